@@ -132,6 +132,7 @@ namespace ortc
 
     struct Options {
       bool                mContinuousGathering {true};
+      bool                mICELite {false};       // host candidates only; never initiates connectivity checks
       InterfacePolicyList mInterfacePolicies;
       ServerList          mICEServers;
 
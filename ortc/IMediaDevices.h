@@ -174,6 +174,13 @@ namespace ortc
 
     static PromiseWithDeviceListPtr enumerateDevices();
 
+    // A device id constraint of the form "synthetic:<type>?<name>=<value>"
+    // selects a generated or file-backed source instead of a capture device:
+    //   synthetic:video-pattern?width=1280&height=720&fps=30
+    //   synthetic:video-file?path=clip.y4m (or clip.yuv&width=..&height=..)
+    //   synthetic:audio-tone?frequency=440&rate=48000&channels=1
+    //   synthetic:audio-file?path=speech.wav (or speech.pcm&rate=..&channels=..)
+    // Tracks opened with the same device id share one decoded source.
     static PromiseWithMediaStreamTrackListPtr getUserMedia(const Constraints &constraints = Constraints());
 
     static IMediaDevicesSubscriptionPtr subscribe(IMediaDevicesDelegatePtr delegate);
@@ -67,6 +67,11 @@ namespace ortc
     static bool saveMediaTrace(String filename);
     static bool saveMediaTrace(String host, int port);
 
+    static void startEventTracing();
+    static void stopEventTracing();
+    static bool isEventTracing();
+    static bool saveEventTrace(String filename);
+
     virtual ~IORTC() {} // make polymorphic
   };
 }
@@ -0,0 +1,102 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#pragma once
+
+#include <ortc/types.h>
+#include <ortc/IRTPTypes.h>
+
+namespace ortc
+{
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IRTPForwarderTypes
+  #pragma mark
+  
+  interaction IRTPForwarderTypes : public IRTPTypes
+  {
+    ZS_DECLARE_STRUCT_PTR(Options)
+
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPForwarderTypes::Options
+    #pragma mark
+
+    struct Options
+    {
+      Optional<SSRCType> mSourceSSRC;   // forward only this incoming SSRC (otherwise follow the most recently active source)
+      bool mExclusive {false};          // when true the receiver stops feeding its own decoder while the forwarder is attached
+
+      Options() {}
+      Options(const Options &op2) {(*this) = op2;}
+
+      ElementPtr toDebug() const;
+      String hash() const;
+    };
+  };
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IRTPForwarder
+  #pragma mark
+
+  // Relays RTP received on an IRTPReceiver out of an IRTPSender without
+  // decoding. Outgoing packets are rewritten to the sender's SSRC, payload
+  // types and header extension IDs; NACK/PLI/FIR/REMB feedback arriving at
+  // the sender is translated back to the original source. The sender is
+  // expected to have been created without a track.
+  interaction IRTPForwarder : public IRTPForwarderTypes
+  {
+    static ElementPtr toDebug(IRTPForwarderPtr forwarder);
+
+    static IRTPForwarderPtr create(
+                                   IRTPReceiverPtr receiver,
+                                   IRTPSenderPtr sender,
+                                   const Options &options = Options()
+                                   );
+
+    virtual PUID getID() const = 0;
+
+    virtual IRTPReceiverPtr receiver() const = 0;
+    virtual IRTPSenderPtr sender() const = 0;
+
+    virtual void update(const Options &options) = 0;
+
+    virtual void stop() = 0;
+  };
+}
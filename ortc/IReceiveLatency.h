@@ -0,0 +1,126 @@
+/*
+
+ Copyright (c) 2015, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#pragma once
+
+#include <ortc/types.h>
+
+namespace ortc
+{
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IReceiveLatencyTypes
+  #pragma mark
+
+  interaction IReceiveLatencyTypes
+  {
+    ZS_DECLARE_STRUCT_PTR(StageStats);
+    ZS_DECLARE_TYPEDEF_PTR(std::list<StageStats>, StageStatsList);
+
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IReceiveLatencyTypes::Stages
+    #pragma mark
+
+    // Each stage measures the time from the previous stage (or from the
+    // socket read for the first) until the packet reaches the named stage.
+    enum Stages
+    {
+      Stage_First,
+
+      Stage_ICETransport = Stage_First,   // socket read -> ICETransport::notifyPacket
+      Stage_DTLSTransport,                // -> DTLSTransport::handleReceivedPacket
+      Stage_SRTPTransport,                // -> SRTPTransport::handleReceivedPacket
+      Stage_RTPListener,                  // -> RTPListener::handleRTPPacket
+      Stage_RTPReceiver,                  // -> RTPReceiver::handlePacket
+      Stage_MediaEngineQueue,             // media engine queue -> onHandleRTPPacket
+      Stage_Total,                        // socket read -> onHandleRTPPacket
+
+      Stage_Last = Stage_Total,
+    };
+
+    static const char *toString(Stages stage);
+    static Optional<Stages> toStage(const char *stage);
+
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IReceiveLatencyTypes::StageStats
+    #pragma mark
+
+    struct StageStats
+    {
+      Stages mStage {Stage_First};
+      String mThread;                 // empty when aggregated across threads
+
+      ULONGLONG mCount {};
+      Microseconds mMin {};
+      Microseconds mMean {};
+      Microseconds mP50 {};
+      Microseconds mP90 {};
+      Microseconds mP99 {};
+      Microseconds mP999 {};
+      Microseconds mMax {};
+
+      ElementPtr toDebug() const;
+    };
+  };
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IReceiveLatency
+  #pragma mark
+
+  // Optional per stage latency histograms for the RTP receive pipeline,
+  // kept separately for every thread that reads packets from a socket or
+  // services a media engine packet queue. Disabled by default (see the
+  // "ortc/receive-latency/enabled" setting); when disabled the cost on the
+  // receive path is a single relaxed atomic load per stage.
+
+  interaction IReceiveLatency : public IReceiveLatencyTypes
+  {
+    static ElementPtr toDebug();
+
+    static void enable(bool enabled = true);
+    static bool isEnabled();
+
+    static StageStatsListPtr getStats(bool perThread = false);
+
+    static void reset();
+
+    virtual ~IReceiveLatency() {} // make polymorphic
+  };
+}
@@ -0,0 +1,190 @@
+/*
+
+ Copyright (c) 2015, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#pragma once
+
+#include <ortc/types.h>
+#include <ortc/IStatsReport.h>
+
+namespace ortc
+{
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IStatsCountersTypes
+  #pragma mark
+
+  interaction IStatsCountersTypes
+  {
+    typedef IStatsReportTypes::StatsTypes StatsTypes;
+
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IStatsCountersTypes::Counters
+    #pragma mark
+
+    enum Counters
+    {
+      Counter_First,
+
+      Counter_PacketsSent = Counter_First,
+      Counter_BytesSent,
+      Counter_PacketsReceived,
+      Counter_BytesReceived,
+      Counter_PacketsLost,            // gauge (signed, cumulative lost reported by the remote party)
+      Counter_NACKCount,
+      Counter_PLICount,
+      Counter_FIRCount,
+      Counter_RoundTripTime,          // gauge (in microseconds)
+      Counter_HandshakeQueueDepth,    // gauge (DTLS records pending in this transport's incoming and outgoing lists, sampled as each handshake pass starts)
+      Counter_HandshakeProcessingTime,  // gauge (in microseconds spent in the DTLS adapter for the last completed handshake)
+
+      Counter_Last = Counter_HandshakeProcessingTime,
+    };
+
+    static const char *toString(Counters counter);
+    static Optional<Counters> toCounter(const char *counter);
+    static bool isGauge(Counters counter);
+
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IStatsCountersTypes::ExportFormats
+    #pragma mark
+
+    enum ExportFormats
+    {
+      ExportFormat_First,
+
+      ExportFormat_Binary = ExportFormat_First,
+      ExportFormat_JSON,
+
+      ExportFormat_Last = ExportFormat_JSON,
+    };
+
+    static const char *toString(ExportFormats format);
+    static Optional<ExportFormats> toExportFormat(const char *format);
+  };
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IStatsCounters
+  #pragma mark
+
+  // Push based counterpart to IStatsProvider::getStats(). Every registered
+  // object maintains a fixed set of atomic counters which are periodically
+  // snapshotted and pushed to subscribers as a single compact buffer (no
+  // promises and no per object allocations).
+  //
+  // Binary format (all values in network byte order):
+  //   header:
+  //     4 bytes  - magic "OSC1"
+  //     1 byte   - flags (0x01 = values are deltas from previous export)
+  //     1 byte   - total counters per object
+  //     4 bytes  - sequence number of export
+  //     8 bytes  - timestamp (milliseconds since epoch)
+  //     4 bytes  - total object entries
+  //     4 bytes  - total removed entries
+  //   object entry:
+  //     8 bytes  - object ID
+  //     1 byte   - IStatsReportTypes::StatsTypes
+  //     varint   - per counter value (LEB128 zig-zag encoded)
+  //   removed entry:
+  //     8 bytes  - object ID
+  //
+  // Delta exports only contain objects whose counters changed since the
+  // previous export. Gauges (see isGauge()) are always exported as their
+  // current value, never as a delta. A full (non-delta) export is
+  // periodically produced to allow subscribers to resynchronize.
+
+  interaction IStatsCounters : public IStatsCountersTypes
+  {
+    static ElementPtr toDebug();
+
+    static IStatsCountersSubscriptionPtr subscribe(IStatsCountersDelegatePtr delegate);
+
+    static SecureByteBlockPtr snapshot(ExportFormats format = ExportFormat_JSON);
+
+    virtual ~IStatsCounters() {} // make polymorphic
+  };
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IStatsCountersDelegate
+  #pragma mark
+
+  interaction IStatsCountersDelegate
+  {
+    typedef IStatsCountersTypes::ExportFormats ExportFormats;
+
+    virtual void onStatsCountersExported(
+                                         ExportFormats format,
+                                         SecureByteBlockPtr buffer
+                                         ) = 0;
+  };
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IStatsCountersSubscription
+  #pragma mark
+
+  interaction IStatsCountersSubscription
+  {
+    virtual PUID getID() const = 0;
+
+    virtual void cancel() = 0;
+
+    virtual void background() = 0;
+  };
+}
+
+
+ZS_DECLARE_PROXY_BEGIN(ortc::IStatsCountersDelegate)
+ZS_DECLARE_PROXY_TYPEDEF(ortc::IStatsCountersDelegate::ExportFormats, ExportFormats)
+ZS_DECLARE_PROXY_TYPEDEF(ortc::SecureByteBlockPtr, SecureByteBlockPtr)
+ZS_DECLARE_PROXY_METHOD_2(onStatsCountersExported, ExportFormats, SecureByteBlockPtr)
+ZS_DECLARE_PROXY_END()
+
+ZS_DECLARE_PROXY_SUBSCRIPTIONS_BEGIN(ortc::IStatsCountersDelegate, ortc::IStatsCountersSubscription)
+ZS_DECLARE_PROXY_SUBSCRIPTIONS_TYPEDEF(ortc::IStatsCountersDelegate::ExportFormats, ExportFormats)
+ZS_DECLARE_PROXY_SUBSCRIPTIONS_TYPEDEF(ortc::SecureByteBlockPtr, SecureByteBlockPtr)
+ZS_DECLARE_PROXY_SUBSCRIPTIONS_METHOD_2(onStatsCountersExported, ExportFormats, SecureByteBlockPtr)
+ZS_DECLARE_PROXY_SUBSCRIPTIONS_END()
@@ -649,6 +649,14 @@ namespace ortc
       bool                          mReadable {};
       unsigned long long            mBytesSent {};
       unsigned long long            mBytesReceived {};
+      unsigned long long            mPacketsSent {};
+      unsigned long long            mPacketsReceived {};
+      unsigned long long            mRequestsSent {};
+      unsigned long long            mRequestsReceived {};
+      unsigned long long            mResponsesSent {};
+      unsigned long long            mResponsesReceived {};
+      unsigned long long            mConsentRequestsSent {};
+      Time                          mLastConsentTimestamp;
       double                        mRoundTripTime {};
       double                        mAvailableOutgoingBitrate {};
       double                        mAvailableIncomingBitrate {};
@@ -279,6 +279,14 @@ namespace ortc
 
       static ServerListPtr getDefaultIceServers();
 
+      // pre-gathered ICE transports (and certificates) shared by all peer
+      // connections whose gather options and RTCP mux policy match; a
+      // target depth of 0 empties the pool
+      static void setSharedTransportPool(
+                                         const Configuration &configuration,
+                                         size_t targetDepth
+                                         );
+
       virtual ConfigurationPtr getConfiguration() const = 0;
       virtual void setConfiguration(const Configuration &configuration) = 0;
 
@@ -31,6 +31,7 @@
 
 #include <ortc/adapter/internal/ortc_adapter_PeerConnection.h>
 #include <ortc/adapter/internal/ortc_adapter_MediaStream.h>
+#include <ortc/adapter/internal/ortc_adapter_TransportPool.h>
 
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc_RTPTypes.h>
@@ -345,7 +346,17 @@ namespace ortc
       {
         AutoRecursiveLock lock(*this);
 
+        if (mConfiguration.mCertificates.size() < 1) {
+          auto pool = TransportPool::singleton();
+          auto certificate = pool ? pool->claimCertificate() : ICertificatePtr();
+          if (certificate) {
+            ZS_LOG_DEBUG(log("using pre-generated certificate from shared transport pool"));
+            mConfiguration.mCertificates.push_back(certificate);
+          }
+        }
+
         for (size_t index = 0; index < mConfiguration.mICECandidatePoolSize; ++index) {
+          if (addToTransportPoolFromSharedPool()) continue;
           addToTransportPool();
         }
 
@@ -4181,7 +4192,9 @@ namespace ortc
         String useIDStr(useID);
 
         if (mTransportPool.size() < 1) {
-          addToTransportPool();
+          if (!addToTransportPoolFromSharedPool()) {
+            addToTransportPool();
+          }
         }
 
         TransportInfoPtr transport = mTransportPool.front();
@@ -4206,7 +4219,7 @@ namespace ortc
 
         if (IPeerConnectionTypes::RTCPMuxPolicy_Negotiated == mConfiguration.mRTCPMuxPolicy) {
           info->mRTCP.mGatherer = info->mRTP.mGatherer->createAssociatedGatherer(mThisWeak.lock());
-          info->mRTCP.mTransport = info->mRTCP.mTransport->createAssociatedTransport(mThisWeak.lock());
+          info->mRTCP.mTransport = info->mRTP.mTransport->createAssociatedTransport(mThisWeak.lock());
         }
 
         if (mConfiguration.mNegotiateSRTPSDES) {
@@ -4216,6 +4229,41 @@ namespace ortc
         mTransportPool.push_back(info);
       }
 
+      //-----------------------------------------------------------------------
+      bool PeerConnection::addToTransportPoolFromSharedPool()
+      {
+        auto pool = TransportPool::singleton();
+        if (!pool) return false;
+
+        auto bundle = pool->claim(TransportPool::hash(mConfiguration.mGatherOptions), mConfiguration.mRTCPMuxPolicy);
+        if (!bundle) return false;
+
+        TransportInfoPtr info(make_shared<TransportInfo>());
+
+        // the shared pool created these without knowing which peer connection
+        // would claim them thus subscribe now (existing candidates replay)
+        info->mRTP.mGatherer = bundle->mRTPGatherer;
+        info->mRTP.mTransport = bundle->mRTPTransport;
+        info->mRTP.mGathererSubscription = info->mRTP.mGatherer->subscribe(mThisWeak.lock());
+        info->mRTP.mTransportSubscription = info->mRTP.mTransport->subscribe(mThisWeak.lock());
+
+        if (bundle->mRTCPGatherer) {
+          info->mRTCP.mGatherer = bundle->mRTCPGatherer;
+          info->mRTCP.mTransport = bundle->mRTCPTransport;
+          info->mRTCP.mGathererSubscription = info->mRTCP.mGatherer->subscribe(mThisWeak.lock());
+          info->mRTCP.mTransportSubscription = info->mRTCP.mTransport->subscribe(mThisWeak.lock());
+        }
+
+        if (mConfiguration.mNegotiateSRTPSDES) {
+          info->mRTP.mSRTPSDESParameters = ISRTPSDESTransport::getLocalParameters();
+        }
+
+        ZS_LOG_DEBUG(log("claimed transport from shared transport pool") + info->mRTP.toDebug());
+
+        mTransportPool.push_back(info);
+        return true;
+      }
+
       //-----------------------------------------------------------------------
       String PeerConnection::registerNewID(size_t length)
       {
@@ -4341,6 +4389,14 @@ namespace ortc
           details.mDTLSTransport->stop();
           details.mDTLSTransport.reset();
         }
+        if (details.mTransportSubscription) {
+          details.mTransportSubscription->cancel();
+          details.mTransportSubscription.reset();
+        }
+        if (details.mGathererSubscription) {
+          details.mGathererSubscription->cancel();
+          details.mGathererSubscription.reset();
+        }
         if (details.mTransport) {
           details.mTransport->stop();
           details.mTransport.reset();
@@ -4802,6 +4858,18 @@ namespace ortc
         return internal::PeerConnection::getDefaultIceServers();
       }
 
+      //-------------------------------------------------------------------------
+      void IPeerConnectionFactory::setSharedTransportPool(
+                                                          const Configuration &configuration,
+                                                          size_t targetDepth
+                                                          )
+      {
+        if (this) {}
+        auto pool = TransportPool::singleton();
+        if (!pool) return;
+        pool->configure(configuration, targetDepth);
+      }
+
     }  // namespace internal
 
     
@@ -5102,5 +5170,14 @@ namespace ortc
       return internal::IPeerConnectionFactory::singleton().getDefaultIceServers();
     }
 
+    //-------------------------------------------------------------------------
+    void IPeerConnection::setSharedTransportPool(
+                                                 const Configuration &configuration,
+                                                 size_t targetDepth
+                                                 )
+    {
+      internal::IPeerConnectionFactory::singleton().setSharedTransportPool(configuration, targetDepth);
+    }
+
   } // namespace adapter
 } // namespace ortc
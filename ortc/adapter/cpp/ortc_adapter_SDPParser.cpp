@@ -75,6 +75,70 @@ namespace ortc
         return Log::Params(message, "ortc::adapter::SDPParser");
       }
 
+      //-----------------------------------------------------------------------
+      static DWORD hashAttributeName(
+                                     const char *name,
+                                     size_t &outLength
+                                     )
+      {
+        // FNV-1a over the raw characters (no temporary string is created)
+        DWORD hash = 2166136261UL;
+        const char *pos = name;
+        for (; '\0' != *pos; ++pos) {
+          hash ^= static_cast<DWORD>(static_cast<BYTE>(*pos));
+          hash *= 16777619UL;
+        }
+        outLength = static_cast<size_t>(pos - name);
+        return hash;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark AttributeIndex
+      #pragma mark
+
+      #define ORTC_ADAPTER_SDP_ATTRIBUTE_INDEX_SIZE (128)
+
+      //-----------------------------------------------------------------------
+      // Open addressed hash index of every known attribute name, built once
+      // from ISDPTypes::toString() so the enum remains the single source of
+      // truth for attribute spellings.
+      struct AttributeIndex
+      {
+        struct Entry
+        {
+          const char *mName {};
+          size_t mLength {};
+          DWORD mHash {};
+          ISDPTypes::Attributes mAttribute {ISDPTypes::Attribute_Unknown};
+        };
+
+        Entry mEntries[ORTC_ADAPTER_SDP_ATTRIBUTE_INDEX_SIZE];
+
+        AttributeIndex()
+        {
+          static_assert(0 == (ORTC_ADAPTER_SDP_ATTRIBUTE_INDEX_SIZE & (ORTC_ADAPTER_SDP_ATTRIBUTE_INDEX_SIZE - 1)), "index size must be a power of 2");
+          static_assert(ISDPTypes::Attribute_Last < (ORTC_ADAPTER_SDP_ATTRIBUTE_INDEX_SIZE / 2), "index size is too small for the number of attributes");
+
+          for (auto attribute = ISDPTypes::Attribute_First + 1; attribute <= ISDPTypes::Attribute_Last; ++attribute) {
+            Entry entry;
+            entry.mAttribute = static_cast<ISDPTypes::Attributes>(attribute);
+            entry.mName = ISDPTypes::toString(entry.mAttribute);
+            entry.mHash = hashAttributeName(entry.mName, entry.mLength);
+
+            for (size_t probe = 0; probe < ORTC_ADAPTER_SDP_ATTRIBUTE_INDEX_SIZE; ++probe) {
+              auto &slot = mEntries[(entry.mHash + probe) & (ORTC_ADAPTER_SDP_ATTRIBUTE_INDEX_SIZE - 1)];
+              if (slot.mName) continue;
+              slot = entry;
+              break;
+            }
+          }
+        }
+      };
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -105,26 +169,13 @@ namespace ortc
       //-----------------------------------------------------------------------
       ISDPTypes::LineTypes ISDPTypes::toLineType(const char *type)
       {
-        String str(type);
-        
-        static LineTypes checkLines[] = {
-          LineType_v_Version,
-          LineType_o_Origin,
-          LineType_s_SessionName,
-          LineType_b_Bandwidth,
-          LineType_t_Timing,
-          LineType_a_Attributes,
-          LineType_m_MediaLine,
-          LineType_c_ConnectionDataLine,
-          LineType_Unknown
-        };
+        if (!type) return LineType_Unknown;
 
-        for (size_t index = 0; LineType_Unknown != checkLines[index]; ++index)
-        {
-          if (0 != str.compare(toString(checkLines[index]))) continue;
-          return checkLines[index];
-        }
-        return LineType_Unknown;
+        // every line type is exactly one character long
+        if (('\0' == type[0]) ||
+            ('\0' != type[1])) return LineType_Unknown;
+
+        return toLineType(type[0]);
       }
 
       //-----------------------------------------------------------------------
@@ -284,9 +335,21 @@ namespace ortc
       //-----------------------------------------------------------------------
       ISDPTypes::Attributes ISDPTypes::toAttribute(const char *attribute)
       {
-        String str(attribute);
-        for (Attributes index = Attribute_First; index <= Attribute_Last; index = static_cast<Attributes>(static_cast<std::underlying_type<Attributes>::type>(index) + 1)) {
-          if (0 == str.compare(toString(index))) return index;
+        if (!attribute) return Attribute_Unknown;
+
+        size_t length = 0;
+        auto hash = hashAttributeName(attribute, length);
+        if (0 == length) return Attribute_Unknown;
+
+        static const AttributeIndex index;
+
+        for (size_t probe = 0; probe < ORTC_ADAPTER_SDP_ATTRIBUTE_INDEX_SIZE; ++probe) {
+          auto &entry = index.mEntries[(hash + probe) & (ORTC_ADAPTER_SDP_ATTRIBUTE_INDEX_SIZE - 1)];
+          if (!entry.mName) break;
+          if (entry.mHash != hash) continue;
+          if (entry.mLength != length) continue;
+          if (0 != memcmp(entry.mName, attribute, length)) continue;
+          return entry.mAttribute;
         }
 
         return Attribute_Unknown;
@@ -976,45 +1039,49 @@ namespace ortc
       String ISDPTypes::ACandidateLine::toString() const
       {
         String result;
-        result.append("candidate:");
-        result.append(mFoundation.hasData() ? mFoundation : String("+"));
-        result.append(" ");
-        result.append(string(mComponentID));
-        result.append(" ");
-        result.append(mTransport.hasData() ? mTransport : String("UDP"));
-        result.append(" ");
-        result.append(string(mPriority));
-        result.append(" ");
-        result.append(mConnectionAddress.hasData() ? mConnectionAddress : String("127.0.0.1"));
-        result.append(" ");
-        result.append(string(mPort));
-        result.append(" ");
-        result.append(mTyp.hasData() ? mTyp : String("typ"));
-        result.append(" ");
-        result.append(mCandidateType.hasData() ? mCandidateType : String("host"));
+        appendTo(result);
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      void ISDPTypes::ACandidateLine::appendTo(String &ioResult) const
+      {
+        ioResult.append("candidate:");
+        if (mFoundation.hasData()) ioResult.append(mFoundation); else ioResult.append("+");
+        ioResult.append(" ");
+        ioResult.append(string(mComponentID));
+        ioResult.append(" ");
+        if (mTransport.hasData()) ioResult.append(mTransport); else ioResult.append("UDP");
+        ioResult.append(" ");
+        ioResult.append(string(mPriority));
+        ioResult.append(" ");
+        if (mConnectionAddress.hasData()) ioResult.append(mConnectionAddress); else ioResult.append("127.0.0.1");
+        ioResult.append(" ");
+        ioResult.append(string(mPort));
+        ioResult.append(" ");
+        if (mTyp.hasData()) ioResult.append(mTyp); else ioResult.append("typ");
+        ioResult.append(" ");
+        if (mCandidateType.hasData()) ioResult.append(mCandidateType); else ioResult.append("host");
         if ((mRelAddr.hasData()) ||
             (mRelPort.hasValue()) ||
             (mExtensionPairs.size() > 0)) {
-          result.append(" ");
-          result.append(mRelAddr.hasData() ? mRelAddr : String("0.0.0.0"));
-          result.append(" ");
-          result.append(mRelPort.hasValue() ? string(mRelPort.value()) : String("0"));
-          if (mExtensionPairs.size() > 0) {
-            for (auto iter = mExtensionPairs.begin(); iter != mExtensionPairs.end(); ++iter) {
-              auto &name = (*iter).first;
-              auto &value = (*iter).second;
-              if (name.isEmpty()) {
-                ZS_LOG_WARNING(Debug, internal::slog("missing ice extension name") + ZS_PARAM("value", value));
-                continue;
-              }
-              result.append(" ");
-              result.append(name);
-              result.append(" ");
-              result.append(value);
+          ioResult.append(" ");
+          if (mRelAddr.hasData()) ioResult.append(mRelAddr); else ioResult.append("0.0.0.0");
+          ioResult.append(" ");
+          if (mRelPort.hasValue()) ioResult.append(string(mRelPort.value())); else ioResult.append("0");
+          for (auto iter = mExtensionPairs.begin(); iter != mExtensionPairs.end(); ++iter) {
+            auto &name = (*iter).first;
+            auto &value = (*iter).second;
+            if (name.isEmpty()) {
+              ZS_LOG_WARNING(Debug, internal::slog("missing ice extension name") + ZS_PARAM("value", value));
+              continue;
             }
+            ioResult.append(" ");
+            ioResult.append(name);
+            ioResult.append(" ");
+            ioResult.append(value);
           }
         }
-        return result;
       }
 
       //-----------------------------------------------------------------------
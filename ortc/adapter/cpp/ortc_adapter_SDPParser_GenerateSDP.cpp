@@ -76,10 +76,9 @@ namespace ortc
       }
 
       //-----------------------------------------------------------------------
-      static String eol()
+      static const char *eol()
       {
-        static String result("\r\n");
-        return result;
+        return "\r\n";
       }
 
       //-----------------------------------------------------------------------
@@ -105,12 +104,8 @@ namespace ortc
         if (NULL == line) return;
         if ('\0' == *line) return;
 
-        char prefix[3];
-        prefix[0] = letter;
-        prefix[1] = '=';
-        prefix[2] = '\0';
-
-        ioResult.append(&(prefix[0]));
+        ioResult.append(1, letter);
+        ioResult.append(1, '=');
         ioResult.append(line);
         ioResult.append(eol());
       }
@@ -120,16 +115,20 @@ namespace ortc
       {
         if (line.isEmpty()) return;
 
-        char prefix[3];
-        prefix[0] = letter;
-        prefix[1] = '=';
-        prefix[2] = '\0';
-
-        ioResult.append(&(prefix[0]));
+        ioResult.append(1, letter);
+        ioResult.append(1, '=');
         ioResult.append(line);
         ioResult.append(eol());
       }
 
+      //-----------------------------------------------------------------------
+      static void appendCandidateLine(String &ioResult, const ISDPTypes::ACandidateLine &line)
+      {
+        ioResult.append("a=");
+        line.appendTo(ioResult);
+        ioResult.append(eol());
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -182,98 +181,127 @@ namespace ortc
                                          )
       {
         for (auto iter = sdp.mMLines.begin(); iter != sdp.mMLines.end(); ++iter) {
-          auto mline = *(*iter);
-          appendLine(ioResult, 'm', mline.toString());
+          generateMediaLine(*(*iter), ioResult);
+        }
+      }
 
-          appendLine(ioResult, 'c', ISDPTypes::CLine::toString(mline.mCLine));
-          if ((mline.mBundleOnly.hasValue()) &&
-              (mline.mBundleOnly.value())) {
-            appendLine(ioResult, 'a', "bundle-only");
-          }
-          appendLine(ioResult, 'a', ISDPTypes::AICEUFragLine::toString(mline.mAICEUFragLine));
-          appendLine(ioResult, 'a', ISDPTypes::AICEPwdLine::toString(mline.mAICEPwdLine));
-          appendLine(ioResult, 'a', ISDPTypes::ASetupLine::toString(mline.mASetupLine));
-          appendLine(ioResult, 'a', ISDPTypes::AMIDLine::toString(mline.mAMIDLine));
-          appendLine(ioResult, 'a', ISDPTypes::ARTCPLine::toString(mline.mARTCPLine));
-          appendLine(ioResult, 'a', ISDPTypes::APTimeLine::toString(mline.mAPTimeLine));
-          appendLine(ioResult, 'a', ISDPTypes::AMaxPTimeLine::toString(mline.mAMaxPTimeLine));
-          //appendLine(ioResult, 'a', ISDPTypes::ASimulcastLine::toString(mline.mASimulcastLine));
-          appendLine(ioResult, 'a', ISDPTypes::ASCTPPortLine::toString(mline.mASCTPPortLine));
-          appendLine(ioResult, 'a', ISDPTypes::AMaxMessageSizeLine::toString(mline.mAMaxMessageSize));
-
-          if (mline.mMediaDirection.hasValue()) {
-            appendLine(ioResult, 'a', ISDPTypes::toString(mline.mMediaDirection.value()));
-          }
-          if ((mline.mRTCPMux.hasValue()) &&
-              (mline.mRTCPMux.value())) {
-            appendLine(ioResult, 'a', "rtcp-mux");
-          }
-          if ((mline.mRTCPRSize.hasValue()) &&
-              (mline.mRTCPRSize.value())) {
-            appendLine(ioResult, 'a', "rtcp-rsize");
-          }
+      //-----------------------------------------------------------------------
+      void SDPParser::generateMediaLine(
+                                        const MLine &mline,
+                                        String &ioResult
+                                        )
+      {
+        appendLine(ioResult, 'm', mline.toString());
 
-          for (auto iterSub = mline.mAMSIDLines.begin(); iterSub != mline.mAMSIDLines.end(); ++iterSub) {
-            auto &msid = *(*iterSub);
-            appendLine(ioResult, 'a', msid.toString());
-          }
-          for (auto iterSub = mline.mAFingerprintLines.begin(); iterSub != mline.mAFingerprintLines.end(); ++iterSub) {
-            auto &fingerprint = *(*iterSub);
-            appendLine(ioResult, 'a', fingerprint.toString());
-          }
-          for (auto iterSub = mline.mACryptoLines.begin(); iterSub != mline.mACryptoLines.end(); ++iterSub) {
-            auto &crypto = *(*iterSub);
-            appendLine(ioResult, 'a', crypto.toString());
-          }
-          for (auto iterSub = mline.mAExtmapLines.begin(); iterSub != mline.mAExtmapLines.end(); ++iterSub) {
-            auto &extmap = *(*iterSub);
-            appendLine(ioResult, 'a', extmap.toString());
-          }
-          for (auto iterSub = mline.mARTPMapLines.begin(); iterSub != mline.mARTPMapLines.end(); ++iterSub) {
-            auto &rtpmap = *(*iterSub);
-            appendLine(ioResult, 'a', rtpmap.toString());
-          }
-          for (auto iterSub = mline.mAFMTPLines.begin(); iterSub != mline.mAFMTPLines.end(); ++iterSub) {
-            auto &fmtp = *(*iterSub);
-            appendLine(ioResult, 'a', fmtp.toString());
-          }
-          for (auto iterSub = mline.mARTCPFBLines.begin(); iterSub != mline.mARTCPFBLines.end(); ++iterSub) {
-            auto &fmtp = *(*iterSub);
-            appendLine(ioResult, 'a', fmtp.toString());
-          }
-          for (auto iterSub = mline.mACandidateLines.begin(); iterSub != mline.mACandidateLines.end(); ++iterSub) {
-            auto &candidate = *(*iterSub);
-            appendLine(ioResult, 'a', candidate.toString());
-          }
-          if ((mline.mEndOfCandidates.hasValue()) &&
-              (mline.mEndOfCandidates.value())) {
-            appendLine(ioResult, 'a', "end-of-candidates");
-          }
+        appendLine(ioResult, 'c', ISDPTypes::CLine::toString(mline.mCLine));
+        if ((mline.mBundleOnly.hasValue()) &&
+            (mline.mBundleOnly.value())) {
+          appendLine(ioResult, 'a', "bundle-only");
+        }
+        appendLine(ioResult, 'a', ISDPTypes::AICEUFragLine::toString(mline.mAICEUFragLine));
+        appendLine(ioResult, 'a', ISDPTypes::AICEPwdLine::toString(mline.mAICEPwdLine));
+        appendLine(ioResult, 'a', ISDPTypes::ASetupLine::toString(mline.mASetupLine));
+        appendLine(ioResult, 'a', ISDPTypes::AMIDLine::toString(mline.mAMIDLine));
+        appendLine(ioResult, 'a', ISDPTypes::ARTCPLine::toString(mline.mARTCPLine));
+        appendLine(ioResult, 'a', ISDPTypes::APTimeLine::toString(mline.mAPTimeLine));
+        appendLine(ioResult, 'a', ISDPTypes::AMaxPTimeLine::toString(mline.mAMaxPTimeLine));
+        //appendLine(ioResult, 'a', ISDPTypes::ASimulcastLine::toString(mline.mASimulcastLine));
+        appendLine(ioResult, 'a', ISDPTypes::ASCTPPortLine::toString(mline.mASCTPPortLine));
+        appendLine(ioResult, 'a', ISDPTypes::AMaxMessageSizeLine::toString(mline.mAMaxMessageSize));
+
+        if (mline.mMediaDirection.hasValue()) {
+          appendLine(ioResult, 'a', ISDPTypes::toString(mline.mMediaDirection.value()));
+        }
+        if ((mline.mRTCPMux.hasValue()) &&
+            (mline.mRTCPMux.value())) {
+          appendLine(ioResult, 'a', "rtcp-mux");
+        }
+        if ((mline.mRTCPRSize.hasValue()) &&
+            (mline.mRTCPRSize.value())) {
+          appendLine(ioResult, 'a', "rtcp-rsize");
+        }
 
-          for (auto iterSub = mline.mARIDLines.begin(); iterSub != mline.mARIDLines.end(); ++iterSub) {
-            auto &rid = *(*iterSub);
-            appendLine(ioResult, 'a', rid.toString());
-          }
-          for (auto iterSub = mline.mASSRCLines.begin(); iterSub != mline.mASSRCLines.end(); ++iterSub) {
-            auto &ssrc = *(*iterSub);
-            appendLine(ioResult, 'a', ssrc.toString());
-            for (auto iterSSrcSub = ssrc.mAFMTPLines.begin(); iterSSrcSub != ssrc.mAFMTPLines.end(); ++iterSSrcSub) {
-              auto &ssrcFmtp = *(*iterSSrcSub);
-              appendLine(ioResult, 'a', ssrcFmtp.toString());
-            }
-          }
-          for (auto iterSub = mline.mASSRCGroupLines.begin(); iterSub != mline.mASSRCGroupLines.end(); ++iterSub) {
-            auto &ssrcGroup = *(*iterSub);
-            appendLine(ioResult, 'a', ssrcGroup.toString());
+        for (auto iterSub = mline.mAMSIDLines.begin(); iterSub != mline.mAMSIDLines.end(); ++iterSub) {
+          auto &msid = *(*iterSub);
+          appendLine(ioResult, 'a', msid.toString());
+        }
+        for (auto iterSub = mline.mAFingerprintLines.begin(); iterSub != mline.mAFingerprintLines.end(); ++iterSub) {
+          auto &fingerprint = *(*iterSub);
+          appendLine(ioResult, 'a', fingerprint.toString());
+        }
+        for (auto iterSub = mline.mACryptoLines.begin(); iterSub != mline.mACryptoLines.end(); ++iterSub) {
+          auto &crypto = *(*iterSub);
+          appendLine(ioResult, 'a', crypto.toString());
+        }
+        for (auto iterSub = mline.mAExtmapLines.begin(); iterSub != mline.mAExtmapLines.end(); ++iterSub) {
+          auto &extmap = *(*iterSub);
+          appendLine(ioResult, 'a', extmap.toString());
+        }
+        for (auto iterSub = mline.mARTPMapLines.begin(); iterSub != mline.mARTPMapLines.end(); ++iterSub) {
+          auto &rtpmap = *(*iterSub);
+          appendLine(ioResult, 'a', rtpmap.toString());
+        }
+        for (auto iterSub = mline.mAFMTPLines.begin(); iterSub != mline.mAFMTPLines.end(); ++iterSub) {
+          auto &fmtp = *(*iterSub);
+          appendLine(ioResult, 'a', fmtp.toString());
+        }
+        for (auto iterSub = mline.mARTCPFBLines.begin(); iterSub != mline.mARTCPFBLines.end(); ++iterSub) {
+          auto &fmtp = *(*iterSub);
+          appendLine(ioResult, 'a', fmtp.toString());
+        }
+        for (auto iterSub = mline.mACandidateLines.begin(); iterSub != mline.mACandidateLines.end(); ++iterSub) {
+          auto &candidate = *(*iterSub);
+          appendCandidateLine(ioResult, candidate);
+        }
+        if ((mline.mEndOfCandidates.hasValue()) &&
+            (mline.mEndOfCandidates.value())) {
+          appendLine(ioResult, 'a', "end-of-candidates");
+        }
+
+        for (auto iterSub = mline.mARIDLines.begin(); iterSub != mline.mARIDLines.end(); ++iterSub) {
+          auto &rid = *(*iterSub);
+          appendLine(ioResult, 'a', rid.toString());
+        }
+        for (auto iterSub = mline.mASSRCLines.begin(); iterSub != mline.mASSRCLines.end(); ++iterSub) {
+          auto &ssrc = *(*iterSub);
+          appendLine(ioResult, 'a', ssrc.toString());
+          for (auto iterSSrcSub = ssrc.mAFMTPLines.begin(); iterSSrcSub != ssrc.mAFMTPLines.end(); ++iterSSrcSub) {
+            auto &ssrcFmtp = *(*iterSSrcSub);
+            appendLine(ioResult, 'a', ssrcFmtp.toString());
           }
         }
+        for (auto iterSub = mline.mASSRCGroupLines.begin(); iterSub != mline.mASSRCGroupLines.end(); ++iterSub) {
+          auto &ssrcGroup = *(*iterSub);
+          appendLine(ioResult, 'a', ssrcGroup.toString());
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      size_t SDPParser::estimateGeneratedSize(const SDP &sdp)
+      {
+        enum Estimates
+        {
+          Estimate_SessionLevel = 512,
+          Estimate_MediaLevel = 1536,
+          Estimate_PerCandidate = 96,
+          Estimate_PerSSRC = 160,
+        };
+
+        size_t result = Estimate_SessionLevel;
+        for (auto iter = sdp.mMLines.begin(); iter != sdp.mMLines.end(); ++iter) {
+          auto &mline = *(*iter);
+          result += Estimate_MediaLevel;
+          result += (mline.mACandidateLines.size() * Estimate_PerCandidate);
+          result += (mline.mASSRCLines.size() * Estimate_PerSSRC);
+        }
+        return result;
       }
 
       //-----------------------------------------------------------------------
       String SDPParser::generate(const SDP &sdp)
       {
         String result;
-        result.reserve(2500);
+        result.reserve(estimateGeneratedSize(sdp));
         try {
           generateSessionLevel(sdp, result);
           generateMediaLevel(sdp, result);
@@ -283,7 +311,6 @@ namespace ortc
         return result;
       }
 
-
     }  // namespace internal
   } // namespace adapter
 } // namespace ortc
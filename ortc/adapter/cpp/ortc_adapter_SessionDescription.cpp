@@ -35,6 +35,8 @@
 
 #include <ortc/adapter/IHelper.h>
 
+#include <ortc/internal/ortc_RTPTypesSerializer.h>
+
 #include <zsLib/eventing/IHasher.h>
 
 #include <zsLib/Log.h>
@@ -61,6 +63,9 @@ namespace ortc
 
     namespace internal
     {
+      ZS_DECLARE_TYPEDEF_PTR(ortc::internal::RTPTypesSerializer, UseRTPTypesSerializer);
+      typedef ortc::internal::RTPTypesJSONReader UseJSONReader;
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -75,6 +80,339 @@ namespace ortc
         return Log::Params(message, "ortc::adapter::ISessionDescriptionTypes");
       }
 
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (json helpers)
+      #pragma mark
+
+      // Descriptions are streamed to and from JSON so the RTP parameters and
+      // capabilities (by far the bulk of a description) never build an
+      // Element tree. The remaining members are small and still go through
+      // their Element forms, one member at a time.
+
+      //-----------------------------------------------------------------------
+      static String getElementJSONValue(ElementPtr el)
+      {
+        if (!el) return String();
+
+        String json = zsLib::IHelper::toString(el);
+        json.trim();
+
+        // the generator wraps the element, i.e. {"name":value}
+        String prefix = String("{\"") + el->getValue() + "\":";
+        if ((json.length() <= prefix.length()) ||
+            (0 != json.compare(0, prefix.length(), prefix)) ||
+            ('}' != json[json.length() - 1])) {
+          ZS_LOG_WARNING(Debug, slog("unexpected element json") + ZS_PARAM("json", json))
+          return String();
+        }
+
+        return json.substr(prefix.length(), json.length() - prefix.length() - 1);
+      }
+
+      //-----------------------------------------------------------------------
+      static void writeJSONElement(
+                                   std::string &output,
+                                   bool &ioFirst,
+                                   ElementPtr el
+                                   )
+      {
+        String value = getElementJSONValue(el);
+        if (value.isEmpty()) return;
+
+        UseRTPTypesSerializer::writeJSONName(output, ioFirst, el->getValue().c_str());
+        output.append(value);
+      }
+
+      //-----------------------------------------------------------------------
+      template <typename List>
+      static void writeJSONElementList(
+                                       std::string &output,
+                                       bool &ioFirst,
+                                       const char *listName,
+                                       const char *itemName,
+                                       const List &list
+                                       )
+      {
+        std::vector<String> values;
+        for (auto iter = list.begin(); iter != list.end(); ++iter) {
+          auto &item = (*iter);
+          if (!item) continue;
+
+          String value = getElementJSONValue(item->createElement(itemName));
+          if (value.isEmpty()) continue;
+          values.push_back(value);
+        }
+
+        UseRTPTypesSerializer::writeJSONList(output, ioFirst, listName, itemName, values, [](std::string &itemOutput, const String &value) {
+          itemOutput.append(value);
+        });
+      }
+
+      //-----------------------------------------------------------------------
+      static void writeJSONValue(
+                                 std::string &output,
+                                 bool &ioFirst,
+                                 const char *name,
+                                 const String &value
+                                 )
+      {
+        if (value.isEmpty()) return;
+
+        UseRTPTypesSerializer::writeJSONName(output, ioFirst, name);
+        UseRTPTypesSerializer::writeJSONString(output, value.c_str());
+      }
+
+      //-----------------------------------------------------------------------
+      static void writeJSON(
+                            std::string &output,
+                            const ISessionDescriptionTypes::RTPMediaLine &mediaLine
+                            )
+      {
+        bool first = true;
+        output.append(1, '{');
+
+        writeJSONValue(output, first, "id", mediaLine.mID);
+        writeJSONValue(output, first, "transportId", mediaLine.mTransportID);
+        writeJSONValue(output, first, "mediaType", mediaLine.mMediaType);
+        if (mediaLine.mDetails) {
+          writeJSONElement(output, first, mediaLine.mDetails->createElement());
+        }
+        if (mediaLine.mSenderCapabilities) {
+          UseRTPTypesSerializer::writeJSONName(output, first, "senderCapabilities");
+          UseRTPTypesSerializer::writeJSON(output, *mediaLine.mSenderCapabilities);
+        }
+        if (mediaLine.mReceiverCapabilities) {
+          UseRTPTypesSerializer::writeJSONName(output, first, "receiverCapabilities");
+          UseRTPTypesSerializer::writeJSON(output, *mediaLine.mReceiverCapabilities);
+        }
+
+        output.append(1, '}');
+      }
+
+      //-----------------------------------------------------------------------
+      static void writeJSON(
+                            std::string &output,
+                            const ISessionDescriptionTypes::RTPSender &sender
+                            )
+      {
+        bool first = true;
+        output.append(1, '{');
+
+        writeJSONValue(output, first, "id", sender.mID);
+        if (sender.mDetails) {
+          writeJSONElement(output, first, sender.mDetails->createElement());
+        }
+        writeJSONValue(output, first, "rtpMediaLineId", sender.mRTPMediaLineID);
+        if (sender.mParameters) {
+          UseRTPTypesSerializer::writeJSONName(output, first, "rtpParameters");
+          UseRTPTypesSerializer::writeJSON(output, *sender.mParameters);
+        }
+        writeJSONValue(output, first, "mediaStreamTrackId", sender.mMediaStreamTrackID);
+        UseRTPTypesSerializer::writeJSONList(output, first, "mediaSteamIds", "mediaStreamId", sender.mMediaStreamIDs, [](std::string &itemOutput, const String &streamID) {
+          UseRTPTypesSerializer::writeJSONString(itemOutput, streamID.c_str());
+        });
+
+        output.append(1, '}');
+      }
+
+      //-----------------------------------------------------------------------
+      template <typename List>
+      static void writeJSONStreamedList(
+                                        std::string &output,
+                                        bool &ioFirst,
+                                        const char *listName,
+                                        const char *itemName,
+                                        const List &list
+                                        )
+      {
+        std::vector<typename List::value_type> items;
+        items.reserve(list.size());
+        for (auto iter = list.begin(); iter != list.end(); ++iter) {
+          if (!(*iter)) continue;
+          items.push_back(*iter);
+        }
+
+        UseRTPTypesSerializer::writeJSONList(output, ioFirst, listName, itemName, items, [](std::string &itemOutput, const typename List::value_type &item) {
+          writeJSON(itemOutput, *item);
+        });
+      }
+
+      //-----------------------------------------------------------------------
+      static bool writeJSON(
+                            std::string &output,
+                            const ISessionDescriptionTypes::Description &description
+                            )
+      {
+        bool first = true;
+        output.append(1, '{');
+
+        if (description.mDetails) {
+          writeJSONElement(output, first, description.mDetails->createElement());
+        }
+        writeJSONElementList(output, first, "transports", "transport", description.mTransports);
+        writeJSONStreamedList(output, first, "rtpMediaLines", "rtpMediaLine", description.mRTPMediaLines);
+        writeJSONElementList(output, first, "sctpMediaLines", "sctpMediaLine", description.mSCTPMediaLines);
+        writeJSONStreamedList(output, first, "rtpSenders", "rtpSender", description.mRTPSenders);
+
+        output.append(1, '}');
+        return !first;
+      }
+
+      //-----------------------------------------------------------------------
+      static ElementPtr readJSONElement(
+                                        UseJSONReader &reader,
+                                        const char *name
+                                        )
+      {
+        String value;
+        if (!reader.readRaw(value)) return ElementPtr();
+
+        String json = String("{\"") + name + "\":" + value + "}";
+        return IHelper::toJSON(json);
+      }
+
+      //-----------------------------------------------------------------------
+      static void readJSON(
+                           UseJSONReader &reader,
+                           ISessionDescriptionTypes::RTPMediaLine &mediaLine
+                           )
+      {
+        if (!reader.beginObject()) return;
+
+        String name;
+        while (reader.nextMember(name)) {
+          if ("id" == name) {reader.readScalar(mediaLine.mID); continue;}
+          if ("transportId" == name) {reader.readScalar(mediaLine.mTransportID); continue;}
+          if ("mediaType" == name) {reader.readScalar(mediaLine.mMediaType); continue;}
+          if ("details" == name) {
+            mediaLine.mDetails = ISessionDescriptionTypes::MediaLine::Details::create(readJSONElement(reader, "details"));
+            continue;
+          }
+          if ("senderCapabilities" == name) {
+            auto capabilities = make_shared<ISessionDescriptionTypes::RTPCapabilities>();
+            if (UseRTPTypesSerializer::readJSON(reader, *capabilities)) mediaLine.mSenderCapabilities = capabilities;
+            continue;
+          }
+          if ("receiverCapabilities" == name) {
+            auto capabilities = make_shared<ISessionDescriptionTypes::RTPCapabilities>();
+            if (UseRTPTypesSerializer::readJSON(reader, *capabilities)) mediaLine.mReceiverCapabilities = capabilities;
+            continue;
+          }
+          reader.skipValue();
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      static void readJSON(
+                           UseJSONReader &reader,
+                           ISessionDescriptionTypes::RTPSender &sender
+                           )
+      {
+        if (!reader.beginObject()) return;
+
+        String name;
+        while (reader.nextMember(name)) {
+          if ("id" == name) {reader.readScalar(sender.mID); continue;}
+          if ("details" == name) {
+            sender.mDetails = ISessionDescriptionTypes::RTPSender::Details::create(readJSONElement(reader, "details"));
+            continue;
+          }
+          if ("rtpMediaLineId" == name) {reader.readScalar(sender.mRTPMediaLineID); continue;}
+          if ("rtpParameters" == name) {
+            auto params = make_shared<ISessionDescriptionTypes::RTPParameters>();
+            if (UseRTPTypesSerializer::readJSON(reader, *params)) sender.mParameters = params;
+            continue;
+          }
+          if ("mediaStreamTrackId" == name) {reader.readScalar(sender.mMediaStreamTrackID); continue;}
+          if ("mediaSteamIds" == name) {
+            auto readStreamID = [&reader, &sender]() {
+              String streamID;
+              reader.readScalar(streamID);
+              if (streamID.isEmpty()) return;
+              sender.mMediaStreamIDs.insert(streamID);
+            };
+            // older writers named each item "mediaSteamId"
+            if (!reader.isNext('{')) {
+              reader.skipValue();
+              continue;
+            }
+            reader.beginObject();
+            String itemName;
+            while (reader.nextMember(itemName)) {
+              if (("mediaStreamId" != itemName) &&
+                  ("mediaSteamId" != itemName)) {
+                reader.skipValue();
+                continue;
+              }
+              if (reader.isNext('[')) {
+                reader.beginArray();
+                while (reader.nextItem()) {
+                  readStreamID();
+                }
+                continue;
+              }
+              readStreamID();
+            }
+            continue;
+          }
+          reader.skipValue();
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      static void readJSON(
+                           UseJSONReader &reader,
+                           ISessionDescriptionTypes::Description &description
+                           )
+      {
+        if (!reader.beginObject()) return;
+
+        String name;
+        while (reader.nextMember(name)) {
+          if ("details" == name) {
+            description.mDetails = ISessionDescriptionTypes::Description::Details::create(readJSONElement(reader, "details"));
+            continue;
+          }
+          if ("transports" == name) {
+            reader.readList("transport", [&reader, &description]() {
+              auto transport = ISessionDescriptionTypes::Transport::create(readJSONElement(reader, "transport"));
+              if (!transport) return;
+              description.mTransports.push_back(transport);
+            });
+            continue;
+          }
+          if ("rtpMediaLines" == name) {
+            reader.readList("rtpMediaLine", [&reader, &description]() {
+              auto mediaLine = make_shared<ISessionDescriptionTypes::RTPMediaLine>();
+              readJSON(reader, *mediaLine);
+              description.mRTPMediaLines.push_back(mediaLine);
+            });
+            continue;
+          }
+          if ("sctpMediaLines" == name) {
+            reader.readList("sctpMediaLine", [&reader, &description]() {
+              auto mediaLine = ISessionDescriptionTypes::SCTPMediaLine::create(readJSONElement(reader, "sctpMediaLine"));
+              if (!mediaLine) return;
+              description.mSCTPMediaLines.push_back(mediaLine);
+            });
+            continue;
+          }
+          if ("rtpSenders" == name) {
+            reader.readList("rtpSender", [&reader, &description]() {
+              auto sender = make_shared<ISessionDescriptionTypes::RTPSender>();
+              readJSON(reader, *sender);
+              description.mRTPSenders.push_back(sender);
+            });
+            continue;
+          }
+          reader.skipValue();
+        }
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -108,6 +446,54 @@ namespace ortc
         return ZS_DYNAMIC_PTR_CAST(SessionDescription, object);
       }
 
+      //-----------------------------------------------------------------------
+      String SessionDescription::toJSON(
+                                        const Description &description,
+                                        const char *objectName
+                                        )
+      {
+        std::string output;
+        output.reserve(1024 + (description.mRTPMediaLines.size() * 4096) + (description.mRTPSenders.size() * 1024));
+
+        bool first = true;
+        output.append(1, '{');
+        UseRTPTypesSerializer::writeJSONName(output, first, objectName);
+        if (!writeJSON(output, description)) return String();
+        output.append(1, '}');
+
+        return String(output);
+      }
+
+      //-----------------------------------------------------------------------
+      SessionDescription::DescriptionPtr SessionDescription::createDescriptionFromJSON(const char *json)
+      {
+        UseJSONReader reader(json);
+
+        DescriptionPtr result;
+
+        // the root object's name is not significant (as with Element parsing)
+        if (reader.beginObject()) {
+          String name;
+          while (reader.nextMember(name)) {
+            if (result) {
+              reader.skipValue();
+              continue;
+            }
+            result = make_shared<Description>();
+            readJSON(reader, *result);
+          }
+        }
+
+        if ((!result) ||
+            (reader.hasFailed()) ||
+            (!reader.isAtEnd())) {
+          ZS_LOG_WARNING(Debug, slog("unable to parse json session description"))
+          return DescriptionPtr();
+        }
+
+        return result;
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -165,8 +551,7 @@ namespace ortc
 
           switch (mType) {
             case SignalingType_JSON: {
-              auto rootEl = IHelper::toJSON(mFormattedString);
-              mDescription = ISessionDescriptionTypes::Description::create(rootEl);
+              mDescription = createDescriptionFromJSON(mFormattedString.c_str());
               break;
             }
             case SignalingType_SDPOffer:
@@ -195,10 +580,7 @@ namespace ortc
             case SignalingType_JSON: {
               if (!mDescription) return SignalingDescription();
 
-              ElementPtr rootEl = mDescription->createElement();
-              if (!rootEl) return SignalingDescription();
-
-              mFormattedString = zsLib::IHelper::toString(rootEl);
+              mFormattedString = toJSON(*mDescription);
               break;
             }
             case SignalingType_SDPOffer:
@@ -1016,7 +1398,7 @@ namespace ortc
         for (auto iter = mMediaStreamIDs.begin(); iter != mMediaStreamIDs.end(); ++iter)
         {
           auto streamID = (*iter);
-          IHelper::adoptElementValue(mediaStreamIDsEl, "mediaSteamId", streamID, false);
+          IHelper::adoptElementValue(mediaStreamIDsEl, "mediaStreamId", streamID, false);
         }
         if (mediaStreamIDsEl->hasChildren()) {
           rootEl->adoptAsLastChild(mediaStreamIDsEl);
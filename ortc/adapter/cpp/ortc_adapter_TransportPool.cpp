@@ -0,0 +1,555 @@
+/*
+
+ Copyright (c) 2016, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include <ortc/adapter/internal/ortc_adapter_TransportPool.h>
+
+#include <ortc/internal/ortc_ORTC.h>
+
+#include <ortc/services/IHelper.h>
+
+#include <zsLib/Log.h>
+#include <zsLib/XML.h>
+
+namespace ortc { namespace adapter { ZS_DECLARE_SUBSYSTEM(ortclib_adapter); } }
+
+namespace ortc
+{
+  namespace adapter
+  {
+    namespace internal
+    {
+      ZS_DECLARE_TYPEDEF_PTR(ortc::services::IHelper, UseServicesHelper);
+      ZS_DECLARE_TYPEDEF_PTR(ortc::internal::IORTCForInternal, UseORTC);
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TransportPool::Bundle
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      bool TransportPool::Bundle::isReady() const
+      {
+        if (!mRTPGatherer) return false;
+        if (IICEGathererTypes::State_Complete != mRTPGatherer->state()) return false;
+        if (!mRTCPGatherer) return true;
+        return IICEGathererTypes::State_Complete == mRTCPGatherer->state();
+      }
+
+      //-----------------------------------------------------------------------
+      bool TransportPool::Bundle::isClosed() const
+      {
+        if (!mRTPGatherer) return true;
+        if (IICEGathererTypes::State_Closed == mRTPGatherer->state()) return true;
+        if (!mRTCPGatherer) return false;
+        return IICEGathererTypes::State_Closed == mRTCPGatherer->state();
+      }
+
+      //-----------------------------------------------------------------------
+      ElementPtr TransportPool::Bundle::toDebug() const
+      {
+        ElementPtr resultEl = Element::create("ortc::adapter::TransportPool::Bundle");
+
+        UseServicesHelper::debugAppend(resultEl, "rtp ice gatherer", mRTPGatherer ? mRTPGatherer->getID() : 0);
+        UseServicesHelper::debugAppend(resultEl, "rtp ice transport", mRTPTransport ? mRTPTransport->getID() : 0);
+        UseServicesHelper::debugAppend(resultEl, "rtcp ice gatherer", mRTCPGatherer ? mRTCPGatherer->getID() : 0);
+        UseServicesHelper::debugAppend(resultEl, "rtcp ice transport", mRTCPTransport ? mRTCPTransport->getID() : 0);
+
+        return resultEl;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TransportPool
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      TransportPool::TransportPool(
+                                   const make_private &,
+                                   IMessageQueuePtr queue
+                                   ) :
+        MessageQueueAssociator(queue),
+        SharedRecursiveLock(SharedRecursiveLock::create())
+      {
+        ZS_LOG_DEBUG(log("created"));
+      }
+
+      //-----------------------------------------------------------------------
+      void TransportPool::init()
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      TransportPool::~TransportPool()
+      {
+        mThisWeak.reset();
+        ZS_LOG_DEBUG(log("destroyed"));
+
+        AutoRecursiveLock lock(*this);
+        flush();
+      }
+
+      //-----------------------------------------------------------------------
+      TransportPoolPtr TransportPool::singleton()
+      {
+        AutoRecursiveLock lock(*UseServicesHelper::getGlobalLock());
+        static zsLib::SingletonLazySharedPtr<TransportPool> singleton(create());
+        TransportPoolPtr result = singleton.singleton();
+
+        static zsLib::SingletonManager::Register registerSingleton("org.ortc.adapter.TransportPool", result);
+
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      void TransportPool::configure(
+                                    const Configuration &configuration,
+                                    size_t targetDepth
+                                    )
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (mShutdown) {
+          ZS_LOG_WARNING(Detail, log("cannot configure transport pool after shutdown"));
+          return;
+        }
+
+        String gatherOptionsHash = hash(configuration.mGatherOptions);
+
+        if ((gatherOptionsHash != mGatherOptionsHash) ||
+            (configuration.mRTCPMuxPolicy != mConfiguration.mRTCPMuxPolicy)) {
+          ZS_LOG_DETAIL(log("transport pool configuration changed (thus flushing pooled transports)") + ZS_PARAM("total bundles", mBundles.size()));
+          for (auto iter = mBundles.begin(); iter != mBundles.end(); ++iter) {
+            close(*(*iter));
+          }
+          mBundles.clear();
+        }
+
+        mConfiguration = configuration;
+        mGatherOptionsHash = gatherOptionsHash;
+        mTargetDepth = targetDepth;
+
+        while (mBundles.size() > mTargetDepth) {
+          close(*(mBundles.back()));
+          mBundles.pop_back();
+        }
+        while (mCertificates.size() > mTargetDepth) {
+          mCertificates.pop_back();
+        }
+
+        ZS_LOG_DETAIL(debug("transport pool configured"));
+
+        wake();
+      }
+
+      //-----------------------------------------------------------------------
+      TransportPool::BundlePtr TransportPool::claim(
+                                                    const String &gatherOptionsHash,
+                                                    RTCPMuxPolicies rtcpMuxPolicy
+                                                    )
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (0 == mTargetDepth) return BundlePtr();
+
+        if ((gatherOptionsHash != mGatherOptionsHash) ||
+            (rtcpMuxPolicy != mConfiguration.mRTCPMuxPolicy)) {
+          ZS_LOG_TRACE(log("pooled transports do not match requested configuration") + ZS_PARAM("gather options hash", gatherOptionsHash) + ZS_PARAM("rtcp mux policy", IPeerConnectionTypes::toString(rtcpMuxPolicy)));
+          ++mTotalMissed;
+          return BundlePtr();
+        }
+
+        BundlePtr result;
+
+        for (auto iter_doNotUse = mBundles.begin(); iter_doNotUse != mBundles.end(); ) {
+          auto current = iter_doNotUse;
+          ++iter_doNotUse;
+
+          auto bundle = (*current);
+          if (bundle->isClosed()) {
+            ZS_LOG_WARNING(Debug, log("discarding closed pooled transport") + bundle->toDebug());
+            close(*bundle);
+            mBundles.erase(current);
+            continue;
+          }
+
+          if (!bundle->isReady()) continue;
+
+          result = bundle;
+          mBundles.erase(current);
+          break;
+        }
+
+        if ((!result) &&
+            (mBundles.size() > 0)) {
+          // nothing has finished gathering yet but the oldest bundle is still
+          // further along than starting from scratch
+          result = mBundles.front();
+          mBundles.pop_front();
+        }
+
+        if (!result) {
+          ZS_LOG_WARNING(Debug, log("transport pool is exhausted"));
+          ++mTotalMissed;
+        } else {
+          ZS_LOG_DEBUG(log("claimed pooled transport") + result->toDebug() + ZS_PARAM("remaining", mBundles.size()));
+          ++mTotalClaimed;
+        }
+
+        wake();
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      ICertificatePtr TransportPool::claimCertificate()
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (mCertificates.size() < 1) return ICertificatePtr();
+
+        auto certificate = mCertificates.front();
+        mCertificates.pop_front();
+
+        wake();
+        return certificate;
+      }
+
+      //-----------------------------------------------------------------------
+      String TransportPool::hash(const IICEGathererTypes::OptionsPtr &options)
+      {
+        if (!options) return IICEGathererTypes::Options().hash();
+        return options->hash();
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TransportPool => IICEGathererDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void TransportPool::onICEGathererStateChange(
+                                                   IICEGathererPtr gatherer,
+                                                   IICEGatherer::States state
+                                                   )
+      {
+        ZS_LOG_TRACE(log("on ice gatherer state change") + ZS_PARAM("gatherer id", gatherer->getID()) + ZS_PARAM("state", IICEGathererTypes::toString(state)));
+
+        if (IICEGathererTypes::State_Closed != state) return;
+
+        AutoRecursiveLock lock(*this);
+        wake();
+      }
+
+      //-----------------------------------------------------------------------
+      void TransportPool::onICEGathererLocalCandidate(
+                                                      IICEGathererPtr gatherer,
+                                                      CandidatePtr candidate
+                                                      )
+      {
+        // ignored
+      }
+
+      //-----------------------------------------------------------------------
+      void TransportPool::onICEGathererLocalCandidateComplete(
+                                                              IICEGathererPtr gatherer,
+                                                              CandidateCompletePtr candidate
+                                                              )
+      {
+        // ignored
+      }
+
+      //-----------------------------------------------------------------------
+      void TransportPool::onICEGathererLocalCandidateGone(
+                                                          IICEGathererPtr gatherer,
+                                                          CandidatePtr candidate
+                                                          )
+      {
+        // ignored
+      }
+
+      //-----------------------------------------------------------------------
+      void TransportPool::onICEGathererError(
+                                             IICEGathererPtr gatherer,
+                                             ErrorEventPtr errorEvent
+                                             )
+      {
+        // ignored
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TransportPool => IWakeDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void TransportPool::onWake()
+      {
+        ZS_LOG_TRACE(log("on wake"));
+
+        AutoRecursiveLock lock(*this);
+        mWakeScheduled = false;
+        refill();
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TransportPool => IPromiseSettledDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void TransportPool::onPromiseSettled(PromisePtr promise)
+      {
+        ZS_LOG_TRACE(log("on promise settled"));
+
+        AutoRecursiveLock lock(*this);
+
+        for (auto iter_doNotUse = mPendingCertificates.begin(); iter_doNotUse != mPendingCertificates.end(); ) {
+          auto current = iter_doNotUse;
+          ++iter_doNotUse;
+
+          auto pending = (*current);
+          if (!pending->isSettled()) continue;
+
+          mPendingCertificates.erase(current);
+
+          if (pending->isRejected()) {
+            ZS_LOG_WARNING(Detail, log("pooled certificate generation was rejected"));
+            continue;
+          }
+
+          auto certificate = pending->value();
+          if (!certificate) continue;
+          if (mShutdown) continue;
+
+          mCertificates.push_back(certificate);
+        }
+
+        wake();
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TransportPool => ISingletonManagerDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void TransportPool::notifySingletonCleanup()
+      {
+        AutoRecursiveLock lock(*this);
+        mShutdown = true;
+        flush();
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TransportPool => (internal)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      TransportPoolPtr TransportPool::create()
+      {
+        auto pThis = make_shared<TransportPool>(make_private{}, UseORTC::queueORTC());
+        pThis->mThisWeak = pThis;
+        pThis->init();
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      Log::Params TransportPool::log(const char *message) const
+      {
+        ElementPtr objectEl = Element::create("ortc::adapter::TransportPool");
+        UseServicesHelper::debugAppend(objectEl, "id", mID);
+        return Log::Params(message, objectEl);
+      }
+
+      //-----------------------------------------------------------------------
+      Log::Params TransportPool::slog(const char *message)
+      {
+        return Log::Params(message, "ortc::adapter::TransportPool");
+      }
+
+      //-----------------------------------------------------------------------
+      Log::Params TransportPool::debug(const char *message) const
+      {
+        return Log::Params(message, toDebug());
+      }
+
+      //-----------------------------------------------------------------------
+      ElementPtr TransportPool::toDebug() const
+      {
+        AutoRecursiveLock lock(*this);
+
+        ElementPtr resultEl = Element::create("ortc::adapter::TransportPool");
+
+        UseServicesHelper::debugAppend(resultEl, "id", mID);
+
+        UseServicesHelper::debugAppend(resultEl, "gather options hash", mGatherOptionsHash);
+        UseServicesHelper::debugAppend(resultEl, "rtcp mux policy", IPeerConnectionTypes::toString(mConfiguration.mRTCPMuxPolicy));
+        UseServicesHelper::debugAppend(resultEl, "target depth", mTargetDepth);
+
+        UseServicesHelper::debugAppend(resultEl, "wake scheduled", mWakeScheduled);
+        UseServicesHelper::debugAppend(resultEl, "shutdown", mShutdown);
+
+        UseServicesHelper::debugAppend(resultEl, "bundles", mBundles.size());
+        UseServicesHelper::debugAppend(resultEl, "certificates", mCertificates.size());
+        UseServicesHelper::debugAppend(resultEl, "pending certificates", mPendingCertificates.size());
+
+        UseServicesHelper::debugAppend(resultEl, "total claimed", mTotalClaimed);
+        UseServicesHelper::debugAppend(resultEl, "total missed", mTotalMissed);
+
+        return resultEl;
+      }
+
+      //-----------------------------------------------------------------------
+      void TransportPool::wake()
+      {
+        if (mWakeScheduled) return;
+        mWakeScheduled = true;
+        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+      }
+
+      //-----------------------------------------------------------------------
+      void TransportPool::refill()
+      {
+        if (mShutdown) return;
+
+        for (auto iter_doNotUse = mBundles.begin(); iter_doNotUse != mBundles.end(); ) {
+          auto current = iter_doNotUse;
+          ++iter_doNotUse;
+
+          auto bundle = (*current);
+          if (!bundle->isClosed()) continue;
+
+          ZS_LOG_WARNING(Debug, log("discarding closed pooled transport") + bundle->toDebug());
+          close(*bundle);
+          mBundles.erase(current);
+        }
+
+        while (mBundles.size() < mTargetDepth) {
+          auto bundle = createBundle();
+          if (!bundle) break;
+          mBundles.push_back(bundle);
+        }
+
+        while ((mCertificates.size() + mPendingCertificates.size()) < mTargetDepth) {
+          auto promise = ICertificate::generateCertificate();
+          if (!promise) {
+            ZS_LOG_WARNING(Detail, log("unable to generate pooled certificate"));
+            break;
+          }
+          mPendingCertificates.push_back(promise);
+          promise->thenWeak(mThisWeak.lock());
+        }
+
+        ZS_LOG_TRACE(debug("refilled"));
+      }
+
+      //-----------------------------------------------------------------------
+      TransportPool::BundlePtr TransportPool::createBundle()
+      {
+        BundlePtr bundle(make_shared<Bundle>());
+
+        try {
+          IICEGatherer::Options emptyOptions;
+          bundle->mRTPGatherer = IICEGatherer::create(mThisWeak.lock(), mConfiguration.mGatherOptions ? (*(mConfiguration.mGatherOptions)) : emptyOptions);
+          bundle->mRTPGatherer->gather();
+          bundle->mRTPTransport = IICETransport::create(IICETransportDelegatePtr(), bundle->mRTPGatherer);
+
+          if (IPeerConnectionTypes::RTCPMuxPolicy_Negotiated == mConfiguration.mRTCPMuxPolicy) {
+            bundle->mRTCPGatherer = bundle->mRTPGatherer->createAssociatedGatherer(mThisWeak.lock());
+            bundle->mRTCPTransport = bundle->mRTPTransport->createAssociatedTransport(IICETransportDelegatePtr());
+          }
+        } catch (const InvalidStateError &) {
+          ZS_LOG_WARNING(Detail, log("unable to create pooled transport") + bundle->toDebug());
+          close(*bundle);
+          return BundlePtr();
+        }
+
+        ZS_LOG_DEBUG(log("created pooled transport") + bundle->toDebug());
+        return bundle;
+      }
+
+      //-----------------------------------------------------------------------
+      void TransportPool::close(Bundle &bundle)
+      {
+        if (bundle.mRTCPTransport) {
+          bundle.mRTCPTransport->stop();
+          bundle.mRTCPTransport.reset();
+        }
+        if (bundle.mRTPTransport) {
+          bundle.mRTPTransport->stop();
+          bundle.mRTPTransport.reset();
+        }
+        if (bundle.mRTCPGatherer) {
+          bundle.mRTCPGatherer->close();
+          bundle.mRTCPGatherer.reset();
+        }
+        if (bundle.mRTPGatherer) {
+          bundle.mRTPGatherer->close();
+          bundle.mRTPGatherer.reset();
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void TransportPool::flush()
+      {
+        for (auto iter = mBundles.begin(); iter != mBundles.end(); ++iter) {
+          close(*(*iter));
+        }
+        mBundles.clear();
+        mCertificates.clear();
+        mPendingCertificates.clear();
+      }
+
+    } // namespace internal
+  } // namespace adapter
+} // namespace ortc
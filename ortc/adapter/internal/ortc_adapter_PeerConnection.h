@@ -185,6 +185,8 @@ namespace ortc
           {
             IICEGathererPtr mGatherer;
             IICETransportPtr mTransport;
+            IICEGathererSubscriptionPtr mGathererSubscription;    // only for gatherers claimed from the shared transport pool
+            IICETransportSubscriptionPtr mTransportSubscription;  // only for transports claimed from the shared transport pool
             bool mRTPEndOfCandidates {false};
 
             IDTLSTransportPtr mDTLSTransport;
@@ -662,6 +664,7 @@ namespace ortc
 
         TransportInfoPtr getTransportFromPool(const char *useID = NULL);
         void addToTransportPool();
+        bool addToTransportPoolFromSharedPool();
 
         String registerNewID(size_t length = 3);
         String registerIDUsage(const char *idStr);
@@ -798,6 +801,11 @@ namespace ortc
                                          );
 
         virtual ServerListPtr getDefaultIceServers();
+
+        virtual void setSharedTransportPool(
+                                            const Configuration &configuration,
+                                            size_t targetDepth
+                                            );
       };
 
       class PeerConnectionFactory : public IFactory<IPeerConnectionFactory> {};
@@ -526,6 +526,7 @@ namespace ortc
           ACandidateLine(const Noop &) : AMediaLine(nullptr) {}
           ACandidateLine(MLinePtr mline, const char *value);
           String toString() const;
+          void appendTo(String &ioResult) const;
           static String toString(const ACandidateLinePtr &line) { if (!line) return String(); return line->toString(); }
         };
 
@@ -896,10 +897,15 @@ namespace ortc
                                        const SDP &sdp,
                                        String &ioResult
                                        );
+        static void generateMediaLine(
+                                      const MLine &mline,
+                                      String &ioResult
+                                      );
 
       public:
         static SDPPtr parse(const char *blob);
         static String generate(const SDP &sdp);
+        static size_t estimateGeneratedSize(const SDP &sdp);
 
         static SDPPtr createSDP(
                                 const GeneratorOptions &options,
@@ -71,6 +71,14 @@ namespace ortc
 
         static SessionDescriptionPtr convert(ISessionDescriptionPtr object);
 
+        // streams the JSON signaling form without building an Element tree
+        // for the whole description
+        static String toJSON(
+                             const Description &description,
+                             const char *objectName = "session"
+                             );
+        static DescriptionPtr createDescriptionFromJSON(const char *json);
+
         //---------------------------------------------------------------------
         #pragma mark
         #pragma mark SessionDescription => ISessionDescription
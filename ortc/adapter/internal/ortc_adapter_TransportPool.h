@@ -0,0 +1,227 @@
+/*
+
+ Copyright (c) 2016, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#pragma once
+
+#include <ortc/adapter/internal/types.h>
+
+#include <ortc/adapter/IPeerConnection.h>
+
+#include <ortc/ICertificate.h>
+#include <ortc/IICEGatherer.h>
+#include <ortc/IICETransport.h>
+
+#include <zsLib/Singleton.h>
+
+#include <list>
+
+namespace ortc
+{
+  namespace adapter
+  {
+    namespace internal
+    {
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TransportPool
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      // Process wide pool of pre-gathered ICE gatherer/transport bundles
+      // (and pre-generated certificates) that any PeerConnection whose
+      // gather options and RTCP mux policy match the pool's configuration
+      // can claim without waiting on interface enumeration, socket binds,
+      // STUN/TURN allocations or key generation. The pool is refilled in
+      // the background to its target depth after every claim.
+
+      class TransportPool : public Noop,
+                            public MessageQueueAssociator,
+                            public SharedRecursiveLock,
+                            public IICEGathererDelegate,
+                            public IWakeDelegate,
+                            public IPromiseSettledDelegate,
+                            public zsLib::ISingletonManagerDelegate
+      {
+      protected:
+        struct make_private {};
+
+      public:
+        typedef IPeerConnectionTypes::Configuration Configuration;
+        typedef IPeerConnectionTypes::RTCPMuxPolicies RTCPMuxPolicies;
+        typedef std::list<ICertificateTypes::PromiseWithCertificatePtr> CertificatePromiseList;
+        typedef std::list<ICertificatePtr> CertificateList;
+
+        struct Bundle
+        {
+          IICEGathererPtr mRTPGatherer;
+          IICETransportPtr mRTPTransport;
+          IICEGathererPtr mRTCPGatherer;
+          IICETransportPtr mRTCPTransport;
+
+          bool isReady() const;
+          bool isClosed() const;
+
+          ElementPtr toDebug() const;
+        };
+        ZS_DECLARE_PTR(Bundle);
+
+        typedef std::list<BundlePtr> BundleList;
+
+      public:
+        TransportPool(
+                      const make_private &,
+                      IMessageQueuePtr queue
+                      );
+
+      protected:
+        void init();
+
+      public:
+        virtual ~TransportPool();
+
+        static TransportPoolPtr singleton();
+
+        void configure(
+                       const Configuration &configuration,
+                       size_t targetDepth
+                       );
+
+        BundlePtr claim(
+                        const String &gatherOptionsHash,
+                        RTCPMuxPolicies rtcpMuxPolicy
+                        );
+        ICertificatePtr claimCertificate();
+
+        static String hash(const IICEGathererTypes::OptionsPtr &options);
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark TransportPool => IICEGathererDelegate
+        #pragma mark
+
+        virtual void onICEGathererStateChange(
+                                              IICEGathererPtr gatherer,
+                                              IICEGatherer::States state
+                                              ) override;
+
+        virtual void onICEGathererLocalCandidate(
+                                                 IICEGathererPtr gatherer,
+                                                 CandidatePtr candidate
+                                                 ) override;
+
+        virtual void onICEGathererLocalCandidateComplete(
+                                                         IICEGathererPtr gatherer,
+                                                         CandidateCompletePtr candidate
+                                                         ) override;
+
+        virtual void onICEGathererLocalCandidateGone(
+                                                     IICEGathererPtr gatherer,
+                                                     CandidatePtr candidate
+                                                     ) override;
+
+        virtual void onICEGathererError(
+                                        IICEGathererPtr gatherer,
+                                        ErrorEventPtr errorEvent
+                                        ) override;
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark TransportPool => IWakeDelegate
+        #pragma mark
+
+        virtual void onWake() override;
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark TransportPool => IPromiseSettledDelegate
+        #pragma mark
+
+        virtual void onPromiseSettled(PromisePtr promise) override;
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark TransportPool => ISingletonManagerDelegate
+        #pragma mark
+
+        virtual void notifySingletonCleanup() override;
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark TransportPool => (internal)
+        #pragma mark
+
+        static TransportPoolPtr create();
+
+        Log::Params log(const char *message) const;
+        static Log::Params slog(const char *message);
+        Log::Params debug(const char *message) const;
+        ElementPtr toDebug() const;
+
+        void wake();
+        void refill();
+        BundlePtr createBundle();
+        void close(Bundle &bundle);
+        void flush();
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark TransportPool => (data)
+        #pragma mark
+
+        AutoPUID mID;
+        TransportPoolWeakPtr mThisWeak;
+
+        Configuration mConfiguration;
+        String mGatherOptionsHash;
+        size_t mTargetDepth {};
+
+        bool mWakeScheduled {false};
+        bool mShutdown {false};
+
+        BundleList mBundles;
+
+        CertificateList mCertificates;
+        CertificatePromiseList mPendingCertificates;
+
+        size_t mTotalClaimed {};
+        size_t mTotalMissed {};
+      };
+
+    }
+  }
+}
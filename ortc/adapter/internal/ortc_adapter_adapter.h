@@ -39,3 +39,4 @@ either expressed or implied, of the FreeBSD Project.
 #include <ortc/adapter/internal/ortc_adapter_SDPParser.h>
 #include <ortc/adapter/internal/ortc_adapter_SessionDescription.h>
 #include <ortc/adapter/internal/ortc_adapter_PeerConnection.h>
+#include <ortc/adapter/internal/ortc_adapter_TransportPool.h>
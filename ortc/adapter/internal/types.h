@@ -76,6 +76,7 @@ namespace ortc
       ZS_DECLARE_CLASS_PTR(SDPParser);
       ZS_DECLARE_CLASS_PTR(SessionDescription);
       ZS_DECLARE_CLASS_PTR(PeerConnection);
+      ZS_DECLARE_CLASS_PTR(TransportPool);
 
       ZS_DECLARE_INTERACTION_PROXY(IPeerConnectionAsyncDelegate);
 
@@ -36,6 +36,8 @@
 #include <ortc/internal/ortc_SRTPTransport.h>
 #include <ortc/internal/ortc_Helper.h>
 #include <ortc/internal/ortc_ORTC.h>
+#include <ortc/internal/ortc_ReceiveLatency.h>
+#include <ortc/internal/ortc_StatsCounters.h>
 #include <ortc/internal/ortc.events.h>
 #include <ortc/internal/platform.h>
 
@@ -90,6 +92,8 @@ namespace ortc
   namespace internal
   {
     ZS_DECLARE_CLASS_PTR(DTLSTransportSettingsDefaults);
+    ZS_DECLARE_TYPEDEF_PTR(IReceiveLatencyForInternal, UseReceiveLatency);
+    ZS_DECLARE_TYPEDEF_PTR(IStatsCountersForInternal, UseStatsCounters);
 
     typedef DTLSTransport::StreamResult StreamResult;
 
@@ -386,6 +390,7 @@ namespace ortc
       MessageQueueAssociator(queue),
       SharedRecursiveLock(SharedRecursiveLock::create()),
       mICETransport(ICETransport::convert(iceTransport)),
+      mHandshakeQueue(IORTCForInternal::queueDTLSHandshake()),
       mComponent(mICETransport->component()),
       mMaxPendingDTLSBuffer(ISettings::getUInt(ORTC_SETTING_DTLS_TRANSPORT_MAX_PENDING_DTLS_BUFFER)),
       mMaxPendingRTPPackets(ISettings::getUInt(ORTC_SETTING_DTLS_TRANSPORT_MAX_PENDING_RTP_PACKETS))
@@ -497,6 +502,8 @@ namespace ortc
                       );
       }
 
+      mStatsCounters = UseStatsCounters::registerObject(mID, IStatsReportTypes::StatsType_DTLSTransport);
+
       transport->notifyAttached(mID, mThisWeak.lock());
 
       IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
@@ -732,8 +739,12 @@ namespace ortc
                           string, role, IDTLSTransportTypes::toString(IDTLSTransportTypes::Role_Server)
                           );
             mFixedRole = true;
-            mAdapter->setServerRole();
-            mAdapter->startSSLWithPeer();
+            {
+              AutoRecursiveLock adapterLock(mAdapterLock);
+              mAdapter->setServerRole();
+              mAdapter->startSSLWithPeer();
+            }
+            mHandshakeActive = true;
             break;
           }
           case IDTLSTransportTypes::Role_Server: {
@@ -743,7 +754,11 @@ namespace ortc
                           string, role, IDTLSTransportTypes::toString(IDTLSTransportTypes::Role_Client)
                           );
             mFixedRole = true;
-            mAdapter->startSSLWithPeer();
+            {
+              AutoRecursiveLock adapterLock(mAdapterLock);
+              mAdapter->startSSLWithPeer();
+            }
+            mHandshakeActive = true;
             break;
           }
         }
@@ -857,6 +872,8 @@ namespace ortc
                                              size_t bufferLengthInBytes
                                              )
     {
+      UseReceiveLatency::stage(IReceiveLatencyTypes::Stage_DTLSTransport);
+
       bool isDTLSPacket = isDtlsPacket(buffer, bufferLengthInBytes);
 
       StreamResult streamResult {};
@@ -878,6 +895,15 @@ namespace ortc
 
       ASSERT(viaTransport == component());  // must be identical
 
+      if ((isDTLSPacket) &&
+          (mHandshakeActive)) {
+        // the handshake worker may be inside the adapter for a while; hand
+        // the record over without waiting on the object lock
+        if (!queueIncomingDTLS(buffer, bufferLengthInBytes)) return false;
+        scheduleHandshake();
+        return true;
+      }
+
       // scope: pre-validation check
       {
         AutoRecursiveLock lock(*this);
@@ -897,31 +923,7 @@ namespace ortc
         ZS_THROW_BAD_STATE_IF(!mAdapter)
 
         if (isDTLSPacket) {
-          // Sanity check we're not passing junk that
-          // just looks like DTLS.
-          const BYTE * tmp_data = buffer;
-          size_t tmp_size = bufferLengthInBytes;
-          while (tmp_size > 0) {
-            if (tmp_size < kDtlsRecordHeaderLen) {
-              ZS_LOG_WARNING(Trace, log("too short for the DTLS header") + ZS_PARAM("buffer length", bufferLengthInBytes) + ZS_PARAM("tmp size", tmp_size))
-              return false;
-            }
-
-            size_t record_len = (tmp_data[11] << 8) | (tmp_data[12]);
-            if ((record_len + kDtlsRecordHeaderLen) > tmp_size) {
-              ZS_LOG_WARNING(Trace, log("DTLS body is too short") + ZS_PARAM("buffer length", bufferLengthInBytes) + ZS_PARAM("record len", record_len) + ZS_PARAM("tmp size", tmp_size))
-              return false;
-            }
-
-            tmp_data += record_len + kDtlsRecordHeaderLen;
-            tmp_size -= record_len + kDtlsRecordHeaderLen;
-          }
-
-          if (mPendingIncomingDTLS.CurrentSize() < mMaxPendingDTLSBuffer) {
-            mPendingIncomingDTLS.Put(buffer, bufferLengthInBytes);
-          } else {
-            ZS_LOG_WARNING(Debug, log("too many pending dtls packets (thus ignoring incoming dtls packet)"))
-          }
+          if (!queueIncomingDTLS(buffer, bufferLengthInBytes)) return false;
 
           if (!mFixedRole) {
             ZS_EVENTING_2(
@@ -931,27 +933,27 @@ namespace ortc
                           );
 
             mFixedRole = true;
-            mAdapter->setServerRole();
-            mAdapter->startSSLWithPeer();
+            {
+              AutoRecursiveLock adapterLock(mAdapterLock);
+              mAdapter->setServerRole();
+            }
+            mHandshakeStartPending = true;
+            mHandshakeActive = true;
           }
 
-          BYTE extractedBuffer[kMaxDtlsPacketLen] {};
-
-          while (true) {
-            size_t read = 0;
-            streamResult = mAdapter->read(extractedBuffer, sizeof(extractedBuffer), &read, &streamError);
-
-            switch (streamResult) {
-              case SR_SUCCESS: {
-                decryptedPackets.push(make_shared<SecureByteBlock>(extractedBuffer, read));
-                break;
-              }
-              case SR_BLOCK: 
-              case SR_EOS:  
-              case SR_ERROR:  goto handle_data_packet;
-            }
+          if ((mHandshakeStartPending) ||
+              (mHandshakeActive) ||
+              (mHandshakeProcessingScheduled)) {
+            // certificate verification and key exchange must not stall other
+            // transports sharing this packet thread
+            scheduleHandshake();
+            return true;
           }
 
+          {
+            AutoRecursiveLock adapterLock(mAdapterLock);
+            readPendingIncomingDTLS(decryptedPackets, streamResult, streamError);
+          }
           goto handle_data_packet;
         }
 
@@ -998,46 +1000,7 @@ namespace ortc
 
     handle_data_packet:
       {
-        wakeUpIfNeeded();
-
-        bool returnResult {true};
-
-        while (decryptedPackets.size() > 0) {
-          SecureByteBlockPtr decryptedPacket = decryptedPackets.front();
-          decryptedPackets.pop();
-
-          ZS_EVENTING_5(
-                        x, i, Trace, DtlsTransportForwardingPacketToDataTransport, ol, DtlsTransport, Deliver,
-                        puid, id, mID,
-                        puid, dataTransportId, mDataTransport->getID(),
-                        enum, viaTransport, zsLib::to_underlying(viaTransport),
-                        buffer, packet, decryptedPacket->BytePtr(),
-                        size, size, decryptedPacket->SizeInBytes()
-                        );
-
-          auto result = mDataTransport->handleDataPacket(decryptedPacket->BytePtr(), decryptedPacket->SizeInBytes());
-          if (!result) returnResult = false;
-        }
-
-        switch (streamResult) {
-          case SR_SUCCESS:  break;
-          case SR_BLOCK: {
-            ZS_LOG_TRACE(log("dtls packet consumed"));
-            break;
-          }
-          case SR_EOS: {
-            ZS_LOG_DEBUG(log("end of stream reached (thus shutting down)"));
-            cancel();
-            break;
-          }
-          case SR_ERROR: {
-            ZS_LOG_ERROR(Debug, log("read error found (thus shutting down)") + ZS_PARAM("error code", streamError));
-            cancel();
-            break;
-          }
-        }
-
-        return returnResult;
+        return handleDecryptedPackets(viaTransport, decryptedPackets, streamResult, streamError);
       }
 
       ASSERT(false); // cannot reach this point
@@ -1115,6 +1078,48 @@ namespace ortc
       return transport->sendPacket(buffer, bufferLengthInBytes);
     }
 
+    //-------------------------------------------------------------------------
+    bool DTLSTransport::sendEncryptedPackets(
+                                             IICETypes::Components sendOverICETransport,
+                                             IICETypes::Components packetType,
+                                             const PacketBufferRefList &packets
+                                             )
+    {
+      UseICETransportPtr transport;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if ((isShuttingDown()) ||
+            (isShutdown())) {
+          ZS_LOG_WARNING(Debug, log("cannot send encrypted packets while shutdown") + ZS_PARAM("send over component", IICETypes::toString(sendOverICETransport)) + ZS_PARAM("packet type", packetType) + ZS_PARAM("packets", packets.size()))
+          return false;
+        }
+
+        transport = mICETransport;
+        if (!transport) {
+          ZS_LOG_WARNING(Debug, log("ice transport is not available") + ZS_PARAM("send over component", IICETypes::toString(sendOverICETransport)) + ZS_PARAM("packet type", packetType) + ZS_PARAM("packets", packets.size()))
+          return false;
+        }
+
+        ASSERT(sendOverICETransport == transport->component())
+      }
+
+      for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+        ZS_EVENTING_6(
+                      x, i, Trace, DtlsTransportSendEncryptedRtpPacket, ol, DtlsTransport, Send,
+                      puid, id, mID,
+                      puid, iceTransportId, transport->getID(),
+                      enum, sendOverComponent, zsLib::to_underlying(sendOverICETransport),
+                      enum, packetType, zsLib::to_underlying(packetType),
+                      buffer, packet, (*iter).mBuffer,
+                      size, size, (*iter).mSize
+                      );
+      }
+
+      return transport->sendPackets(packets);
+    }
+
     //-------------------------------------------------------------------------
     bool DTLSTransport::handleReceivedDecryptedPacket(
                                                       IICETypes::Components viaTransport,
@@ -1209,6 +1214,7 @@ namespace ortc
 
       if (!mAdapter) return false;
 
+      AutoRecursiveLock adapterLock(mAdapterLock);
       switch (mAdapter->role())
       {
         case Adapter::SSL_CLIENT: return true;
@@ -1262,7 +1268,11 @@ namespace ortc
         size_t written {};
         int error {};
 
-        auto result = mAdapter->write(buffer, bufferLengthInBytes, &written, &error);
+        StreamResult result {};
+        {
+          AutoRecursiveLock adapterLock(mAdapterLock);
+          result = mAdapter->write(buffer, bufferLengthInBytes, &written, &error);
+        }
 
         wakeUpIfNeeded();
 
@@ -1331,7 +1341,10 @@ namespace ortc
       ZS_LOG_DEBUG(log("timer") + ZS_PARAM("timer id", timer->getID()));
 
       AutoRecursiveLock lock(*this);
-      mAdapter->onTimer(timer);
+      {
+        AutoRecursiveLock adapterLock(mAdapterLock);
+        mAdapter->onTimer(timer);
+      }
 
       wakeUpIfNeeded();
     }
@@ -1360,7 +1373,10 @@ namespace ortc
         }
 
         transport = mICETransport;
+      }
 
+      {
+        AutoLock outgoingLock(mPendingOutgoingDTLSLock);
         packets = mPendingOutgoingDTLS;
         mPendingOutgoingDTLS = PacketQueue();
         goto send_packets;
@@ -1423,6 +1439,88 @@ namespace ortc
       }
     }
 
+    //-------------------------------------------------------------------------
+    void DTLSTransport::onProcessPendingHandshake()
+    {
+      ZS_LOG_TRACE(log("on process pending handshake"))
+
+      IICETypes::Components viaTransport = component();
+
+      PacketQueue decryptedPackets;
+      StreamResult streamResult {SR_BLOCK};
+      int streamError {};
+
+      bool startPending {};
+      bool completed {};
+      Microseconds processingTime {};
+      size_t queueDepth {};
+
+      // allow the next incoming record to schedule another pass
+      mHandshakeProcessingScheduled = false;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (isShutdown()) {
+          ZS_LOG_WARNING(Detail, log("already shutdown (thus discarding pending handshake)"))
+          return;
+        }
+
+        if (!mAdapter) return;
+
+        startPending = mHandshakeStartPending;
+        mHandshakeStartPending = false;
+      }
+
+      // scope: sample this transport's own backlog (not the shared pool
+      // queue) as the pass starts
+      {
+        {
+          AutoLock incomingLock(mPendingIncomingDTLSLock);
+          queueDepth += mPendingIncomingDTLSRecords;
+        }
+        {
+          AutoLock outgoingLock(mPendingOutgoingDTLSLock);
+          queueDepth += mPendingOutgoingDTLS.size();
+        }
+      }
+
+      // scope: adapter crypto runs without the object lock so the packet
+      // thread can keep queuing records for this transport
+      {
+        AutoRecursiveLock adapterLock(mAdapterLock);
+
+        auto started = zsLib::now();
+
+        if (startPending) mAdapter->startSSLWithPeer();
+
+        readPendingIncomingDTLS(decryptedPackets, streamResult, streamError);
+
+        completed = (Adapter::SS_OPENING != mAdapter->getState());
+        processingTime = zsLib::toMicroseconds(zsLib::now() - started);
+      }
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        mHandshakeProcessingTime += processingTime;
+
+        if (mStatsCounters) mStatsCounters->set(IStatsCountersTypes::Counter_HandshakeQueueDepth, queueDepth);
+
+        if ((completed) &&
+            (mHandshakeActive)) {
+          mHandshakeActive = false;
+
+          ZS_LOG_DEBUG(log("handshake processing complete") + ZS_PARAM("processing time (us)", mHandshakeProcessingTime.count()))
+
+          if (mStatsCounters) mStatsCounters->set(IStatsCountersTypes::Counter_HandshakeProcessingTime, static_cast<QWORD>(mHandshakeProcessingTime.count()));
+          mHandshakeProcessingTime = Microseconds();
+        }
+      }
+
+      handleDecryptedPackets(viaTransport, decryptedPackets, streamResult, streamError);
+    }
+
     //-------------------------------------------------------------------------
     void DTLSTransport::onDeliverPendingIncomingRTP()
     {
@@ -1579,7 +1677,9 @@ namespace ortc
     {
       if (NULL != read) *read = 0;
 
-      AutoRecursiveLock lock(*this);
+      // warning: called from inside the adapter while the handshake worker
+      // may not hold the object lock; never take the object lock here
+      AutoRecursiveLock adapterLock(mAdapterLock);
       if (!mAdapter) {
         if (error) *error = SSL_ERROR_ZERO_RETURN;
         return SR_ERROR;
@@ -1598,7 +1698,9 @@ namespace ortc
     {
       if (NULL != written) *written = 0;
 
-      AutoRecursiveLock lock(*this);
+      // warning: called from inside the adapter while the handshake worker
+      // may not hold the object lock; never take the object lock here
+      AutoRecursiveLock adapterLock(mAdapterLock);
       if (!mAdapter) {
         if (error) *error = SSL_ERROR_ZERO_RETURN;
         return SR_ERROR;
@@ -1622,7 +1724,11 @@ namespace ortc
                                           )
     {
       ZS_LOG_TRACE(log("adding dtls packet to send to outgoing queue") + ZS_PARAM("buffer length", bufferLengthInBytes))
-      mPendingOutgoingDTLS.push(make_shared<SecureByteBlock>(buffer, bufferLengthInBytes));
+
+      {
+        AutoLock outgoingLock(mPendingOutgoingDTLSLock);
+        mPendingOutgoingDTLS.push(make_shared<SecureByteBlock>(buffer, bufferLengthInBytes));
+      }
 
       IDTLSTransportAsyncDelegateProxy::create(mThisWeak.lock())->onAdapterSendPacket();
     }
@@ -1630,12 +1736,15 @@ namespace ortc
     //-------------------------------------------------------------------------
     size_t DTLSTransport::adapterReadPacket(BYTE *buffer, size_t bufferLengthInBytes)
     {
+      AutoLock incomingLock(mPendingIncomingDTLSLock);
+
       size_t currentSize = SafeInt<CryptoPP::lword>(mPendingIncomingDTLS.CurrentSize());
       if (currentSize < 1) return 0;
 
       auto readSize = (currentSize < bufferLengthInBytes ? currentSize : bufferLengthInBytes);
 
       mPendingIncomingDTLS.Get(buffer, readSize);
+      if (0 == mPendingIncomingDTLS.CurrentSize()) mPendingIncomingDTLSRecords = 0;
 
       return readSize;
     }
@@ -1697,16 +1806,26 @@ namespace ortc
       IHelper::debugAppend(resultEl, "local params", mLocalParams.toDebug());
       IHelper::debugAppend(resultEl, "remote params", mRemoteParams.toDebug());
 
-      IHelper::debugAppend(resultEl, "adapter", mAdapter ? mAdapter->toDebug() : ElementPtr());
+      {
+        AutoRecursiveLock adapterLock(mAdapterLock);
+        IHelper::debugAppend(resultEl, "adapter", mAdapter ? mAdapter->toDebug() : ElementPtr());
+      }
 
       IHelper::debugAppend(resultEl, "max pending dtls buffer", mMaxPendingDTLSBuffer);
       IHelper::debugAppend(resultEl, "max pending rtp packets", mMaxPendingRTPPackets);
 
       IHelper::debugAppend(resultEl, "put pending incoming RTP packets into queue", mPutIncomingRTPIntoPendingQueue);
       IHelper::debugAppend(resultEl, "pending incoming RTP packets", mPendingIncomingRTP.size());
-      IHelper::debugAppend(resultEl, "pending incoming dtls buffer size (bytes)", mPendingIncomingDTLS.CurrentSize());
+      {
+        AutoLock incomingLock(mPendingIncomingDTLSLock);
+        IHelper::debugAppend(resultEl, "pending incoming dtls buffer size (bytes)", mPendingIncomingDTLS.CurrentSize());
+        IHelper::debugAppend(resultEl, "pending incoming dtls records", mPendingIncomingDTLSRecords);
+      }
 
-      IHelper::debugAppend(resultEl, "pending outgoing dtls packets", mPendingOutgoingDTLS.size());
+      {
+        AutoLock outgoingLock(mPendingOutgoingDTLSLock);
+        IHelper::debugAppend(resultEl, "pending outgoing dtls packets", mPendingOutgoingDTLS.size());
+      }
 
       IHelper::debugAppend(resultEl, "fixed role", mFixedRole);
 
@@ -1802,6 +1921,7 @@ namespace ortc
                             puid, id, mID,
                             string, role, IDTLSTransportTypes::toString(IDTLSTransportTypes::Role_Server)
                             );
+              AutoRecursiveLock adapterLock(mAdapterLock);
               mAdapter->setServerRole();
               break;
             }
@@ -1816,7 +1936,11 @@ namespace ortc
           }
 
           mFixedRole = true;
-          mAdapter->startSSLWithPeer();
+          {
+            AutoRecursiveLock adapterLock(mAdapterLock);
+            mAdapter->startSSLWithPeer();
+          }
+          mHandshakeActive = true;
           return true;
         }
 
@@ -1849,7 +1973,12 @@ namespace ortc
       }
 
       X509 *peerCert = NULL;
-      if (!mAdapter->getPeerCertificate(&peerCert)) {
+      bool hasPeerCert {};
+      {
+        AutoRecursiveLock adapterLock(mAdapterLock);
+        hasPeerCert = mAdapter->getPeerCertificate(&peerCert);
+      }
+      if (!hasPeerCert) {
         ZS_LOG_TRACE(log("do not have a peer certificate yet"))
         return true;
       }
@@ -1870,7 +1999,11 @@ namespace ortc
                       bool, isLocal, false
                       );
 
-        auto result = mAdapter->setPeerCertificateDigest(fingerprint.mAlgorithm, fingerprint.mValue);
+        Adapter::Validation result {};
+        {
+          AutoRecursiveLock adapterLock(mAdapterLock);
+          result = mAdapter->setPeerCertificateDigest(fingerprint.mAlgorithm, fingerprint.mValue);
+        }
         switch (result) {
           case Adapter::VALIDATION_NA:      break;
           case Adapter::VALIDATION_PASSED:  passed = true; break;
@@ -1898,7 +2031,11 @@ namespace ortc
     {
       ZS_EVENTING_1(x, i, Debug, DtlsTransportStep, ol, DtlsTransport, Step, puid, id, mID);
 
-      auto state = mAdapter->getState();
+      Adapter::StreamState state {};
+      {
+        AutoRecursiveLock adapterLock(mAdapterLock);
+        state = mAdapter->getState();
+      }
       switch (state) {
         case Adapter::SS_OPENING: {
           setState(IDTLSTransportTypes::State_Connecting);
@@ -1991,7 +2128,12 @@ namespace ortc
 
       setState(IDTLSTransportTypes::State_Closed);
 
-      mAdapter->close();
+      mHandshakeActive = false;
+
+      {
+        AutoRecursiveLock adapterLock(mAdapterLock);
+        mAdapter->close();
+      }
 
       if (mICETransport) {
         mICETransport->notifyDetached(mID);
@@ -2088,9 +2230,135 @@ namespace ortc
       }
     }
 
+    //-------------------------------------------------------------------------
+    bool DTLSTransport::queueIncomingDTLS(
+                                          const BYTE *buffer,
+                                          size_t bufferLengthInBytes
+                                          )
+    {
+      // Sanity check we're not passing junk that
+      // just looks like DTLS.
+      const BYTE * tmp_data = buffer;
+      size_t tmp_size = bufferLengthInBytes;
+      size_t totalRecords = 0;
+      while (tmp_size > 0) {
+        if (tmp_size < kDtlsRecordHeaderLen) {
+          ZS_LOG_WARNING(Trace, log("too short for the DTLS header") + ZS_PARAM("buffer length", bufferLengthInBytes) + ZS_PARAM("tmp size", tmp_size))
+          return false;
+        }
+
+        size_t record_len = (tmp_data[11] << 8) | (tmp_data[12]);
+        if ((record_len + kDtlsRecordHeaderLen) > tmp_size) {
+          ZS_LOG_WARNING(Trace, log("DTLS body is too short") + ZS_PARAM("buffer length", bufferLengthInBytes) + ZS_PARAM("record len", record_len) + ZS_PARAM("tmp size", tmp_size))
+          return false;
+        }
+
+        tmp_data += record_len + kDtlsRecordHeaderLen;
+        tmp_size -= record_len + kDtlsRecordHeaderLen;
+        ++totalRecords;
+      }
+
+      AutoLock incomingLock(mPendingIncomingDTLSLock);
+
+      if (mPendingIncomingDTLS.CurrentSize() < mMaxPendingDTLSBuffer) {
+        mPendingIncomingDTLS.Put(buffer, bufferLengthInBytes);
+        mPendingIncomingDTLSRecords += totalRecords;
+      } else {
+        ZS_LOG_WARNING(Debug, log("too many pending dtls packets (thus ignoring incoming dtls packet)"))
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void DTLSTransport::scheduleHandshake()
+    {
+      if (mHandshakeProcessingScheduled.exchange(true)) return;
+
+      ZS_LOG_TRACE(log("scheduling handshake processing"))
+
+      IDTLSTransportAsyncDelegateProxy::create(mHandshakeQueue, mThisWeak.lock())->onProcessPendingHandshake();
+    }
+
+    //-------------------------------------------------------------------------
+    void DTLSTransport::readPendingIncomingDTLS(
+                                                PacketQueue &outDecryptedPackets,
+                                                StreamResult &outStreamResult,
+                                                int &outStreamError
+                                                )
+    {
+      BYTE extractedBuffer[kMaxDtlsPacketLen] {};
+
+      while (true) {
+        size_t read = 0;
+        outStreamResult = mAdapter->read(extractedBuffer, sizeof(extractedBuffer), &read, &outStreamError);
+
+        switch (outStreamResult) {
+          case SR_SUCCESS: {
+            outDecryptedPackets.push(make_shared<SecureByteBlock>(extractedBuffer, read));
+            break;
+          }
+          case SR_BLOCK:
+          case SR_EOS:
+          case SR_ERROR:  return;
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    bool DTLSTransport::handleDecryptedPackets(
+                                               IICETypes::Components viaTransport,
+                                               PacketQueue &decryptedPackets,
+                                               StreamResult streamResult,
+                                               int streamError
+                                               )
+    {
+      wakeUpIfNeeded();
+
+      bool returnResult {true};
+
+      while (decryptedPackets.size() > 0) {
+        SecureByteBlockPtr decryptedPacket = decryptedPackets.front();
+        decryptedPackets.pop();
+
+        ZS_EVENTING_5(
+                      x, i, Trace, DtlsTransportForwardingPacketToDataTransport, ol, DtlsTransport, Deliver,
+                      puid, id, mID,
+                      puid, dataTransportId, mDataTransport->getID(),
+                      enum, viaTransport, zsLib::to_underlying(viaTransport),
+                      buffer, packet, decryptedPacket->BytePtr(),
+                      size, size, decryptedPacket->SizeInBytes()
+                      );
+
+        auto result = mDataTransport->handleDataPacket(decryptedPacket->BytePtr(), decryptedPacket->SizeInBytes());
+        if (!result) returnResult = false;
+      }
+
+      switch (streamResult) {
+        case SR_SUCCESS:  break;
+        case SR_BLOCK: {
+          ZS_LOG_TRACE(log("dtls packet consumed"));
+          break;
+        }
+        case SR_EOS: {
+          ZS_LOG_DEBUG(log("end of stream reached (thus shutting down)"));
+          cancel();
+          break;
+        }
+        case SR_ERROR: {
+          ZS_LOG_ERROR(Debug, log("read error found (thus shutting down)") + ZS_PARAM("error code", streamError));
+          cancel();
+          break;
+        }
+      }
+
+      return returnResult;
+    }
+
     //-------------------------------------------------------------------------
     void DTLSTransport::wakeUpIfNeeded()
     {
+      AutoRecursiveLock adapterLock(mAdapterLock);
+
       switch ((States)mCurrentState) {
         case IDTLSTransportTypes::State_New:        {
           if (!mFixedRole) return;
@@ -2124,6 +2392,8 @@ namespace ortc
 
       if (mSRTPTransport) return; // already setup
 
+      AutoRecursiveLock adapterLock(mAdapterLock);
+
       SecureByteBlock dtlsBuffer(SRTP_MASTER_KEY_KEY_LEN * 2 +
                                  SRTP_MASTER_KEY_SALT_LEN * 2);
 
@@ -0,0 +1,713 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+
+#include <ortc/internal/ortc_EventTrace.h>
+#include <ortc/internal/platform.h>
+
+#include <ortc/IHelper.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/Numeric.h>
+#include <zsLib/Singleton.h>
+#include <zsLib/Stringize.h>
+#include <zsLib/XML.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib) }
+
+namespace ortc
+{
+  ZS_DECLARE_USING_PTR(zsLib, ISettings);
+
+  using zsLib::Numeric;
+
+  namespace internal
+  {
+    ZS_DECLARE_CLASS_PTR(EventTraceSettingsDefaults);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark EventTraceSettingsDefaults
+    #pragma mark
+
+    class EventTraceSettingsDefaults : public ISettingsApplyDefaultsDelegate
+    {
+    public:
+      //-----------------------------------------------------------------------
+      ~EventTraceSettingsDefaults()
+      {
+        ISettings::removeDefaults(*this);
+      }
+
+      //-----------------------------------------------------------------------
+      static EventTraceSettingsDefaultsPtr singleton()
+      {
+        static SingletonLazySharedPtr<EventTraceSettingsDefaults> singleton(create());
+        return singleton.singleton();
+      }
+
+      //-----------------------------------------------------------------------
+      static EventTraceSettingsDefaultsPtr create()
+      {
+        auto pThis(make_shared<EventTraceSettingsDefaults>());
+        ISettings::installDefaults(pThis);
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      virtual void notifySettingsApplyDefaults() override
+      {
+        ISettings::setBool(ORTC_SETTING_EVENT_TRACE_AUTO_START, false);
+        ISettings::setUInt(ORTC_SETTING_EVENT_TRACE_RING_SIZE_IN_BYTES, 1024*1024);
+        ISettings::setUInt(ORTC_SETTING_EVENT_TRACE_CAPTURE_PAYLOAD_BYTES, 64);
+        ISettings::setString(ORTC_SETTING_EVENT_TRACE_TRIGGER_SEVERITY, "");
+        ISettings::setString(ORTC_SETTING_EVENT_TRACE_TRIGGER_EVENT_IDS, "");
+        ISettings::setUInt(ORTC_SETTING_EVENT_TRACE_TRIGGER_DELAY_IN_MILLISECONDS, 500);
+        ISettings::setString(ORTC_SETTING_EVENT_TRACE_TRIGGER_FILE, "ortc-event-trace.pcapng");
+      }
+      
+    };
+
+    //-------------------------------------------------------------------------
+    void installEventTraceSettingsDefaults()
+    {
+      EventTraceSettingsDefaults::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (helpers)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    static ULONGLONG steadyNowInNanoseconds()
+    {
+      return static_cast<ULONGLONG>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    //-------------------------------------------------------------------------
+    static ULONGLONG systemNowInNanoseconds()
+    {
+      return static_cast<ULONGLONG>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    //-------------------------------------------------------------------------
+    static size_t alignTo(size_t value, size_t alignment)
+    {
+      return ((value + (alignment - 1)) / alignment) * alignment;
+    }
+
+    //-------------------------------------------------------------------------
+    static bool isStringParameter(Log::EventParameterTypes type)
+    {
+      switch (type) {
+        case Log::EventParameterType_String:
+        case Log::EventParameterType_AString:
+        case Log::EventParameterType_WString:   return true;
+        default:                                break;
+      }
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark PcapNGWriter
+    #pragma mark
+
+    // Minimal pcapng (https://github.com/pcapng/pcapng) writer: one section,
+    // one interface per traced thread, enhanced packet blocks with
+    // nanosecond timestamps. Written in host byte order (the section's
+    // byte-order magic tells readers which that is).
+    class PcapNGWriter
+    {
+    public:
+      //-----------------------------------------------------------------------
+      PcapNGWriter(const char *fileName) :
+        mFile(fileName, std::ios::out | std::ios::binary | std::ios::trunc)
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      bool isOpen() const {return mFile.is_open();}
+      bool isGood() const {return mFile.good();}
+
+      //-----------------------------------------------------------------------
+      void writeSectionHeader()
+      {
+        std::vector<BYTE> body;
+        append32(body, 0x1A2B3C4D);
+        append16(body, 1);
+        append16(body, 0);
+        append32(body, 0xFFFFFFFF);   // section length unspecified
+        append32(body, 0xFFFFFFFF);
+        writeBlock(0x0A0D0D0A, body);
+      }
+
+      //-----------------------------------------------------------------------
+      void writeInterface(const String &name)
+      {
+        std::vector<BYTE> body;
+        append16(body, 147);          // LINKTYPE_USER0
+        append16(body, 0);
+        append32(body, 0);            // no snap length limit
+        appendOption(body, 2, reinterpret_cast<const BYTE *>(name.c_str()), name.length());   // if_name
+        BYTE resolution = 9;          // nanoseconds
+        appendOption(body, 9, &resolution, sizeof(resolution));                               // if_tsresol
+        appendOption(body, 0, NULL, 0);
+        writeBlock(0x00000001, body);
+      }
+
+      //-----------------------------------------------------------------------
+      void writePacket(
+                       DWORD interfaceID,
+                       ULONGLONG timestamp,
+                       const BYTE *data,
+                       size_t capturedSize,
+                       size_t originalSize,
+                       const String &comment
+                       )
+      {
+        std::vector<BYTE> body;
+        append32(body, interfaceID);
+        append32(body, static_cast<DWORD>(timestamp >> 32));
+        append32(body, static_cast<DWORD>(timestamp));
+        append32(body, static_cast<DWORD>(capturedSize));
+        append32(body, static_cast<DWORD>(originalSize));
+        appendPadded(body, data, capturedSize);
+        appendOption(body, 1, reinterpret_cast<const BYTE *>(comment.c_str()), comment.length());  // opt_comment
+        appendOption(body, 0, NULL, 0);
+        writeBlock(0x00000006, body);
+      }
+
+    protected:
+      //-----------------------------------------------------------------------
+      static void append16(std::vector<BYTE> &buffer, WORD value)
+      {
+        const BYTE *ptr = reinterpret_cast<const BYTE *>(&value);
+        buffer.insert(buffer.end(), ptr, ptr + sizeof(value));
+      }
+
+      //-----------------------------------------------------------------------
+      static void append32(std::vector<BYTE> &buffer, DWORD value)
+      {
+        const BYTE *ptr = reinterpret_cast<const BYTE *>(&value);
+        buffer.insert(buffer.end(), ptr, ptr + sizeof(value));
+      }
+
+      //-----------------------------------------------------------------------
+      static void appendPadded(std::vector<BYTE> &buffer, const BYTE *data, size_t size)
+      {
+        if (size > 0) buffer.insert(buffer.end(), data, data + size);
+        buffer.resize(buffer.size() + (alignTo(size, 4) - size), 0);
+      }
+
+      //-----------------------------------------------------------------------
+      static void appendOption(std::vector<BYTE> &buffer, WORD code, const BYTE *data, size_t size)
+      {
+        append16(buffer, code);
+        append16(buffer, static_cast<WORD>(size));
+        appendPadded(buffer, data, size);
+      }
+
+      //-----------------------------------------------------------------------
+      void writeBlock(DWORD type, const std::vector<BYTE> &body)
+      {
+        DWORD totalLength = static_cast<DWORD>(body.size() + 12);
+        mFile.write(reinterpret_cast<const char *>(&type), sizeof(type));
+        mFile.write(reinterpret_cast<const char *>(&totalLength), sizeof(totalLength));
+        if (body.size() > 0) mFile.write(reinterpret_cast<const char *>(&(body[0])), body.size());
+        mFile.write(reinterpret_cast<const char *>(&totalLength), sizeof(totalLength));
+      }
+
+    protected:
+      std::ofstream mFile;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IEventTraceForORTC
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void IEventTraceForORTC::start()
+    {
+      auto singleton = EventTrace::singleton();
+      if (!singleton) return;
+      singleton->start();
+    }
+
+    //-------------------------------------------------------------------------
+    void IEventTraceForORTC::stop()
+    {
+      auto singleton = EventTrace::singleton();
+      if (!singleton) return;
+      singleton->stop();
+    }
+
+    //-------------------------------------------------------------------------
+    bool IEventTraceForORTC::isTracing()
+    {
+      auto singleton = EventTrace::singleton();
+      if (!singleton) return false;
+      return singleton->isTracing();
+    }
+
+    //-------------------------------------------------------------------------
+    bool IEventTraceForORTC::save(const char *fileName)
+    {
+      auto singleton = EventTrace::singleton();
+      if (!singleton) return false;
+      return singleton->save(fileName);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark EventTrace::Ring
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    EventTrace::Ring::Ring(
+                           size_t slotSize,
+                           size_t totalSlots,
+                           size_t threadIndex
+                           ) :
+      mBuffer(slotSize * totalSlots),
+      mSlotSize(slotSize),
+      mTotalSlots(totalSlots),
+      mThreadIndex(threadIndex)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark EventTrace
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    EventTrace::EventTrace(const make_private &)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    void EventTrace::init()
+    {
+      mEventingAtomIndex = Log::registerEventingAtom("org.ortc.eventTrace");
+    }
+
+    //-------------------------------------------------------------------------
+    EventTrace::~EventTrace()
+    {
+      mThisWeak.reset();
+      stop();
+    }
+
+    //-------------------------------------------------------------------------
+    EventTracePtr EventTrace::singleton()
+    {
+      static SingletonLazySharedPtr<EventTrace> singleton([]() -> EventTracePtr {
+        auto pThis(make_shared<EventTrace>(make_private{}));
+        pThis->mThisWeak = pThis;
+        pThis->init();
+        return pThis;
+      }());
+      return singleton.singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark EventTrace => IEventTraceForORTC
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void EventTrace::start()
+    {
+      {
+        AutoLock lock(mLock);
+
+        if (mTracing) return;
+
+        mCapturePayloadBytes = std::min<size_t>(ISettings::getUInt(ORTC_SETTING_EVENT_TRACE_CAPTURE_PAYLOAD_BYTES), ORTC_EVENT_TRACE_MAX_CAPTURE_PAYLOAD_BYTES);
+        mSlotSize = alignTo(sizeof(Record) + mCapturePayloadBytes, alignof(Record));
+        mRingSizeInBytes = std::max<size_t>(ISettings::getUInt(ORTC_SETTING_EVENT_TRACE_RING_SIZE_IN_BYTES), mSlotSize * 16);
+
+        String severityStr = ISettings::getString(ORTC_SETTING_EVENT_TRACE_TRIGGER_SEVERITY);
+        mTriggerOnSeverity = severityStr.hasData();
+        if (mTriggerOnSeverity) {
+          if (0 == severityStr.compareNoCase("warning")) mTriggerSeverity = Log::Warning;
+          else if (0 == severityStr.compareNoCase("fatal")) mTriggerSeverity = Log::Fatal;
+          else mTriggerSeverity = Log::Error;
+        }
+
+        mTotalTriggerEventIDs = 0;
+        {
+          IHelper::SplitMap splits;
+          IHelper::split(ISettings::getString(ORTC_SETTING_EVENT_TRACE_TRIGGER_EVENT_IDS), splits, ',');
+          for (auto iter = splits.begin(); iter != splits.end(); ++iter) {
+            if (mTotalTriggerEventIDs >= ORTC_EVENT_TRACE_MAX_TRIGGER_EVENT_IDS) break;
+            try {
+              mTriggerEventIDs[mTotalTriggerEventIDs] = Numeric<WORD>((*iter).second);
+              ++mTotalTriggerEventIDs;
+            } catch (const Numeric<WORD>::ValueOutOfRange &) {
+              ZS_LOG_WARNING(Detail, slog("trigger event id is not valid") + ZS_PARAM("value", (*iter).second))
+            }
+          }
+        }
+
+        mTriggerDelay = Milliseconds(ISettings::getUInt(ORTC_SETTING_EVENT_TRACE_TRIGGER_DELAY_IN_MILLISECONDS));
+        mTriggerFile = ISettings::getString(ORTC_SETTING_EVENT_TRACE_TRIGGER_FILE);
+
+        mRings.clear();
+        mNextThreadIndex = 0;
+
+        // threads holding a ring from a previous session pick up a new one
+        ++mGeneration;
+
+        mTracing = true;
+
+        ZS_LOG_BASIC(slog("event tracing started") + ZS_PARAM("ring size", mRingSizeInBytes) + ZS_PARAM("slot size", mSlotSize) + ZS_PARAM("capture payload", mCapturePayloadBytes))
+      }
+
+      auto pThis = mThisWeak.lock();
+      if (pThis) Log::addEventingListener(pThis);
+    }
+
+    //-------------------------------------------------------------------------
+    void EventTrace::stop()
+    {
+      {
+        AutoLock lock(mLock);
+        if (!mTracing) return;
+        mTracing = false;
+      }
+
+      auto pThis = mThisWeak.lock();
+      if (pThis) Log::removeEventingListener(pThis);
+
+      ZS_LOG_BASIC(slog("event tracing stopped") + ZS_PARAM("triggers", mTotalTriggers.load()))
+    }
+
+    //-------------------------------------------------------------------------
+    bool EventTrace::save(const char *fileName)
+    {
+      typedef std::pair<Ring *, std::vector<BYTE> > SlotCopy;
+      typedef std::vector<SlotCopy> SlotCopyList;
+
+      RingList rings;
+
+      {
+        AutoLock lock(mLock);
+        rings = mRings;
+      }
+
+      SlotCopyList slots;
+
+      for (auto iter = rings.begin(); iter != rings.end(); ++iter) {
+        Ring *ring = (*iter).get();
+
+        ULONGLONG head = ring->mHead.load(std::memory_order_acquire);
+        ULONGLONG first = (head > ring->mTotalSlots ? head - ring->mTotalSlots : 0);
+
+        std::vector<std::vector<BYTE> > copies;
+        copies.reserve(static_cast<size_t>(head - first));
+        for (ULONGLONG index = first; index < head; ++index) {
+          BYTE *slot = ring->slot(index);
+          copies.push_back(std::vector<BYTE>(slot, slot + ring->mSlotSize));
+        }
+
+        // drop anything the writer lapped while it was being copied (the
+        // slot the writer is currently filling is one past the new head)
+        ULONGLONG afterHead = ring->mHead.load(std::memory_order_acquire);
+        ULONGLONG firstValid = ((afterHead + 1) > ring->mTotalSlots ? (afterHead + 1) - ring->mTotalSlots : 0);
+
+        for (ULONGLONG index = first; index < head; ++index) {
+          if (index < firstValid) continue;
+          slots.push_back(SlotCopy(ring, std::move(copies[static_cast<size_t>(index - first)])));
+        }
+      }
+
+      std::stable_sort(slots.begin(), slots.end(), [](const SlotCopy &op1, const SlotCopy &op2) -> bool {
+        return reinterpret_cast<const Record *>(&(op1.second[0]))->mTimestamp < reinterpret_cast<const Record *>(&(op2.second[0]))->mTimestamp;
+      });
+
+      PcapNGWriter writer(fileName);
+      if (!writer.isOpen()) {
+        ZS_LOG_WARNING(Detail, slog("unable to open event trace file") + ZS_PARAM("file", fileName))
+        return false;
+      }
+
+      writer.writeSectionHeader();
+
+      std::map<size_t, DWORD> interfaceIDs;
+      for (auto iter = rings.begin(); iter != rings.end(); ++iter) {
+        DWORD interfaceID = static_cast<DWORD>(interfaceIDs.size());
+        interfaceIDs[(*iter)->mThreadIndex] = interfaceID;
+        writer.writeInterface(String("ortc-thread-") + string((*iter)->mThreadIndex));
+      }
+
+      // records are stamped with the steady clock; map onto wall time
+      ULONGLONG steadyToSystemOffset = systemNowInNanoseconds() - steadyNowInNanoseconds();
+
+      for (auto iter = slots.begin(); iter != slots.end(); ++iter) {
+        const Record *record = reinterpret_cast<const Record *>(&((*iter).second[0]));
+        const BYTE *payload = &((*iter).second[sizeof(Record)]);
+
+        String comment = String("provider=") + string(record->mProvider) +
+                         " event=" + string(record->mEventID) +
+                         " severity=" + string(static_cast<ULONG>(record->mSeverity)) +
+                         " level=" + string(static_cast<ULONG>(record->mLevel)) +
+                         " values=";
+        for (BYTE index = 0; index < record->mTotalValues; ++index) {
+          if (0 != index) comment += ",";
+          comment += string(record->mValues[index]);
+        }
+
+        writer.writePacket(
+                           interfaceIDs[(*iter).first->mThreadIndex],
+                           record->mTimestamp + steadyToSystemOffset,
+                           payload,
+                           std::min<size_t>(record->mCapturedPayloadSize, mCapturePayloadBytes),
+                           record->mOriginalPayloadSize,
+                           comment
+                           );
+      }
+
+      bool result = writer.isGood();
+
+      ZS_LOG_BASIC(slog("event trace saved") + ZS_PARAM("file", fileName) + ZS_PARAM("threads", rings.size()) + ZS_PARAM("events", slots.size()) + ZS_PARAM("result", result))
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark EventTrace => ILogEventingDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void EventTrace::notifyEventingProviderRegistered(
+                                                      ProviderHandle handle,
+                                                      EventingAtomDataArray eventingAtomDataArray
+                                                      )
+    {
+      // events are only written once some listener has enabled the
+      // provider's keywords
+      Log::setEventingLogging(handle, mEventingAtomIndex, true);
+    }
+
+    //-------------------------------------------------------------------------
+    void EventTrace::notifyWriteEvent(
+                                      ProviderHandle handle,
+                                      EventingAtomDataArray eventingAtomDataArray,
+                                      Log::Severity severity,
+                                      Log::Level level,
+                                      Log::EVENT_DESCRIPTOR_HANDLE descriptor,
+                                      Log::EVENT_PARAMETER_DESCRIPTOR_HANDLE paramDescriptor,
+                                      Log::EVENT_DATA_DESCRIPTOR_HANDLE dataDescriptor,
+                                      size_t dataDescriptorCount
+                                      )
+    {
+      if (!mTracing) return;
+      if (!descriptor) return;
+
+      Ring *ring = getThreadRing();
+      if (!ring) return;
+
+      ULONGLONG head = ring->mHead.load(std::memory_order_relaxed);
+      BYTE *slot = ring->slot(head);
+      Record *record = reinterpret_cast<Record *>(slot);
+      BYTE *payload = slot + sizeof(Record);
+
+      record->mTimestamp = steadyNowInNanoseconds();
+      record->mProvider = static_cast<PTRNUMBER>(handle);
+      record->mEventID = static_cast<WORD>(descriptor->Id);
+      record->mSeverity = static_cast<BYTE>(severity);
+      record->mLevel = static_cast<BYTE>(level);
+      record->mOriginalPayloadSize = 0;
+      record->mCapturedPayloadSize = 0;
+      record->mTotalValues = 0;
+
+      bool capturedPayload = false;
+
+      for (size_t index = 0; index < dataDescriptorCount; ++index) {
+        const BYTE *ptr = reinterpret_cast<const BYTE *>(static_cast<PTRNUMBER>(dataDescriptor[index].Ptr));
+        size_t size = static_cast<size_t>(dataDescriptor[index].Size);
+
+        auto type = (paramDescriptor ? paramDescriptor[index].Type : Log::EventParameterType_Unknown);
+
+        if (Log::EventParameterType_Binary == type) {
+          if (capturedPayload) continue;
+          capturedPayload = true;
+
+          size_t captured = std::min(size, mCapturePayloadBytes);
+          record->mOriginalPayloadSize = static_cast<DWORD>(size);
+          record->mCapturedPayloadSize = static_cast<WORD>(captured);
+          if ((captured > 0) && (ptr)) memcpy(payload, ptr, captured);
+          continue;
+        }
+
+        // strings stay on the ZS_LOG_* path; this backend keeps scalars only
+        if (isStringParameter(type)) continue;
+        if (record->mTotalValues >= ORTC_EVENT_TRACE_MAX_VALUES) continue;
+
+        ULONGLONG value = 0;
+        if (ptr) memcpy(&value, ptr, std::min(size, sizeof(value)));
+        record->mValues[record->mTotalValues] = value;
+        ++(record->mTotalValues);
+      }
+
+      ring->mHead.store(head + 1, std::memory_order_release);
+
+      if (isTrigger(severity, record->mEventID)) trigger();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark EventTrace => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    Log::Params EventTrace::slog(const char *message)
+    {
+      return Log::Params(message, "ortc::EventTrace");
+    }
+
+    //-------------------------------------------------------------------------
+    EventTrace::Ring *EventTrace::getThreadRing()
+    {
+      struct ThreadRing
+      {
+        RingPtr mRing;
+        ULONG mGeneration {};
+      };
+
+      static thread_local ThreadRing threadRing;
+
+      ULONG generation = mGeneration.load(std::memory_order_acquire);
+      if ((threadRing.mRing) &&
+          (threadRing.mGeneration == generation)) return threadRing.mRing.get();
+
+      // first event on this thread (or first since a restart); the only
+      // locked step on the write path
+      AutoLock lock(mLock);
+      if (!mTracing) return NULL;
+
+      threadRing.mRing = make_shared<Ring>(mSlotSize, std::max<size_t>(mRingSizeInBytes / mSlotSize, 1), mNextThreadIndex);
+      threadRing.mGeneration = mGeneration;
+      ++mNextThreadIndex;
+
+      mRings.push_back(threadRing.mRing);
+
+      return threadRing.mRing.get();
+    }
+
+    //-------------------------------------------------------------------------
+    bool EventTrace::isTrigger(
+                               Log::Severity severity,
+                               WORD eventID
+                               ) const
+    {
+      if ((mTriggerOnSeverity) && (severity >= mTriggerSeverity)) return true;
+      for (size_t index = 0; index < mTotalTriggerEventIDs; ++index) {
+        if (eventID == mTriggerEventIDs[index]) return true;
+      }
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    void EventTrace::trigger()
+    {
+      if (mTriggerPending.exchange(true)) return;
+      if (mTriggerFile.isEmpty()) {
+        mTriggerPending = false;
+        return;
+      }
+
+      ++mTotalTriggers;
+
+      // dump from a separate thread after a short delay so the events that
+      // follow the trigger are captured too and the hot path never blocks
+      // on file I/O
+      auto pThis = mThisWeak.lock();
+      Milliseconds delay = mTriggerDelay;
+      String fileName = mTriggerFile;
+
+      std::thread([pThis, delay, fileName]() {
+        std::this_thread::sleep_for(delay);
+        if (!pThis) return;
+        pThis->save(fileName.c_str());
+        pThis->mTriggerPending = false;
+      }).detach();
+    }
+
+  }
+}
@@ -33,6 +33,7 @@
 #include <ortc/internal/ortc_ICETransport.h>
 #include <ortc/internal/ortc_Helper.h>
 #include <ortc/internal/ortc_ORTC.h>
+#include <ortc/internal/ortc_ReceiveLatency.h>
 #include <ortc/internal/ortc.events.h>
 #include <ortc/internal/platform.h>
 
@@ -657,6 +658,17 @@ namespace ortc
         ZS_LOG_DETAIL(log("setting up timer to clean unsed routes") + ZS_PARAM("clean duration (s)", mCleanUnusedRoutesDuration) + ZS_PARAM("timer", mCleanUnusedRoutesTimer->getID()))
       }
 
+      mUDPMux = UseUDPMux::singleton();
+      if (mUDPMux) {
+        // the RTCP gatherer shares the RTP username frag thus incoming
+        // requests can only be demultiplexed to the RTP gatherer; the RTCP
+        // gatherer relies on remotes learned from its outgoing packets
+        if (Component_RTP == mComponent) {
+          mUDPMux->registerGatherer(mThisWeak.lock(), mUsernameFrag);
+        }
+        ZS_LOG_DETAIL(log("using shared udp port") + UseUDPMux::toDebug(mUDPMux))
+      }
+
       // kick start the process
       IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
     }
@@ -809,10 +821,13 @@ namespace ortc
     //-------------------------------------------------------------------------
     IICEGatherer::ParametersPtr ICEGatherer::getLocalParameters() const
     {
+      AutoRecursiveLock lock(*this);
+
       ParametersPtr result(make_shared<Parameters>());
       result->mUseUnfreezePriority = true;
       result->mUsernameFragment = mUsernameFrag;
       result->mPassword = mPassword;
+      result->mICELite = mOptions.mICELite;
       return result;
     }
 
@@ -1110,6 +1125,13 @@ namespace ortc
       return mOptions.mContinuousGathering;
     }
 
+    //-------------------------------------------------------------------------
+    bool ICEGatherer::isICELite() const
+    {
+      AutoRecursiveLock lock(*this);
+      return mOptions.mICELite;
+    }
+
     //-------------------------------------------------------------------------
     ICEGathererRouterPtr ICEGatherer::getGathererRouter() const
     {
@@ -1238,7 +1260,14 @@ namespace ortc
                         buffer, packet, buffer,
                         size, size, bufferSizeInBytes
                         );
-          return sendUDPPacket(route->mHostPort->mBoundUDPSocket, route->mHostPort->mBoundUDPIP, route->mRouterRoute->mRemoteIP, buffer, bufferSizeInBytes);
+          if ((mUDPMux) &&
+              (!route->mNotifiedUDPMux)) {
+            mUDPMux->notifyRemote(mID, route->mHostPort->mBoundUDPIP, route->mRouterRoute->mRemoteIP);
+            route->mNotifiedUDPMux = true;
+          }
+          bool sent = sendUDPPacket(route->mHostPort->mBoundUDPSocket, route->mHostPort->mBoundUDPIP, route->mRouterRoute->mRemoteIP, buffer, bufferSizeInBytes);
+          if (sent) routerRoute->notifySent(bufferSizeInBytes);
+          return sent;
         }
         if (route->mRelayPort) {
           if (!route->mRelayPort->mTURNSocket) {
@@ -1255,37 +1284,7 @@ namespace ortc
             goto send_failed;
           }
 
-          auto currentSize = route->mTCPPort->mOutgoingBuffer.CurrentSize();
-          auto maxSize = (route->mTCPPort->mConnected ? mMaxTCPBufferingSizeConnected : mMaxTCPBufferingSizePendingConnection);
-
-          ZS_LOG_INSANE(log("putting packet into TCP buffer for sending") + route->toDebug() + route->mTCPPort->toDebug() + ZS_PARAM("buffer size", bufferSizeInBytes) + ZS_PARAM("current buffer size", currentSize) + ZS_PARAM("max size", maxSize))
-
-          if (currentSize > maxSize) {
-            ZS_LOG_WARNING(Trace, log("cannot send packet due to TCP buffer overflow") + route->toDebug() + route->mTCPPort->toDebug() + ZS_PARAM("buffer size", bufferSizeInBytes) + ZS_PARAM("current buffer size", currentSize) + ZS_PARAM("max size", maxSize))
-            return false;
-          }
-
-          ZS_EVENTING_6(
-                        x, i, Trace, IceGathererSendIceTransportPacketViaTcp, ol, IceGatherer, Send,
-                        puid, id, mID,
-                        puid, iceTransportId, transport.getID(),
-                        puid, routerRouteId, routerRoute->mID,
-                        puid, tcpPortId, route->mTCPPort->mID,
-                        buffer, packet, buffer,
-                        size, size, bufferSizeInBytes
-                        );
-
-          CryptoPP::word16 packeSize {static_cast<CryptoPP::word16>(htons(static_cast<unsigned short>(bufferSizeInBytes)))};
-
-          route->mTCPPort->mOutgoingBuffer.Put((const BYTE *)(&packeSize), sizeof(packeSize));
-          route->mTCPPort->mOutgoingBuffer.Put(buffer, bufferSizeInBytes);
-          if ((route->mTCPPort->mConnected) &&
-              (0 == currentSize) &&
-              (route->mTCPPort->mWriteReady)) {
-            ZS_LOG_INSANE(log("simulate write ready for TCP socket (to ensure packet is sent out straight away)"))
-            ISocketDelegateProxy::create(mThisWeak.lock())->onWriteReady(route->mTCPPort->mSocket);
-          }
-          return true;
+          return sendTCPPacket(transport, routerRoute, route, buffer, bufferSizeInBytes);
         }
 
         ZS_LOG_WARNING(Debug, log("route does not have any source / destination ports") + route->toDebug())
@@ -1312,6 +1311,7 @@ namespace ortc
         goto send_failed;
       }
 
+      routerRoute->notifySent(bufferSizeInBytes);
       return true;
 
     send_failed: {}
@@ -1326,6 +1326,158 @@ namespace ortc
       return false;
     }
 
+    //-------------------------------------------------------------------------
+    bool ICEGatherer::sendPackets(
+                                  UseICETransport &transport,
+                                  RouterRoutePtr routerRoute,
+                                  const PacketBufferRefList &packets
+                                  )
+    {
+      if (packets.size() < 1) return true;
+
+      for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+        auto &packet = (*iter);
+        ZS_EVENTING_5(
+                      x, i, Trace, IceGathererSendIceTransportPacket, ol, IceGatherer, Send,
+                      puid, id, mID,
+                      puid, iceTransportId, transport.getID(),
+                      puid, routerRouteId, routerRoute->mID,
+                      buffer, packet, packet.mBuffer,
+                      size, size, packet.mSize
+                      );
+      }
+
+      ITURNSocketPtr turn;
+      RoutePtr route;
+
+      bool result = true;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        {
+          auto found = mRoutes.find(routerRoute->mID);
+          if (found == mRoutes.end()) {
+            ZS_LOG_DEBUG(log("no route found at this time (attempt to install a route)") + routerRoute->toDebug() + ZS_PARAM("packets", packets.size()))
+
+            route = installRoute(routerRoute, transport.getForGatherer());
+          } else {
+            route = (*found).second;
+          }
+        }
+
+        if (!route) {
+          ZS_LOG_WARNING(Debug, log("no route found at this time") + routerRoute->toDebug() + ZS_PARAM("packets", packets.size()))
+          goto send_failed;
+        }
+
+        route->mLastUsed = zsLib::now();
+
+        if (route->mHostPort) {
+          if (!route->mHostPort->mBoundUDPSocket) {
+            ZS_LOG_WARNING(Debug, log("no UDP socket found at this time") + route->toDebug() + ZS_PARAM("packets", packets.size()))
+            goto send_failed;
+          }
+          if ((mUDPMux) &&
+              (!route->mNotifiedUDPMux)) {
+            mUDPMux->notifyRemote(mID, route->mHostPort->mBoundUDPIP, route->mRouterRoute->mRemoteIP);
+            route->mNotifiedUDPMux = true;
+          }
+
+          for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+            auto &packet = (*iter);
+            ZS_EVENTING_7(
+                          x, i, Trace, IceGathererSendIceTransportPacketViaUdp, ol, IceGatherer, Send,
+                          puid, id, mID,
+                          puid, iceTransportId, transport.getID(),
+                          puid, routerRouteId, routerRoute->mID,
+                          puid, hostPortId, route->mHostPort->mID,
+                          string, remoteIp, route->mRouterRoute->mRemoteIP.string(),
+                          buffer, packet, packet.mBuffer,
+                          size, size, packet.mSize
+                          );
+            if (!sendUDPPacket(route->mHostPort->mBoundUDPSocket, route->mHostPort->mBoundUDPIP, route->mRouterRoute->mRemoteIP, packet.mBuffer, packet.mSize)) {
+              result = false;
+              continue;
+            }
+            routerRoute->notifySent(packet.mSize);
+          }
+          return result;
+        }
+        if (route->mRelayPort) {
+          if (!route->mRelayPort->mTURNSocket) {
+            ZS_LOG_WARNING(Debug, log("no turn socket available at this time") + route->toDebug() + ZS_PARAM("packets", packets.size()))
+            goto send_failed;
+          }
+          route->mRelayPort->mLastActivity = route->mLastUsed;
+          turn = route->mRelayPort->mTURNSocket;
+          goto send_via_turn;
+        }
+        if (route->mTCPPort) {
+          if (!route->mTCPPort->mSocket) {
+            ZS_LOG_WARNING(Debug, log("no TCP socket found at this time") + route->toDebug() + ZS_PARAM("packets", packets.size()))
+            goto send_failed;
+          }
+
+          // TCP routes enforce their outgoing buffer limits per packet
+          for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+            if (!sendTCPPacket(transport, routerRoute, route, (*iter).mBuffer, (*iter).mSize)) result = false;
+          }
+          return result;
+        }
+
+        ZS_LOG_WARNING(Debug, log("route does not have any source / destination ports") + route->toDebug())
+      }
+      goto send_failed;
+
+    send_via_turn:
+
+      ZS_LOG_INSANE(log("sending packets over TURN") + ZS_PARAM("packets", packets.size()));
+
+      for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+        auto &packet = (*iter);
+        ZS_EVENTING_6(
+                      x, i, Trace, IceGathererSendIceTransportPacketViaTurn, ol, IceGatherer, Send,
+                      puid, id, mID,
+                      puid, iceTransportId, transport.getID(),
+                      puid, routerRouteId, routerRoute->mID,
+                      puid, turnSocketId, turn->getID(),
+                      buffer, packet, packet.mBuffer,
+                      size, size, packet.mSize
+                      );
+
+        if (!turn->sendPacket(route->mRouterRoute->mRemoteIP, packet.mBuffer, packet.mSize)) {
+          ZS_LOG_WARNING(Debug, log("turn socket not able to send packet at this time") + ZS_PARAM("turn socket id", turn->getID()) + ZS_PARAM("buffer size", packet.mSize));
+          ZS_EVENTING_5(
+                        x, w, Trace, IceGathererSendIceTransportPacketFailed, ol, IceGatherer, Send,
+                        puid, id, mID,
+                        puid, iceTransportId, transport.getID(),
+                        puid, routerRouteId, routerRoute->mID,
+                        buffer, packet, packet.mBuffer,
+                        size, size, packet.mSize
+                        );
+          result = false;
+          continue;
+        }
+        routerRoute->notifySent(packet.mSize);
+      }
+      return result;
+
+    send_failed: {}
+      for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+        auto &packet = (*iter);
+        ZS_EVENTING_5(
+                      x, w, Trace, IceGathererSendIceTransportPacketFailed, ol, IceGatherer, Send,
+                      puid, id, mID,
+                      puid, iceTransportId, transport.getID(),
+                      puid, routerRouteId, routerRoute->mID,
+                      buffer, packet, packet.mBuffer,
+                      size, size, packet.mSize
+                      );
+      }
+      return false;
+    }
+
     //-------------------------------------------------------------------------
     void ICEGatherer::notifyLikelyReflexiveActivity(RouterRoutePtr routerRoute)
     {
@@ -1375,6 +1527,39 @@ namespace ortc
       }
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGatherer => IICEGathererForICEGathererUDPMux
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void ICEGatherer::notifyUDPMuxPacket(
+                                         SocketPtr socket,
+                                         const IPAddress &fromIP,
+                                         const BYTE *buffer,
+                                         size_t bufferSizeInBytes
+                                         )
+    {
+      HostPortPtr hostPort;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        auto found = mHostPortSockets.find(socket);
+        if (found == mHostPortSockets.end()) {
+          ZS_LOG_WARNING(Debug, log("shared udp packet arrived for socket without host port") + ZS_PARAM("socket", string(socket)) + ZS_PARAM("from ip", fromIP.string()))
+          return;
+        }
+        hostPort = (*found).second;
+      }
+
+      // warning: do NOT call from within a lock
+      handleUDPPacket(hostPort, socket, fromIP, buffer, bufferSizeInBytes);
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -2177,7 +2362,7 @@ namespace ortc
           return;
         }
 
-        auto response = handleIncomingPacket(localCandidate, source, stunPacket);
+        auto response = handleIncomingPacket(localCandidate, source, stunPacket, packetLengthInBytes);
         if (response) {
           ZS_LOG_TRACE(log("sending response packet") + localCandidate->toDebug() + ZS_PARAM("to", source.string()) + ZS_PARAM("packet length", response->SizeInBytes()))
           socket->sendPacket(source, *response, response->SizeInBytes());
@@ -2337,6 +2522,7 @@ namespace ortc
 
       IHelper::debugAppend(resultEl, "host ports", mHostPorts.size());
       IHelper::debugAppend(resultEl, "host port sockets", mHostPortSockets.size());
+      IHelper::debugAppend(resultEl, "udp mux", UseUDPMux::toDebug(mUDPMux));
 
       IHelper::debugAppend(resultEl, "stun discoveries", mSTUNDiscoveries.size());
       IHelper::debugAppend(resultEl, "turn sockets", mTURNSockets.size());
@@ -3205,7 +3391,7 @@ namespace ortc
             hostPort->mBindUDPBackOffTimer->notifyAttempting();
 
             IPAddress bindIP(hostPort->mHostData->mIP);
-            hostPort->mBoundUDPSocket = bind(firstAttempt, bindIP, IICETypes::Protocol_UDP);
+            hostPort->mBoundUDPSocket = (mUDPMux ? mUDPMux->bind(bindIP) : bind(firstAttempt, bindIP, IICETypes::Protocol_UDP));
             if (hostPort->mBoundUDPSocket) {
               ZS_EVENTING_4(
                             x, i, Debug, IceGathererHostPortBind, ol, IceGatherer, HostSocketBind,
@@ -3274,9 +3460,12 @@ namespace ortc
                 if (mGatherPassiveTCP) {
                   hostPort->mCandidateTCPPassive = createCandidate(hostPort->mHostData, IICETypes::CandidateType_Host, bindIP, IICETypes::Protocol_TCP, IICETypes::TCPCandidateType_Passive);
                 }
-                IPAddress bindActiveIP(bindIP);
-                bindActiveIP.setPort(9);
-                hostPort->mCandidateTCPActive = createCandidate(hostPort->mHostData, IICETypes::CandidateType_Host, bindActiveIP, IICETypes::Protocol_TCP, IICETypes::TCPCandidateType_Active);
+                if (!mOptions.mICELite) {
+                  // an ice lite agent never initiates connections thus never offers active TCP
+                  IPAddress bindActiveIP(bindIP);
+                  bindActiveIP.setPort(9);
+                  hostPort->mCandidateTCPActive = createCandidate(hostPort->mHostData, IICETypes::CandidateType_Host, bindActiveIP, IICETypes::Protocol_TCP, IICETypes::TCPCandidateType_Active);
+                }
               } else {
                 ZS_EVENTING_4(
                               x, e, Debug, IceGathererHostPortBindFailed, ol, IceGatherer, HostSocketBind,
@@ -3504,6 +3693,13 @@ namespace ortc
           }
         }
 
+        if (mUDPMux) {
+          // every gatherer shares the same local port thus responses from
+          // the stun server cannot be demultiplexed to the right gatherer
+          ZS_LOG_TRACE(log("server reflexive not possible on shared udp port (thus do not setup)"))
+          filterOut = true;
+        }
+
         if (filterOut) {
           for (auto iterReflex_doNotUse = hostPort->mReflexivePorts.begin(); iterReflex_doNotUse != hostPort->mReflexivePorts.end(); ) {
             auto currentReflex = iterReflex_doNotUse;
@@ -3805,6 +4001,13 @@ namespace ortc
           }
         }
 
+        if (mUDPMux) {
+          // every gatherer shares the same local port thus responses from
+          // the turn server cannot be demultiplexed to the right gatherer
+          ZS_LOG_TRACE(log("relay not possible on shared udp port (thus do not setup)"))
+          filterOut = true;
+        }
+
         if (filterOut) {
           for (auto iterRelay_doNotUse = hostPort->mRelayPorts.begin(); iterRelay_doNotUse != hostPort->mRelayPorts.end(); ) {
             auto currentRelay = iterRelay_doNotUse;
@@ -4270,6 +4473,11 @@ namespace ortc
         }
       }
 
+      if (mUDPMux) {
+        mUDPMux->unregisterGatherer(mID);
+        mUDPMux.reset();
+      }
+
       // scope: remote all routes
       {
         for (auto iter_doNotUse = mRoutes.begin(); iter_doNotUse != mRoutes.end();)
@@ -4462,6 +4670,11 @@ namespace ortc
                                    const char *urlPrefix
                                    ) const
     {
+      if (mOptions.mICELite) {
+        ZS_LOG_INSANE(log("ice lite gatherer ignores all servers (host candidates only)") + server.toDebug() + ZS_PARAMIZE(urlPrefix))
+        return false;
+      }
+
       size_t length = strlen(urlPrefix);
 
       if (server.mURLs.size() < 1) {
@@ -4645,10 +4858,15 @@ namespace ortc
         if (found != mHostPortSockets.end()) {
           mHostPortSockets.erase(found);
         }
-        try {
-          hostPort->mBoundUDPSocket->close();
-        } catch(Socket::Exceptions::Unspecified &error) {
-          ZS_LOG_ERROR(Detail, log("failed to close udp socket") + ZS_PARAM("error", error.errorCode()))
+        if (mUDPMux) {
+          // shared socket is owned by the mux
+          mUDPMux->unbind(hostPort->mBoundUDPIP);
+        } else {
+          try {
+            hostPort->mBoundUDPSocket->close();
+          } catch(Socket::Exceptions::Unspecified &error) {
+            ZS_LOG_ERROR(Detail, log("failed to close udp socket") + ZS_PARAM("error", error.errorCode()))
+          }
         }
         hostPort->mBoundUDPSocket.reset();
       }
@@ -5341,14 +5559,11 @@ namespace ortc
                            SocketPtr socket
                            )
     {
-      UseTURNSocketPtr turnSocket;
-      STUNPacketPtr stunPacket;
-
       size_t totalRead = 0;
       IPAddress fromIP;
       BYTE readBuffer[0xFFFF] {};
 
-      CandidatePtr localCandidate;
+      ReceiveLatencyScope latencyScope;
 
       {
         AutoRecursiveLock lock(*this);
@@ -5371,40 +5586,8 @@ namespace ortc
             return false;
           }
 
-          ZS_EVENTING_4(
-                        x, i, Trace, IceGathererUdpSocketPacketReceivedFrom, ol, IceGatherer, Receive,
-                        puid, id, mID,
-                        string, fromIp, fromIP.string(),
-                        buffer, packet, &(readBuffer[0]),
-                        size, size, totalRead
-                        );
-
-          ZS_LOG_INSANE(log("receiving incoming packet") + ZS_PARAM("from ip", fromIP.string()) + ZS_PARAM("read", totalRead) + hostPort->toDebug());
-
-          stunPacket = STUNPacket::parseIfSTUN(&(readBuffer[0]), totalRead, mSTUNPacketParseOptions);
-          fixSTUNParserOptions(stunPacket);
-
-          // scope: check if for relay socket
-          {
-            auto found = hostPort->mIPToRelayPortMapping.find(fromIP);
-            if (found != hostPort->mIPToRelayPortMapping.end()) {
-              auto relayPort = (*found).second;
-              turnSocket = relayPort->mTURNSocket;
-              if (!turnSocket) {
-                ZS_LOG_WARNING(Detail, log("TURN socket was not found despite mapping being found") + relayPort->toDebug());
-                goto unknown_handler;
-              }
-              goto found_relay_port;
-            }
-          }
-
-          // this is not a relay socket, see if there is a route
-          localCandidate = hostPort->mCandidateUDP;
-          if (!localCandidate) {
-            ZS_LOG_WARNING(Trace, log("did not find local candidate"))
-            goto unknown_handler;
-          }
-          goto handle_incoming;
+          latencyScope.received();
+          goto handle_udp_packet;
         }
 
         if (hostPort->mBoundTCPSocket == socket) {
@@ -5455,15 +5638,81 @@ namespace ortc
 
       return false;
 
+    handle_udp_packet:
+      {
+        // warning: do NOT call from within a lock
+        handleUDPPacket(hostPort, socket, fromIP, &(readBuffer[0]), totalRead);
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGatherer::handleUDPPacket(
+                                      HostPortPtr hostPort,
+                                      SocketPtr socket,
+                                      const IPAddress &fromIP,
+                                      const BYTE *buffer,
+                                      size_t bufferSizeInBytes
+                                      )
+    {
+      UseTURNSocketPtr turnSocket;
+      STUNPacketPtr stunPacket;
+      UseUDPMuxPtr udpMux;
+      IPAddress boundUDPIP;
+
+      CandidatePtr localCandidate;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        udpMux = mUDPMux;
+        boundUDPIP = hostPort->mBoundUDPIP;
+
+        ZS_EVENTING_4(
+                      x, i, Trace, IceGathererUdpSocketPacketReceivedFrom, ol, IceGatherer, Receive,
+                      puid, id, mID,
+                      string, fromIp, fromIP.string(),
+                      buffer, packet, buffer,
+                      size, size, bufferSizeInBytes
+                      );
+
+        ZS_LOG_INSANE(log("receiving incoming packet") + ZS_PARAM("from ip", fromIP.string()) + ZS_PARAM("read", bufferSizeInBytes) + hostPort->toDebug());
+
+        stunPacket = STUNPacket::parseIfSTUN(buffer, bufferSizeInBytes, mSTUNPacketParseOptions);
+        fixSTUNParserOptions(stunPacket);
+
+        // scope: check if for relay socket
+        {
+          auto found = hostPort->mIPToRelayPortMapping.find(fromIP);
+          if (found != hostPort->mIPToRelayPortMapping.end()) {
+            auto relayPort = (*found).second;
+            turnSocket = relayPort->mTURNSocket;
+            if (!turnSocket) {
+              ZS_LOG_WARNING(Detail, log("TURN socket was not found despite mapping being found") + relayPort->toDebug());
+              goto unknown_handler;
+            }
+            goto found_relay_port;
+          }
+        }
+
+        // this is not a relay socket, see if there is a route
+        localCandidate = hostPort->mCandidateUDP;
+        if (!localCandidate) {
+          ZS_LOG_WARNING(Trace, log("did not find local candidate"))
+          goto unknown_handler;
+        }
+        goto handle_incoming;
+      }
+
     unknown_handler:
       {
         if (stunPacket) {
           if (ISTUNRequester::handleSTUNPacket(fromIP, stunPacket)) {
             ZS_LOG_TRACE(log("handled by stun requester") + ZS_PARAM("from ip", fromIP.string()) + stunPacket->toDebug())
-            return true;
+            return;
           }
         }
-        return true;
+        return;
       }
 
     found_relay_port:
@@ -5473,24 +5722,24 @@ namespace ortc
                       puid, id, mID,
                       string, fromIp, fromIP.string(),
                       bool, isStunPacket, ((bool)stunPacket),
-                      buffer, packet, &(readBuffer[0]),
-                      size, size, totalRead
+                      buffer, packet, buffer,
+                      size, size, bufferSizeInBytes
                       );
 
         if (stunPacket) {
           if (ISTUNRequester::handleSTUNPacket(fromIP, stunPacket)) {
             ZS_LOG_TRACE(log("handled by stun requester") + ZS_PARAM("from ip", fromIP.string()) + stunPacket->toDebug())
-            return true;
+            return;
           }
 
           ZS_LOG_INSANE(log("forwarding stun packet to turn socket") + ZS_PARAM("from ip", fromIP.string()) + stunPacket->toDebug())
           turnSocket->handleSTUNPacket(fromIP, stunPacket);
-          return true;
+          return;
         }
 
-        ZS_LOG_INSANE(log("forwarding turn channel data to turn socket") + ZS_PARAM("from ip", fromIP.string()) + ZS_PARAM("total", totalRead))
-        turnSocket->handleChannelData(fromIP, &(readBuffer[0]), totalRead);
-        return true;
+        ZS_LOG_INSANE(log("forwarding turn channel data to turn socket") + ZS_PARAM("from ip", fromIP.string()) + ZS_PARAM("total", bufferSizeInBytes))
+        turnSocket->handleChannelData(fromIP, buffer, bufferSizeInBytes);
+        return;
       }
 
     handle_incoming:
@@ -5498,11 +5747,18 @@ namespace ortc
         if (stunPacket) {
           if (ISTUNRequester::handleSTUNPacket(fromIP, stunPacket)) {
             ZS_LOG_TRACE(log("handled by stun requester") + ZS_PARAM("from ip", fromIP.string()) + stunPacket->toDebug())
-            return true;
+            return;
           }
 
           ZS_LOG_INSANE(log("handling incoming stun packet") + localCandidate->toDebug() + ZS_PARAM("from ip", fromIP.string()) + stunPacket->toDebug())
-          auto response = handleIncomingPacket(localCandidate, fromIP, stunPacket);
+          bool authenticated = false;
+          auto response = handleIncomingPacket(localCandidate, fromIP, stunPacket, bufferSizeInBytes, &authenticated);
+          if ((authenticated) &&
+              (udpMux)) {
+            // the shared port only learns remotes whose requests passed
+            // MESSAGE-INTEGRITY against this gatherer's password
+            udpMux->notifyRemote(mID, boundUDPIP, fromIP);
+          }
           if (response) {
             AutoRecursiveLock lock(*this);
 
@@ -5515,11 +5771,11 @@ namespace ortc
               ZS_LOG_WARNING(Debug, log("cannot send response as socket is gone") + localCandidate->toDebug() + ZS_PARAM("from ip", fromIP.string()) + stunPacket->toDebug())
             }
           }
-          return true;
+          return;
         }
-        ZS_LOG_INSANE(log("handling incoming packet") + localCandidate->toDebug() + ZS_PARAM("from ip", fromIP.string()) + ZS_PARAM("total", totalRead))
-        handleIncomingPacket(localCandidate, fromIP, &(readBuffer[0]), totalRead);
-        return true;
+        ZS_LOG_INSANE(log("handling incoming packet") + localCandidate->toDebug() + ZS_PARAM("from ip", fromIP.string()) + ZS_PARAM("total", bufferSizeInBytes))
+        handleIncomingPacket(localCandidate, fromIP, buffer, bufferSizeInBytes);
+        return;
       }
     }
 
@@ -5534,6 +5790,8 @@ namespace ortc
       CandidatePtr localCandidate;
       IPAddress fromIP;
 
+      ReceiveLatencyScope latencyScope;
+
       {
         AutoRecursiveLock lock(*this);
 
@@ -5609,6 +5867,9 @@ namespace ortc
         for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
           auto packet = (*iter);
 
+          // framed packets are timed from when they leave the TCP buffer
+          latencyScope.received();
+
           if (packet->mSTUNPacket) {
             if (ISTUNRequester::handleSTUNPacket(fromIP, packet->mSTUNPacket)) {
               ZS_LOG_TRACE(log("handled by stun requester") + ZS_PARAM("from ip", fromIP.string()) + packet->mSTUNPacket->toDebug())
@@ -5617,7 +5878,7 @@ namespace ortc
 
             ZS_LOG_TRACE(log("handling incoming TCP stun packet") + packet->toDebug() + packet->mSTUNPacket->toDebug())
 
-            auto response = handleIncomingPacket(localCandidate, fromIP, packet->mSTUNPacket);
+            auto response = handleIncomingPacket(localCandidate, fromIP, packet->mSTUNPacket, packet->mBuffer->SizeInBytes());
             if (response) {
               AutoRecursiveLock lock(*this);
               if (tcpPort.mSocket) {
@@ -5820,9 +6081,13 @@ namespace ortc
     SecureByteBlockPtr ICEGatherer::handleIncomingPacket(
                                                          CandidatePtr localCandidate,
                                                          const IPAddress &remoteIP,
-                                                         STUNPacketPtr stunPacket
+                                                         STUNPacketPtr stunPacket,
+                                                         size_t packetSizeInBytes,
+                                                         bool *outAuthenticated
                                                          )
     {
+      if (outAuthenticated) *outAuthenticated = false;
+
       RoutePtr route;
       RouterRoutePtr routerRoute;
       UseICETransportPtr transport;
@@ -5880,6 +6145,8 @@ namespace ortc
             }
           }
 
+          if (outAuthenticated) *outAuthenticated = true;
+
           auto found = mInstalledTransports.find(rFrag);
           if (found == mInstalledTransports.end()) goto buffer_data_now;
 
@@ -5917,6 +6184,7 @@ namespace ortc
                       bool, wasBuffered, false
                       );
         stunPacket->trace(__func__);
+        routerRoute->notifyReceived(packetSizeInBytes);
         transport->notifyPacket(routerRoute, stunPacket);
         return SecureByteBlockPtr();
       }
@@ -5953,6 +6221,8 @@ namespace ortc
           return SecureByteBlockPtr();
         }
 
+        routerRoute->notifyReceived(packetSizeInBytes);
+
         AutoRecursiveLock lock(*this);
 
         BufferedPacketPtr packet(make_shared<BufferedPacket>());
@@ -6020,7 +6290,9 @@ namespace ortc
                       buffer, packet, buffer,
                       size, size, bufferSizeInBytes
                       );
+        routerRoute->notifyReceived(bufferSizeInBytes);
         transport->notifyPacket(routerRoute, buffer, bufferSizeInBytes);
+        return;
       }
 
     buffer_data_now:
@@ -6033,6 +6305,8 @@ namespace ortc
           return;
         }
 
+        routerRoute->notifyReceived(bufferSizeInBytes);
+
         AutoRecursiveLock lock(*this);
 
         BufferedPacketPtr packet(make_shared<BufferedPacket>());
@@ -6508,6 +6782,49 @@ namespace ortc
       return false;
     }
 
+    //-------------------------------------------------------------------------
+    bool ICEGatherer::sendTCPPacket(
+                                    UseICETransport &transport,
+                                    RouterRoutePtr routerRoute,
+                                    RoutePtr route,
+                                    const BYTE *buffer,
+                                    size_t bufferSizeInBytes
+                                    )
+    {
+      auto currentSize = route->mTCPPort->mOutgoingBuffer.CurrentSize();
+      auto maxSize = (route->mTCPPort->mConnected ? mMaxTCPBufferingSizeConnected : mMaxTCPBufferingSizePendingConnection);
+
+      ZS_LOG_INSANE(log("putting packet into TCP buffer for sending") + route->toDebug() + route->mTCPPort->toDebug() + ZS_PARAM("buffer size", bufferSizeInBytes) + ZS_PARAM("current buffer size", currentSize) + ZS_PARAM("max size", maxSize))
+
+      if (currentSize > maxSize) {
+        ZS_LOG_WARNING(Trace, log("cannot send packet due to TCP buffer overflow") + route->toDebug() + route->mTCPPort->toDebug() + ZS_PARAM("buffer size", bufferSizeInBytes) + ZS_PARAM("current buffer size", currentSize) + ZS_PARAM("max size", maxSize))
+        return false;
+      }
+
+      ZS_EVENTING_6(
+                    x, i, Trace, IceGathererSendIceTransportPacketViaTcp, ol, IceGatherer, Send,
+                    puid, id, mID,
+                    puid, iceTransportId, transport.getID(),
+                    puid, routerRouteId, routerRoute->mID,
+                    puid, tcpPortId, route->mTCPPort->mID,
+                    buffer, packet, buffer,
+                    size, size, bufferSizeInBytes
+                    );
+
+      CryptoPP::word16 packeSize {static_cast<CryptoPP::word16>(htons(static_cast<unsigned short>(bufferSizeInBytes)))};
+
+      route->mTCPPort->mOutgoingBuffer.Put((const BYTE *)(&packeSize), sizeof(packeSize));
+      route->mTCPPort->mOutgoingBuffer.Put(buffer, bufferSizeInBytes);
+      if ((route->mTCPPort->mConnected) &&
+          (0 == currentSize) &&
+          (route->mTCPPort->mWriteReady)) {
+        ZS_LOG_INSANE(log("simulate write ready for TCP socket (to ensure packet is sent out straight away)"))
+        ISocketDelegateProxy::create(mThisWeak.lock())->onWriteReady(route->mTCPPort->mSocket);
+      }
+      routerRoute->notifySent(bufferSizeInBytes);
+      return true;
+    }
+
     //-------------------------------------------------------------------------
     bool ICEGatherer::shouldKeepWarm() const
     {
@@ -7621,6 +7938,17 @@ namespace ortc
       }
     }
 
+    {
+      String str = IHelper::getElementText(elem->findFirstChildElement("iceLite"));
+      if (str.hasData()) {
+        try {
+          mICELite = Numeric<decltype(mICELite)>(str);
+        } catch(const Numeric<decltype(mICELite)>::ValueOutOfRange &) {
+          ZS_LOG_WARNING(Debug, slog("ice lite value out of range") + ZS_PARAM("value", str))
+        }
+      }
+    }
+
     ElementPtr interfacePoliciesEl = elem->findFirstChildElement("interfacePolicies");
 
     if (interfacePoliciesEl) {
@@ -7665,6 +7993,9 @@ namespace ortc
     ElementPtr elem = Element::create(objectName);
 
     elem->adoptAsLastChild(IHelper::createElementWithNumber("continuousGathering",  string(mContinuousGathering)));
+    if (mICELite) {
+      elem->adoptAsLastChild(IHelper::createElementWithNumber("iceLite", string(mICELite)));
+    }
 
     if (mInterfacePolicies.size() > 0) {
       ElementPtr interfacePoliciesEl = Element::create("interfacePolicies");
@@ -7705,7 +8036,8 @@ namespace ortc
   {
     auto hasher = IHasher::sha1();
 
-    hasher->update(mContinuousGathering ? "Options:true:policy:" : "Options:false:policy:");
+    hasher->update(mContinuousGathering ? "Options:true:" : "Options:false:");
+    hasher->update(mICELite ? "lite:policy:" : "full:policy:");
     for (auto iter = mInterfacePolicies.begin(); iter != mInterfacePolicies.end(); ++iter) {
       auto policy = (*iter);
       hasher->update(policy.hash());
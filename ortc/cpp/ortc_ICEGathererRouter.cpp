@@ -416,6 +416,10 @@ namespace ortc
       UseServicesHelper::debugAppend(objectEl, "id", mID);
       UseServicesHelper::debugAppend(objectEl, "local candidate", mLocalCandidate ? mLocalCandidate->toDebug() : ElementPtr());
       UseServicesHelper::debugAppend(objectEl, "remote ip", mRemoteIP.string());
+      UseServicesHelper::debugAppend(objectEl, "packets sent", mPacketsSent.load());
+      UseServicesHelper::debugAppend(objectEl, "bytes sent", mBytesSent.load());
+      UseServicesHelper::debugAppend(objectEl, "packets received", mPacketsReceived.load());
+      UseServicesHelper::debugAppend(objectEl, "bytes received", mBytesReceived.load());
       return objectEl;
     }
 
@@ -0,0 +1,812 @@
+/*
+
+ Copyright (c) 2016, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#include <ortc/internal/ortc_ICEGathererUDPMux.h>
+#include <ortc/internal/ortc_ICEGatherer.h>
+#include <ortc/internal/ortc_Helper.h>
+#include <ortc/internal/ortc_ORTC.h>
+#include <ortc/internal/ortc_ReceiveLatency.h>
+#include <ortc/internal/platform.h>
+
+#include <ortc/IHelper.h>
+
+#include <ortc/services/ISTUNRequester.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/Log.h>
+#include <zsLib/XML.h>
+#include <zsLib/SafeInt.h>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#endif //ndef _WIN32
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib_icegatherer) }
+
+namespace ortc
+{
+  ZS_DECLARE_USING_PTR(zsLib, ISettings);
+
+  namespace internal
+  {
+    ZS_DECLARE_CLASS_PTR(ICEGathererUDPMuxSettingsDefaults);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererUDPMuxSettingsDefaults
+    #pragma mark
+
+    class ICEGathererUDPMuxSettingsDefaults : public ISettingsApplyDefaultsDelegate
+    {
+    public:
+      //-----------------------------------------------------------------------
+      ~ICEGathererUDPMuxSettingsDefaults()
+      {
+        ISettings::removeDefaults(*this);
+      }
+
+      //-----------------------------------------------------------------------
+      static ICEGathererUDPMuxSettingsDefaultsPtr singleton()
+      {
+        static SingletonLazySharedPtr<ICEGathererUDPMuxSettingsDefaults> singleton(create());
+        return singleton.singleton();
+      }
+
+      //-----------------------------------------------------------------------
+      static ICEGathererUDPMuxSettingsDefaultsPtr create()
+      {
+        auto pThis(make_shared<ICEGathererUDPMuxSettingsDefaults>());
+        ISettings::installDefaults(pThis);
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      virtual void notifySettingsApplyDefaults() override
+      {
+        ISettings::setUInt(ORTC_SETTING_GATHERER_UDP_MUX_PORT, 0);
+        ISettings::setUInt(ORTC_SETTING_GATHERER_UDP_MUX_TOTAL_SHARDS, 1);
+        ISettings::setUInt(ORTC_SETTING_GATHERER_UDP_MUX_REMOTE_IDLE_TIMEOUT_IN_SECONDS, 60);
+      }
+      
+    };
+
+    //-------------------------------------------------------------------------
+    void installICEGathererUDPMuxSettingsDefaults()
+    {
+      ICEGathererUDPMuxSettingsDefaults::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (helpers)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    static bool mightBeSTUNRequest(
+                                   const BYTE *buffer,
+                                   size_t bufferSizeInBytes
+                                   )
+    {
+      if (bufferSizeInBytes < 20) return false;           // smaller than a STUN header
+      if (buffer[0] > 3) return false;                    // RFC 7983 demultiplexing range for STUN
+      return (0 == (buffer[0] & 0x01)) &&                 // class bit C1
+             (0 == (buffer[1] & 0x10));                   // class bit C0
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IICEGathererUDPMuxForICEGatherer
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr IICEGathererUDPMuxForICEGatherer::toDebug(ForICEGathererPtr mux)
+    {
+      if (!mux) return ElementPtr();
+      return ICEGathererUDPMux::convert(mux)->toDebug();
+    }
+
+    //-------------------------------------------------------------------------
+    IICEGathererUDPMuxForICEGatherer::ForICEGathererPtr IICEGathererUDPMuxForICEGatherer::singleton()
+    {
+      return ICEGathererUDPMux::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererUDPMux::Shard
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ICEGathererUDPMux::Shard::Shard(
+                                    IMessageQueuePtr queue,
+                                    ICEGathererUDPMuxPtr outer,
+                                    size_t index
+                                    ) :
+      MessageQueueAssociator(queue),
+      mOuter(outer),
+      mIndex(index)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererUDPMux::Shard::onReadReady(SocketPtr socket)
+    {
+      auto outer = mOuter.lock();
+      if (!outer) return;
+
+      // warning: do NOT call from within a lock
+      while (outer->read(socket)) {}
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererUDPMux::Shard::onWriteReady(SocketPtr socket)
+    {
+      ZS_LOG_INSANE(ICEGathererUDPMux::slog("write ready") + ZS_PARAM("shard", mIndex) + ZS_PARAM("socket", string(socket)))
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererUDPMux::Shard::onException(SocketPtr socket)
+    {
+      ZS_LOG_WARNING(Debug, ICEGathererUDPMux::slog("socket exception") + ZS_PARAM("shard", mIndex) + ZS_PARAM("socket", string(socket)))
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererUDPMux::Listener
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr ICEGathererUDPMux::Listener::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::ICEGathererUDPMux::Listener");
+
+      IHelper::debugAppend(resultEl, "bound ip", mBoundIP.string());
+      IHelper::debugAppend(resultEl, "sockets", mSockets.size());
+      IHelper::debugAppend(resultEl, "bindings", mTotalBindings);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererUDPMux::GathererInfo
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr ICEGathererUDPMux::GathererInfo::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::ICEGathererUDPMux::GathererInfo");
+
+      IHelper::debugAppend(resultEl, "gatherer id", mGathererID);
+      IHelper::debugAppend(resultEl, "gatherer", (bool)(mGatherer.lock()));
+      IHelper::debugAppend(resultEl, "username frag", mUsernameFrag);
+      IHelper::debugAppend(resultEl, "remotes", mRemotes.size());
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererUDPMux
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ICEGathererUDPMux::ICEGathererUDPMux(
+                                         const make_private &,
+                                         WORD port,
+                                         size_t totalShards
+                                         ) :
+      SharedRecursiveLock(SharedRecursiveLock::create()),
+      mPort(port),
+      mRemoteIdleTimeout(ISettings::getUInt(ORTC_SETTING_GATHERER_UDP_MUX_REMOTE_IDLE_TIMEOUT_IN_SECONDS)),
+      mSTUNPacketParseOptions(STUNPacket::RFC_AllowAll, false, "ortc::ICEGathererUDPMux", mID)
+    {
+      for (size_t index = 0; index < totalShards; ++index) {
+        mShards.push_back(ShardPtr());
+      }
+      ZS_LOG_DETAIL(debug("created"))
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererUDPMux::init()
+    {
+      AutoRecursiveLock lock(*this);
+
+      for (size_t index = 0; index < mShards.size(); ++index) {
+        mShards[index] = make_shared<Shard>(IORTCForInternal::queuePacket(), mThisWeak.lock(), index);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    ICEGathererUDPMux::~ICEGathererUDPMux()
+    {
+      if (isNoop()) return;
+
+      ZS_LOG_DETAIL(log("destroyed"))
+      mThisWeak.reset();
+
+      cancel();
+    }
+
+    //-------------------------------------------------------------------------
+    ICEGathererUDPMuxPtr ICEGathererUDPMux::convert(ForICEGathererPtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(ICEGathererUDPMux, object);
+    }
+
+    //-------------------------------------------------------------------------
+    ICEGathererUDPMuxPtr ICEGathererUDPMux::create()
+    {
+      WORD port = SafeInt<WORD>(ISettings::getUInt(ORTC_SETTING_GATHERER_UDP_MUX_PORT));
+      if (0 == port) return ICEGathererUDPMuxPtr();
+
+      size_t totalShards = SafeInt<size_t>(ISettings::getUInt(ORTC_SETTING_GATHERER_UDP_MUX_TOTAL_SHARDS));
+      if (totalShards < 1) totalShards = 1;
+
+#ifndef SO_REUSEPORT
+      if (totalShards > 1) {
+        ZS_LOG_WARNING(Detail, slog("SO_REUSEPORT is not supported on this platform (thus only a single shard is possible)"))
+        totalShards = 1;
+      }
+#endif //ndef SO_REUSEPORT
+
+      ICEGathererUDPMuxPtr pThis(make_shared<ICEGathererUDPMux>(make_private {}, port, totalShards));
+      pThis->mThisWeak = pThis;
+      pThis->init();
+      return pThis;
+    }
+
+    //-------------------------------------------------------------------------
+    ICEGathererUDPMuxPtr ICEGathererUDPMux::singleton()
+    {
+      AutoRecursiveLock lock(*IHelper::getGlobalLock());
+      static SingletonLazySharedPtr<ICEGathererUDPMux> singleton(create());
+      ICEGathererUDPMuxPtr result = singleton.singleton();
+
+      static zsLib::SingletonManager::Register registerSingleton("org.ortc.ICEGathererUDPMux", result);
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererUDPMux => IICEGathererUDPMuxForICEGatherer
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void ICEGathererUDPMux::registerGatherer(
+                                             UseICEGathererPtr gatherer,
+                                             const String &localUsernameFrag
+                                             )
+    {
+      ZS_THROW_INVALID_ARGUMENT_IF(!gatherer)
+
+      AutoRecursiveLock lock(*this);
+
+      auto gathererID = gatherer->getID();
+
+      {
+        auto found = mUsernameFrags.find(localUsernameFrag);
+        if (found != mUsernameFrags.end()) {
+          auto &existing = (*found).second;
+          if (existing->mGathererID != gathererID) {
+            ZS_LOG_WARNING(Detail, log("username frag is already in use by another gatherer (thus incoming requests cannot be demultiplexed)") + ZS_PARAM("gatherer id", gathererID) + existing->toDebug())
+            return;
+          }
+        }
+      }
+
+      GathererInfoPtr info(make_shared<GathererInfo>());
+      info->mGathererID = gathererID;
+      info->mGatherer = gatherer;
+      info->mUsernameFrag = localUsernameFrag;
+
+      mGatherers[gathererID] = info;
+      mUsernameFrags[localUsernameFrag] = info;
+
+      ZS_LOG_DEBUG(log("registered gatherer") + info->toDebug())
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererUDPMux::unregisterGatherer(PUID gathererID)
+    {
+      AutoRecursiveLock lock(*this);
+
+      auto found = mGatherers.find(gathererID);
+      if (found == mGatherers.end()) return;
+
+      auto info = (*found).second;
+
+      for (auto iter = info->mRemotes.begin(); iter != info->mRemotes.end(); ++iter) {
+        auto foundRemote = mRemotes.find(*iter);
+        if (foundRemote == mRemotes.end()) continue;
+        if ((*foundRemote).second->mGathererInfo != info) continue;
+        mRemotes.erase(foundRemote);
+      }
+      info->mRemotes.clear();
+
+      {
+        auto foundFrag = mUsernameFrags.find(info->mUsernameFrag);
+        if ((foundFrag != mUsernameFrags.end()) &&
+            ((*foundFrag).second == info)) {
+          mUsernameFrags.erase(foundFrag);
+        }
+      }
+
+      mGatherers.erase(found);
+
+      ZS_LOG_DEBUG(log("unregistered gatherer") + info->toDebug())
+    }
+
+    //-------------------------------------------------------------------------
+    ICEGathererUDPMux::SocketPtr ICEGathererUDPMux::bind(IPAddress &ioBindIP)
+    {
+      AutoRecursiveLock lock(*this);
+
+      IPAddress bindIP(ioBindIP);
+      bindIP.setPort(mPort);
+
+      {
+        auto found = mListeners.find(bindIP);
+        if (found != mListeners.end()) {
+          auto listener = (*found).second;
+          ++(listener->mTotalBindings);
+          ioBindIP = bindIP;
+          ZS_LOG_TRACE(log("sharing existing bound socket") + listener->toDebug())
+          return listener->mSockets.front();
+        }
+      }
+
+      ListenerPtr listener(make_shared<Listener>());
+      listener->mBoundIP = bindIP;
+
+      for (auto iter = mShards.begin(); iter != mShards.end(); ++iter) {
+        auto socket = createSocket(bindIP, *iter);
+        if (!socket) {
+          ZS_LOG_WARNING(Detail, log("failed to bind shared udp socket") + ZS_PARAM("bind ip", bindIP.string()) + ZS_PARAM("shard", (*iter)->index()))
+          close(listener);
+          return SocketPtr();
+        }
+        listener->mSockets.push_back(socket);
+        mSocketListeners[socket] = listener;
+      }
+
+      listener->mTotalBindings = 1;
+      mListeners[bindIP] = listener;
+
+      ZS_LOG_DEBUG(log("bound shared udp socket") + listener->toDebug())
+
+      ioBindIP = bindIP;
+      return listener->mSockets.front();
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererUDPMux::unbind(const IPAddress &boundIP)
+    {
+      AutoRecursiveLock lock(*this);
+
+      auto found = mListeners.find(boundIP);
+      if (found == mListeners.end()) {
+        ZS_LOG_WARNING(Debug, log("unbind called for unknown bound ip") + ZS_PARAM("bound ip", boundIP.string()))
+        return;
+      }
+
+      auto listener = (*found).second;
+      if (listener->mTotalBindings > 1) {
+        --(listener->mTotalBindings);
+        return;
+      }
+
+      ZS_LOG_DEBUG(log("last binding released (thus closing shared socket)") + listener->toDebug())
+
+      mListeners.erase(found);
+      close(listener);
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererUDPMux::notifyRemote(
+                                         PUID gathererID,
+                                         const IPAddress &boundIP,
+                                         const IPAddress &remoteIP
+                                         )
+    {
+      AutoRecursiveLock lock(*this);
+
+      auto found = mGatherers.find(gathererID);
+      if (found == mGatherers.end()) return;
+
+      auto info = (*found).second;
+
+      auto now = zsLib::now();
+
+      expireIdleRemotes(now);
+
+      LocalRemotePair key(boundIP, remoteIP);
+
+      auto foundRemote = mRemotes.find(key);
+      if (foundRemote != mRemotes.end()) {
+        auto remote = (*foundRemote).second;
+        remote->mLastActivity = now;
+        if (remote->mGathererInfo == info) return;
+
+        ZS_LOG_WARNING(Debug, log("authenticated remote address moving to different gatherer") + ZS_PARAM("bound ip", boundIP.string()) + ZS_PARAM("remote ip", remoteIP.string()) + remote->mGathererInfo->toDebug() + info->toDebug())
+
+        remote->mGathererInfo->mRemotes.erase(key);
+        remote->mGathererInfo = info;
+        info->mRemotes.insert(key);
+        return;
+      }
+
+      RemoteInfoPtr remote(make_shared<RemoteInfo>());
+      remote->mGathererInfo = info;
+      remote->mLastActivity = now;
+
+      mRemotes[key] = remote;
+      info->mRemotes.insert(key);
+
+      ZS_LOG_DEBUG(log("associated authenticated remote") + ZS_PARAM("bound ip", boundIP.string()) + ZS_PARAM("remote ip", remoteIP.string()) + info->toDebug())
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererUDPMux => ISingletonManagerDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void ICEGathererUDPMux::notifySingletonCleanup()
+    {
+      cancel();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererUDPMux => friend Shard
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    bool ICEGathererUDPMux::read(SocketPtr socket)
+    {
+      IPAddress fromIP;
+      size_t totalRead = 0;
+      BYTE readBuffer[0xFFFF] {};
+
+      ReceiveLatencyScope latencyScope;
+
+      // the receive and any STUN parsing happen outside the lock as every
+      // shard's packet thread shares this mux
+      {
+        bool wouldBlock = false;
+        try {
+          totalRead = socket->receiveFrom(fromIP, readBuffer, sizeof(readBuffer), &wouldBlock);
+        } catch(Socket::Exceptions::Unspecified &error) {
+          ZS_LOG_WARNING(Debug, log("socket read error") + ZS_PARAM("socket", string(socket)) + ZS_PARAM("error", error.errorCode()))
+          return false;
+        }
+
+        if (0 == totalRead) return false;
+      }
+
+      latencyScope.received();
+
+      SocketPtr canonicalSocket;
+      IPAddress boundIP;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        auto foundListener = mSocketListeners.find(socket);
+        if (foundListener == mSocketListeners.end()) {
+          ZS_LOG_WARNING(Debug, log("read ready on unknown socket") + ZS_PARAM("socket", string(socket)))
+          return false;
+        }
+
+        auto listener = (*foundListener).second;
+
+        // gatherers only know the first shard's socket; packets arriving on
+        // any other shard are delivered as if received on that socket
+        boundIP = listener->mBoundIP;
+        if (listener->mSockets.size() > 0) canonicalSocket = listener->mSockets.front();
+      }
+
+      if (!canonicalSocket) return true;
+
+      auto gatherer = route(boundIP, fromIP, &(readBuffer[0]), totalRead);
+      if (!gatherer) return true;
+
+      gatherer->notifyUDPMuxPacket(canonicalSocket, fromIP, &(readBuffer[0]), totalRead);
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererUDPMux => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    Log::Params ICEGathererUDPMux::log(const char *message) const
+    {
+      ElementPtr objectEl = Element::create("ortc::ICEGathererUDPMux");
+      IHelper::debugAppend(objectEl, "id", mID);
+      return Log::Params(message, objectEl);
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params ICEGathererUDPMux::slog(const char *message)
+    {
+      ElementPtr objectEl = Element::create("ortc::ICEGathererUDPMux");
+      return Log::Params(message, objectEl);
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params ICEGathererUDPMux::debug(const char *message) const
+    {
+      return Log::Params(message, toDebug());
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr ICEGathererUDPMux::toDebug() const
+    {
+      AutoRecursiveLock lock(*this);
+
+      ElementPtr resultEl = Element::create("ortc::ICEGathererUDPMux");
+
+      IHelper::debugAppend(resultEl, "id", mID);
+      IHelper::debugAppend(resultEl, "port", mPort);
+      IHelper::debugAppend(resultEl, "shards", mShards.size());
+      IHelper::debugAppend(resultEl, "listeners", mListeners.size());
+      IHelper::debugAppend(resultEl, "sockets", mSocketListeners.size());
+      IHelper::debugAppend(resultEl, "gatherers", mGatherers.size());
+      IHelper::debugAppend(resultEl, "username frags", mUsernameFrags.size());
+      IHelper::debugAppend(resultEl, "remotes", mRemotes.size());
+      IHelper::debugAppend(resultEl, "remote idle timeout", mRemoteIdleTimeout);
+      IHelper::debugAppend(resultEl, "last idle sweep", mLastIdleSweep);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererUDPMux::cancel()
+    {
+      AutoRecursiveLock lock(*this);
+
+      for (auto iter = mListeners.begin(); iter != mListeners.end(); ++iter) {
+        close((*iter).second);
+      }
+      mListeners.clear();
+      mSocketListeners.clear();
+
+      mRemotes.clear();
+      mUsernameFrags.clear();
+      mGatherers.clear();
+    }
+
+    //-------------------------------------------------------------------------
+    ICEGathererUDPMux::UseICEGathererPtr ICEGathererUDPMux::route(
+                                                                  const IPAddress &boundIP,
+                                                                  const IPAddress &fromIP,
+                                                                  const BYTE *buffer,
+                                                                  size_t bufferSizeInBytes
+                                                                  )
+    {
+      UseICEGathererPtr gatherer;
+
+      // scope: known (authenticated) remote 5-tuple
+      {
+        AutoRecursiveLock lock(*this);
+
+        auto now = zsLib::now();
+
+        expireIdleRemotes(now);
+
+        auto found = mRemotes.find(LocalRemotePair(boundIP, fromIP));
+        if (found != mRemotes.end()) {
+          auto remote = (*found).second;
+          remote->mLastActivity = now;
+          gatherer = remote->mGathererInfo->mGatherer.lock();
+        }
+      }
+
+      // media and STUN responses from a known remote skip STUN parsing
+      if ((gatherer) &&
+          (!mightBeSTUNRequest(buffer, bufferSizeInBytes))) return gatherer;
+
+      // parsing happens outside the lock as every shard's packet thread
+      // shares this mux
+      auto stunPacket = STUNPacket::parseIfSTUN(buffer, bufferSizeInBytes, mSTUNPacketParseOptions);
+      if (!stunPacket) {
+        if (!gatherer) {
+          ZS_LOG_TRACE(log("dropping non-stun packet from unauthenticated remote") + ZS_PARAM("from ip", fromIP.string()) + ZS_PARAM("size", bufferSizeInBytes))
+        }
+        return gatherer;
+      }
+
+      if (STUNPacket::Class_Request != stunPacket->mClass) {
+        if (gatherer) return gatherer;
+
+        // responses are matched against outstanding requests by
+        // transaction ID (requesters are process wide)
+        if (!ISTUNRequester::handleSTUNPacket(fromIP, stunPacket)) {
+          ZS_LOG_TRACE(log("dropping unexpected stun packet from unknown remote") + ZS_PARAM("from ip", fromIP.string()) + stunPacket->toDebug())
+        }
+        return UseICEGathererPtr();
+      }
+
+      // requests are always routed by USERNAME (even from a known remote) so
+      // the gatherer owning the username frag checks MESSAGE-INTEGRITY; the
+      // remote is only learned (or moved) when that gatherer confirms it
+      String username = stunPacket->mUsername;
+      auto pos = username.find(':');
+      String localFrag = (String::npos == pos ? username : username.substr(0, pos));
+
+      AutoRecursiveLock lock(*this);
+
+      auto found = mUsernameFrags.find(localFrag);
+      if (found == mUsernameFrags.end()) {
+        ZS_LOG_TRACE(log("no gatherer matches username frag") + ZS_PARAM("from ip", fromIP.string()) + stunPacket->toDebug())
+        return UseICEGathererPtr();
+      }
+
+      return (*found).second->mGatherer.lock();
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererUDPMux::expireIdleRemotes(Time now)
+    {
+      // warning: must be called from within the object lock
+
+      if (Seconds() == mRemoteIdleTimeout) return;
+      if (now < mLastIdleSweep + mRemoteIdleTimeout) return;
+
+      mLastIdleSweep = now;
+
+      for (auto iter_doNotUse = mRemotes.begin(); iter_doNotUse != mRemotes.end(); ) {
+        auto current = iter_doNotUse;
+        ++iter_doNotUse;
+
+        auto remote = (*current).second;
+        if (remote->mLastActivity + mRemoteIdleTimeout > now) continue;
+
+        ZS_LOG_TRACE(log("expiring idle remote") + ZS_PARAM("bound ip", (*current).first.first.string()) + ZS_PARAM("remote ip", (*current).first.second.string()) + remote->mGathererInfo->toDebug())
+        removeRemote(current);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererUDPMux::removeRemote(RemoteMap::iterator found)
+    {
+      // warning: must be called from within the object lock
+
+      auto remote = (*found).second;
+      remote->mGathererInfo->mRemotes.erase((*found).first);
+      mRemotes.erase(found);
+    }
+
+    //-------------------------------------------------------------------------
+    ICEGathererUDPMux::SocketPtr ICEGathererUDPMux::createSocket(
+                                                                 const IPAddress &bindIP,
+                                                                 ShardPtr shard
+                                                                 )
+    {
+      auto createFamily = (bindIP.isIPv6() ? Socket::Create::IPv6 : Socket::Create::IPv4);
+
+      SocketPtr socket;
+
+      try {
+        socket = Socket::createUDP(createFamily);
+
+#ifdef SO_REUSEPORT
+        if (mShards.size() > 1) {
+          int enable = 1;
+          if (0 != setsockopt(socket->getSocket(), SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<const char *>(&enable), sizeof(enable))) {
+            ZS_LOG_ERROR(Detail, log("unable to enable SO_REUSEPORT") + ZS_PARAM("bind ip", bindIP.string()))
+            return SocketPtr();
+          }
+        }
+#endif //SO_REUSEPORT
+
+        socket->bind(bindIP);
+        socket->setBlocking(false);
+
+        try {
+#ifndef __QNX__
+          socket->setOptionFlag(Socket::SetOptionFlag::IgnoreSigPipe, true);
+#endif //ndef __QNX__
+        } catch(Socket::Exceptions::UnsupportedSocketOption &) {
+        }
+
+        socket->setDelegate(shard);
+      } catch(Socket::Exceptions::Unspecified &error) {
+        ZS_LOG_ERROR(Detail, log("bind error") + ZS_PARAM("bind ip", bindIP.string()) + ZS_PARAM("error", error.errorCode()))
+        return SocketPtr();
+      }
+
+      return socket;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererUDPMux::close(ListenerPtr listener)
+    {
+      for (auto iter = listener->mSockets.begin(); iter != listener->mSockets.end(); ++iter) {
+        auto socket = (*iter);
+
+        auto found = mSocketListeners.find(socket);
+        if (found != mSocketListeners.end()) mSocketListeners.erase(found);
+
+        try {
+          socket->close();
+        } catch(Socket::Exceptions::Unspecified &error) {
+          ZS_LOG_ERROR(Detail, log("failed to close udp socket") + ZS_PARAM("error", error.errorCode()))
+        }
+      }
+      listener->mSockets.clear();
+    }
+
+  }
+}
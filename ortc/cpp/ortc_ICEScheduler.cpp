@@ -0,0 +1,607 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#include <ortc/internal/ortc_ICEScheduler.h>
+#include <ortc/internal/ortc_ORTC.h>
+#include <ortc/internal/platform.h>
+
+#include <ortc/IHelper.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/Stringize.h>
+#include <zsLib/Log.h>
+#include <zsLib/XML.h>
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib_icetransport) }
+
+namespace ortc
+{
+  ZS_DECLARE_USING_PTR(zsLib, ISettings);
+
+  using zsLib::Log;
+
+  namespace internal
+  {
+    ZS_DECLARE_CLASS_PTR(ICESchedulerSettingsDefaults);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (helpers)
+    #pragma mark
+
+    static const QWORD kLevel0Size {static_cast<QWORD>(1) << ICEScheduler::kLevel0Bits};
+    static const QWORD kLevel0Mask {kLevel0Size - 1};
+    static const QWORD kLevelNSize {static_cast<QWORD>(1) << ICEScheduler::kLevelNBits};
+    static const QWORD kLevelNMask {kLevelNSize - 1};
+    static const QWORD kLevel1Span {static_cast<QWORD>(1) << (ICEScheduler::kLevel0Bits + ICEScheduler::kLevelNBits)};
+    static const QWORD kLevel2Span {static_cast<QWORD>(1) << (ICEScheduler::kLevel0Bits + (2 * ICEScheduler::kLevelNBits))};
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICESchedulerSettingsDefaults
+    #pragma mark
+
+    class ICESchedulerSettingsDefaults : public ISettingsApplyDefaultsDelegate
+    {
+    public:
+      //-----------------------------------------------------------------------
+      ~ICESchedulerSettingsDefaults()
+      {
+        ISettings::removeDefaults(*this);
+      }
+
+      //-----------------------------------------------------------------------
+      static ICESchedulerSettingsDefaultsPtr singleton()
+      {
+        static SingletonLazySharedPtr<ICESchedulerSettingsDefaults> singleton(create());
+        return singleton.singleton();
+      }
+
+      //-----------------------------------------------------------------------
+      static ICESchedulerSettingsDefaultsPtr create()
+      {
+        auto pThis(make_shared<ICESchedulerSettingsDefaults>());
+        ISettings::installDefaults(pThis);
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      virtual void notifySettingsApplyDefaults() override
+      {
+        ISettings::setUInt(ORTC_SETTING_ICE_SCHEDULER_TICK_IN_MILLISECONDS, 10);
+      }
+      
+    };
+
+    //-------------------------------------------------------------------------
+    void installICESchedulerSettingsDefaults()
+    {
+      ICESchedulerSettingsDefaults::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IICESchedulerForICETransport
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ICESchedulerTimerPtr IICESchedulerForICETransport::schedule(
+                                                                PUID ownerID,
+                                                                IICESchedulerDelegatePtr delegate,
+                                                                const Time &earliest,
+                                                                Milliseconds window
+                                                                )
+    {
+      return IICESchedulerFactory::singleton().schedule(ownerID, delegate, earliest, window);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICESchedulerTimer
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ICESchedulerTimer::ICESchedulerTimer(
+                                         ICESchedulerPtr scheduler,
+                                         PUID ownerID,
+                                         IICESchedulerDelegatePtr delegate
+                                         ) :
+      mScheduler(scheduler),
+      mOwnerID(ownerID),
+      mDelegate(delegate)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    void ICESchedulerTimer::cancel()
+    {
+      auto scheduler = mScheduler.lock();
+      if (!scheduler) return;
+
+      scheduler->cancel(*this);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEScheduler
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ICEScheduler::ICEScheduler(
+                               const make_private &,
+                               IMessageQueuePtr queue
+                               ) :
+      MessageQueueAssociator(queue),
+      SharedRecursiveLock(SharedRecursiveLock::create()),
+      mTickDuration(ISettings::getUInt(ORTC_SETTING_ICE_SCHEDULER_TICK_IN_MILLISECONDS)),
+      mStarted(zsLib::now())
+    {
+      if (mTickDuration < Milliseconds(1)) mTickDuration = Milliseconds(1);
+
+      ZS_LOG_DETAIL(debug("created"))
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEScheduler::init()
+    {
+      AutoRecursiveLock lock(*this);
+
+      mWheels[Wheel_Level0].resize(static_cast<size_t>(kLevel0Size));
+      mWheels[Wheel_Level1].resize(static_cast<size_t>(kLevelNSize));
+      mWheels[Wheel_Level2].resize(static_cast<size_t>(kLevelNSize));
+    }
+
+    //-------------------------------------------------------------------------
+    ICEScheduler::~ICEScheduler()
+    {
+      if (isNoop()) return;
+
+      ZS_LOG_DETAIL(log("destroyed"))
+      mThisWeak.reset();
+
+      cancel();
+    }
+
+    //-------------------------------------------------------------------------
+    ICESchedulerPtr ICEScheduler::create()
+    {
+      ICESchedulerPtr pThis(make_shared<ICEScheduler>(make_private {}, IORTCForInternal::queueORTC()));
+      pThis->mThisWeak = pThis;
+      pThis->init();
+      return pThis;
+    }
+
+    //-------------------------------------------------------------------------
+    ICESchedulerPtr ICEScheduler::singleton()
+    {
+      AutoRecursiveLock lock(*IHelper::getGlobalLock());
+      static SingletonLazySharedPtr<ICEScheduler> singleton(create());
+      ICESchedulerPtr result = singleton.singleton();
+
+      static zsLib::SingletonManager::Register registerSingleton("org.ortc.ICEScheduler", result);
+
+      if (!result) {
+        ZS_LOG_WARNING(Detail, slog("singleton gone"))
+      }
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEScheduler => IICESchedulerForICETransport
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ICESchedulerTimerPtr ICEScheduler::schedule(
+                                                PUID ownerID,
+                                                IICESchedulerDelegatePtr delegate,
+                                                const Time &earliest,
+                                                Milliseconds window
+                                                )
+    {
+      ORTC_THROW_INVALID_PARAMETERS_IF(!delegate)
+
+      auto pThis = singleton();
+      if (!pThis) return ICESchedulerTimerPtr();
+
+      AutoRecursiveLock lock(*pThis);
+
+      if (0 == pThis->mTotalScheduled) pThis->startTicking();
+
+      // +1 as the timer must never fire before the earliest time
+      QWORD earliestTick = pThis->toTick(earliest) + 1;
+      QWORD windowTicks = static_cast<QWORD>(window.count() / pThis->mTickDuration.count());
+
+      return pThis->scheduleAt(ownerID, IICESchedulerDelegateProxy::createWeak(delegate), pThis->pickTick(earliestTick, windowTicks));
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEScheduler => ITimerDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void ICEScheduler::onTimer(ITimerPtr timer)
+    {
+      ZS_LOG_INSANE(log("on timer") + ZS_PARAM("timer", timer->getID()))
+
+      FiredBatchMap fired;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (timer != mTickTimer) {
+          ZS_LOG_WARNING(Trace, log("notified about obsolete timer") + ZS_PARAM("timer", timer->getID()))
+          return;
+        }
+
+        QWORD targetTick = toTick(zsLib::now());
+        while ((mCurrentTick < targetTick) &&
+               (mTotalScheduled > 0)) {
+          advance(fired);
+        }
+
+        if (mTotalScheduled < 1) stopTicking();
+      }
+
+      for (auto iter = fired.begin(); iter != fired.end(); ++iter) {
+        auto &batch = (*iter).second;
+
+        try {
+          batch.mDelegate->onICESchedulerTimersFired(batch.mTimers);
+        } catch (const IICESchedulerDelegateProxy::Exceptions::DelegateGone &) {
+          ZS_LOG_TRACE(log("delegate gone") + ZS_PARAM("owner", (*iter).first))
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEScheduler => ISingletonManagerDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void ICEScheduler::notifySingletonCleanup()
+    {
+      cancel();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEScheduler => friend ICESchedulerTimer
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void ICEScheduler::cancel(ICESchedulerTimer &timer)
+    {
+      AutoRecursiveLock lock(*this);
+
+      timer.mDelegate.reset();
+
+      if (NULL == timer.mSlot) return;
+
+      auto slot = timer.mSlot;
+      timer.mSlot = NULL;
+      slot->erase(timer.mPosition);   // NOTE: may release the wheel's reference to the timer
+
+      ASSERT(mTotalScheduled > 0)
+      --mTotalScheduled;
+
+      if (mTotalScheduled < 1) stopTicking();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEScheduler => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    Log::Params ICEScheduler::log(const char *message) const
+    {
+      ElementPtr objectEl = Element::create("ortc::ICEScheduler");
+      IHelper::debugAppend(objectEl, "id", mID);
+      return Log::Params(message, objectEl);
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params ICEScheduler::slog(const char *message)
+    {
+      return Log::Params(message, "ortc::ICEScheduler");
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params ICEScheduler::debug(const char *message) const
+    {
+      return Log::Params(message, toDebug());
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr ICEScheduler::toDebug() const
+    {
+      AutoRecursiveLock lock(*this);
+
+      ElementPtr resultEl = Element::create("ortc::ICEScheduler");
+
+      IHelper::debugAppend(resultEl, "id", mID);
+
+      IHelper::debugAppend(resultEl, "tick duration", mTickDuration);
+      IHelper::debugAppend(resultEl, "started", mStarted);
+      IHelper::debugAppend(resultEl, "current tick", mCurrentTick);
+
+      IHelper::debugAppend(resultEl, "total scheduled", mTotalScheduled);
+      IHelper::debugAppend(resultEl, "tick timer", mTickTimer ? mTickTimer->getID() : 0);
+
+      IHelper::debugAppend(resultEl, "total fired", mTotalFired);
+      IHelper::debugAppend(resultEl, "total batches", mTotalBatches);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEScheduler::cancel()
+    {
+      AutoRecursiveLock lock(*this);
+
+      stopTicking();
+
+      for (size_t wheel = Wheel_First; wheel <= Wheel_Last; ++wheel) {
+        for (auto iter = mWheels[wheel].begin(); iter != mWheels[wheel].end(); ++iter) {
+          auto &slot = (*iter);
+          for (auto iterTimer = slot.begin(); iterTimer != slot.end(); ++iterTimer) {
+            auto timer = (*iterTimer);
+            timer->mSlot = NULL;
+            timer->mDelegate.reset();
+          }
+          slot.clear();
+        }
+      }
+
+      mTotalScheduled = 0;
+    }
+
+    //-------------------------------------------------------------------------
+    QWORD ICEScheduler::toTick(const Time &time) const
+    {
+      if (time <= mStarted) return 0;
+      return static_cast<QWORD>(zsLib::toMilliseconds(time - mStarted).count() / mTickDuration.count());
+    }
+
+    //-------------------------------------------------------------------------
+    ICESchedulerTimerPtr ICEScheduler::scheduleAt(
+                                                  PUID ownerID,
+                                                  IICESchedulerDelegatePtr delegate,
+                                                  QWORD expiryTick
+                                                  )
+    {
+      AutoRecursiveLock lock(*this);
+
+      auto timer = make_shared<ICESchedulerTimer>(mThisWeak.lock(), ownerID, delegate);
+
+      timer->mExpiryTick = expiryTick;
+      insert(timer);
+      ++mTotalScheduled;
+
+      return timer;
+    }
+
+    //-------------------------------------------------------------------------
+    QWORD ICEScheduler::pickTick(
+                                 QWORD earliestTick,
+                                 QWORD windowTicks
+                                 ) const
+    {
+      if (earliestTick <= mCurrentTick) earliestTick = mCurrentTick + 1;
+      if (0 == windowTicks) return earliestTick;
+
+      QWORD first = earliestTick + static_cast<QWORD>(IHelper::random(0, static_cast<size_t>(windowTicks)));
+      QWORD second = earliestTick + static_cast<QWORD>(IHelper::random(0, static_cast<size_t>(windowTicks)));
+
+      // the less loaded of two random ticks ("power of two choices") keeps
+      // the per tick bursts even without scanning the whole window
+      if ((first - mCurrentTick < kLevel0Size) &&
+          (second - mCurrentTick < kLevel0Size)) {
+        auto &level0 = mWheels[Wheel_Level0];
+        if (level0[second & kLevel0Mask].size() < level0[first & kLevel0Mask].size()) return second;
+      }
+
+      return first;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEScheduler::insert(ICESchedulerTimerPtr timer)
+    {
+      ASSERT(NULL == timer->mSlot)
+
+      QWORD expiry = timer->mExpiryTick;
+      if (expiry < mCurrentTick) expiry = mCurrentTick;
+
+      QWORD delta = expiry - mCurrentTick;
+
+      TimerList *slot = NULL;
+
+      if (delta < kLevel0Size) {
+        slot = &(mWheels[Wheel_Level0][static_cast<size_t>(expiry & kLevel0Mask)]);
+      } else if (delta < kLevel1Span) {
+        slot = &(mWheels[Wheel_Level1][static_cast<size_t>((expiry >> kLevel0Bits) & kLevelNMask)]);
+      } else {
+        if (delta >= kLevel2Span) expiry = mCurrentTick + kLevel2Span - 1;
+        slot = &(mWheels[Wheel_Level2][static_cast<size_t>((expiry >> (kLevel0Bits + kLevelNBits)) & kLevelNMask)]);
+      }
+
+      timer->mExpiryTick = expiry;
+      timer->mSlot = slot;
+      timer->mPosition = slot->insert(slot->end(), timer);
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEScheduler::cascade(
+                               Wheels wheel,
+                               size_t slot
+                               )
+    {
+      TimerList timers;
+      timers.swap(mWheels[wheel][slot]);
+
+      for (auto iter = timers.begin(); iter != timers.end(); ++iter) {
+        auto timer = (*iter);
+        timer->mSlot = NULL;
+        insert(timer);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEScheduler::advance(FiredBatchMap &ioFired)
+    {
+      ++mCurrentTick;
+
+      if (0 == (mCurrentTick & kLevel0Mask)) {
+        size_t level1Slot = static_cast<size_t>((mCurrentTick >> kLevel0Bits) & kLevelNMask);
+        if (0 == level1Slot) {
+          cascade(Wheel_Level2, static_cast<size_t>((mCurrentTick >> (kLevel0Bits + kLevelNBits)) & kLevelNMask));
+        }
+        cascade(Wheel_Level1, level1Slot);
+      }
+
+      auto &slot = mWheels[Wheel_Level0][static_cast<size_t>(mCurrentTick & kLevel0Mask)];
+
+      while (slot.size() > 0) {
+        auto timer = slot.front();
+        slot.pop_front();
+
+        timer->mSlot = NULL;
+        --mTotalScheduled;
+        ++mTotalFired;
+
+        if (!timer->mDelegate) continue;
+
+        auto &batch = ioFired[timer->mOwnerID];
+        if (!batch.mTimers) {
+          batch.mDelegate = timer->mDelegate;
+          batch.mTimers = make_shared<TimerIDList>();
+          ++mTotalBatches;
+        }
+        batch.mTimers->push_back(timer->getID());
+
+        timer->mDelegate.reset();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEScheduler::startTicking()
+    {
+      if (mTickTimer) return;
+
+      // the wheel is empty so it is safe to jump straight to the current tick
+      mCurrentTick = toTick(zsLib::now());
+      mTickTimer = ITimer::create(mThisWeak.lock(), mTickDuration);
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEScheduler::stopTicking()
+    {
+      if (!mTickTimer) return;
+
+      mTickTimer->cancel();
+      mTickTimer.reset();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IICESchedulerFactory
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    IICESchedulerFactory &IICESchedulerFactory::singleton()
+    {
+      return ICESchedulerFactory::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    ICESchedulerPtr IICESchedulerFactory::create()
+    {
+      if (this) {}
+      return internal::ICEScheduler::create();
+    }
+
+    //-------------------------------------------------------------------------
+    ICESchedulerTimerPtr IICESchedulerFactory::schedule(
+                                                        PUID ownerID,
+                                                        IICESchedulerDelegatePtr delegate,
+                                                        const Time &earliest,
+                                                        Milliseconds window
+                                                        )
+    {
+      if (this) {}
+      return internal::ICEScheduler::schedule(ownerID, delegate, earliest, window);
+    }
+
+  } // internal namespace
+}
@@ -35,6 +35,8 @@
 #include <ortc/internal/ortc_ICETransportController.h>
 #include <ortc/internal/ortc_Helper.h>
 #include <ortc/internal/ortc_ORTC.h>
+#include <ortc/internal/ortc_ReceiveLatency.h>
+#include <ortc/internal/ortc_StatsReport.h>
 #include <ortc/internal/ortc.events.h>
 #include <ortc/internal/platform.h>
 
@@ -70,6 +72,9 @@ namespace ortc
   namespace internal
   {
     ZS_DECLARE_CLASS_PTR(ICETransportSettingsDefaults);
+    ZS_DECLARE_TYPEDEF_PTR(IReceiveLatencyForInternal, UseReceiveLatency);
+
+    ZS_DECLARE_TYPEDEF_PTR(IStatsReportForInternal, UseStatsReport);
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -110,6 +115,40 @@ namespace ortc
       return diff > comparison;
     }
 
+    //-------------------------------------------------------------------------
+    static IStatsReportTypes::StatsICECandidatePairStates toStatsState(ICETransport::Route::States state)
+    {
+      switch (state) {
+        case ICETransport::Route::State_New:          return IStatsReportTypes::StatsICECandidatePairState_Waiting;
+        case ICETransport::Route::State_Pending:      return IStatsReportTypes::StatsICECandidatePairState_Waiting;
+        case ICETransport::Route::State_Frozen:       return IStatsReportTypes::StatsICECandidatePairState_Frozen;
+        case ICETransport::Route::State_InProgress:   return IStatsReportTypes::StatsICECandidatePairState_InProgress;
+        case ICETransport::Route::State_Succeeded:    return IStatsReportTypes::StatsICECandidatePairState_Succeeded;
+        case ICETransport::Route::State_Ignored:      return IStatsReportTypes::StatsICECandidatePairState_Cancelled;
+        case ICETransport::Route::State_Failed:       return IStatsReportTypes::StatsICECandidatePairState_Failed;
+        case ICETransport::Route::State_Blacklisted:  return IStatsReportTypes::StatsICECandidatePairState_Failed;
+      }
+      return IStatsReportTypes::StatsICECandidatePairState_Waiting;
+    }
+
+    //-------------------------------------------------------------------------
+    static IStatsReportTypes::ICECandidateAttributesPtr createCandidateStats(
+                                                                             IStatsReportTypes::StatsTypes statsType,
+                                                                             const String &statsID,
+                                                                             const IICETypes::Candidate &candidate
+                                                                             )
+    {
+      auto report = make_shared<IStatsReportTypes::ICECandidateAttributes>();
+      report->mStatsType = statsType;
+      report->mID = statsID;
+      report->mIPAddress = candidate.mIP;
+      report->mPortNumber = candidate.mPort;
+      report->mTransport = IICETypes::toString(candidate.mProtocol);
+      report->mCandidateType = candidate.mCandidateType;
+      report->mPriority = candidate.mPriority;
+      return report;
+    }
+
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -355,7 +394,7 @@ namespace ortc
       }
 
       PromiseWithStatsReportPtr promise = PromiseWithStatsReport::create(IORTCForInternal::queueDelegate());
-      IICETransportAsyncDelegateProxy::create(mThisWeak.lock())->onResolveStatsPromise(promise);
+      IICETransportAsyncDelegateProxy::create(mThisWeak.lock())->onResolveStatsPromise(promise, stats);
       return promise;
     }
 
@@ -581,6 +620,14 @@ namespace ortc
         }
       }
 
+      if ((isLocalICELite()) &&
+          (!mRemoteParameters.mICELite) &&
+          (IICETypes::Role_Controlled != mOptions.mRole)) {
+        ZS_LOG_DETAIL(log("ice lite must be controlled when remote party is a full ice agent"))
+        mOptions.mRole = IICETypes::Role_Controlled;
+        mOptionsHash = mOptions.hash();
+      }
+
       wakeUp();
     }
 
@@ -1040,6 +1087,8 @@ namespace ortc
           return;
         }
 
+        ++(route->mRequestsReceived);
+
         mLastReceivedPacket = zsLib::now();
 
         if (mBlacklistConsent) {
@@ -1051,6 +1100,7 @@ namespace ortc
 
               ZS_LOG_WARNING(Detail, log("returning unauthorized error to remote party (as route is blacklisted)") + routerRoute->toDebug() + response->toDebug())
               sendPacket(routerRoute, response);
+              ++(route->mResponsesSent);
 
               setBlacklisted(route);
               route->trace(__func__, "blacklist response to stun binding request");
@@ -1067,6 +1117,7 @@ namespace ortc
 
           ZS_LOG_WARNING(Debug, log("returning conflict error to remote party") + routerRoute->toDebug() + response->toDebug())
           sendPacket(routerRoute, response);
+          ++(route->mResponsesSent);
           route->trace(__func__, "blacklist response to stun binding request");
           response->trace(__func__);
           return;
@@ -1086,7 +1137,11 @@ namespace ortc
             (route->isPending()) ||
             (route->isFailed()) ||
             (route->isIgnored())) {
-          if (mRemoteParameters.mUsernameFragment.hasData()) {
+          if (isLocalICELite()) {
+            ZS_LOG_DETAIL(log("ice lite treats validated incoming request as candidate pair success") + route->toDebug())
+            route->trace(__func__, "ice lite success (due to incoming request)");
+            setSucceeded(route);
+          } else if (mRemoteParameters.mUsernameFragment.hasData()) {
             ZS_LOG_DETAIL(log("going to activate candidate pair because of incoming request") + route->toDebug())
             route->trace(__func__, "activate route (due to incoming request)");
             setInProgress(route);
@@ -1102,6 +1157,7 @@ namespace ortc
 
         ZS_LOG_TRACE(log("sending binding response to remote party") + route->toDebug() + response->toDebug())
         sendPacket(routerRoute, response);
+        ++(route->mResponsesSent);
 
         if (IICETypes::Role_Controlled == mOptions.mRole) {
           if (packet->mUseCandidateIncluded) {
@@ -1160,6 +1216,8 @@ namespace ortc
                                     size_t bufferSizeInBytes
                                     )
     {
+      UseReceiveLatency::stage(IReceiveLatencyTypes::Stage_ICETransport);
+
       ZS_EVENTING_4(
                     x, i, Trace, IceTransportReceivedPacketFromGatherer, ol, IceTransport, Receive,
                     puid, id, mID,
@@ -1541,6 +1599,40 @@ namespace ortc
       return gatherer->sendPacket(*this, routerRoute, buffer, bufferSizeInBytes);
     }
 
+    //-------------------------------------------------------------------------
+    bool ICETransport::sendPackets(const PacketBufferRefList &packets)
+    {
+      if (packets.size() < 1) return true;
+
+      UseICEGathererPtr gatherer;
+      RouterRoutePtr routerRoute;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (!installGathererRoute(mActiveRoute)) {
+          ZS_LOG_WARNING(Trace, log("cannot install a gatherer route") + (mActiveRoute ? mActiveRoute->toDebug() : ElementPtr()) + ZS_PARAM("packets", packets.size()))
+          return false;
+        }
+
+        gatherer = mGatherer;
+        routerRoute = mActiveRoute->mGathererRoute;
+      }
+
+      for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+        ZS_EVENTING_4(
+                      x, i, Trace, IceTransportForwardSecureTransportPacketToGatherer, ol, IceTransport, Send,
+                      puid, id, mID,
+                      puid, iceGathererId, gatherer->getID(),
+                      buffer, packet, (*iter).mBuffer,
+                      size, size, (*iter).mSize
+                      );
+      }
+
+      routerRoute->trace(__func__, "gatherer to use this route to send secure packets");
+      return gatherer->sendPackets(*this, routerRoute, packets);
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -1550,11 +1642,102 @@ namespace ortc
     #pragma mark
 
     //-------------------------------------------------------------------------
-    void ICETransport::onResolveStatsPromise(IStatsProvider::PromiseWithStatsReportPtr promise)
+    void ICETransport::onResolveStatsPromise(
+                                             IStatsProvider::PromiseWithStatsReportPtr promise,
+                                             IStatsReportTypes::StatsTypeSet stats
+                                             )
     {
-#define TODO_COMPLETE 1
-#define TODO_COMPLETE 2
-      promise->reject();
+      UseStatsReport::StatMap reportStats;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (isShutdown()) {
+          ZS_LOG_WARNING(Detail, log("requesting stats after shutdown"))
+          promise->reject();
+          return;
+        }
+
+        String transportID = string(mID);
+        String selectedPairID;
+
+        QWORD totalBytesSent {};
+        QWORD totalBytesReceived {};
+
+        for (auto iter = mLegalRoutes.begin(); iter != mLegalRoutes.end(); ++iter) {
+          auto route = (*iter).second;
+
+          auto &localCandidate = *(route->mCandidatePair->mLocal);
+          auto &remoteCandidate = *(route->mCandidatePair->mRemote);
+
+          String pairID = transportID + "_" + string(route->mID);
+          String localID = transportID + "_local_" + localCandidate.hash(false);
+          String remoteID = transportID + "_remote_" + remoteCandidate.hash(false);
+
+          totalBytesSent += route->bytesSent();
+          totalBytesReceived += route->bytesReceived();
+
+          if (route == mActiveRoute) selectedPairID = pairID;
+
+          if (stats.hasStatType(IStatsReportTypes::StatsType_CandidatePair)) {
+            auto report = make_shared<IStatsReportTypes::ICECandidatePairStats>();
+
+            auto lastConsent = getLatest(route->mLastReceivedResponse, route->mLastReceivedCheck);
+
+            report->mID = pairID;
+            report->mTransportID = transportID;
+            report->mLocalCandidateID = localID;
+            report->mRemoteCandidateID = remoteID;
+            report->mState = toStatsState(route->state());
+            report->mPriority = route->getPreference(IICETypes::Role_Controlling == mOptions.mRole);
+            report->mNominated = (route == mUseCandidateRoute) || (route == mActiveRoute);
+            report->mWritable = (Time() != route->mLastReceivedResponse);
+            report->mReadable = (Time() != route->mLastReceivedCheck) || (Time() != route->mLastReceivedMedia);
+            report->mBytesSent = route->bytesSent();
+            report->mBytesReceived = route->bytesReceived();
+            report->mPacketsSent = route->packetsSent();
+            report->mPacketsReceived = route->packetsReceived();
+            report->mRequestsSent = route->mRequestsSent;
+            report->mRequestsReceived = route->mRequestsReceived;
+            report->mResponsesSent = route->mResponsesSent;
+            report->mResponsesReceived = route->mResponsesReceived;
+            report->mConsentRequestsSent = route->mConsentRequestsSent;
+            report->mLastConsentTimestamp = lastConsent;
+            report->mRoundTripTime = static_cast<double>(route->mCurrentRoundTripTime.count()) / 1000000.0;
+
+            reportStats[report->mID] = report;
+          }
+
+          if (stats.hasStatType(IStatsReportTypes::StatsType_LocalCandidate)) {
+            if (reportStats.end() == reportStats.find(localID)) {
+              reportStats[localID] = createCandidateStats(IStatsReportTypes::StatsType_LocalCandidate, localID, localCandidate);
+            }
+          }
+          if (stats.hasStatType(IStatsReportTypes::StatsType_RemoteCandidate)) {
+            if (reportStats.end() == reportStats.find(remoteID)) {
+              reportStats[remoteID] = createCandidateStats(IStatsReportTypes::StatsType_RemoteCandidate, remoteID, remoteCandidate);
+            }
+          }
+        }
+
+        if (stats.hasStatType(IStatsReportTypes::StatsType_ICETransport)) {
+          auto report = make_shared<IStatsReportTypes::ICETransportStats>();
+
+          report->mID = transportID;
+          report->mBytesSent = totalBytesSent;
+          report->mBytesReceived = totalBytesReceived;
+          report->mActiveConnection = (bool)mActiveRoute;
+          report->mSelectedCandidatePairID = selectedPairID;
+
+          if (mRTCPTransport) {
+            report->mRTCPTransportStatsID = string(mRTCPTransport->getID());
+          }
+
+          reportStats[report->mID] = report;
+        }
+      }
+
+      promise->resolve(UseStatsReport::create(reportStats));
     }
 
     //-------------------------------------------------------------------------
@@ -1803,34 +1986,52 @@ namespace ortc
         return;
       }
 
-      // scope: check keep warm timers
-      {
-        auto found = mNextKeepWarmTimers.find(timer);
-        if (found == mNextKeepWarmTimers.end()) goto not_a_keep_warm_timer;
+      ZS_EVENTING_3(
+                    x, i, Trace, IceTransportInternalTimerEvent, ol, IceTransport, InternalEvent,
+                    puid, id, mID,
+                    puid, timerId, timer->getID(),
+                    string, timerType, "obsolete timer"
+                    );
+
+      ZS_LOG_WARNING(Trace, log("notified about an obsolete timer") + ZS_PARAM("timer id", timer->getID()));
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICETransport => IICESchedulerDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void ICETransport::onICESchedulerTimersFired(TimerIDListPtr timers)
+    {
+      ZS_LOG_TRACE(log("scheduler timers fired") + ZS_PARAM("total", timers->size()))
+
+      AutoRecursiveLock lock(*this);
+
+      // all keep warm checks that are due on the same scheduler tick are
+      // handled (and their STUN requests issued) together
+      for (auto iter = timers->begin(); iter != timers->end(); ++iter) {
+        auto timerID = (*iter);
+
+        auto found = mNextKeepWarmTimers.find(timerID);
+        if (found == mNextKeepWarmTimers.end()) {
+          ZS_LOG_TRACE(log("notified about an obsolete scheduler timer") + ZS_PARAM("timer id", timerID));
+          continue;
+        }
 
         ZS_EVENTING_3(
                       x, i, Trace, IceTransportInternalTimerEvent, ol, IceTransport, InternalEvent,
                       puid, id, mID,
-                      puid, timerId, timer->getID(),
+                      puid, timerId, timerID,
                       string, timerType, "next keep warm timer"
                       );
 
         RoutePtr route = (*found).second;
         mNextKeepWarmTimers.erase(found);
         handleNextKeepWarmTimer(route);
-        return;
-      }
-
-    not_a_keep_warm_timer:
-      {
-        ZS_EVENTING_3(
-                      x, i, Trace, IceTransportInternalTimerEvent, ol, IceTransport, InternalEvent,
-                      puid, id, mID,
-                      puid, timerId, timer->getID(),
-                      string, timerType, "obsolete timer"
-                      );
-
-        ZS_LOG_WARNING(Trace, log("notified about an obsolete timer") + ZS_PARAM("timer id", timer->getID()));
       }
     }
 
@@ -2151,6 +2352,9 @@ namespace ortc
 
           routerRoute = route->mGathererRoute;
           route->mLastSentCheck = zsLib::now();
+
+          ++(route->mRequestsSent);
+          if (route->isSucceeded()) ++(route->mConsentRequestsSent);
         }
       }
 
@@ -2226,6 +2430,8 @@ namespace ortc
 
       mLastReceivedPacket = zsLib::now();
 
+      ++(route->mResponsesReceived);
+
       if (STUNPacket::Class_ErrorResponse == response->mClass) {
         if (STUNPacket::ErrorCode_RoleConflict == response->mErrorCode) {
           // role conflict occured
@@ -2266,10 +2472,14 @@ namespace ortc
 
       if (route->mOutgoingCheck) {
         if (requester == route->mOutgoingCheck) {
+          // measured regardless of role (only the controlling side uses the
+          // measurement to pick routes)
+          route->mCurrentRoundTripTime = zsLib::toMicroseconds(getLatest(mLastReceivedPacket, route->mLastRoundTripCheck) - route->mLastRoundTripCheck);
+
           if (IICETypes::Role_Controlling == mOptions.mRole) {
             auto previousValue = route->mLastRoundTripMeasurement;
 
-            route->mLastRoundTripMeasurement = zsLib::toMicroseconds(getLatest(mLastReceivedPacket, route->mLastRoundTripCheck) - route->mLastRoundTripCheck);
+            route->mLastRoundTripMeasurement = route->mCurrentRoundTripTime;
             ZS_LOG_TRACE(log("updated route round trip time") + route->toDebug())
 
             if (Microseconds() != previousValue) {
@@ -2306,8 +2516,7 @@ namespace ortc
 
       if ((keptWarm) &&
           (!route->mNextKeepWarm)) {
-        route->mNextKeepWarm = ITimer::create(mThisWeak.lock(), zsLib::now() + mKeepWarmTimeBase + Milliseconds(IHelper::random(0, static_cast<size_t>(mKeepWarmTimeRandomizedAddTime.count()))));
-        mNextKeepWarmTimers[route->mNextKeepWarm] = route;
+        installKeepWarmTimer(route, mKeepWarmTimeBase);
 
         ZS_LOG_TRACE(log("installed keep warm timer") + route->toDebug())
       }
@@ -2498,6 +2707,13 @@ namespace ortc
       return false;
     }
 
+    //-------------------------------------------------------------------------
+    bool ICETransport::isLocalICELite() const
+    {
+      if (mGatherer) return mGatherer->isICELite();
+      return false;
+    }
+
     //-------------------------------------------------------------------------
     void ICETransport::step()
     {
@@ -2513,11 +2729,18 @@ namespace ortc
       ZS_EVENTING_1(x, i, Debug, IceTransportStep, ol, IceTransport, Step, puid, id, mID);
 
       if (!stepCalculateLegalPairs()) goto done;
-      if (!stepPendingActivation()) goto done;
-      if (!stepActivationTimer()) goto done;
-      if (!stepPickRoute()) goto done;
-      if (!stepDewarmRoutes()) goto done;
-      if (!stepKeepWarmRoutes()) goto done;
+      if (isLocalICELite()) {
+        // an ice lite agent never sends checks thus routes are only ever
+        // activated, chosen and kept warm by the remote party's requests
+        if (!stepICELite()) goto done;
+        if (!stepDewarmRoutes()) goto done;
+      } else {
+        if (!stepPendingActivation()) goto done;
+        if (!stepActivationTimer()) goto done;
+        if (!stepPickRoute()) goto done;
+        if (!stepDewarmRoutes()) goto done;
+        if (!stepKeepWarmRoutes()) goto done;
+      }
       if (!stepExpireRouteTimer()) goto done;
       if (!stepLastReceivedPacketTimer()) goto done;
 
@@ -2672,6 +2895,42 @@ namespace ortc
       return true;
     }
 
+    //-------------------------------------------------------------------------
+    bool ICETransport::stepICELite()
+    {
+      ZS_EVENTING_1(x, i, Debug, IceTransportStep, ol, IceTransport, Step, puid, id, mID);
+
+      if (mActivationTimer) {
+        ZS_LOG_DEBUG(log("ice lite does not need activation timer"))
+        mActivationTimer->cancel();
+        mActivationTimer.reset();
+      }
+
+      // scope: remove any outgoing activity left over from before the gatherer became lite
+      {
+        while (mPendingActivation.size() > 0) {
+          auto route = (*(mPendingActivation.begin())).second;
+          ZS_LOG_TRACE(log("ice lite will not activate route") + route->toDebug())
+          removePendingActivation(route);
+        }
+
+        while (mOutgoingChecks.size() > 0) {
+          auto route = (*(mOutgoingChecks.begin())).second;
+          ZS_LOG_TRACE(log("ice lite will not perform outgoing check") + route->toDebug())
+          mOutgoingChecks.erase(mOutgoingChecks.begin());
+          removeOutgoingCheck(route);
+        }
+
+        while (mNextKeepWarmTimers.size() > 0) {
+          auto route = (*(mNextKeepWarmTimers.begin())).second;
+          mNextKeepWarmTimers.erase(mNextKeepWarmTimers.begin());
+          removeKeepWarmTimer(route);
+        }
+      }
+
+      return true;
+    }
+
     //-------------------------------------------------------------------------
     bool ICETransport::stepPendingActivation()
     {
@@ -3023,8 +3282,7 @@ namespace ortc
 
           ZS_LOG_DEBUG(log("installing keep warm timer") + route->toDebug())
 
-          route->mNextKeepWarm = ITimer::create(mThisWeak.lock(), zsLib::now() + mKeepWarmTimeBase + Milliseconds(IHelper::random(0, static_cast<size_t>(mKeepWarmTimeRandomizedAddTime.count()))));
-          mNextKeepWarmTimers[route->mNextKeepWarm] = route;
+          installKeepWarmTimer(route, mKeepWarmTimeBase);
           continue;
         }
       do_not_keep_warm:
@@ -3142,6 +3400,34 @@ namespace ortc
         return true;
       }
 
+      if (isLocalICELite()) {
+        // ice lite never checks on its own thus the state only reflects what the remote party has validated
+        if (mActiveRoute) {
+          if (Time() != mLastReceivedUseCandidate) {
+            ZS_LOG_INSANE(debug("state is complete (ice lite, remote party nominated active route)"))
+            setState(IICETransport::State_Completed);
+            return true;
+          }
+          ZS_LOG_INSANE(debug("state is connected (ice lite, active route found)"))
+          setState(IICETransport::State_Connected);
+          return true;
+        }
+        if (mWarmRoutes.size() > 0) {
+          ZS_LOG_INSANE(debug("state is checking (ice lite, waiting for remote party to nominate a route)"))
+          setState(IICETransport::State_Checking);
+          return true;
+        }
+        if ((Time() != mLastReceivedPacket) &&
+            (mLastReceivedPacket + mExpireRouteTime < zsLib::now())) {
+          ZS_LOG_INSANE(debug("state is disconnected (ice lite, remote party stopped checking)"))
+          setState(IICETransport::State_Disconnected);
+          return true;
+        }
+        ZS_LOG_INSANE(debug("state is checking (ice lite, waiting for checks from remote party)"))
+        setState(IICETransport::State_Checking);
+        return true;
+      }
+
       bool pendingChecks = ((0 != mRouteStateTracker->count(Route::State_New)) ||
                             (0 != mRouteStateTracker->count(Route::State_Pending)) ||
                             (0 != mRouteStateTracker->count(Route::State_Frozen)) ||
@@ -3754,6 +4040,25 @@ namespace ortc
       ZS_LOG_INSANE(log("installed outgoing stun binding keep alive") + route->toDebug())
     }
 
+    //-----------------------------------------------------------------------
+    void ICETransport::installKeepWarmTimer(
+                                            RoutePtr route,
+                                            Milliseconds minimumDelay
+                                            )
+    {
+      ASSERT(!route->mNextKeepWarm)
+
+      // the scheduler picks a tick within the randomized window that spreads
+      // keep warm checks evenly (instead of a random time per route)
+      route->mNextKeepWarm = UseICEScheduler::schedule(mID, mThisWeak.lock(), zsLib::now() + minimumDelay, mKeepWarmTimeRandomizedAddTime);
+      if (!route->mNextKeepWarm) {
+        ZS_LOG_WARNING(Debug, log("ice scheduler is gone (thus cannot install keep warm timer)") + route->toDebug())
+        return;
+      }
+
+      mNextKeepWarmTimers[route->mNextKeepWarm->getID()] = route;
+    }
+
     //-----------------------------------------------------------------------
     void ICETransport::forceActive(RoutePtr route)
     {
@@ -3765,8 +4070,7 @@ namespace ortc
       route->trace(__func__, "forced active");
 
       // install a temporary keep warm timer (to force route activate sooner)
-      route->mNextKeepWarm = ITimer::create(mThisWeak.lock(), zsLib::now() + Milliseconds(IHelper::random(0, static_cast<size_t>(mKeepWarmTimeRandomizedAddTime.count()))));
-      mNextKeepWarmTimers[route->mNextKeepWarm] = route;
+      installKeepWarmTimer(route, Milliseconds());
 
       ZS_LOG_TRACE(log("forcing route to generate activity") + route->toDebug())
     }
@@ -4263,7 +4567,8 @@ namespace ortc
             } else {
               if (((Time() != route->mLastReceivedCheck) ||
                    (mRemoteParameters.mICELite)) &&
-                  (Time() != route->mLastReceivedResponse)) {
+                  ((Time() != route->mLastReceivedResponse) ||
+                   (isLocalICELite()))) {
                 ZS_LOG_DEBUG(log("route is now a success") + route->toDebug())
                 setSucceeded(route);
               }
@@ -4504,6 +4809,14 @@ namespace ortc
         mGatherer->removeRoute(route->mGathererRoute);
       }
 
+      // the router route can outlive this removal and be reinstalled later
+      // (on this or another route) so its counters are moved rather than
+      // copied to ensure they are only ever counted once
+      route->mPreviousPacketsSent += route->mGathererRoute->mPacketsSent.exchange(0);
+      route->mPreviousBytesSent += route->mGathererRoute->mBytesSent.exchange(0);
+      route->mPreviousPacketsReceived += route->mGathererRoute->mPacketsReceived.exchange(0);
+      route->mPreviousBytesReceived += route->mGathererRoute->mBytesReceived.exchange(0);
+
       route->trace(__func__, "removing fatherer route");
       route->mGathererRoute.reset();
     }
@@ -4513,7 +4826,7 @@ namespace ortc
     {
       if (!route->mNextKeepWarm) return;
 
-      auto found = mNextKeepWarmTimers.find(route->mNextKeepWarm);
+      auto found = mNextKeepWarmTimers.find(route->mNextKeepWarm->getID());
 
       if (found != mNextKeepWarmTimers.end()) {
         mNextKeepWarmTimers.erase(found);
@@ -5028,6 +5341,18 @@ namespace ortc
 
       IHelper::debugAppend(resultEl, "last round trip check", mLastRoundTripCheck);
       IHelper::debugAppend(resultEl, "last round trip measurement", mLastRoundTripMeasurement);
+      IHelper::debugAppend(resultEl, "current round trip time", mCurrentRoundTripTime);
+
+      IHelper::debugAppend(resultEl, "requests sent", mRequestsSent);
+      IHelper::debugAppend(resultEl, "requests received", mRequestsReceived);
+      IHelper::debugAppend(resultEl, "responses sent", mResponsesSent);
+      IHelper::debugAppend(resultEl, "responses received", mResponsesReceived);
+      IHelper::debugAppend(resultEl, "consent requests sent", mConsentRequestsSent);
+
+      IHelper::debugAppend(resultEl, "previous packets sent", mPreviousPacketsSent);
+      IHelper::debugAppend(resultEl, "previous bytes sent", mPreviousBytesSent);
+      IHelper::debugAppend(resultEl, "previous packets received", mPreviousPacketsReceived);
+      IHelper::debugAppend(resultEl, "previous bytes received", mPreviousBytesReceived);
 
       IHelper::debugAppend(resultEl, "frozen promise", (bool)mFrozenPromise);
       IHelper::debugAppend(resultEl, "dependent promises", mDependentPromises.size());
@@ -5082,6 +5407,30 @@ namespace ortc
       mTracker->inState(mState);
     }
 
+    //-------------------------------------------------------------------------
+    QWORD ICETransport::Route::packetsSent() const
+    {
+      return mPreviousPacketsSent + (mGathererRoute ? mGathererRoute->mPacketsSent.load() : 0);
+    }
+
+    //-------------------------------------------------------------------------
+    QWORD ICETransport::Route::bytesSent() const
+    {
+      return mPreviousBytesSent + (mGathererRoute ? mGathererRoute->mBytesSent.load() : 0);
+    }
+
+    //-------------------------------------------------------------------------
+    QWORD ICETransport::Route::packetsReceived() const
+    {
+      return mPreviousPacketsReceived + (mGathererRoute ? mGathererRoute->mPacketsReceived.load() : 0);
+    }
+
+    //-------------------------------------------------------------------------
+    QWORD ICETransport::Route::bytesReceived() const
+    {
+      return mPreviousBytesReceived + (mGathererRoute ? mGathererRoute->mBytesReceived.load() : 0);
+    }
+
     //-------------------------------------------------------------------------
     void ICETransport::Route::trace(const char *function, const char *message) const
     {
@@ -32,6 +32,8 @@
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc.events.h>
 #include <ortc/internal/ortc.stats.events.h>
+#include <ortc/internal/ortc_EventTrace.h>
+#include <ortc/internal/ortc_ReceiveLatency.h>
 #include <ortc/internal/ortc_RTPMediaEngine.h>
 
 #include <ortc/services/IHelper.h>
@@ -59,11 +61,16 @@ namespace ortc
     void installDataChannelSettingsDefaults();
     void installDTMFSenderSettingsDefaults();
     void installDTLSTransportSettingsDefaults();
+    void installEventTraceSettingsDefaults();
     void installICEGathererSettingsDefaults();
+    void installICEGathererUDPMuxSettingsDefaults();
+    void installICESchedulerSettingsDefaults();
     void installICETransportSettingsDefaults();
     void installIdentitySettingsDefaults();
     void installMediaDevicesSettingsDefaults();
     void installMediaStreamTrackSettingsDefaults();
+    void installReceiveLatencySettingsDefaults();
+    void installRTPForwarderSettingsDefaults();
     void installRTPListenerSettingsDefaults();
     void installRTPMediaEngineSettingsDefaults();
     void installRTPReceiverSettingsDefaults();
@@ -75,10 +82,12 @@ namespace ortc
     void installRTPSenderChannelAudioSettingsDefaults();
     void installRTPSenderChannelVideoSettingsDefaults();
     void installStatsReportSettingsDefaults();
+    void installStatsCountersSettingsDefaults();
     void installSCTPTransportSettingsDefaults();
     void installSCTPTransportListenerSettingsDefaults();
     void installSRTPTransportSettingsDefaults();
     void installSRTPSDESTransportSettingsDefaults();
+    void installSyntheticMediaSourceSettingsDefaults();
 
     //-------------------------------------------------------------------------
     static void installAllDefaults()
@@ -87,11 +96,16 @@ namespace ortc
       installDataChannelSettingsDefaults();
       installDTMFSenderSettingsDefaults();
       installDTLSTransportSettingsDefaults();
+      installEventTraceSettingsDefaults();
       installICEGathererSettingsDefaults();
+      installICEGathererUDPMuxSettingsDefaults();
+      installICESchedulerSettingsDefaults();
       installICETransportSettingsDefaults();
       installIdentitySettingsDefaults();
       installMediaDevicesSettingsDefaults();
       installMediaStreamTrackSettingsDefaults();
+      installReceiveLatencySettingsDefaults();
+      installRTPForwarderSettingsDefaults();
       installRTPListenerSettingsDefaults();
       installRTPMediaEngineSettingsDefaults();
       installRTPReceiverSettingsDefaults();
@@ -103,10 +117,12 @@ namespace ortc
       installRTPSenderChannelAudioSettingsDefaults();
       installRTPSenderChannelVideoSettingsDefaults();
       installStatsReportSettingsDefaults();
+      installStatsCountersSettingsDefaults();
       installSCTPTransportSettingsDefaults();
       installSCTPTransportListenerSettingsDefaults();
       installSRTPTransportSettingsDefaults();
       installSRTPSDESTransportSettingsDefaults();
+      installSyntheticMediaSourceSettingsDefaults();
     }
 
     //-------------------------------------------------------------------------
@@ -153,6 +169,12 @@ namespace ortc
       return (ORTC::singleton())->queueCertificateGeneration();
     }
 
+    //-------------------------------------------------------------------------
+    IMessageQueuePtr IORTCForInternal::queueDTLSHandshake()
+    {
+      return (ORTC::singleton())->queueDTLSHandshake();
+    }
+
     //-------------------------------------------------------------------------
     Optional<Log::Level> IORTCForInternal::webrtcLogLevel()
     {
@@ -265,6 +287,13 @@ namespace ortc
       UseServicesHelper::setup();
       installAllDefaults();
       ISettings::applyDefaults();
+
+      if (ISettings::getBool(ORTC_SETTING_EVENT_TRACE_AUTO_START)) {
+        IEventTraceForORTC::start();
+      }
+      if (ISettings::getBool(ORTC_SETTING_RECEIVE_LATENCY_ENABLED)) {
+        IReceiveLatency::enable();
+      }
     }
 
 #ifdef WINRT
@@ -274,6 +303,13 @@ namespace ortc
       UseServicesHelper::setup(dispatcher);
       installAllDefaults();
       ISettings::applyDefaults();
+
+      if (ISettings::getBool(ORTC_SETTING_EVENT_TRACE_AUTO_START)) {
+        IEventTraceForORTC::start();
+      }
+      if (ISettings::getBool(ORTC_SETTING_RECEIVE_LATENCY_ENABLED)) {
+        IReceiveLatency::enable();
+      }
     }
 #endif //WINRT
 
@@ -339,6 +375,30 @@ namespace ortc
       return IRTPMediaEngineForORTC::saveMediaTrace(host, port);
     }
 
+    //-------------------------------------------------------------------------
+    void ORTC::startEventTracing()
+    {
+      IEventTraceForORTC::start();
+    }
+
+    //-------------------------------------------------------------------------
+    void ORTC::stopEventTracing()
+    {
+      IEventTraceForORTC::stop();
+    }
+
+    //-------------------------------------------------------------------------
+    bool ORTC::isEventTracing()
+    {
+      return IEventTraceForORTC::isTracing();
+    }
+
+    //-------------------------------------------------------------------------
+    bool ORTC::saveEventTrace(String filename)
+    {
+      return IEventTraceForORTC::save(filename.c_str());
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -409,6 +469,21 @@ namespace ortc
       return mCertificateGeneration;
     }
 
+    //-------------------------------------------------------------------------
+    IMessageQueuePtr ORTC::queueDTLSHandshake() const
+    {
+      AutoRecursiveLock lock(*this);
+
+      size_t index = mNextDTLSHandshakeQueueThread % ORTC_QUEUE_TOTAL_DTLS_HANDSHAKE_THREADS;
+
+      if (!mDTLSHandshakeQueues[index]) {
+        mDTLSHandshakeQueues[index] = UseMessageQueueManager::getMessageQueue((String(ORTC_QUEUE_DTLS_HANDSHAKE_THREAD_NAME) + string(index)).c_str());
+      }
+
+      ++mNextDTLSHandshakeQueueThread;
+      return mDTLSHandshakeQueues[index];
+    }
+
     //-------------------------------------------------------------------------
     Optional<Log::Level> ORTC::webrtcLogLevel() const
     {
@@ -562,4 +637,36 @@ namespace ortc
     return singleton->saveMediaTrace(host, port);
   }
 
+  //-------------------------------------------------------------------------
+  void IORTC::startEventTracing()
+  {
+    auto singleton = internal::ORTC::singleton();
+    if (!singleton) return;
+    singleton->startEventTracing();
+  }
+
+  //-------------------------------------------------------------------------
+  void IORTC::stopEventTracing()
+  {
+    auto singleton = internal::ORTC::singleton();
+    if (!singleton) return;
+    singleton->stopEventTracing();
+  }
+
+  //-------------------------------------------------------------------------
+  bool IORTC::isEventTracing()
+  {
+    auto singleton = internal::ORTC::singleton();
+    if (!singleton) return false;
+    return singleton->isEventTracing();
+  }
+
+  //-------------------------------------------------------------------------
+  bool IORTC::saveEventTrace(String filename)
+  {
+    auto singleton = internal::ORTC::singleton();
+    if (!singleton) return false;
+    return singleton->saveEventTrace(filename);
+  }
+
 }
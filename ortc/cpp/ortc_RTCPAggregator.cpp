@@ -0,0 +1,417 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#include <ortc/internal/ortc_RTCPAggregator.h>
+#include <ortc/internal/platform.h>
+
+#include <ortc/IHelper.h>
+
+#include <zsLib/Stringize.h>
+#include <zsLib/Log.h>
+#include <zsLib/XML.h>
+
+#include <vector>
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib_rtp_rtcp_packet) }
+
+namespace ortc
+{
+  namespace internal
+  {
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (helpers)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    static bool isUrgent(const RTCPPacket &packet)
+    {
+      // feedback and session control must not wait for the next report
+      // interval (but any pending reports are piggybacked on them)
+      if (NULL != packet.firstTransportLayerFeedbackMessage()) return true;
+      if (NULL != packet.firstPayloadSpecificFeedbackMessage()) return true;
+      if (NULL != packet.firstBye()) return true;
+      if (NULL != packet.firstApp()) return true;
+      if (NULL != packet.firstUnknownReport()) return true;
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    static bool hasTimingReport(const RTCPPacket &packet)
+    {
+      // SR/RR carry NTP/LSR/DLSR values stamped when the packet was created;
+      // holding them back would inflate the remote party's RTT calculation
+      // (thus they are only held for the short timing report delay)
+      if (NULL != packet.firstSenderReport()) return true;
+      if (NULL != packet.firstReceiverReport()) return true;
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    static DWORD getSupersedeSSRC(const RTCPPacket &packet)
+    {
+      // a newer plain report from the same sender replaces a report that is
+      // still waiting in the queue
+      if (NULL != packet.firstXR()) return 0;
+
+      auto sr = packet.firstSenderReport();
+      auto rr = packet.firstReceiverReport();
+
+      if ((NULL != sr) && (NULL == rr)) {
+        if (NULL != sr->nextSenderReport()) return 0;
+        return sr->ssrcOfSender();
+      }
+      if ((NULL != rr) && (NULL == sr)) {
+        if (NULL != rr->nextReceiverReport()) return 0;
+        return rr->ssrcOfPacketSender();
+      }
+      return 0;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTCPAggregator::Settings
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTCPAggregator::Settings::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::RTCPAggregator::Settings");
+
+      IHelper::debugAppend(resultEl, "max packet size", mMaxPacketSize);
+      IHelper::debugAppend(resultEl, "max delay", mMaxDelay);
+      IHelper::debugAppend(resultEl, "max timing report delay", mMaxTimingReportDelay);
+      IHelper::debugAppend(resultEl, "max bandwidth delay", mMaxBandwidthDelay);
+      IHelper::debugAppend(resultEl, "bandwidth percentage", mBandwidthPercentage);
+      IHelper::debugAppend(resultEl, "min bandwidth bytes per second", mMinBandwidthBytesPerSecond);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTCPAggregator
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTCPAggregator::RTCPAggregator(
+                                   const make_private &,
+                                   const Settings &settings
+                                   ) :
+      mSettings(settings)
+    {
+      mCredit = static_cast<double>(mSettings.mMaxPacketSize);
+    }
+
+    //-------------------------------------------------------------------------
+    RTCPAggregatorPtr RTCPAggregator::create(const Settings &settings)
+    {
+      return make_shared<RTCPAggregator>(make_private{}, settings);
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTCPAggregator::queue(
+                               const BYTE *buffer,
+                               size_t bufferLengthInBytes,
+                               const Time &now,
+                               bool &outFlushNow
+                               )
+    {
+      outFlushNow = false;
+
+      if (bufferLengthInBytes >= mSettings.mMaxPacketSize) return false;
+
+      auto packet = RTCPPacket::create(buffer, bufferLengthInBytes);
+      if (!packet) return false;
+
+      auto queued = make_shared<QueuedPacket>();
+      queued->mPacket = packet;
+      queued->mQueued = now;
+      queued->mUrgent = isUrgent(*packet);
+      queued->mTimingReport = hasTimingReport(*packet);
+      if (!queued->mUrgent) queued->mSupersedeSSRC = getSupersedeSSRC(*packet);
+
+      if (0 != queued->mSupersedeSSRC) {
+        for (auto iter_doNotUse = mPending.begin(); iter_doNotUse != mPending.end(); ) {
+          auto current = iter_doNotUse;
+          ++iter_doNotUse;
+
+          if ((*current)->mSupersedeSSRC != queued->mSupersedeSSRC) continue;
+
+          // keep the original queue time so superseding cannot starve a stream
+          queued->mQueued = (*current)->mQueued;
+          mPending.erase(current);
+          ++mTotalSuperseded;
+        }
+      }
+
+      mPending.push_back(queued);
+      ++mTotalQueued;
+
+      outFlushNow = (queued->mUrgent) ||
+                    ((queued->mTimingReport) && (Milliseconds() == mSettings.mMaxTimingReportDelay)) ||
+                    (pendingSize() >= mSettings.mMaxPacketSize);
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTCPAggregator::notifyRTPSent(
+                                       size_t bufferLengthInBytes,
+                                       const Time &now
+                                       )
+    {
+      if (Time() == mLastRTPRateUpdate) mLastRTPRateUpdate = now;
+
+      mRTPBytesSinceUpdate += bufferLengthInBytes;
+
+      auto elapsed = zsLib::toMilliseconds(now - mLastRTPRateUpdate);
+      if (elapsed < Seconds(1)) return;
+
+      double measured = static_cast<double>(mRTPBytesSinceUpdate) * 1000.0 / static_cast<double>(elapsed.count());
+      mRTPBytesPerSecond = (0.0 == mRTPBytesPerSecond ? measured : (mRTPBytesPerSecond + measured) / 2.0);
+
+      mRTPBytesSinceUpdate = 0;
+      mLastRTPRateUpdate = now;
+    }
+
+    //-------------------------------------------------------------------------
+    Time RTCPAggregator::nextFlush(const Time &now) const
+    {
+      if (mPending.size() < 1) return Time();
+
+      Time oldest = mPending.front()->mQueued;
+      Time result = oldest + mSettings.mMaxDelay;
+
+      double credit = mCredit;
+      if ((Time() != mLastCreditUpdate) &&
+          (now > mLastCreditUpdate)) {
+        credit += allowedBytesPerSecond() * static_cast<double>(zsLib::toMilliseconds(now - mLastCreditUpdate).count()) / 1000.0;
+      }
+
+      double needed = static_cast<double>(pendingSize()) - credit;
+      if (needed > 0.0) {
+        // hold reports back until the RTCP share of the bandwidth allows them
+        auto wait = Milliseconds(static_cast<Milliseconds::rep>(needed * 1000.0 / allowedBytesPerSecond()));
+        Time limit = oldest + mSettings.mMaxBandwidthDelay;
+        Time delayed = (now + wait < limit ? now + wait : limit);
+        if (delayed > result) result = delayed;
+      }
+
+      // neither the normal nor the bandwidth delay may hold a SR/RR longer
+      // than the timing report delay
+      for (auto iter = mPending.begin(); iter != mPending.end(); ++iter) {
+        auto &queued = (*iter);
+        if (!queued->mTimingReport) continue;
+
+        Time limit = queued->mQueued + mSettings.mMaxTimingReportDelay;
+        if (limit < result) result = limit;
+      }
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTCPAggregator::flush(
+                               const Time &now,
+                               BufferList &outBuffers
+                               )
+    {
+      updateCredit(now);
+
+      QueuedPacketList group;
+      size_t groupSize = 0;
+
+      while (mPending.size() > 0) {
+        auto queued = mPending.front();
+        mPending.pop_front();
+
+        size_t size = queued->mPacket->size();
+
+        if ((group.size() > 0) &&
+            (groupSize + size > mSettings.mMaxPacketSize)) {
+          outBuffers.push_back(buildCompoundPacket(group));
+          mCredit -= static_cast<double>(groupSize);
+          group.clear();
+          groupSize = 0;
+        }
+
+        group.push_back(queued);
+        groupSize += size;
+      }
+
+      if (group.size() > 0) {
+        outBuffers.push_back(buildCompoundPacket(group));
+        mCredit -= static_cast<double>(groupSize);
+      }
+
+      mTotalSent += outBuffers.size();
+    }
+
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr RTCPAggregator::buildCompoundPacket(const QueuedPacketList &packets)
+    {
+      ASSERT(packets.size() > 0)
+
+      if (1 == packets.size()) return packets.front()->mPacket->buffer();
+
+      typedef RTCPPacket::Report Report;
+      typedef std::vector<Report *> ReportVector;
+
+      enum Orders
+      {
+        Order_First,
+
+        Order_SenderReport = Order_First,
+        Order_ReceiverReport,
+        Order_SDES,
+        Order_Other,
+        Order_Bye,
+
+        Order_Last = Order_Bye,
+      };
+
+      ReportVector ordered[Order_Last + 1];
+
+      for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+        auto &packet = (*iter)->mPacket;
+        for (Report *report = packet->first(); NULL != report; report = report->next()) {
+          switch (report->pt()) {
+            case RTCPPacket::SenderReport::kPayloadType:    ordered[Order_SenderReport].push_back(report); break;
+            case RTCPPacket::ReceiverReport::kPayloadType:  ordered[Order_ReceiverReport].push_back(report); break;
+            case RTCPPacket::SDES::kPayloadType:            ordered[Order_SDES].push_back(report); break;
+            case RTCPPacket::Bye::kPayloadType:             ordered[Order_Bye].push_back(report); break;
+            default:                                        ordered[Order_Other].push_back(report); break;
+          }
+        }
+      }
+
+      // NOTE: the reports are re-linked in place; the queued packets are owned
+      // exclusively by the aggregator and are discarded after serialization.
+      Report *first = NULL;
+      Report *last = NULL;
+
+      for (size_t loop = Order_First; loop <= Order_Last; ++loop) {
+        for (auto iter = ordered[loop].begin(); iter != ordered[loop].end(); ++iter) {
+          Report *report = (*iter);
+          if (NULL == first) first = report;
+          if (NULL != last) last->mNext = report;
+          last = report;
+        }
+      }
+
+      if (NULL != last) last->mNext = NULL;
+
+      return RTCPPacket::generateFrom(first);
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTCPAggregator::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::RTCPAggregator");
+
+      IHelper::debugAppend(resultEl, "settings", mSettings.toDebug());
+
+      IHelper::debugAppend(resultEl, "pending", mPending.size());
+      IHelper::debugAppend(resultEl, "pending size", pendingSize());
+
+      IHelper::debugAppend(resultEl, "rtp bytes per second", mRTPBytesPerSecond);
+      IHelper::debugAppend(resultEl, "credit", mCredit);
+
+      IHelper::debugAppend(resultEl, "total queued", mTotalQueued);
+      IHelper::debugAppend(resultEl, "total superseded", mTotalSuperseded);
+      IHelper::debugAppend(resultEl, "total sent", mTotalSent);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTCPAggregator => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTCPAggregator::updateCredit(const Time &now)
+    {
+      if (Time() == mLastCreditUpdate) {
+        mLastCreditUpdate = now;
+        return;
+      }
+
+      auto elapsed = zsLib::toMilliseconds(now - mLastCreditUpdate);
+      if (elapsed < Milliseconds(1)) return;
+
+      mCredit += allowedBytesPerSecond() * static_cast<double>(elapsed.count()) / 1000.0;
+
+      // allow a small burst but never bank an unbounded amount of credit
+      double maxCredit = static_cast<double>(mSettings.mMaxPacketSize * 4);
+      if (mCredit > maxCredit) mCredit = maxCredit;
+
+      mLastCreditUpdate = now;
+    }
+
+    //-------------------------------------------------------------------------
+    double RTCPAggregator::allowedBytesPerSecond() const
+    {
+      double result = mRTPBytesPerSecond * static_cast<double>(mSettings.mBandwidthPercentage) / 100.0;
+      double minimum = static_cast<double>(mSettings.mMinBandwidthBytesPerSecond);
+      return (result > minimum ? result : minimum);
+    }
+
+    //-------------------------------------------------------------------------
+    size_t RTCPAggregator::pendingSize() const
+    {
+      size_t result = 0;
+      for (auto iter = mPending.begin(); iter != mPending.end(); ++iter) {
+        result += (*iter)->mPacket->size();
+      }
+      return result;
+    }
+
+  }
+}
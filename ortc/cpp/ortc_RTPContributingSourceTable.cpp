@@ -0,0 +1,263 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#include <ortc/internal/ortc_RTPContributingSourceTable.h>
+#include <ortc/internal/platform.h>
+
+#include <ortc/IHelper.h>
+
+#include <zsLib/Stringize.h>
+#include <zsLib/Log.h>
+#include <zsLib/XML.h>
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib_rtpreceiver) }
+
+namespace ortc
+{
+  namespace internal
+  {
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (helpers)
+    #pragma mark
+
+    // packed entry state layout:
+    //   bits 0..7   - audio level
+    //   bit 8       - voice activity flag is present
+    //   bit 9       - voice activity flag value
+    //   bit 10      - always set (so an active state is never 0)
+    //   bits 16..63 - timestamp in milliseconds since epoch
+    static const QWORD kStateVoiceActivityPresent {0x100};
+    static const QWORD kStateVoiceActivity {0x200};
+    static const QWORD kStateActive {0x400};
+    static const size_t kStateTimestampShift {16};
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPContributingSourceTable
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTPContributingSourceTable::RTPContributingSourceTable()
+    {
+      static_assert(0 == (kCapacity & (kCapacity - 1)), "capacity must be a power of 2");
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPContributingSourceTable::update(
+                                            SSRCType csrc,
+                                            const Time &now,
+                                            BYTE level,
+                                            const Optional<bool> &voiceActivityFlag
+                                            )
+    {
+      QWORD state = pack(now, level, voiceActivityFlag);
+
+      size_t start = hashIndex(csrc);
+      Entry *reuse = NULL;
+
+      for (size_t probe = 0; probe < kCapacity; ++probe) {
+        auto &entry = mEntries[(start + probe) & (kCapacity - 1)];
+
+        if (!entry.mUsed) {
+          if (NULL == reuse) reuse = &entry;
+          break;
+        }
+
+        if (csrc == entry.mCSRC.load(std::memory_order_relaxed)) {
+          bool added = (0 == entry.mState.load(std::memory_order_relaxed));
+          entry.mState.store(state);
+          if (added) ++mActive;
+          return added;
+        }
+
+        if ((NULL == reuse) &&
+            (0 == entry.mState.load(std::memory_order_relaxed))) {
+          reuse = &entry;
+        }
+      }
+
+      bool evicted = false;
+
+      if (NULL == reuse) {
+        // every entry is active; the least recently updated source makes room
+        for (size_t index = 0; index < kCapacity; ++index) {
+          auto &entry = mEntries[index];
+          if ((NULL == reuse) ||
+              ((entry.mState.load(std::memory_order_relaxed) >> kStateTimestampShift) < (reuse->mState.load(std::memory_order_relaxed) >> kStateTimestampShift))) {
+            reuse = &entry;
+          }
+        }
+        evicted = true;
+        ++mTotalEvicted;
+      }
+
+      // re-keying an entry happens inside an odd generation so readers can
+      // never pair the new csrc with the previous owner's state
+      ++(reuse->mGeneration);
+      reuse->mState.store(0);
+      reuse->mCSRC.store(csrc);
+      reuse->mState.store(state);
+      ++(reuse->mGeneration);
+
+      reuse->mUsed = true;
+      if (!evicted) ++mActive;
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPContributingSourceTable::expire(
+                                            const Time &olderThan,
+                                            ContributingSourceList &outExpired
+                                            )
+    {
+      for (size_t index = 0; index < kCapacity; ++index) {
+        auto &entry = mEntries[index];
+
+        QWORD state = entry.mState.load(std::memory_order_relaxed);
+        if (0 == state) continue;
+
+        ContributingSource source;
+        source.mCSRC = entry.mCSRC.load(std::memory_order_relaxed);
+        unpack(state, source);
+
+        if (source.mTimestamp >= olderThan) continue;
+
+        entry.mState.store(0);
+        --mActive;
+
+        outExpired.push_back(source);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPContributingSourceTable::clear()
+    {
+      for (size_t index = 0; index < kCapacity; ++index) {
+        auto &entry = mEntries[index];
+        if (!entry.mUsed) continue;
+
+        ++(entry.mGeneration);
+        entry.mState.store(0);
+        entry.mCSRC.store(0);
+        ++(entry.mGeneration);
+
+        entry.mUsed = false;
+      }
+      mActive = 0;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPContributingSourceTable::getSources(ContributingSourceList &outSources) const
+    {
+      for (size_t index = 0; index < kCapacity; ++index) {
+        auto &entry = mEntries[index];
+
+        DWORD generation = entry.mGeneration.load();
+        if (0 != (generation & 1)) continue;      // being re-keyed right now
+
+        QWORD state = entry.mState.load();
+        if (0 == state) continue;
+
+        ContributingSource source;
+        source.mCSRC = entry.mCSRC.load();
+
+        if (generation != entry.mGeneration.load()) continue;
+
+        unpack(state, source);
+        outSources.push_back(source);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPContributingSourceTable::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::RTPContributingSourceTable");
+
+      IHelper::debugAppend(resultEl, "capacity", kCapacity);
+      IHelper::debugAppend(resultEl, "active", mActive.load());
+      IHelper::debugAppend(resultEl, "total evicted", mTotalEvicted);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t RTPContributingSourceTable::hashIndex(SSRCType csrc)
+    {
+      // Fibonacci hashing spreads sequentially allocated csrcs across the table
+      return static_cast<size_t>((static_cast<DWORD>(csrc) * 2654435761UL) >> 16) & (kCapacity - 1);
+    }
+
+    //-------------------------------------------------------------------------
+    QWORD RTPContributingSourceTable::pack(
+                                           const Time &timestamp,
+                                           BYTE level,
+                                           const Optional<bool> &voiceActivityFlag
+                                           )
+    {
+      QWORD milliseconds = static_cast<QWORD>(zsLib::toMilliseconds(timestamp.time_since_epoch()).count());
+
+      QWORD result = (milliseconds << kStateTimestampShift) | kStateActive | static_cast<QWORD>(level);
+      if (voiceActivityFlag.hasValue()) {
+        result |= kStateVoiceActivityPresent;
+        if (voiceActivityFlag.value()) result |= kStateVoiceActivity;
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPContributingSourceTable::unpack(
+                                            QWORD state,
+                                            ContributingSource &outSource
+                                            )
+    {
+      outSource.mTimestamp = Time() + Milliseconds(static_cast<Milliseconds::rep>(state >> kStateTimestampShift));
+      outSource.mAudioLevel = static_cast<BYTE>(state & 0xFF);
+      outSource.mVoiceActivityFlag = Optional<bool>();
+      if (0 != (state & kStateVoiceActivityPresent)) {
+        outSource.mVoiceActivityFlag = (0 != (state & kStateVoiceActivity));
+      }
+    }
+
+  }
+}
@@ -0,0 +1,987 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include <ortc/internal/ortc_RTPForwarder.h>
+#include <ortc/internal/ortc_RTPReceiver.h>
+#include <ortc/internal/ortc_RTPSender.h>
+#include <ortc/internal/ortc_RTPPacket.h>
+#include <ortc/internal/ortc_RTCPPacket.h>
+#include <ortc/internal/ortc_ORTC.h>
+#include <ortc/internal/platform.h>
+
+#include <ortc/IHelper.h>
+
+#include <zsLib/eventing/IHasher.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/Stringize.h>
+#include <zsLib/Log.h>
+#include <zsLib/XML.h>
+
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib_rtpsender) }
+
+namespace ortc
+{
+  ZS_DECLARE_USING_PTR(zsLib, ISettings);
+  ZS_DECLARE_USING_PTR(zsLib::eventing, IHasher);
+
+  namespace internal
+  {
+    ZS_DECLARE_CLASS_PTR(RTPForwarderSettingsDefaults);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPForwarderSettingsDefaults
+    #pragma mark
+
+    class RTPForwarderSettingsDefaults : public ISettingsApplyDefaultsDelegate
+    {
+    public:
+      //-----------------------------------------------------------------------
+      ~RTPForwarderSettingsDefaults()
+      {
+        ISettings::removeDefaults(*this);
+      }
+
+      //-----------------------------------------------------------------------
+      static RTPForwarderSettingsDefaultsPtr singleton()
+      {
+        static SingletonLazySharedPtr<RTPForwarderSettingsDefaults> singleton(create());
+        return singleton.singleton();
+      }
+
+      //-----------------------------------------------------------------------
+      static RTPForwarderSettingsDefaultsPtr create()
+      {
+        auto pThis(make_shared<RTPForwarderSettingsDefaults>());
+        ISettings::installDefaults(pThis);
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      virtual void notifySettingsApplyDefaults() override
+      {
+        ISettings::setUInt(ORTC_SETTING_RTP_FORWARDER_SWITCH_SOURCE_AFTER_IDLE_IN_MILLISECONDS, 1000);
+      }
+      
+    };
+
+    //-------------------------------------------------------------------------
+    void installRTPForwarderSettingsDefaults()
+    {
+      RTPForwarderSettingsDefaults::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPForwarderForRTPReceiver
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr IRTPForwarderForRTPReceiver::toDebug(ForRTPReceiverPtr forwarder)
+    {
+      if (!forwarder) return ElementPtr();
+      return ZS_DYNAMIC_PTR_CAST(RTPForwarder, forwarder)->toDebug();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPForwarderForRTPSender
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr IRTPForwarderForRTPSender::toDebug(ForRTPSenderPtr forwarder)
+    {
+      if (!forwarder) return ElementPtr();
+      return ZS_DYNAMIC_PTR_CAST(RTPForwarder, forwarder)->toDebug();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPForwarder
+    #pragma mark
+    
+    //-------------------------------------------------------------------------
+    RTPForwarder::RTPForwarder(
+                               const make_private &,
+                               IMessageQueuePtr queue,
+                               IRTPReceiverPtr receiver,
+                               IRTPSenderPtr sender,
+                               const Options &options
+                               ) :
+      MessageQueueAssociator(queue),
+      SharedRecursiveLock(SharedRecursiveLock::create()),
+      mRTPReceiver(RTPReceiver::convert(receiver)),
+      mRTPSender(RTPSender::convert(sender)),
+      mOptions(options),
+      mSwitchSourceAfterIdle(ISettings::getUInt(ORTC_SETTING_RTP_FORWARDER_SWITCH_SOURCE_AFTER_IDLE_IN_MILLISECONDS))
+    {
+      ZS_LOG_DETAIL(debug("created"))
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPForwarder::init()
+    {
+      AutoRecursiveLock lock(*this);
+      IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+    }
+
+    //-------------------------------------------------------------------------
+    RTPForwarder::~RTPForwarder()
+    {
+      if (isNoop()) return;
+
+      ZS_LOG_DETAIL(log("destroyed"))
+      mThisWeak.reset();
+
+      cancel();
+    }
+
+    //-------------------------------------------------------------------------
+    RTPForwarderPtr RTPForwarder::convert(IRTPForwarderPtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(RTPForwarder, object);
+    }
+
+    //-------------------------------------------------------------------------
+    RTPForwarderPtr RTPForwarder::convert(ForRTPReceiverPtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(RTPForwarder, object);
+    }
+
+    //-------------------------------------------------------------------------
+    RTPForwarderPtr RTPForwarder::convert(ForRTPSenderPtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(RTPForwarder, object);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPForwarder => IRTPForwarder
+    #pragma mark
+    
+    //-------------------------------------------------------------------------
+    ElementPtr RTPForwarder::toDebug(RTPForwarderPtr forwarder)
+    {
+      if (!forwarder) return ElementPtr();
+      return forwarder->toDebug();
+    }
+
+    //-------------------------------------------------------------------------
+    RTPForwarderPtr RTPForwarder::create(
+                                         IRTPReceiverPtr receiver,
+                                         IRTPSenderPtr sender,
+                                         const Options &options
+                                         )
+    {
+      ORTC_THROW_INVALID_PARAMETERS_IF(!receiver)
+      ORTC_THROW_INVALID_PARAMETERS_IF(!sender)
+
+      RTPForwarderPtr pThis(make_shared<RTPForwarder>(make_private {}, IORTCForInternal::queueORTC(), receiver, sender, options));
+      pThis->mThisWeak = pThis;
+      pThis->init();
+      return pThis;
+    }
+
+    //-------------------------------------------------------------------------
+    IRTPReceiverPtr RTPForwarder::receiver() const
+    {
+      return RTPReceiver::convert(mRTPReceiver.lock());
+    }
+
+    //-------------------------------------------------------------------------
+    IRTPSenderPtr RTPForwarder::sender() const
+    {
+      return RTPSender::convert(mRTPSender.lock());
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPForwarder::update(const Options &options)
+    {
+      ZS_LOG_DEBUG(log("update called") + options.toDebug())
+
+      AutoRecursiveLock lock(*this);
+
+      if (isShutdown()) {
+        ZS_LOG_WARNING(Debug, log("cannot update options while shutdown"))
+        return;
+      }
+
+      bool exclusiveChanged = (options.mExclusive != mOptions.mExclusive);
+
+      mOptions = options;
+
+      if ((exclusiveChanged) &&
+          (mRegistered)) {
+        auto receiver = mRTPReceiver.lock();
+        if (receiver) receiver->registerForwarder(mThisWeak.lock(), mOptions.mExclusive);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPForwarder::stop()
+    {
+      ZS_LOG_DEBUG(log("stop called"))
+
+      AutoRecursiveLock lock(*this);
+      cancel();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPForwarder => IRTPForwarderForRTPReceiver
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    bool RTPForwarder::forwardPacket(RTPPacketPtr packet)
+    {
+      UseRTPSenderPtr sender;
+      RTPPacketPtr outPacket;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (isShutdown()) return false;
+
+        if ((!mReceiverParameters) ||
+            (!mSenderParameters)) {
+          ZS_LOG_INSANE(log("parameters are not ready (thus discarding packet)"))
+          ++mTotalPacketsDropped;
+          return false;
+        }
+
+        auto ssrc = packet->ssrc();
+
+        if (mOptions.mSourceSSRC.hasValue()) {
+          if (ssrc != mOptions.mSourceSSRC.value()) return false;
+        }
+
+        auto foundPayloadType = mPayloadTypes.find(packet->pt());
+        if (foundPayloadType == mPayloadTypes.end()) {
+          // RTX, FEC and codecs the sender cannot carry are never forwarded
+          ZS_LOG_INSANE(log("payload type is not mapped (thus discarding packet)") + ZS_PARAM("pt", packet->pt()))
+          ++mTotalPacketsDropped;
+          return false;
+        }
+
+        Time tick = zsLib::now();
+
+        if ((!mActiveSourceSSRC.hasValue()) ||
+            (ssrc != mActiveSourceSSRC.value())) {
+          if ((mActiveSourceSSRC.hasValue()) &&
+              (!mOptions.mSourceSSRC.hasValue())) {
+            if (tick < mLastSourcePacketTime + mSwitchSourceAfterIdle) {
+              ZS_LOG_INSANE(log("current source is still active (thus discarding packet)") + ZS_PARAM("ssrc", ssrc) + ZS_PARAM("active ssrc", mActiveSourceSSRC.value()))
+              ++mTotalPacketsDropped;
+              return false;
+            }
+          }
+
+          auto foundClockRate = mClockRates.find(packet->pt());
+          switchSource(*packet, foundClockRate != mClockRates.end() ? (*foundClockRate).second : 90000, tick);
+        }
+
+        mLastSourcePacketTime = tick;
+
+        WORD sequenceNumber = static_cast<WORD>(packet->sequenceNumber() + mSequenceNumberOffset);
+        DWORD timestamp = packet->timestamp() + mTimestampOffset;
+
+        if ((!mHasOutput) ||
+            (static_cast<int16_t>(sequenceNumber - mLastOutputSequenceNumber) > 0)) {
+          mHasOutput = true;
+          mLastOutputSequenceNumber = sequenceNumber;
+          mLastOutputTimestamp = timestamp;
+          mLastOutputTime = tick;
+        }
+
+        DWORD csrcs[0xF] {};
+
+        RTPPacket::CreationParams params;
+        params.mVersion = packet->version();
+        params.mPadding = packet->padding();
+        params.mM = packet->m();
+        params.mPT = (*foundPayloadType).second;
+        params.mSequenceNumber = sequenceNumber;
+        params.mTimestamp = timestamp;
+        params.mSSRC = outputSSRC();
+
+        params.mCC = packet->cc();
+        if (0 != params.mCC) {
+          for (size_t index = 0; index < params.mCC; ++index) {
+            csrcs[index] = packet->getCSRC(index);
+          }
+          params.mCSRCList = &(csrcs[0]);
+        }
+
+        params.mPayloadSize = packet->payloadSize();
+        params.mPayload = (0 != params.mPayloadSize ? packet->payload() : NULL);
+
+        std::vector<RTPPacket::HeaderExtension> extensions;
+
+        for (auto extension = packet->firstHeaderExtension(); NULL != extension; extension = extension->mNext) {
+          auto foundID = mHeaderExtensionIDs.find(extension->mID);
+          if (foundID == mHeaderExtensionIDs.end()) continue;  // the remote receiver did not negotiate this extension
+
+          RTPPacket::HeaderExtension remapped;
+          remapped.mID = (*foundID).second;
+          remapped.mData = extension->mData;
+          remapped.mDataSizeInBytes = extension->mDataSizeInBytes;
+          extensions.push_back(remapped);
+        }
+
+        if (extensions.size() > 0) {
+          for (size_t index = 1; index < extensions.size(); ++index) {
+            extensions[index-1].mNext = &(extensions[index]);
+          }
+          params.mFirstHeaderExtension = &(extensions[0]);
+          params.mHeaderExtensionAppBits = packet->headerExtensionAppBits();
+        }
+
+        outPacket = RTPPacket::create(params);
+
+        ++mTotalPacketsForwarded;
+
+        sender = mRTPSender.lock();
+      }
+
+      if (!sender) {
+        ZS_LOG_WARNING(Trace, log("sender is gone (thus discarding packet)"))
+        return false;
+      }
+
+      ZS_LOG_INSANE(log("forwarding rtp packet") + ZS_PARAM("ssrc", outPacket->ssrc()) + ZS_PARAM("pt", outPacket->pt()) + ZS_PARAM("seq", outPacket->sequenceNumber()))
+
+      return sender->sendForwardedPacket(outPacket);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPForwarder::forwardPacket(RTCPPacketPtr packet)
+    {
+      typedef RTCPPacket::SenderReport SenderReport;
+
+      if (NULL == packet->firstSenderReport()) return;
+
+      UseRTPSenderPtr sender;
+      RTCPPacketPtr outPacket;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (isShutdown()) return;
+        if (!mActiveSourceSSRC.hasValue()) return;
+
+        for (auto report = packet->firstSenderReport(); NULL != report; report = report->nextSenderReport()) {
+          if (report->ssrcOfSender() != mActiveSourceSSRC.value()) continue;
+
+          // report blocks describe what the source received, which means
+          // nothing to the remote party of the sender
+          SenderReport sr;
+          sr.mVersion = report->version();
+          sr.mPT = SenderReport::kPayloadType;
+          sr.mSSRCOfSender = outputSSRC();
+          sr.mNTPTimestampMS = report->ntpTimestampMS();
+          sr.mNTPTimestampLS = report->ntpTimestampLS();
+          sr.mRTPTimestamp = report->rtpTimestamp() + mTimestampOffset;
+          sr.mSenderPacketCount = report->senderPacketCount();
+          sr.mSenderOctetCount = report->senderOctetCount();
+
+          outPacket = RTCPPacket::create(&sr);
+          break;
+        }
+
+        if (!outPacket) return;
+
+        sender = mRTPSender.lock();
+      }
+
+      if (!sender) return;
+
+      ZS_LOG_INSANE(log("forwarding sender report") + ZS_PARAM("size", outPacket->size()))
+      sender->sendPacket(outPacket);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPForwarder::notifyParametersChanged()
+    {
+      // called from within the receiver/sender lock; never acquire the
+      // forwarder lock here
+      auto pThis = mThisWeak.lock();
+      if (!pThis) return;
+      IWakeDelegateProxy::create(pThis)->onWake();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPForwarder => IRTPForwarderForRTPSender
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    bool RTPForwarder::handleFeedback(RTCPPacketPtr packet)
+    {
+      typedef RTCPPacket::Report Report;
+      typedef RTCPPacket::TransportLayerFeedbackMessage TransportLayerFeedbackMessage;
+      typedef RTCPPacket::TransportLayerFeedbackMessage::GenericNACK GenericNACK;
+      typedef RTCPPacket::PayloadSpecificFeedbackMessage PayloadSpecificFeedbackMessage;
+      typedef RTCPPacket::PayloadSpecificFeedbackMessage::PLI PLI;
+      typedef RTCPPacket::PayloadSpecificFeedbackMessage::FIR FIR;
+      typedef RTCPPacket::PayloadSpecificFeedbackMessage::REMB REMB;
+
+      if ((NULL == packet->firstTransportLayerFeedbackMessage()) &&
+          (NULL == packet->firstPayloadSpecificFeedbackMessage())) return false;
+
+      UseRTPReceiverPtr receiver;
+      RTCPPacketPtr outPacket;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (isShutdown()) return false;
+        if (!mActiveSourceSSRC.hasValue()) return false;
+
+        SSRCType forwardedSSRC = outputSSRC();
+        SSRCType sourceSSRC = mActiveSourceSSRC.value();
+
+        // parse a private copy since the original is shared with every
+        // other receiver/sender on the listener
+        RTCPPacketPtr copy = RTCPPacket::create(packet->ptr(), packet->size());
+        if (!copy) return false;
+
+        Report *first = NULL;
+        Report *last = NULL;
+
+        Report *next = NULL;
+        for (Report *report = copy->first(); NULL != report; report = next) {
+          next = report->next();
+
+          switch (report->pt()) {
+            case TransportLayerFeedbackMessage::kPayloadType:
+            {
+              auto fm = static_cast<TransportLayerFeedbackMessage *>(report);
+              if (GenericNACK::kFmt != fm->fmt()) continue;
+              if (forwardedSSRC != fm->mSSRCOfMediaSource) continue;
+
+              for (size_t index = 0; index < fm->genericNACKCount(); ++index) {
+                auto nack = fm->genericNACKAtIndex(index);
+                nack->mPID = static_cast<WORD>(nack->mPID - mSequenceNumberOffset);
+              }
+              fm->mSSRCOfMediaSource = sourceSSRC;
+              break;
+            }
+            case PayloadSpecificFeedbackMessage::kPayloadType:
+            {
+              auto fm = static_cast<PayloadSpecificFeedbackMessage *>(report);
+              bool found = false;
+
+              switch (fm->fmt()) {
+                case PLI::kFmt:
+                {
+                  found = (forwardedSSRC == fm->mSSRCOfMediaSource);
+                  break;
+                }
+                case FIR::kFmt:
+                {
+                  for (size_t index = 0; index < fm->firCount(); ++index) {
+                    auto fir = fm->firAtIndex(index);
+                    if (forwardedSSRC != fir->mSSRC) continue;
+                    fir->mSSRC = sourceSSRC;
+                    found = true;
+                  }
+                  break;
+                }
+                case REMB::kFmt:
+                {
+                  auto remb = fm->remb();
+                  if (NULL == remb) break;
+                  for (size_t index = 0; index < remb->numSSRC(); ++index) {
+                    if (forwardedSSRC != remb->mSSRCs[index]) continue;
+                    remb->mSSRCs[index] = sourceSSRC;
+                    found = true;
+                  }
+                  break;
+                }
+                default: break;
+              }
+
+              if (!found) continue;
+              if (forwardedSSRC == fm->mSSRCOfMediaSource) fm->mSSRCOfMediaSource = sourceSSRC;
+              break;
+            }
+            default: continue;
+          }
+
+          report->mNext = NULL;
+          report->mPadding = 0;
+
+          if (last) {
+            last->mNext = report;
+          } else {
+            first = report;
+          }
+          last = report;
+        }
+
+        if (NULL == first) return false;
+
+        outPacket = RTCPPacket::create(first);
+
+        ++mTotalFeedbackForwarded;
+
+        receiver = mRTPReceiver.lock();
+      }
+
+      if (!receiver) {
+        ZS_LOG_WARNING(Trace, log("receiver is gone (thus discarding feedback)"))
+        return false;
+      }
+
+      ZS_LOG_TRACE(log("forwarding feedback to source") + ZS_PARAM("size", outPacket->size()))
+
+      return receiver->sendPacket(outPacket);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPForwarder => IWakeDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPForwarder::onWake()
+    {
+      ZS_LOG_DEBUG(log("wake"))
+
+      AutoRecursiveLock lock(*this);
+      step();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPForwarder => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    Log::Params RTPForwarder::log(const char *message) const
+    {
+      ElementPtr objectEl = Element::create("ortc::RTPForwarder");
+      IHelper::debugAppend(objectEl, "id", mID);
+      return Log::Params(message, objectEl);
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params RTPForwarder::slog(const char *message)
+    {
+      return Log::Params(message, "ortc::RTPForwarder");
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params RTPForwarder::debug(const char *message) const
+    {
+      return Log::Params(message, toDebug());
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPForwarder::toDebug() const
+    {
+      AutoRecursiveLock lock(*this);
+
+      ElementPtr resultEl = Element::create("ortc::RTPForwarder");
+
+      auto receiver = mRTPReceiver.lock();
+      auto sender = mRTPSender.lock();
+
+      IHelper::debugAppend(resultEl, "id", mID);
+
+      IHelper::debugAppend(resultEl, "receiver", receiver ? receiver->getID() : 0);
+      IHelper::debugAppend(resultEl, "sender", sender ? sender->getID() : 0);
+
+      IHelper::debugAppend(resultEl, mOptions.toDebug());
+      IHelper::debugAppend(resultEl, "switch source after idle", mSwitchSourceAfterIdle);
+
+      IHelper::debugAppend(resultEl, "registered", mRegistered);
+      IHelper::debugAppend(resultEl, "shutdown", mShutdown);
+
+      IHelper::debugAppend(resultEl, "payload types", mPayloadTypes.size());
+      IHelper::debugAppend(resultEl, "header extension ids", mHeaderExtensionIDs.size());
+
+      IHelper::debugAppend(resultEl, "output ssrc", outputSSRC());
+      IHelper::debugAppend(resultEl, "generated ssrc", mGeneratedSSRC);
+      if (mActiveSourceSSRC.hasValue()) {
+        IHelper::debugAppend(resultEl, "active source ssrc", mActiveSourceSSRC.value());
+      }
+      IHelper::debugAppend(resultEl, "last source packet time", mLastSourcePacketTime);
+
+      IHelper::debugAppend(resultEl, "sequence number offset", mSequenceNumberOffset);
+      IHelper::debugAppend(resultEl, "timestamp offset", mTimestampOffset);
+
+      IHelper::debugAppend(resultEl, "has output", mHasOutput);
+      IHelper::debugAppend(resultEl, "last output sequence number", mLastOutputSequenceNumber);
+      IHelper::debugAppend(resultEl, "last output timestamp", mLastOutputTimestamp);
+      IHelper::debugAppend(resultEl, "last output time", mLastOutputTime);
+
+      IHelper::debugAppend(resultEl, "packets forwarded", mTotalPacketsForwarded);
+      IHelper::debugAppend(resultEl, "packets dropped", mTotalPacketsDropped);
+      IHelper::debugAppend(resultEl, "feedback forwarded", mTotalFeedbackForwarded);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPForwarder::step()
+    {
+      ZS_LOG_DEBUG(debug("step"))
+
+      if (isShutdown()) {
+        ZS_LOG_DEBUG(debug("step forwarding to cancel"))
+        cancel();
+        return;
+      }
+
+      if (!stepRegister()) goto not_ready;
+      if (!stepMappings()) goto not_ready;
+
+      goto ready;
+
+    not_ready:
+      {
+        ZS_LOG_TRACE(debug("not ready"))
+        return;
+      }
+
+    ready:
+      {
+        ZS_LOG_TRACE(log("ready"))
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPForwarder::stepRegister()
+    {
+      if (mRegistered) {
+        ZS_LOG_TRACE(log("already registered"))
+        return true;
+      }
+
+      auto receiver = mRTPReceiver.lock();
+      auto sender = mRTPSender.lock();
+
+      if ((!receiver) ||
+          (!sender)) {
+        ZS_LOG_WARNING(Debug, log("receiver or sender object gone"))
+        cancel();
+        return false;
+      }
+
+      auto pThis = mThisWeak.lock();
+
+      receiver->registerForwarder(pThis, mOptions.mExclusive);
+      sender->registerForwarder(pThis);
+
+      mRegistered = true;
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPForwarder::stepMappings()
+    {
+      auto receiver = mRTPReceiver.lock();
+      auto sender = mRTPSender.lock();
+
+      if ((!receiver) ||
+          (!sender)) {
+        ZS_LOG_WARNING(Debug, log("receiver or sender object gone"))
+        cancel();
+        return false;
+      }
+
+      mReceiverParameters = receiver->getParameters();
+      mSenderParameters = sender->getParameters();
+
+      mPayloadTypes.clear();
+      mClockRates.clear();
+      mHeaderExtensionIDs.clear();
+      mOutputSSRC = Optional<SSRCType>();
+
+      if ((!mReceiverParameters) ||
+          (!mSenderParameters)) {
+        ZS_LOG_TRACE(log("waiting for receive and send parameters"))
+        return false;
+      }
+
+      for (auto iterIn = mReceiverParameters->mCodecs.begin(); iterIn != mReceiverParameters->mCodecs.end(); ++iterIn) {
+        auto &inCodec = (*iterIn);
+
+        switch (IRTPTypes::getCodecKind(IRTPTypes::toSupportedCodec(inCodec.mName))) {
+          case IRTPTypes::CodecKind_RTX:
+          case IRTPTypes::CodecKind_FEC:  continue;   // payloads reference the source's own payload types / sequence space
+          default:                        break;
+        }
+
+        for (auto iterOut = mSenderParameters->mCodecs.begin(); iterOut != mSenderParameters->mCodecs.end(); ++iterOut) {
+          auto &outCodec = (*iterOut);
+
+          if (0 != inCodec.mName.compareNoCase(outCodec.mName)) continue;
+          if ((inCodec.mClockRate.hasValue()) &&
+              (outCodec.mClockRate.hasValue()) &&
+              (inCodec.mClockRate.value() != outCodec.mClockRate.value())) continue;
+          if ((inCodec.mNumChannels.hasValue()) &&
+              (outCodec.mNumChannels.hasValue()) &&
+              (inCodec.mNumChannels.value() != outCodec.mNumChannels.value())) continue;
+
+          mPayloadTypes[inCodec.mPayloadType] = outCodec.mPayloadType;
+          mClockRates[inCodec.mPayloadType] = (inCodec.mClockRate.hasValue() ? inCodec.mClockRate.value() : 90000);
+          break;
+        }
+      }
+
+      for (auto iterIn = mReceiverParameters->mHeaderExtensions.begin(); iterIn != mReceiverParameters->mHeaderExtensions.end(); ++iterIn) {
+        auto &inExtension = (*iterIn);
+
+        for (auto iterOut = mSenderParameters->mHeaderExtensions.begin(); iterOut != mSenderParameters->mHeaderExtensions.end(); ++iterOut) {
+          auto &outExtension = (*iterOut);
+
+          if (inExtension.mURI != outExtension.mURI) continue;
+
+          mHeaderExtensionIDs[static_cast<HeaderExtensionID>(inExtension.mID)] = static_cast<HeaderExtensionID>(outExtension.mID);
+          break;
+        }
+      }
+
+      for (auto iter = mSenderParameters->mEncodings.begin(); iter != mSenderParameters->mEncodings.end(); ++iter) {
+        auto &encoding = (*iter);
+        if (!encoding.mSSRC.hasValue()) continue;
+        mOutputSSRC = encoding.mSSRC;
+        break;
+      }
+
+      if ((!mOutputSSRC.hasValue()) &&
+          (0 == mGeneratedSSRC)) {
+        mGeneratedSSRC = static_cast<SSRCType>(IHelper::random(1, 0xFFFFFFFF));
+        ZS_LOG_WARNING(Detail, log("sender encodings do not specify an ssrc (thus generating ssrc)") + ZS_PARAM("ssrc", mGeneratedSSRC))
+      }
+
+      ZS_LOG_DEBUG(log("mappings updated") + ZS_PARAM("payload types", mPayloadTypes.size()) + ZS_PARAM("header extensions", mHeaderExtensionIDs.size()) + ZS_PARAM("output ssrc", outputSSRC()))
+
+      if (mPayloadTypes.size() < 1) {
+        ZS_LOG_WARNING(Detail, log("no codecs in common between receiver and sender (nothing will be forwarded)"))
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPForwarder::cancel()
+    {
+      if (isShutdown()) return;
+
+      ZS_LOG_DEBUG(log("cancel called"))
+
+      mShutdown = true;
+
+      if (mRegistered) {
+        auto receiver = mRTPReceiver.lock();
+        auto sender = mRTPSender.lock();
+
+        if (receiver) receiver->unregisterForwarder(mID);
+        if (sender) sender->unregisterForwarder(mID);
+
+        mRegistered = false;
+      }
+
+      mReceiverParameters.reset();
+      mSenderParameters.reset();
+
+      mPayloadTypes.clear();
+      mClockRates.clear();
+      mHeaderExtensionIDs.clear();
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPForwarder::switchSource(
+                                    const RTPPacket &packet,
+                                    ULONG clockRate,
+                                    const Time &now
+                                    )
+    {
+      WORD targetSequenceNumber {};
+      DWORD targetTimestamp {};
+
+      if (mHasOutput) {
+        // continue the outgoing sequence/timestamp space so the remote
+        // receiver sees a single uninterrupted stream
+        auto elapsed = zsLib::toMilliseconds(now - mLastOutputTime).count();
+        if (elapsed < 0) elapsed = 0;
+
+        DWORD elapsedTicks = static_cast<DWORD>((static_cast<QWORD>(elapsed) * static_cast<QWORD>(clockRate)) / 1000);
+
+        targetSequenceNumber = static_cast<WORD>(mLastOutputSequenceNumber + 1);
+        targetTimestamp = mLastOutputTimestamp + (0 != elapsedTicks ? elapsedTicks : 1);
+      } else {
+        targetSequenceNumber = static_cast<WORD>(IHelper::random(0, 0xFFFF));
+        targetTimestamp = static_cast<DWORD>(IHelper::random(0, 0xFFFFFFFF));
+      }
+
+      mSequenceNumberOffset = static_cast<WORD>(targetSequenceNumber - packet.sequenceNumber());
+      mTimestampOffset = targetTimestamp - packet.timestamp();
+
+      ZS_LOG_DEBUG(log("switching forwarded source") + ZS_PARAM("old ssrc", mActiveSourceSSRC.hasValue() ? mActiveSourceSSRC.value() : 0) + ZS_PARAM("new ssrc", packet.ssrc()) + ZS_PARAM("sequence number offset", mSequenceNumberOffset) + ZS_PARAM("timestamp offset", mTimestampOffset))
+
+      mActiveSourceSSRC = packet.ssrc();
+    }
+
+    //-------------------------------------------------------------------------
+    IRTPTypes::SSRCType RTPForwarder::outputSSRC() const
+    {
+      if (mOutputSSRC.hasValue()) return mOutputSSRC.value();
+      return mGeneratedSSRC;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPForwarderFactory
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    IRTPForwarderFactory &IRTPForwarderFactory::singleton()
+    {
+      return RTPForwarderFactory::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    RTPForwarderPtr IRTPForwarderFactory::create(
+                                                 IRTPReceiverPtr receiver,
+                                                 IRTPSenderPtr sender,
+                                                 const Options &options
+                                                 )
+    {
+      if (this) {}
+      return internal::RTPForwarder::create(receiver, sender, options);
+    }
+
+  } // internal namespace
+
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IRTPForwarderTypes::Options
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  ElementPtr IRTPForwarderTypes::Options::toDebug() const
+  {
+    ElementPtr resultEl = Element::create("ortc::IRTPForwarderTypes::Options");
+
+    if (mSourceSSRC.hasValue()) {
+      IHelper::debugAppend(resultEl, "source ssrc", mSourceSSRC.value());
+    }
+    IHelper::debugAppend(resultEl, "exclusive", mExclusive);
+
+    return resultEl;
+  }
+
+  //---------------------------------------------------------------------------
+  String IRTPForwarderTypes::Options::hash() const
+  {
+    auto hasher = IHasher::sha1();
+
+    hasher->update("ortc::IRTPForwarderTypes::Options:");
+
+    hasher->update(mSourceSSRC);
+    hasher->update(":");
+    hasher->update(mExclusive);
+
+    return hasher->finalizeAsString();
+  }
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IRTPForwarder
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  ElementPtr IRTPForwarder::toDebug(IRTPForwarderPtr forwarder)
+  {
+    return internal::RTPForwarder::toDebug(internal::RTPForwarder::convert(forwarder));
+  }
+
+  //---------------------------------------------------------------------------
+  IRTPForwarderPtr IRTPForwarder::create(
+                                         IRTPReceiverPtr receiver,
+                                         IRTPSenderPtr sender,
+                                         const Options &options
+                                         )
+  {
+    return internal::IRTPForwarderFactory::singleton().create(receiver, sender, options);
+  }
+
+}
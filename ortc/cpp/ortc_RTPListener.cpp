@@ -38,6 +38,7 @@
 #include <ortc/internal/ortc_SRTPSDESTransport.h>
 #include <ortc/internal/ortc_RTPTypes.h>
 #include <ortc/internal/ortc_ORTC.h>
+#include <ortc/internal/ortc_ReceiveLatency.h>
 #include <ortc/internal/ortc.events.h>
 #include <ortc/internal/platform.h>
 
@@ -72,6 +73,7 @@ namespace ortc
   namespace internal
   {
     ZS_DECLARE_CLASS_PTR(RTPListenerSettingsDefaults);
+    ZS_DECLARE_TYPEDEF_PTR(IReceiveLatencyForInternal, UseReceiveLatency);
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -144,6 +146,8 @@ namespace ortc
         ISettings::setUInt(ORTC_SETTING_RTP_LISTENER_UNHANDLED_EVENTS_TIMEOUT_IN_SECONDS, 60);
 
         ISettings::setUInt(ORTC_SETTING_RTP_LISTENER_ONLY_RESOLVE_AMBIGUOUS_PAYLOAD_MAPPING_IF_ACTIVITY_DIFFERS_IN_MILLISECONDS, 5 * 1000);
+
+        ISettings::setBool(ORTC_SETTING_RTP_LISTENER_ROUTE_RTCP_BY_SSRC, true);
       }
       
     };
@@ -435,6 +439,7 @@ namespace ortc
       mSenders(make_shared<SenderObjectMap>()),
       mAmbiguousPayloadMappingMinDifference(ISettings::getUInt(ORTC_SETTING_RTP_LISTENER_ONLY_RESOLVE_AMBIGUOUS_PAYLOAD_MAPPING_IF_ACTIVITY_DIFFERS_IN_MILLISECONDS)),
       mSSRCTableExpires(ISettings::getUInt(ORTC_SETTING_RTP_LISTENER_SSRC_TIMEOUT_IN_SECONDS)),
+      mRouteRTCPBySSRC(ISettings::getBool(ORTC_SETTING_RTP_LISTENER_ROUTE_RTCP_BY_SSRC)),
       mUnhandledEventsExpires(ISettings::getUInt(ORTC_SETTING_RTP_LISTENER_UNHANDLED_EVENTS_TIMEOUT_IN_SECONDS))
     {
       ZS_EVENTING_8(
@@ -657,6 +662,8 @@ namespace ortc
                                       size_t bufferLengthInBytes
                                       )
     {
+      UseReceiveLatency::stage(IReceiveLatencyTypes::Stage_RTPListener);
+
       ZS_EVENTING_5(
                     x, i, Trace, RtpListenerReceivedIncomingPacket, ol, RtpListener, Receive,
                     puid, id, mID,
@@ -703,6 +710,18 @@ namespace ortc
         if (IICETypes::Component_RTCP == packetType) {
           expireRTCPPackets();
 
+          SSRCList ssrcs;
+          bool allSenders = false;
+          bool routeBySSRC = (mRouteRTCPBySSRC) && (extractRTCPSSRCs(*rtcpPacket, ssrcs, allSenders));
+
+          if (routeBySSRC) {
+            receivers = make_shared<ReceiverObjectMap>();
+            senders = make_shared<SenderObjectMap>();
+
+            // resolve before BYEs are processed (as they remove the SSRC mappings)
+            routeRTCPSSRCs(ssrcs, *receivers, *senders);
+          }
+
           processByes(*rtcpPacket);
           processSDESMid(*rtcpPacket);
           processSenderReports(*rtcpPacket);
@@ -718,8 +737,14 @@ namespace ortc
 
           mBufferedRTCPPackets.push_back(TimeRTCPPacketPair(zsLib::now(), rtcpPacket));
 
-          receivers = mReceivers;
-          senders = mSenders;
+          if (routeBySSRC) {
+            // resolve again to pick up SSRCs just latched by SDES mid / SR
+            routeRTCPSSRCs(ssrcs, *receivers, *senders);
+            addRTCPWildcards(*receivers, *senders, allSenders);
+          } else {
+            receivers = mReceivers;
+            senders = mSenders;
+          }
           goto process_rtcp;
         }
 
@@ -942,6 +967,8 @@ namespace ortc
 
     finalize_registration:
       {
+        setReceiverRTCPSSRC(receiverID, &inParams);
+
         unregisterAllHeaderExtensionReferences(receiverID);
 
         // register all new header extensions
@@ -1055,6 +1082,10 @@ namespace ortc
         mMuxIDTable.erase(current);
       }
 
+      mRTCPWildcardReceiversDirty = true;
+
+      setReceiverRTCPSSRC(receiverID, NULL);
+
       unregisterAllHeaderExtensionReferences(receiverID);
     }
 
@@ -1123,6 +1154,8 @@ namespace ortc
       (*senders)[inSender->getID()] = inSender;
       mSenders = senders;
 
+      setSenderSSRCs(inSender->getID(), &inParams);
+
       expireRTCPPackets();
 
       for (auto iter = mBufferedRTCPPackets.begin(); iter != mBufferedRTCPPackets.end(); ++iter)
@@ -1169,7 +1202,8 @@ namespace ortc
           mSenders = senders;
         }
       }
-      
+
+      setSenderSSRCs(senderID, NULL);
     }
 
     //-------------------------------------------------------------------------
@@ -1253,6 +1287,7 @@ namespace ortc
                         );
 
           mSSRCTable.erase(current);
+          mRTCPWildcardReceiversDirty = true;
         }
 
         return;
@@ -1514,6 +1549,13 @@ namespace ortc
       mMuxIDTable.clear();
       mUnhandledEvents.clear();
 
+      mRTCPWildcardReceivers.clear();
+      mRTCPWildcardReceiversDirty = true;
+      mSenderSSRCs.clear();
+      mSenderSSRCLists.clear();
+      mRTCPWildcardSenders.clear();
+      mReceiverRTCPSSRCs.clear();
+
       if (mSSRCTableTimer) {
         mSSRCTableTimer->cancel();
         mSSRCTableTimer.reset();
@@ -2228,6 +2270,8 @@ namespace ortc
 
       // point to replacement list
       mReceivers = receivers;
+
+      mRTCPWildcardReceiversDirty = true;
     }
 
     //-------------------------------------------------------------------------
@@ -2254,6 +2298,7 @@ namespace ortc
                             );
 
               mSSRCTable.erase(found);
+              mRTCPWildcardReceiversDirty = true;
             }
           }
 
@@ -2377,6 +2422,265 @@ namespace ortc
       }
     }
 
+    //-------------------------------------------------------------------------
+    bool RTPListener::extractRTCPSSRCs(
+                                       const RTCPPacket &rtcpPacket,
+                                       SSRCList &outSSRCs,
+                                       bool &outAllSenders
+                                       )
+    {
+      outAllSenders = false;
+
+      // APP and unknown reports cannot be attributed to a stream
+      if (NULL != rtcpPacket.firstApp()) return false;
+      if (NULL != rtcpPacket.firstUnknownReport()) return false;
+
+      for (auto sr = rtcpPacket.firstSenderReport(); NULL != sr; sr = sr->nextSenderReport()) {
+        outSSRCs.push_back(sr->ssrcOfSender());
+        for (auto block = sr->firstReportBlock(); NULL != block; block = block->next()) {
+          outSSRCs.push_back(block->ssrc());
+        }
+      }
+
+      for (auto rr = rtcpPacket.firstReceiverReport(); NULL != rr; rr = rr->nextReceiverReport()) {
+        outSSRCs.push_back(rr->ssrcOfPacketSender());
+        for (auto block = rr->firstReportBlock(); NULL != block; block = block->next()) {
+          outSSRCs.push_back(block->ssrc());
+        }
+      }
+
+      for (auto sdes = rtcpPacket.firstSDES(); NULL != sdes; sdes = sdes->nextSDES()) {
+        for (auto chunk = sdes->firstChunk(); NULL != chunk; chunk = chunk->next()) {
+          outSSRCs.push_back(chunk->ssrc());
+        }
+      }
+
+      for (auto bye = rtcpPacket.firstBye(); NULL != bye; bye = bye->nextBye()) {
+        for (size_t index = 0; index < bye->sc(); ++index) {
+          outSSRCs.push_back(bye->ssrc(index));
+        }
+      }
+
+      for (auto fb = rtcpPacket.firstTransportLayerFeedbackMessage(); NULL != fb; fb = fb->nextTransportLayerFeedbackMessage()) {
+        if (0 == fb->ssrcOfMediaSource()) outAllSenders = true;
+        else outSSRCs.push_back(fb->ssrcOfMediaSource());
+
+        for (size_t index = 0; index < fb->tmmbrCount(); ++index) {
+          outSSRCs.push_back(fb->tmmbrAtIndex(index)->ssrc());
+        }
+      }
+
+      for (auto fb = rtcpPacket.firstPayloadSpecificFeedbackMessage(); NULL != fb; fb = fb->nextPayloadSpecificFeedbackMessage()) {
+        if (0 == fb->ssrcOfMediaSource()) outAllSenders = true;
+        else outSSRCs.push_back(fb->ssrcOfMediaSource());
+
+        for (size_t index = 0; index < fb->firCount(); ++index) {
+          outSSRCs.push_back(fb->firAtIndex(index)->ssrc());
+        }
+
+        auto remb = fb->remb();
+        if (NULL != remb) {
+          for (size_t index = 0; index < remb->numSSRC(); ++index) {
+            outSSRCs.push_back(remb->ssrcAtIndex(index));
+          }
+        }
+      }
+
+      for (auto xr = rtcpPacket.firstXR(); NULL != xr; xr = xr->nextXR()) {
+        outSSRCs.push_back(xr->ssrc());
+
+        for (auto block = xr->firstLossRLEReportBlock(); NULL != block; block = block->nextLossRLE()) {
+          outSSRCs.push_back(block->ssrcOfSource());
+        }
+        for (auto block = xr->firstDuplicateRLEReportBlock(); NULL != block; block = block->nextDuplicateRLE()) {
+          outSSRCs.push_back(block->ssrcOfSource());
+        }
+        for (auto block = xr->firstPacketReceiptTimesReportBlock(); NULL != block; block = block->nextPacketReceiptTimesReportBlock()) {
+          outSSRCs.push_back(block->ssrcOfSource());
+        }
+        for (auto block = xr->firstDLRRReportBlock(); NULL != block; block = block->nextDLRRReportBlock()) {
+          for (size_t index = 0; index < block->subBlockCount(); ++index) {
+            outSSRCs.push_back(block->subBlockAtIndex(index)->ssrc());
+          }
+        }
+        for (auto block = xr->firstStatisticsSummaryReportBlock(); NULL != block; block = block->nextStatisticsSummaryReportBlock()) {
+          outSSRCs.push_back(block->ssrcOfSource());
+        }
+        for (auto block = xr->firstVoIPMetricsReportBlock(); NULL != block; block = block->nextVoIPMetricsReportBlock()) {
+          outSSRCs.push_back(block->ssrcOfSource());
+        }
+      }
+
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPListener::routeRTCPSSRCs(
+                                     const SSRCList &ssrcs,
+                                     ReceiverObjectMap &ioReceivers,
+                                     SenderObjectMap &ioSenders
+                                     )
+    {
+      for (auto iter = ssrcs.begin(); iter != ssrcs.end(); ++iter) {
+        SSRCType ssrc = (*iter);
+
+        // scope: find receiver using this SSRC
+        {
+          SSRCInfoPtr ssrcInfo;
+
+          auto found = mSSRCTable.find(ssrc);
+          if (found != mSSRCTable.end()) {
+            ssrcInfo = (*found).second;
+          } else {
+            auto foundWeak = mRegisteredSSRCs.find(ssrc);
+            if (foundWeak != mRegisteredSSRCs.end()) ssrcInfo = (*foundWeak).second.lock();
+          }
+
+          if ((ssrcInfo) &&
+              (ssrcInfo->mReceiverInfo)) {
+            auto foundReceiver = mReceivers->find(ssrcInfo->mReceiverInfo->mReceiverID);
+            if (foundReceiver != mReceivers->end()) ioReceivers[(*foundReceiver).first] = (*foundReceiver).second;
+          }
+        }
+
+        // scope: find receiver sending RTCP from this SSRC (e.g. an XR DLRR
+        // answering the receiver's own RRTR)
+        {
+          auto found = mReceiverRTCPSSRCs.find(ssrc);
+          if (found != mReceiverRTCPSSRCs.end()) {
+            auto foundReceiver = mReceivers->find((*found).second);
+            if (foundReceiver != mReceivers->end()) ioReceivers[(*foundReceiver).first] = (*foundReceiver).second;
+          }
+        }
+
+        // scope: find sender using this SSRC
+        {
+          auto found = mSenderSSRCs.find(ssrc);
+          if (found != mSenderSSRCs.end()) {
+            auto foundSender = mSenders->find((*found).second);
+            if (foundSender != mSenders->end()) ioSenders[(*foundSender).first] = (*foundSender).second;
+          }
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPListener::addRTCPWildcards(
+                                       ReceiverObjectMap &ioReceivers,
+                                       SenderObjectMap &ioSenders,
+                                       bool allSenders
+                                       )
+    {
+      if (mRTCPWildcardReceiversDirty) {
+        mRTCPWildcardReceiversDirty = false;
+
+        // any receiver which cannot be found via an SSRC receives all RTCP
+        mRTCPWildcardReceivers = *mReceivers;
+
+        for (auto iter = mSSRCTable.begin(); iter != mSSRCTable.end(); ++iter) {
+          auto &ssrcInfo = (*iter).second;
+          if (!ssrcInfo->mReceiverInfo) continue;
+          mRTCPWildcardReceivers.erase(ssrcInfo->mReceiverInfo->mReceiverID);
+        }
+
+        for (auto iter = mRegisteredSSRCs.begin(); iter != mRegisteredSSRCs.end(); ++iter) {
+          auto ssrcInfo = (*iter).second.lock();
+          if (!ssrcInfo) continue;
+          if (!ssrcInfo->mReceiverInfo) continue;
+          mRTCPWildcardReceivers.erase(ssrcInfo->mReceiverInfo->mReceiverID);
+        }
+      }
+
+      for (auto iter = mRTCPWildcardReceivers.begin(); iter != mRTCPWildcardReceivers.end(); ++iter) {
+        ioReceivers[(*iter).first] = (*iter).second;
+      }
+
+      if (allSenders) {
+        ioSenders = *mSenders;
+        return;
+      }
+
+      for (auto iter = mRTCPWildcardSenders.begin(); iter != mRTCPWildcardSenders.end(); ++iter) {
+        auto found = mSenders->find(*iter);
+        if (found == mSenders->end()) continue;
+        ioSenders[(*found).first] = (*found).second;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPListener::setSenderSSRCs(
+                                     SenderID senderID,
+                                     const Parameters *params
+                                     )
+    {
+      // scope: remove previous SSRCs for this sender
+      {
+        auto found = mSenderSSRCLists.find(senderID);
+        if (found != mSenderSSRCLists.end()) {
+          auto &ssrcs = (*found).second;
+          for (auto iter = ssrcs.begin(); iter != ssrcs.end(); ++iter) {
+            auto foundSSRC = mSenderSSRCs.find(*iter);
+            if (foundSSRC == mSenderSSRCs.end()) continue;
+            if ((*foundSSRC).second != senderID) continue;
+            mSenderSSRCs.erase(foundSSRC);
+          }
+          mSenderSSRCLists.erase(found);
+        }
+        mRTCPWildcardSenders.erase(senderID);
+      }
+
+      if (NULL == params) return;
+
+      SSRCList ssrcs;
+
+      for (auto iter = params->mEncodings.begin(); iter != params->mEncodings.end(); ++iter) {
+        auto &encodingInfo = (*iter);
+
+        if (encodingInfo.mSSRC.hasValue()) {
+          ssrcs.push_back(encodingInfo.mSSRC.value());
+        }
+        if ((encodingInfo.mRTX.hasValue()) &&
+            (encodingInfo.mRTX.value().mSSRC.hasValue())) {
+          ssrcs.push_back(encodingInfo.mRTX.value().mSSRC.value());
+        }
+        if ((encodingInfo.mFEC.hasValue()) &&
+            (encodingInfo.mFEC.value().mSSRC.hasValue())) {
+          ssrcs.push_back(encodingInfo.mFEC.value().mSSRC.value());
+        }
+      }
+
+      if (ssrcs.size() < 1) {
+        // sender SSRCs are not known thus it must receive all RTCP
+        mRTCPWildcardSenders.insert(senderID);
+        return;
+      }
+
+      for (auto iter = ssrcs.begin(); iter != ssrcs.end(); ++iter) {
+        mSenderSSRCs[*iter] = senderID;
+      }
+      mSenderSSRCLists[senderID] = ssrcs;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPListener::setReceiverRTCPSSRC(
+                                          ReceiverID receiverID,
+                                          const Parameters *params
+                                          )
+    {
+      for (auto iter_doNotUse = mReceiverRTCPSSRCs.begin(); iter_doNotUse != mReceiverRTCPSSRCs.end(); ) {
+        auto current = iter_doNotUse;
+        ++iter_doNotUse;
+
+        if ((*current).second != receiverID) continue;
+        mReceiverRTCPSSRCs.erase(current);
+      }
+
+      if (NULL == params) return;
+      if (0 == params->mRTCP.mSSRC) return;
+
+      mReceiverRTCPSSRCs[params->mRTCP.mSSRC] = receiverID;
+    }
+
     //-------------------------------------------------------------------------
     void RTPListener::handleDeltaChanges(
                                          ReceiverInfoPtr replacementInfo,
@@ -2485,6 +2789,7 @@ namespace ortc
                       );
 
         mSSRCTable[ssrc] = ssrcInfo;
+        if (ioReceiverInfo) mRTCPWildcardReceiversDirty = true;
         reattemptDelivery();
         return ssrcInfo;
       }
@@ -2492,6 +2797,7 @@ namespace ortc
       ssrcInfo->mLastUsage = zsLib::now();
 
       if (ioReceiverInfo) {
+        if (ssrcInfo->mReceiverInfo != ioReceiverInfo) mRTCPWildcardReceiversDirty = true;
         ssrcInfo->mReceiverInfo = ioReceiverInfo;
       } else {
         ioReceiverInfo = ssrcInfo->mReceiverInfo;
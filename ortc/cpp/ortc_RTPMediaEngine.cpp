@@ -56,6 +56,7 @@
 #include <cryptopp/sha.h>
 
 #include <limits>
+#include <algorithm>
 #include <float.h>
 #include <math.h>
 
@@ -89,6 +90,7 @@ namespace ortc
   namespace internal
   {
     ZS_DECLARE_CLASS_PTR(RTPMediaEngineSettingsDefaults);
+    ZS_DECLARE_TYPEDEF_PTR(IReceiveLatencyForInternal, UseReceiveLatency);
     ZS_DECLARE_CLASS_PTR(RTPMediaEngineRegistration);
     ZS_DECLARE_CLASS_PTR(RTPMediaEngineSingleton);
     ZS_DECLARE_TYPEDEF_PTR(IStatsReportForInternal, UseStatsReport);
@@ -955,6 +957,21 @@ namespace ortc
       return mVoiceEngine.get();
     }
 
+    //-------------------------------------------------------------------------
+    bool RTPMediaEngine::claimSyntheticAudioFeed(PUID resourceID)
+    {
+      PUID expected {};
+      if (mSyntheticAudioFeedResourceID.compare_exchange_strong(expected, resourceID)) return true;
+      return expected == resourceID;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::releaseSyntheticAudioFeed(PUID resourceID)
+    {
+      PUID expected = resourceID;
+      mSyntheticAudioFeedResourceID.compare_exchange_strong(expected, 0);
+    }
+
     //-------------------------------------------------------------------------
     rtc::scoped_refptr<webrtc::AudioState> RTPMediaEngine::getAudioState()
     {
@@ -1775,6 +1792,9 @@ namespace ortc
     {
       mThisWeak.reset();  // shared pointer to self is no longer valid
 
+      // a synthetic source's pacing thread must not outlive its last sink
+      releaseSyntheticSource();
+
       // inform the rtp media engine of this resource no longer being in use
       UseEnginePtr engine = getEngine<UseEngine>();
       if (engine) {
@@ -1849,12 +1869,16 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPMediaEngine::DeviceResource::stop()
     {
-      AutoRecursiveLock lock(*this);
+      {
+        AutoRecursiveLock lock(*this);
 
-      if (mVideoCaptureModule) {
-        mVideoCaptureModule->StopCapture();
-        mVideoCaptureModule->DeRegisterCaptureDataCallback();
+        if (mVideoCaptureModule) {
+          mVideoCaptureModule->StopCapture();
+          mVideoCaptureModule->DeRegisterCaptureDataCallback();
+        }
       }
+
+      releaseSyntheticSource();
     }
 
     //-------------------------------------------------------------------------
@@ -2026,6 +2050,66 @@ namespace ortc
       ++mFramesSent;
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngine::DeviceResource => ISyntheticMediaSourceSink
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::DeviceResource::onSyntheticVideoFrame(VideoFramePtr frame)
+    {
+      AutoIncrementLock incLock(mAccessFromNonLockedMethods);
+
+      if (mDenyNonLockedAccess) return;
+
+      // Delivered directly on the source's pacing thread rather than being
+      // posted to the device queue so many synthetic tracks do not serialize
+      // behind a single queue and the frame cadence is preserved.
+      onCapturedVideoFrame(frame);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::DeviceResource::onSyntheticAudioSamples(
+                                                                 const int16_t *samples,
+                                                                 size_t samplesPerChannel,
+                                                                 size_t channels,
+                                                                 ULONG sampleRate
+                                                                 )
+    {
+      AutoIncrementLock incLock(mAccessFromNonLockedMethods);
+
+      if (mDenyNonLockedAccess) return;
+      if (!mSyntheticAudioFeed) return;
+
+      auto engine = mMediaEngine.lock();
+      if (!engine) return;
+
+      auto voiceEngine = engine->getVoiceEngine();
+      if (!voiceEngine) return;
+
+      auto audioTransport = webrtc::VoEBase::GetInterface(voiceEngine)->audio_transport();
+      if (!audioTransport) return;
+
+      // inject as if recorded by the audio device so the samples follow the
+      // same processing and encoding path as captured audio
+      uint32_t newMicLevel {};
+      audioTransport->RecordedDataIsAvailable(
+                                              samples,
+                                              samplesPerChannel,
+                                              sizeof(int16_t) * channels,
+                                              channels,
+                                              sampleRate,
+                                              0,
+                                              0,
+                                              0,
+                                              false,
+                                              newMicLevel
+                                              );
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -2066,6 +2150,16 @@ namespace ortc
         }
 
         mDeviceID = constraints->mAdvanced.front()->mDeviceID.mValue.value().mValue.value();
+
+        if (UseSyntheticSource::isSyntheticDeviceID(mDeviceID)) {
+          if (!setupSyntheticSource(kind, settings)) {
+            notifyPromisesReject();
+            return;
+          }
+          notifyPromisesResolve();
+          return;
+        }
+
         mVideoCaptureModule = webrtc::VideoCaptureFactory::Create(0, mDeviceID.c_str());
         if (!mVideoCaptureModule) {
           return;
@@ -2218,6 +2312,15 @@ namespace ortc
 
         mDeviceID = constraints->mAdvanced.front()->mDeviceID.mValue.value().mValue.value();
 
+        if (UseSyntheticSource::isSyntheticDeviceID(mDeviceID)) {
+          if (!setupSyntheticSource(kind, settings)) {
+            notifyPromisesReject();
+            return;
+          }
+          notifyPromisesResolve();
+          return;
+        }
+
         auto engine = mMediaEngine.lock();
         if (!engine) return;
 
@@ -2239,6 +2342,8 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPMediaEngine::DeviceResource::stepShutdown()
     {
+      releaseSyntheticSource();
+
       mDenyNonLockedAccess = true;
 
       // rare race condition that can happen so
@@ -2369,6 +2474,72 @@ namespace ortc
     #pragma mark RTPMediaEngine::DeviceResource => (internal)
     #pragma mark
 
+    //-------------------------------------------------------------------------
+    bool RTPMediaEngine::DeviceResource::setupSyntheticSource(
+                                                              Kinds kind,
+                                                              TrackSettingsPtr settings
+                                                              )
+    {
+      auto source = UseSyntheticSource::open(mDeviceID);
+      if (!source) return false;
+
+      if (source->kind() != kind) {
+        ZS_LOG_WARNING(Detail, Log::Params("synthetic source kind does not match track kind", "ortc::RTPMediaEngine::DeviceResource") + ZS_PARAM("device id", mDeviceID))
+        return false;
+      }
+
+      if (Kinds::Kind_Video == kind) {
+        settings->mWidth = static_cast<LONG>(source->width());
+        settings->mHeight = static_cast<LONG>(source->height());
+        settings->mFrameRate = source->frameRate();
+      } else {
+        auto engine = mMediaEngine.lock();
+        if (!engine) return false;
+
+        if (!engine->claimSyntheticAudioFeed(mID)) {
+          ZS_LOG_WARNING(Detail, Log::Params("another synthetic audio source is already feeding the voice engine", "ortc::RTPMediaEngine::DeviceResource") + ZS_PARAM("device id", mDeviceID))
+          return false;
+        }
+        mSyntheticAudioFeed = true;
+
+        settings->mSampleRate = static_cast<LONG>(source->sampleRate());
+        settings->mChannelCount = static_cast<LONG>(source->channels());
+      }
+      settings->mDeviceID = mDeviceID;
+
+      mSyntheticSource = source;
+
+      auto pThis = ZS_DYNAMIC_PTR_CAST(DeviceResource, mThisWeak.lock());
+      source->attach(mID, pThis);
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::DeviceResource::releaseSyntheticSource()
+    {
+      UseSyntheticSourcePtr source;
+      bool audioFeed = false;
+
+      {
+        AutoRecursiveLock lock(*this);
+        source = mSyntheticSource;
+        audioFeed = mSyntheticAudioFeed;
+        mSyntheticSource.reset();
+        mSyntheticAudioFeed = false;
+      }
+
+      if (!source) return;
+
+      // NOTE: detach outside the lock as it waits for the pacing thread which
+      // may be delivering a frame that requires the lock.
+      source->detach(mID);
+
+      if (audioFeed) {
+        auto engine = mMediaEngine.lock();
+        if (engine) engine->releaseSyntheticAudioFeed(mID);
+      }
+    }
+
     //-------------------------------------------------------------------------
     PromisePtr RTPMediaEngine::DeviceResource::getShutdownPromise()
     {
@@ -2828,7 +2999,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     bool RTPMediaEngine::AudioReceiverChannelResource::handlePacket(const RTPPacket &packet)
     {
-      IRTPMediaEngineHandlePacketAsyncDelegateProxy::createUsingQueue(mHandlePacketQueue, getThis<AudioReceiverChannelResource>())->onHandleRTPPacket(packet.timestamp(), packet.buffer());
+      IRTPMediaEngineHandlePacketAsyncDelegateProxy::createUsingQueue(mHandlePacketQueue, getThis<AudioReceiverChannelResource>())->onHandleRTPPacket(packet.timestamp(), packet.buffer(), UseReceiveLatency::queued());
       return true;
     }
 
@@ -2848,8 +3019,14 @@ namespace ortc
     #pragma mark
 
     //-------------------------------------------------------------------------
-    void RTPMediaEngine::AudioReceiverChannelResource::onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer)
+    void RTPMediaEngine::AudioReceiverChannelResource::onHandleRTPPacket(
+                                                                         DWORD timestamp,
+                                                                         SecureByteBlockPtr buffer,
+                                                                         ReceiveLatencyStamp latencyStamp
+                                                                         )
     {
+      UseReceiveLatency::dequeued(latencyStamp);
+
       AutoIncrementLock incLock(mAccessFromNonLockedMethods);
 
       if (mDenyNonLockedAccess) return;
@@ -3984,7 +4161,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     bool RTPMediaEngine::VideoReceiverChannelResource::handlePacket(const RTPPacket &packet)
     {
-      IRTPMediaEngineHandlePacketAsyncDelegateProxy::createUsingQueue(mHandlePacketQueue, getThis<VideoReceiverChannelResource>())->onHandleRTPPacket(packet.timestamp(), packet.buffer());
+      IRTPMediaEngineHandlePacketAsyncDelegateProxy::createUsingQueue(mHandlePacketQueue, getThis<VideoReceiverChannelResource>())->onHandleRTPPacket(packet.timestamp(), packet.buffer(), UseReceiveLatency::queued());
       return true;
     }
 
@@ -4004,8 +4181,14 @@ namespace ortc
     #pragma mark
 
     //-------------------------------------------------------------------------
-    void RTPMediaEngine::VideoReceiverChannelResource::onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer)
+    void RTPMediaEngine::VideoReceiverChannelResource::onHandleRTPPacket(
+                                                                         DWORD timestamp,
+                                                                         SecureByteBlockPtr buffer,
+                                                                         ReceiveLatencyStamp latencyStamp
+                                                                         )
     {
+      UseReceiveLatency::dequeued(latencyStamp);
+
       AutoIncrementLock incLock(mAccessFromNonLockedMethods);
 
       if (mDenyNonLockedAccess) return;
@@ -4734,7 +4917,27 @@ namespace ortc
       int totalMinBitrate = 0;
       int totalMaxBitrate = 0;
       int totalTargetBitrate = 0;
-      for (auto encodingParamIter = mParameters->mEncodings.begin(); encodingParamIter != mParameters->mEncodings.end(); encodingParamIter++) {
+
+      // Simulcast encodings share this single send stream so the captured
+      // frame is downscaled once into a resolution pyramid; the encoder
+      // requires the streams ordered from lowest to highest resolution.
+      typedef std::vector<const IRTPTypes::EncodingParameters *> EncodingParametersOrderedList;
+      EncodingParametersOrderedList orderedEncodings;
+      for (auto iter = mParameters->mEncodings.begin(); iter != mParameters->mEncodings.end(); ++iter) {
+        orderedEncodings.push_back(&(*iter));
+      }
+      std::stable_sort(
+                       orderedEncodings.begin(),
+                       orderedEncodings.end(),
+                       [](const IRTPTypes::EncodingParameters *left, const IRTPTypes::EncodingParameters *right) -> bool {
+                         double leftScale = left->mResolutionScale.hasValue() ? left->mResolutionScale.value() : 1.0;
+                         double rightScale = right->mResolutionScale.hasValue() ? right->mResolutionScale.value() : 1.0;
+                         return leftScale > rightScale;
+                       }
+                       );
+
+      for (auto orderedIter = orderedEncodings.begin(); orderedIter != orderedEncodings.end(); ++orderedIter) {
+        auto encodingParamIter = (*orderedIter);
 
         IRTPTypes::PayloadType codecPayloadType {};
         if (encodingParamIter->mCodecPayloadType.hasValue())
@@ -4763,7 +4966,7 @@ namespace ortc
           webrtc::VideoStream stream;
           stream.width = encodingParamIter->mResolutionScale.hasValue() ? sourceWidth / encodingParamIter->mResolutionScale : sourceWidth;
           stream.height = encodingParamIter->mResolutionScale.hasValue() ? sourceHeight / encodingParamIter->mResolutionScale : sourceHeight;
-          stream.max_framerate = encodingParamIter->mFramerateScale.hasValue() ? sourceMaxFramerate / encodingParamIter->mResolutionScale : sourceMaxFramerate;
+          stream.max_framerate = encodingParamIter->mFramerateScale.hasValue() ? sourceMaxFramerate / encodingParamIter->mFramerateScale : sourceMaxFramerate;
           stream.min_bitrate_bps = 30000;
           stream.max_bitrate_bps = encodingParamIter->mMaxBitrate.hasValue() ? encodingParamIter->mMaxBitrate : 2000000;
           stream.target_bitrate_bps = stream.max_bitrate_bps / 2;
@@ -0,0 +1,293 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#include <ortc/internal/ortc_RTPPacketHistory.h>
+#include <ortc/internal/ortc_RTPUtils.h>
+#include <ortc/internal/platform.h>
+
+#include <ortc/IHelper.h>
+
+#include <zsLib/Stringize.h>
+#include <zsLib/Log.h>
+#include <zsLib/XML.h>
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib_rtpsender) }
+
+namespace ortc
+{
+  namespace internal
+  {
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPPacketHistory::Settings
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPPacketHistory::Settings::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::RTPPacketHistory::Settings");
+
+      IHelper::debugAppend(resultEl, "max packets", mMaxPackets);
+      IHelper::debugAppend(resultEl, "max age", mMaxAge);
+      IHelper::debugAppend(resultEl, "min resend interval", mMinResendInterval);
+      IHelper::debugAppend(resultEl, "max resends per packet", mMaxResendsPerPacket);
+      IHelper::debugAppend(resultEl, "max resend bytes per second", mMaxResendBytesPerSecond);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPPacketHistory
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTPPacketHistory::RTPPacketHistory(
+                                       const make_private &,
+                                       const Settings &settings,
+                                       SSRCType rtxSSRC
+                                       ) :
+      mSettings(settings),
+      mRTXSSRC(rtxSSRC),
+      mRTXSequenceNumber(static_cast<WORD>(IHelper::random(0, 0x7FFF)))
+    {
+      size_t size = 1;
+      while (size < mSettings.mMaxPackets) size <<= 1;
+
+      mSlots.resize(size);
+      mMask = size - 1;
+
+      mCredit = static_cast<double>(mSettings.mMaxResendBytesPerSecond);
+    }
+
+    //-------------------------------------------------------------------------
+    RTPPacketHistoryPtr RTPPacketHistory::create(
+                                                 const Settings &settings,
+                                                 SSRCType rtxSSRC
+                                                 )
+    {
+      return make_shared<RTPPacketHistory>(make_private{}, settings, rtxSSRC);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPPacketHistory::store(
+                                 RTPPacketPtr packet,
+                                 const Time &now
+                                 )
+    {
+      ASSERT((bool)packet)
+
+      auto &slot = mSlots[packet->sequenceNumber() & mMask];
+
+      slot.mPacket = packet;
+      slot.mSequenceNumber = packet->sequenceNumber();
+      slot.mSent = now;
+      slot.mLastResent = Time();
+      slot.mResends = 0;
+
+      ++mTotalStored;
+    }
+
+    //-------------------------------------------------------------------------
+    RTPPacketPtr RTPPacketHistory::resend(
+                                          WORD sequenceNumber,
+                                          const Time &now,
+                                          Milliseconds roundTripTime,
+                                          const PayloadTypeMap &rtxPayloadTypes
+                                          )
+    {
+      auto &slot = mSlots[sequenceNumber & mMask];
+
+      if ((!slot.mPacket) ||
+          (slot.mSequenceNumber != sequenceNumber) ||
+          (slot.mSent + mSettings.mMaxAge < now)) {
+        ++mTotalMissing;
+        return RTPPacketPtr();
+      }
+
+      auto found = rtxPayloadTypes.find(slot.mPacket->pt());
+      if (found == rtxPayloadTypes.end()) {
+        ++mTotalMissing;
+        return RTPPacketPtr();
+      }
+
+      if (slot.mResends >= mSettings.mMaxResendsPerPacket) {
+        ++mTotalSuppressed;
+        return RTPPacketPtr();
+      }
+
+      if (Time() != slot.mLastResent) {
+        // a repeated NACK arriving within a round trip of the previous
+        // resend was sent before that resend could have been received
+        Milliseconds interval = (roundTripTime > mSettings.mMinResendInterval ? roundTripTime : mSettings.mMinResendInterval);
+        if (slot.mLastResent + interval > now) {
+          ++mTotalSuppressed;
+          return RTPPacketPtr();
+        }
+      }
+
+      updateCredit(now);
+
+      double size = static_cast<double>(slot.mPacket->size() + sizeof(WORD));
+      if (mCredit < size) {
+        ++mTotalRateLimited;
+        return RTPPacketPtr();
+      }
+
+      auto result = createRTXPacket(*slot.mPacket, (*found).second, mRTXSSRC, mRTXSequenceNumber);
+      if (!result) return RTPPacketPtr();
+
+      ++mRTXSequenceNumber;
+      mCredit -= size;
+
+      slot.mLastResent = now;
+      ++slot.mResends;
+      ++mTotalResent;
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPPacketHistory::handleNACK(
+                                      const RTCPPacket::TransportLayerFeedbackMessage &nack,
+                                      const Time &now,
+                                      Milliseconds roundTripTime,
+                                      const PayloadTypeMap &rtxPayloadTypes,
+                                      RTPPacketList &outResends
+                                      )
+    {
+      for (size_t index = 0; index < nack.genericNACKCount(); ++index) {
+        auto entry = nack.genericNACKAtIndex(index);
+
+        // https://tools.ietf.org/html/rfc4585#section-6.2.1
+        for (size_t bit = 0; bit <= 16; ++bit) {
+          if (0 != bit) {
+            if (0 == (entry->blp() & (1 << (bit - 1)))) continue;
+          }
+
+          // a sequence number listed more than once is suppressed by resend()
+          auto resend = this->resend(static_cast<WORD>(entry->pid() + bit), now, roundTripTime, rtxPayloadTypes);
+          if (!resend) continue;
+
+          outResends.push_back(resend);
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    RTPPacketPtr RTPPacketHistory::createRTXPacket(
+                                                   const RTPPacket &original,
+                                                   PayloadType rtxPayloadType,
+                                                   SSRCType rtxSSRC,
+                                                   WORD rtxSequenceNumber
+                                                   )
+    {
+      // https://tools.ietf.org/html/rfc4588#section-4
+      SecureByteBlock payload(original.payloadSize() + sizeof(WORD));
+      RTPUtils::setBE16(payload.BytePtr(), original.sequenceNumber());
+      if (original.payloadSize() > 0) {
+        memcpy(&((payload.BytePtr())[sizeof(WORD)]), original.payload(), original.payloadSize());
+      }
+
+      DWORD csrcs[0xF] {};
+      for (size_t index = 0; index < original.cc(); ++index) {
+        csrcs[index] = original.getCSRC(index);
+      }
+
+      RTPPacket::CreationParams params;
+      params.mVersion = original.version();
+      params.mM = original.m();
+      params.mPT = rtxPayloadType;
+      params.mSequenceNumber = rtxSequenceNumber;
+      params.mTimestamp = original.timestamp();
+      params.mSSRC = rtxSSRC;
+      params.mCC = original.cc();
+      params.mCSRCList = (original.cc() > 0 ? &(csrcs[0]) : NULL);
+      params.mPayload = payload.BytePtr();
+      params.mPayloadSize = payload.SizeInBytes();
+      params.mFirstHeaderExtension = original.firstHeaderExtension();
+      params.mHeaderExtensionAppBits = original.headerExtensionAppBits();
+
+      return RTPPacket::create(params);
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPPacketHistory::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::RTPPacketHistory");
+
+      IHelper::debugAppend(resultEl, "settings", mSettings.toDebug());
+      IHelper::debugAppend(resultEl, "rtx ssrc", mRTXSSRC);
+      IHelper::debugAppend(resultEl, "rtx sequence number", mRTXSequenceNumber);
+
+      IHelper::debugAppend(resultEl, "slots", mSlots.size());
+
+      IHelper::debugAppend(resultEl, "last credit update", mLastCreditUpdate);
+      IHelper::debugAppend(resultEl, "credit", mCredit);
+
+      IHelper::debugAppend(resultEl, "total stored", mTotalStored);
+      IHelper::debugAppend(resultEl, "total resent", mTotalResent);
+      IHelper::debugAppend(resultEl, "total missing", mTotalMissing);
+      IHelper::debugAppend(resultEl, "total suppressed", mTotalSuppressed);
+      IHelper::debugAppend(resultEl, "total rate limited", mTotalRateLimited);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPPacketHistory::updateCredit(const Time &now)
+    {
+      double maxCredit = static_cast<double>(mSettings.mMaxResendBytesPerSecond);
+
+      if (Time() != mLastCreditUpdate) {
+        if (now > mLastCreditUpdate) {
+          mCredit += maxCredit * static_cast<double>(zsLib::toMilliseconds(now - mLastCreditUpdate).count()) / 1000.0;
+        }
+      }
+      mLastCreditUpdate = now;
+
+      if (mCredit > maxCredit) mCredit = maxCredit;
+    }
+
+  }
+}
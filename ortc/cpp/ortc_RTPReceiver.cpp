@@ -31,6 +31,7 @@
 
 #include <ortc/internal/ortc_RTPReceiver.h>
 #include <ortc/internal/ortc_RTPReceiverChannel.h>
+#include <ortc/internal/ortc_RTPForwarder.h>
 #include <ortc/internal/ortc_DTLSTransport.h>
 #include <ortc/internal/ortc_RTPListener.h>
 #include <ortc/internal/ortc_MediaStreamTrack.h>
@@ -40,7 +41,9 @@
 #include <ortc/internal/ortc_RTPTypes.h>
 #include <ortc/internal/ortc_SRTPSDESTransport.h>
 #include <ortc/internal/ortc_ORTC.h>
+#include <ortc/internal/ortc_ReceiveLatency.h>
 #include <ortc/internal/ortc_StatsReport.h>
+#include <ortc/internal/ortc_StatsCounters.h>
 #include <ortc/internal/ortc.events.h>
 #include <ortc/internal/platform.h>
 
@@ -79,7 +82,9 @@ namespace ortc
   namespace internal
   {
     ZS_DECLARE_CLASS_PTR(RTPReceiverSettingsDefaults);
+    ZS_DECLARE_TYPEDEF_PTR(IReceiveLatencyForInternal, UseReceiveLatency);
     ZS_DECLARE_TYPEDEF_PTR(IStatsReportForInternal, UseStatsReport);
+    ZS_DECLARE_TYPEDEF_PTR(IStatsCountersForInternal, UseStatsCounters);
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -152,6 +157,10 @@ namespace ortc
         ISettings::setUInt(ORTC_SETTING_RTP_RECEIVER_ONLY_RESOLVE_AMBIGUOUS_PAYLOAD_MAPPING_IF_ACTIVITY_DIFFERS_IN_MILLISECONDS, 5 * 1000);
 
         ISettings::setUInt(ORTC_SETTING_RTP_RECEIVER_LOCK_TO_RECEIVER_CHANNEL_AFTER_SWITCH_EXCLUSIVELY_FOR_IN_MILLISECONDS, 3 * 1000);
+
+        ISettings::setBool(ORTC_SETTING_RTP_RECEIVER_DECODE_ONLY_ACTIVE_CHANNEL, true);
+        ISettings::setUInt(ORTC_SETTING_RTP_RECEIVER_CHANNEL_WARM_UP_TIMEOUT_IN_MILLISECONDS, 1000);
+        ISettings::setUInt(ORTC_SETTING_RTP_RECEIVER_MIN_KEY_FRAME_REQUEST_INTERVAL_IN_MILLISECONDS, 500);
       }
       
     };
@@ -207,6 +216,21 @@ namespace ortc
       return ZS_DYNAMIC_PTR_CAST(RTPReceiver, object)->toDebug();
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPReceiverForRTPForwarder
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr IRTPReceiverForRTPForwarder::toDebug(ForRTPForwarderPtr object)
+    {
+      if (!object) return ElementPtr();
+      return ZS_DYNAMIC_PTR_CAST(RTPReceiver, object)->toDebug();
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -479,6 +503,7 @@ namespace ortc
 
       UseServicesHelper::debugAppend(resultEl, "payload type", mPayloadType);
       UseServicesHelper::debugAppend(resultEl, "codec type", toString(mCodecType));
+      UseServicesHelper::debugAppend(resultEl, "supported codec", IRTPTypes::toString(mSupportedCodec));
       if (mOriginalCodec) {
         UseServicesHelper::debugAppend(resultEl, "original codec payload type", mOriginalCodec->mPayloadType);
       }
@@ -524,9 +549,13 @@ namespace ortc
       mMaxBufferedRTPPackets(SafeInt<decltype(mMaxBufferedRTPPackets)>(ISettings::getUInt(ORTC_SETTING_RTP_RECEIVER_MAX_RTP_PACKETS_IN_BUFFER))),
       mMaxRTPPacketAge(ISettings::getUInt(ORTC_SETTING_RTP_RECEIVER_MAX_AGE_RTP_PACKETS_IN_SECONDS)),
       mLockAfterSwitchTime(ISettings::getUInt(ORTC_SETTING_RTP_RECEIVER_LOCK_TO_RECEIVER_CHANNEL_AFTER_SWITCH_EXCLUSIVELY_FOR_IN_MILLISECONDS)),
+      mDecodeOnlyActiveChannel(ISettings::getBool(ORTC_SETTING_RTP_RECEIVER_DECODE_ONLY_ACTIVE_CHANNEL)),
+      mChannelWarmUpTimeout(ISettings::getUInt(ORTC_SETTING_RTP_RECEIVER_CHANNEL_WARM_UP_TIMEOUT_IN_MILLISECONDS)),
+      mMinKeyFrameRequestInterval(ISettings::getUInt(ORTC_SETTING_RTP_RECEIVER_MIN_KEY_FRAME_REQUEST_INTERVAL_IN_MILLISECONDS)),
       mAmbiguousPayloadMappingMinDifference(ISettings::getUInt(ORTC_SETTING_RTP_RECEIVER_ONLY_RESOLVE_AMBIGUOUS_PAYLOAD_MAPPING_IF_ACTIVITY_DIFFERS_IN_MILLISECONDS)),
       mSSRCTableExpires(Seconds(ISettings::getUInt(ORTC_SETTING_RTP_RECEIVER_SSRC_TIMEOUT_IN_SECONDS))),
-      mContributingSourcesExpiry(Seconds(ISettings::getUInt(ORTC_SETTING_RTP_RECEIVER_CSRC_EXPIRY_TIME_IN_SECONDS)))
+      mContributingSourcesExpiry(Seconds(ISettings::getUInt(ORTC_SETTING_RTP_RECEIVER_CSRC_EXPIRY_TIME_IN_SECONDS))),
+      mForwarders(make_shared<ForwarderWeakMap>())
     {
       ZS_LOG_DETAIL(debug("created"))
 
@@ -578,6 +607,8 @@ namespace ortc
 
       mRTCPTransportSubscription = mRTCPTransport->subscribe(mThisWeak.lock());
 
+      mStatsCounters = UseStatsCounters::registerObject(mID, IStatsReportTypes::StatsType_InboundRTP);
+
       IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
     }
 
@@ -617,6 +648,12 @@ namespace ortc
       return ZS_DYNAMIC_PTR_CAST(RTPReceiver, object);
     }
 
+    //-------------------------------------------------------------------------
+    RTPReceiverPtr RTPReceiver::convert(ForRTPForwarderPtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(RTPReceiver, object);
+    }
+
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -1342,8 +1379,9 @@ namespace ortc
           CodecInfo info;
           info.mPayloadType = codec.mPayloadType;
           info.mOriginalCodecParams = &codec;
+          info.mSupportedCodec = IRTPTypes::toSupportedCodec(codec.mName);
 
-          switch (IRTPTypes::toSupportedCodec(codec.mName))
+          switch (info.mSupportedCodec)
           {
             case SupportedCodec_Unknown:
 
@@ -1458,7 +1496,7 @@ namespace ortc
         mParameters = parameters;
 
         mParametersGroupedIntoChannels.clear();
-        RTPTypesHelper::splitParamsIntoChannels(*parameters, mParametersGroupedIntoChannels);
+        RTPTypesHelper::splitParamsIntoChannels(*parameters, oldGroupedParams, mParametersGroupedIntoChannels);
 
         ParametersPtrPairList unchangedChannels;
         ParametersPtrList newChannels;
@@ -1483,23 +1521,8 @@ namespace ortc
           }
         }
 
-        // scope: swap out new / old parameters
-        {
-          for (auto iter = unchangedChannels.begin(); iter != unchangedChannels.end(); ++iter) {
-            auto &pairInfo = (*iter);
-            auto &oldParams = pairInfo.first;
-            auto &newParams = pairInfo.second;
-            auto found = mChannelInfos.find(oldParams);
-            ASSERT(found != mChannelInfos.end())
-
-            if (found == mChannelInfos.end()) continue;
-
-            auto channelInfo = (*found).second;
-
-            mChannelInfos.erase(found);
-            mChannelInfos[newParams] = channelInfo;
-          }
-        }
+        // unchanged channels stay keyed by their existing parameters
+        RTPTypesHelper::adoptUnchangedChannels(mParametersGroupedIntoChannels, unchangedChannels);
 
         // scope: update existing channels
         {
@@ -1556,6 +1579,11 @@ namespace ortc
 
       registerHeaderExtensions(*mParameters);
 
+      for (auto iter = mForwarders->begin(); iter != mForwarders->end(); ++iter) {
+        auto forwarder = (*iter).second.lock();
+        if (forwarder) forwarder->notifyParametersChanged();
+      }
+
       promise->resolve();
       return promise;
     }
@@ -1576,12 +1604,8 @@ namespace ortc
     {
       ContributingSourceList result;
 
-      AutoRecursiveLock lock(*this);
-
-      for (auto iter = mContributingSources.begin(); iter != mContributingSources.end(); ++iter) {
-        auto &source = (*iter).second;
-        result.push_back(source);
-      }
+      // no lock required (table entries are updated atomically)
+      mContributingSources.getSources(result);
 
       ZS_LOG_TRACE(log("get contributing sources") + ZS_PARAM("total", result.size()))
       return result;
@@ -1607,6 +1631,8 @@ namespace ortc
                                    RTPPacketPtr packet
                                    )
     {
+      UseReceiveLatency::stage(IReceiveLatencyTypes::Stage_RTPReceiver);
+
       ZS_EVENTING_5(
                     x, i, Trace, RtpReceivedIncomingPacket, ol, RtpReceiver, Receive, 
                     puid, id, mID,
@@ -1619,7 +1645,16 @@ namespace ortc
 
       ZS_LOG_TRACE(log("received packet") + ZS_PARAM("via", IICETypes::toString(viaTransport)) + packet->toDebug())
 
+      if (mStatsCounters) {
+        mStatsCounters->increment(IStatsCountersTypes::Counter_PacketsReceived);
+        mStatsCounters->increment(IStatsCountersTypes::Counter_BytesReceived, packet->size());
+      }
+
       ChannelHolderPtr channelHolder;
+      ForwarderWeakMapPtr forwarders;
+      bool forwardExclusively = false;
+      bool deliverToChannel = true;
+      ContributingSourceUpdates contributingSources;
 
       {
         AutoRecursiveLock lock(*this);
@@ -1631,7 +1666,9 @@ namespace ortc
 
         String rid;
         if (findMapping(*packet, channelHolder, rid)) {
-          postFindMappingProcessPacket(*packet, channelHolder);
+          deliverToChannel = postFindMappingProcessPacket(*packet, channelHolder, contributingSources);
+          forwarders = mForwarders; // obtain pointer to COW list while inside a lock
+          forwardExclusively = (mExclusiveForwarders.size() > 0);
           goto process_rtp;
         }
 
@@ -1655,18 +1692,9 @@ namespace ortc
 
     process_rtp:
       {
-        ZS_LOG_TRACE(log("forwarding RTP packet to channel") + ZS_PARAM("channel id", channelHolder->getID()) + ZS_PARAM("ssrc", packet->ssrc()));
-        ZS_EVENTING_6(
-                      x, i, Trace, RtpReceiverDeliverIncomingPacketToChannel, ol, RtpReceiver, Deliver,
-                      puid, id, mID,
-                      puid, channelObjectId, channelHolder->getID(),
-                      enum, viaTransport, zsLib::to_underlying(viaTransport),
-                      enum, packetType, zsLib::to_underlying(IICETypes::Component_RTP),
-                      buffer, packet, packet->buffer()->BytePtr(),
-                      size, size, packet->buffer()->SizeInBytes()
-                      );
+        if (0 != contributingSources.mCount) setContributingSources(contributingSources);
 
-        return channelHolder->handle(packet);
+        return deliverPacket(viaTransport, packet, channelHolder, forwarders, forwardExclusively, deliverToChannel);
       }
 
       return false; // return true if packet was handled
@@ -1690,15 +1718,24 @@ namespace ortc
       ZS_LOG_TRACE(log("received packet") + ZS_PARAM("via", IICETypes::toString(viaTransport)) + packet->toDebug());
 
       ChannelWeakMapPtr channels;
+      ForwarderWeakMapPtr forwarders;
 
       {
         AutoRecursiveLock lock(*this);
         channels = mChannels; // obtain pointer to COW list while inside a lock
+        forwarders = mForwarders;
 
         processByes(*packet);
         processSenderReports(*packet);
       }
 
+      if (NULL != packet->firstSenderReport()) {
+        for (auto iter = forwarders->begin(); iter != forwarders->end(); ++iter) {
+          auto forwarder = (*iter).second.lock();
+          if (forwarder) forwarder->forwardPacket(packet);
+        }
+      }
+
       bool clean = false;
       auto result = false;
       for (auto iter = channels->begin(); iter != channels->end(); ++iter)
@@ -1782,6 +1819,64 @@ namespace ortc
     #pragma mark RTPReceiver => IRTPReceiverForRTPReceiverChannel
     #pragma mark
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPReceiver => IRTPReceiverForRTPForwarder
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    IRTPTypes::ParametersPtr RTPReceiver::getParameters() const
+    {
+      AutoRecursiveLock lock(*this);
+      return mParameters;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::registerForwarder(
+                                        UseForwarderPtr forwarder,
+                                        bool exclusive
+                                        )
+    {
+      ZS_LOG_DEBUG(log("register forwarder") + ZS_PARAM("forwarder", forwarder->getID()) + ZS_PARAM("exclusive", exclusive))
+
+      AutoRecursiveLock lock(*this);
+
+      if (isShutdown()) {
+        ZS_LOG_WARNING(Debug, log("cannot register forwarder while shutdown"))
+        return;
+      }
+
+      ForwarderWeakMapPtr replacementForwarders = make_shared<ForwarderWeakMap>(*mForwarders);
+      (*replacementForwarders)[forwarder->getID()] = forwarder;
+      mForwarders = replacementForwarders;  // COW replacement
+
+      if (exclusive) {
+        mExclusiveForwarders.insert(forwarder->getID());
+      } else {
+        mExclusiveForwarders.erase(forwarder->getID());
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::unregisterForwarder(PUID forwarderID)
+    {
+      ZS_LOG_DEBUG(log("unregister forwarder") + ZS_PARAM("forwarder", forwarderID))
+
+      AutoRecursiveLock lock(*this);
+
+      auto found = mForwarders->find(forwarderID);
+      if (found == mForwarders->end()) return;
+
+      ForwarderWeakMapPtr replacementForwarders = make_shared<ForwarderWeakMap>(*mForwarders);
+      replacementForwarders->erase(forwarderID);
+      mForwarders = replacementForwarders;  // COW replacement
+
+      mExclusiveForwarders.erase(forwarderID);
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -1887,13 +1982,14 @@ namespace ortc
       if (timer == mContributingSourcesTimer) {
         auto tick = zsLib::now();
 
-        for (auto iter_doNotUse = mContributingSources.begin(); iter_doNotUse != mContributingSources.end(); ) {
-          auto current = iter_doNotUse;
-          ++iter_doNotUse;
-
-          auto &source = (*current).second;
+        ContributingSourceList expired;
+        {
+          AutoLock csrcLock(mContributingSourcesLock);
+          mContributingSources.expire(tick - mContributingSourcesExpiry, expired);
+        }
 
-          if (source.mTimestamp + mContributingSourcesExpiry > tick) continue;
+        for (auto iter = expired.begin(); iter != expired.end(); ++iter) {
+          auto &source = (*iter);
 
           ZS_LOG_TRACE(log("expiring contributing source") + source.toDebug());
 
@@ -1904,8 +2000,6 @@ namespace ortc
                         byte, audioLevel, source.mAudioLevel,
                         bool, voiceActivityFlag, source.mVoiceActivityFlag.hasValue() ? source.mVoiceActivityFlag.value() : false
                         );
-
-          mContributingSources.erase(current);
         }
         return;
       }
@@ -1921,6 +2015,58 @@ namespace ortc
     #pragma mark RTPReceiver => IRTPReceiverAsyncDelegate
     #pragma mark
 
+    //-------------------------------------------------------------------------
+    void RTPReceiver::onRequestKeyFrame(SSRCType ssrc)
+    {
+      typedef RTCPPacket::PayloadSpecificFeedbackMessage PayloadSpecificFeedbackMessage;
+      typedef RTCPPacket::PayloadSpecificFeedbackMessage::PLI PLI;
+
+      ZS_LOG_DEBUG(log("requesting key frame to warm up channel") + ZS_PARAM("ssrc", ssrc))
+
+      PayloadSpecificFeedbackMessage pli;
+
+      {
+        AutoRecursiveLock lock(*this);
+        if (isShutdown()) return;
+
+        pli.mSSRCOfPacketSender = (mParameters ? mParameters->mRTCP.mSSRC : 0);
+      }
+
+      pli.mVersion = 2;
+      pli.mPT = PayloadSpecificFeedbackMessage::kPayloadType;
+      pli.mReportSpecific = PLI::kFmt;
+      pli.mSSRCOfMediaSource = ssrc;
+
+      auto packet = RTCPPacket::create(&pli);
+      if (!packet) return;
+
+      sendPacket(packet);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::onDeliverBufferedPackets()
+    {
+      BufferedDeliveryList deliveries;
+      ForwarderWeakMapPtr forwarders;
+      bool forwardExclusively = false;
+
+      {
+        AutoRecursiveLock lock(*this);
+        if (isShutdown()) return;
+
+        deliveries.swap(mPendingBufferedDeliveries);
+        forwarders = mForwarders; // obtain pointer to COW list while inside a lock
+        forwardExclusively = (mExclusiveForwarders.size() > 0);
+      }
+
+      // warning: do NOT call from within a lock
+      for (auto iter = deliveries.begin(); iter != deliveries.end(); ++iter) {
+        auto &delivery = (*iter);
+        ZS_LOG_TRACE(log("will attempt to deliver buffered RTP packet") + ZS_PARAM("channel", delivery.mChannelHolder->getID()) + ZS_PARAM("ssrc", delivery.mPacket->ssrc()))
+        deliverPacket(IICETypes::Component_RTP, delivery.mPacket, delivery.mChannelHolder, forwarders, forwardExclusively, delivery.mDeliverToChannel);
+      }
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -1998,6 +2144,8 @@ namespace ortc
       UseServicesHelper::debugAppend(resultEl, "params grouped into channels", mParametersGroupedIntoChannels.size());
 
       UseServicesHelper::debugAppend(resultEl, "channels", mChannels->size());
+      UseServicesHelper::debugAppend(resultEl, "forwarders", mForwarders->size());
+      UseServicesHelper::debugAppend(resultEl, "exclusive forwarders", mExclusiveForwarders.size());
       UseServicesHelper::debugAppend(resultEl, "clean channels", mCleanChannels);
 
       UseServicesHelper::debugAppend(resultEl, "channel infos", mChannelInfos.size());
@@ -2016,7 +2164,8 @@ namespace ortc
       UseServicesHelper::debugAppend(resultEl, "buffered rtp packets", mBufferedRTPPackets.size());
       UseServicesHelper::debugAppend(resultEl, "reattempt delivery", mReattemptRTPDelivery);
 
-      UseServicesHelper::debugAppend(resultEl, "contributing sources", mContributingSources.size());
+      UseServicesHelper::debugAppend(resultEl, "has audio level extensions", mHasAudioLevelExtensions);
+      UseServicesHelper::debugAppend(resultEl, "contributing sources", mContributingSources.toDebug());
       UseServicesHelper::debugAppend(resultEl, "contributing sources expiry", mContributingSourcesExpiry);
       UseServicesHelper::debugAppend(resultEl, "contributing source timer", mContributingSourcesTimer ? mContributingSourcesTimer->getID() : 0);
 
@@ -2024,6 +2173,13 @@ namespace ortc
       UseServicesHelper::debugAppend(resultEl, "last switched current channel", mLastSwitchedCurrentChannel);
       UseServicesHelper::debugAppend(resultEl, "lock after switch time", mLockAfterSwitchTime);
 
+      UseServicesHelper::debugAppend(resultEl, "decode only active channel", mDecodeOnlyActiveChannel);
+      UseServicesHelper::debugAppend(resultEl, "channel warm up timeout", mChannelWarmUpTimeout);
+      UseServicesHelper::debugAppend(resultEl, "warming channel", mWarmingChannel ? mWarmingChannel->getID() : 0);
+      UseServicesHelper::debugAppend(resultEl, "warming started", mWarmingStarted);
+      UseServicesHelper::debugAppend(resultEl, "min key frame request interval", mMinKeyFrameRequestInterval);
+      UseServicesHelper::debugAppend(resultEl, "last key frame requests", mLastKeyFrameRequests.size());
+
       UseServicesHelper::debugAppend(resultEl, "ambiguous payload mapping min difference", mAmbiguousPayloadMappingMinDifference);
 
       return resultEl;
@@ -2106,10 +2262,16 @@ namespace ortc
           String rid;
           if (!findMapping(*packet, channelHolder, rid)) continue;
 
-          postFindMappingProcessPacket(*packet, channelHolder);
+          // buffered packets take the same forwarder and exclusive checks
+          // as live packets (but are delivered outside the lock)
+          BufferedDelivery delivery;
+          ContributingSourceUpdates contributingSources;
+          delivery.mPacket = packet;
+          delivery.mChannelHolder = channelHolder;
+          delivery.mDeliverToChannel = postFindMappingProcessPacket(*packet, channelHolder, contributingSources);
+          mPendingBufferedDeliveries.push_back(delivery);
 
-          ZS_LOG_TRACE(log("will attempt to deliver buffered RTP packet") + ZS_PARAM("channel", channelHolder->getID()) + ZS_PARAM("ssrc", packet->ssrc()))
-          channelHolder->notify(packet);
+          if (0 != contributingSources.mCount) setContributingSources(contributingSources);
 
           mBufferedRTPPackets.erase(current);
         }
@@ -2120,6 +2282,10 @@ namespace ortc
       } while ((beforeSize != mBufferedRTPPackets.size()) &&
                (0 != mBufferedRTPPackets.size()));
 
+      if (mPendingBufferedDeliveries.size() > 0) {
+        IRTPReceiverAsyncDelegateProxy::create(mThisWeak.lock())->onDeliverBufferedPackets();
+      }
+
       return true;
     }
 
@@ -2197,11 +2363,15 @@ namespace ortc
       ChannelWeakMapPtr channels = ChannelWeakMapPtr(make_shared<ChannelWeakMap>());
       mChannels = channels;
 
+      mForwarders = make_shared<ForwarderWeakMap>();
+      mExclusiveForwarders.clear();
+
       if (mParameters) {
         mListener->unregisterReceiver(*this);
       }
 
       mRegisteredExtensions.clear();
+      mHasAudioLevelExtensions = false;
 
       mChannelInfos.clear();
       mSSRCRoutingPayloadTable.clear();
@@ -2214,8 +2384,12 @@ namespace ortc
       }
 
       mBufferedRTPPackets.clear();
+      mPendingBufferedDeliveries.clear();
 
-      mContributingSources.clear();
+      {
+        AutoLock csrcLock(mContributingSourcesLock);
+        mContributingSources.clear();
+      }
       if (mContributingSourcesTimer) {
         mContributingSourcesTimer->cancel();
         mContributingSourcesTimer.reset();
@@ -2554,6 +2728,13 @@ namespace ortc
         }
       }
 
+      if (mWarmingChannel) {
+        if (mWarmingChannel->mChannelInfo->mID == channelInfo.mID) {
+          mWarmingChannel.reset();
+          mWarmingStarted = Time();
+        }
+      }
+
       ChannelWeakMapPtr replacementChannels(make_shared<ChannelWeakMap>(*mChannels));
 
       for (auto iter_doNotUse = replacementChannels->begin(); iter_doNotUse != replacementChannels->end(); )
@@ -2587,6 +2768,7 @@ namespace ortc
     void RTPReceiver::registerHeaderExtensions(const Parameters &params)
     {
       mRegisteredExtensions.clear();
+      mHasAudioLevelExtensions = false;
 
       for (auto iter = mParameters->mHeaderExtensions.begin(); iter != mParameters->mHeaderExtensions.end(); ++iter) {
         auto &ext = (*iter);
@@ -2612,6 +2794,12 @@ namespace ortc
                       );
 
         mRegisteredExtensions[newExt.mLocalID] = newExt;
+
+        switch (newExt.mHeaderExtensionURI) {
+          case IRTPTypes::HeaderExtensionURI_ClienttoMixerAudioLevelIndication:
+          case IRTPTypes::HeaderExtensionURI_MixertoClientAudioLevelIndication:   mHasAudioLevelExtensions = true; break;
+          default:                                                                break;
+        }
       }
     }
 
@@ -3913,8 +4101,26 @@ namespace ortc
     }
 
     //-------------------------------------------------------------------------
-    void RTPReceiver::extractCSRCs(const RTPPacket &rtpPacket)
+    void RTPReceiver::extractCSRCs(
+                                   const RTPPacket &rtpPacket,
+                                   ContributingSourceUpdates &outUpdates
+                                   )
     {
+      // fast path: audio levels are the only source of contributing source information
+      if (!mHasAudioLevelExtensions) return;
+      if (NULL == rtpPacket.firstHeaderExtension()) return;
+
+      outUpdates.mTime = zsLib::now();
+
+      auto add = [&outUpdates](SSRCType csrc, BYTE level, const Optional<bool> &voiceActivityFlag) {
+        if (outUpdates.mCount >= ContributingSourceUpdates::kMaxUpdates) return;
+        auto &update = outUpdates.mUpdates[outUpdates.mCount];
+        update.mCSRC = csrc;
+        update.mLevel = level;
+        update.mVoiceActivityFlag = voiceActivityFlag;
+        ++outUpdates.mCount;
+      };
+
       for (auto ext = rtpPacket.firstHeaderExtension(); NULL != ext; ext = ext->mNext) {
         LocalID localID = static_cast<LocalID>(ext->mID);
         auto found = mRegisteredExtensions.find(localID);
@@ -3927,7 +4133,7 @@ namespace ortc
             RTPPacket::ClientToMixerExtension levelExt(*ext);
             auto level = levelExt.level();
             Optional<bool> voiceActivity(levelExt.voiceActivity());
-            setContributingSource(rtpPacket.ssrc(), level, voiceActivity);
+            add(rtpPacket.ssrc(), level, voiceActivity);
             break;
           }
           case IRTPTypes::HeaderExtensionURI_MixertoClientAudioLevelIndication:   {
@@ -3935,7 +4141,7 @@ namespace ortc
             for (size_t index = 0; (index < levelExt.levelsCount()) && (index < rtpPacket.cc()); ++index) {
               auto level = levelExt.level(index);
               Optional<bool> voiceActivity {};
-              setContributingSource(rtpPacket.getCSRC(index) , level, voiceActivity);
+              add(rtpPacket.getCSRC(index), level, voiceActivity);
             }
             break;
           }
@@ -3947,48 +4153,41 @@ namespace ortc
     }
     
     //-------------------------------------------------------------------------
-    void RTPReceiver::setContributingSource(
-                                            SSRCType csrc,
-                                            BYTE level,
-                                            const Optional<bool> &voiceActivityFlag
-                                            )
+    void RTPReceiver::setContributingSources(const ContributingSourceUpdates &updates)
     {
-      auto found = mContributingSources.find(csrc);
-      if (found == mContributingSources.end()) {
-        ContributingSource source;
-        source.mCSRC = csrc;
-        source.mTimestamp = zsLib::now();
-        source.mAudioLevel = level;
-        source.mVoiceActivityFlag = voiceActivityFlag;
-        mContributingSources[csrc] = source;
+      // NOTE: only the table's own writer lock is needed (the receiver lock
+      //       need not be held)
+      AutoLock csrcLock(mContributingSourcesLock);
+
+      for (size_t index = 0; index < updates.mCount; ++index) {
+        auto &update = updates.mUpdates[index];
+
+        if (mContributingSources.update(update.mCSRC, updates.mTime, update.mLevel, update.mVoiceActivityFlag)) {
+          ZS_EVENTING_4(
+                        x, i, Trace, RtpReceiverAddContributingSource, ol, RtpReceiver, Info,
+                        puid, id, mID,
+                        dword, csrc, update.mCSRC,
+                        byte, level, update.mLevel,
+                        bool, voiceActivityFlag, update.mVoiceActivityFlag.hasValue() ? update.mVoiceActivityFlag.value() : false
+                        );
+          continue;
+        }
+
         ZS_EVENTING_4(
-                      x, i, Trace, RtpReceiverAddContributingSource, ol, RtpReceiver, Info,
+                      x, i, Trace, RtpReceiverUpdateContributingSource, ol, RtpReceiver, Info,
                       puid, id, mID,
-                      dword, csrc, csrc,
-                      byte, level, level,
-                      bool, voiceActivityFlag, voiceActivityFlag.hasValue() ? voiceActivityFlag.value() : false
+                      dword, csrc, update.mCSRC,
+                      byte, level, update.mLevel,
+                      bool, voiceActivityFlag, update.mVoiceActivityFlag.hasValue() ? update.mVoiceActivityFlag.value() : false
                       );
-        return;
       }
-
-      auto &source = (*found).second;
-
-      source.mTimestamp = zsLib::now();
-      source.mAudioLevel = level;
-      source.mVoiceActivityFlag = voiceActivityFlag;
-      ZS_EVENTING_4(
-                    x, i, Trace, RtpReceiverUpdateContributingSource, ol, RtpReceiver, Info,
-                    puid, id, mID,
-                    dword, csrc, csrc,
-                    byte, level, level,
-                    bool, voiceActivityFlag, voiceActivityFlag.hasValue() ? voiceActivityFlag.value() : false
-                    );
     }
 
     //-------------------------------------------------------------------------
-    void RTPReceiver::postFindMappingProcessPacket(
+    bool RTPReceiver::postFindMappingProcessPacket(
                                                    const RTPPacket &rtpPacket,
-                                                   ChannelHolderPtr &channelHolder
+                                                   ChannelHolderPtr &channelHolder,
+                                                   ContributingSourceUpdates &outContributingSources
                                                    )
     {
       ASSERT(channelHolder)
@@ -3998,12 +4197,19 @@ namespace ortc
 
       if (!encoding.mActive) {
         ZS_LOG_WARNING(Trace, log("encoding is not active thus do not process information from this channel"))
-        return;
+        return true;
       }
 
-      extractCSRCs(rtpPacket);
+      extractCSRCs(rtpPacket, outContributingSources);
 
-      if (channelHolder == mCurrentChannel) return;
+      if (channelHolder == mCurrentChannel) return true;
+
+      // Only the current channel of a video receiver with multiple channels
+      // (i.e. simulcast / SVC layers) is fed to a decoder; the other channels
+      // are kept on standby and only watched for key frames.
+      bool standby = (mDecodeOnlyActiveChannel) &&
+                     (IMediaStreamTrackTypes::Kind_Video == mKind) &&
+                     ((bool)mCurrentChannel);
 
       Time tick = zsLib::now();
 
@@ -4011,11 +4217,97 @@ namespace ortc
         if (Time() != mLastSwitchedCurrentChannel) {
           if (mLastSwitchedCurrentChannel + mLockAfterSwitchTime > tick) {
             ZS_LOG_INSANE(log("cannot switch channel (as locked out after last switch)"))
-            return;
+            return !standby;
           }
         }
       }
 
+      if (!standby) {
+        switchActiveReceiverChannel(channelHolder, tick);
+        return true;
+      }
+
+      bool warmingExpired = (mWarmingStarted + mChannelWarmUpTimeout <= tick);
+
+      if (channelHolder != mWarmingChannel) {
+        // only one candidate is warmed up at a time; other standby channels
+        // wait until the candidate goes live or its warm up times out
+        if ((mWarmingChannel) &&
+            (!warmingExpired)) return false;
+
+        ZS_LOG_DEBUG(log("warming up channel before switching") + ZS_PARAM("channel", channelHolder->getID()) + ZS_PARAM("ssrc", rtpPacket.ssrc()) + ZS_PARAM("replacing", mWarmingChannel ? mWarmingChannel->getID() : 0))
+        mWarmingChannel = channelHolder;
+        mWarmingStarted = tick;
+        warmingExpired = false;
+      }
+
+      if (!isKeyFrameStart(rtpPacket)) {
+        if (!warmingExpired) {
+          requestKeyFrame(rtpPacket.ssrc(), tick);
+          return false;
+        }
+        ZS_LOG_WARNING(Debug, log("no key frame arrived while warming up channel (thus switching anyway)") + ZS_PARAM("channel", channelHolder->getID()))
+      }
+
+      switchActiveReceiverChannel(channelHolder, tick);
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPReceiver::deliverPacket(
+                                    IICETypes::Components viaTransport,
+                                    RTPPacketPtr packet,
+                                    ChannelHolderPtr channelHolder,
+                                    ForwarderWeakMapPtr forwarders,
+                                    bool forwardExclusively,
+                                    bool deliverToChannel
+                                    )
+    {
+      // warning: do NOT call from within a lock
+
+      if (forwarders->size() > 0) {
+        bool forwarded = false;
+        for (auto iter = forwarders->begin(); iter != forwarders->end(); ++iter) {
+          auto forwarder = (*iter).second.lock();
+          if (!forwarder) continue;
+          auto forwarderResult = forwarder->forwardPacket(packet);
+          forwarded = forwarded || forwarderResult;
+        }
+
+        if (forwardExclusively) {
+          ZS_LOG_INSANE(log("packet forwarded exclusively (not delivered to channel)") + ZS_PARAM("ssrc", packet->ssrc()))
+          return forwarded;
+        }
+      }
+
+      if (!deliverToChannel) {
+        ZS_LOG_INSANE(log("channel is on standby (packet not delivered for decoding)") + ZS_PARAM("channel id", channelHolder->getID()) + ZS_PARAM("ssrc", packet->ssrc()))
+        return true;
+      }
+
+      ZS_LOG_TRACE(log("forwarding RTP packet to channel") + ZS_PARAM("channel id", channelHolder->getID()) + ZS_PARAM("ssrc", packet->ssrc()));
+      ZS_EVENTING_6(
+                    x, i, Trace, RtpReceiverDeliverIncomingPacketToChannel, ol, RtpReceiver, Deliver,
+                    puid, id, mID,
+                    puid, channelObjectId, channelHolder->getID(),
+                    enum, viaTransport, zsLib::to_underlying(viaTransport),
+                    enum, packetType, zsLib::to_underlying(IICETypes::Component_RTP),
+                    buffer, packet, packet->buffer()->BytePtr(),
+                    size, size, packet->buffer()->SizeInBytes()
+                    );
+
+      return channelHolder->handle(packet);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::switchActiveReceiverChannel(
+                                                  ChannelHolderPtr &channelHolder,
+                                                  const Time &tick
+                                                  )
+    {
+      mWarmingChannel.reset();
+      mWarmingStarted = Time();
+
       mLastSwitchedCurrentChannel = tick;
       mCurrentChannel = channelHolder;
 
@@ -4031,6 +4323,9 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPReceiver::resetActiveReceiverChannel()
     {
+      mWarmingChannel.reset();
+      mWarmingStarted = Time();
+
       if (!mCurrentChannel) return;
 
       mCurrentChannel.reset();
@@ -4046,6 +4341,63 @@ namespace ortc
       mTrack->notifyActiveReceiverChannel(RTPReceiverChannelPtr());
     }
 
+    //-------------------------------------------------------------------------
+    void RTPReceiver::requestKeyFrame(
+                                      SSRCType ssrc,
+                                      const Time &tick
+                                      )
+    {
+      for (auto iter_doNotUse = mLastKeyFrameRequests.begin(); iter_doNotUse != mLastKeyFrameRequests.end(); ) {
+        auto current = iter_doNotUse;
+        ++iter_doNotUse;
+
+        if ((*current).second + mMinKeyFrameRequestInterval > tick) continue;
+        mLastKeyFrameRequests.erase(current);
+      }
+
+      auto found = mLastKeyFrameRequests.find(ssrc);
+      if (found != mLastKeyFrameRequests.end()) {
+        ZS_LOG_INSANE(log("key frame recently requested (thus not requesting again)") + ZS_PARAM("ssrc", ssrc))
+        return;
+      }
+
+      mLastKeyFrameRequests[ssrc] = tick;
+      IRTPReceiverAsyncDelegateProxy::create(mThisWeak.lock())->onRequestKeyFrame(ssrc);
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPReceiver::isKeyFrameStart(const RTPPacket &rtpPacket)
+    {
+      auto found = mCodecInfos.find(rtpPacket.pt());
+      if (found == mCodecInfos.end()) return false;
+
+      auto &codecInfo = (*found).second;
+
+      switch (codecInfo.mCodecType) {
+        case CodecType_Normal:
+        {
+          return RTPTypesHelper::isKeyFrameStart(codecInfo.mSupportedCodec, rtpPacket.payload(), rtpPacket.payloadSize());
+        }
+        case CodecType_RED:
+        {
+          const BYTE *innerPayload = NULL;
+          size_t innerPayloadSize = 0;
+          Optional<PayloadType> innerPayloadType = RTPTypesHelper::getRedCodecPayload(rtpPacket.payload(), rtpPacket.payloadSize(), innerPayload, innerPayloadSize);
+          if (!innerPayloadType.hasValue()) return false;
+
+          auto foundInner = mCodecInfos.find(innerPayloadType.value());
+          if (foundInner == mCodecInfos.end()) return false;
+          if (CodecType_Normal != (*foundInner).second.mCodecType) return false;
+
+          return RTPTypesHelper::isKeyFrameStart((*foundInner).second.mSupportedCodec, innerPayload, innerPayloadSize);
+        }
+        case CodecType_ULPFEC:
+        case CodecType_FlexFEC:
+        case CodecType_RTX:       break;
+      }
+      return false;
+    }
+
     //-------------------------------------------------------------------------
     Optional<RTPReceiver::RoutingPayloadType> RTPReceiver::decodeREDRoutingPayloadType(
                                                                                        const BYTE *buffer,
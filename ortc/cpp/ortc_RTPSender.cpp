@@ -31,6 +31,7 @@
 
 #include <ortc/internal/ortc_RTPSender.h>
 #include <ortc/internal/ortc_RTPSenderChannel.h>
+#include <ortc/internal/ortc_RTPForwarder.h>
 #include <ortc/internal/ortc_DTLSTransport.h>
 #include <ortc/internal/ortc_ISecureTransport.h>
 #include <ortc/internal/ortc_RTPListener.h>
@@ -41,6 +42,8 @@
 #include <ortc/internal/ortc_RTPTypes.h>
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc_StatsReport.h>
+#include <ortc/internal/ortc_StatsCounters.h>
+#include <ortc/internal/ortc_RTPUtils.h>
 #include <ortc/internal/ortc.events.h>
 #include <ortc/internal/platform.h>
 
@@ -82,6 +85,7 @@ namespace ortc
     ZS_DECLARE_CLASS_PTR(RTPSenderSettingsDefaults);
 
     ZS_DECLARE_TYPEDEF_PTR(IStatsReportForInternal, UseStatsReport);
+    ZS_DECLARE_TYPEDEF_PTR(IStatsCountersForInternal, UseStatsCounters);
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -127,6 +131,13 @@ namespace ortc
       //-----------------------------------------------------------------------
       virtual void notifySettingsApplyDefaults() override
       {
+        ISettings::setBool(ORTC_SETTING_RTP_SENDER_GROUP_SIMULCAST_VIDEO_ENCODINGS, true);
+
+        ISettings::setUInt(ORTC_SETTING_RTP_SENDER_NACK_HISTORY_MAX_PACKETS, 512);
+        ISettings::setUInt(ORTC_SETTING_RTP_SENDER_NACK_HISTORY_MAX_AGE_IN_MILLISECONDS, 1000);
+        ISettings::setUInt(ORTC_SETTING_RTP_SENDER_NACK_HISTORY_MIN_RESEND_INTERVAL_IN_MILLISECONDS, 10);
+        ISettings::setUInt(ORTC_SETTING_RTP_SENDER_NACK_HISTORY_MAX_RESENDS_PER_PACKET, 5);
+        ISettings::setUInt(ORTC_SETTING_RTP_SENDER_NACK_HISTORY_MAX_RESEND_BYTES_PER_SECOND, 256*1024);
       }
       
     };
@@ -196,6 +207,21 @@ namespace ortc
       return ZS_DYNAMIC_PTR_CAST(RTPSender, object)->toDebug();
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPSenderForRTPForwarder
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr IRTPSenderForRTPForwarder::toDebug(ForRTPForwarderPtr object)
+    {
+      if (!object) return ElementPtr();
+      return ZS_DYNAMIC_PTR_CAST(RTPSender, object)->toDebug();
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -352,10 +378,17 @@ namespace ortc
       MessageQueueAssociator(queue),
       SharedRecursiveLock(SharedRecursiveLock::create()),
       mChannels(make_shared<ParametersToChannelHolderMap>()),
-      mTrack(MediaStreamTrack::convert(track))
+      mTrack(MediaStreamTrack::convert(track)),
+      mForwarders(make_shared<ForwarderWeakMap>())
     {
       ZS_LOG_DETAIL(debug("created"))
 
+      mPacketHistorySettings.mMaxPackets = ISettings::getUInt(ORTC_SETTING_RTP_SENDER_NACK_HISTORY_MAX_PACKETS);
+      mPacketHistorySettings.mMaxAge = Milliseconds(ISettings::getUInt(ORTC_SETTING_RTP_SENDER_NACK_HISTORY_MAX_AGE_IN_MILLISECONDS));
+      mPacketHistorySettings.mMinResendInterval = Milliseconds(ISettings::getUInt(ORTC_SETTING_RTP_SENDER_NACK_HISTORY_MIN_RESEND_INTERVAL_IN_MILLISECONDS));
+      mPacketHistorySettings.mMaxResendsPerPacket = ISettings::getUInt(ORTC_SETTING_RTP_SENDER_NACK_HISTORY_MAX_RESENDS_PER_PACKET);
+      mPacketHistorySettings.mMaxResendBytesPerSecond = ISettings::getUInt(ORTC_SETTING_RTP_SENDER_NACK_HISTORY_MAX_RESEND_BYTES_PER_SECOND);
+
       mListener = UseListener::getListener(transport);
       ORTC_THROW_INVALID_STATE_IF(!mListener)
 
@@ -378,6 +411,8 @@ namespace ortc
       IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
 
       mRTCPTransportSubscription = mRTCPTransport->subscribe(mThisWeak.lock());
+
+      mStatsCounters = UseStatsCounters::registerObject(mID, IStatsReportTypes::StatsType_OutboundRTP);
     }
 
     //-------------------------------------------------------------------------
@@ -428,6 +463,12 @@ namespace ortc
       return ZS_DYNAMIC_PTR_CAST(RTPSender, object);
     }
 
+    //-------------------------------------------------------------------------
+    RTPSenderPtr RTPSender::convert(ForRTPForwarderPtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(RTPSender, object);
+    }
+
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -745,7 +786,7 @@ namespace ortc
         mParameters = make_shared<Parameters>(parameters);
 
         mParametersGroupedIntoChannels.clear();
-        RTPTypesHelper::splitParamsIntoChannels(parameters, mParametersGroupedIntoChannels);
+        RTPTypesHelper::splitParamsIntoChannels(parameters, oldGroupedParams, mParametersGroupedIntoChannels, shouldGroupSimulcastEncodings());
 
         ParametersToChannelHolderMapPtr replacementChannels = make_shared<ParametersToChannelHolderMap>(*mChannels);
 
@@ -771,22 +812,8 @@ namespace ortc
           }
         }
 
-        // scope: swap out new / old parameters
-        {
-          for (auto iter = unchangedChannels.begin(); iter != unchangedChannels.end(); ++iter) {
-            auto &pairInfo = (*iter);
-            auto &oldParams = pairInfo.first;
-            auto &newParams = pairInfo.second;
-            auto found = replacementChannels->find(oldParams);
-
-            if (found == replacementChannels->end()) continue;  // possible it will not be found (when channel self destructs)
-
-            auto channel = (*found).second;
-
-            replacementChannels->erase(found);
-            (*replacementChannels)[newParams] = channel;
-          }
-        }
+        // unchanged channels stay keyed by their existing parameters
+        RTPTypesHelper::adoptUnchangedChannels(mParametersGroupedIntoChannels, unchangedChannels);
 
         // scope: update existing channels
         {
@@ -821,7 +848,7 @@ namespace ortc
       } else {
         mParameters = make_shared<Parameters>(parameters);
 
-        RTPTypesHelper::splitParamsIntoChannels(parameters, mParametersGroupedIntoChannels);
+        RTPTypesHelper::splitParamsIntoChannels(parameters, mParametersGroupedIntoChannels, shouldGroupSimulcastEncodings());
 
         ParametersToChannelHolderMapPtr replacementChannels = make_shared<ParametersToChannelHolderMap>();
 
@@ -836,9 +863,16 @@ namespace ortc
 
       mParameters = make_shared<Parameters>(parameters);
 
+      updatePacketHistories();
+
       RTCPPacketList historicalRTCPPackets;
       mListener->registerSender(mThisWeak.lock(), *mParameters, historicalRTCPPackets);
 
+      for (auto iter = mForwarders->begin(); iter != mForwarders->end(); ++iter) {
+        auto forwarder = (*iter).second.lock();
+        if (forwarder) forwarder->notifyParametersChanged();
+      }
+
       promise->resolve();
       return promise;
     }
@@ -880,10 +914,21 @@ namespace ortc
       ZS_LOG_TRACE(log("received packet") + ZS_PARAM("via", IICETypes::toString(viaTransport)) + packet->toDebug())
 
       ParametersToChannelHolderMapPtr channels;
+      ForwarderWeakMapPtr forwarders;
+      RTPPacketList resends;
 
       {
         AutoRecursiveLock lock(*this);
         channels = mChannels; // obtain pointer to COW list while inside a lock
+        forwarders = mForwarders;
+
+        if (mPacketHistories.size() > 0) handleNACKs(*packet, resends);
+      }
+
+      if (mStatsCounters) updateStatsCounters(*channels, *packet);
+
+      for (auto iter = resends.begin(); iter != resends.end(); ++iter) {
+        sendPacket(*iter);
       }
 
       bool result = false;
@@ -904,6 +949,15 @@ namespace ortc
         result = result || channelResult;
       }
 
+      for (auto iter = forwarders->begin(); iter != forwarders->end(); ++iter)
+      {
+        auto forwarder = (*iter).second.lock();
+        if (!forwarder) continue;
+
+        auto forwarderResult = forwarder->handleFeedback(packet);
+        result = result || forwarderResult;
+      }
+
       return result;
     }
 
@@ -947,6 +1001,11 @@ namespace ortc
                     size, size, packet->buffer()->SizeInBytes()
                     );
 
+      if (mStatsCounters) {
+        mStatsCounters->increment(IStatsCountersTypes::Counter_PacketsSent);
+        mStatsCounters->increment(IStatsCountersTypes::Counter_BytesSent, packet->size());
+      }
+
       return rtpTransport->sendPacket(mSendRTPOverTransport, IICETypes::Component_RTP, packet->ptr(), packet->size());
     }
 
@@ -1042,6 +1101,70 @@ namespace ortc
     #pragma mark RTPSender => IRTPSenderForMediaStreamTrack
     #pragma mark
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPSender => IRTPSenderForRTPForwarder
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    IRTPTypes::ParametersPtr RTPSender::getParameters() const
+    {
+      AutoRecursiveLock lock(*this);
+      return mParameters;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::registerForwarder(UseForwarderPtr forwarder)
+    {
+      ZS_LOG_DEBUG(log("register forwarder") + ZS_PARAM("forwarder", forwarder->getID()))
+
+      AutoRecursiveLock lock(*this);
+
+      if (isShutdown()) {
+        ZS_LOG_WARNING(Debug, log("cannot register forwarder while shutdown"))
+        return;
+      }
+
+      ForwarderWeakMapPtr replacementForwarders = make_shared<ForwarderWeakMap>(*mForwarders);
+      (*replacementForwarders)[forwarder->getID()] = forwarder;
+      mForwarders = replacementForwarders;  // COW replacement
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::unregisterForwarder(PUID forwarderID)
+    {
+      ZS_LOG_DEBUG(log("unregister forwarder") + ZS_PARAM("forwarder", forwarderID))
+
+      AutoRecursiveLock lock(*this);
+
+      auto found = mForwarders->find(forwarderID);
+      if (found == mForwarders->end()) return;
+
+      ForwarderWeakMapPtr replacementForwarders = make_shared<ForwarderWeakMap>(*mForwarders);
+      replacementForwarders->erase(forwarderID);
+      mForwarders = replacementForwarders;  // COW replacement
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPSender::sendForwardedPacket(RTPPacketPtr packet)
+    {
+      {
+        AutoRecursiveLock lock(*this);
+
+        // forwarded packets never pass through the media engine so NACKs for
+        // them can only be answered from the packet history
+        if (mPacketHistories.size() > 0) {
+          auto found = mPacketHistories.find(packet->ssrc());
+          if (found != mPacketHistories.end()) (*found).second->store(packet, zsLib::now());
+        }
+      }
+
+      return sendPacket(packet);
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -1416,9 +1539,15 @@ namespace ortc
       IHelper::debugAppend(resultEl, "track", mTrack ? mTrack->getID() : 0);
 
       IHelper::debugAppend(resultEl, "channels", mChannels->size());
+      IHelper::debugAppend(resultEl, "forwarders", mForwarders->size());
 
       IHelper::debugAppend(resultEl, "conflicts", mConflicts.size());
 
+      IHelper::debugAppend(resultEl, "packet history settings", mPacketHistorySettings.toDebug());
+      IHelper::debugAppend(resultEl, "packet histories", mPacketHistories.size());
+      IHelper::debugAppend(resultEl, "rtx payload types", mRTXPayloadTypes.size());
+      IHelper::debugAppend(resultEl, "round trip time", mRoundTripTime);
+
       return resultEl;
     }
 
@@ -1489,6 +1618,10 @@ namespace ortc
       ParametersToChannelHolderMapPtr channels = ParametersToChannelHolderMapPtr(make_shared<ParametersToChannelHolderMap>());
       mChannels = channels;
 
+      mForwarders = make_shared<ForwarderWeakMap>();
+
+      mPacketHistories.clear();
+
       mSubscriptions.clear();
 
       if (mDefaultSubscription) {
@@ -1650,6 +1783,203 @@ namespace ortc
       return (*found).second;
     }
 
+    //-------------------------------------------------------------------------
+    bool RTPSender::shouldGroupSimulcastEncodings() const
+    {
+      if (!mKind.hasValue()) return false;
+      if (IMediaStreamTrackTypes::Kind_Video != mKind.value()) return false;
+
+      return ISettings::getBool(ORTC_SETTING_RTP_SENDER_GROUP_SIMULCAST_VIDEO_ENCODINGS);
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPSender::isSSRCOfChannels(
+                                     const ParametersToChannelHolderMap &channels,
+                                     IRTPTypes::SSRCType ssrc
+                                     )
+    {
+      for (auto iter = channels.begin(); iter != channels.end(); ++iter) {
+        auto params = (*iter).first;
+
+        for (auto iterEncoding = params->mEncodings.begin(); iterEncoding != params->mEncodings.end(); ++iterEncoding) {
+          auto &encoding = (*iterEncoding);
+
+          if (encoding.mSSRC.hasValue()) {
+            if (ssrc == encoding.mSSRC.value()) return true;
+          }
+          if (encoding.mRTX.hasValue()) {
+            if (encoding.mRTX.value().mSSRC.hasValue()) {
+              if (ssrc == encoding.mRTX.value().mSSRC.value()) return true;
+            }
+          }
+        }
+      }
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::updateStatsCounters(
+                                        const ParametersToChannelHolderMap &channels,
+                                        const RTCPPacket &packet
+                                        )
+    {
+      typedef RTCPPacket::SenderReceiverCommonReport CommonReport;
+
+      DWORD compactNow = RTPUtils::timeToCompactNTP(zsLib::now());
+
+      auto handleReport = [this, &channels, compactNow](const CommonReport *report) {
+        for (auto block = report->firstReportBlock(); NULL != block; block = block->next()) {
+          if (!isSSRCOfChannels(channels, block->ssrc())) continue;
+
+          // cumulative number of packets lost is a signed 24 bit value
+          DWORD lost = block->cumulativeNumberOfPacketsLost() & 0xFFFFFF;
+          long long signedLost = static_cast<long long>(0 != (lost & 0x800000) ? (static_cast<long>(lost) - 0x1000000) : static_cast<long>(lost));
+          mStatsCounters->setSigned(IStatsCountersTypes::Counter_PacketsLost, signedLost);
+
+          Microseconds rtt {};
+          if (!getRoundTripTime(*block, compactNow, rtt)) continue;
+
+          mStatsCounters->set(IStatsCountersTypes::Counter_RoundTripTime, rtt.count());
+        }
+      };
+
+      for (auto report = packet.firstSenderReport(); NULL != report; report = report->nextSenderReport()) {
+        handleReport(report);
+      }
+      for (auto report = packet.firstReceiverReport(); NULL != report; report = report->nextReceiverReport()) {
+        handleReport(report);
+      }
+
+      for (auto fb = packet.firstTransportLayerFeedbackMessage(); NULL != fb; fb = fb->nextTransportLayerFeedbackMessage()) {
+        if (0 == fb->genericNACKCount()) continue;
+        if (!isSSRCOfChannels(channels, fb->ssrcOfMediaSource())) continue;
+        mStatsCounters->increment(IStatsCountersTypes::Counter_NACKCount, fb->genericNACKCount());
+      }
+
+      for (auto fb = packet.firstPayloadSpecificFeedbackMessage(); NULL != fb; fb = fb->nextPayloadSpecificFeedbackMessage()) {
+        if (fb->pli()) {
+          if (isSSRCOfChannels(channels, fb->ssrcOfMediaSource())) {
+            mStatsCounters->increment(IStatsCountersTypes::Counter_PLICount);
+          }
+        }
+        for (size_t index = 0; index < fb->firCount(); ++index) {
+          auto fir = fb->firAtIndex(index);
+          if (!isSSRCOfChannels(channels, fir->ssrc())) continue;
+          mStatsCounters->increment(IStatsCountersTypes::Counter_FIRCount);
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPSender::getRoundTripTime(
+                                     const RTCPPacket::SenderReceiverCommonReport::ReportBlock &block,
+                                     DWORD compactNow,
+                                     Microseconds &outRoundTripTime
+                                     )
+    {
+      if (0 == block.lsr()) return false;
+
+      // RFC3550 section 6.4.1: RTT = A - LSR - DLSR (in 1/65536 seconds)
+      DWORD rtt = compactNow - block.lsr() - block.dlsr();
+      if (0 != (rtt & 0x80000000)) return false;  // clock skew / bogus report
+
+      outRoundTripTime = Microseconds(static_cast<Microseconds::rep>((static_cast<QWORD>(rtt) * 1000000ULL) >> 16));
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::updatePacketHistories()
+    {
+      PacketHistoryMap oldHistories = mPacketHistories;
+
+      mPacketHistories.clear();
+      mRTXPayloadTypes.clear();
+
+      if (!mParameters) return;
+      if (0 == mPacketHistorySettings.mMaxPackets) return;
+
+      for (auto iter = mParameters->mCodecs.begin(); iter != mParameters->mCodecs.end(); ++iter) {
+        auto &codec = (*iter);
+        if (IRTPTypes::SupportedCodec_RTX != IRTPTypes::toSupportedCodec(codec.mName)) continue;
+
+        auto rtxParams = IRTPTypes::RTXCodecParameters::convert(codec.mParameters);
+        if (!rtxParams) continue;
+
+        mRTXPayloadTypes[rtxParams->mApt] = codec.mPayloadType;
+      }
+
+      if (mRTXPayloadTypes.size() < 1) {
+        ZS_LOG_TRACE(log("no rtx codec negotiated (thus nacks will not be answered from packet history)"))
+        return;
+      }
+
+      for (auto iter = mParameters->mEncodings.begin(); iter != mParameters->mEncodings.end(); ++iter) {
+        auto &encoding = (*iter);
+
+        if (!encoding.mSSRC.hasValue()) continue;
+        if (!encoding.mRTX.hasValue()) continue;
+        if (!encoding.mRTX.value().mSSRC.hasValue()) continue;
+
+        auto ssrc = encoding.mSSRC.value();
+        auto rtxSSRC = encoding.mRTX.value().mSSRC.value();
+
+        auto found = oldHistories.find(ssrc);
+        if (found != oldHistories.end()) {
+          if ((*found).second->rtxSSRC() == rtxSSRC) {
+            mPacketHistories[ssrc] = (*found).second;
+            continue;
+          }
+        }
+
+        ZS_LOG_DEBUG(log("packet history created") + ZS_PARAM("ssrc", ssrc) + ZS_PARAM("rtx ssrc", rtxSSRC))
+        mPacketHistories[ssrc] = RTPPacketHistory::create(mPacketHistorySettings, rtxSSRC);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::handleNACKs(
+                                const RTCPPacket &packet,
+                                RTPPacketList &outResends
+                                )
+    {
+      typedef RTCPPacket::SenderReceiverCommonReport CommonReport;
+
+      Time tick = zsLib::now();
+
+      DWORD compactNow = RTPUtils::timeToCompactNTP(tick);
+
+      auto handleReport = [this, compactNow](const CommonReport *report) {
+        for (auto block = report->firstReportBlock(); NULL != block; block = block->next()) {
+          if (mPacketHistories.find(block->ssrc()) == mPacketHistories.end()) continue;
+
+          Microseconds rtt {};
+          if (!getRoundTripTime(*block, compactNow, rtt)) continue;
+
+          mRoundTripTime = zsLib::toMilliseconds(rtt);
+        }
+      };
+
+      for (auto report = packet.firstSenderReport(); NULL != report; report = report->nextSenderReport()) {
+        handleReport(report);
+      }
+      for (auto report = packet.firstReceiverReport(); NULL != report; report = report->nextReceiverReport()) {
+        handleReport(report);
+      }
+
+      for (auto fb = packet.firstTransportLayerFeedbackMessage(); NULL != fb; fb = fb->nextTransportLayerFeedbackMessage()) {
+        if (0 == fb->genericNACKCount()) continue;
+
+        auto found = mPacketHistories.find(fb->ssrcOfMediaSource());
+        if (found == mPacketHistories.end()) continue;
+
+        (*found).second->handleNACK(*fb, tick, mRoundTripTime, mRTXPayloadTypes, outResends);
+      }
+
+      if (outResends.size() > 0) {
+        ZS_LOG_TRACE(log("answering nack from packet history") + ZS_PARAM("resends", outResends.size()) + ZS_PARAM("rtt", mRoundTripTime))
+      }
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -514,13 +514,15 @@ namespace ortc
 
           auto oldHeaderExtensions = packet->mHeaderExtensions; // remember old pointer temporarily
 
+          const String &rid = getRID(packet->ssrc());
+
           RTPPacket::StringHeaderExtension muxHeader(mMuxHeader ? mMuxHeader->mID : 0, mMuxID.c_str());
-          RTPPacket::StringHeaderExtension ridHeader(mRIDHeader ? mRIDHeader->mID : 0, mRID.c_str());
+          RTPPacket::StringHeaderExtension ridHeader(mRIDHeader ? mRIDHeader->mID : 0, rid.c_str());
 
           // Re-point extenion headers in RTP packet to first point to MuxID or
           // RID or both.
           if (mMuxID.hasData()) {
-            if (mRID.hasData()) {
+            if (rid.hasData()) {
               muxHeader.mNext = &ridHeader;
               ridHeader.mNext = oldHeaderExtensions;
               packet->mHeaderExtensions = &muxHeader;
@@ -574,18 +576,23 @@ namespace ortc
       if ((mIsTagging) &&
           (mTagSDES))
       {
+        typedef std::list<RTCPPacket::SDES::Chunk::Rid> RidItemList;
+
         String muxID;
         String rid;
+        SSRCToRIDMap rids;
 
         {
           AutoRecursiveLock lock(*this);
           muxID = mMuxID;
-          mRID = rid;
+          rid = mRID;
+          rids = mRIDs;
         }
 
         //RTCPPacket::SDES::Chunk::Mid
         RTCPPacket::SDES::Chunk::Mid midItem;
         RTCPPacket::SDES::Chunk::Rid ridItem;
+        RidItemList ssrcRidItems;
 
         midItem.mValue = muxID.c_str();
         ridItem.mValue = rid.c_str();
@@ -601,7 +608,14 @@ namespace ortc
               chunk->mMidCount = 1;
               chunk->mFirstMid = &midItem;
             }
-            if (rid.hasData()) {
+
+            auto found = rids.find(chunk->ssrc());
+            if (found != rids.end()) {
+              ssrcRidItems.push_back(RTCPPacket::SDES::Chunk::Rid());
+              ssrcRidItems.back().mValue = (*found).second.c_str();
+              chunk->mRidCount = 1;
+              chunk->mFirstRid = &(ssrcRidItems.back());
+            } else if (rid.hasData()) {
               chunk->mRidCount = 1;
               chunk->mFirstRid = &ridItem;
             }
@@ -995,6 +1009,7 @@ namespace ortc
       // defined in the parameters.
       mMuxID.clear();
       mRID.clear();
+      mRIDs.clear();
 
       if (mMuxHeader) {
         mMuxID = mParameters->mMuxID;
@@ -1004,6 +1019,22 @@ namespace ortc
           auto &encoding = (mParameters->mEncodings.front());
           mRID = encoding.mEncodingID;
         }
+        if (mParameters->mEncodings.size() > 1) {
+          // simulcast encodings sharing this channel each tag their own RID
+          // (encodings are only grouped when all their SSRCs are set)
+          for (auto iter = mParameters->mEncodings.begin(); iter != mParameters->mEncodings.end(); ++iter) {
+            auto &encoding = (*iter);
+            if (encoding.mEncodingID.isEmpty()) continue;
+
+            if (encoding.mSSRC.hasValue()) mRIDs[encoding.mSSRC.value()] = encoding.mEncodingID;
+            if (encoding.mRTX.hasValue()) {
+              if (encoding.mRTX.value().mSSRC.hasValue()) mRIDs[encoding.mRTX.value().mSSRC.value()] = encoding.mEncodingID;
+            }
+            if (encoding.mFEC.hasValue()) {
+              if (encoding.mFEC.value().mSSRC.hasValue()) mRIDs[encoding.mFEC.value().mSSRC.value()] = encoding.mEncodingID;
+            }
+          }
+        }
       }
 
       // Check to see if the header options have changed since last update.
@@ -1022,6 +1053,12 @@ namespace ortc
         hasher->update(mMuxID);
         hasher->update(":");
         hasher->update(mRID);
+        for (auto iter = mRIDs.begin(); iter != mRIDs.end(); ++iter) {
+          hasher->update(":");
+          hasher->update(string((*iter).first));
+          hasher->update("=");
+          hasher->update((*iter).second);
+        }
 
         String hashResult = hasher->finalizeAsString();
         if (hashResult != mHeaderHash) {
@@ -1031,7 +1068,15 @@ namespace ortc
       }
 
       // Set flag to do tagging if there is a mux id or a rid set.
-      mIsTagging = mMuxID.hasData() || mRID.hasData();
+      mIsTagging = mMuxID.hasData() || mRID.hasData() || (mRIDs.size() > 0);
+    }
+
+    //-------------------------------------------------------------------------
+    const String &RTPSenderChannel::getRID(SSRCType ssrc) const
+    {
+      auto found = mRIDs.find(ssrc);
+      if (found == mRIDs.end()) return mRID;
+      return (*found).second;
     }
     
     //-------------------------------------------------------------------------
@@ -78,6 +78,22 @@ namespace ortc
 
     const float kExactMatchRankAmount = 1000000.0;
 
+    //-------------------------------------------------------------------------
+    static String combineChannelHash(
+                                     const String &sectionHash,
+                                     const String &encodingsHash
+                                     )
+    {
+      auto hasher = IHasher::sha1();
+
+      hasher->update("ortc::RTPTypesHelper::ChannelHashes:");
+      hasher->update(sectionHash);
+      hasher->update(":");
+      hasher->update(encodingsHash);
+
+      return hasher->finalizeAsString();
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -437,7 +453,19 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPTypesHelper::splitParamsIntoChannels(
                                                 const Parameters &params,
-                                                ParametersPtrList &outParamsGroupedIntoChannels
+                                                ParametersPtrList &outParamsGroupedIntoChannels,
+                                                bool groupSimulcastEncodings
+                                                )
+    {
+      splitParamsIntoChannels(params, ParametersPtrList(), outParamsGroupedIntoChannels, groupSimulcastEncodings);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPTypesHelper::splitParamsIntoChannels(
+                                                const Parameters &params,
+                                                const ParametersPtrList &previousParamsGroupedIntoChannels,
+                                                ParametersPtrList &outParamsGroupedIntoChannels,
+                                                bool groupSimulcastEncodings
                                                 )
     {
       typedef IRTPTypes::EncodingID EncodingID;
@@ -450,11 +478,9 @@ namespace ortc
         auto &encoding = (*iter);
         if (encoding.mDependencyEncodingIDs.size() > 0) continue; // skip all that are dependent on other layers
 
+        // channels only hold their encodings until grouping is done (the
+        // shared sections are filled in afterwards)
         ParametersPtr tmpParam(make_shared<Parameters>());
-        tmpParam->mCodecs = params.mCodecs;
-        tmpParam->mHeaderExtensions = params.mHeaderExtensions;
-        tmpParam->mMuxID = params.mMuxID;
-        tmpParam->mRTCP = params.mRTCP;
         tmpParam->mEncodings.push_back(encoding);
 
         outParamsGroupedIntoChannels.push_back(tmpParam);
@@ -506,9 +532,132 @@ namespace ortc
       ORTC_THROW_INVALID_PARAMETERS_IF((missingEntry) &&
                                        (!foundEntry))
 
+      if (groupSimulcastEncodings) {
+        typedef IRTPTypes::PayloadType PayloadType;
+        typedef std::map<PayloadType, ParametersPtr> PayloadTypeToParamsMap;
+
+        // Independent single layer encodings using the same codec are
+        // simulcast copies of the same source and can be fed into a single
+        // channel so the source frame is scaled once into a resolution
+        // pyramid and the streams share a single pacer / bitrate allocator.
+        //
+        // Only the VP8 encoder produces multiple simulcast streams and each
+        // grouped stream must have an explicit SSRC so its RID can be
+        // tagged per SSRC (engine assigned SSRCs are not known up front).
+        PayloadTypeToParamsMap groupedByPayloadType;
+        ParametersPtr groupedWithDefaultPayloadType;
+
+        // the engine encodes with the first video codec unless the encoding
+        // selects a payload type
+        Optional<IRTPTypes::SupportedCodecs> defaultCodec;
+        for (auto iter = params.mCodecs.begin(); iter != params.mCodecs.end(); ++iter) {
+          auto supportedCodec = IRTPTypes::toSupportedCodec((*iter).mName);
+          if (IRTPTypes::CodecKind_Video != IRTPTypes::getCodecKind(supportedCodec)) continue;
+          defaultCodec = supportedCodec;
+          break;
+        }
+
+        for (auto iter_doNotUse = outParamsGroupedIntoChannels.begin(); iter_doNotUse != outParamsGroupedIntoChannels.end(); ) {
+          auto current = iter_doNotUse;
+          ++iter_doNotUse;
+
+          auto channelParams = (*current);
+          if (channelParams->mEncodings.size() != 1) continue;            // layered channels are never grouped
+
+          auto &encoding = channelParams->mEncodings.front();
+          if (!encoding.mSSRC.hasValue()) continue;                       // RID cannot be mapped without a known SSRC
+          if ((encoding.mRTX.hasValue()) &&
+              (!encoding.mRTX.value().mSSRC.hasValue())) continue;
+          if ((encoding.mFEC.hasValue()) &&
+              (!encoding.mFEC.value().mSSRC.hasValue())) continue;
+
+          Optional<IRTPTypes::SupportedCodecs> codec = defaultCodec;
+          if (encoding.mCodecPayloadType.hasValue()) {
+            codec = Optional<IRTPTypes::SupportedCodecs>();
+            for (auto iterCodec = params.mCodecs.begin(); iterCodec != params.mCodecs.end(); ++iterCodec) {
+              if ((*iterCodec).mPayloadType != encoding.mCodecPayloadType.value()) continue;
+              codec = IRTPTypes::toSupportedCodec((*iterCodec).mName);
+              break;
+            }
+          }
+          if (!codec.hasValue()) continue;
+          if (IRTPTypes::SupportedCodec_VP8 != codec.value()) continue;   // H264 / VP9 encoders are single stream
+
+          ParametersPtr *existingGroup = &groupedWithDefaultPayloadType;
+          if (encoding.mCodecPayloadType.hasValue()) {
+            existingGroup = &(groupedByPayloadType[encoding.mCodecPayloadType.value()]);
+          }
+
+          if (!(*existingGroup)) {
+            (*existingGroup) = channelParams;
+            continue;
+          }
+
+          (*existingGroup)->mEncodings.push_back(encoding);
+          outParamsGroupedIntoChannels.erase(current);
+        }
+      }
+
       if (outParamsGroupedIntoChannels.size() < 1) {
         // ensure at least one channel exists
-        outParamsGroupedIntoChannels.push_back(make_shared<Parameters>(params));
+        ParametersPtr tmpParam(make_shared<Parameters>());
+        tmpParam->mEncodings = params.mEncodings;
+        tmpParam->mDegredationPreference = params.mDegredationPreference;
+        outParamsGroupedIntoChannels.push_back(tmpParam);
+      }
+
+      // scope: fill in the shared sections
+      {
+        typedef std::pair<String, ParametersPtr> HashParametersPair;
+        typedef std::list<HashParametersPair> HashParametersPairList;
+
+        Parameters::HashOptions sectionOptions;
+        sectionOptions.mEncodingParameters = false;
+        sectionOptions.mDegredationPreference = false;
+
+        Parameters::HashOptions channelOptions;
+        channelOptions.mMuxID = false;
+        channelOptions.mCodecs = false;
+        channelOptions.mHeaderExtensions = false;
+        channelOptions.mRTCP = false;
+
+        // Every previous channel carries the same muxId, codec, header
+        // extension and RTCP sections. When those are unchanged, a channel
+        // whose encodings are unchanged too keeps its previous (immutable)
+        // parameters object instead of deep copying the lists again.
+        HashParametersPairList reusable;
+        if (previousParamsGroupedIntoChannels.size() > 0) {
+          if (previousParamsGroupedIntoChannels.front()->hash(sectionOptions) == params.hash(sectionOptions)) {
+            for (auto iter = previousParamsGroupedIntoChannels.begin(); iter != previousParamsGroupedIntoChannels.end(); ++iter) {
+              auto &previousParams = (*iter);
+              reusable.push_back(HashParametersPair(previousParams->hash(channelOptions), previousParams));
+            }
+          }
+        }
+
+        for (auto iter = outParamsGroupedIntoChannels.begin(); iter != outParamsGroupedIntoChannels.end(); ++iter) {
+          auto &channelParams = (*iter);
+
+          if (reusable.size() > 0) {
+            String channelHash = channelParams->hash(channelOptions);
+
+            bool found = false;
+            for (auto iterReusable = reusable.begin(); iterReusable != reusable.end(); ++iterReusable) {
+              if ((*iterReusable).first != channelHash) continue;
+
+              channelParams = (*iterReusable).second;
+              reusable.erase(iterReusable);
+              found = true;
+              break;
+            }
+            if (found) continue;
+          }
+
+          channelParams->mMuxID = params.mMuxID;
+          channelParams->mCodecs = params.mCodecs;
+          channelParams->mHeaderExtensions = params.mHeaderExtensions;
+          channelParams->mRTCP = params.mRTCP;
+        }
       }
     }
 
@@ -571,11 +720,10 @@ namespace ortc
 
       HashParameterPairList newHashedList;
 
-      Parameters::HashOptions hashOptions;
+      ChannelHashMap hashes;
+      calculateChannelHashes(oldList, hashes);
+      calculateChannelHashes(newList, hashes);
 
-      hashOptions.mHeaderExtensions = false;
-      hashOptions.mRTCP = false;
-      
       // scope: calculate hashes for new list
       {
         for (auto iter_doNotUse = newList.begin(); iter_doNotUse != newList.end(); ) {
@@ -583,7 +731,7 @@ namespace ortc
           ++iter_doNotUse;
 
           auto params = (*current);
-          auto hash = params->hash(hashOptions);
+          auto &hash = hashes[params].mCompatible;
 
           newHashedList.push_back(HashParameterPair(hash, params));
         }
@@ -624,10 +772,10 @@ namespace ortc
 
             if (oldEncodingBase.mEncodingID != newEncodingBase.mEncodingID) continue;
 
-            auto oldHash = oldParams->hash(hashOptions);
+            auto &oldHash = hashes[oldParams].mCompatible;
 
             float rank {};
-            if (oldParams->hash() == newParams->hash()) {
+            if (hashes[oldParams].mFull == hashes[newParams].mFull) {
               // an exact match
               ZS_LOG_TRACE(slog("parameters are unchanged") + oldParams->toDebug())
               outUnchangedChannels.push_back(OldNewParametersPair(oldParams, newParams));
@@ -707,7 +855,7 @@ namespace ortc
           ++iterOld_doNotUse;
 
           auto oldParams = (*currentOld);
-          auto oldHash = oldParams->hash(hashOptions);
+          auto &oldHash = hashes[oldParams].mCompatible;
 
           auto iterNew_doNotUse = newList.begin();
           auto iterNewHash_doNotUse = newHashedList.begin();
@@ -725,7 +873,7 @@ namespace ortc
 
             auto newParams = (*currentNew);
 
-            if (oldParams->hash() == newParams->hash()) {
+            if (hashes[oldParams].mFull == hashes[newParams].mFull) {
               // an exact match
               ZS_LOG_TRACE(slog("parameters are unchanged") + oldParams->toDebug())
               outUnchangedChannels.push_back(OldNewParametersPair(oldParams, newParams));
@@ -900,6 +1048,70 @@ namespace ortc
                    ZS_PARAM("removed channels", outRemovedChannels.size()))
     }
 
+    //-------------------------------------------------------------------------
+    void RTPTypesHelper::calculateChannelHashes(
+                                                const ParametersPtrList &paramsGroupedIntoChannels,
+                                                ChannelHashMap &ioHashes
+                                                )
+    {
+      if (paramsGroupedIntoChannels.size() < 1) return;
+
+      // Every channel split from the same parameters (or adopted from a
+      // previous split as unchanged) carries an identical copy of the muxId,
+      // codec, header extension and RTCP sections so those sections are
+      // hashed once per list and only the encodings are hashed per channel.
+      auto &sectionParams = paramsGroupedIntoChannels.front();
+
+      Parameters::HashOptions sectionOptions;
+      sectionOptions.mEncodingParameters = false;
+
+      String fullSectionHash = sectionParams->hash(sectionOptions);
+
+      sectionOptions.mHeaderExtensions = false;
+      sectionOptions.mRTCP = false;
+
+      String compatibleSectionHash = sectionParams->hash(sectionOptions);
+
+      Parameters::HashOptions encodingOptions;
+      encodingOptions.mMuxID = false;
+      encodingOptions.mCodecs = false;
+      encodingOptions.mHeaderExtensions = false;
+      encodingOptions.mRTCP = false;
+      encodingOptions.mDegredationPreference = false;
+
+      for (auto iter = paramsGroupedIntoChannels.begin(); iter != paramsGroupedIntoChannels.end(); ++iter) {
+        auto &params = (*iter);
+        if (ioHashes.end() != ioHashes.find(params)) continue;
+
+        String encodingsHash = params->hash(encodingOptions);
+
+        auto &hashes = ioHashes[params];
+        hashes.mFull = combineChannelHash(fullSectionHash, encodingsHash);
+        hashes.mCompatible = combineChannelHash(compatibleSectionHash, encodingsHash);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPTypesHelper::adoptUnchangedChannels(
+                                                ParametersPtrList &ioParamsGroupedIntoChannels,
+                                                const ParametersPtrPairList &unchangedChannels
+                                                )
+    {
+      // unchanged channels keep their existing parameters instance so the
+      // channel (and anything keyed by it) is left untouched and the freshly
+      // split copy is released
+      for (auto iterPair = unchangedChannels.begin(); iterPair != unchangedChannels.end(); ++iterPair) {
+        auto &oldParams = (*iterPair).first;
+        auto &newParams = (*iterPair).second;
+
+        for (auto iter = ioParamsGroupedIntoChannels.begin(); iter != ioParamsGroupedIntoChannels.end(); ++iter) {
+          if ((*iter) != newParams) continue;
+          (*iter) = oldParams;
+          break;
+        }
+      }
+    }
+
     //-------------------------------------------------------------------------
     bool RTPTypesHelper::isGeneralizedSSRCCompatibleChange(
                                                           const Parameters &oldParams,
@@ -1924,7 +2136,96 @@ namespace ortc
       result = static_cast<PayloadType>(0x7F & packetPayload[1]);
       return result;
     }
-    
+
+    //-------------------------------------------------------------------------
+    bool RTPTypesHelper::isKeyFrameStart(
+                                         IRTPTypes::SupportedCodecs codec,
+                                         const BYTE *packetPayload,
+                                         size_t packetPayloadSizeInBytes
+                                         )
+    {
+      if (NULL == packetPayload) return false;
+      if (packetPayloadSizeInBytes < 1) return false;
+
+      const BYTE *pos = packetPayload;
+      size_t remaining = packetPayloadSizeInBytes;
+
+      switch (codec) {
+        case IRTPTypes::SupportedCodec_VP8:
+        {
+          // https://tools.ietf.org/html/rfc7741#section-4.2
+          BYTE descriptor = pos[0];
+          bool extended = (0 != (descriptor & 0x80));
+          bool startOfPartition = (0 != (descriptor & 0x10));
+          BYTE partitionIndex = (descriptor & 0x07);
+
+          if ((!startOfPartition) || (0 != partitionIndex)) return false;
+
+          size_t skip = 1;
+          if (extended) {
+            if (remaining < 2) return false;
+            BYTE flags = pos[1];
+            skip = 2;
+            if (0 != (flags & 0x80)) {                            // I: picture ID present
+              if (remaining < skip + 1) return false;
+              skip += (0 != (pos[skip] & 0x80)) ? 2 : 1;          // M: 15 bit picture ID
+            }
+            if (0 != (flags & 0x40)) ++skip;                      // L: TL0PICIDX present
+            if (0 != (flags & 0x30)) ++skip;                      // T/K: TID/KEYIDX present
+          }
+
+          if (remaining < skip + 1) return false;
+          return (0 == (pos[skip] & 0x01));                       // P bit of VP8 payload header (0 = key frame)
+        }
+        case IRTPTypes::SupportedCodec_VP9:
+        {
+          // https://tools.ietf.org/html/draft-ietf-payload-vp9#section-4.2
+          BYTE descriptor = pos[0];
+          bool interPicturePredicted = (0 != (descriptor & 0x40));
+          bool startOfFrame = (0 != (descriptor & 0x08));
+          return (startOfFrame) && (!interPicturePredicted);
+        }
+        case IRTPTypes::SupportedCodec_H264:
+        {
+          // https://tools.ietf.org/html/rfc6184#section-5.2
+          BYTE nalType = (pos[0] & 0x1F);
+          switch (nalType) {
+            case 5:                                               // IDR slice
+            case 7:                                               // SPS
+            {
+              return true;
+            }
+            case 24:                                              // STAP-A
+            {
+              pos += 1; remaining -= 1;
+              while (remaining > sizeof(WORD)) {
+                size_t naluSize = static_cast<size_t>(RTPUtils::getBE16(pos));
+                pos += sizeof(WORD); remaining -= sizeof(WORD);
+                if ((naluSize < 1) || (naluSize > remaining)) return false;
+
+                BYTE innerType = (pos[0] & 0x1F);
+                if ((5 == innerType) || (7 == innerType)) return true;
+                pos += naluSize; remaining -= naluSize;
+              }
+              return false;
+            }
+            case 28:                                              // FU-A
+            {
+              if (remaining < 2) return false;
+              bool start = (0 != (pos[1] & 0x80));
+              BYTE innerType = (pos[1] & 0x1F);
+              return (start) && ((5 == innerType) || (7 == innerType));
+            }
+            default:  break;
+          }
+          return false;
+        }
+        default:  break;
+      }
+
+      return false;
+    }
+
     //-------------------------------------------------------------------------
     Log::Params RTPTypesHelper::slog(const char *message)
     {
@@ -2973,7 +3274,8 @@ namespace ortc
   {
     if (!elem) return;
 
-    IHelper::getElementValue(elem, "ortc::IRTPTypes::FlexFECCodecCapabilityParameters", "rtxTime", mRepairWindow);
+    IHelper::getElementValue(elem, "ortc::IRTPTypes::FlexFECCodecCapabilityParameters", "rtxTime", mRepairWindow);  // legacy name
+    IHelper::getElementValue(elem, "ortc::IRTPTypes::FlexFECCodecCapabilityParameters", "repairWindow", mRepairWindow);
     IHelper::getElementValue(elem, "ortc::IRTPTypes::FlexFECCodecCapabilityParameters", "l", mL);
     IHelper::getElementValue(elem, "ortc::IRTPTypes::FlexFECCodecCapabilityParameters", "d", mD);
 
@@ -3750,6 +4052,7 @@ namespace ortc
 
     IHelper::getElementValue(elem, "ortc::IRTPTypes::OpusCodecParameters", "maxPlaybackRate", mMaxPlaybackRate);
     IHelper::getElementValue(elem, "ortc::IRTPTypes::OpusCodecParameters", "maxAverageBitrate", mMaxAverageBitrate);
+    IHelper::getElementValue(elem, "ortc::IRTPTypes::OpusCodecParameters", "stereo", mStereo);
     IHelper::getElementValue(elem, "ortc::IRTPTypes::OpusCodecParameters", "cbr", mCBR);
     IHelper::getElementValue(elem, "ortc::IRTPTypes::OpusCodecParameters", "useInbandFec", mUseInbandFEC);
     IHelper::getElementValue(elem, "ortc::IRTPTypes::OpusCodecParameters", "useDtx", mUseDTX);
@@ -3796,7 +4099,7 @@ namespace ortc
     IHelper::adoptElementValue(elem, "stereo", mStereo);
     IHelper::adoptElementValue(elem, "cbr", mCBR);
     IHelper::adoptElementValue(elem, "useInbandFec", mUseInbandFEC);
-    IHelper::adoptElementValue(elem, "UseDtx", mUseDTX);
+    IHelper::adoptElementValue(elem, "useDtx", mUseDTX);
 
     IHelper::adoptElementValue(elem, "complexity", mComplexity);
     IHelper::adoptElementValue(elem, "signal", OpusCodecCapabilityOptions::toString(mSignal), false);
@@ -4215,7 +4518,7 @@ namespace ortc
     IHelper::adoptElementValue(elem, "maxBitrate", mMaxBitrate);
     IHelper::adoptElementValue(elem, "minQuality", mMinQuality);
     IHelper::adoptElementValue(elem, "resolutionScale", mResolutionScale);
-    IHelper::adoptElementValue(elem, "resolutionScale", mFramerateScale);
+    IHelper::adoptElementValue(elem, "framerateScale", mFramerateScale);
     IHelper::adoptElementValue(elem, "active", mActive);
     IHelper::adoptElementValue(elem, "encodingId", mEncodingID, false);
 
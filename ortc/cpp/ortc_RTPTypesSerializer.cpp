@@ -0,0 +1,2780 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#include <ortc/internal/ortc_RTPTypesSerializer.h>
+#include <ortc/internal/platform.h>
+
+#include <ortc/IHelper.h>
+
+#include <zsLib/Numeric.h>
+#include <zsLib/Stringize.h>
+#include <zsLib/Log.h>
+#include <zsLib/XML.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib) }
+
+namespace ortc
+{
+  using zsLib::Numeric;
+  using zsLib::Log;
+
+  namespace internal
+  {
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::CodecCapability, CodecCapability)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::OpusCodecCapabilityOptions, OpusCodecCapabilityOptions)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::OpusCodecCapabilityParameters, OpusCodecCapabilityParameters)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::VP8CodecCapabilityParameters, VP8CodecCapabilityParameters)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::H264CodecCapabilityParameters, H264CodecCapabilityParameters)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::RTXCodecCapabilityParameters, RTXCodecCapabilityParameters)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::FlexFECCodecCapabilityParameters, FlexFECCodecCapabilityParameters)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::HeaderExtension, HeaderExtension)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::RTCPFeedback, RTCPFeedback)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::CodecParameters, CodecParameters)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::OpusCodecParameters, OpusCodecParameters)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::VP8CodecParameters, VP8CodecParameters)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::H264CodecParameters, H264CodecParameters)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::RTXCodecParameters, RTXCodecParameters)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::REDCodecParameters, REDCodecParameters)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::FlexFECCodecParameters, FlexFECCodecParameters)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::HeaderExtensionParameters, HeaderExtensionParameters)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::EncodingParameters, EncodingParameters)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::RTCPParameters, RTCPParameters)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::FECParameters, FECParameters)
+    ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::RTXParameters, RTXParameters)
+
+    typedef RTPTypesSerializer::Parameters Parameters;
+    typedef RTPTypesSerializer::Capabilities Capabilities;
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (helpers)
+    #pragma mark
+
+    static const BYTE kRTPTypesSerializerMagic[] = {'O', 'R', 'T', 'P'};
+
+    //-------------------------------------------------------------------------
+    static Log::Params slog(const char *message)
+    {
+      return RTPTypesSerializer::slog(message);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (json writer helpers)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    static void writeJSONString(std::string &output, const char *value)
+    {
+      static const char *hexDigits = "0123456789abcdef";
+
+      output.append(1, '"');
+      for (const char *pos = value; 0 != *pos; ++pos) {
+        BYTE ch = static_cast<BYTE>(*pos);
+        switch (ch) {
+          case '"':   output.append("\\\""); break;
+          case '\\':  output.append("\\\\"); break;
+          case '\b':  output.append("\\b"); break;
+          case '\f':  output.append("\\f"); break;
+          case '\n':  output.append("\\n"); break;
+          case '\r':  output.append("\\r"); break;
+          case '\t':  output.append("\\t"); break;
+          default: {
+            if (ch < 0x20) {
+              output.append("\\u00");
+              output.append(1, hexDigits[ch >> 4]);
+              output.append(1, hexDigits[ch & 0xF]);
+              break;
+            }
+            output.append(1, static_cast<char>(ch));
+            break;
+          }
+        }
+      }
+      output.append(1, '"');
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSONName(
+                              std::string &output,
+                              bool &ioFirst,
+                              const char *name
+                              )
+    {
+      // all member names are fixed ASCII and need no escaping
+      if (!ioFirst) output.append(1, ',');
+      ioFirst = false;
+
+      output.append(1, '"');
+      output.append(name);
+      output.append("\":");
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSONValue(
+                               std::string &output,
+                               bool &ioFirst,
+                               const char *name,
+                               const String &value,
+                               bool adoptEmptyValue = false
+                               )
+    {
+      if ((value.isEmpty()) &&
+          (!adoptEmptyValue)) return;
+
+      writeJSONName(output, ioFirst, name);
+      writeJSONString(output, value.c_str());
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSONValue(
+                               std::string &output,
+                               bool &ioFirst,
+                               const char *name,
+                               const char *value
+                               )
+    {
+      if (!value) return;
+      if (0 == *value) return;
+
+      writeJSONName(output, ioFirst, name);
+      writeJSONString(output, value);
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSONValue(
+                               std::string &output,
+                               bool &ioFirst,
+                               const char *name,
+                               QWORD value
+                               )
+    {
+      writeJSONName(output, ioFirst, name);
+      output.append(std::to_string(value));
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSONValue(
+                               std::string &output,
+                               bool &ioFirst,
+                               const char *name,
+                               bool value
+                               )
+    {
+      writeJSONName(output, ioFirst, name);
+      output.append(value ? "true" : "false");
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSONValue(
+                               std::string &output,
+                               bool &ioFirst,
+                               const char *name,
+                               double value
+                               )
+    {
+      if (!std::isfinite(value)) value = 0.0;
+
+      char buffer[32] {};
+      std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+
+      writeJSONName(output, ioFirst, name);
+      output.append(buffer);
+    }
+
+    //-------------------------------------------------------------------------
+    template <typename T>
+    static void writeJSONNumber(
+                                std::string &output,
+                                bool &ioFirst,
+                                const char *name,
+                                T value
+                                )
+    {
+      writeJSONValue(output, ioFirst, name, static_cast<QWORD>(value));
+    }
+
+    //-------------------------------------------------------------------------
+    template <typename T>
+    static void writeJSONNumber(
+                                std::string &output,
+                                bool &ioFirst,
+                                const char *name,
+                                const Optional<T> &value
+                                )
+    {
+      if (!value.hasValue()) return;
+      writeJSONNumber(output, ioFirst, name, value.value());
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSONBool(
+                              std::string &output,
+                              bool &ioFirst,
+                              const char *name,
+                              const Optional<bool> &value
+                              )
+    {
+      if (!value.hasValue()) return;
+      writeJSONValue(output, ioFirst, name, value.value());
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSONDouble(
+                                std::string &output,
+                                bool &ioFirst,
+                                const char *name,
+                                const Optional<double> &value
+                                )
+    {
+      if (!value.hasValue()) return;
+      writeJSONValue(output, ioFirst, name, value.value());
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSONFeedbacks(
+                                   std::string &output,
+                                   bool &ioFirst,
+                                   const IRTPTypes::RTCPFeedbackList &feedbacks
+                                   )
+    {
+      RTPTypesSerializer::writeJSONList(output, ioFirst, "rtcpFeedbacks", "rtcpFeedback", feedbacks, [](std::string &itemOutput, const RTCPFeedback &feedback) {
+        bool first = true;
+        itemOutput.append(1, '{');
+        writeJSONValue(itemOutput, first, "type", feedback.mType);
+        writeJSONValue(itemOutput, first, "parameter", feedback.mParameter);
+        itemOutput.append(1, '}');
+      });
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSONOpusCommon(
+                                    std::string &output,
+                                    bool &ioFirst,
+                                    const Optional<ULONG> &maxPlaybackRate,
+                                    const Optional<ULONG> &maxAverageBitrate,
+                                    const Optional<bool> &stereo,
+                                    const Optional<bool> &cbr,
+                                    const Optional<bool> &useInbandFEC,
+                                    const Optional<bool> &useDTX
+                                    )
+    {
+      writeJSONNumber(output, ioFirst, "maxPlaybackRate", maxPlaybackRate);
+      writeJSONNumber(output, ioFirst, "maxAverageBitrate", maxAverageBitrate);
+      writeJSONBool(output, ioFirst, "stereo", stereo);
+      writeJSONBool(output, ioFirst, "cbr", cbr);
+      writeJSONBool(output, ioFirst, "useInbandFec", useInbandFEC);
+      writeJSONBool(output, ioFirst, "useDtx", useDTX);
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSONOpusOptions(
+                                     std::string &output,
+                                     bool &ioFirst,
+                                     const Optional<ULONG> &complexity,
+                                     const Optional<OpusCodecCapabilityOptions::Signals> &signal,
+                                     const Optional<OpusCodecCapabilityOptions::Applications> &application,
+                                     const Optional<ULONG> &packetLossPerc,
+                                     const Optional<bool> &predictionDisabled
+                                     )
+    {
+      writeJSONNumber(output, ioFirst, "complexity", complexity);
+      if (signal.hasValue()) {
+        writeJSONValue(output, ioFirst, "signal", OpusCodecCapabilityOptions::toString(signal.value()));
+      }
+      if (application.hasValue()) {
+        writeJSONValue(output, ioFirst, "application", OpusCodecCapabilityOptions::toString(application.value()));
+      }
+      writeJSONNumber(output, ioFirst, "packetLossPerc", packetLossPerc);
+      writeJSONBool(output, ioFirst, "predictionDisabled", predictionDisabled);
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSON(std::string &output, const OpusCodecCapabilityOptions &options)
+    {
+      bool first = true;
+      output.append(1, '{');
+      writeJSONOpusOptions(output, first, options.mComplexity, options.mSignal, options.mApplication, options.mPacketLossPerc, options.mPredictionDisabled);
+      output.append(1, '}');
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSON(std::string &output, const OpusCodecCapabilityParameters &params)
+    {
+      bool first = true;
+      output.append(1, '{');
+      writeJSONOpusCommon(output, first, params.mMaxPlaybackRate, params.mMaxAverageBitrate, params.mStereo, params.mCBR, params.mUseInbandFEC, params.mUseDTX);
+      writeJSONNumber(output, first, "spropMaxCaptureRate", params.mSPropMaxCaptureRate);
+      writeJSONBool(output, first, "spropStereo", params.mSPropStereo);
+      output.append(1, '}');
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSON(std::string &output, const OpusCodecParameters &params)
+    {
+      bool first = true;
+      output.append(1, '{');
+      writeJSONOpusCommon(output, first, params.mMaxPlaybackRate, params.mMaxAverageBitrate, params.mStereo, params.mCBR, params.mUseInbandFEC, params.mUseDTX);
+      writeJSONOpusOptions(output, first, params.mComplexity, params.mSignal, params.mApplication, params.mPacketLossPerc, params.mPredictionDisabled);
+      writeJSONNumber(output, first, "spropMaxCaptureRate", params.mSPropMaxCaptureRate);
+      writeJSONBool(output, first, "spropStereo", params.mSPropStereo);
+      output.append(1, '}');
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSON(std::string &output, const VP8CodecCapabilityParameters &params)
+    {
+      bool first = true;
+      output.append(1, '{');
+      writeJSONNumber(output, first, "maxFr", params.mMaxFR);
+      writeJSONNumber(output, first, "maxFs", params.mMaxFS);
+      output.append(1, '}');
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSON(std::string &output, const H264CodecCapabilityParameters &params)
+    {
+      bool first = true;
+      output.append(1, '{');
+      writeJSONNumber(output, first, "profileLevelId", params.mProfileLevelID);
+      RTPTypesSerializer::writeJSONList(output, first, "packetizationModes", "packetizationMode", params.mPacketizationModes, [](std::string &itemOutput, USHORT mode) {
+        itemOutput.append(std::to_string(mode));
+      });
+      writeJSONNumber(output, first, "maxMbps", params.mMaxMBPS);
+      writeJSONNumber(output, first, "maxSmbps", params.mMaxSMBPS);
+      writeJSONNumber(output, first, "mMaxFs", params.mMaxFS);
+      writeJSONNumber(output, first, "maxCpb", params.mMaxCPB);
+      writeJSONNumber(output, first, "maxDpb", params.mMaxDPB);
+      writeJSONNumber(output, first, "maxBr", params.mMaxBR);
+      output.append(1, '}');
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSON(std::string &output, const RTXCodecCapabilityParameters &params)
+    {
+      bool first = true;
+      output.append(1, '{');
+      writeJSONNumber(output, first, "apt", params.mApt);
+      writeJSONNumber(output, first, "rtxTime", params.mRTXTime.count());
+      output.append(1, '}');
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSON(std::string &output, const REDCodecParameters &params)
+    {
+      bool first = true;
+      output.append(1, '{');
+      RTPTypesSerializer::writeJSONList(output, first, "payloadTypes", "payloadType", params.mPayloadTypes, [](std::string &itemOutput, IRTPTypes::PayloadType payloadType) {
+        itemOutput.append(std::to_string(payloadType));
+      });
+      output.append(1, '}');
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSON(std::string &output, const FlexFECCodecCapabilityParameters &params)
+    {
+      bool first = true;
+      output.append(1, '{');
+      writeJSONNumber(output, first, "repairWindow", params.mRepairWindow.count());
+      writeJSONNumber(output, first, "l", params.mL);
+      writeJSONNumber(output, first, "d", params.mD);
+      if (params.mToP.hasValue()) {
+        writeJSONValue(output, first, "toP", FlexFECCodecCapabilityParameters::toString(params.mToP.value()));
+      }
+      output.append(1, '}');
+    }
+
+    //-------------------------------------------------------------------------
+    template <typename Params>
+    static void writeJSONCodecSpecific(
+                                       std::string &output,
+                                       bool &ioFirst,
+                                       const char *name,
+                                       AnyPtr any
+                                       )
+    {
+      auto params = ZS_DYNAMIC_PTR_CAST(Params, any);
+      if (!params) return;
+
+      writeJSONName(output, ioFirst, name);
+      writeJSON(output, *params);
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSON(std::string &output, const CodecCapability &codec)
+    {
+      bool first = true;
+      output.append(1, '{');
+
+      writeJSONValue(output, first, "name", codec.mName);
+      writeJSONValue(output, first, "kind", codec.mKind);
+      writeJSONNumber(output, first, "clockRate", codec.mClockRate);
+      writeJSONNumber(output, first, "preferredPayloadType", codec.mPreferredPayloadType);
+      if (Milliseconds() != codec.mPTime) {
+        writeJSONNumber(output, first, "ptime", codec.mPTime.count());
+      }
+      if (Milliseconds() != codec.mMaxPTime) {
+        writeJSONNumber(output, first, "maxptime", codec.mMaxPTime.count());
+      }
+      writeJSONNumber(output, first, "numChannels", codec.mNumChannels);
+
+      writeJSONFeedbacks(output, first, codec.mRTCPFeedback);
+
+      IRTPTypes::SupportedCodecs supported = IRTPTypes::toSupportedCodec(codec.mName);
+
+      if (codec.mParameters) {
+        switch (supported) {
+          case IRTPTypes::SupportedCodec_Opus:    writeJSONCodecSpecific<OpusCodecCapabilityParameters>(output, first, "parameters", codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_VP8:     writeJSONCodecSpecific<VP8CodecCapabilityParameters>(output, first, "parameters", codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_H264:    writeJSONCodecSpecific<H264CodecCapabilityParameters>(output, first, "parameters", codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_RTX:     writeJSONCodecSpecific<RTXCodecCapabilityParameters>(output, first, "parameters", codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_FlexFEC: writeJSONCodecSpecific<FlexFECCodecCapabilityParameters>(output, first, "parameters", codec.mParameters); break;
+          default:                                break;
+        }
+      }
+      if (codec.mOptions) {
+        switch (supported) {
+          case IRTPTypes::SupportedCodec_Opus:    writeJSONCodecSpecific<OpusCodecCapabilityOptions>(output, first, "options", codec.mOptions); break;
+          default:                                break;
+        }
+      }
+
+      if (0 == codec.mKind.compareNoCase(IMediaStreamTrackTypes::toString(IMediaStreamTrackTypes::Kind_Video))) {
+        writeJSONNumber(output, first, "maxTemporalLayers", codec.mMaxTemporalLayers);
+        writeJSONNumber(output, first, "maxSpatialLayers", codec.mMaxSpatialLayers);
+        if (codec.mSVCMultiStreamSupport) {
+          writeJSONValue(output, first, "svcMultiStreamSupport", codec.mSVCMultiStreamSupport);
+        }
+      }
+
+      output.append(1, '}');
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSON(std::string &output, const HeaderExtension &ext)
+    {
+      bool first = true;
+      output.append(1, '{');
+      writeJSONValue(output, first, "kind", ext.mKind);
+      writeJSONValue(output, first, "uri", ext.mURI);
+      writeJSONNumber(output, first, "preferredId", ext.mPreferredID);
+      writeJSONValue(output, first, "preferredEncrypt", ext.mPreferredEncrypt);
+      output.append(1, '}');
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSON(std::string &output, const CodecParameters &codec)
+    {
+      bool first = true;
+      output.append(1, '{');
+
+      writeJSONValue(output, first, "name", codec.mName);
+      writeJSONNumber(output, first, "payloadType", codec.mPayloadType);
+      writeJSONNumber(output, first, "clockRate", codec.mClockRate);
+      if (Milliseconds() != codec.mPTime) {
+        writeJSONNumber(output, first, "ptime", codec.mPTime.count());
+      }
+      if (Milliseconds() != codec.mMaxPTime) {
+        writeJSONNumber(output, first, "maxptime", codec.mMaxPTime.count());
+      }
+      writeJSONNumber(output, first, "numChannels", codec.mNumChannels);
+
+      writeJSONFeedbacks(output, first, codec.mRTCPFeedback);
+
+      if (codec.mParameters) {
+        switch (IRTPTypes::toSupportedCodec(codec.mName)) {
+          case IRTPTypes::SupportedCodec_Opus:    writeJSONCodecSpecific<OpusCodecParameters>(output, first, "parameters", codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_VP8:     writeJSONCodecSpecific<VP8CodecParameters>(output, first, "parameters", codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_H264:    writeJSONCodecSpecific<H264CodecParameters>(output, first, "parameters", codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_RTX:     writeJSONCodecSpecific<RTXCodecParameters>(output, first, "parameters", codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_RED:     writeJSONCodecSpecific<REDCodecParameters>(output, first, "parameters", codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_FlexFEC: writeJSONCodecSpecific<FlexFECCodecParameters>(output, first, "parameters", codec.mParameters); break;
+          default:                                break;
+        }
+      }
+
+      output.append(1, '}');
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSON(std::string &output, const HeaderExtensionParameters &ext)
+    {
+      bool first = true;
+      output.append(1, '{');
+      writeJSONValue(output, first, "uri", ext.mURI);
+      writeJSONNumber(output, first, "id", ext.mID);
+      writeJSONValue(output, first, "encrypt", ext.mEncrypt);
+      output.append(1, '}');
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSON(std::string &output, const EncodingParameters &encoding)
+    {
+      bool first = true;
+      output.append(1, '{');
+
+      writeJSONNumber(output, first, "ssrc", encoding.mSSRC);
+      writeJSONNumber(output, first, "codecPayloadType", encoding.mCodecPayloadType);
+
+      if (encoding.mFEC.hasValue()) {
+        auto &fec = encoding.mFEC.value();
+        bool firstFEC = true;
+        writeJSONName(output, first, "fec");
+        output.append(1, '{');
+        writeJSONNumber(output, firstFEC, "ssrc", fec.mSSRC);
+        writeJSONValue(output, firstFEC, "mechanism", fec.mMechanism);
+        output.append(1, '}');
+      }
+      if (encoding.mRTX.hasValue()) {
+        auto &rtx = encoding.mRTX.value();
+        bool firstRTX = true;
+        writeJSONName(output, first, "rtx");
+        output.append(1, '{');
+        writeJSONNumber(output, firstRTX, "ssrc", rtx.mSSRC);
+        output.append(1, '}');
+      }
+
+      writeJSONValue(output, first, "priority", IRTPTypes::toString(encoding.mPriority));
+      writeJSONNumber(output, first, "maxBitrate", encoding.mMaxBitrate);
+      writeJSONDouble(output, first, "minQuality", encoding.mMinQuality);
+      writeJSONDouble(output, first, "resolutionScale", encoding.mResolutionScale);
+      writeJSONDouble(output, first, "framerateScale", encoding.mFramerateScale);
+      writeJSONValue(output, first, "active", encoding.mActive);
+      writeJSONValue(output, first, "encodingId", encoding.mEncodingID);
+
+      RTPTypesSerializer::writeJSONList(output, first, "dependencyEncodingIds", "dependencyEncodingId", encoding.mDependencyEncodingIDs, [](std::string &itemOutput, const IRTPTypes::EncodingID &encodingID) {
+        writeJSONString(itemOutput, encodingID.c_str());
+      });
+
+      output.append(1, '}');
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeJSON(std::string &output, const RTCPParameters &rtcp)
+    {
+      bool first = true;
+      output.append(1, '{');
+      writeJSONNumber(output, first, "ssrc", rtcp.mSSRC);
+      writeJSONValue(output, first, "cname", rtcp.mCName);
+      writeJSONValue(output, first, "reducedSize", rtcp.mReducedSize);
+      writeJSONValue(output, first, "mux", rtcp.mMux);
+      output.append(1, '}');
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPTypesJSONReader
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTPTypesJSONReader::RTPTypesJSONReader(const char *json) :
+      mPos(json ? json : "")
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPTypesJSONReader::fail()
+    {
+      mFailed = true;
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPTypesJSONReader::isNext(char ch)
+    {
+      skipWhitespace();
+      return ch == *mPos;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPTypesJSONReader::isAtEnd()
+    {
+      skipWhitespace();
+      return 0 == *mPos;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPTypesJSONReader::beginObject()
+    {
+      if (mFailed) return false;
+      if (!isNext('{')) return fail();
+      ++mPos;
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPTypesJSONReader::nextMember(String &outName)
+    {
+      if (mFailed) return false;
+
+      skipWhitespace();
+      if ('}' == *mPos) {
+        ++mPos;
+        return false;
+      }
+      if (',' == *mPos) {
+        ++mPos;
+        skipWhitespace();
+      }
+      if ('"' != *mPos) return fail();
+      if (!readString(outName)) return false;
+      if (!isNext(':')) return fail();
+      ++mPos;
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPTypesJSONReader::beginArray()
+    {
+      if (mFailed) return false;
+      if (!isNext('[')) return fail();
+      ++mPos;
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPTypesJSONReader::nextItem()
+    {
+      if (mFailed) return false;
+
+      skipWhitespace();
+      if (']' == *mPos) {
+        ++mPos;
+        return false;
+      }
+      if (',' == *mPos) {
+        ++mPos;
+        skipWhitespace();
+      }
+      if ((0 == *mPos) ||
+          (']' == *mPos)) return fail();
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPTypesJSONReader::readScalar(String &outValue)
+    {
+      outValue.clear();
+      if (mFailed) return false;
+
+      skipWhitespace();
+      switch (*mPos) {
+        case '"': return readString(outValue);
+        case '{':
+        case '[': return skipValue();
+        default:  break;
+      }
+
+      const char *start = mPos;
+      while (!isDelimiter(*mPos)) { ++mPos; }
+      if (start == mPos) return fail();
+
+      size_t length = static_cast<size_t>(mPos - start);
+      if ((4 == length) &&
+          (0 == strncmp(start, "null", length))) return true;
+
+      outValue.assign(start, length);
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPTypesJSONReader::skipValue()
+    {
+      if (mFailed) return false;
+
+      skipWhitespace();
+      switch (*mPos) {
+        case '"': {
+          String ignored;
+          return readString(ignored);
+        }
+        case '{': {
+          ++mPos;
+          String name;
+          while (nextMember(name)) {
+            if (!skipValue()) return false;
+          }
+          return !mFailed;
+        }
+        case '[': {
+          ++mPos;
+          while (nextItem()) {
+            if (!skipValue()) return false;
+          }
+          return !mFailed;
+        }
+        default: break;
+      }
+
+      const char *start = mPos;
+      while (!isDelimiter(*mPos)) { ++mPos; }
+      if (start == mPos) return fail();
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPTypesJSONReader::readRaw(String &outValue)
+    {
+      outValue.clear();
+      if (mFailed) return false;
+
+      skipWhitespace();
+      const char *start = mPos;
+      if (!skipValue()) return false;
+
+      outValue.assign(start, static_cast<size_t>(mPos - start));
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPTypesJSONReader::isDelimiter(char ch)
+    {
+      switch (ch) {
+        case 0:
+        case ',':
+        case '}':
+        case ']':
+        case ':':
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\n':  return true;
+        default:    break;
+      }
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPTypesJSONReader::skipWhitespace()
+    {
+      while ((' ' == *mPos) ||
+             ('\t' == *mPos) ||
+             ('\r' == *mPos) ||
+             ('\n' == *mPos)) {
+        ++mPos;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPTypesJSONReader::readHex4(DWORD &outValue)
+    {
+      outValue = 0;
+      for (int index = 0; index < 4; ++index, ++mPos) {
+        char ch = *mPos;
+        outValue <<= 4;
+        if ((ch >= '0') && (ch <= '9')) { outValue |= static_cast<DWORD>(ch - '0'); continue; }
+        if ((ch >= 'a') && (ch <= 'f')) { outValue |= static_cast<DWORD>(ch - 'a' + 10); continue; }
+        if ((ch >= 'A') && (ch <= 'F')) { outValue |= static_cast<DWORD>(ch - 'A' + 10); continue; }
+        return fail();
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPTypesJSONReader::appendUTF8(String &output, DWORD codePoint)
+    {
+      if (codePoint < 0x80) {
+        output.append(1, static_cast<char>(codePoint));
+      } else if (codePoint < 0x800) {
+        output.append(1, static_cast<char>(0xC0 | (codePoint >> 6)));
+        output.append(1, static_cast<char>(0x80 | (codePoint & 0x3F)));
+      } else if (codePoint < 0x10000) {
+        output.append(1, static_cast<char>(0xE0 | (codePoint >> 12)));
+        output.append(1, static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        output.append(1, static_cast<char>(0x80 | (codePoint & 0x3F)));
+      } else {
+        output.append(1, static_cast<char>(0xF0 | (codePoint >> 18)));
+        output.append(1, static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        output.append(1, static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        output.append(1, static_cast<char>(0x80 | (codePoint & 0x3F)));
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPTypesJSONReader::readString(String &outValue)
+    {
+      outValue.clear();
+
+      ASSERT('"' == *mPos)
+      ++mPos;
+
+      while (true) {
+        const char *start = mPos;
+        while ((0 != *mPos) &&
+               ('"' != *mPos) &&
+               ('\\' != *mPos)) {
+          ++mPos;
+        }
+        outValue.append(start, static_cast<size_t>(mPos - start));
+
+        switch (*mPos) {
+          case 0:   return fail();
+          case '"': ++mPos; return true;
+          default:  break;
+        }
+
+        ++mPos;
+        char escaped = *mPos;
+        ++mPos;
+        switch (escaped) {
+          case '"':   outValue.append(1, '"'); break;
+          case '\\':  outValue.append(1, '\\'); break;
+          case '/':   outValue.append(1, '/'); break;
+          case 'b':   outValue.append(1, '\b'); break;
+          case 'f':   outValue.append(1, '\f'); break;
+          case 'n':   outValue.append(1, '\n'); break;
+          case 'r':   outValue.append(1, '\r'); break;
+          case 't':   outValue.append(1, '\t'); break;
+          case 'u': {
+            DWORD codePoint = 0;
+            if (!readHex4(codePoint)) return false;
+            if ((codePoint >= 0xD800) &&
+                (codePoint <= 0xDBFF) &&
+                ('\\' == mPos[0]) &&
+                ('u' == mPos[1])) {
+              mPos += 2;
+              DWORD lowSurrogate = 0;
+              if (!readHex4(lowSurrogate)) return false;
+              if ((lowSurrogate < 0xDC00) ||
+                  (lowSurrogate > 0xDFFF)) return fail();
+              codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+            }
+            appendUTF8(outValue, codePoint);
+            break;
+          }
+          default:    return fail();
+        }
+      }
+    }
+
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (json reader helpers)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    static void readJSONValue(
+                              RTPTypesJSONReader &reader,
+                              String &outValue
+                              )
+    {
+      reader.readScalar(outValue);
+    }
+
+    //-------------------------------------------------------------------------
+    template <typename T>
+    static bool readJSONNumber(
+                               RTPTypesJSONReader &reader,
+                               const char *name,
+                               T &outValue
+                               )
+    {
+      String str;
+      if (!reader.readScalar(str)) return false;
+      if (str.isEmpty()) return false;
+
+      try {
+        outValue = Numeric<T>(str);
+      } catch(const typename Numeric<T>::ValueOutOfRange &) {
+        ZS_LOG_WARNING(Debug, slog("value out of range") + ZS_PARAM("name", name) + ZS_PARAM("value", str))
+        return false;
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    template <typename T>
+    static bool readJSONNumber(
+                               RTPTypesJSONReader &reader,
+                               const char *name,
+                               Optional<T> &outValue
+                               )
+    {
+      T value {};
+      if (!readJSONNumber(reader, name, value)) return false;
+      outValue = value;
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    template <typename Duration>
+    static void readJSONDuration(
+                                 RTPTypesJSONReader &reader,
+                                 const char *name,
+                                 Duration &outValue
+                                 )
+    {
+      ULONGLONG value {};
+      if (!readJSONNumber(reader, name, value)) return;
+      outValue = Duration(static_cast<typename Duration::rep>(value));
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSONFeedbacks(
+                                  RTPTypesJSONReader &reader,
+                                  IRTPTypes::RTCPFeedbackList &outFeedbacks
+                                  )
+    {
+      reader.readList("rtcpFeedback", [&reader, &outFeedbacks]() {
+        RTCPFeedback feedback;
+        if (!reader.beginObject()) return;
+
+        String name;
+        while (reader.nextMember(name)) {
+          if ("type" == name) {readJSONValue(reader, feedback.mType); continue;}
+          if ("parameter" == name) {readJSONValue(reader, feedback.mParameter); continue;}
+          reader.skipValue();
+        }
+        outFeedbacks.push_back(feedback);
+      });
+    }
+
+    //-------------------------------------------------------------------------
+    template <typename Params>
+    static bool readJSONOpusCommon(
+                                   RTPTypesJSONReader &reader,
+                                   const String &name,
+                                   Params &params
+                                   )
+    {
+      if ("maxPlaybackRate" == name) {readJSONNumber(reader, "maxPlaybackRate", params.mMaxPlaybackRate); return true;}
+      if ("maxAverageBitrate" == name) {readJSONNumber(reader, "maxAverageBitrate", params.mMaxAverageBitrate); return true;}
+      if ("stereo" == name) {readJSONNumber(reader, "stereo", params.mStereo); return true;}
+      if ("cbr" == name) {readJSONNumber(reader, "cbr", params.mCBR); return true;}
+      if ("useInbandFec" == name) {readJSONNumber(reader, "useInbandFec", params.mUseInbandFEC); return true;}
+      if (0 == name.compareNoCase("useDtx")) {readJSONNumber(reader, "useDtx", params.mUseDTX); return true;}
+      if ("spropMaxCaptureRate" == name) {readJSONNumber(reader, "spropMaxCaptureRate", params.mSPropMaxCaptureRate); return true;}
+      if ("spropStereo" == name) {readJSONNumber(reader, "spropStereo", params.mSPropStereo); return true;}
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    template <typename Options>
+    static bool readJSONOpusOptions(
+                                    RTPTypesJSONReader &reader,
+                                    const String &name,
+                                    Options &options
+                                    )
+    {
+      if ("complexity" == name) {readJSONNumber(reader, "complexity", options.mComplexity); return true;}
+      if ("packetLossPerc" == name) {readJSONNumber(reader, "packetLossPerc", options.mPacketLossPerc); return true;}
+      if (0 == name.compareNoCase("predictionDisabled")) {readJSONNumber(reader, "predictionDisabled", options.mPredictionDisabled); return true;}
+      if ("signal" == name) {
+        String str;
+        readJSONValue(reader, str);
+        if (str.isEmpty()) return true;
+        try {
+          options.mSignal = OpusCodecCapabilityOptions::toSignal(str);
+        } catch(const InvalidParameters &) {
+          ZS_LOG_WARNING(Debug, slog("unknown opus signal") + ZS_PARAM("value", str))
+        }
+        return true;
+      }
+      if ("application" == name) {
+        String str;
+        readJSONValue(reader, str);
+        if (str.isEmpty()) return true;
+        try {
+          options.mApplication = OpusCodecCapabilityOptions::toApplication(str);
+        } catch(const InvalidParameters &) {
+          ZS_LOG_WARNING(Debug, slog("unknown opus application") + ZS_PARAM("value", str))
+        }
+        return true;
+      }
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, OpusCodecCapabilityOptions &options)
+    {
+      if (!reader.beginObject()) return;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if (readJSONOpusOptions(reader, name, options)) continue;
+        reader.skipValue();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, OpusCodecCapabilityParameters &params)
+    {
+      if (!reader.beginObject()) return;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if (readJSONOpusCommon(reader, name, params)) continue;
+        reader.skipValue();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, OpusCodecParameters &params)
+    {
+      if (!reader.beginObject()) return;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if (readJSONOpusCommon(reader, name, params)) continue;
+        if (readJSONOpusOptions(reader, name, params)) continue;
+        reader.skipValue();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, VP8CodecCapabilityParameters &params)
+    {
+      if (!reader.beginObject()) return;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if ("maxFr" == name) {readJSONNumber(reader, "maxFr", params.mMaxFR); continue;}
+        if ("maxFs" == name) {readJSONNumber(reader, "maxFs", params.mMaxFS); continue;}
+        reader.skipValue();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, H264CodecCapabilityParameters &params)
+    {
+      if (!reader.beginObject()) return;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if ("profileLevelId" == name) {readJSONNumber(reader, "profileLevelId", params.mProfileLevelID); continue;}
+        if ("packetizationModes" == name) {
+          reader.readList("packetizationMode", [&reader, &params]() {
+            H264CodecCapabilityParameters::PacketizationModeList::value_type value {};
+            readJSONNumber(reader, "packetizationMode", value);
+            params.mPacketizationModes.push_back(value);
+          });
+          continue;
+        }
+        if ("maxMbps" == name) {readJSONNumber(reader, "maxMbps", params.mMaxMBPS); continue;}
+        if ("maxSmbps" == name) {readJSONNumber(reader, "maxSmbps", params.mMaxSMBPS); continue;}
+        if (("mMaxFs" == name) ||
+            ("maxFs" == name)) {readJSONNumber(reader, "maxFs", params.mMaxFS); continue;}
+        if ("maxCpb" == name) {readJSONNumber(reader, "maxCpb", params.mMaxCPB); continue;}
+        if ("maxDpb" == name) {readJSONNumber(reader, "maxDpb", params.mMaxDPB); continue;}
+        if ("maxBr" == name) {readJSONNumber(reader, "maxBr", params.mMaxBR); continue;}
+        reader.skipValue();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, RTXCodecCapabilityParameters &params)
+    {
+      if (!reader.beginObject()) return;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if ("apt" == name) {readJSONNumber(reader, "apt", params.mApt); continue;}
+        if ("rtxTime" == name) {readJSONDuration(reader, "rtxTime", params.mRTXTime); continue;}
+        reader.skipValue();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, REDCodecParameters &params)
+    {
+      if (!reader.beginObject()) return;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if ("payloadTypes" == name) {
+          reader.readList("payloadType", [&reader, &params]() {
+            IRTPTypes::PayloadType value {};
+            readJSONNumber(reader, "payloadType", value);
+            params.mPayloadTypes.push_back(value);
+          });
+          continue;
+        }
+        reader.skipValue();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, FlexFECCodecCapabilityParameters &params)
+    {
+      if (!reader.beginObject()) return;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if (("repairWindow" == name) ||
+            ("rtxTime" == name)) {readJSONDuration(reader, "repairWindow", params.mRepairWindow); continue;}
+        if ("l" == name) {readJSONNumber(reader, "l", params.mL); continue;}
+        if ("d" == name) {readJSONNumber(reader, "d", params.mD); continue;}
+        if ("toP" == name) {
+          String str;
+          readJSONValue(reader, str);
+          if (str.hasData()) params.mToP = FlexFECCodecCapabilityParameters::toToP(str.c_str());
+          continue;
+        }
+        reader.skipValue();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    template <typename Params>
+    static AnyPtr readJSONCodecSpecific(RTPTypesJSONReader &reader)
+    {
+      auto params = make_shared<Params>();
+      readJSON(reader, *params);
+      return params;
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, CodecCapability &codec)
+    {
+      if (!reader.beginObject()) return;
+
+      // codec specific values depend on the codec name which is not
+      // guaranteed to preceed them so their positions are revisited after
+      const char *parametersPos = NULL;
+      const char *optionsPos = NULL;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if ("name" == name) {readJSONValue(reader, codec.mName); continue;}
+        if ("kind" == name) {readJSONValue(reader, codec.mKind); continue;}
+        if ("clockRate" == name) {readJSONNumber(reader, "clockRate", codec.mClockRate); continue;}
+        if ("preferredPayloadType" == name) {readJSONNumber(reader, "preferredPayloadType", codec.mPreferredPayloadType); continue;}
+        if ("ptime" == name) {readJSONDuration(reader, "ptime", codec.mPTime); continue;}
+        if ("maxptime" == name) {readJSONDuration(reader, "maxptime", codec.mMaxPTime); continue;}
+        if ("numChannels" == name) {readJSONNumber(reader, "numChannels", codec.mNumChannels); continue;}
+        if ("rtcpFeedbacks" == name) {readJSONFeedbacks(reader, codec.mRTCPFeedback); continue;}
+        if ("parameters" == name) {parametersPos = reader.position(); reader.skipValue(); continue;}
+        if ("options" == name) {optionsPos = reader.position(); reader.skipValue(); continue;}
+        if ("maxTemporalLayers" == name) {readJSONNumber(reader, "maxTemporalLayers", codec.mMaxTemporalLayers); continue;}
+        if ("maxSpatialLayers" == name) {readJSONNumber(reader, "maxSpatialLayers", codec.mMaxSpatialLayers); continue;}
+        if ("svcMultiStreamSupport" == name) {readJSONNumber(reader, "svcMultiStreamSupport", codec.mSVCMultiStreamSupport); continue;}
+        reader.skipValue();
+      }
+
+      if (reader.hasFailed()) return;
+
+      IRTPTypes::SupportedCodecs supported = IRTPTypes::toSupportedCodec(codec.mName);
+
+      if (parametersPos) {
+        RTPTypesJSONReader subReader(parametersPos);
+        switch (supported) {
+          case IRTPTypes::SupportedCodec_Opus:    codec.mParameters = readJSONCodecSpecific<OpusCodecCapabilityParameters>(subReader); break;
+          case IRTPTypes::SupportedCodec_VP8:     codec.mParameters = readJSONCodecSpecific<VP8CodecCapabilityParameters>(subReader); break;
+          case IRTPTypes::SupportedCodec_H264:    codec.mParameters = readJSONCodecSpecific<H264CodecCapabilityParameters>(subReader); break;
+          case IRTPTypes::SupportedCodec_RTX:     codec.mParameters = readJSONCodecSpecific<RTXCodecCapabilityParameters>(subReader); break;
+          case IRTPTypes::SupportedCodec_FlexFEC: codec.mParameters = readJSONCodecSpecific<FlexFECCodecCapabilityParameters>(subReader); break;
+          default:                                break;
+        }
+        if (subReader.hasFailed()) reader.fail();
+      }
+      if (optionsPos) {
+        RTPTypesJSONReader subReader(optionsPos);
+        switch (supported) {
+          case IRTPTypes::SupportedCodec_Opus:    codec.mOptions = readJSONCodecSpecific<OpusCodecCapabilityOptions>(subReader); break;
+          default:                                break;
+        }
+        if (subReader.hasFailed()) reader.fail();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, HeaderExtension &ext)
+    {
+      if (!reader.beginObject()) return;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if ("kind" == name) {readJSONValue(reader, ext.mKind); continue;}
+        if ("uri" == name) {readJSONValue(reader, ext.mURI); continue;}
+        if ("preferredId" == name) {readJSONNumber(reader, "preferredId", ext.mPreferredID); continue;}
+        if ("preferredEncrypt" == name) {readJSONNumber(reader, "preferredEncrypt", ext.mPreferredEncrypt); continue;}
+        reader.skipValue();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, CodecParameters &codec)
+    {
+      if (!reader.beginObject()) return;
+
+      // see CodecCapability regarding the deferred parameters
+      const char *parametersPos = NULL;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if ("name" == name) {readJSONValue(reader, codec.mName); continue;}
+        if ("payloadType" == name) {readJSONNumber(reader, "payloadType", codec.mPayloadType); continue;}
+        if ("clockRate" == name) {readJSONNumber(reader, "clockRate", codec.mClockRate); continue;}
+        if ("ptime" == name) {readJSONDuration(reader, "ptime", codec.mPTime); continue;}
+        if ("maxptime" == name) {readJSONDuration(reader, "maxptime", codec.mMaxPTime); continue;}
+        if ("numChannels" == name) {readJSONNumber(reader, "numChannels", codec.mNumChannels); continue;}
+        if ("rtcpFeedbacks" == name) {readJSONFeedbacks(reader, codec.mRTCPFeedback); continue;}
+        if ("parameters" == name) {parametersPos = reader.position(); reader.skipValue(); continue;}
+        reader.skipValue();
+      }
+
+      if (reader.hasFailed()) return;
+      if (!parametersPos) return;
+
+      RTPTypesJSONReader subReader(parametersPos);
+      switch (IRTPTypes::toSupportedCodec(codec.mName)) {
+        case IRTPTypes::SupportedCodec_Opus:    codec.mParameters = readJSONCodecSpecific<OpusCodecParameters>(subReader); break;
+        case IRTPTypes::SupportedCodec_VP8:     codec.mParameters = readJSONCodecSpecific<VP8CodecParameters>(subReader); break;
+        case IRTPTypes::SupportedCodec_H264:    codec.mParameters = readJSONCodecSpecific<H264CodecParameters>(subReader); break;
+        case IRTPTypes::SupportedCodec_RTX:     codec.mParameters = readJSONCodecSpecific<RTXCodecParameters>(subReader); break;
+        case IRTPTypes::SupportedCodec_RED:     codec.mParameters = readJSONCodecSpecific<REDCodecParameters>(subReader); break;
+        case IRTPTypes::SupportedCodec_FlexFEC: codec.mParameters = readJSONCodecSpecific<FlexFECCodecParameters>(subReader); break;
+        default:                                break;
+      }
+      if (subReader.hasFailed()) reader.fail();
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, HeaderExtensionParameters &ext)
+    {
+      if (!reader.beginObject()) return;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if ("uri" == name) {readJSONValue(reader, ext.mURI); continue;}
+        if ("id" == name) {readJSONNumber(reader, "id", ext.mID); continue;}
+        if ("encrypt" == name) {readJSONNumber(reader, "encrypt", ext.mEncrypt); continue;}
+        reader.skipValue();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, FECParameters &fec)
+    {
+      if (!reader.beginObject()) return;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if ("ssrc" == name) {readJSONNumber(reader, "ssrc", fec.mSSRC); continue;}
+        if ("mechanism" == name) {readJSONValue(reader, fec.mMechanism); continue;}
+        reader.skipValue();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, RTXParameters &rtx)
+    {
+      if (!reader.beginObject()) return;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if ("ssrc" == name) {readJSONNumber(reader, "ssrc", rtx.mSSRC); continue;}
+        reader.skipValue();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, EncodingParameters &encoding)
+    {
+      if (!reader.beginObject()) return;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if ("ssrc" == name) {readJSONNumber(reader, "ssrc", encoding.mSSRC); continue;}
+        if ("codecPayloadType" == name) {readJSONNumber(reader, "codecPayloadType", encoding.mCodecPayloadType); continue;}
+        if ("fec" == name) {
+          FECParameters fec;
+          readJSON(reader, fec);
+          encoding.mFEC = fec;
+          continue;
+        }
+        if ("rtx" == name) {
+          RTXParameters rtx;
+          readJSON(reader, rtx);
+          encoding.mRTX = rtx;
+          continue;
+        }
+        if ("priority" == name) {
+          String str;
+          readJSONValue(reader, str);
+          if (str.isEmpty()) continue;
+          encoding.mPriority = IRTPTypes::toPriorityType(str);
+          continue;
+        }
+        if ("maxBitrate" == name) {readJSONNumber(reader, "maxBitrate", encoding.mMaxBitrate); continue;}
+        if ("minQuality" == name) {readJSONNumber(reader, "minQuality", encoding.mMinQuality); continue;}
+        if ("resolutionScale" == name) {readJSONNumber(reader, "resolutionScale", encoding.mResolutionScale); continue;}
+        if ("framerateScale" == name) {readJSONNumber(reader, "framerateScale", encoding.mFramerateScale); continue;}
+        if ("active" == name) {readJSONNumber(reader, "active", encoding.mActive); continue;}
+        if ("encodingId" == name) {readJSONValue(reader, encoding.mEncodingID); continue;}
+        if ("dependencyEncodingIds" == name) {
+          reader.readList("dependencyEncodingId", [&reader, &encoding]() {
+            IRTPTypes::EncodingID value;
+            readJSONValue(reader, value);
+            encoding.mDependencyEncodingIDs.push_back(value);
+          });
+          continue;
+        }
+        reader.skipValue();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, RTCPParameters &rtcp)
+    {
+      if (!reader.beginObject()) return;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if ("ssrc" == name) {readJSONNumber(reader, "ssrc", rtcp.mSSRC); continue;}
+        if ("cname" == name) {readJSONValue(reader, rtcp.mCName); continue;}
+        if ("reducedSize" == name) {readJSONNumber(reader, "reducedSize", rtcp.mReducedSize); continue;}
+        if ("mux" == name) {readJSONNumber(reader, "mux", rtcp.mMux); continue;}
+        reader.skipValue();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, Parameters &params)
+    {
+      if (!reader.beginObject()) return;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if ("muxId" == name) {readJSONValue(reader, params.mMuxID); continue;}
+        if ("codecs" == name) {
+          reader.readList("codec", [&reader, &params]() {
+            params.mCodecs.push_back(CodecParameters());
+            readJSON(reader, params.mCodecs.back());
+          });
+          continue;
+        }
+        if ("headerExtensions" == name) {
+          reader.readList("headerExtension", [&reader, &params]() {
+            params.mHeaderExtensions.push_back(HeaderExtensionParameters());
+            readJSON(reader, params.mHeaderExtensions.back());
+          });
+          continue;
+        }
+        if ("encodings" == name) {
+          reader.readList("encoding", [&reader, &params]() {
+            params.mEncodings.push_back(EncodingParameters());
+            readJSON(reader, params.mEncodings.back());
+          });
+          continue;
+        }
+        if ("rtcp" == name) {readJSON(reader, params.mRTCP); continue;}
+        if ("degredationPreference" == name) {
+          String str;
+          readJSONValue(reader, str);
+          if (str.isEmpty()) continue;
+          try {
+            params.mDegredationPreference = IRTPTypes::toDegredationPreference(str);
+          } catch(const InvalidParameters &) {
+            ZS_LOG_WARNING(Debug, slog("degredation preference is not valid") + ZS_PARAM("value", str))
+          }
+          continue;
+        }
+        reader.skipValue();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readJSON(RTPTypesJSONReader &reader, Capabilities &capabilities)
+    {
+      if (!reader.beginObject()) return;
+
+      String name;
+      while (reader.nextMember(name)) {
+        if ("codecs" == name) {
+          reader.readList("codec", [&reader, &capabilities]() {
+            capabilities.mCodecs.push_back(CodecCapability());
+            readJSON(reader, capabilities.mCodecs.back());
+          });
+          continue;
+        }
+        if ("headerExtensions" == name) {
+          reader.readList("headerExtension", [&reader, &capabilities]() {
+            capabilities.mHeaderExtensions.push_back(HeaderExtension());
+            readJSON(reader, capabilities.mHeaderExtensions.back());
+          });
+          continue;
+        }
+        if ("fecMechanisms" == name) {
+          reader.readList("fecMechanism", [&reader, &capabilities]() {
+            IRTPTypes::FECMechanism value;
+            readJSONValue(reader, value);
+            capabilities.mFECMechanisms.push_back(value);
+          });
+          continue;
+        }
+        reader.skipValue();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    template <typename Type>
+    static std::shared_ptr<Type> readJSONDocument(
+                                                  const char *json,
+                                                  const char *objectName
+                                                  )
+    {
+      RTPTypesJSONReader reader(json);
+
+      auto result = make_shared<Type>();
+
+      if (!objectName) {
+        readJSON(reader, *result);
+      } else {
+        bool found = false;
+        if (reader.beginObject()) {
+          String name;
+          while (reader.nextMember(name)) {
+            if ((found) ||
+                (name != objectName)) {
+              reader.skipValue();
+              continue;
+            }
+            found = true;
+            readJSON(reader, *result);
+          }
+        }
+        if (!found) return std::shared_ptr<Type>();
+      }
+
+      if ((reader.hasFailed()) ||
+          (!reader.isAtEnd())) {
+        ZS_LOG_WARNING(Debug, slog("unable to parse json") + ZS_PARAM("object name", objectName))
+        return std::shared_ptr<Type>();
+      }
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (binary writer helpers)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    static void writeBE8(std::string &output, BYTE value)
+    {
+      output.push_back(static_cast<char>(value));
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeVarUInt(std::string &output, QWORD value)
+    {
+      do {
+        BYTE part = static_cast<BYTE>(value & 0x7F);
+        value >>= 7;
+        if (0 != value) part |= 0x80;
+        writeBE8(output, part);
+      } while (0 != value);
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinary(std::string &output, const String &value)
+    {
+      writeVarUInt(output, value.size());
+      output.append(value);
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinary(std::string &output, bool value)
+    {
+      writeBE8(output, value ? 1 : 0);
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinary(std::string &output, double value)
+    {
+      QWORD bits {};
+      static_assert(sizeof(bits) == sizeof(value), "double must be 64 bits");
+      memcpy(&bits, &value, sizeof(bits));
+
+      for (int shift = 56; shift >= 0; shift -= 8) {
+        writeBE8(output, static_cast<BYTE>(bits >> shift));
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    // optional values are announced in a leading presence bitmask so absent
+    // values cost nothing beyond their bit
+    class RTPTypesBinaryFlags
+    {
+    public:
+      //-----------------------------------------------------------------------
+      template <typename T>
+      void add(const Optional<T> &value)
+      {
+        if (value.hasValue()) mFlags |= (static_cast<QWORD>(1) << mIndex);
+        ++mIndex;
+      }
+
+      //-----------------------------------------------------------------------
+      void add(bool present)
+      {
+        if (present) mFlags |= (static_cast<QWORD>(1) << mIndex);
+        ++mIndex;
+      }
+
+      //-----------------------------------------------------------------------
+      void write(std::string &output) const
+      {
+        writeVarUInt(output, mFlags);
+      }
+
+    protected:
+      QWORD mFlags {};
+      size_t mIndex {};
+    };
+
+    //-------------------------------------------------------------------------
+    template <typename T>
+    static void writeBinaryNumber(std::string &output, const Optional<T> &value)
+    {
+      if (!value.hasValue()) return;
+      writeVarUInt(output, static_cast<QWORD>(value.value()));
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinaryBool(std::string &output, const Optional<bool> &value)
+    {
+      if (!value.hasValue()) return;
+      writeBinary(output, value.value());
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinaryDouble(std::string &output, const Optional<double> &value)
+    {
+      if (!value.hasValue()) return;
+      writeBinary(output, value.value());
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinaryFeedbacks(std::string &output, const IRTPTypes::RTCPFeedbackList &feedbacks)
+    {
+      writeVarUInt(output, feedbacks.size());
+      for (auto iter = feedbacks.begin(); iter != feedbacks.end(); ++iter) {
+        auto &feedback = (*iter);
+        writeBinary(output, feedback.mType);
+        writeBinary(output, feedback.mParameter);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinary(std::string &output, const OpusCodecCapabilityOptions &options)
+    {
+      RTPTypesBinaryFlags flags;
+      flags.add(options.mComplexity);
+      flags.add(options.mSignal);
+      flags.add(options.mApplication);
+      flags.add(options.mPacketLossPerc);
+      flags.add(options.mPredictionDisabled);
+      flags.write(output);
+
+      writeBinaryNumber(output, options.mComplexity);
+      writeBinaryNumber(output, options.mSignal);
+      writeBinaryNumber(output, options.mApplication);
+      writeBinaryNumber(output, options.mPacketLossPerc);
+      writeBinaryBool(output, options.mPredictionDisabled);
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinary(std::string &output, const OpusCodecCapabilityParameters &params)
+    {
+      RTPTypesBinaryFlags flags;
+      flags.add(params.mMaxPlaybackRate);
+      flags.add(params.mMaxAverageBitrate);
+      flags.add(params.mStereo);
+      flags.add(params.mCBR);
+      flags.add(params.mUseInbandFEC);
+      flags.add(params.mUseDTX);
+      flags.add(params.mSPropMaxCaptureRate);
+      flags.add(params.mSPropStereo);
+      flags.write(output);
+
+      writeBinaryNumber(output, params.mMaxPlaybackRate);
+      writeBinaryNumber(output, params.mMaxAverageBitrate);
+      writeBinaryBool(output, params.mStereo);
+      writeBinaryBool(output, params.mCBR);
+      writeBinaryBool(output, params.mUseInbandFEC);
+      writeBinaryBool(output, params.mUseDTX);
+      writeBinaryNumber(output, params.mSPropMaxCaptureRate);
+      writeBinaryBool(output, params.mSPropStereo);
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinary(std::string &output, const OpusCodecParameters &params)
+    {
+      RTPTypesBinaryFlags flags;
+      flags.add(params.mMaxPlaybackRate);
+      flags.add(params.mMaxAverageBitrate);
+      flags.add(params.mStereo);
+      flags.add(params.mCBR);
+      flags.add(params.mUseInbandFEC);
+      flags.add(params.mUseDTX);
+      flags.add(params.mComplexity);
+      flags.add(params.mSignal);
+      flags.add(params.mApplication);
+      flags.add(params.mPacketLossPerc);
+      flags.add(params.mPredictionDisabled);
+      flags.add(params.mSPropMaxCaptureRate);
+      flags.add(params.mSPropStereo);
+      flags.write(output);
+
+      writeBinaryNumber(output, params.mMaxPlaybackRate);
+      writeBinaryNumber(output, params.mMaxAverageBitrate);
+      writeBinaryBool(output, params.mStereo);
+      writeBinaryBool(output, params.mCBR);
+      writeBinaryBool(output, params.mUseInbandFEC);
+      writeBinaryBool(output, params.mUseDTX);
+      writeBinaryNumber(output, params.mComplexity);
+      writeBinaryNumber(output, params.mSignal);
+      writeBinaryNumber(output, params.mApplication);
+      writeBinaryNumber(output, params.mPacketLossPerc);
+      writeBinaryBool(output, params.mPredictionDisabled);
+      writeBinaryNumber(output, params.mSPropMaxCaptureRate);
+      writeBinaryBool(output, params.mSPropStereo);
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinary(std::string &output, const VP8CodecCapabilityParameters &params)
+    {
+      RTPTypesBinaryFlags flags;
+      flags.add(params.mMaxFR);
+      flags.add(params.mMaxFS);
+      flags.write(output);
+
+      writeBinaryNumber(output, params.mMaxFR);
+      writeBinaryNumber(output, params.mMaxFS);
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinary(std::string &output, const H264CodecCapabilityParameters &params)
+    {
+      RTPTypesBinaryFlags flags;
+      flags.add(params.mProfileLevelID);
+      flags.add(params.mMaxMBPS);
+      flags.add(params.mMaxSMBPS);
+      flags.add(params.mMaxFS);
+      flags.add(params.mMaxCPB);
+      flags.add(params.mMaxDPB);
+      flags.add(params.mMaxBR);
+      flags.write(output);
+
+      writeBinaryNumber(output, params.mProfileLevelID);
+      writeBinaryNumber(output, params.mMaxMBPS);
+      writeBinaryNumber(output, params.mMaxSMBPS);
+      writeBinaryNumber(output, params.mMaxFS);
+      writeBinaryNumber(output, params.mMaxCPB);
+      writeBinaryNumber(output, params.mMaxDPB);
+      writeBinaryNumber(output, params.mMaxBR);
+
+      writeVarUInt(output, params.mPacketizationModes.size());
+      for (auto iter = params.mPacketizationModes.begin(); iter != params.mPacketizationModes.end(); ++iter) {
+        writeVarUInt(output, *iter);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinary(std::string &output, const RTXCodecCapabilityParameters &params)
+    {
+      writeBE8(output, params.mApt);
+      writeVarUInt(output, static_cast<QWORD>(params.mRTXTime.count()));
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinary(std::string &output, const REDCodecParameters &params)
+    {
+      writeVarUInt(output, params.mPayloadTypes.size());
+      for (auto iter = params.mPayloadTypes.begin(); iter != params.mPayloadTypes.end(); ++iter) {
+        writeBE8(output, *iter);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinary(std::string &output, const FlexFECCodecCapabilityParameters &params)
+    {
+      RTPTypesBinaryFlags flags;
+      flags.add(params.mL);
+      flags.add(params.mD);
+      flags.add(params.mToP);
+      flags.write(output);
+
+      writeVarUInt(output, static_cast<QWORD>(params.mRepairWindow.count()));
+      writeBinaryNumber(output, params.mL);
+      writeBinaryNumber(output, params.mD);
+      writeBinaryNumber(output, params.mToP);
+    }
+
+    //-------------------------------------------------------------------------
+    // returns true if the codec specific value is of the expected type and
+    // was written
+    template <typename Params>
+    static bool writeBinaryCodecSpecific(std::string &output, AnyPtr any)
+    {
+      auto params = ZS_DYNAMIC_PTR_CAST(Params, any);
+      if (!params) return false;
+
+      writeBinary(output, *params);
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinary(std::string &output, const CodecCapability &codec)
+    {
+      IRTPTypes::SupportedCodecs supported = IRTPTypes::toSupportedCodec(codec.mName);
+
+      std::string codecSpecific;
+      bool hasParameters = false;
+      bool hasOptions = false;
+
+      if (codec.mParameters) {
+        switch (supported) {
+          case IRTPTypes::SupportedCodec_Opus:    hasParameters = writeBinaryCodecSpecific<OpusCodecCapabilityParameters>(codecSpecific, codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_VP8:     hasParameters = writeBinaryCodecSpecific<VP8CodecCapabilityParameters>(codecSpecific, codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_H264:    hasParameters = writeBinaryCodecSpecific<H264CodecCapabilityParameters>(codecSpecific, codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_RTX:     hasParameters = writeBinaryCodecSpecific<RTXCodecCapabilityParameters>(codecSpecific, codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_FlexFEC: hasParameters = writeBinaryCodecSpecific<FlexFECCodecCapabilityParameters>(codecSpecific, codec.mParameters); break;
+          default:                                break;
+        }
+      }
+      if (codec.mOptions) {
+        switch (supported) {
+          case IRTPTypes::SupportedCodec_Opus:    hasOptions = writeBinaryCodecSpecific<OpusCodecCapabilityOptions>(codecSpecific, codec.mOptions); break;
+          default:                                break;
+        }
+      }
+
+      RTPTypesBinaryFlags flags;
+      flags.add(codec.mClockRate);
+      flags.add(codec.mNumChannels);
+      flags.add(hasParameters);
+      flags.add(hasOptions);
+      flags.write(output);
+
+      writeBinary(output, codec.mName);
+      writeBinary(output, codec.mKind);
+      writeBinaryNumber(output, codec.mClockRate);
+      writeBE8(output, codec.mPreferredPayloadType);
+      writeVarUInt(output, static_cast<QWORD>(codec.mPTime.count()));
+      writeVarUInt(output, static_cast<QWORD>(codec.mMaxPTime.count()));
+      writeBinaryNumber(output, codec.mNumChannels);
+      writeBinaryFeedbacks(output, codec.mRTCPFeedback);
+      output.append(codecSpecific);
+      writeVarUInt(output, codec.mMaxTemporalLayers);
+      writeVarUInt(output, codec.mMaxSpatialLayers);
+      writeBinary(output, codec.mSVCMultiStreamSupport);
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinary(std::string &output, const HeaderExtension &ext)
+    {
+      writeBinary(output, ext.mKind);
+      writeBinary(output, ext.mURI);
+      writeVarUInt(output, ext.mPreferredID);
+      writeBinary(output, ext.mPreferredEncrypt);
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinary(std::string &output, const CodecParameters &codec)
+    {
+      std::string codecSpecific;
+      bool hasParameters = false;
+
+      if (codec.mParameters) {
+        switch (IRTPTypes::toSupportedCodec(codec.mName)) {
+          case IRTPTypes::SupportedCodec_Opus:    hasParameters = writeBinaryCodecSpecific<OpusCodecParameters>(codecSpecific, codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_VP8:     hasParameters = writeBinaryCodecSpecific<VP8CodecParameters>(codecSpecific, codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_H264:    hasParameters = writeBinaryCodecSpecific<H264CodecParameters>(codecSpecific, codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_RTX:     hasParameters = writeBinaryCodecSpecific<RTXCodecParameters>(codecSpecific, codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_RED:     hasParameters = writeBinaryCodecSpecific<REDCodecParameters>(codecSpecific, codec.mParameters); break;
+          case IRTPTypes::SupportedCodec_FlexFEC: hasParameters = writeBinaryCodecSpecific<FlexFECCodecParameters>(codecSpecific, codec.mParameters); break;
+          default:                                break;
+        }
+      }
+
+      RTPTypesBinaryFlags flags;
+      flags.add(codec.mClockRate);
+      flags.add(codec.mNumChannels);
+      flags.add(hasParameters);
+      flags.write(output);
+
+      writeBinary(output, codec.mName);
+      writeBE8(output, codec.mPayloadType);
+      writeBinaryNumber(output, codec.mClockRate);
+      writeVarUInt(output, static_cast<QWORD>(codec.mPTime.count()));
+      writeVarUInt(output, static_cast<QWORD>(codec.mMaxPTime.count()));
+      writeBinaryNumber(output, codec.mNumChannels);
+      writeBinaryFeedbacks(output, codec.mRTCPFeedback);
+      output.append(codecSpecific);
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinary(std::string &output, const HeaderExtensionParameters &ext)
+    {
+      writeBinary(output, ext.mURI);
+      writeVarUInt(output, ext.mID);
+      writeBinary(output, ext.mEncrypt);
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinary(std::string &output, const EncodingParameters &encoding)
+    {
+      RTPTypesBinaryFlags flags;
+      flags.add(encoding.mSSRC);
+      flags.add(encoding.mCodecPayloadType);
+      flags.add(encoding.mFEC);
+      flags.add(encoding.mFEC.hasValue() && encoding.mFEC.value().mSSRC.hasValue());
+      flags.add(encoding.mRTX);
+      flags.add(encoding.mRTX.hasValue() && encoding.mRTX.value().mSSRC.hasValue());
+      flags.add(encoding.mMaxBitrate);
+      flags.add(encoding.mMinQuality);
+      flags.add(encoding.mResolutionScale);
+      flags.add(encoding.mFramerateScale);
+      flags.write(output);
+
+      writeBinaryNumber(output, encoding.mSSRC);
+      writeBinaryNumber(output, encoding.mCodecPayloadType);
+      if (encoding.mFEC.hasValue()) {
+        writeBinaryNumber(output, encoding.mFEC.value().mSSRC);
+        writeBinary(output, encoding.mFEC.value().mMechanism);
+      }
+      if (encoding.mRTX.hasValue()) {
+        writeBinaryNumber(output, encoding.mRTX.value().mSSRC);
+      }
+      writeBE8(output, static_cast<BYTE>(encoding.mPriority));
+      writeBinaryNumber(output, encoding.mMaxBitrate);
+      writeBinaryDouble(output, encoding.mMinQuality);
+      writeBinaryDouble(output, encoding.mResolutionScale);
+      writeBinaryDouble(output, encoding.mFramerateScale);
+      writeBinary(output, encoding.mActive);
+      writeBinary(output, encoding.mEncodingID);
+
+      writeVarUInt(output, encoding.mDependencyEncodingIDs.size());
+      for (auto iter = encoding.mDependencyEncodingIDs.begin(); iter != encoding.mDependencyEncodingIDs.end(); ++iter) {
+        writeBinary(output, *iter);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinary(std::string &output, const RTCPParameters &rtcp)
+    {
+      writeVarUInt(output, rtcp.mSSRC);
+      writeBinary(output, rtcp.mCName);
+      writeBinary(output, rtcp.mReducedSize);
+      writeBinary(output, rtcp.mMux);
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBinaryHeader(std::string &output, RTPTypesSerializer::BinaryTypes type)
+    {
+      output.append(reinterpret_cast<const char *>(kRTPTypesSerializerMagic), sizeof(kRTPTypesSerializerMagic));
+      writeBE8(output, RTPTypesSerializer::kBinaryVersion);
+      writeBE8(output, static_cast<BYTE>(type));
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPTypesBinaryReader
+    #pragma mark
+
+    // Bounds checked reader; once a read fails every following read returns
+    // zero values so decoders only need to check for failure at the end.
+    class RTPTypesBinaryReader
+    {
+    public:
+      //-----------------------------------------------------------------------
+      RTPTypesBinaryReader(
+                           const BYTE *buffer,
+                           size_t bufferSizeInBytes
+                           ) :
+        mPos(buffer),
+        mEnd(buffer + bufferSizeInBytes)
+      {
+        if (!buffer) mEnd = mPos;
+      }
+
+      //-----------------------------------------------------------------------
+      bool hasFailed() const {return mFailed;}
+      bool isAtEnd() const {return mPos == mEnd;}
+      void fail() {mFailed = true; mPos = mEnd;}
+
+      //-----------------------------------------------------------------------
+      BYTE readBE8()
+      {
+        if (mPos >= mEnd) {
+          fail();
+          return 0;
+        }
+        return *(mPos++);
+      }
+
+      //-----------------------------------------------------------------------
+      QWORD readVarUInt()
+      {
+        QWORD result = 0;
+        for (size_t shift = 0; shift < 64; shift += 7) {
+          BYTE part = readBE8();
+          result |= (static_cast<QWORD>(part & 0x7F) << shift);
+          if (0 == (part & 0x80)) return result;
+        }
+        fail();
+        return 0;
+      }
+
+      //-----------------------------------------------------------------------
+      template <typename T>
+      T readVarUIntAs()
+      {
+        QWORD value = readVarUInt();
+        if (value > static_cast<QWORD>(std::numeric_limits<T>::max())) {
+          fail();
+          return T();
+        }
+        return static_cast<T>(value);
+      }
+
+      //-----------------------------------------------------------------------
+      // every list entry takes at least one byte so larger counts can only be
+      // the result of a corrupt buffer
+      size_t readCount()
+      {
+        QWORD count = readVarUInt();
+        if (count > static_cast<QWORD>(mEnd - mPos)) {
+          fail();
+          return 0;
+        }
+        return static_cast<size_t>(count);
+      }
+
+      //-----------------------------------------------------------------------
+      bool readBool()
+      {
+        BYTE value = readBE8();
+        if (value > 1) fail();
+        return 0 != value;
+      }
+
+      //-----------------------------------------------------------------------
+      double readDouble()
+      {
+        QWORD bits = 0;
+        for (int index = 0; index < 8; ++index) {
+          bits = (bits << 8) | readBE8();
+        }
+
+        double result {};
+        memcpy(&result, &bits, sizeof(result));
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      void readString(String &outValue)
+      {
+        size_t length = readCount();
+        outValue.assign(reinterpret_cast<const char *>(mPos), length);
+        mPos += length;
+      }
+
+    protected:
+      const BYTE *mPos {};
+      const BYTE *mEnd {};
+      bool mFailed {false};
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (binary reader helpers)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    class RTPTypesBinaryFlagsReader
+    {
+    public:
+      //-----------------------------------------------------------------------
+      RTPTypesBinaryFlagsReader(RTPTypesBinaryReader &reader) :
+        mFlags(reader.readVarUInt())
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      bool next()
+      {
+        bool result = (0 != (mFlags & (static_cast<QWORD>(1) << mIndex)));
+        ++mIndex;
+        return result;
+      }
+
+    protected:
+      QWORD mFlags {};
+      size_t mIndex {};
+    };
+
+    //-------------------------------------------------------------------------
+    template <typename T>
+    static void readBinaryNumber(
+                                 RTPTypesBinaryReader &reader,
+                                 bool present,
+                                 Optional<T> &outValue
+                                 )
+    {
+      if (!present) return;
+      outValue = reader.readVarUIntAs<T>();
+    }
+
+    //-------------------------------------------------------------------------
+    template <typename Enum>
+    static void readBinaryEnum(
+                               RTPTypesBinaryReader &reader,
+                               bool present,
+                               Enum last,
+                               Optional<Enum> &outValue
+                               )
+    {
+      if (!present) return;
+
+      QWORD value = reader.readVarUInt();
+      if (value > static_cast<QWORD>(last)) {
+        reader.fail();
+        return;
+      }
+      outValue = static_cast<Enum>(value);
+    }
+
+    //-------------------------------------------------------------------------
+    static void readBinaryBool(
+                               RTPTypesBinaryReader &reader,
+                               bool present,
+                               Optional<bool> &outValue
+                               )
+    {
+      if (!present) return;
+      outValue = reader.readBool();
+    }
+
+    //-------------------------------------------------------------------------
+    static void readBinaryDouble(
+                                 RTPTypesBinaryReader &reader,
+                                 bool present,
+                                 Optional<double> &outValue
+                                 )
+    {
+      if (!present) return;
+      outValue = reader.readDouble();
+    }
+
+    //-------------------------------------------------------------------------
+    template <typename Duration>
+    static Duration readBinaryDuration(RTPTypesBinaryReader &reader)
+    {
+      return Duration(reader.readVarUIntAs<typename Duration::rep>());
+    }
+
+    //-------------------------------------------------------------------------
+    static void readBinaryFeedbacks(
+                                    RTPTypesBinaryReader &reader,
+                                    IRTPTypes::RTCPFeedbackList &outFeedbacks
+                                    )
+    {
+      size_t count = reader.readCount();
+      for (size_t index = 0; index < count; ++index) {
+        RTCPFeedback feedback;
+        reader.readString(feedback.mType);
+        reader.readString(feedback.mParameter);
+        outFeedbacks.push_back(feedback);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readBinary(RTPTypesBinaryReader &reader, OpusCodecCapabilityOptions &options)
+    {
+      RTPTypesBinaryFlagsReader flags(reader);
+      bool hasComplexity = flags.next();
+      bool hasSignal = flags.next();
+      bool hasApplication = flags.next();
+      bool hasPacketLossPerc = flags.next();
+      bool hasPredictionDisabled = flags.next();
+
+      readBinaryNumber(reader, hasComplexity, options.mComplexity);
+      readBinaryEnum(reader, hasSignal, OpusCodecCapabilityOptions::Signal_Last, options.mSignal);
+      readBinaryEnum(reader, hasApplication, OpusCodecCapabilityOptions::Application_Last, options.mApplication);
+      readBinaryNumber(reader, hasPacketLossPerc, options.mPacketLossPerc);
+      readBinaryBool(reader, hasPredictionDisabled, options.mPredictionDisabled);
+    }
+
+    //-------------------------------------------------------------------------
+    static void readBinary(RTPTypesBinaryReader &reader, OpusCodecCapabilityParameters &params)
+    {
+      RTPTypesBinaryFlagsReader flags(reader);
+      bool hasMaxPlaybackRate = flags.next();
+      bool hasMaxAverageBitrate = flags.next();
+      bool hasStereo = flags.next();
+      bool hasCBR = flags.next();
+      bool hasUseInbandFEC = flags.next();
+      bool hasUseDTX = flags.next();
+      bool hasSPropMaxCaptureRate = flags.next();
+      bool hasSPropStereo = flags.next();
+
+      readBinaryNumber(reader, hasMaxPlaybackRate, params.mMaxPlaybackRate);
+      readBinaryNumber(reader, hasMaxAverageBitrate, params.mMaxAverageBitrate);
+      readBinaryBool(reader, hasStereo, params.mStereo);
+      readBinaryBool(reader, hasCBR, params.mCBR);
+      readBinaryBool(reader, hasUseInbandFEC, params.mUseInbandFEC);
+      readBinaryBool(reader, hasUseDTX, params.mUseDTX);
+      readBinaryNumber(reader, hasSPropMaxCaptureRate, params.mSPropMaxCaptureRate);
+      readBinaryBool(reader, hasSPropStereo, params.mSPropStereo);
+    }
+
+    //-------------------------------------------------------------------------
+    static void readBinary(RTPTypesBinaryReader &reader, OpusCodecParameters &params)
+    {
+      RTPTypesBinaryFlagsReader flags(reader);
+      bool hasMaxPlaybackRate = flags.next();
+      bool hasMaxAverageBitrate = flags.next();
+      bool hasStereo = flags.next();
+      bool hasCBR = flags.next();
+      bool hasUseInbandFEC = flags.next();
+      bool hasUseDTX = flags.next();
+      bool hasComplexity = flags.next();
+      bool hasSignal = flags.next();
+      bool hasApplication = flags.next();
+      bool hasPacketLossPerc = flags.next();
+      bool hasPredictionDisabled = flags.next();
+      bool hasSPropMaxCaptureRate = flags.next();
+      bool hasSPropStereo = flags.next();
+
+      readBinaryNumber(reader, hasMaxPlaybackRate, params.mMaxPlaybackRate);
+      readBinaryNumber(reader, hasMaxAverageBitrate, params.mMaxAverageBitrate);
+      readBinaryBool(reader, hasStereo, params.mStereo);
+      readBinaryBool(reader, hasCBR, params.mCBR);
+      readBinaryBool(reader, hasUseInbandFEC, params.mUseInbandFEC);
+      readBinaryBool(reader, hasUseDTX, params.mUseDTX);
+      readBinaryNumber(reader, hasComplexity, params.mComplexity);
+      readBinaryEnum(reader, hasSignal, OpusCodecCapabilityOptions::Signal_Last, params.mSignal);
+      readBinaryEnum(reader, hasApplication, OpusCodecCapabilityOptions::Application_Last, params.mApplication);
+      readBinaryNumber(reader, hasPacketLossPerc, params.mPacketLossPerc);
+      readBinaryBool(reader, hasPredictionDisabled, params.mPredictionDisabled);
+      readBinaryNumber(reader, hasSPropMaxCaptureRate, params.mSPropMaxCaptureRate);
+      readBinaryBool(reader, hasSPropStereo, params.mSPropStereo);
+    }
+
+    //-------------------------------------------------------------------------
+    static void readBinary(RTPTypesBinaryReader &reader, VP8CodecCapabilityParameters &params)
+    {
+      RTPTypesBinaryFlagsReader flags(reader);
+      bool hasMaxFR = flags.next();
+      bool hasMaxFS = flags.next();
+
+      readBinaryNumber(reader, hasMaxFR, params.mMaxFR);
+      readBinaryNumber(reader, hasMaxFS, params.mMaxFS);
+    }
+
+    //-------------------------------------------------------------------------
+    static void readBinary(RTPTypesBinaryReader &reader, H264CodecCapabilityParameters &params)
+    {
+      RTPTypesBinaryFlagsReader flags(reader);
+      bool hasProfileLevelID = flags.next();
+      bool hasMaxMBPS = flags.next();
+      bool hasMaxSMBPS = flags.next();
+      bool hasMaxFS = flags.next();
+      bool hasMaxCPB = flags.next();
+      bool hasMaxDPB = flags.next();
+      bool hasMaxBR = flags.next();
+
+      readBinaryNumber(reader, hasProfileLevelID, params.mProfileLevelID);
+      readBinaryNumber(reader, hasMaxMBPS, params.mMaxMBPS);
+      readBinaryNumber(reader, hasMaxSMBPS, params.mMaxSMBPS);
+      readBinaryNumber(reader, hasMaxFS, params.mMaxFS);
+      readBinaryNumber(reader, hasMaxCPB, params.mMaxCPB);
+      readBinaryNumber(reader, hasMaxDPB, params.mMaxDPB);
+      readBinaryNumber(reader, hasMaxBR, params.mMaxBR);
+
+      size_t count = reader.readCount();
+      for (size_t index = 0; index < count; ++index) {
+        params.mPacketizationModes.push_back(reader.readVarUIntAs<H264CodecCapabilityParameters::PacketizationModeList::value_type>());
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readBinary(RTPTypesBinaryReader &reader, RTXCodecCapabilityParameters &params)
+    {
+      params.mApt = reader.readBE8();
+      params.mRTXTime = readBinaryDuration<Milliseconds>(reader);
+    }
+
+    //-------------------------------------------------------------------------
+    static void readBinary(RTPTypesBinaryReader &reader, REDCodecParameters &params)
+    {
+      size_t count = reader.readCount();
+      for (size_t index = 0; index < count; ++index) {
+        params.mPayloadTypes.push_back(reader.readBE8());
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readBinary(RTPTypesBinaryReader &reader, FlexFECCodecCapabilityParameters &params)
+    {
+      RTPTypesBinaryFlagsReader flags(reader);
+      bool hasL = flags.next();
+      bool hasD = flags.next();
+      bool hasToP = flags.next();
+
+      params.mRepairWindow = readBinaryDuration<Microseconds>(reader);
+      readBinaryNumber(reader, hasL, params.mL);
+      readBinaryNumber(reader, hasD, params.mD);
+      readBinaryEnum(reader, hasToP, FlexFECCodecCapabilityParameters::ToP_Last, params.mToP);
+    }
+
+    //-------------------------------------------------------------------------
+    template <typename Params>
+    static AnyPtr readBinaryCodecSpecific(RTPTypesBinaryReader &reader)
+    {
+      auto params = make_shared<Params>();
+      readBinary(reader, *params);
+      return params;
+    }
+
+    //-------------------------------------------------------------------------
+    static void readBinary(RTPTypesBinaryReader &reader, CodecCapability &codec)
+    {
+      RTPTypesBinaryFlagsReader flags(reader);
+      bool hasClockRate = flags.next();
+      bool hasNumChannels = flags.next();
+      bool hasParameters = flags.next();
+      bool hasOptions = flags.next();
+
+      reader.readString(codec.mName);
+      reader.readString(codec.mKind);
+      readBinaryNumber(reader, hasClockRate, codec.mClockRate);
+      codec.mPreferredPayloadType = reader.readBE8();
+      codec.mPTime = readBinaryDuration<Milliseconds>(reader);
+      codec.mMaxPTime = readBinaryDuration<Milliseconds>(reader);
+      readBinaryNumber(reader, hasNumChannels, codec.mNumChannels);
+      readBinaryFeedbacks(reader, codec.mRTCPFeedback);
+
+      IRTPTypes::SupportedCodecs supported = IRTPTypes::toSupportedCodec(codec.mName);
+
+      if (hasParameters) {
+        switch (supported) {
+          case IRTPTypes::SupportedCodec_Opus:    codec.mParameters = readBinaryCodecSpecific<OpusCodecCapabilityParameters>(reader); break;
+          case IRTPTypes::SupportedCodec_VP8:     codec.mParameters = readBinaryCodecSpecific<VP8CodecCapabilityParameters>(reader); break;
+          case IRTPTypes::SupportedCodec_H264:    codec.mParameters = readBinaryCodecSpecific<H264CodecCapabilityParameters>(reader); break;
+          case IRTPTypes::SupportedCodec_RTX:     codec.mParameters = readBinaryCodecSpecific<RTXCodecCapabilityParameters>(reader); break;
+          case IRTPTypes::SupportedCodec_FlexFEC: codec.mParameters = readBinaryCodecSpecific<FlexFECCodecCapabilityParameters>(reader); break;
+          default:                                reader.fail(); break;
+        }
+      }
+      if (hasOptions) {
+        switch (supported) {
+          case IRTPTypes::SupportedCodec_Opus:    codec.mOptions = readBinaryCodecSpecific<OpusCodecCapabilityOptions>(reader); break;
+          default:                                reader.fail(); break;
+        }
+      }
+
+      codec.mMaxTemporalLayers = reader.readVarUIntAs<USHORT>();
+      codec.mMaxSpatialLayers = reader.readVarUIntAs<USHORT>();
+      codec.mSVCMultiStreamSupport = reader.readBool();
+    }
+
+    //-------------------------------------------------------------------------
+    static void readBinary(RTPTypesBinaryReader &reader, HeaderExtension &ext)
+    {
+      reader.readString(ext.mKind);
+      reader.readString(ext.mURI);
+      ext.mPreferredID = reader.readVarUIntAs<USHORT>();
+      ext.mPreferredEncrypt = reader.readBool();
+    }
+
+    //-------------------------------------------------------------------------
+    static void readBinary(RTPTypesBinaryReader &reader, CodecParameters &codec)
+    {
+      RTPTypesBinaryFlagsReader flags(reader);
+      bool hasClockRate = flags.next();
+      bool hasNumChannels = flags.next();
+      bool hasParameters = flags.next();
+
+      reader.readString(codec.mName);
+      codec.mPayloadType = reader.readBE8();
+      readBinaryNumber(reader, hasClockRate, codec.mClockRate);
+      codec.mPTime = readBinaryDuration<Milliseconds>(reader);
+      codec.mMaxPTime = readBinaryDuration<Milliseconds>(reader);
+      readBinaryNumber(reader, hasNumChannels, codec.mNumChannels);
+      readBinaryFeedbacks(reader, codec.mRTCPFeedback);
+
+      if (!hasParameters) return;
+
+      switch (IRTPTypes::toSupportedCodec(codec.mName)) {
+        case IRTPTypes::SupportedCodec_Opus:    codec.mParameters = readBinaryCodecSpecific<OpusCodecParameters>(reader); break;
+        case IRTPTypes::SupportedCodec_VP8:     codec.mParameters = readBinaryCodecSpecific<VP8CodecParameters>(reader); break;
+        case IRTPTypes::SupportedCodec_H264:    codec.mParameters = readBinaryCodecSpecific<H264CodecParameters>(reader); break;
+        case IRTPTypes::SupportedCodec_RTX:     codec.mParameters = readBinaryCodecSpecific<RTXCodecParameters>(reader); break;
+        case IRTPTypes::SupportedCodec_RED:     codec.mParameters = readBinaryCodecSpecific<REDCodecParameters>(reader); break;
+        case IRTPTypes::SupportedCodec_FlexFEC: codec.mParameters = readBinaryCodecSpecific<FlexFECCodecParameters>(reader); break;
+        default:                                reader.fail(); break;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readBinary(RTPTypesBinaryReader &reader, HeaderExtensionParameters &ext)
+    {
+      reader.readString(ext.mURI);
+      ext.mID = reader.readVarUIntAs<USHORT>();
+      ext.mEncrypt = reader.readBool();
+    }
+
+    //-------------------------------------------------------------------------
+    static void readBinary(RTPTypesBinaryReader &reader, EncodingParameters &encoding)
+    {
+      RTPTypesBinaryFlagsReader flags(reader);
+      bool hasSSRC = flags.next();
+      bool hasCodecPayloadType = flags.next();
+      bool hasFEC = flags.next();
+      bool hasFECSSRC = flags.next();
+      bool hasRTX = flags.next();
+      bool hasRTXSSRC = flags.next();
+      bool hasMaxBitrate = flags.next();
+      bool hasMinQuality = flags.next();
+      bool hasResolutionScale = flags.next();
+      bool hasFramerateScale = flags.next();
+
+      readBinaryNumber(reader, hasSSRC, encoding.mSSRC);
+      readBinaryNumber(reader, hasCodecPayloadType, encoding.mCodecPayloadType);
+      if (hasFEC) {
+        FECParameters fec;
+        readBinaryNumber(reader, hasFECSSRC, fec.mSSRC);
+        reader.readString(fec.mMechanism);
+        encoding.mFEC = fec;
+      }
+      if (hasRTX) {
+        RTXParameters rtx;
+        readBinaryNumber(reader, hasRTXSSRC, rtx.mSSRC);
+        encoding.mRTX = rtx;
+      }
+
+      BYTE priority = reader.readBE8();
+      if (priority > IRTPTypes::PriorityType_Last) reader.fail();
+      encoding.mPriority = static_cast<IRTPTypes::PriorityTypes>(priority);
+
+      readBinaryNumber(reader, hasMaxBitrate, encoding.mMaxBitrate);
+
+      // minimum quality defaults to a value so absence must be explicit
+      encoding.mMinQuality = Optional<double>();
+      readBinaryDouble(reader, hasMinQuality, encoding.mMinQuality);
+      readBinaryDouble(reader, hasResolutionScale, encoding.mResolutionScale);
+      readBinaryDouble(reader, hasFramerateScale, encoding.mFramerateScale);
+
+      encoding.mActive = reader.readBool();
+      reader.readString(encoding.mEncodingID);
+
+      size_t count = reader.readCount();
+      for (size_t index = 0; index < count; ++index) {
+        IRTPTypes::EncodingID value;
+        reader.readString(value);
+        encoding.mDependencyEncodingIDs.push_back(value);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    static void readBinary(RTPTypesBinaryReader &reader, RTCPParameters &rtcp)
+    {
+      rtcp.mSSRC = reader.readVarUIntAs<IRTPTypes::SSRCType>();
+      reader.readString(rtcp.mCName);
+      rtcp.mReducedSize = reader.readBool();
+      rtcp.mMux = reader.readBool();
+    }
+
+    //-------------------------------------------------------------------------
+    static bool readBinaryHeader(
+                                 RTPTypesBinaryReader &reader,
+                                 RTPTypesSerializer::BinaryTypes type
+                                 )
+    {
+      for (size_t index = 0; index < sizeof(kRTPTypesSerializerMagic); ++index) {
+        if (kRTPTypesSerializerMagic[index] != reader.readBE8()) return false;
+      }
+
+      BYTE version = reader.readBE8();
+      if (RTPTypesSerializer::kBinaryVersion != version) {
+        ZS_LOG_WARNING(Debug, slog("binary encoding version is not supported") + ZS_PARAM("version", version))
+        return false;
+      }
+
+      BYTE binaryType = reader.readBE8();
+      if (static_cast<BYTE>(type) != binaryType) {
+        ZS_LOG_WARNING(Debug, slog("binary encoding is not of the expected type") + ZS_PARAM("expected", static_cast<BYTE>(type)) + ZS_PARAM("found", binaryType))
+        return false;
+      }
+
+      return !reader.hasFailed();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPTypesSerializer
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPTypesSerializer::writeJSON(
+                                       std::string &output,
+                                       const Parameters &params
+                                       )
+    {
+      bool first = true;
+      output.append(1, '{');
+
+      writeJSONValue(output, first, "muxId", params.mMuxID);
+
+      RTPTypesSerializer::writeJSONList(output, first, "codecs", "codec", params.mCodecs, [](std::string &itemOutput, const CodecParameters &codec) {
+        internal::writeJSON(itemOutput, codec);
+      });
+      RTPTypesSerializer::writeJSONList(output, first, "headerExtensions", "headerExtension", params.mHeaderExtensions, [](std::string &itemOutput, const HeaderExtensionParameters &ext) {
+        internal::writeJSON(itemOutput, ext);
+      });
+      RTPTypesSerializer::writeJSONList(output, first, "encodings", "encoding", params.mEncodings, [](std::string &itemOutput, const EncodingParameters &encoding) {
+        internal::writeJSON(itemOutput, encoding);
+      });
+
+      writeJSONName(output, first, "rtcp");
+      internal::writeJSON(output, params.mRTCP);
+
+      writeJSONValue(output, first, "degredationPreference", IRTPTypes::toString(params.mDegredationPreference));
+
+      output.append(1, '}');
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPTypesSerializer::writeJSON(
+                                       std::string &output,
+                                       const Capabilities &capabilities
+                                       )
+    {
+      bool first = true;
+      output.append(1, '{');
+
+      RTPTypesSerializer::writeJSONList(output, first, "codecs", "codec", capabilities.mCodecs, [](std::string &itemOutput, const CodecCapability &codec) {
+        internal::writeJSON(itemOutput, codec);
+      });
+      RTPTypesSerializer::writeJSONList(output, first, "headerExtensions", "headerExtension", capabilities.mHeaderExtensions, [](std::string &itemOutput, const HeaderExtension &ext) {
+        internal::writeJSON(itemOutput, ext);
+      });
+      RTPTypesSerializer::writeJSONList(output, first, "fecMechanisms", "fecMechanism", capabilities.mFECMechanisms, [](std::string &itemOutput, const IRTPTypes::FECMechanism &mechanism) {
+        writeJSONString(itemOutput, mechanism.c_str());
+      });
+
+      output.append(1, '}');
+    }
+
+    //-------------------------------------------------------------------------
+    String RTPTypesSerializer::toJSON(
+                                      const Parameters &params,
+                                      const char *objectName
+                                      )
+    {
+      std::string output;
+      output.reserve(256 + (params.mCodecs.size() * 128) + (params.mHeaderExtensions.size() * 96) + (params.mEncodings.size() * 128));
+
+      if (!objectName) {
+        writeJSON(output, params);
+        return String(output);
+      }
+
+      bool first = true;
+      output.append(1, '{');
+      writeJSONName(output, first, objectName);
+      writeJSON(output, params);
+      output.append(1, '}');
+
+      return String(output);
+    }
+
+    //-------------------------------------------------------------------------
+    String RTPTypesSerializer::toJSON(
+                                      const Capabilities &capabilities,
+                                      const char *objectName
+                                      )
+    {
+      std::string output;
+      output.reserve(128 + (capabilities.mCodecs.size() * 192) + (capabilities.mHeaderExtensions.size() * 96));
+
+      if (!objectName) {
+        writeJSON(output, capabilities);
+        return String(output);
+      }
+
+      bool first = true;
+      output.append(1, '{');
+      writeJSONName(output, first, objectName);
+      writeJSON(output, capabilities);
+      output.append(1, '}');
+
+      return String(output);
+    }
+
+    //-------------------------------------------------------------------------
+    RTPTypesSerializer::ParametersPtr RTPTypesSerializer::createParametersFromJSON(
+                                                                                   const char *json,
+                                                                                   const char *objectName
+                                                                                   )
+    {
+      return readJSONDocument<Parameters>(json, objectName);
+    }
+
+    //-------------------------------------------------------------------------
+    RTPTypesSerializer::CapabilitiesPtr RTPTypesSerializer::createCapabilitiesFromJSON(
+                                                                                       const char *json,
+                                                                                       const char *objectName
+                                                                                       )
+    {
+      return readJSONDocument<Capabilities>(json, objectName);
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPTypesSerializer::readJSON(
+                                      RTPTypesJSONReader &reader,
+                                      Parameters &outParams
+                                      )
+    {
+      internal::readJSON(reader, outParams);
+      return !reader.hasFailed();
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPTypesSerializer::readJSON(
+                                      RTPTypesJSONReader &reader,
+                                      Capabilities &outCapabilities
+                                      )
+    {
+      internal::readJSON(reader, outCapabilities);
+      return !reader.hasFailed();
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPTypesSerializer::writeJSONString(
+                                             std::string &output,
+                                             const char *value
+                                             )
+    {
+      internal::writeJSONString(output, value ? value : "");
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPTypesSerializer::writeJSONName(
+                                           std::string &output,
+                                           bool &ioFirst,
+                                           const char *name
+                                           )
+    {
+      internal::writeJSONName(output, ioFirst, name);
+    }
+
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr RTPTypesSerializer::encodeBinary(const Parameters &params)
+    {
+      std::string output;
+      output.reserve(64 + (params.mCodecs.size() * 32) + (params.mHeaderExtensions.size() * 64) + (params.mEncodings.size() * 32));
+
+      writeBinaryHeader(output, BinaryType_Parameters);
+
+      writeBinary(output, params.mMuxID);
+
+      writeVarUInt(output, params.mCodecs.size());
+      for (auto iter = params.mCodecs.begin(); iter != params.mCodecs.end(); ++iter) {
+        writeBinary(output, *iter);
+      }
+
+      writeVarUInt(output, params.mHeaderExtensions.size());
+      for (auto iter = params.mHeaderExtensions.begin(); iter != params.mHeaderExtensions.end(); ++iter) {
+        writeBinary(output, *iter);
+      }
+
+      writeVarUInt(output, params.mEncodings.size());
+      for (auto iter = params.mEncodings.begin(); iter != params.mEncodings.end(); ++iter) {
+        writeBinary(output, *iter);
+      }
+
+      writeBinary(output, params.mRTCP);
+      writeBE8(output, static_cast<BYTE>(params.mDegredationPreference));
+
+      return make_shared<SecureByteBlock>(reinterpret_cast<const BYTE *>(output.c_str()), output.size());
+    }
+
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr RTPTypesSerializer::encodeBinary(const Capabilities &capabilities)
+    {
+      std::string output;
+      output.reserve(64 + (capabilities.mCodecs.size() * 48) + (capabilities.mHeaderExtensions.size() * 64));
+
+      writeBinaryHeader(output, BinaryType_Capabilities);
+
+      writeVarUInt(output, capabilities.mCodecs.size());
+      for (auto iter = capabilities.mCodecs.begin(); iter != capabilities.mCodecs.end(); ++iter) {
+        writeBinary(output, *iter);
+      }
+
+      writeVarUInt(output, capabilities.mHeaderExtensions.size());
+      for (auto iter = capabilities.mHeaderExtensions.begin(); iter != capabilities.mHeaderExtensions.end(); ++iter) {
+        writeBinary(output, *iter);
+      }
+
+      writeVarUInt(output, capabilities.mFECMechanisms.size());
+      for (auto iter = capabilities.mFECMechanisms.begin(); iter != capabilities.mFECMechanisms.end(); ++iter) {
+        writeBinary(output, *iter);
+      }
+
+      return make_shared<SecureByteBlock>(reinterpret_cast<const BYTE *>(output.c_str()), output.size());
+    }
+
+    //-------------------------------------------------------------------------
+    RTPTypesSerializer::ParametersPtr RTPTypesSerializer::decodeParameters(
+                                                                           const BYTE *buffer,
+                                                                           size_t bufferSizeInBytes
+                                                                           )
+    {
+      RTPTypesBinaryReader reader(buffer, bufferSizeInBytes);
+      if (!readBinaryHeader(reader, BinaryType_Parameters)) return ParametersPtr();
+
+      auto result = make_shared<Parameters>();
+
+      reader.readString(result->mMuxID);
+
+      size_t codecCount = reader.readCount();
+      for (size_t index = 0; index < codecCount; ++index) {
+        result->mCodecs.push_back(CodecParameters());
+        readBinary(reader, result->mCodecs.back());
+      }
+
+      size_t extCount = reader.readCount();
+      for (size_t index = 0; index < extCount; ++index) {
+        result->mHeaderExtensions.push_back(HeaderExtensionParameters());
+        readBinary(reader, result->mHeaderExtensions.back());
+      }
+
+      size_t encodingCount = reader.readCount();
+      for (size_t index = 0; index < encodingCount; ++index) {
+        result->mEncodings.push_back(EncodingParameters());
+        readBinary(reader, result->mEncodings.back());
+      }
+
+      readBinary(reader, result->mRTCP);
+
+      BYTE preference = reader.readBE8();
+      if (preference > IRTPTypes::DegradationPreference_Last) reader.fail();
+      result->mDegredationPreference = static_cast<IRTPTypes::DegradationPreferences>(preference);
+
+      if ((reader.hasFailed()) ||
+          (!reader.isAtEnd())) {
+        ZS_LOG_WARNING(Debug, slog("unable to decode binary parameters") + ZS_PARAM("size", bufferSizeInBytes))
+        return ParametersPtr();
+      }
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    RTPTypesSerializer::CapabilitiesPtr RTPTypesSerializer::decodeCapabilities(
+                                                                               const BYTE *buffer,
+                                                                               size_t bufferSizeInBytes
+                                                                               )
+    {
+      RTPTypesBinaryReader reader(buffer, bufferSizeInBytes);
+      if (!readBinaryHeader(reader, BinaryType_Capabilities)) return CapabilitiesPtr();
+
+      auto result = make_shared<Capabilities>();
+
+      size_t codecCount = reader.readCount();
+      for (size_t index = 0; index < codecCount; ++index) {
+        result->mCodecs.push_back(CodecCapability());
+        readBinary(reader, result->mCodecs.back());
+      }
+
+      size_t extCount = reader.readCount();
+      for (size_t index = 0; index < extCount; ++index) {
+        result->mHeaderExtensions.push_back(HeaderExtension());
+        readBinary(reader, result->mHeaderExtensions.back());
+      }
+
+      size_t mechanismCount = reader.readCount();
+      for (size_t index = 0; index < mechanismCount; ++index) {
+        IRTPTypes::FECMechanism value;
+        reader.readString(value);
+        result->mFECMechanisms.push_back(value);
+      }
+
+      if ((reader.hasFailed()) ||
+          (!reader.isAtEnd())) {
+        ZS_LOG_WARNING(Debug, slog("unable to decode binary capabilities") + ZS_PARAM("size", bufferSizeInBytes))
+        return CapabilitiesPtr();
+      }
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params RTPTypesSerializer::slog(const char *message)
+    {
+      return Log::Params(message, "ortc::RTPTypesSerializer");
+    }
+  }
+}
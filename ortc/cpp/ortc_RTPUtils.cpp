@@ -459,6 +459,18 @@ namespace ortc
       return (epoch + secondsSince) + totalMicrosecondsSince;
     }
 
+    //-------------------------------------------------------------------------
+    DWORD RTPUtils::timeToCompactNTP(const Time &time)
+    {
+      // 0x83AA7E80ULL = 2,208,988,800 (seconds between 1900 and 1970)
+      QWORD microseconds = static_cast<QWORD>(zsLib::toMicroseconds(time.time_since_epoch()).count());
+
+      QWORD seconds = (microseconds / 1000000ULL) + 0x83AA7E80ULL;
+      QWORD fraction = ((microseconds % 1000000ULL) << 32) / 1000000ULL;
+
+      return static_cast<DWORD>(((seconds & 0xFFFF) << 16) | (fraction >> 16));
+    }
+
     //-------------------------------------------------------------------------
     Log::Params RTPUtils::slog(const char *message)
     {
@@ -0,0 +1,669 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+
+#include <ortc/internal/ortc_ReceiveLatency.h>
+#include <ortc/internal/platform.h>
+
+#include <ortc/IHelper.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/Singleton.h>
+#include <zsLib/Stringize.h>
+#include <zsLib/Log.h>
+#include <zsLib/XML.h>
+
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <thread>
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib_stats) }
+
+namespace ortc
+{
+  ZS_DECLARE_USING_PTR(zsLib, ISettings);
+
+  using zsLib::Log;
+
+  namespace internal
+  {
+    ZS_DECLARE_CLASS_PTR(ReceiveLatencySettingsDefaults);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (helpers)
+    #pragma mark
+
+    static std::atomic<bool> gReceiveLatencyEnabled {false};
+
+    //-------------------------------------------------------------------------
+    struct ReceiveLatencyThreadState
+    {
+      ULONGLONG mReceived {};
+      ULONGLONG mLast {};
+      ReceiveLatency::ThreadHistogramsPtr mHistograms;
+    };
+
+    //-------------------------------------------------------------------------
+    static ReceiveLatencyThreadState &threadState()
+    {
+      static thread_local ReceiveLatencyThreadState state;
+      return state;
+    }
+
+    //-------------------------------------------------------------------------
+    static ULONGLONG nowInNanoseconds()
+    {
+      return static_cast<ULONGLONG>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    //-------------------------------------------------------------------------
+    static size_t highestBit(ULONGLONG value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+      return static_cast<size_t>(63 - __builtin_clzll(value));
+#else
+      size_t result = 0;
+      while (0 != (value >>= 1)) ++result;
+      return result;
+#endif //defined(__GNUC__) || defined(__clang__)
+    }
+
+    //-------------------------------------------------------------------------
+    static Microseconds toMicroseconds(ULONGLONG nanoseconds)
+    {
+      return Microseconds(static_cast<Microseconds::rep>(nanoseconds / 1000));
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ReceiveLatencySettingsDefaults
+    #pragma mark
+
+    class ReceiveLatencySettingsDefaults : public ISettingsApplyDefaultsDelegate
+    {
+    public:
+      //-----------------------------------------------------------------------
+      ~ReceiveLatencySettingsDefaults()
+      {
+        ISettings::removeDefaults(*this);
+      }
+
+      //-----------------------------------------------------------------------
+      static ReceiveLatencySettingsDefaultsPtr singleton()
+      {
+        static SingletonLazySharedPtr<ReceiveLatencySettingsDefaults> singleton(create());
+        return singleton.singleton();
+      }
+
+      //-----------------------------------------------------------------------
+      static ReceiveLatencySettingsDefaultsPtr create()
+      {
+        auto pThis(make_shared<ReceiveLatencySettingsDefaults>());
+        ISettings::installDefaults(pThis);
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      virtual void notifySettingsApplyDefaults() override
+      {
+        ISettings::setBool(ORTC_SETTING_RECEIVE_LATENCY_ENABLED, false);
+      }
+      
+    };
+
+    //-------------------------------------------------------------------------
+    void installReceiveLatencySettingsDefaults()
+    {
+      ReceiveLatencySettingsDefaults::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IReceiveLatencyForInternal
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void IReceiveLatencyForInternal::received()
+    {
+      if (!gReceiveLatencyEnabled.load(std::memory_order_relaxed)) return;
+
+      auto &state = threadState();
+      state.mReceived = state.mLast = nowInNanoseconds();
+    }
+
+    //-------------------------------------------------------------------------
+    void IReceiveLatencyForInternal::stage(Stages stage)
+    {
+      if (!gReceiveLatencyEnabled.load(std::memory_order_relaxed)) return;
+
+      auto &state = threadState();
+      if (0 == state.mLast) return;
+
+      auto histograms = ReceiveLatency::getThreadHistograms();
+      if (!histograms) return;
+
+      ULONGLONG now = nowInNanoseconds();
+      histograms->mStages[stage].record(now - state.mLast);
+      state.mLast = now;
+    }
+
+    //-------------------------------------------------------------------------
+    ReceiveLatencyStamp IReceiveLatencyForInternal::queued()
+    {
+      ReceiveLatencyStamp stamp;
+      if (!gReceiveLatencyEnabled.load(std::memory_order_relaxed)) return stamp;
+
+      auto &state = threadState();
+      if (0 == state.mReceived) return stamp;
+
+      stamp.mReceived = state.mReceived;
+      stamp.mQueued = nowInNanoseconds();
+      return stamp;
+    }
+
+    //-------------------------------------------------------------------------
+    void IReceiveLatencyForInternal::dequeued(const ReceiveLatencyStamp &stamp)
+    {
+      if (0 == stamp.mQueued) return;
+      if (!gReceiveLatencyEnabled.load(std::memory_order_relaxed)) return;
+
+      // recorded against the thread servicing the queue so queueing delay
+      // shows up on the packet thread that is falling behind
+      auto histograms = ReceiveLatency::getThreadHistograms();
+      if (!histograms) return;
+
+      ULONGLONG now = nowInNanoseconds();
+      histograms->mStages[IReceiveLatencyTypes::Stage_MediaEngineQueue].record(now - stamp.mQueued);
+      histograms->mStages[IReceiveLatencyTypes::Stage_Total].record(now - stamp.mReceived);
+    }
+
+    //-------------------------------------------------------------------------
+    void IReceiveLatencyForInternal::finished()
+    {
+      auto &state = threadState();
+      state.mReceived = state.mLast = 0;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ReceiveLatencyHistogram::Values
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void ReceiveLatencyHistogram::Values::add(const Values &values)
+    {
+      if (0 == values.mTotal) return;
+
+      for (size_t index = 0; index < TotalBuckets; ++index) {
+        mCounts[index] += values.mCounts[index];
+      }
+
+      mMin = (0 == mTotal ? values.mMin : std::min(mMin, values.mMin));
+      mMax = std::max(mMax, values.mMax);
+      mTotal += values.mTotal;
+      mSum += values.mSum;
+    }
+
+    //-------------------------------------------------------------------------
+    ULONGLONG ReceiveLatencyHistogram::Values::percentile(double fraction) const
+    {
+      if (0 == mTotal) return 0;
+
+      ULONGLONG target = static_cast<ULONGLONG>(std::ceil(fraction * static_cast<double>(mTotal)));
+      if (target < 1) target = 1;
+
+      ULONGLONG cumulative = 0;
+      for (size_t index = 0; index < TotalBuckets; ++index) {
+        cumulative += mCounts[index];
+        if (cumulative >= target) return std::min(ReceiveLatencyHistogram::fromBucket(index), mMax);
+      }
+      return mMax;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ReceiveLatencyHistogram
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void ReceiveLatencyHistogram::record(ULONGLONG value)
+    {
+      // single writer; plain load/store keeps the hot path free of locked
+      // instructions while still being safe for concurrent readers
+      size_t bucket = toBucket(value);
+      mCounts[bucket].store(mCounts[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+      ULONGLONG total = mTotal.load(std::memory_order_relaxed);
+      mTotal.store(total + 1, std::memory_order_relaxed);
+      mSum.store(mSum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+
+      if ((0 == total) ||
+          (value < mMin.load(std::memory_order_relaxed))) {
+        mMin.store(value, std::memory_order_relaxed);
+      }
+      if (value > mMax.load(std::memory_order_relaxed)) {
+        mMax.store(value, std::memory_order_relaxed);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ReceiveLatencyHistogram::get(Values &outValues) const
+    {
+      outValues.mTotal = 0;
+      for (size_t index = 0; index < TotalBuckets; ++index) {
+        outValues.mCounts[index] = mCounts[index].load(std::memory_order_relaxed);
+        outValues.mTotal += outValues.mCounts[index];
+      }
+      outValues.mSum = mSum.load(std::memory_order_relaxed);
+      outValues.mMin = mMin.load(std::memory_order_relaxed);
+      outValues.mMax = mMax.load(std::memory_order_relaxed);
+    }
+
+    //-------------------------------------------------------------------------
+    void ReceiveLatencyHistogram::reset()
+    {
+      // racing with the writer only loses the samples being recorded at
+      // the time of the reset
+      for (size_t index = 0; index < TotalBuckets; ++index) {
+        mCounts[index].store(0, std::memory_order_relaxed);
+      }
+      mTotal.store(0, std::memory_order_relaxed);
+      mSum.store(0, std::memory_order_relaxed);
+      mMin.store(0, std::memory_order_relaxed);
+      mMax.store(0, std::memory_order_relaxed);
+    }
+
+    //-------------------------------------------------------------------------
+    size_t ReceiveLatencyHistogram::toBucket(ULONGLONG value)
+    {
+      const ULONGLONG maxValue = ((static_cast<ULONGLONG>(1) << MaxValueBits) - 1);
+      if (value > maxValue) value = maxValue;
+
+      if (value < (2 * SubBucketCount)) return static_cast<size_t>(value);
+
+      size_t shift = highestBit(value) - SubBucketBits;
+      return ((shift + 1) * SubBucketCount) + static_cast<size_t>((value >> shift) - SubBucketCount);
+    }
+
+    //-------------------------------------------------------------------------
+    ULONGLONG ReceiveLatencyHistogram::fromBucket(size_t bucket)
+    {
+      if (bucket < (2 * SubBucketCount)) return static_cast<ULONGLONG>(bucket);
+
+      // highest value that maps into the bucket
+      size_t shift = (bucket / SubBucketCount) - 1;
+      ULONGLONG subBucket = static_cast<ULONGLONG>((bucket % SubBucketCount) + SubBucketCount);
+      return ((subBucket + 1) << shift) - 1;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ReceiveLatency
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ReceiveLatency::ReceiveLatency(const make_private &)
+    {
+      ZS_LOG_DETAIL(slog("created"))
+    }
+
+    //-------------------------------------------------------------------------
+    void ReceiveLatency::init()
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    ReceiveLatency::~ReceiveLatency()
+    {
+      mThisWeak.reset();
+      ZS_LOG_DETAIL(slog("destroyed"))
+    }
+
+    //-------------------------------------------------------------------------
+    ReceiveLatencyPtr ReceiveLatency::singleton()
+    {
+      static SingletonLazySharedPtr<ReceiveLatency> singleton([]() -> ReceiveLatencyPtr {
+        auto pThis(make_shared<ReceiveLatency>(make_private{}));
+        pThis->mThisWeak = pThis;
+        pThis->init();
+        return pThis;
+      }());
+      return singleton.singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ReceiveLatency => IReceiveLatency
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr ReceiveLatency::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::ReceiveLatency");
+
+      IHelper::debugAppend(resultEl, "enabled", isEnabled());
+
+      {
+        AutoLock lock(mLock);
+        IHelper::debugAppend(resultEl, "threads", mThreads.size());
+      }
+
+      auto stats = getStats(false);
+      for (auto iter = stats->begin(); iter != stats->end(); ++iter) {
+        IHelper::debugAppend(resultEl, (*iter).toDebug());
+      }
+
+      auto threadStats = getStats(true);
+      for (auto iter = threadStats->begin(); iter != threadStats->end(); ++iter) {
+        IHelper::debugAppend(resultEl, (*iter).toDebug());
+      }
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    void ReceiveLatency::enable(bool enabled)
+    {
+      gReceiveLatencyEnabled.store(enabled, std::memory_order_relaxed);
+      ZS_LOG_BASIC(slog("receive latency tracking") + ZS_PARAM("enabled", enabled))
+    }
+
+    //-------------------------------------------------------------------------
+    bool ReceiveLatency::isEnabled()
+    {
+      return gReceiveLatencyEnabled.load(std::memory_order_relaxed);
+    }
+
+    //-------------------------------------------------------------------------
+    ReceiveLatency::StageStatsListPtr ReceiveLatency::getStats(bool perThread) const
+    {
+      StageStatsListPtr result(make_shared<StageStatsList>());
+
+      ThreadHistogramsList threads;
+      {
+        AutoLock lock(mLock);
+        threads = mThreads;
+      }
+
+      ReceiveLatencyHistogram::Values values;
+
+      if (perThread) {
+        for (auto iter = threads.begin(); iter != threads.end(); ++iter) {
+          auto &thread = *(*iter);
+          for (size_t stage = IReceiveLatencyTypes::Stage_First; stage <= IReceiveLatencyTypes::Stage_Last; ++stage) {
+            thread.mStages[stage].get(values);
+            if (0 == values.mTotal) continue;
+
+            StageStats stats;
+            stats.mStage = static_cast<Stages>(stage);
+            stats.mThread = thread.mThread;
+            fill(stats, values);
+            result->push_back(stats);
+          }
+        }
+        return result;
+      }
+
+      for (size_t stage = IReceiveLatencyTypes::Stage_First; stage <= IReceiveLatencyTypes::Stage_Last; ++stage) {
+        ReceiveLatencyHistogram::Values aggregate;
+
+        for (auto iter = threads.begin(); iter != threads.end(); ++iter) {
+          (*iter)->mStages[stage].get(values);
+          aggregate.add(values);
+        }
+
+        StageStats stats;
+        stats.mStage = static_cast<Stages>(stage);
+        fill(stats, aggregate);
+        result->push_back(stats);
+      }
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    void ReceiveLatency::reset()
+    {
+      ThreadHistogramsList threads;
+      {
+        AutoLock lock(mLock);
+        threads = mThreads;
+      }
+
+      for (auto iter = threads.begin(); iter != threads.end(); ++iter) {
+        for (size_t stage = IReceiveLatencyTypes::Stage_First; stage <= IReceiveLatencyTypes::Stage_Last; ++stage) {
+          (*iter)->mStages[stage].reset();
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ReceiveLatency => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    Log::Params ReceiveLatency::slog(const char *message)
+    {
+      return Log::Params(message, "ortc::ReceiveLatency");
+    }
+
+    //-------------------------------------------------------------------------
+    ReceiveLatency::ThreadHistograms *ReceiveLatency::getThreadHistograms()
+    {
+      auto &state = threadState();
+      if (state.mHistograms) return state.mHistograms.get();
+
+      auto pThis = singleton();
+      if (!pThis) return NULL;
+
+      state.mHistograms = pThis->registerThread();
+      return state.mHistograms.get();
+    }
+
+    //-------------------------------------------------------------------------
+    ReceiveLatency::ThreadHistogramsPtr ReceiveLatency::registerThread()
+    {
+      auto histograms = make_shared<ThreadHistograms>();
+
+      std::stringstream name;
+      name << std::this_thread::get_id();
+
+      AutoLock lock(mLock);
+      histograms->mThread = String("thread-") + string(mNextThreadIndex) + " (" + name.str() + ")";
+      ++mNextThreadIndex;
+
+      // histograms of exited threads are kept so their samples still count
+      mThreads.push_back(histograms);
+
+      ZS_LOG_DEBUG(slog("registered receive thread") + ZS_PARAM("thread", histograms->mThread))
+      return histograms;
+    }
+
+    //-------------------------------------------------------------------------
+    void ReceiveLatency::fill(
+                              StageStats &outStats,
+                              const ReceiveLatencyHistogram::Values &values
+                              )
+    {
+      outStats.mCount = values.mTotal;
+      if (0 == values.mTotal) return;
+
+      outStats.mMin = toMicroseconds(values.mMin);
+      outStats.mMean = toMicroseconds(values.mSum / values.mTotal);
+      outStats.mP50 = toMicroseconds(values.percentile(0.50));
+      outStats.mP90 = toMicroseconds(values.percentile(0.90));
+      outStats.mP99 = toMicroseconds(values.percentile(0.99));
+      outStats.mP999 = toMicroseconds(values.percentile(0.999));
+      outStats.mMax = toMicroseconds(values.mMax);
+    }
+
+  } // internal namespace
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IReceiveLatencyTypes
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  const char *IReceiveLatencyTypes::toString(Stages stage)
+  {
+    switch (stage) {
+      case Stage_ICETransport:      return "iceTransport";
+      case Stage_DTLSTransport:     return "dtlsTransport";
+      case Stage_SRTPTransport:     return "srtpTransport";
+      case Stage_RTPListener:       return "rtpListener";
+      case Stage_RTPReceiver:       return "rtpReceiver";
+      case Stage_MediaEngineQueue:  return "mediaEngineQueue";
+      case Stage_Total:             return "total";
+    }
+    return "UNDEFINED";
+  }
+
+  //---------------------------------------------------------------------------
+  Optional<IReceiveLatencyTypes::Stages> IReceiveLatencyTypes::toStage(const char *stage)
+  {
+    String str(stage);
+    for (IReceiveLatencyTypes::Stages index = IReceiveLatencyTypes::Stage_First; index <= IReceiveLatencyTypes::Stage_Last; index = static_cast<IReceiveLatencyTypes::Stages>(static_cast<std::underlying_type<IReceiveLatencyTypes::Stages>::type>(index) + 1)) {
+      if (0 == str.compareNoCase(IReceiveLatencyTypes::toString(index))) return index;
+    }
+
+    return Optional<Stages>();
+  }
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IReceiveLatencyTypes::StageStats
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  ElementPtr IReceiveLatencyTypes::StageStats::toDebug() const
+  {
+    ElementPtr resultEl = Element::create("ortc::IReceiveLatencyTypes::StageStats");
+
+    IHelper::debugAppend(resultEl, "stage", IReceiveLatencyTypes::toString(mStage));
+    IHelper::debugAppend(resultEl, "thread", mThread);
+    IHelper::debugAppend(resultEl, "count", mCount);
+    IHelper::debugAppend(resultEl, "min (us)", mMin.count());
+    IHelper::debugAppend(resultEl, "mean (us)", mMean.count());
+    IHelper::debugAppend(resultEl, "p50 (us)", mP50.count());
+    IHelper::debugAppend(resultEl, "p90 (us)", mP90.count());
+    IHelper::debugAppend(resultEl, "p99 (us)", mP99.count());
+    IHelper::debugAppend(resultEl, "p99.9 (us)", mP999.count());
+    IHelper::debugAppend(resultEl, "max (us)", mMax.count());
+
+    return resultEl;
+  }
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IReceiveLatency
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  ElementPtr IReceiveLatency::toDebug()
+  {
+    auto singleton = internal::ReceiveLatency::singleton();
+    if (!singleton) return ElementPtr();
+    return singleton->toDebug();
+  }
+
+  //---------------------------------------------------------------------------
+  void IReceiveLatency::enable(bool enabled)
+  {
+    internal::ReceiveLatency::enable(enabled);
+  }
+
+  //---------------------------------------------------------------------------
+  bool IReceiveLatency::isEnabled()
+  {
+    return internal::ReceiveLatency::isEnabled();
+  }
+
+  //---------------------------------------------------------------------------
+  IReceiveLatencyTypes::StageStatsListPtr IReceiveLatency::getStats(bool perThread)
+  {
+    auto singleton = internal::ReceiveLatency::singleton();
+    if (!singleton) return make_shared<StageStatsList>();
+    return singleton->getStats(perThread);
+  }
+
+  //---------------------------------------------------------------------------
+  void IReceiveLatency::reset()
+  {
+    auto singleton = internal::ReceiveLatency::singleton();
+    if (!singleton) return;
+    singleton->reset();
+  }
+
+} // namespace ortc
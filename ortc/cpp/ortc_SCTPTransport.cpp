@@ -306,6 +306,7 @@ namespace ortc
       {
         // http://tools.ietf.org/html/draft-ietf-rtcweb-data-channel-05#section-6.2
         ISettings::setUInt(ORTC_SETTING_SCTP_TRANSPORT_MAX_SESSIONS_PER_PORT, kMaxSctpSid);
+        ISettings::setUInt(ORTC_SETTING_SCTP_TRANSPORT_TOTAL_SHARDS, ORTC_QUEUE_TOTAL_PACKET_THREADS);
       }
 
     };
@@ -316,6 +317,49 @@ namespace ortc
       SCTPTransportSettingsDefaults::singleton();
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SCTPShardAllocator
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    SCTPShardAllocator::SCTPShardAllocator(size_t totalShards) :
+      mAssociations(totalShards)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    size_t SCTPShardAllocator::allocate()
+    {
+      ZS_THROW_INVALID_ASSUMPTION_IF(mAssociations.size() < 1)
+
+      size_t found = 0;
+      for (size_t index = 1; index < mAssociations.size(); ++index) {
+        if (mAssociations[index] < mAssociations[found]) found = index;
+      }
+
+      ++(mAssociations[found]);
+      return found;
+    }
+
+    //-------------------------------------------------------------------------
+    bool SCTPShardAllocator::release(size_t shardIndex)
+    {
+      if (shardIndex >= mAssociations.size()) return false;
+      if (mAssociations[shardIndex] > 0) --(mAssociations[shardIndex]);
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t SCTPShardAllocator::totalAssociations(size_t shardIndex) const
+    {
+      if (shardIndex >= mAssociations.size()) return 0;
+      return mAssociations[shardIndex];
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -347,6 +391,20 @@ namespace ortc
     public:
       ZS_DECLARE_TYPEDEF_PTR(IDataChannelForSCTPTransport, UseDataChannel)
 
+      // usrsctp keeps its stack state in process wide globals so only a single
+      // usrsctp_init() is possible per process. Associations are instead
+      // partitioned into shards where each shard owns a packet thread queue;
+      // each transport is bound to a shard upon creation so that the
+      // association's processing and inbound delivery are spread across the
+      // packet threads rather than all funnelling through one queue.
+      struct Shard
+      {
+        size_t mIndex {};
+        IMessageQueuePtr mQueue;
+      };
+
+      typedef std::vector<Shard> ShardList;
+
     public:
       //-----------------------------------------------------------------------
       SCTPInit(const make_private &)
@@ -392,6 +450,18 @@ namespace ortc
         // is cricket::kMaxSctpSid.
         usrsctp_sysctl_set_sctp_nr_outgoing_streams_default(SafeInt<uint32_t>(ISettings::getUInt(ORTC_SETTING_SCTP_TRANSPORT_MAX_SESSIONS_PER_PORT)));
 
+        size_t totalShards = SafeInt<size_t>(ISettings::getUInt(ORTC_SETTING_SCTP_TRANSPORT_TOTAL_SHARDS));
+        if (totalShards < 1) totalShards = 1;
+
+        for (size_t index = 0; index < totalShards; ++index) {
+          Shard shard;
+          shard.mIndex = index;
+          shard.mQueue = IORTCForInternal::queuePacket();
+          mShards.push_back(shard);
+        }
+
+        mAllocator = SCTPShardAllocator(totalShards);
+
         mInitialized = true;
       }
 
@@ -430,6 +500,35 @@ namespace ortc
         return result;
       }
 
+      //-----------------------------------------------------------------------
+      // Select the least loaded shard for a new association.
+      IMessageQueuePtr allocateShard(size_t &outShardIndex)
+      {
+        AutoRecursiveLock lock(mLock);
+
+        ZS_THROW_INVALID_ASSUMPTION_IF(mShards.size() < 1)
+
+        auto &shard = mShards[mAllocator.allocate()];
+
+        ZS_LOG_TRACE(log("allocated shard") + ZS_PARAM("shard", shard.mIndex) + ZS_PARAM("associations", mAllocator.totalAssociations(shard.mIndex)))
+
+        outShardIndex = shard.mIndex;
+        return shard.mQueue;
+      }
+
+      //-----------------------------------------------------------------------
+      void releaseShard(size_t shardIndex)
+      {
+        AutoRecursiveLock lock(mLock);
+
+        if (!mAllocator.release(shardIndex)) {
+          ZS_LOG_WARNING(Detail, log("shard was not found") + ZS_PARAM("shard", shardIndex))
+          return;
+        }
+
+        ZS_LOG_TRACE(log("released shard") + ZS_PARAM("shard", shardIndex) + ZS_PARAM("associations", mAllocator.totalAssociations(shardIndex)))
+      }
+
     protected:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -593,6 +692,15 @@ namespace ortc
 
         IHelper::debugAppend(resultEl, "id", mID);
 
+        for (auto iter = mShards.begin(); iter != mShards.end(); ++iter) {
+          auto &shard = (*iter);
+          ElementPtr shardEl = Element::create("shard");
+          IHelper::debugAppend(shardEl, "index", shard.mIndex);
+          IHelper::debugAppend(shardEl, "queue", (bool)shard.mQueue);
+          IHelper::debugAppend(shardEl, "associations", mAllocator.totalAssociations(shard.mIndex));
+          IHelper::debugAppend(resultEl, shardEl);
+        }
+
         return resultEl;
       }
 
@@ -627,6 +735,9 @@ namespace ortc
       SCTPInitWeakPtr mThisWeak;
 
       std::atomic<bool> mInitialized{ false };
+
+      ShardList mShards;
+      SCTPShardAllocator mAllocator;
     };
 
     //-------------------------------------------------------------------------
@@ -756,6 +867,12 @@ namespace ortc
 
       cancel();
 
+      if ((mSCTPInit) &&
+          (mShardIndex.hasValue())) {
+        mSCTPInit->releaseShard(mShardIndex.value());
+        mShardIndex = Optional<size_t>();
+      }
+
       delete mThisSocket;
       mThisSocket = NULL;
       ZS_EVENTING_1(x, i, Detail, SctpTransportDestroy, ol, SctpTransport, Stop, puid, id, mID);
@@ -850,7 +967,14 @@ namespace ortc
         inLocalPort = allocatedLocalPort.value();
       }
 
-      SCTPTransportPtr pThis(make_shared<SCTPTransport>(make_private{}, IORTCForInternal::queueORTC(), listener, useSecureTransport));
+      auto sctpInit = SCTPInit::singleton();
+      ORTC_THROW_INVALID_STATE_IF(!sctpInit);
+
+      size_t shardIndex {};
+      auto shardQueue = sctpInit->allocateShard(shardIndex);
+
+      SCTPTransportPtr pThis(make_shared<SCTPTransport>(make_private{}, shardQueue, listener, useSecureTransport));
+      pThis->mShardIndex = shardIndex;
       pThis->mThisWeak = pThis;
       pThis->mThisSocket = new SCTPTransportWeakPtr(pThis);
 
@@ -1370,7 +1494,14 @@ namespace ortc
                                                         WORD localPort
                                                         )
     {
-      SCTPTransportPtr pThis(make_shared<SCTPTransport>(make_private {}, IORTCForInternal::queueORTC(), listener, secureTransport, localPort));
+      auto sctpInit = SCTPInit::singleton();
+      ORTC_THROW_INVALID_STATE_IF(!sctpInit);
+
+      size_t shardIndex {};
+      auto shardQueue = sctpInit->allocateShard(shardIndex);
+
+      SCTPTransportPtr pThis(make_shared<SCTPTransport>(make_private {}, shardQueue, listener, secureTransport, localPort));
+      pThis->mShardIndex = shardIndex;
       pThis->mThisWeak = pThis;
       pThis->mThisSocket = new SCTPTransportWeakPtr(pThis);
       pThis->init();
@@ -1408,9 +1539,14 @@ namespace ortc
           if (mPendingIncomingBuffers.size() > 0) goto queue_packet;
           if (!mSocket) goto queue_packet;
 
-          usrsctp_conninput(mThisSocket, buffer, bufferLengthInBytes, 0);
+          if (mSocketClosePending) {
+            ZS_LOG_WARNING(Debug, log("packet arrived while socket is closing"))
+            return false;
+          }
 
-          return true;
+          // registration reference; released after usrsctp_conninput()
+          ++mInputsInFlight;
+          goto deliver_packet;
         }
 
       queue_packet:
@@ -1427,7 +1563,24 @@ namespace ortc
         }
       }
 
-      return false;
+    deliver_packet:
+      {
+        // NOTE: usrsctp performs its own internal locking thus the packet is
+        //       handed to the stack outside of the transport lock (which
+        //       would otherwise serialize the packet thread against all other
+        //       transport activity). The registration reference taken above
+        //       keeps the socket open and the address registered until this
+        //       call returns.
+        usrsctp_conninput(mThisSocket, buffer, bufferLengthInBytes, 0);
+
+        if ((0 == --mInputsInFlight) &&
+            (mSocketClosePending)) {
+          AutoRecursiveLock lock(*this);
+          closeSocket();
+        }
+      }
+
+      return true;
     }
 
     //-------------------------------------------------------------------------
@@ -1697,6 +1850,7 @@ namespace ortc
       IHelper::debugAppend(resultEl, "graceful shutdown", (bool)mGracefulShutdownReference);
 
       IHelper::debugAppend(resultEl, "sctp init", (bool)mSCTPInit);
+      IHelper::debugAppend(resultEl, "shard", mShardIndex);
       IHelper::debugAppend(resultEl, "mMaxSessionsPerPort", mMaxSessionsPerPort);
 
       IHelper::debugAppend(resultEl, "subscribers", mSubscriptions.size());
@@ -1718,6 +1872,8 @@ namespace ortc
       IHelper::debugAppend(resultEl, mCapabilities ? mCapabilities->toDebug() : ElementPtr());
 
       IHelper::debugAppend(resultEl, "this socket", (PTRNUMBER)mThisSocket);
+      IHelper::debugAppend(resultEl, "inputs in flight", mInputsInFlight.load());
+      IHelper::debugAppend(resultEl, "socket close pending", mSocketClosePending.load());
 
       IHelper::debugAppend(resultEl, "incoming", mIncoming);
 
@@ -2123,9 +2279,12 @@ namespace ortc
       mAnnouncedIncomingDataChannels.clear();
 
       if (mSocket) {
-        usrsctp_close(mSocket);
+        mClosingSocket = mSocket;
         mSocket = NULL;
-        usrsctp_deregister_address(mThisSocket);
+        mSocketClosePending = true;
+
+        // an input still inside usrsctp closes the socket once it returns
+        if (0 == mInputsInFlight) closeSocket();
       }
 
       for (auto iter = mSessions.begin(); iter != mSessions.end(); ++iter)
@@ -2220,6 +2379,20 @@ namespace ortc
       ZS_LOG_WARNING(Detail, debug("error set") + ZS_PARAM("error", mLastError) + ZS_PARAM("reason", mLastErrorReason))
     }
 
+    //-------------------------------------------------------------------------
+    void SCTPTransport::closeSocket()
+    {
+      // warning: must be called from within the object lock
+      if (!mClosingSocket) return;
+      if (0 != mInputsInFlight) return;
+
+      ZS_LOG_DEBUG(log("closing sctp socket"))
+
+      usrsctp_close(mClosingSocket);
+      mClosingSocket = NULL;
+      usrsctp_deregister_address(mThisSocket);
+    }
+
     //-------------------------------------------------------------------------
     bool SCTPTransport::openConnectSCTPSocket()
     {
@@ -470,6 +470,27 @@ namespace ortc
       return transport->sendPacket(buffer, bufferLengthInBytes);
     }
 
+    //-------------------------------------------------------------------------
+    bool SRTPSDESTransport::sendEncryptedPackets(
+                                                 IICETypes::Components sendOverICETransport,
+                                                 IICETypes::Components packetType,
+                                                 const PacketBufferRefList &packets
+                                                 )
+    {
+      if (isShutdown()) {
+        ZS_LOG_WARNING(Debug, log("cannot send packets on shutdown transport"))
+        return false;
+      }
+
+      UseICETransportPtr transport = (IICETypes::Component_RTP == sendOverICETransport ? mICETransportRTP : fixRTCPTransport());
+      if (!transport) {
+        ZS_LOG_WARNING(Debug, log("no ice transport is attached") + ZS_PARAM("send over transport", IICETypes::toString(sendOverICETransport)) + ZS_PARAM("packet type", IICETypes::toString(packetType)))
+        return false;
+      }
+
+      return transport->sendPackets(packets);
+    }
+
     //-------------------------------------------------------------------------
     bool SRTPSDESTransport::handleReceivedDecryptedPacket(
                                                           IICETypes::Components viaTransport,
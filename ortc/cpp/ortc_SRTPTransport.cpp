@@ -34,6 +34,7 @@
 #include <ortc/internal/ortc_Helper.h>
 #include <ortc/internal/ortc_RTPUtils.h>
 #include <ortc/internal/ortc_ORTC.h>
+#include <ortc/internal/ortc_ReceiveLatency.h>
 #include <ortc/internal/ortc.events.h>
 #include <ortc/internal/platform.h>
 
@@ -88,6 +89,7 @@ namespace ortc
   namespace internal
   {
     ZS_DECLARE_CLASS_PTR(SRTPTransportSettingsDefaults);
+    ZS_DECLARE_TYPEDEF_PTR(IReceiveLatencyForInternal, UseReceiveLatency);
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -161,6 +163,13 @@ namespace ortc
       //-----------------------------------------------------------------------
       virtual void notifySettingsApplyDefaults() override
       {
+        ISettings::setBool(ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_ENABLED, true);
+        ISettings::setUInt(ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_MAX_PACKET_SIZE, 1200);
+        ISettings::setUInt(ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_MAX_DELAY_IN_MILLISECONDS, 20);
+        ISettings::setUInt(ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_MAX_TIMING_REPORT_DELAY_IN_MILLISECONDS, 5);
+        ISettings::setUInt(ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_MAX_BANDWIDTH_DELAY_IN_MILLISECONDS, 1000);
+        ISettings::setUInt(ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_BANDWIDTH_PERCENTAGE, 5);
+        ISettings::setUInt(ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_MIN_BANDWIDTH_BYTES_PER_SECOND, 1000);
       }
       
     };
@@ -419,7 +428,8 @@ namespace ortc
       MessageQueueAssociator(queue),
       SharedRecursiveLock(SharedRecursiveLock::create()),
       mSecureTransport(secureTransport),
-      mSRTPInit(SRTPInit::singleton())
+      mSRTPInit(SRTPInit::singleton()),
+      mRTCPAggregationEnabled(ISettings::getBool(ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_ENABLED))
     {
       ZS_EVENTING_2(
                     x, i, Detail, SrtpTransportCreate, ol, SrtpTransport, Start,
@@ -434,6 +444,13 @@ namespace ortc
       mParams[Direction_Encrypt] = encryptParameters;
       mParams[Direction_Decrypt] = decryptParameters;
 
+      mRTCPAggregatorSettings.mMaxPacketSize = ISettings::getUInt(ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_MAX_PACKET_SIZE);
+      mRTCPAggregatorSettings.mMaxDelay = Milliseconds(ISettings::getUInt(ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_MAX_DELAY_IN_MILLISECONDS));
+      mRTCPAggregatorSettings.mMaxTimingReportDelay = Milliseconds(ISettings::getUInt(ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_MAX_TIMING_REPORT_DELAY_IN_MILLISECONDS));
+      mRTCPAggregatorSettings.mMaxBandwidthDelay = Milliseconds(ISettings::getUInt(ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_MAX_BANDWIDTH_DELAY_IN_MILLISECONDS));
+      mRTCPAggregatorSettings.mBandwidthPercentage = SafeInt<ULONG>(ISettings::getUInt(ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_BANDWIDTH_PERCENTAGE));
+      mRTCPAggregatorSettings.mMinBandwidthBytesPerSecond = ISettings::getUInt(ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_MIN_BANDWIDTH_BYTES_PER_SECOND);
+
       if (originalDelegate) {
         mDefaultSubscription = mSubscriptions.subscribe(originalDelegate, IORTCForInternal::queueORTC()); // using ORTC queue and not delegate queue since this is an internal only class
       }
@@ -664,6 +681,8 @@ namespace ortc
                                              size_t bufferLengthInBytes
                                              )
     {
+      UseReceiveLatency::stage(IReceiveLatencyTypes::Stage_SRTPTransport);
+
       UseSecureTransportPtr transport;
       SecureByteBlockPtr decryptedBuffer;
       IICETypes::Components component = (RTPUtils::isRTCPPacketType(buffer, bufferLengthInBytes) ? IICETypes::Component_RTCP : IICETypes::Component_RTP);
@@ -889,66 +908,155 @@ namespace ortc
                                    size_t bufferLengthInBytes
                                    )
     {
-      ZS_EVENTING_5(
-                    x, i, Trace, SrtpTransportSendOutgoingPacketAndEncrypt, ol, SrtpTransport, Send,
-                    puid, id, mID,
-                    enum, viaTransport, zsLib::to_underlying(sendOverICETransport),
-                    enum, packetType, zsLib::to_underlying(packetType),
-                    buffer, packet, buffer,
-                    size, size, bufferLengthInBytes
-                    );
+      if ((mRTCPAggregationEnabled) &&
+          (IICETypes::Component_RTCP == packetType)) {
+        if (queueRTCPPacket(sendOverICETransport, buffer, bufferLengthInBytes)) return true;
+      }
 
-      UseSecureTransportPtr transport;
-      KeyingMaterialPtr keyingMaterial;
+      return protectAndSendPacket(sendOverICETransport, packetType, buffer, bufferLengthInBytes);
+    }
 
-      SecureByteBlockPtr encryptedBuffer;
+    //-------------------------------------------------------------------------
+    bool SRTPTransport::sendPackets(
+                                    IICETypes::Components sendOverICETransport,
+                                    IICETypes::Components packetType,  // is packet RTP or RTCP
+                                    const PacketBufferRefList &packets
+                                    )
+    {
+      if ((mRTCPAggregationEnabled) &&
+          (IICETypes::Component_RTCP == packetType)) {
+        // rtcp is aggregated into compound packets anyway
+        bool result = true;
+        for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+          if (!sendPacket(sendOverICETransport, packetType, (*iter).mBuffer, (*iter).mSize)) result = false;
+        }
+        return result;
+      }
 
-      DirectionMaterial &material = mMaterial[Direction_Encrypt]; // WARNING: only some values are accessible outside a lock
+      return protectAndSendPackets(sendOverICETransport, packetType, packets);
+    }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SRTPTransport => IWakeDelegate
+    #pragma mark
 
-      //lbojan fix for SRTCP packet lenght
-      size_t authenticationTagLength  {0};// = material.mAuthenticationTagLength[packetType];
-      packetType == IICETypes::Component_RTP ? (authenticationTagLength = material.mAuthenticationTagLength[packetType]) : (authenticationTagLength = material.mAuthenticationTagLength[packetType] + 4);
+    //-------------------------------------------------------------------------
+    void SRTPTransport::onWake()
+    {
+      // NOT USED
+      // ZS_LOG_DEBUG(log("wake"))
+      // AutoRecursiveLock lock(*this);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SRTPTransport => ITimerDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void SRTPTransport::onTimer(ITimerPtr timer)
+    {
+      ZS_LOG_TRACE(log("timer") + ZS_PARAM("timer id", timer->getID()))
 
       {
         AutoRecursiveLock lock(*this);
-
-        if (0 == mLastRemainingOverallPercentageReported) {
-          ZS_LOG_WARNING(Detail, log("cannot encrypt packet as packet lifetime is exhausted"))
-          return false;
+        if (timer != mRTCPFlushTimer) {
+          ZS_LOG_WARNING(Trace, log("notified about obsolete timer") + ZS_PARAM("timer id", timer->getID()))
+          return;
         }
 
-        transport = mSecureTransport.lock();
-        if (!transport) {
-          ZS_LOG_WARNING(Debug, log("nowhere to send packet as secure transport is gone"))
+        mRTCPFlushTimer.reset();
+      }
+
+      flushRTCPPackets(true);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SRTPTransport => ISRTPTransportAsyncDelegate
+    #pragma mark
+
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SRTPTransport => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    bool SRTPTransport::selectEncryptionKey(
+                                            IICETypes::Components packetType,
+                                            size_t bufferLengthInBytes,
+                                            KeyingMaterialPtr &outKeyingMaterial
+                                            )
+    {
+      DirectionMaterial &material = mMaterial[Direction_Encrypt];
+
+      if (0 == mLastRemainingOverallPercentageReported) {
+        ZS_LOG_WARNING(Detail, log("cannot encrypt packet as packet lifetime is exhausted"))
+        return false;
+      }
+
+      while (true) {
+        if (material.mKeyList.size() < 1) {
+          ZS_LOG_WARNING(Debug, log("no more keying material is present (all lifetimes are exhausted)") + material.toDebug())
           return false;
         }
 
-        while (true) {
-          if (material.mKeyList.size() < 1) {
-            ZS_LOG_WARNING(Debug, log("no more keying material is present (all lifetimes are exhausted)") + material.toDebug())
-            return false;
-          }
+        outKeyingMaterial = material.mKeyList.front();
+
+        ASSERT(((bool)outKeyingMaterial))
 
-          keyingMaterial = material.mKeyList.front();
+        if (outKeyingMaterial->mTotalPackets[packetType] + 1 > outKeyingMaterial->mLifetime) {
+          ZS_LOG_WARNING(Debug, log("cannot use keying material as it's lifetime is exhausted") + outKeyingMaterial->toDebug())
+          material.mKeyList.pop_front();
+          continue; // try another key
+        }
 
-          ASSERT(((bool)keyingMaterial))
+        break;
+      }
 
-          if (keyingMaterial->mTotalPackets[packetType] + 1 > keyingMaterial->mLifetime) {
-            ZS_LOG_WARNING(Debug, log("cannot use keying material as it's lifetime is exhausted") + keyingMaterial->toDebug())
-            material.mKeyList.pop_front();
-            continue; // try another key
-          }
+      updateTotalPackets(Direction_Encrypt, packetType, outKeyingMaterial);
 
-          break;
+      if ((mRTCPAggregationEnabled) &&
+          (IICETypes::Component_RTP == packetType)) {
+        Time tick = zsLib::now();
+        for (size_t loop = IICETypes::Component_First; loop <= IICETypes::Component_Last; ++loop) {
+          if (mRTCPAggregators[loop]) mRTCPAggregators[loop]->notifyRTPSent(bufferLengthInBytes, tick);
         }
-
-        updateTotalPackets(Direction_Encrypt, packetType, keyingMaterial);
       }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr SRTPTransport::protect(
+                                              IICETypes::Components packetType,
+                                              KeyingMaterialPtr keyingMaterial,
+                                              const BYTE *buffer,
+                                              size_t bufferLengthInBytes
+                                              )
+    {
+      DirectionMaterial &material = mMaterial[Direction_Encrypt]; // WARNING: only some values are accessible outside a lock
+
+      //lbojan fix for SRTCP packet lenght
+      size_t authenticationTagLength  {0};// = material.mAuthenticationTagLength[packetType];
+      packetType == IICETypes::Component_RTP ? (authenticationTagLength = material.mAuthenticationTagLength[packetType]) : (authenticationTagLength = material.mAuthenticationTagLength[packetType] + 4);
 
       // Encrypted buffer must include enough room for the full packet and the
       // MKI and authentication tag.
-      encryptedBuffer = make_shared<SecureByteBlock>(bufferLengthInBytes + authenticationTagLength + material.mMKILength);
+      SecureByteBlockPtr encryptedBuffer = make_shared<SecureByteBlock>(bufferLengthInBytes + authenticationTagLength + material.mMKILength);
 
       memcpy(encryptedBuffer->BytePtr(), buffer, bufferLengthInBytes);
 
@@ -974,7 +1082,7 @@ namespace ortc
 
       if (err != err_status_ok) {
         ZS_LOG_WARNING(Debug, log("cannot use current keying material for encryption") + keyingMaterial->toDebug())
-        return false;
+        return SecureByteBlockPtr();
       }
 
       if (material.mMKILength > 0) {
@@ -990,11 +1098,47 @@ namespace ortc
         memcpy(packetMKI, keyingMaterial->mMKIValue->BytePtr(), material.mMKILength);
       }
 
+      ASSERT(out_len <= SafeInt<decltype(out_len)>(encryptedBuffer->SizeInBytes()));
 
-      ASSERT(((bool)transport));
-      ASSERT(((bool)encryptedBuffer));
+      return encryptedBuffer;
+    }
 
-      ASSERT(out_len <= SafeInt<decltype(out_len)>(encryptedBuffer->SizeInBytes()));
+    //-------------------------------------------------------------------------
+    bool SRTPTransport::protectAndSendPacket(
+                                             IICETypes::Components sendOverICETransport,
+                                             IICETypes::Components packetType,
+                                             const BYTE *buffer,
+                                             size_t bufferLengthInBytes
+                                             )
+    {
+      ZS_EVENTING_5(
+                    x, i, Trace, SrtpTransportSendOutgoingPacketAndEncrypt, ol, SrtpTransport, Send,
+                    puid, id, mID,
+                    enum, viaTransport, zsLib::to_underlying(sendOverICETransport),
+                    enum, packetType, zsLib::to_underlying(packetType),
+                    buffer, packet, buffer,
+                    size, size, bufferLengthInBytes
+                    );
+
+      UseSecureTransportPtr transport;
+      KeyingMaterialPtr keyingMaterial;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        transport = mSecureTransport.lock();
+        if (!transport) {
+          ZS_LOG_WARNING(Debug, log("nowhere to send packet as secure transport is gone"))
+          return false;
+        }
+
+        if (!selectEncryptionKey(packetType, bufferLengthInBytes, keyingMaterial)) return false;
+      }
+
+      SecureByteBlockPtr encryptedBuffer = protect(packetType, keyingMaterial, buffer, bufferLengthInBytes);
+      if (!encryptedBuffer) return false;
+
+      ASSERT(((bool)transport));
 
       // do NOT call this method from within a lock
       ZS_EVENTING_6(
@@ -1010,53 +1154,209 @@ namespace ortc
     }
 
     //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    #pragma mark
-    #pragma mark SRTPTransport => IWakeDelegate
-    #pragma mark
-
-    //-------------------------------------------------------------------------
-    void SRTPTransport::onWake()
+    bool SRTPTransport::protectAndSendPackets(
+                                              IICETypes::Components sendOverICETransport,
+                                              IICETypes::Components packetType,
+                                              const PacketBufferRefList &packets
+                                              )
     {
-      // NOT USED
-      // ZS_LOG_DEBUG(log("wake"))
-      // AutoRecursiveLock lock(*this);
+      if (packets.size() < 1) return true;
+
+      typedef std::vector<KeyingMaterialPtr> KeyingMaterialList;
+      typedef std::vector<SecureByteBlockPtr> EncryptedBufferList;
+
+      UseSecureTransportPtr transport;
+      KeyingMaterialList keyingMaterials;
+
+      keyingMaterials.reserve(packets.size());
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        transport = mSecureTransport.lock();
+        if (!transport) {
+          ZS_LOG_WARNING(Debug, log("nowhere to send packets as secure transport is gone") + ZS_PARAM("packets", packets.size()))
+          return false;
+        }
+
+        for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+          KeyingMaterialPtr keyingMaterial;
+          if (!selectEncryptionKey(packetType, (*iter).mSize, keyingMaterial)) break;
+          keyingMaterials.push_back(keyingMaterial);
+        }
+      }
+
+      bool result = (keyingMaterials.size() == packets.size());
+
+      EncryptedBufferList encryptedBuffers;
+      PacketBufferRefList encryptedPackets;
+
+      encryptedBuffers.reserve(keyingMaterials.size());
+      encryptedPackets.reserve(keyingMaterials.size());
+
+      for (size_t index = 0; index < keyingMaterials.size(); ++index) {
+        auto &packet = packets[index];
+
+        ZS_EVENTING_5(
+                      x, i, Trace, SrtpTransportSendOutgoingPacketAndEncrypt, ol, SrtpTransport, Send,
+                      puid, id, mID,
+                      enum, viaTransport, zsLib::to_underlying(sendOverICETransport),
+                      enum, packetType, zsLib::to_underlying(packetType),
+                      buffer, packet, packet.mBuffer,
+                      size, size, packet.mSize
+                      );
+
+        SecureByteBlockPtr encryptedBuffer = protect(packetType, keyingMaterials[index], packet.mBuffer, packet.mSize);
+        if (!encryptedBuffer) {
+          result = false;
+          continue;
+        }
+
+        PacketBufferRef encryptedPacket;
+        encryptedPacket.mBuffer = encryptedBuffer->BytePtr();
+        encryptedPacket.mSize = encryptedBuffer->SizeInBytes();
+
+        encryptedPackets.push_back(encryptedPacket);
+        encryptedBuffers.push_back(encryptedBuffer);
+      }
+
+      if (encryptedPackets.size() < 1) return false;
+
+      ZS_LOG_INSANE(log("sending encrypted packets via secure transport") + ZS_PARAM("secure transport id", transport->getID()) + ZS_PARAM("via", IICETypes::toString(sendOverICETransport)) + ZS_PARAM("packet type", IICETypes::toString(packetType)) + ZS_PARAM("packets", encryptedPackets.size()))
+
+      // do NOT call this method from within a lock
+      if (!transport->sendEncryptedPackets(sendOverICETransport, packetType, encryptedPackets)) return false;
+      return result;
     }
 
     //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    #pragma mark
-    #pragma mark SRTPTransport => ITimerDelegate
-    #pragma mark
+    bool SRTPTransport::queueRTCPPacket(
+                                        IICETypes::Components sendOverICETransport,
+                                        const BYTE *buffer,
+                                        size_t bufferLengthInBytes
+                                        )
+    {
+      bool flushNow = false;
+      bool queued = false;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (0 == mLastRemainingOverallPercentageReported) {
+          // keys are exhausted; anything pending goes out before the bypass
+          for (size_t loop = IICETypes::Component_First; loop <= IICETypes::Component_Last; ++loop) {
+            if (!mRTCPAggregators[loop]) continue;
+            flushNow = flushNow || mRTCPAggregators[loop]->hasPending();
+          }
+          goto bypass;
+        }
+
+        auto &aggregator = mRTCPAggregators[sendOverICETransport];
+        if (!aggregator) aggregator = RTCPAggregator::create(mRTCPAggregatorSettings);
+
+        queued = aggregator->queue(buffer, bufferLengthInBytes, zsLib::now(), flushNow);
+        if (!queued) {
+          // each compound packet stands alone (and BYE is never held) so an
+          // oversized packet may go out ahead of what is pending without
+          // cutting the pending packets' hold short
+          goto bypass;
+        }
+
+        ZS_LOG_INSANE(log("queued rtcp packet for aggregation") + ZS_PARAM("via", IICETypes::toString(sendOverICETransport)) + ZS_PARAM("size", bufferLengthInBytes) + ZS_PARAM("flush now", flushNow))
+
+        if (!flushNow) {
+          scheduleRTCPFlush();
+          return true;
+        }
+      }
+
+    bypass:
+      {
+        // do NOT call this method from within a lock
+        if (flushNow) flushRTCPPackets(false);
+      }
+      return queued;
+    }
 
     //-------------------------------------------------------------------------
-    void SRTPTransport::onTimer(ITimerPtr timer)
+    void SRTPTransport::flushRTCPPackets(bool onlyIfDue)
     {
-      // NOT USED
-      // ZS_LOG_DEBUG(log("timer") + ZS_PARAM("timer id", timer->getID()))
-      // AutoRecursiveLock lock(*this);
+      RTCPAggregator::BufferList buffers[IICETypes::Component_Last+1];
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        Time tick = zsLib::now();
+
+        for (size_t loop = IICETypes::Component_First; loop <= IICETypes::Component_Last; ++loop) {
+          auto &aggregator = mRTCPAggregators[loop];
+          if (!aggregator) continue;
+          if (!aggregator->hasPending()) continue;
+          if ((onlyIfDue) &&
+              (aggregator->nextFlush(tick) > tick)) continue;
+
+          aggregator->flush(tick, buffers[loop]);
+        }
+
+        scheduleRTCPFlush();
+      }
+
+      for (size_t loop = IICETypes::Component_First; loop <= IICETypes::Component_Last; ++loop) {
+        if (buffers[loop].size() < 1) continue;
+
+        PacketBufferRefList packets;
+        packets.reserve(buffers[loop].size());
+
+        for (auto iter = buffers[loop].begin(); iter != buffers[loop].end(); ++iter) {
+          auto &buffer = (*iter);
+
+          PacketBufferRef packet;
+          packet.mBuffer = buffer->BytePtr();
+          packet.mSize = buffer->SizeInBytes();
+          packets.push_back(packet);
+        }
+
+        protectAndSendPackets(static_cast<IICETypes::Components>(loop), IICETypes::Component_RTCP, packets);
+      }
     }
 
     //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    #pragma mark
-    #pragma mark SRTPTransport => ISRTPTransportAsyncDelegate
-    #pragma mark
+    void SRTPTransport::scheduleRTCPFlush()
+    {
+      Time tick = zsLib::now();
+      Time fireAt;
 
+      for (size_t loop = IICETypes::Component_First; loop <= IICETypes::Component_Last; ++loop) {
+        auto &aggregator = mRTCPAggregators[loop];
+        if (!aggregator) continue;
+        if (!aggregator->hasPending()) continue;
 
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    #pragma mark
-    #pragma mark SRTPTransport => (internal)
-    #pragma mark
+        Time next = aggregator->nextFlush(tick);
+        if ((Time() == fireAt) || (next < fireAt)) fireAt = next;
+      }
+
+      if (Time() == fireAt) {
+        if (mRTCPFlushTimer) {
+          mRTCPFlushTimer->cancel();
+          mRTCPFlushTimer.reset();
+        }
+        return;
+      }
+
+      if ((mRTCPFlushTimer) &&
+          (mRTCPFlushTime <= fireAt)) return;
+
+      if (mRTCPFlushTimer) {
+        mRTCPFlushTimer->cancel();
+        mRTCPFlushTimer.reset();
+      }
+
+      auto delay = (fireAt > tick ? zsLib::toMilliseconds(fireAt - tick) : Milliseconds(0));
+      if (delay < Milliseconds(1)) delay = Milliseconds(1);
+
+      mRTCPFlushTime = fireAt;
+      mRTCPFlushTimer = ITimer::create(mThisWeak.lock(), delay, false);
+    }
 
     //-------------------------------------------------------------------------
     Log::Params SRTPTransport::log(const char *message) const
@@ -1104,6 +1404,13 @@ namespace ortc
         IHelper::debugAppend(resultEl, toString((Directions)loopDirection), mMaterial[loopDirection].toDebug());
       }
 
+      IHelper::debugAppend(resultEl, "rtcp aggregation enabled", mRTCPAggregationEnabled);
+      for (size_t loop = IICETypes::Component_First; loop <= IICETypes::Component_Last; ++loop) {
+        if (!mRTCPAggregators[loop]) continue;
+        IHelper::debugAppend(resultEl, IICETypes::toString(static_cast<IICETypes::Components>(loop)), mRTCPAggregators[loop]->toDebug());
+      }
+      IHelper::debugAppend(resultEl, "rtcp flush timer", mRTCPFlushTimer ? mRTCPFlushTimer->getID() : 0);
+
       return resultEl;
     }
 
@@ -1114,6 +1421,15 @@ namespace ortc
       mSRTPInit.reset();
       // final cleanup
 
+      if (mRTCPFlushTimer) {
+        mRTCPFlushTimer->cancel();
+        mRTCPFlushTimer.reset();
+      }
+
+      for (size_t loop = IICETypes::Component_First; loop <= IICETypes::Component_Last; ++loop) {
+        mRTCPAggregators[loop].reset();
+      }
+
       mSubscriptions.clear();
 
       if (mDefaultSubscription) {
@@ -0,0 +1,943 @@
+/*
+
+ Copyright (c) 2015, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#include <ortc/internal/ortc_StatsCounters.h>
+#include <ortc/internal/ortc_Helper.h>
+#include <ortc/internal/ortc_ORTC.h>
+#include <ortc/internal/platform.h>
+
+#include <ortc/IHelper.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/Numeric.h>
+#include <zsLib/Stringize.h>
+#include <zsLib/Log.h>
+#include <zsLib/XML.h>
+#include <zsLib/SafeInt.h>
+
+#include <sstream>
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib_stats) }
+
+namespace ortc
+{
+  ZS_DECLARE_USING_PTR(zsLib, ISettings);
+
+  using zsLib::Log;
+  using zsLib::Numeric;
+
+  namespace internal
+  {
+    ZS_DECLARE_CLASS_PTR(StatsCountersSettingsDefaults);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (helpers)
+    #pragma mark
+
+    static const BYTE kStatsCountersMagic[] = {'O', 'S', 'C', '1'};
+    static const BYTE kStatsCountersFlagDelta = 0x01;
+
+    //-------------------------------------------------------------------------
+    static void writeBE8(std::string &output, BYTE value)
+    {
+      output.push_back(static_cast<char>(value));
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBE32(std::string &output, DWORD value)
+    {
+      writeBE8(output, static_cast<BYTE>(value >> 24));
+      writeBE8(output, static_cast<BYTE>(value >> 16));
+      writeBE8(output, static_cast<BYTE>(value >> 8));
+      writeBE8(output, static_cast<BYTE>(value));
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeBE64(std::string &output, QWORD value)
+    {
+      writeBE32(output, static_cast<DWORD>(value >> 32));
+      writeBE32(output, static_cast<DWORD>(value));
+    }
+
+    //-------------------------------------------------------------------------
+    static void writeVarInt(std::string &output, long long value)
+    {
+      // zig-zag encode so small negative deltas remain small
+      QWORD encoded = (static_cast<QWORD>(value) << 1) ^ static_cast<QWORD>(value >> 63);
+
+      do {
+        BYTE part = static_cast<BYTE>(encoded & 0x7F);
+        encoded >>= 7;
+        if (0 != encoded) part |= 0x80;
+        writeBE8(output, part);
+      } while (0 != encoded);
+    }
+
+    //-------------------------------------------------------------------------
+    static QWORD getMillisecondsSinceEpoch()
+    {
+      return static_cast<QWORD>(zsLib::toMilliseconds(zsLib::now().time_since_epoch()).count());
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsCountersSettingsDefaults
+    #pragma mark
+
+    class StatsCountersSettingsDefaults : public ISettingsApplyDefaultsDelegate
+    {
+    public:
+      //-----------------------------------------------------------------------
+      ~StatsCountersSettingsDefaults()
+      {
+        ISettings::removeDefaults(*this);
+      }
+
+      //-----------------------------------------------------------------------
+      static StatsCountersSettingsDefaultsPtr singleton()
+      {
+        static SingletonLazySharedPtr<StatsCountersSettingsDefaults> singleton(create());
+        return singleton.singleton();
+      }
+
+      //-----------------------------------------------------------------------
+      static StatsCountersSettingsDefaultsPtr create()
+      {
+        auto pThis(make_shared<StatsCountersSettingsDefaults>());
+        ISettings::installDefaults(pThis);
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      virtual void notifySettingsApplyDefaults() override
+      {
+        ISettings::setUInt(ORTC_SETTING_STATS_COUNTERS_MAX_OBJECTS, 16 * 1024);
+        ISettings::setUInt(ORTC_SETTING_STATS_COUNTERS_EXPORT_INTERVAL_IN_MILLISECONDS, 1000);
+        ISettings::setString(ORTC_SETTING_STATS_COUNTERS_EXPORT_FORMAT, IStatsCountersTypes::toString(IStatsCountersTypes::ExportFormat_Binary));
+        ISettings::setUInt(ORTC_SETTING_STATS_COUNTERS_FULL_EXPORT_EVERY, 30);
+      }
+      
+    };
+
+    //-------------------------------------------------------------------------
+    void installStatsCountersSettingsDefaults()
+    {
+      StatsCountersSettingsDefaults::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsCountersHandle
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    StatsCountersHandle::StatsCountersHandle(
+                                             StatsCountersPtr owner,
+                                             StatsCountersSlot *slot,
+                                             size_t index
+                                             ) :
+      mOwner(owner),
+      mSlot(slot),
+      mIndex(index)
+    {
+      ZS_THROW_INVALID_ARGUMENT_IF(!owner)
+      ZS_THROW_INVALID_ARGUMENT_IF(!slot)
+    }
+
+    //-------------------------------------------------------------------------
+    StatsCountersHandle::~StatsCountersHandle()
+    {
+      mOwner->releaseSlot(mIndex);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IStatsCountersForInternal
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    StatsCountersHandlePtr IStatsCountersForInternal::registerObject(
+                                                                     PUID objectID,
+                                                                     StatsTypes statsType
+                                                                     )
+    {
+      return IStatsCountersFactory::singleton().registerObject(objectID, statsType);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsCounters
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    StatsCounters::StatsCounters(
+                                 const make_private &,
+                                 IMessageQueuePtr queue
+                                 ) :
+      MessageQueueAssociator(queue),
+      SharedRecursiveLock(SharedRecursiveLock::create()),
+      mTotalSlots(SafeInt<size_t>(ISettings::getUInt(ORTC_SETTING_STATS_COUNTERS_MAX_OBJECTS))),
+      mExportInterval(ISettings::getUInt(ORTC_SETTING_STATS_COUNTERS_EXPORT_INTERVAL_IN_MILLISECONDS)),
+      mFullExportEvery(SafeInt<size_t>(ISettings::getUInt(ORTC_SETTING_STATS_COUNTERS_FULL_EXPORT_EVERY)))
+    {
+      auto format = IStatsCountersTypes::toExportFormat(ISettings::getString(ORTC_SETTING_STATS_COUNTERS_EXPORT_FORMAT));
+      if (format.hasValue()) mExportFormat = format.value();
+
+      ZS_LOG_DETAIL(debug("created"))
+    }
+
+    //-------------------------------------------------------------------------
+    void StatsCounters::init()
+    {
+      AutoRecursiveLock lock(*this);
+
+      if (mTotalSlots > 0) {
+        // allocate extra space to manually align the slot array to a cache
+        // line boundary (over-aligned new is not guaranteed pre-C++17)
+        mSlotAllocation = new BYTE[(sizeof(StatsCountersSlot) * mTotalSlots) + ORTC_STATS_COUNTERS_CACHE_LINE_SIZE];
+
+        PTRNUMBER aligned = reinterpret_cast<PTRNUMBER>(mSlotAllocation);
+        aligned = (aligned + (ORTC_STATS_COUNTERS_CACHE_LINE_SIZE - 1)) & ~(static_cast<PTRNUMBER>(ORTC_STATS_COUNTERS_CACHE_LINE_SIZE - 1));
+
+        mSlots = reinterpret_cast<StatsCountersSlot *>(aligned);
+        for (size_t index = 0; index < mTotalSlots; ++index) {
+          auto slot = new (&(mSlots[index])) StatsCountersSlot;
+          slot->mObjectID.store(0, std::memory_order_relaxed);
+          slot->mStatsType.store(0, std::memory_order_relaxed);
+          for (size_t counter = IStatsCountersTypes::Counter_First; counter <= IStatsCountersTypes::Counter_Last; ++counter) {
+            slot->mCounters[counter].store(0, std::memory_order_relaxed);
+          }
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    StatsCounters::~StatsCounters()
+    {
+      if (isNoop()) return;
+
+      ZS_LOG_DETAIL(log("destroyed"))
+      mThisWeak.reset();
+
+      cancel();
+
+      if (mSlots) {
+        for (size_t index = 0; index < mTotalSlots; ++index) {
+          mSlots[index].~StatsCountersSlot();
+        }
+        mSlots = NULL;
+      }
+
+      delete [] mSlotAllocation;
+      mSlotAllocation = NULL;
+    }
+
+    //-------------------------------------------------------------------------
+    StatsCountersPtr StatsCounters::create()
+    {
+      StatsCountersPtr pThis(make_shared<StatsCounters>(make_private {}, IORTCForInternal::queueORTC()));
+      pThis->mThisWeak = pThis;
+      pThis->init();
+      return pThis;
+    }
+
+    //-------------------------------------------------------------------------
+    StatsCountersPtr StatsCounters::singleton()
+    {
+      AutoRecursiveLock lock(*IHelper::getGlobalLock());
+      static SingletonLazySharedPtr<StatsCounters> singleton(create());
+      StatsCountersPtr result = singleton.singleton();
+
+      static zsLib::SingletonManager::Register registerSingleton("org.ortc.StatsCounters", result);
+
+      if (!result) {
+        ZS_LOG_WARNING(Detail, slog("singleton gone"))
+      }
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsCounters => IStatsCounters
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr StatsCounters::singletonToDebug()
+    {
+      StatsCountersPtr pThis(StatsCounters::singleton());
+      if (!pThis) return ElementPtr();
+
+      return pThis->toDebug();
+    }
+
+    //-------------------------------------------------------------------------
+    IStatsCountersSubscriptionPtr StatsCounters::subscribe(IStatsCountersDelegatePtr originalDelegate)
+    {
+      ZS_LOG_DETAIL(slog("subscribing to stats counters"))
+
+      auto pThis = singleton();
+      if (!pThis) {
+        ZS_DECLARE_STRUCT_PTR(BogusSubscription)
+
+        struct BogusSubscription : public IStatsCountersSubscription {
+          virtual PUID getID() const override {return mID;}
+          virtual void cancel() override {}
+          virtual void background() override {}
+
+          AutoPUID mID;
+        };
+
+        return make_shared<BogusSubscription>();
+      }
+
+      AutoRecursiveLock lock(*pThis);
+      if (!originalDelegate) return IStatsCountersSubscriptionPtr();
+
+      IStatsCountersSubscriptionPtr subscription = pThis->mSubscriptions.subscribe(originalDelegate, IORTCForInternal::queueDelegate());
+
+      // new subscribers require a full export to establish a delta baseline
+      pThis->mForceFullExport = true;
+
+      pThis->startExportTimer();
+
+      return subscription;
+    }
+
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr StatsCounters::snapshot(ExportFormats format)
+    {
+      auto pThis = singleton();
+      if (!pThis) return SecureByteBlockPtr();
+
+      ObjectValuesList current;
+      pThis->collect(current);
+
+      ExportEntryList entries;
+      PUIDList removed;
+      pThis->calculateExport(current, NULL, entries, removed);
+
+      DWORD sequence {};
+      {
+        AutoRecursiveLock lock(*pThis);
+        sequence = pThis->mExportSequence;
+      }
+
+      return pThis->encode(format, false, sequence, entries, removed);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsCounters => IStatsCountersForInternal
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    StatsCountersHandlePtr StatsCounters::registerObject(
+                                                         PUID objectID,
+                                                         StatsTypes statsType
+                                                         )
+    {
+      auto pThis = singleton();
+      if (!pThis) return StatsCountersHandlePtr();
+      return pThis->allocateSlot(objectID, statsType);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsCounters => ITimerDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void StatsCounters::onTimer(ITimerPtr timer)
+    {
+      ZS_LOG_INSANE(log("on timer") + ZS_PARAM("timer", timer->getID()))
+
+      AutoRecursiveLock lock(*this);
+
+      if (timer != mExportTimer) {
+        ZS_LOG_WARNING(Trace, log("notified about obsolete timer") + ZS_PARAM("timer", timer->getID()))
+        return;
+      }
+
+      if (mSubscriptions.size() < 1) {
+        ZS_LOG_DEBUG(log("no more subscribers (thus stopping export timer)"))
+
+        mExportTimer->cancel();
+        mExportTimer.reset();
+
+        mPreviousExport.clear();
+        mForceFullExport = true;
+        return;
+      }
+
+      ObjectValuesList current;
+      collect(current);
+
+      bool delta = ((!mForceFullExport) &&
+                    (mExportsSinceFull < mFullExportEvery));
+
+      ExportEntryList entries;
+      PUIDList removed;
+      calculateExport(current, delta ? (&mPreviousExport) : NULL, entries, removed);
+
+      ++mExportSequence;
+
+      auto buffer = encode(mExportFormat, delta, mExportSequence, entries, removed);
+
+      mPreviousExport.swap(current);
+
+      if (delta) {
+        ++mExportsSinceFull;
+      } else {
+        mExportsSinceFull = 0;
+        mForceFullExport = false;
+      }
+
+      if (!buffer) return;
+
+      mSubscriptions.delegate()->onStatsCountersExported(mExportFormat, buffer);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsCounters => ISingletonManagerDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void StatsCounters::notifySingletonCleanup()
+    {
+      cancel();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsCounters => friend StatsCountersHandle
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void StatsCounters::releaseSlot(SlotIndex index)
+    {
+      AutoRecursiveLock lock(*this);
+
+      ASSERT(index < mTotalSlots)
+
+      mSlots[index].mObjectID.store(0, std::memory_order_release);
+      mFreeSlots.push_back(index);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsCounters => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    Log::Params StatsCounters::log(const char *message) const
+    {
+      ElementPtr objectEl = Element::create("ortc::StatsCounters");
+      IHelper::debugAppend(objectEl, "id", mID);
+      return Log::Params(message, objectEl);
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params StatsCounters::slog(const char *message)
+    {
+      return Log::Params(message, "ortc::StatsCounters");
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params StatsCounters::debug(const char *message) const
+    {
+      return Log::Params(message, toDebug());
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr StatsCounters::toDebug() const
+    {
+      AutoRecursiveLock lock(*this);
+
+      ElementPtr resultEl = Element::create("ortc::StatsCounters");
+
+      IHelper::debugAppend(resultEl, "id", mID);
+
+      IHelper::debugAppend(resultEl, "subscribers", mSubscriptions.size());
+
+      IHelper::debugAppend(resultEl, "total slots", mTotalSlots);
+      IHelper::debugAppend(resultEl, "high water slot", mHighWaterSlot.load());
+      IHelper::debugAppend(resultEl, "free slots", mFreeSlots.size());
+
+      IHelper::debugAppend(resultEl, "export interval", mExportInterval);
+      IHelper::debugAppend(resultEl, "export timer", mExportTimer ? mExportTimer->getID() : 0);
+      IHelper::debugAppend(resultEl, "export format", IStatsCountersTypes::toString(mExportFormat));
+      IHelper::debugAppend(resultEl, "full export every", mFullExportEvery);
+      IHelper::debugAppend(resultEl, "exports since full", mExportsSinceFull);
+      IHelper::debugAppend(resultEl, "force full export", mForceFullExport);
+      IHelper::debugAppend(resultEl, "export sequence", mExportSequence);
+
+      IHelper::debugAppend(resultEl, "previous export", mPreviousExport.size());
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    void StatsCounters::cancel()
+    {
+      AutoRecursiveLock lock(*this);
+
+      if (mExportTimer) {
+        mExportTimer->cancel();
+        mExportTimer.reset();
+      }
+
+      mSubscriptions.clear();
+      mPreviousExport.clear();
+    }
+
+    //-------------------------------------------------------------------------
+    void StatsCounters::startExportTimer()
+    {
+      if (mExportTimer) return;
+      if (Milliseconds() == mExportInterval) return;
+
+      ZS_LOG_DEBUG(log("starting export timer") + ZS_PARAM("interval", mExportInterval))
+      mExportTimer = ITimer::create(mThisWeak.lock(), mExportInterval);
+    }
+
+    //-------------------------------------------------------------------------
+    StatsCountersHandlePtr StatsCounters::allocateSlot(
+                                                       PUID objectID,
+                                                       StatsTypes statsType
+                                                       )
+    {
+      AutoRecursiveLock lock(*this);
+
+      SlotIndex index {};
+
+      if (mFreeSlots.size() > 0) {
+        index = mFreeSlots.back();
+        mFreeSlots.pop_back();
+      } else {
+        index = mHighWaterSlot.load(std::memory_order_relaxed);
+        if (index >= mTotalSlots) {
+          ZS_LOG_WARNING(Debug, log("no stats counter slots available") + ZS_PARAM("object id", objectID) + ZS_PARAM("total slots", mTotalSlots))
+          return StatsCountersHandlePtr();
+        }
+        mHighWaterSlot.store(index + 1, std::memory_order_release);
+      }
+
+      auto &slot = mSlots[index];
+
+      for (size_t counter = IStatsCountersTypes::Counter_First; counter <= IStatsCountersTypes::Counter_Last; ++counter) {
+        slot.mCounters[counter].store(0, std::memory_order_relaxed);
+      }
+      slot.mStatsType.store(static_cast<int>(statsType), std::memory_order_relaxed);
+      slot.mObjectID.store(objectID, std::memory_order_release);
+
+      ZS_LOG_TRACE(log("registered stats counters") + ZS_PARAM("object id", objectID) + ZS_PARAM("type", IStatsReportTypes::toString(statsType)) + ZS_PARAM("slot", index))
+
+      return make_shared<StatsCountersHandle>(mThisWeak.lock(), &slot, index);
+    }
+
+    //-------------------------------------------------------------------------
+    void StatsCounters::collect(ObjectValuesList &outValues) const
+    {
+      // NOTE: no lock is required; counters are read with relaxed ordering
+      //       and the slot array is never reallocated
+      size_t highWater = mHighWaterSlot.load(std::memory_order_acquire);
+
+      outValues.resize(highWater);
+
+      for (size_t index = 0; index < highWater; ++index) {
+        auto &slot = mSlots[index];
+        auto &values = outValues[index];
+
+        values.mObjectID = slot.mObjectID.load(std::memory_order_acquire);
+        if (0 == values.mObjectID) continue;
+
+        values.mStatsType = static_cast<StatsTypes>(slot.mStatsType.load(std::memory_order_relaxed));
+        for (size_t counter = IStatsCountersTypes::Counter_First; counter <= IStatsCountersTypes::Counter_Last; ++counter) {
+          values.mValues[counter] = slot.mCounters[counter].load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void StatsCounters::calculateExport(
+                                        const ObjectValuesList &current,
+                                        const ObjectValuesList *previous,
+                                        ExportEntryList &outEntries,
+                                        PUIDList &outRemoved
+                                        ) const
+    {
+      outEntries.reserve(current.size());
+
+      size_t total = current.size();
+      if (previous) {
+        if (previous->size() > total) total = previous->size();
+      }
+
+      for (size_t index = 0; index < total; ++index) {
+        PUID currentID = (index < current.size() ? current[index].mObjectID : 0);
+        PUID previousID = ((NULL != previous) && (index < previous->size())) ? (*previous)[index].mObjectID : 0;
+
+        if ((0 != previousID) &&
+            (previousID != currentID)) {
+          outRemoved.push_back(previousID);
+        }
+
+        if (0 == currentID) continue;
+
+        auto &values = current[index];
+
+        ExportEntry entry;
+        entry.mObjectID = values.mObjectID;
+        entry.mStatsType = values.mStatsType;
+
+        if (previousID == currentID) {
+          auto &previousValues = (*previous)[index];
+
+          bool changed = false;
+          for (size_t counter = IStatsCountersTypes::Counter_First; counter <= IStatsCountersTypes::Counter_Last; ++counter) {
+            if (IStatsCountersTypes::isGauge(static_cast<Counters>(counter))) {
+              // gauges are exported as their current value
+              entry.mValues[counter] = static_cast<long long>(values.mValues[counter]);
+              changed = changed || (values.mValues[counter] != previousValues.mValues[counter]);
+              continue;
+            }
+            entry.mValues[counter] = static_cast<long long>(values.mValues[counter] - previousValues.mValues[counter]);
+            changed = changed || (0 != entry.mValues[counter]);
+          }
+          if (!changed) continue;
+        } else {
+          for (size_t counter = IStatsCountersTypes::Counter_First; counter <= IStatsCountersTypes::Counter_Last; ++counter) {
+            entry.mValues[counter] = static_cast<long long>(values.mValues[counter]);
+          }
+        }
+
+        outEntries.push_back(entry);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr StatsCounters::encode(
+                                             ExportFormats format,
+                                             bool delta,
+                                             DWORD sequence,
+                                             const ExportEntryList &entries,
+                                             const PUIDList &removed
+                                             ) const
+    {
+      switch (format) {
+        case IStatsCountersTypes::ExportFormat_Binary:  return encodeBinary(delta, sequence, entries, removed);
+        case IStatsCountersTypes::ExportFormat_JSON:    return encodeJSON(delta, sequence, entries, removed);
+      }
+
+      ZS_LOG_WARNING(Debug, log("export format is not supported") + ZS_PARAM("format", IStatsCountersTypes::toString(format)))
+      return SecureByteBlockPtr();
+    }
+
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr StatsCounters::encodeBinary(
+                                                   bool delta,
+                                                   DWORD sequence,
+                                                   const ExportEntryList &entries,
+                                                   const PUIDList &removed
+                                                   )
+    {
+      std::string output;
+      output.reserve(26 + (entries.size() * (9 + (IStatsCountersTypes::Counter_Last + 1) * 2)) + (removed.size() * 8));
+
+      output.append(reinterpret_cast<const char *>(kStatsCountersMagic), sizeof(kStatsCountersMagic));
+      writeBE8(output, delta ? kStatsCountersFlagDelta : 0);
+      writeBE8(output, static_cast<BYTE>(IStatsCountersTypes::Counter_Last + 1));
+      writeBE32(output, sequence);
+      writeBE64(output, getMillisecondsSinceEpoch());
+      writeBE32(output, static_cast<DWORD>(entries.size()));
+      writeBE32(output, static_cast<DWORD>(removed.size()));
+
+      for (auto iter = entries.begin(); iter != entries.end(); ++iter) {
+        auto &entry = (*iter);
+        writeBE64(output, static_cast<QWORD>(entry.mObjectID));
+        writeBE8(output, static_cast<BYTE>(entry.mStatsType));
+        for (size_t counter = IStatsCountersTypes::Counter_First; counter <= IStatsCountersTypes::Counter_Last; ++counter) {
+          writeVarInt(output, entry.mValues[counter]);
+        }
+      }
+
+      for (auto iter = removed.begin(); iter != removed.end(); ++iter) {
+        writeBE64(output, static_cast<QWORD>(*iter));
+      }
+
+      return make_shared<SecureByteBlock>(reinterpret_cast<const BYTE *>(output.c_str()), output.size());
+    }
+
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr StatsCounters::encodeJSON(
+                                                 bool delta,
+                                                 DWORD sequence,
+                                                 const ExportEntryList &entries,
+                                                 const PUIDList &removed
+                                                 )
+    {
+      // written directly rather than via an Element DOM to avoid per object
+      // allocations (all names are fixed ASCII and need no escaping)
+      std::stringstream output;
+
+      output << "{\"statsCounters\":{\"sequence\":" << sequence;
+      output << ",\"timestamp\":" << getMillisecondsSinceEpoch();
+      output << ",\"delta\":" << (delta ? "true" : "false");
+      output << ",\"objects\":[";
+
+      bool firstEntry = true;
+      for (auto iter = entries.begin(); iter != entries.end(); ++iter) {
+        auto &entry = (*iter);
+
+        if (!firstEntry) output << ",";
+        firstEntry = false;
+
+        output << "{\"id\":" << entry.mObjectID << ",\"type\":\"" << IStatsReportTypes::toString(entry.mStatsType) << "\"";
+
+        for (size_t counter = IStatsCountersTypes::Counter_First; counter <= IStatsCountersTypes::Counter_Last; ++counter) {
+          if ((delta) &&
+              (0 == entry.mValues[counter]) &&
+              (!IStatsCountersTypes::isGauge(static_cast<IStatsCountersTypes::Counters>(counter)))) continue;
+          output << ",\"" << IStatsCountersTypes::toString(static_cast<IStatsCountersTypes::Counters>(counter)) << "\":" << entry.mValues[counter];
+        }
+        output << "}";
+      }
+
+      output << "],\"removed\":[";
+
+      bool firstRemoved = true;
+      for (auto iter = removed.begin(); iter != removed.end(); ++iter) {
+        if (!firstRemoved) output << ",";
+        firstRemoved = false;
+        output << (*iter);
+      }
+
+      output << "]}}";
+
+      std::string result = output.str();
+      return make_shared<SecureByteBlock>(reinterpret_cast<const BYTE *>(result.c_str()), result.size());
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IStatsCountersFactory
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    IStatsCountersFactory &IStatsCountersFactory::singleton()
+    {
+      return StatsCountersFactory::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    StatsCountersPtr IStatsCountersFactory::create()
+    {
+      if (this) {}
+      return internal::StatsCounters::create();
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr IStatsCountersFactory::singletonToDebug()
+    {
+      if (this) {}
+      return internal::StatsCounters::singletonToDebug();
+    }
+
+    //-------------------------------------------------------------------------
+    IStatsCountersSubscriptionPtr IStatsCountersFactory::subscribe(IStatsCountersDelegatePtr delegate)
+    {
+      if (this) {}
+      return internal::StatsCounters::subscribe(delegate);
+    }
+
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr IStatsCountersFactory::snapshot(ExportFormats format)
+    {
+      if (this) {}
+      return internal::StatsCounters::snapshot(format);
+    }
+
+    //-------------------------------------------------------------------------
+    StatsCountersHandlePtr IStatsCountersFactory::registerObject(
+                                                                 PUID objectID,
+                                                                 StatsTypes statsType
+                                                                 )
+    {
+      if (this) {}
+      return internal::StatsCounters::registerObject(objectID, statsType);
+    }
+
+  } // internal namespace
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IStatsCountersTypes
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  const char *IStatsCountersTypes::toString(Counters counter)
+  {
+    switch (counter) {
+      case Counter_PacketsSent:       return "packetsSent";
+      case Counter_BytesSent:         return "bytesSent";
+      case Counter_PacketsReceived:   return "packetsReceived";
+      case Counter_BytesReceived:     return "bytesReceived";
+      case Counter_PacketsLost:       return "packetsLost";
+      case Counter_NACKCount:         return "nackCount";
+      case Counter_PLICount:          return "pliCount";
+      case Counter_FIRCount:          return "firCount";
+      case Counter_RoundTripTime:     return "roundTripTime";
+      case Counter_HandshakeQueueDepth: return "handshakeQueueDepth";
+      case Counter_HandshakeProcessingTime: return "handshakeProcessingTime";
+    }
+    return "UNDEFINED";
+  }
+
+  //---------------------------------------------------------------------------
+  Optional<IStatsCountersTypes::Counters> IStatsCountersTypes::toCounter(const char *counter)
+  {
+    String str(counter);
+    for (IStatsCountersTypes::Counters index = IStatsCountersTypes::Counter_First; index <= IStatsCountersTypes::Counter_Last; index = static_cast<IStatsCountersTypes::Counters>(static_cast<std::underlying_type<IStatsCountersTypes::Counters>::type>(index) + 1)) {
+      if (0 == str.compareNoCase(IStatsCountersTypes::toString(index))) return index;
+    }
+
+    return Optional<Counters>();
+  }
+
+  //---------------------------------------------------------------------------
+  bool IStatsCountersTypes::isGauge(Counters counter)
+  {
+    switch (counter) {
+      case Counter_PacketsLost:       return true;
+      case Counter_RoundTripTime:     return true;
+      case Counter_HandshakeQueueDepth: return true;
+      case Counter_HandshakeProcessingTime: return true;
+      default:                        break;
+    }
+    return false;
+  }
+
+  //---------------------------------------------------------------------------
+  const char *IStatsCountersTypes::toString(ExportFormats format)
+  {
+    switch (format) {
+      case ExportFormat_Binary:       return "binary";
+      case ExportFormat_JSON:         return "json";
+    }
+    return "UNDEFINED";
+  }
+
+  //---------------------------------------------------------------------------
+  Optional<IStatsCountersTypes::ExportFormats> IStatsCountersTypes::toExportFormat(const char *format)
+  {
+    String str(format);
+    for (IStatsCountersTypes::ExportFormats index = IStatsCountersTypes::ExportFormat_First; index <= IStatsCountersTypes::ExportFormat_Last; index = static_cast<IStatsCountersTypes::ExportFormats>(static_cast<std::underlying_type<IStatsCountersTypes::ExportFormats>::type>(index) + 1)) {
+      if (0 == str.compareNoCase(IStatsCountersTypes::toString(index))) return index;
+    }
+
+    return Optional<ExportFormats>();
+  }
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IStatsCounters
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  ElementPtr IStatsCounters::toDebug()
+  {
+    return internal::IStatsCountersFactory::singleton().singletonToDebug();
+  }
+
+  //---------------------------------------------------------------------------
+  IStatsCountersSubscriptionPtr IStatsCounters::subscribe(IStatsCountersDelegatePtr delegate)
+  {
+    return internal::IStatsCountersFactory::singleton().subscribe(delegate);
+  }
+
+  //---------------------------------------------------------------------------
+  SecureByteBlockPtr IStatsCounters::snapshot(ExportFormats format)
+  {
+    return internal::IStatsCountersFactory::singleton().snapshot(format);
+  }
+
+} // namespace ortc
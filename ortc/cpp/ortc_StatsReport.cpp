@@ -2279,6 +2279,14 @@ namespace ortc
     mReadable(op2.mReadable),
     mBytesSent(op2.mBytesSent),
     mBytesReceived(op2.mBytesReceived),
+    mPacketsSent(op2.mPacketsSent),
+    mPacketsReceived(op2.mPacketsReceived),
+    mRequestsSent(op2.mRequestsSent),
+    mRequestsReceived(op2.mRequestsReceived),
+    mResponsesSent(op2.mResponsesSent),
+    mResponsesReceived(op2.mResponsesReceived),
+    mConsentRequestsSent(op2.mConsentRequestsSent),
+    mLastConsentTimestamp(op2.mLastConsentTimestamp),
     mRoundTripTime(op2.mRoundTripTime),
     mAvailableOutgoingBitrate(op2.mAvailableOutgoingBitrate),
     mAvailableIncomingBitrate(op2.mAvailableIncomingBitrate)
@@ -2315,6 +2323,14 @@ namespace ortc
     IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "readable", mReadable);
     IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "bytesSent", mBytesSent);
     IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "bytesReceived", mBytesReceived);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "packetsSent", mPacketsSent);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "packetsReceived", mPacketsReceived);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "requestsSent", mRequestsSent);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "requestsReceived", mRequestsReceived);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "responsesSent", mResponsesSent);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "responsesReceived", mResponsesReceived);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "consentRequestsSent", mConsentRequestsSent);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "lastConsentTimestamp", mLastConsentTimestamp);
     IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "roundTripTime", mRoundTripTime);
     IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "availableOutgoingBitrate", mAvailableOutgoingBitrate);
     IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "availableIncomingBitrate", mAvailableIncomingBitrate);
@@ -2348,6 +2364,14 @@ namespace ortc
     IHelper::adoptElementValue(rootEl, "readable", mReadable);
     IHelper::adoptElementValue(rootEl, "bytesSent", mBytesSent);
     IHelper::adoptElementValue(rootEl, "bytesReceived", mBytesReceived);
+    IHelper::adoptElementValue(rootEl, "packetsSent", mPacketsSent);
+    IHelper::adoptElementValue(rootEl, "packetsReceived", mPacketsReceived);
+    IHelper::adoptElementValue(rootEl, "requestsSent", mRequestsSent);
+    IHelper::adoptElementValue(rootEl, "requestsReceived", mRequestsReceived);
+    IHelper::adoptElementValue(rootEl, "responsesSent", mResponsesSent);
+    IHelper::adoptElementValue(rootEl, "responsesReceived", mResponsesReceived);
+    IHelper::adoptElementValue(rootEl, "consentRequestsSent", mConsentRequestsSent);
+    IHelper::adoptElementValue(rootEl, "lastConsentTimestamp", mLastConsentTimestamp);
     IHelper::adoptElementValue(rootEl, "roundTripTime", mRoundTripTime);
     IHelper::adoptElementValue(rootEl, "availableOutgoingBitrate", mAvailableOutgoingBitrate);
     IHelper::adoptElementValue(rootEl, "availableIncomingBitrate", mAvailableIncomingBitrate);
@@ -2390,6 +2414,24 @@ namespace ortc
     hasher->update(":");
     hasher->update(mBytesSent);
     hasher->update(":");
+    hasher->update(mBytesReceived);
+    hasher->update(":");
+    hasher->update(mPacketsSent);
+    hasher->update(":");
+    hasher->update(mPacketsReceived);
+    hasher->update(":");
+    hasher->update(mRequestsSent);
+    hasher->update(":");
+    hasher->update(mRequestsReceived);
+    hasher->update(":");
+    hasher->update(mResponsesSent);
+    hasher->update(":");
+    hasher->update(mResponsesReceived);
+    hasher->update(":");
+    hasher->update(mConsentRequestsSent);
+    hasher->update(":");
+    hasher->update(mLastConsentTimestamp);
+    hasher->update(":");
     hasher->update(mRoundTripTime);
     hasher->update(":");
     hasher->update(mAvailableOutgoingBitrate);
@@ -2415,6 +2457,14 @@ namespace ortc
     internal::reportBool(mID, timestamp, "readable", mReadable);
     internal::reportInt64(mID, timestamp, "bytesSent", SafeInt<int64_t>(mBytesSent));
     internal::reportInt64(mID, timestamp, "bytesReceived", SafeInt<int64_t>(mBytesReceived));
+    internal::reportInt64(mID, timestamp, "packetsSent", SafeInt<int64_t>(mPacketsSent));
+    internal::reportInt64(mID, timestamp, "packetsReceived", SafeInt<int64_t>(mPacketsReceived));
+    internal::reportInt64(mID, timestamp, "requestsSent", SafeInt<int64_t>(mRequestsSent));
+    internal::reportInt64(mID, timestamp, "requestsReceived", SafeInt<int64_t>(mRequestsReceived));
+    internal::reportInt64(mID, timestamp, "responsesSent", SafeInt<int64_t>(mResponsesSent));
+    internal::reportInt64(mID, timestamp, "responsesReceived", SafeInt<int64_t>(mResponsesReceived));
+    internal::reportInt64(mID, timestamp, "consentRequestsSent", SafeInt<int64_t>(mConsentRequestsSent));
+    internal::reportInt64(mID, timestamp, "lastConsentTimestamp", static_cast<int64_t>(internal::getTimestamp(mLastConsentTimestamp)));
     internal::reportFloat(mID, timestamp, "roundTripTime", static_cast<float>(mRoundTripTime));
     internal::reportFloat(mID, timestamp, "availableOutgoingBitrate", static_cast<float>(mAvailableOutgoingBitrate));
     internal::reportFloat(mID, timestamp, "availableIncomingBitrate", static_cast<float>(mAvailableIncomingBitrate));
@@ -0,0 +1,972 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include <ortc/internal/ortc_SyntheticMediaSource.h>
+#include <ortc/internal/ortc_ORTC.h>
+#include <ortc/internal/platform.h>
+
+#include <ortc/IHelper.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/Numeric.h>
+#include <zsLib/Stringize.h>
+#include <zsLib/Log.h>
+#include <zsLib/XML.h>
+
+#include <webrtc/common_video/include/video_frame_buffer.h>
+#include <webrtc/system_wrappers/include/clock.h>
+
+#include <chrono>
+#include <fstream>
+
+#include <math.h>
+
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib_mediadevices) }
+
+namespace ortc
+{
+  ZS_DECLARE_USING_PTR(zsLib, ISettings);
+
+  using zsLib::Numeric;
+
+  namespace internal
+  {
+    ZS_DECLARE_CLASS_PTR(SyntheticMediaSourceSettingsDefaults);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SyntheticMediaSourceSettingsDefaults
+    #pragma mark
+
+    class SyntheticMediaSourceSettingsDefaults : public ISettingsApplyDefaultsDelegate
+    {
+    public:
+      //-----------------------------------------------------------------------
+      ~SyntheticMediaSourceSettingsDefaults()
+      {
+        ISettings::removeDefaults(*this);
+      }
+
+      //-----------------------------------------------------------------------
+      static SyntheticMediaSourceSettingsDefaultsPtr singleton()
+      {
+        static SingletonLazySharedPtr<SyntheticMediaSourceSettingsDefaults> singleton(create());
+        return singleton.singleton();
+      }
+
+      //-----------------------------------------------------------------------
+      static SyntheticMediaSourceSettingsDefaultsPtr create()
+      {
+        auto pThis(make_shared<SyntheticMediaSourceSettingsDefaults>());
+        ISettings::installDefaults(pThis);
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      virtual void notifySettingsApplyDefaults() override
+      {
+        ISettings::setUInt(ORTC_SETTING_SYNTHETIC_MEDIA_SOURCE_MAX_PRELOAD_VIDEO_FRAMES, 300);
+        ISettings::setUInt(ORTC_SETTING_SYNTHETIC_MEDIA_SOURCE_MAX_PRELOAD_AUDIO_SECONDS, 60);
+      }
+      
+    };
+
+    //-------------------------------------------------------------------------
+    void installSyntheticMediaSourceSettingsDefaults()
+    {
+      SyntheticMediaSourceSettingsDefaults::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (helpers)
+    #pragma mark
+
+    static const char *kSyntheticDeviceIDPrefix = "synthetic:";
+
+    static const ULONG kDefaultWidth = 640;
+    static const ULONG kDefaultHeight = 480;
+    static const double kDefaultFrameRate = 30.0;
+    static const ULONG kDefaultToneFrequency = 440;
+    static const ULONG kDefaultSampleRate = 48000;
+    static const size_t kDefaultChannels = 1;
+
+    //-------------------------------------------------------------------------
+    struct SyntheticMediaSourceRegistry
+    {
+      Lock mLock;
+      SyntheticMediaSource::SourceMap mSources;
+    };
+
+    //-------------------------------------------------------------------------
+    static SyntheticMediaSourceRegistry &registry()
+    {
+      static SyntheticMediaSourceRegistry gRegistry;
+      return gRegistry;
+    }
+
+    //-------------------------------------------------------------------------
+    static size_t chromaSize(ULONG value)
+    {
+      return static_cast<size_t>((value + 1) / 2);
+    }
+
+    //-------------------------------------------------------------------------
+    static DWORD readLittleEndian(const BYTE *data, size_t length)
+    {
+      DWORD result {};
+      for (size_t index = length; index > 0; --index) {
+        result = (result << 8) | static_cast<DWORD>(data[index-1]);
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    static void copyPlane(
+                          const BYTE *source,
+                          size_t sourceStride,
+                          BYTE *dest,
+                          size_t destStride,
+                          size_t width,
+                          size_t height
+                          )
+    {
+      for (size_t row = 0; row < height; ++row) {
+        memcpy(&(dest[row * destStride]), &(source[row * sourceStride]), width);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ISyntheticMediaSourceForDeviceResource
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr ISyntheticMediaSourceForDeviceResource::toDebug(ForDeviceResourcePtr source)
+    {
+      return SyntheticMediaSource::toDebug(SyntheticMediaSource::convert(source));
+    }
+
+    //-------------------------------------------------------------------------
+    bool ISyntheticMediaSourceForDeviceResource::isSyntheticDeviceID(const String &deviceID)
+    {
+      return 0 == deviceID.compare(0, strlen(kSyntheticDeviceIDPrefix), kSyntheticDeviceIDPrefix);
+    }
+
+    //-------------------------------------------------------------------------
+    ISyntheticMediaSourceForDeviceResource::ForDeviceResourcePtr ISyntheticMediaSourceForDeviceResource::open(const String &deviceID)
+    {
+      return SyntheticMediaSource::open(deviceID);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SyntheticMediaSource
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    const char *SyntheticMediaSource::toString(SourceTypes type)
+    {
+      switch (type) {
+        case SourceType_VideoPattern: return "video-pattern";
+        case SourceType_VideoFile:    return "video-file";
+        case SourceType_AudioTone:    return "audio-tone";
+        case SourceType_AudioFile:    return "audio-file";
+      }
+      return "UNDEFINED";
+    }
+
+    //-------------------------------------------------------------------------
+    SyntheticMediaSource::SourceTypes SyntheticMediaSource::toSourceType(const char *type) throw (InvalidParameters)
+    {
+      String str(type);
+      for (SourceTypes index = SourceType_First; index <= SourceType_Last; index = static_cast<SourceTypes>(static_cast<std::underlying_type<SourceTypes>::type>(index) + 1)) {
+        if (0 == str.compareNoCase(toString(index))) return index;
+      }
+
+      ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + str)
+    }
+
+    //-------------------------------------------------------------------------
+    SyntheticMediaSource::SyntheticMediaSource(
+                                               const make_private &,
+                                               const String &deviceID,
+                                               SourceTypes type,
+                                               const ParameterMap &params
+                                               ) :
+      SharedRecursiveLock(SharedRecursiveLock::create()),
+      mDeviceID(deviceID),
+      mType(type),
+      mParams(params),
+      mSinks(make_shared<SinkMap>())
+    {
+      ZS_LOG_DETAIL(debug("created"))
+    }
+
+    //-------------------------------------------------------------------------
+    void SyntheticMediaSource::init()
+    {
+      switch (mType) {
+        case SourceType_VideoPattern: mLoaded = loadVideoPattern(); break;
+        case SourceType_VideoFile:    mLoaded = loadVideoFile(); break;
+        case SourceType_AudioTone:    mLoaded = loadAudioTone(); break;
+        case SourceType_AudioFile:    mLoaded = loadAudioFile(); break;
+      }
+
+      ZS_LOG_DETAIL(debug("initialized"))
+    }
+
+    //-------------------------------------------------------------------------
+    SyntheticMediaSource::~SyntheticMediaSource()
+    {
+      mThisWeak.reset();
+
+      ZS_LOG_DETAIL(log("destroyed"))
+
+      // NOTE: the registry entry is left behind as an expired weak pointer
+      // and is purged the next time the same device ID is opened.
+
+      // the pacing thread holds a reference to the source thus it has
+      // always been stopped (by the last detach) before destruction
+      ASSERT(!mThread.joinable())
+    }
+
+    //-------------------------------------------------------------------------
+    SyntheticMediaSourcePtr SyntheticMediaSource::convert(ForDeviceResourcePtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(SyntheticMediaSource, object);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SyntheticMediaSource => ISyntheticMediaSourceForDeviceResource
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr SyntheticMediaSource::toDebug(SyntheticMediaSourcePtr source)
+    {
+      if (!source) return ElementPtr();
+      return source->toDebug();
+    }
+
+    //-------------------------------------------------------------------------
+    SyntheticMediaSourcePtr SyntheticMediaSource::open(const String &deviceID)
+    {
+      SourceTypes type {SourceType_First};
+      ParameterMap params;
+
+      if (!parseDeviceID(deviceID, type, params)) {
+        ZS_LOG_WARNING(Detail, slog("unable to parse synthetic device id") + ZS_PARAM("device id", deviceID))
+        return SyntheticMediaSourcePtr();
+      }
+
+      auto &reg = registry();
+
+      // NOTE: the registry lock is held while a new source loads so two
+      // tracks opening the same file at once do not decode it twice.
+      AutoLock lock(reg.mLock);
+
+      auto found = reg.mSources.find(deviceID);
+      if (found != reg.mSources.end()) {
+        auto existing = (*found).second.lock();
+        if (existing) {
+          ZS_LOG_TRACE(slog("sharing existing synthetic source") + ZS_PARAM("device id", deviceID) + ZS_PARAM("source", existing->getID()))
+          return existing;
+        }
+        reg.mSources.erase(found);
+      }
+
+      SyntheticMediaSourcePtr pThis(make_shared<SyntheticMediaSource>(make_private {}, deviceID, type, params));
+      pThis->mThisWeak = pThis;
+      pThis->init();
+
+      if (!pThis->mLoaded) {
+        ZS_LOG_WARNING(Detail, pThis->log("unable to load synthetic source"))
+        return SyntheticMediaSourcePtr();
+      }
+
+      reg.mSources[deviceID] = pThis;
+      return pThis;
+    }
+
+    //-------------------------------------------------------------------------
+    SyntheticMediaSource::Kinds SyntheticMediaSource::kind() const
+    {
+      return isVideo() ? IMediaStreamTrackTypes::Kind_Video : IMediaStreamTrackTypes::Kind_Audio;
+    }
+
+    //-------------------------------------------------------------------------
+    void SyntheticMediaSource::attach(
+                                      PUID sinkID,
+                                      UseSinkPtr sink
+                                      )
+    {
+      ZS_LOG_DEBUG(log("attach sink") + ZS_PARAM("sink", sinkID))
+
+      AutoRecursiveLock lock(*this);
+
+      auto replacement = make_shared<SinkMap>(*mSinks);
+      (*replacement)[sinkID] = sink;
+      mSinks = replacement; // COW replacement
+
+      start();
+    }
+
+    //-------------------------------------------------------------------------
+    void SyntheticMediaSource::detach(PUID sinkID)
+    {
+      ZS_LOG_DEBUG(log("detach sink") + ZS_PARAM("sink", sinkID))
+
+      std::thread thread;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        auto found = mSinks->find(sinkID);
+        if (found == mSinks->end()) return;
+
+        auto replacement = make_shared<SinkMap>(*mSinks);
+        replacement->erase(sinkID);
+        mSinks = replacement; // COW replacement
+
+        // the decision to stop and the stop itself happen within the same
+        // lock so a concurrent attach always starts a fresh pacing thread
+        if (mSinks->size() < 1) stop(thread);
+      }
+
+      join(thread);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SyntheticMediaSource => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    Log::Params SyntheticMediaSource::slog(const char *message)
+    {
+      return Log::Params(message, "ortc::SyntheticMediaSource");
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params SyntheticMediaSource::log(const char *message) const
+    {
+      ElementPtr objectEl = Element::create("ortc::SyntheticMediaSource");
+      IHelper::debugAppend(objectEl, "id", mID);
+      return Log::Params(message, objectEl);
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params SyntheticMediaSource::debug(const char *message) const
+    {
+      return Log::Params(message, toDebug());
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr SyntheticMediaSource::toDebug() const
+    {
+      AutoRecursiveLock lock(*this);
+
+      ElementPtr resultEl = Element::create("ortc::SyntheticMediaSource");
+
+      IHelper::debugAppend(resultEl, "id", mID);
+
+      IHelper::debugAppend(resultEl, "device id", mDeviceID);
+      IHelper::debugAppend(resultEl, "type", toString(mType));
+      IHelper::debugAppend(resultEl, "loaded", mLoaded);
+
+      IHelper::debugAppend(resultEl, "width", mWidth);
+      IHelper::debugAppend(resultEl, "height", mHeight);
+      IHelper::debugAppend(resultEl, "frame rate", mFrameRate);
+      IHelper::debugAppend(resultEl, "frames", mFrames.size());
+
+      IHelper::debugAppend(resultEl, "sample rate", mSampleRate);
+      IHelper::debugAppend(resultEl, "channels", mChannels);
+      IHelper::debugAppend(resultEl, "samples", mSamples.size());
+
+      IHelper::debugAppend(resultEl, "sinks", mSinks->size());
+      IHelper::debugAppend(resultEl, "running", mThread.joinable());
+
+      IHelper::debugAppend(resultEl, "delivered", static_cast<ULONG>(mFramesDelivered));
+      IHelper::debugAppend(resultEl, "late deadlines", static_cast<ULONG>(mLateDeadlines));
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    bool SyntheticMediaSource::parseDeviceID(
+                                             const String &deviceID,
+                                             SourceTypes &outType,
+                                             ParameterMap &outParams
+                                             )
+    {
+      if (!ISyntheticMediaSourceForDeviceResource::isSyntheticDeviceID(deviceID)) return false;
+
+      String remaining = deviceID.substr(strlen(kSyntheticDeviceIDPrefix));
+
+      String typeStr = remaining;
+      String query;
+
+      auto pos = remaining.find('?');
+      if (String::npos != pos) {
+        typeStr = remaining.substr(0, pos);
+        query = remaining.substr(pos + 1);
+      }
+
+      try {
+        outType = toSourceType(typeStr);
+      } catch (const InvalidParameters &) {
+        return false;
+      }
+
+      IHelper::SplitMap pairs;
+      IHelper::split(query, pairs, '&');
+
+      for (auto iter = pairs.begin(); iter != pairs.end(); ++iter) {
+        auto &pair = (*iter).second;
+        if (pair.isEmpty()) continue;
+
+        auto equals = pair.find('=');
+        if (String::npos == equals) {
+          outParams[pair] = String();
+          continue;
+        }
+        outParams[pair.substr(0, equals)] = pair.substr(equals + 1);
+      }
+
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    String SyntheticMediaSource::getParam(
+                                          const ParameterMap &params,
+                                          const char *name
+                                          )
+    {
+      auto found = params.find(String(name));
+      if (found == params.end()) return String();
+      return (*found).second;
+    }
+
+    //-------------------------------------------------------------------------
+    template <typename T>
+    T SyntheticMediaSource::getParam(
+                                     const ParameterMap &params,
+                                     const char *name,
+                                     T defaultValue
+                                     )
+    {
+      String value = getParam(params, name);
+      if (value.isEmpty()) return defaultValue;
+
+      try {
+        return Numeric<T>(value);
+      } catch (const typename Numeric<T>::ValueOutOfRange &) {
+        ZS_LOG_WARNING(Detail, slog("synthetic source parameter out of range") + ZS_PARAM("name", name) + ZS_PARAM("value", value))
+      }
+      return defaultValue;
+    }
+
+    //-------------------------------------------------------------------------
+    bool SyntheticMediaSource::isVideo() const
+    {
+      return (SourceType_VideoPattern == mType) || (SourceType_VideoFile == mType);
+    }
+
+    //-------------------------------------------------------------------------
+    bool SyntheticMediaSource::loadVideoPattern()
+    {
+      mWidth = getParam<ULONG>(mParams, "width", kDefaultWidth);
+      mHeight = getParam<ULONG>(mParams, "height", kDefaultHeight);
+      mFrameRate = getParam<double>(mParams, "fps", kDefaultFrameRate);
+
+      if ((mWidth < 2) || (mHeight < 2) || (mFrameRate <= 0.0)) return false;
+
+      // One second of a moving pattern is generated up front so the encoder
+      // sees realistic motion while the pacing thread only hands out buffers.
+      size_t maxFrames = ISettings::getUInt(ORTC_SETTING_SYNTHETIC_MEDIA_SOURCE_MAX_PRELOAD_VIDEO_FRAMES);
+      size_t totalFrames = static_cast<size_t>(ceil(mFrameRate));
+      if ((0 != maxFrames) && (totalFrames > maxFrames)) totalFrames = maxFrames;
+      if (totalFrames < 1) totalFrames = 1;
+
+      size_t boxSize = static_cast<size_t>(mHeight / 4);
+      if (boxSize < 1) boxSize = 1;
+
+      for (size_t frameIndex = 0; frameIndex < totalFrames; ++frameIndex) {
+        rtc::scoped_refptr<webrtc::I420Buffer> buffer(new rtc::RefCountedObject<webrtc::I420Buffer>(static_cast<int>(mWidth), static_cast<int>(mHeight)));
+
+        BYTE *yPlane = buffer->MutableData(webrtc::kYPlane);
+        BYTE *uPlane = buffer->MutableData(webrtc::kUPlane);
+        BYTE *vPlane = buffer->MutableData(webrtc::kVPlane);
+        size_t yStride = static_cast<size_t>(buffer->stride(webrtc::kYPlane));
+        size_t uStride = static_cast<size_t>(buffer->stride(webrtc::kUPlane));
+        size_t vStride = static_cast<size_t>(buffer->stride(webrtc::kVPlane));
+
+        size_t shift = (frameIndex * mWidth) / totalFrames;
+        size_t boxLeft = shift % (mWidth > boxSize ? mWidth - boxSize : 1);
+        size_t boxTop = (mHeight - boxSize) / 2;
+
+        for (size_t y = 0; y < mHeight; ++y) {
+          for (size_t x = 0; x < mWidth; ++x) {
+            bool inBox = (x >= boxLeft) && (x < boxLeft + boxSize) && (y >= boxTop) && (y < boxTop + boxSize);
+            yPlane[(y * yStride) + x] = inBox ? 235 : static_cast<BYTE>(((x + shift) + (y / 2)) & 0xFF);
+          }
+        }
+        for (size_t y = 0; y < chromaSize(mHeight); ++y) {
+          for (size_t x = 0; x < chromaSize(mWidth); ++x) {
+            uPlane[(y * uStride) + x] = static_cast<BYTE>((x * 255) / chromaSize(mWidth));
+            vPlane[(y * vStride) + x] = static_cast<BYTE>((y * 255) / chromaSize(mHeight));
+          }
+        }
+
+        mFrames.push_back(buffer);
+      }
+
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool SyntheticMediaSource::loadVideoFile()
+    {
+      String path = getParam(mParams, "path");
+      if (path.isEmpty()) return false;
+
+      std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+      if (!file.is_open()) {
+        ZS_LOG_WARNING(Detail, log("unable to open video file") + ZS_PARAM("path", path))
+        return false;
+      }
+
+      bool isY4M = false;
+
+      {
+        char magic[10] {};
+        file.read(magic, sizeof(magic) - 1);
+        isY4M = (0 == strncmp(magic, "YUV4MPEG2", sizeof(magic) - 1));
+        if (!isY4M) file.seekg(0, std::ios::beg);
+      }
+
+      mWidth = getParam<ULONG>(mParams, "width", 0);
+      mHeight = getParam<ULONG>(mParams, "height", 0);
+      mFrameRate = getParam<double>(mParams, "fps", 0.0);
+
+      if (isY4M) {
+        std::string header;
+        std::getline(file, header);
+
+        IHelper::SplitMap tokens;
+        IHelper::split(String(header), tokens, ' ');
+
+        for (auto iter = tokens.begin(); iter != tokens.end(); ++iter) {
+          auto &token = (*iter).second;
+          if (token.length() < 2) continue;
+
+          String value = token.substr(1);
+          try {
+            switch (token[0]) {
+              case 'W': if (0 == mWidth) mWidth = Numeric<ULONG>(value); break;
+              case 'H': if (0 == mHeight) mHeight = Numeric<ULONG>(value); break;
+              case 'F': {
+                if (0.0 != mFrameRate) break;
+                auto colon = value.find(':');
+                if (String::npos == colon) break;
+                double numerator = Numeric<double>(value.substr(0, colon));
+                double denominator = Numeric<double>(value.substr(colon + 1));
+                if (denominator > 0.0) mFrameRate = numerator / denominator;
+                break;
+              }
+              case 'C': {
+                if (0 != value.compare(0, 3, "420")) {
+                  ZS_LOG_WARNING(Detail, log("only 4:2:0 y4m files are supported") + ZS_PARAM("colour space", value))
+                  return false;
+                }
+                break;
+              }
+              default:  break;
+            }
+          } catch (const Numeric<ULONG>::ValueOutOfRange &) {
+            return false;
+          } catch (const Numeric<double>::ValueOutOfRange &) {
+            return false;
+          }
+        }
+      }
+
+      if (0.0 == mFrameRate) mFrameRate = kDefaultFrameRate;
+      if ((mWidth < 2) || (mHeight < 2) || (mFrameRate <= 0.0)) {
+        ZS_LOG_WARNING(Detail, log("video file dimensions are not known") + ZS_PARAM("path", path))
+        return false;
+      }
+
+      size_t ySize = static_cast<size_t>(mWidth) * static_cast<size_t>(mHeight);
+      size_t uvSize = chromaSize(mWidth) * chromaSize(mHeight);
+
+      std::vector<BYTE> raw(ySize + (uvSize * 2));
+
+      size_t maxFrames = ISettings::getUInt(ORTC_SETTING_SYNTHETIC_MEDIA_SOURCE_MAX_PRELOAD_VIDEO_FRAMES);
+
+      while ((0 == maxFrames) || (mFrames.size() < maxFrames)) {
+        if (isY4M) {
+          std::string frameHeader;
+          std::getline(file, frameHeader);
+          if (!file.good()) break;
+          if (0 != frameHeader.compare(0, 5, "FRAME")) break;
+        }
+
+        file.read(reinterpret_cast<char *>(&(raw[0])), raw.size());
+        if (static_cast<size_t>(file.gcount()) != raw.size()) break;
+
+        rtc::scoped_refptr<webrtc::I420Buffer> buffer(new rtc::RefCountedObject<webrtc::I420Buffer>(static_cast<int>(mWidth), static_cast<int>(mHeight)));
+
+        copyPlane(&(raw[0]), mWidth, buffer->MutableData(webrtc::kYPlane), buffer->stride(webrtc::kYPlane), mWidth, mHeight);
+        copyPlane(&(raw[ySize]), chromaSize(mWidth), buffer->MutableData(webrtc::kUPlane), buffer->stride(webrtc::kUPlane), chromaSize(mWidth), chromaSize(mHeight));
+        copyPlane(&(raw[ySize + uvSize]), chromaSize(mWidth), buffer->MutableData(webrtc::kVPlane), buffer->stride(webrtc::kVPlane), chromaSize(mWidth), chromaSize(mHeight));
+
+        mFrames.push_back(buffer);
+      }
+
+      if (mFrames.size() < 1) {
+        ZS_LOG_WARNING(Detail, log("video file contains no complete frames") + ZS_PARAM("path", path))
+        return false;
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool SyntheticMediaSource::loadAudioTone()
+    {
+      ULONG frequency = getParam<ULONG>(mParams, "frequency", kDefaultToneFrequency);
+      mSampleRate = getParam<ULONG>(mParams, "rate", kDefaultSampleRate);
+      mChannels = getParam<size_t>(mParams, "channels", kDefaultChannels);
+
+      if ((mSampleRate < 100) || (mChannels < 1) || (frequency < 1)) return false;
+
+      // one second of an integer frequency loops without a discontinuity
+      const double kPi = 3.14159265358979323846;
+      const double kAmplitude = 32767.0 * 0.25;
+
+      mSamples.resize(static_cast<size_t>(mSampleRate) * mChannels);
+      for (size_t index = 0; index < static_cast<size_t>(mSampleRate); ++index) {
+        int16_t value = static_cast<int16_t>(kAmplitude * sin((2.0 * kPi * frequency * index) / mSampleRate));
+        for (size_t channel = 0; channel < mChannels; ++channel) {
+          mSamples[(index * mChannels) + channel] = value;
+        }
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool SyntheticMediaSource::loadAudioFile()
+    {
+      String path = getParam(mParams, "path");
+      if (path.isEmpty()) return false;
+
+      std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+      if (!file.is_open()) {
+        ZS_LOG_WARNING(Detail, log("unable to open audio file") + ZS_PARAM("path", path))
+        return false;
+      }
+
+      mSampleRate = getParam<ULONG>(mParams, "rate", 0);
+      mChannels = getParam<size_t>(mParams, "channels", 0);
+
+      size_t dataLength = 0;
+      bool foundData = false;
+
+      BYTE riff[12] {};
+      file.read(reinterpret_cast<char *>(&(riff[0])), sizeof(riff));
+
+      if ((sizeof(riff) == static_cast<size_t>(file.gcount())) &&
+          (0 == memcmp(&(riff[0]), "RIFF", 4)) &&
+          (0 == memcmp(&(riff[8]), "WAVE", 4))) {
+
+        while (file.good()) {
+          BYTE chunkHeader[8] {};
+          file.read(reinterpret_cast<char *>(&(chunkHeader[0])), sizeof(chunkHeader));
+          if (sizeof(chunkHeader) != static_cast<size_t>(file.gcount())) break;
+
+          size_t chunkLength = static_cast<size_t>(readLittleEndian(&(chunkHeader[4]), 4));
+
+          if (0 == memcmp(&(chunkHeader[0]), "data", 4)) {
+            dataLength = chunkLength;
+            foundData = true;
+            break;
+          }
+
+          if (0 == memcmp(&(chunkHeader[0]), "fmt ", 4)) {
+            std::vector<BYTE> format(chunkLength < 16 ? 16 : chunkLength);
+            file.read(reinterpret_cast<char *>(&(format[0])), chunkLength);
+            if (chunkLength != static_cast<size_t>(file.gcount())) break;
+
+            WORD formatTag = static_cast<WORD>(readLittleEndian(&(format[0]), 2));
+            WORD bitsPerSample = static_cast<WORD>(readLittleEndian(&(format[14]), 2));
+
+            if (((1 != formatTag) && (0xFFFE != formatTag)) ||
+                (16 != bitsPerSample)) {
+              ZS_LOG_WARNING(Detail, log("only 16-bit PCM wav files are supported") + ZS_PARAM("path", path) + ZS_PARAM("format", formatTag) + ZS_PARAM("bits", bitsPerSample))
+              return false;
+            }
+
+            mChannels = static_cast<size_t>(readLittleEndian(&(format[2]), 2));
+            mSampleRate = static_cast<ULONG>(readLittleEndian(&(format[4]), 4));
+          } else {
+            file.seekg(chunkLength, std::ios::cur);
+          }
+
+          // chunks are word aligned
+          if (0 != (chunkLength % 2)) file.seekg(1, std::ios::cur);
+        }
+
+        if (!foundData) {
+          ZS_LOG_WARNING(Detail, log("wav file has no data chunk") + ZS_PARAM("path", path))
+          return false;
+        }
+      } else {
+        // raw 16-bit little endian PCM
+        file.clear();
+        file.seekg(0, std::ios::end);
+        dataLength = static_cast<size_t>(file.tellg());
+        file.seekg(0, std::ios::beg);
+      }
+
+      if ((mSampleRate < 100) || (mChannels < 1)) {
+        ZS_LOG_WARNING(Detail, log("audio file format is not known") + ZS_PARAM("path", path))
+        return false;
+      }
+
+      size_t maxSeconds = ISettings::getUInt(ORTC_SETTING_SYNTHETIC_MEDIA_SOURCE_MAX_PRELOAD_AUDIO_SECONDS);
+      size_t totalSamples = dataLength / sizeof(int16_t);
+      if (0 != maxSeconds) {
+        size_t maxSamples = maxSeconds * static_cast<size_t>(mSampleRate) * mChannels;
+        if (totalSamples > maxSamples) totalSamples = maxSamples;
+      }
+      totalSamples -= (totalSamples % mChannels);
+
+      std::vector<BYTE> raw(totalSamples * sizeof(int16_t));
+      if (raw.size() > 0) {
+        file.read(reinterpret_cast<char *>(&(raw[0])), raw.size());
+        totalSamples = static_cast<size_t>(file.gcount()) / sizeof(int16_t);
+        totalSamples -= (totalSamples % mChannels);
+      }
+
+      mSamples.resize(totalSamples);
+      for (size_t index = 0; index < totalSamples; ++index) {
+        mSamples[index] = static_cast<int16_t>(readLittleEndian(&(raw[index * sizeof(int16_t)]), sizeof(int16_t)));
+      }
+
+      // at least one full 10ms chunk is required to pace the output
+      if (mSamples.size() < (static_cast<size_t>(mSampleRate / 100) * mChannels)) {
+        ZS_LOG_WARNING(Detail, log("audio file is too short") + ZS_PARAM("path", path))
+        return false;
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void SyntheticMediaSource::start()
+    {
+      if (mThread.joinable()) return;
+
+      auto pThis = mThisWeak.lock();
+      if (!pThis) return;
+
+      ZS_LOG_DEBUG(log("starting pacing thread"))
+
+      // the thread keeps the source alive until it has been told to stop
+      auto shouldStop = make_shared<StopFlag>(false);
+      mShouldStop = shouldStop;
+
+      if (isVideo()) {
+        mThread = std::thread([pThis, shouldStop]() { pThis->runVideo(*shouldStop); });
+      } else {
+        mThread = std::thread([pThis, shouldStop]() { pThis->runAudio(*shouldStop); });
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void SyntheticMediaSource::stop(std::thread &outThread)
+    {
+      if (!mThread.joinable()) return;
+
+      ZS_LOG_DEBUG(log("stopping pacing thread"))
+
+      if (mShouldStop) mShouldStop->store(true);
+      mShouldStop.reset();
+
+      outThread = std::move(mThread);
+    }
+
+    //-------------------------------------------------------------------------
+    void SyntheticMediaSource::join(std::thread &thread)
+    {
+      // warning: do NOT call from within a lock as the pacing thread obtains
+      //          the lock to fetch the current sinks
+      if (!thread.joinable()) return;
+
+      if (thread.get_id() == std::this_thread::get_id()) {
+        // a sink detached from within its own callback; the thread exits
+        // after the callback returns and holds its own source reference
+        thread.detach();
+        return;
+      }
+      thread.join();
+    }
+
+    //-------------------------------------------------------------------------
+    void SyntheticMediaSource::runVideo(const StopFlag &shouldStop)
+    {
+      typedef std::chrono::steady_clock Clock;
+
+      auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / mFrameRate));
+      auto clock = webrtc::Clock::GetRealTimeClock();
+
+      // Deadlines are computed from the start time so sleep jitter never
+      // accumulates into drift; missed deadlines are skipped (not bursted).
+      auto startTime = Clock::now();
+      ULONGLONG tick = 0;
+
+      while (!shouldStop) {
+        auto deadline = startTime + (interval * tick);
+        auto now = Clock::now();
+
+        if (now < deadline) {
+          std::this_thread::sleep_until(deadline);
+        } else if (now - deadline >= interval) {
+          ++mLateDeadlines;
+          tick = static_cast<ULONGLONG>((now - startTime) / interval);
+        }
+
+        if (shouldStop) break;
+
+        auto &buffer = mFrames[static_cast<size_t>(tick % mFrames.size())];
+        int64_t renderTimeMs = clock->TimeInMilliseconds();
+
+        auto currentSinks = sinks();
+        for (auto iter = currentSinks->begin(); iter != currentSinks->end(); ++iter) {
+          auto sink = (*iter).second.lock();
+          if (!sink) continue;
+
+          auto frame = make_shared<VideoFrame>(buffer, 0, renderTimeMs, webrtc::kVideoRotation_0);
+          sink->onSyntheticVideoFrame(frame);
+        }
+
+        ++mFramesDelivered;
+        ++tick;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void SyntheticMediaSource::runAudio(const StopFlag &shouldStop)
+    {
+      typedef std::chrono::steady_clock Clock;
+
+      const auto interval = std::chrono::duration_cast<Clock::duration>(Milliseconds(10));
+
+      size_t samplesPerChannel = static_cast<size_t>(mSampleRate / 100);
+      size_t chunkSize = samplesPerChannel * mChannels;
+
+      SampleBuffer chunk(chunkSize);
+      size_t position = 0;
+
+      auto startTime = Clock::now();
+      ULONGLONG tick = 0;
+
+      while (!shouldStop) {
+        auto deadline = startTime + (interval * tick);
+        auto now = Clock::now();
+
+        if (now < deadline) {
+          std::this_thread::sleep_until(deadline);
+        } else if (now - deadline >= interval) {
+          ++mLateDeadlines;
+          tick = static_cast<ULONGLONG>((now - startTime) / interval);
+        }
+
+        if (shouldStop) break;
+
+        const int16_t *samples = &(mSamples[position]);
+        if (position + chunkSize > mSamples.size()) {
+          size_t first = mSamples.size() - position;
+          memcpy(&(chunk[0]), &(mSamples[position]), first * sizeof(int16_t));
+          memcpy(&(chunk[first]), &(mSamples[0]), (chunkSize - first) * sizeof(int16_t));
+          samples = &(chunk[0]);
+        }
+        position = (position + chunkSize) % mSamples.size();
+
+        auto currentSinks = sinks();
+        for (auto iter = currentSinks->begin(); iter != currentSinks->end(); ++iter) {
+          auto sink = (*iter).second.lock();
+          if (!sink) continue;
+
+          sink->onSyntheticAudioSamples(samples, samplesPerChannel, mChannels, mSampleRate);
+        }
+
+        ++mFramesDelivered;
+        ++tick;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    SyntheticMediaSource::SinkMapPtr SyntheticMediaSource::sinks() const
+    {
+      AutoRecursiveLock lock(*this);
+      return mSinks;
+    }
+
+  }
+}
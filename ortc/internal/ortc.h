@@ -38,11 +38,15 @@
 #include <ortc/internal/ortc_Helper.h>
 #include <ortc/internal/ortc_Certificate.h>
 #include <ortc/internal/ortc_DTLSTransport.h>
+#include <ortc/internal/ortc_EventTrace.h>
 #include <ortc/internal/ortc_ICEGatherer.h>
 #include <ortc/internal/ortc_ICEGathererRouter.h>
+#include <ortc/internal/ortc_ICEGathererUDPMux.h>
 #include <ortc/internal/ortc_ICETransport.h>
 #include <ortc/internal/ortc_ICETransportController.h>
 #include <ortc/internal/ortc_MediaDevices.h>
+#include <ortc/internal/ortc_ReceiveLatency.h>
+#include <ortc/internal/ortc_RTPForwarder.h>
 #include <ortc/internal/ortc_RTPListener.h>
 #include <ortc/internal/ortc_RTPMediaEngine.h>
 #include <ortc/internal/ortc_RTPReceiver.h>
@@ -56,7 +60,9 @@
 #include <ortc/internal/ortc_RTPSenderChannelAudio.h>
 #include <ortc/internal/ortc_RTPSenderChannelVideo.h>
 #include <ortc/internal/ortc_SCTPTransport.h>
+#include <ortc/internal/ortc_StatsCounters.h>
 #include <ortc/internal/ortc_ISecureTransport.h>
 #include <ortc/internal/ortc_SRTPSDESTransport.h>
 #include <ortc/internal/ortc_ISRTPTransport.h>
 #include <ortc/internal/ortc_SRTPTransport.h>
+#include <ortc/internal/ortc_SyntheticMediaSource.h>
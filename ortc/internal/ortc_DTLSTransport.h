@@ -45,6 +45,7 @@
 
 #include <openssl/base.h>
 
+#include <atomic>
 #include <queue>
 
 #define ORTC_SETTING_DTLS_TRANSPORT_MAX_PENDING_DTLS_BUFFER "ortc/dtls/max-pending-dtls-buffer"
@@ -60,6 +61,8 @@ namespace ortc
     ZS_DECLARE_INTERACTION_PTR(IRTPListenerForSecureTransport)
     ZS_DECLARE_INTERACTION_PTR(IDataTransportForSecureTransport)
 
+    ZS_DECLARE_CLASS_PTR(StatsCountersHandle);
+
     ZS_DECLARE_INTERACTION_PTR(IDTLSTransportForSettings)
 
     ZS_DECLARE_INTERACTION_PROXY(IDTLSTransportAsyncDelegate)
@@ -97,6 +100,7 @@ namespace ortc
     {
       virtual void onAdapterSendPacket() = 0;
       virtual void onDeliverPendingIncomingRTP() = 0;
+      virtual void onProcessPendingHandshake() = 0;
     };
 
     //-------------------------------------------------------------------------
@@ -323,6 +327,12 @@ namespace ortc
                                        size_t bufferLengthInBytes
                                        ) override;
 
+      virtual bool sendEncryptedPackets(
+                                        IICETypes::Components sendOverICETransport,
+                                        IICETypes::Components packetType,
+                                        const PacketBufferRefList &packets
+                                        ) override;
+
       virtual bool handleReceivedDecryptedPacket(
                                                  IICETypes::Components viaTransport,
                                                  IICETypes::Components packetType,
@@ -384,6 +394,7 @@ namespace ortc
 
       virtual void onAdapterSendPacket() override;
       virtual void onDeliverPendingIncomingRTP() override;
+      virtual void onProcessPendingHandshake() override;
 
       //-----------------------------------------------------------------------
       #pragma mark
@@ -489,6 +500,23 @@ namespace ortc
 
       void setupSRTP();
 
+      bool queueIncomingDTLS(
+                             const BYTE *buffer,
+                             size_t bufferLengthInBytes
+                             );
+      void scheduleHandshake();
+      void readPendingIncomingDTLS(
+                                   PacketQueue &outDecryptedPackets,
+                                   StreamResult &outStreamResult,
+                                   int &outStreamError
+                                   );
+      bool handleDecryptedPackets(
+                                  IICETypes::Components viaTransport,
+                                  PacketQueue &decryptedPackets,
+                                  StreamResult streamResult,
+                                  int streamError
+                                  );
+
     public:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -738,18 +766,33 @@ namespace ortc
       Parameters mRemoteParams;
 
       AdapterPtr mAdapter;
+      mutable RecursiveLock mAdapterLock;         // serializes all adapter (OpenSSL) access; order: object lock -> adapter lock, never the reverse
 
       size_t mMaxPendingDTLSBuffer {};
       size_t mMaxPendingRTPPackets {};
 
       bool mPutIncomingRTPIntoPendingQueue {true};
       PacketQueue mPendingIncomingRTP;
-      ByteQueue mPendingIncomingDTLS;
+      mutable Lock mPendingIncomingDTLSLock;
+      ByteQueue mPendingIncomingDTLS;             // guarded by mPendingIncomingDTLSLock (filled by the packet thread, drained by the adapter)
+      size_t mPendingIncomingDTLSRecords {};      // guarded by mPendingIncomingDTLSLock (records queued since the buffer was last drained)
 
-      PacketQueue mPendingOutgoingDTLS;
+      mutable Lock mPendingOutgoingDTLSLock;
+      PacketQueue mPendingOutgoingDTLS;           // guarded by mPendingOutgoingDTLSLock
 
       bool mFixedRole {false};
 
+      // handshake records are processed in order on a queue from the shared
+      // DTLS handshake pool rather than inline on the packet thread; while a
+      // handshake is active records are handed over without the object lock
+      IMessageQueuePtr mHandshakeQueue;
+      bool mHandshakeStartPending {false};
+      std::atomic<bool> mHandshakeActive {false};
+      std::atomic<bool> mHandshakeProcessingScheduled {false};
+      Microseconds mHandshakeProcessingTime {};   // time spent in the adapter for the current handshake
+
+      StatsCountersHandlePtr mStatsCounters;     // set once in init(), updated without lock
+
       Adapter::Validation mValidation {Adapter::VALIDATION_NA};
 
       UseSRTPTransportPtr mSRTPTransport;
@@ -787,4 +830,5 @@ ZS_DECLARE_PROXY_BEGIN(ortc::internal::IDTLSTransportAsyncDelegate)
 ZS_DECLARE_PROXY_TYPEDEF(zsLib::PromisePtr, PromisePtr)
 ZS_DECLARE_PROXY_METHOD_0(onAdapterSendPacket)
 ZS_DECLARE_PROXY_METHOD_0(onDeliverPendingIncomingRTP)
+ZS_DECLARE_PROXY_METHOD_0(onProcessPendingHandshake)
 ZS_DECLARE_PROXY_END()
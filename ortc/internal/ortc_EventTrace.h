@@ -0,0 +1,260 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+
+#pragma once
+
+#include <ortc/internal/types.h>
+
+#include <zsLib/Log.h>
+
+#include <atomic>
+#include <list>
+#include <vector>
+
+#define ORTC_SETTING_EVENT_TRACE_AUTO_START "ortc/event-trace/auto-start"
+#define ORTC_SETTING_EVENT_TRACE_RING_SIZE_IN_BYTES "ortc/event-trace/ring-size-in-bytes"
+#define ORTC_SETTING_EVENT_TRACE_CAPTURE_PAYLOAD_BYTES "ortc/event-trace/capture-payload-bytes"
+#define ORTC_SETTING_EVENT_TRACE_TRIGGER_SEVERITY "ortc/event-trace/trigger-severity"
+#define ORTC_SETTING_EVENT_TRACE_TRIGGER_EVENT_IDS "ortc/event-trace/trigger-event-ids"
+#define ORTC_SETTING_EVENT_TRACE_TRIGGER_DELAY_IN_MILLISECONDS "ortc/event-trace/trigger-delay-in-milliseconds"
+#define ORTC_SETTING_EVENT_TRACE_TRIGGER_FILE "ortc/event-trace/trigger-file"
+
+#define ORTC_EVENT_TRACE_MAX_VALUES 8
+#define ORTC_EVENT_TRACE_MAX_CAPTURE_PAYLOAD_BYTES 1500
+#define ORTC_EVENT_TRACE_MAX_TRIGGER_EVENT_IDS 16
+
+namespace ortc
+{
+  namespace internal
+  {
+    ZS_DECLARE_CLASS_PTR(EventTrace);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IEventTraceForORTC
+    #pragma mark
+
+    interaction IEventTraceForORTC
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IEventTraceForORTC, ForORTC)
+
+      // begins recording every ZS_EVENTING_* event into per-thread binary
+      // ring buffers (settings are read at start)
+      static void start();
+      static void stop();
+      static bool isTracing();
+
+      // writes the current ring contents as pcapng; events carrying a
+      // buffer become packets with the (truncated) payload and the event
+      // metadata in the packet comment
+      static bool save(const char *fileName);
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark EventTraceSettingsDefaults
+    #pragma mark
+
+    void installEventTraceSettingsDefaults();
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark EventTrace
+    #pragma mark
+
+    class EventTrace : public IEventTraceForORTC,
+                       public zsLib::ILogEventingDelegate
+    {
+    protected:
+      struct make_private {};
+
+    public:
+      friend interaction IEventTraceForORTC;
+
+      typedef Log::ProviderHandle ProviderHandle;
+      typedef Log::EventingAtomDataArray EventingAtomDataArray;
+      typedef Log::EventingAtomIndex EventingAtomIndex;
+      typedef Log::KeywordBitmaskType KeywordBitmaskType;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark EventTrace::Record
+      #pragma mark
+
+      // fixed-size slot header; the captured payload (if any) follows
+      // immediately after in the same slot
+      struct Record
+      {
+        ULONGLONG mTimestamp {};                            // steady clock, nanoseconds
+        PTRNUMBER mProvider {};
+        ULONGLONG mValues[ORTC_EVENT_TRACE_MAX_VALUES] {};  // scalar event parameters, in order
+        DWORD mOriginalPayloadSize {};
+        WORD mEventID {};
+        WORD mCapturedPayloadSize {};
+        BYTE mSeverity {};
+        BYTE mLevel {};
+        BYTE mTotalValues {};
+        BYTE mReserved {};
+      };
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark EventTrace::Ring
+      #pragma mark
+
+      // Single writer (the owning thread), any number of readers. The writer
+      // fills a slot then publishes it by advancing mHead; a reader copies
+      // slots and afterwards discards any that the writer may have lapped
+      // while they were being copied.
+      struct Ring
+      {
+        Ring(
+             size_t slotSize,
+             size_t totalSlots,
+             size_t threadIndex
+             );
+
+        BYTE *slot(ULONGLONG index) {return &(mBuffer[static_cast<size_t>(index % mTotalSlots) * mSlotSize]);}
+
+        std::vector<BYTE> mBuffer;
+        size_t mSlotSize {};
+        size_t mTotalSlots {};
+        size_t mThreadIndex {};
+        std::atomic<ULONGLONG> mHead {};
+      };
+
+      ZS_DECLARE_PTR(Ring)
+
+      typedef std::list<RingPtr> RingList;
+
+    public:
+      EventTrace(const make_private &);
+
+    protected:
+      void init();
+
+    public:
+      virtual ~EventTrace();
+
+      static EventTracePtr singleton();
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark EventTrace => IEventTraceForORTC
+      #pragma mark
+
+      void start();
+      void stop();
+      bool isTracing() const {return mTracing;}
+      bool save(const char *fileName);
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark EventTrace => ILogEventingDelegate
+      #pragma mark
+
+      virtual void notifyEventingProviderRegistered(
+                                                    ProviderHandle handle,
+                                                    EventingAtomDataArray eventingAtomDataArray
+                                                    ) override;
+
+      virtual void notifyWriteEvent(
+                                    ProviderHandle handle,
+                                    EventingAtomDataArray eventingAtomDataArray,
+                                    Log::Severity severity,
+                                    Log::Level level,
+                                    Log::EVENT_DESCRIPTOR_HANDLE descriptor,
+                                    Log::EVENT_PARAMETER_DESCRIPTOR_HANDLE paramDescriptor,
+                                    Log::EVENT_DATA_DESCRIPTOR_HANDLE dataDescriptor,
+                                    size_t dataDescriptorCount
+                                    ) override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark EventTrace => (internal)
+      #pragma mark
+
+      static Log::Params slog(const char *message);
+
+      Ring *getThreadRing();
+      bool isTrigger(
+                     Log::Severity severity,
+                     WORD eventID
+                     ) const;
+      void trigger();
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark EventTrace => (data)
+      #pragma mark
+
+      EventTraceWeakPtr mThisWeak;
+
+      Lock mLock;
+
+      std::atomic<bool> mTracing {false};
+      std::atomic<ULONG> mGeneration {};
+
+      EventingAtomIndex mEventingAtomIndex {};
+
+      RingList mRings;
+      size_t mNextThreadIndex {};
+
+      // fixed at start() so the write path reads them without locking
+      size_t mRingSizeInBytes {};
+      size_t mCapturePayloadBytes {};
+      size_t mSlotSize {};
+
+      bool mTriggerOnSeverity {false};
+      Log::Severity mTriggerSeverity {Log::Error};
+      WORD mTriggerEventIDs[ORTC_EVENT_TRACE_MAX_TRIGGER_EVENT_IDS] {};
+      size_t mTotalTriggerEventIDs {};
+      Milliseconds mTriggerDelay {};
+      String mTriggerFile;
+
+      std::atomic<bool> mTriggerPending {false};
+      std::atomic<ULONGLONG> mTotalTriggers {};
+    };
+  }
+}
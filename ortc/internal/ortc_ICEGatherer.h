@@ -36,6 +36,7 @@
 #include <ortc/IICEGatherer.h>
 
 #include <ortc/internal/ortc_ICEGathererRouter.h>
+#include <ortc/internal/ortc_ICEGathererUDPMux.h>
 
 #include <ortc/services/IBackOffTimer.h>
 #include <ortc/services/IDNS.h>
@@ -131,6 +132,7 @@ namespace ortc
       virtual IICEGathererSubscriptionPtr subscribe(IICEGathererDelegatePtr delegate) = 0;
 
       virtual bool isContinousGathering() const = 0;
+      virtual bool isICELite() const = 0;
       virtual String getUsernameFrag() const = 0;
       virtual String getPassword() const = 0;
 
@@ -148,9 +150,40 @@ namespace ortc
                               size_t bufferSizeInBytes
                               ) = 0;
 
+      virtual bool sendPackets(
+                               UseICETransport &transport,
+                               RouterRoutePtr routerRoute,
+                               const PacketBufferRefList &packets
+                               ) = 0;
+
       virtual void notifyLikelyReflexiveActivity(RouterRoutePtr routerRoute) = 0;
     };
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IICEGathererForICEGathererUDPMux
+    #pragma mark
+
+    interaction IICEGathererForICEGathererUDPMux
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IICEGathererForICEGathererUDPMux, ForUDPMux)
+      ZS_DECLARE_TYPEDEF_PTR(zsLib::Socket, Socket)
+
+      virtual PUID getID() const = 0;
+
+      // "socket" is always the socket returned from the mux's bind() even
+      // when the packet was received on another shard's socket
+      virtual void notifyUDPMuxPacket(
+                                      SocketPtr socket,
+                                      const IPAddress &fromIP,
+                                      const BYTE *buffer,
+                                      size_t bufferSizeInBytes
+                                      ) = 0;
+    };
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -183,6 +216,7 @@ namespace ortc
                         public SharedRecursiveLock,
                         public IICEGatherer,
                         public IICEGathererForICETransport,
+                        public IICEGathererForICEGathererUDPMux,
                         public IGathererAsyncDelegate,
                         public IWakeDelegate,
                         public IDNSDelegate,
@@ -201,6 +235,7 @@ namespace ortc
       friend interaction IICEGatherer;
       friend interaction IICEGathererFactory;
       friend interaction IICEGathererForICETransport;
+      friend interaction IICEGathererForICEGathererUDPMux;
 
       typedef IICEGatherer::States States;
 
@@ -261,6 +296,7 @@ namespace ortc
       ZS_DECLARE_TYPEDEF_PTR(ortc::services::ISTUNDiscovery, UseSTUNDiscovery)
       ZS_DECLARE_TYPEDEF_PTR(ortc::services::ITURNSocket, UseTURNSocket)
       ZS_DECLARE_TYPEDEF_PTR(ortc::services::IBackOffTimer, UseBackOffTimer)
+      ZS_DECLARE_TYPEDEF_PTR(IICEGathererUDPMuxForICEGatherer, UseUDPMux)
       ZS_DECLARE_TYPEDEF_PTR(zsLib::Socket, Socket)
       ZS_DECLARE_TYPEDEF_PTR(IICETypes::Candidate, Candidate)
       ZS_DECLARE_TYPEDEF_PTR(IICETypes::CandidateList, CandidateList)
@@ -411,6 +447,7 @@ namespace ortc
       // (duplicate) virtual CandidateListPtr getLocalCandidates() const = 0;
 
       virtual bool isContinousGathering() const override;
+      virtual bool isICELite() const override;
       virtual String getUsernameFrag() const override {return mUsernameFrag;}
       virtual String getPassword() const override {return mPassword;}
 
@@ -426,8 +463,28 @@ namespace ortc
                               size_t bufferSizeInBytes
                               ) override;
 
+      virtual bool sendPackets(
+                               UseICETransport &transport,
+                               RouterRoutePtr routerRoute,
+                               const PacketBufferRefList &packets
+                               ) override;
+
       virtual void notifyLikelyReflexiveActivity(RouterRoutePtr routerRoute) override;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGatherer => IICEGathererForICEGathererUDPMux
+      #pragma mark
+
+      // (duplicate) virtual PUID getID() const;
+
+      virtual void notifyUDPMuxPacket(
+                                      SocketPtr socket,
+                                      const IPAddress &fromIP,
+                                      const BYTE *buffer,
+                                      size_t bufferSizeInBytes
+                                      ) override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark ICEGatherer => IGathererAsyncDelegate
@@ -800,6 +857,8 @@ namespace ortc
         RelayPortPtr mRelayPort;  // send via relay port
         TCPPortPtr mTCPPort;      // send via TCP socket
 
+        bool mNotifiedUDPMux {};  // remote was associated with the shared UDP port
+
         void trace(const char *function, const char *message = NULL) const;
         ElementPtr toDebug() const;
       };
@@ -961,6 +1020,13 @@ namespace ortc
                 HostPortPtr hostPort,
                 SocketPtr socket
                 );
+      void handleUDPPacket(
+                           HostPortPtr hostPort,
+                           SocketPtr socket,
+                           const IPAddress &fromIP,
+                           const BYTE *buffer,
+                           size_t bufferSizeInBytes
+                           );
       void read(
                 HostPort &hostPort,
                 TCPPort &tcpPort
@@ -984,7 +1050,9 @@ namespace ortc
       SecureByteBlockPtr handleIncomingPacket(
                                               CandidatePtr localCandidate,
                                               const IPAddress &remoteIP,
-                                              STUNPacketPtr stunPacket
+                                              STUNPacketPtr stunPacket,
+                                              size_t packetSizeInBytes,
+                                              bool *outAuthenticated = NULL
                                               );
       void handleIncomingPacket(
                                 CandidatePtr localCandidate,
@@ -1019,6 +1087,13 @@ namespace ortc
                          const BYTE *buffer,
                          size_t bufferSizeInBytes
                          );
+      bool sendTCPPacket(
+                         UseICETransport &transport,
+                         RouterRoutePtr routerRoute,
+                         RoutePtr route,
+                         const BYTE *buffer,
+                         size_t bufferSizeInBytes
+                         );
 
       bool shouldKeepWarm() const;
       bool shouldWarmUpAfterInterfaceBinding() const;
@@ -1080,6 +1155,8 @@ namespace ortc
       IPToHostPortMap mHostPorts;
       SocketToHostPortMap mHostPortSockets;
 
+      UseUDPMuxPtr mUDPMux;
+
       STUNToReflexivePortMap mSTUNDiscoveries;
       TURNToRelayPortMap mTURNSockets;
       TURNToRelayPortMap mShutdownTURNSockets;
@@ -37,6 +37,7 @@
 
 #include <zsLib/ITimer.h>
 
+#include <atomic>
 #include <tuple>
 
 namespace ortc
@@ -130,6 +131,17 @@ namespace ortc
         CandidatePtr mLocalCandidate;
         IPAddress mRemoteIP;
 
+        // wire level counters (includes STUN traffic); updated by the
+        // gatherer without holding any lock and drained by the transport
+        // when it stops using the route
+        std::atomic<QWORD> mPacketsSent {};
+        std::atomic<QWORD> mBytesSent {};
+        std::atomic<QWORD> mPacketsReceived {};
+        std::atomic<QWORD> mBytesReceived {};
+
+        void notifySent(size_t bytes)       {mPacketsSent.fetch_add(1, std::memory_order_relaxed); mBytesSent.fetch_add(bytes, std::memory_order_relaxed);}
+        void notifyReceived(size_t bytes)   {mPacketsReceived.fetch_add(1, std::memory_order_relaxed); mBytesReceived.fetch_add(bytes, std::memory_order_relaxed);}
+
         void trace(const char *function, const char *message = NULL) const;
         ElementPtr toDebug() const;
       };
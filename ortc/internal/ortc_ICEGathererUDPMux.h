@@ -0,0 +1,312 @@
+/*
+
+ Copyright (c) 2016, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#pragma once
+
+#include <ortc/internal/types.h>
+
+#include <ortc/services/STUNPacket.h>
+
+#include <zsLib/MessageQueueAssociator.h>
+#include <zsLib/Singleton.h>
+#include <zsLib/Socket.h>
+
+#include <set>
+#include <vector>
+
+#define ORTC_SETTING_GATHERER_UDP_MUX_PORT "ortc/gatherer/udp-mux-port"                    // 0 = each gatherer binds its own UDP sockets (non zero disables server reflexive and relay gathering)
+#define ORTC_SETTING_GATHERER_UDP_MUX_TOTAL_SHARDS "ortc/gatherer/udp-mux-total-shards"    // >1 requires SO_REUSEPORT support
+#define ORTC_SETTING_GATHERER_UDP_MUX_REMOTE_IDLE_TIMEOUT_IN_SECONDS "ortc/gatherer/udp-mux-remote-idle-timeout-in-seconds" // remotes not heard from in this time must be authenticated again
+
+namespace ortc
+{
+  namespace internal
+  {
+    ZS_DECLARE_CLASS_PTR(ICEGathererUDPMux);
+
+    ZS_DECLARE_INTERACTION_PTR(IICEGathererForICEGathererUDPMux);
+    ZS_DECLARE_INTERACTION_PTR(IICEGathererUDPMuxForICEGatherer);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IICEGathererUDPMuxForICEGatherer
+    #pragma mark
+
+    interaction IICEGathererUDPMuxForICEGatherer
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IICEGathererUDPMuxForICEGatherer, ForICEGatherer)
+      ZS_DECLARE_TYPEDEF_PTR(IICEGathererForICEGathererUDPMux, UseICEGatherer)
+      ZS_DECLARE_TYPEDEF_PTR(zsLib::Socket, Socket)
+
+      static ElementPtr toDebug(ForICEGathererPtr mux);
+
+      // returns null when the shared UDP port is not enabled
+      static ForICEGathererPtr singleton();
+
+      virtual PUID getID() const = 0;
+
+      virtual void registerGatherer(
+                                    UseICEGathererPtr gatherer,
+                                    const String &localUsernameFrag
+                                    ) = 0;
+      virtual void unregisterGatherer(PUID gathererID) = 0;
+
+      // binds (or shares an already bound) socket on the mux port for the
+      // interface IP; the resulting port is filled into "ioBindIP"
+      virtual SocketPtr bind(IPAddress &ioBindIP) = 0;
+      virtual void unbind(const IPAddress &boundIP) = 0;
+
+      // associates (or moves) a remote address to the gatherer so packets
+      // from the remote are delivered without requiring a STUN USERNAME;
+      // only call once the remote is authenticated, i.e. a STUN request
+      // from it passed MESSAGE-INTEGRITY or an ICE transport chose it
+      virtual void notifyRemote(
+                                PUID gathererID,
+                                const IPAddress &boundIP,
+                                const IPAddress &remoteIP
+                                ) = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererUDPMux
+    #pragma mark
+
+    class ICEGathererUDPMux : public Noop,
+                              public SharedRecursiveLock,
+                              public IICEGathererUDPMuxForICEGatherer,
+                              public ISingletonManagerDelegate
+    {
+    protected:
+      struct make_private {};
+
+    public:
+      friend interaction IICEGathererUDPMuxForICEGatherer;
+
+      ZS_DECLARE_CLASS_PTR(Shard)
+      ZS_DECLARE_STRUCT_PTR(Listener)
+      ZS_DECLARE_STRUCT_PTR(GathererInfo)
+      ZS_DECLARE_STRUCT_PTR(RemoteInfo)
+
+      typedef std::pair<IPAddress, IPAddress> LocalRemotePair;
+
+      typedef std::map<PUID, GathererInfoPtr> GathererMap;
+      typedef std::map<String, GathererInfoPtr> UsernameFragMap;
+      typedef std::map<LocalRemotePair, RemoteInfoPtr> RemoteMap;
+      typedef std::set<LocalRemotePair> LocalRemotePairSet;
+
+      typedef std::vector<ShardPtr> ShardList;
+      typedef std::vector<SocketPtr> SocketList;
+
+      typedef std::map<IPAddress, ListenerPtr> ListenerMap;
+      typedef std::map<SocketPtr, ListenerPtr> SocketToListenerMap;
+
+      //-----------------------------------------------------------------------
+      // Each shard owns a packet thread queue; with SO_REUSEPORT each shard
+      // has its own socket on the shared port so the kernel spreads inbound
+      // datagrams across the packet threads.
+      class Shard : public MessageQueueAssociator,
+                    public zsLib::ISocketDelegate
+      {
+      public:
+        Shard(
+              IMessageQueuePtr queue,
+              ICEGathererUDPMuxPtr outer,
+              size_t index
+              );
+
+        size_t index() const {return mIndex;}
+
+        virtual void onReadReady(SocketPtr socket) override;
+        virtual void onWriteReady(SocketPtr socket) override;
+        virtual void onException(SocketPtr socket) override;
+
+      protected:
+        ICEGathererUDPMuxWeakPtr mOuter;
+        size_t mIndex {};
+      };
+
+      //-----------------------------------------------------------------------
+      struct Listener
+      {
+        IPAddress mBoundIP;
+        SocketList mSockets;          // one per shard
+        size_t mTotalBindings {};
+
+        ElementPtr toDebug() const;
+      };
+
+      //-----------------------------------------------------------------------
+      struct GathererInfo
+      {
+        PUID mGathererID {};
+        UseICEGathererWeakPtr mGatherer;
+        String mUsernameFrag;
+        LocalRemotePairSet mRemotes;
+
+        ElementPtr toDebug() const;
+      };
+
+      //-----------------------------------------------------------------------
+      struct RemoteInfo
+      {
+        GathererInfoPtr mGathererInfo;
+        Time mLastActivity;
+      };
+
+    public:
+      ICEGathererUDPMux(
+                        const make_private &,
+                        WORD port,
+                        size_t totalShards
+                        );
+
+    protected:
+      ICEGathererUDPMux(Noop) :
+        Noop(true),
+        SharedRecursiveLock(SharedRecursiveLock::create())
+      {}
+
+      void init();
+
+      static ICEGathererUDPMuxPtr create();
+
+    public:
+      virtual ~ICEGathererUDPMux();
+
+      static ICEGathererUDPMuxPtr convert(ForICEGathererPtr object);
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGathererUDPMux => IICEGathererUDPMuxForICEGatherer
+      #pragma mark
+
+      static ICEGathererUDPMuxPtr singleton();
+
+      virtual PUID getID() const override {return mID;}
+
+      virtual void registerGatherer(
+                                    UseICEGathererPtr gatherer,
+                                    const String &localUsernameFrag
+                                    ) override;
+      virtual void unregisterGatherer(PUID gathererID) override;
+
+      virtual SocketPtr bind(IPAddress &ioBindIP) override;
+      virtual void unbind(const IPAddress &boundIP) override;
+
+      virtual void notifyRemote(
+                                PUID gathererID,
+                                const IPAddress &boundIP,
+                                const IPAddress &remoteIP
+                                ) override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGathererUDPMux => ISingletonManagerDelegate
+      #pragma mark
+
+      virtual void notifySingletonCleanup() override;
+
+    public:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGathererUDPMux => friend Shard
+      #pragma mark
+
+      bool read(SocketPtr socket);
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGathererUDPMux => (internal)
+      #pragma mark
+
+      Log::Params log(const char *message) const;
+      static Log::Params slog(const char *message);
+      Log::Params debug(const char *message) const;
+      virtual ElementPtr toDebug() const;
+
+      void cancel();
+
+      // packets from a remote already associated with a gatherer are routed
+      // to that gatherer except STUN requests which are always routed by
+      // USERNAME (the gatherer validates MESSAGE-INTEGRITY and confirms the
+      // remote via notifyRemote)
+      UseICEGathererPtr route(
+                              const IPAddress &boundIP,
+                              const IPAddress &fromIP,
+                              const BYTE *buffer,
+                              size_t bufferSizeInBytes
+                              );
+
+      void expireIdleRemotes(Time now);
+      void removeRemote(RemoteMap::iterator found);
+
+      SocketPtr createSocket(
+                             const IPAddress &bindIP,
+                             ShardPtr shard
+                             );
+      void close(ListenerPtr listener);
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGathererUDPMux => (data)
+      #pragma mark
+
+      AutoPUID mID;
+      ICEGathererUDPMuxWeakPtr mThisWeak;
+
+      WORD mPort {};
+      ShardList mShards;
+
+      ListenerMap mListeners;
+      SocketToListenerMap mSocketListeners;
+
+      GathererMap mGatherers;
+      UsernameFragMap mUsernameFrags;
+      RemoteMap mRemotes;
+
+      Seconds mRemoteIdleTimeout {};
+      Time mLastIdleSweep;
+
+      STUNPacket::ParseOptions mSTUNPacketParseOptions;
+    };
+  }
+}
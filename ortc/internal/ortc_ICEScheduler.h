@@ -0,0 +1,331 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#pragma once
+
+#include <ortc/internal/types.h>
+
+#include <zsLib/MessageQueueAssociator.h>
+#include <zsLib/ITimer.h>
+#include <zsLib/Singleton.h>
+
+#include <vector>
+
+#define ORTC_SETTING_ICE_SCHEDULER_TICK_IN_MILLISECONDS "ortc/ice-scheduler/tick-in-milliseconds"
+
+namespace ortc
+{
+  namespace internal
+  {
+    ZS_DECLARE_CLASS_PTR(ICEScheduler);
+    ZS_DECLARE_CLASS_PTR(ICESchedulerTimer);
+
+    ZS_DECLARE_INTERACTION_PTR(IICESchedulerForICETransport);
+
+    ZS_DECLARE_INTERACTION_PROXY(IICESchedulerDelegate);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IICESchedulerDelegate
+    #pragma mark
+
+    interaction IICESchedulerDelegate
+    {
+      typedef std::list<PUID> TimerIDList;
+      ZS_DECLARE_PTR(TimerIDList);
+
+      // all timers of the same owner that expired on the same tick are
+      // delivered together
+      virtual void onICESchedulerTimersFired(TimerIDListPtr timers) = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IICESchedulerForICETransport
+    #pragma mark
+
+    interaction IICESchedulerForICETransport
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IICESchedulerForICETransport, ForICETransport);
+
+      // schedules a one shot timer some time within [earliest, earliest + window];
+      // the exact tick is picked to spread timers evenly across the window;
+      // returns null if the scheduler is gone (i.e. during shutdown)
+      static ICESchedulerTimerPtr schedule(
+                                           PUID ownerID,
+                                           IICESchedulerDelegatePtr delegate,
+                                           const Time &earliest,
+                                           Milliseconds window
+                                           );
+
+      virtual ~IICESchedulerForICETransport() {}
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICESchedulerTimer
+    #pragma mark
+
+    class ICESchedulerTimer
+    {
+    public:
+      friend class ICEScheduler;
+
+      typedef std::list<ICESchedulerTimerPtr> TimerList;
+
+    public:
+      ICESchedulerTimer(
+                        ICESchedulerPtr scheduler,
+                        PUID ownerID,
+                        IICESchedulerDelegatePtr delegate
+                        );
+
+      PUID getID() const                          {return mID;}
+
+      void cancel();
+
+    protected:
+      AutoPUID mID;
+      ICESchedulerWeakPtr mScheduler;
+      PUID mOwnerID {};
+      IICESchedulerDelegatePtr mDelegate;
+
+      // only accessed while holding the scheduler lock
+      QWORD mExpiryTick {};
+      TimerList *mSlot {};
+      TimerList::iterator mPosition;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEScheduler
+    #pragma mark
+
+    // Shared hierarchical timer wheel for the per route ICE consent and keep
+    // warm timers so that thousands of routes do not each need an ITimer.
+    // Insert and cancel are O(1); a single periodic timer drives the wheel
+    // while any timer is scheduled.
+    class ICEScheduler : public Noop,
+                         public MessageQueueAssociator,
+                         public SharedRecursiveLock,
+                         public IICESchedulerForICETransport,
+                         public zsLib::ITimerDelegate,
+                         public ISingletonManagerDelegate
+    {
+    protected:
+      struct make_private {};
+
+    public:
+      friend interaction IICESchedulerForICETransport;
+      friend interaction IICESchedulerFactory;
+      friend class ICESchedulerTimer;
+
+      typedef ICESchedulerTimer::TimerList TimerList;
+      typedef std::vector<TimerList> SlotVector;
+
+      typedef IICESchedulerDelegate::TimerIDList TimerIDList;
+      typedef IICESchedulerDelegate::TimerIDListPtr TimerIDListPtr;
+
+      struct FiredBatch
+      {
+        IICESchedulerDelegatePtr mDelegate;
+        TimerIDListPtr mTimers;
+      };
+      typedef std::map<PUID, FiredBatch> FiredBatchMap;
+
+      enum Wheels
+      {
+        Wheel_First,
+
+        Wheel_Level0 = Wheel_First,
+        Wheel_Level1,
+        Wheel_Level2,
+
+        Wheel_Last = Wheel_Level2,
+      };
+
+      static const size_t kLevel0Bits {8};        // 256 ticks
+      static const size_t kLevelNBits {6};        // 64 slots on each higher level
+
+    public:
+      ICEScheduler(
+                   const make_private &,
+                   IMessageQueuePtr queue
+                   );
+
+    protected:
+      ICEScheduler(Noop) :
+        Noop(true),
+        MessageQueueAssociator(IMessageQueuePtr()),
+        SharedRecursiveLock(SharedRecursiveLock::create())
+      {}
+
+      void init();
+
+      static ICESchedulerPtr create();
+      static ICESchedulerPtr singleton();
+
+    public:
+      virtual ~ICEScheduler();
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEScheduler => IICESchedulerForICETransport
+      #pragma mark
+
+      static ICESchedulerTimerPtr schedule(
+                                           PUID ownerID,
+                                           IICESchedulerDelegatePtr delegate,
+                                           const Time &earliest,
+                                           Milliseconds window
+                                           );
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEScheduler => ITimerDelegate
+      #pragma mark
+
+      virtual void onTimer(ITimerPtr timer) override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEScheduler => ISingletonManagerDelegate
+      #pragma mark
+
+      virtual void notifySingletonCleanup() override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEScheduler => friend ICESchedulerTimer
+      #pragma mark
+
+      void cancel(ICESchedulerTimer &timer);
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEScheduler => (internal)
+      #pragma mark
+
+      Log::Params log(const char *message) const;
+      static Log::Params slog(const char *message);
+      Log::Params debug(const char *message) const;
+      virtual ElementPtr toDebug() const;
+
+      void cancel();
+
+      QWORD toTick(const Time &time) const;
+
+      ICESchedulerTimerPtr scheduleAt(
+                                      PUID ownerID,
+                                      IICESchedulerDelegatePtr delegate,
+                                      QWORD expiryTick
+                                      );
+      QWORD pickTick(
+                     QWORD earliestTick,
+                     QWORD windowTicks
+                     ) const;
+
+      void insert(ICESchedulerTimerPtr timer);
+      void cascade(
+                   Wheels wheel,
+                   size_t slot
+                   );
+      void advance(FiredBatchMap &ioFired);
+
+      void startTicking();
+      void stopTicking();
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEScheduler => (data)
+      #pragma mark
+
+      AutoPUID mID;
+      ICESchedulerWeakPtr mThisWeak;
+
+      Milliseconds mTickDuration {};
+      Time mStarted;
+      QWORD mCurrentTick {};
+
+      SlotVector mWheels[Wheel_Last + 1];
+      size_t mTotalScheduled {};
+
+      ITimerPtr mTickTimer;
+
+      size_t mTotalFired {};
+      size_t mTotalBatches {};
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IICESchedulerFactory
+    #pragma mark
+
+    interaction IICESchedulerFactory
+    {
+      static IICESchedulerFactory &singleton();
+
+      virtual ICESchedulerPtr create();
+
+      virtual ICESchedulerTimerPtr schedule(
+                                            PUID ownerID,
+                                            IICESchedulerDelegatePtr delegate,
+                                            const Time &earliest,
+                                            Milliseconds window
+                                            );
+    };
+
+    class ICESchedulerFactory : public IFactory<IICESchedulerFactory> {};
+  }
+}
+
+ZS_DECLARE_PROXY_BEGIN(ortc::internal::IICESchedulerDelegate)
+ZS_DECLARE_PROXY_TYPEDEF(ortc::internal::IICESchedulerDelegate::TimerIDListPtr, TimerIDListPtr)
+ZS_DECLARE_PROXY_METHOD_1(onICESchedulerTimersFired, TimerIDListPtr)
+ZS_DECLARE_PROXY_END()
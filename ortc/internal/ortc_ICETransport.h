@@ -34,6 +34,7 @@
 #include <ortc/internal/types.h>
 
 #include <ortc/internal/ortc_ICEGathererRouter.h>
+#include <ortc/internal/ortc_ICEScheduler.h>
 
 #include <ortc/IICETransport.h>
 #include <ortc/IICEGatherer.h>
@@ -178,6 +179,8 @@ namespace ortc
                               const BYTE *buffer,
                               size_t bufferSizeInBytes
                               ) = 0;
+
+      virtual bool sendPackets(const PacketBufferRefList &packets) = 0;
     };
     
     //-------------------------------------------------------------------------
@@ -209,7 +212,10 @@ namespace ortc
 
     interaction IICETransportAsyncDelegate
     {
-      virtual void onResolveStatsPromise(IStatsProvider::PromiseWithStatsReportPtr promise) = 0;
+      virtual void onResolveStatsPromise(
+                                         IStatsProvider::PromiseWithStatsReportPtr promise,
+                                         IStatsReportTypes::StatsTypeSet stats
+                                         ) = 0;
       virtual void onNotifyPacketRetried(
                                          IICETypes::CandidatePtr localCandidate,
                                          IPAddress remoteIP,
@@ -242,6 +248,7 @@ namespace ortc
                          public IICETransportAsyncDelegate,
                          public IWakeDelegate,
                          public zsLib::ITimerDelegate,
+                         public IICESchedulerDelegate,
                          public zsLib::IPromiseSettledDelegate,
                          public IICEGathererDelegate,
                          public ortc::services::ISTUNRequesterDelegate
@@ -264,6 +271,7 @@ namespace ortc
       ZS_DECLARE_TYPEDEF_PTR(ortc::services::ISTUNRequester, ISTUNRequester)
       ZS_DECLARE_TYPEDEF_PTR(IICEGathererForICETransport, UseICEGatherer)
       ZS_DECLARE_TYPEDEF_PTR(IICETransportControllerForICETransport, UseICETransportController)
+      ZS_DECLARE_TYPEDEF_PTR(IICESchedulerForICETransport, UseICEScheduler)
       ZS_DECLARE_TYPEDEF_PTR(IICETypes::Candidate, Candidate)
       ZS_DECLARE_TYPEDEF_PTR(IICETypes::CandidateComplete, CandidateComplete)
       ZS_DECLARE_TYPEDEF_PTR(IICETypes::CandidateList, CandidateList)
@@ -281,7 +289,7 @@ namespace ortc
 
       typedef std::map<RouteID, RoutePtr> RouteIDMap;
       typedef std::map<ISTUNRequesterPtr, RoutePtr> STUNCheckMap;
-      typedef std::map<ITimerPtr, RoutePtr> TimerRouteMap;
+      typedef std::map<PUID, RoutePtr> TimerRouteMap;
       typedef std::map<PromisePtr, RoutePtr> PromiseRouteMap;
 
       typedef std::list<PromisePtr> PromiseList;
@@ -451,6 +459,8 @@ namespace ortc
                               size_t bufferSizeInBytes
                               ) override;
 
+      virtual bool sendPackets(const PacketBufferRefList &packets) override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark ICETransport => IICETransportForDataTransport
@@ -467,7 +477,10 @@ namespace ortc
       #pragma mark ICETransport => IICETransportAsyncDelegate
       #pragma mark
 
-      virtual void onResolveStatsPromise(IStatsProvider::PromiseWithStatsReportPtr promise) override;
+      virtual void onResolveStatsPromise(
+                                         IStatsProvider::PromiseWithStatsReportPtr promise,
+                                         IStatsReportTypes::StatsTypeSet stats
+                                         ) override;
       virtual void onNotifyPacketRetried(
                                          IICETypes::CandidatePtr localCandidate,
                                          IPAddress remoteIP,
@@ -494,6 +507,13 @@ namespace ortc
 
       virtual void onTimer(ITimerPtr timer) override;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICETransport => IICESchedulerDelegate
+      #pragma mark
+
+      virtual void onICESchedulerTimersFired(TimerIDListPtr timers) override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark ICETransport => IPromiseSettledDelegate
@@ -596,13 +616,26 @@ namespace ortc
         bool mPrune {false};
         bool mKeepWarm {false};
         ISTUNRequesterPtr mOutgoingCheck;
-        ITimerPtr mNextKeepWarm;
+        ICESchedulerTimerPtr mNextKeepWarm;
 
         PromisePtr mFrozenPromise;
         PromiseList mDependentPromises;
 
         Time mLastRoundTripCheck;
         Microseconds mLastRoundTripMeasurement {};
+        Microseconds mCurrentRoundTripTime {};
+
+        QWORD mRequestsSent {};
+        QWORD mRequestsReceived {};
+        QWORD mResponsesSent {};
+        QWORD mResponsesReceived {};
+        QWORD mConsentRequestsSent {};
+
+        // totals carried over from gatherer routes that were removed
+        QWORD mPreviousPacketsSent {};
+        QWORD mPreviousBytesSent {};
+        QWORD mPreviousPacketsReceived {};
+        QWORD mPreviousBytesReceived {};
 
         Route(RouteStateTrackerPtr tracker);
         ~Route();
@@ -618,6 +651,11 @@ namespace ortc
         States state() const;
         void state(States state);
 
+        QWORD packetsSent() const;
+        QWORD bytesSent() const;
+        QWORD packetsReceived() const;
+        QWORD bytesReceived() const;
+
         bool isNew() const {return State_New == mState;}
         bool isPending() const {return State_Pending == mState;}
         bool isFrozen() const {return State_Frozen == mState;}
@@ -674,9 +712,11 @@ namespace ortc
       bool isShuttingDown() const;
       bool isShutdown() const;
       bool isContinousGathering() const;
+      bool isLocalICELite() const;
 
       void step();
       bool stepCalculateLegalPairs();
+      bool stepICELite();
       bool stepPendingActivation();
       bool stepActivationTimer();
       bool stepPickRoute();
@@ -700,6 +740,10 @@ namespace ortc
       void handleLastReceivedPacket();
       void handleActivationTimer();
       void handleNextKeepWarmTimer(RoutePtr route);
+      void installKeepWarmTimer(
+                                RoutePtr route,
+                                Milliseconds minimumDelay
+                                );
 
       void forceActive(RoutePtr route);
       void shutdown(RoutePtr route);
@@ -911,10 +955,11 @@ namespace ortc
 
 ZS_DECLARE_PROXY_BEGIN(ortc::internal::IICETransportAsyncDelegate)
 ZS_DECLARE_PROXY_TYPEDEF(ortc::IStatsProvider::PromiseWithStatsReportPtr, PromiseWithStatsReportPtr)
+ZS_DECLARE_PROXY_TYPEDEF(ortc::IStatsReportTypes::StatsTypeSet, StatsTypeSet)
 ZS_DECLARE_PROXY_TYPEDEF(ortc::IICETypes::CandidatePtr, CandidatePtr)
 ZS_DECLARE_PROXY_TYPEDEF(zsLib::IPAddress, IPAddress)
 ZS_DECLARE_PROXY_TYPEDEF(ortc::services::STUNPacketPtr, STUNPacketPtr)
-ZS_DECLARE_PROXY_METHOD_1(onResolveStatsPromise, PromiseWithStatsReportPtr)
+ZS_DECLARE_PROXY_METHOD_2(onResolveStatsPromise, PromiseWithStatsReportPtr, StatsTypeSet)
 ZS_DECLARE_PROXY_METHOD_3(onNotifyPacketRetried, CandidatePtr, IPAddress, STUNPacketPtr)
 ZS_DECLARE_PROXY_METHOD_0(onWarmRoutesChanged)
 ZS_DECLARE_PROXY_METHOD_1(onNotifyAttached, PUID)
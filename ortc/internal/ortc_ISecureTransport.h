@@ -209,6 +209,12 @@ namespace ortc
                                        size_t bufferLengthInBytes
                                        ) = 0;
 
+      virtual bool sendEncryptedPackets(
+                                        IICETypes::Components sendOverICETransport,
+                                        IICETypes::Components packetType,
+                                        const PacketBufferRefList &packets
+                                        ) = 0;
+
       virtual bool handleReceivedDecryptedPacket(
                                                  IICETypes::Components viaTransport,
                                                  IICETypes::Components packetType,
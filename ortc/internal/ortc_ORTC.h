@@ -39,6 +39,8 @@
 #define ORTC_QUEUE_CERTIFICATE_GENERATION_NAME "org.ortc.ortcLibCertificateGeneration"
 #define ORTC_QUEUE_PACKET_THREAD_NAME "org.ortc.ortcLibPacketThread."
 #define ORTC_QUEUE_TOTAL_PACKET_THREADS 4
+#define ORTC_QUEUE_DTLS_HANDSHAKE_THREAD_NAME "org.ortc.ortcLibDTLSHandshakeThread."
+#define ORTC_QUEUE_TOTAL_DTLS_HANDSHAKE_THREADS 2
 
 namespace ortc
 {
@@ -62,6 +64,7 @@ namespace ortc
       static IMessageQueuePtr queuePacket();
       static IMessageQueuePtr queueBlockingMediaStartStopThread();
       static IMessageQueuePtr queueCertificateGeneration();
+      static IMessageQueuePtr queueDTLSHandshake();
 
       static Optional<Log::Level> webrtcLogLevel();
     };
@@ -124,6 +127,11 @@ namespace ortc
       virtual bool saveMediaTrace(String filename);
       virtual bool saveMediaTrace(String host, int port);
 
+      virtual void startEventTracing();
+      virtual void stopEventTracing();
+      virtual bool isEventTracing();
+      virtual bool saveEventTrace(String filename);
+
       //---------------------------------------------------------------------
       #pragma mark
       #pragma mark ORTC => IORTCForInternal
@@ -135,6 +143,7 @@ namespace ortc
       virtual IMessageQueuePtr queuePacket() const;
       virtual IMessageQueuePtr queueBlockingMediaStartStopThread() const;
       virtual IMessageQueuePtr queueCertificateGeneration() const;
+      virtual IMessageQueuePtr queueDTLSHandshake() const;
 
       virtual Optional<Log::Level> webrtcLogLevel() const;
 
@@ -164,6 +173,9 @@ namespace ortc
       mutable IMessageQueuePtr mPacketQueues[ORTC_QUEUE_TOTAL_PACKET_THREADS];
       mutable size_t mNextPacketQueueThread {};
 
+      mutable IMessageQueuePtr mDTLSHandshakeQueues[ORTC_QUEUE_TOTAL_DTLS_HANDSHAKE_THREADS];
+      mutable size_t mNextDTLSHandshakeQueueThread {};
+
       Milliseconds mNTPServerTime {};
 
       Optional<Log::Level> mDefaultWebRTCLogLevel{};
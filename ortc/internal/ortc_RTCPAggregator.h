@@ -0,0 +1,149 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#pragma once
+
+#include <ortc/internal/types.h>
+
+#include <ortc/internal/ortc_RTCPPacket.h>
+
+namespace ortc
+{
+  namespace internal
+  {
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTCPAggregator
+    #pragma mark
+
+    // Collects the RTCP compound packets produced by every channel sharing a
+    // secure transport and re-emits them as MTU-packed compound packets
+    // (SR/RR first, then SDES, other reports and finally BYE) so that fewer
+    // datagrams need to be SRTCP protected and sent. SR/RR are only held
+    // for a short bounded time (their timing values would go stale) so the
+    // reports of channels that fire together still share a packet.
+    //
+    // NOTE: Not thread safe; the owner must serialize access.
+    class RTCPAggregator
+    {
+    protected:
+      struct make_private {};
+
+    public:
+      ZS_DECLARE_STRUCT_PTR(Settings);
+      ZS_DECLARE_STRUCT_PTR(QueuedPacket);
+
+      typedef std::list<SecureByteBlockPtr> BufferList;
+      typedef std::list<QueuedPacketPtr> QueuedPacketList;
+
+      struct Settings
+      {
+        size_t mMaxPacketSize {1200};
+        Milliseconds mMaxDelay {20};
+        Milliseconds mMaxTimingReportDelay {5};     // upper bound on holding SR/RR (0 = flush at once)
+        Milliseconds mMaxBandwidthDelay {1000};
+        ULONG mBandwidthPercentage {5};             // RTCP share of the RTP bandwidth sent over the same transport
+        size_t mMinBandwidthBytesPerSecond {1000};
+
+        ElementPtr toDebug() const;
+      };
+
+      struct QueuedPacket
+      {
+        RTCPPacketPtr mPacket;
+        Time mQueued;
+        bool mUrgent {};
+        bool mTimingReport {};                      // holds a SR/RR
+        DWORD mSupersedeSSRC {};                    // only set for packets holding nothing but SR/RR/SDES
+      };
+
+    public:
+      RTCPAggregator(
+                     const make_private &,
+                     const Settings &settings
+                     );
+
+      static RTCPAggregatorPtr create(const Settings &settings);
+
+      // returns false if the packet cannot be aggregated (and must be sent
+      // as is but only after any pending packets are flushed); outFlushNow
+      // is set when the queue must be flushed right away
+      bool queue(
+                 const BYTE *buffer,
+                 size_t bufferLengthInBytes,
+                 const Time &now,
+                 bool &outFlushNow
+                 );
+
+      void notifyRTPSent(
+                         size_t bufferLengthInBytes,
+                         const Time &now
+                         );
+
+      bool hasPending() const                     {return mPending.size() > 0;}
+      Time nextFlush(const Time &now) const;
+
+      void flush(
+                 const Time &now,
+                 BufferList &outBuffers
+                 );
+
+      static SecureByteBlockPtr buildCompoundPacket(const QueuedPacketList &packets);
+
+      ElementPtr toDebug() const;
+
+    protected:
+      void updateCredit(const Time &now);
+      double allowedBytesPerSecond() const;
+      size_t pendingSize() const;
+
+    protected:
+      Settings mSettings;
+
+      QueuedPacketList mPending;
+
+      Time mLastRTPRateUpdate;
+      size_t mRTPBytesSinceUpdate {};
+      double mRTPBytesPerSecond {};
+
+      Time mLastCreditUpdate;
+      double mCredit {};
+
+      size_t mTotalQueued {};
+      size_t mTotalSuperseded {};
+      size_t mTotalSent {};
+    };
+
+  }
+}
@@ -0,0 +1,122 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#pragma once
+
+#include <ortc/internal/types.h>
+
+#include <ortc/IRTPReceiver.h>
+
+#include <atomic>
+
+namespace ortc
+{
+  namespace internal
+  {
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPContributingSourceTable
+    #pragma mark
+
+    // Fixed capacity open addressing table of the contributing sources seen
+    // by a receiver. Each entry is updated with atomics so the table can be
+    // read from any thread without holding the receiver lock. Once all the
+    // entries are active a new source evicts the least recently updated one.
+    //
+    // NOTE: update(), expire() and clear() must be serialized by the owner;
+    //       getSources() and activeCount() are safe from any thread.
+    class RTPContributingSourceTable
+    {
+    public:
+      typedef IRTPTypes::SSRCType SSRCType;
+      typedef IRTPReceiverTypes::ContributingSource ContributingSource;
+      typedef IRTPReceiverTypes::ContributingSourceList ContributingSourceList;
+
+      static const size_t kCapacity {64};         // must be a power of 2
+
+      struct Entry
+      {
+        std::atomic<DWORD> mGeneration {};        // odd while the entry is being assigned to a different csrc
+        std::atomic<DWORD> mCSRC {};
+        std::atomic<QWORD> mState {};             // 0 when not active, otherwise packed timestamp/level/voice activity
+        bool mUsed {};                            // only accessed by the writer
+      };
+
+    public:
+      RTPContributingSourceTable();
+
+      // returns true if the source was not active before this update (even
+      // when another source had to be evicted to make room for it)
+      bool update(
+                  SSRCType csrc,
+                  const Time &now,
+                  BYTE level,
+                  const Optional<bool> &voiceActivityFlag
+                  );
+
+      void expire(
+                  const Time &olderThan,
+                  ContributingSourceList &outExpired
+                  );
+
+      void clear();
+
+      void getSources(ContributingSourceList &outSources) const;
+
+      size_t activeCount() const                  {return mActive;}
+
+      ElementPtr toDebug() const;
+
+    protected:
+      static size_t hashIndex(SSRCType csrc);
+
+      static QWORD pack(
+                        const Time &timestamp,
+                        BYTE level,
+                        const Optional<bool> &voiceActivityFlag
+                        );
+      static void unpack(
+                         QWORD state,
+                         ContributingSource &outSource
+                         );
+
+    protected:
+      Entry mEntries[kCapacity];
+
+      std::atomic<size_t> mActive {};
+      size_t mTotalEvicted {};
+    };
+
+  }
+}
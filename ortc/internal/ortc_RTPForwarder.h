@@ -0,0 +1,309 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#pragma once
+
+#include <ortc/internal/types.h>
+
+#include <ortc/IRTPForwarder.h>
+
+#include <zsLib/MessageQueueAssociator.h>
+
+#define ORTC_SETTING_RTP_FORWARDER_SWITCH_SOURCE_AFTER_IDLE_IN_MILLISECONDS "ortc/rtp-forwarder/switch-source-after-idle-in-milliseconds"
+
+namespace ortc
+{
+  namespace internal
+  {
+    ZS_DECLARE_INTERACTION_PTR(IRTPForwarderForRTPReceiver);
+    ZS_DECLARE_INTERACTION_PTR(IRTPForwarderForRTPSender);
+
+    ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForRTPForwarder);
+    ZS_DECLARE_INTERACTION_PTR(IRTPSenderForRTPForwarder);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPForwarderForRTPReceiver
+    #pragma mark
+
+    interaction IRTPForwarderForRTPReceiver
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IRTPForwarderForRTPReceiver, ForRTPReceiver)
+
+      static ElementPtr toDebug(ForRTPReceiverPtr forwarder);
+
+      virtual PUID getID() const = 0;
+
+      virtual bool forwardPacket(RTPPacketPtr packet) = 0;
+      virtual void forwardPacket(RTCPPacketPtr packet) = 0;
+
+      virtual void notifyParametersChanged() = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPForwarderForRTPSender
+    #pragma mark
+
+    interaction IRTPForwarderForRTPSender
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IRTPForwarderForRTPSender, ForRTPSender)
+
+      static ElementPtr toDebug(ForRTPSenderPtr forwarder);
+
+      virtual PUID getID() const = 0;
+
+      virtual bool handleFeedback(RTCPPacketPtr packet) = 0;
+
+      virtual void notifyParametersChanged() = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPForwarder
+    #pragma mark
+    
+    class RTPForwarder : public Noop,
+                         public MessageQueueAssociator,
+                         public SharedRecursiveLock,
+                         public IRTPForwarder,
+                         public IRTPForwarderForRTPReceiver,
+                         public IRTPForwarderForRTPSender,
+                         public IWakeDelegate
+    {
+    protected:
+      struct make_private {};
+
+    public:
+      friend interaction IRTPForwarder;
+      friend interaction IRTPForwarderFactory;
+      friend interaction IRTPForwarderForRTPReceiver;
+      friend interaction IRTPForwarderForRTPSender;
+
+      ZS_DECLARE_TYPEDEF_PTR(IRTPReceiverForRTPForwarder, UseRTPReceiver)
+      ZS_DECLARE_TYPEDEF_PTR(IRTPSenderForRTPForwarder, UseRTPSender)
+
+      typedef IRTPTypes::PayloadType PayloadType;
+      typedef BYTE HeaderExtensionID;
+
+      typedef std::map<PayloadType, PayloadType> PayloadTypeMap;
+      typedef std::map<PayloadType, ULONG> ClockRateMap;
+      typedef std::map<HeaderExtensionID, HeaderExtensionID> HeaderExtensionIDMap;
+
+    public:
+      RTPForwarder(
+                   const make_private &,
+                   IMessageQueuePtr queue,
+                   IRTPReceiverPtr receiver,
+                   IRTPSenderPtr sender,
+                   const Options &options
+                   );
+
+    protected:
+      RTPForwarder(Noop) :
+        Noop(true),
+        MessageQueueAssociator(IMessageQueuePtr()),
+        SharedRecursiveLock(SharedRecursiveLock::create())
+      {}
+
+      void init();
+
+    public:
+      virtual ~RTPForwarder();
+
+      static RTPForwarderPtr convert(IRTPForwarderPtr object);
+      static RTPForwarderPtr convert(ForRTPReceiverPtr object);
+      static RTPForwarderPtr convert(ForRTPSenderPtr object);
+
+    protected:
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPForwarder => IRTPForwarder
+      #pragma mark
+
+      static ElementPtr toDebug(RTPForwarderPtr forwarder);
+
+      static RTPForwarderPtr create(
+                                    IRTPReceiverPtr receiver,
+                                    IRTPSenderPtr sender,
+                                    const Options &options
+                                    );
+
+      virtual PUID getID() const override {return mID;}
+
+      virtual IRTPReceiverPtr receiver() const override;
+      virtual IRTPSenderPtr sender() const override;
+
+      virtual void update(const Options &options) override;
+
+      virtual void stop() override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPForwarder => IRTPForwarderForRTPReceiver
+      #pragma mark
+
+      // (duplicate) static ElementPtr toDebug(ForRTPReceiverPtr forwarder);
+
+      // (duplicate) virtual PUID getID() const = 0;
+
+      virtual bool forwardPacket(RTPPacketPtr packet) override;
+      virtual void forwardPacket(RTCPPacketPtr packet) override;
+
+      virtual void notifyParametersChanged() override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPForwarder => IRTPForwarderForRTPSender
+      #pragma mark
+
+      // (duplicate) static ElementPtr toDebug(ForRTPSenderPtr forwarder);
+
+      // (duplicate) virtual PUID getID() const = 0;
+
+      virtual bool handleFeedback(RTCPPacketPtr packet) override;
+
+      // (duplicate) virtual void notifyParametersChanged() = 0;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPForwarder => IWakeDelegate
+      #pragma mark
+
+      virtual void onWake() override;
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPForwarder => (internal)
+      #pragma mark
+
+      Log::Params log(const char *message) const;
+      static Log::Params slog(const char *message);
+      Log::Params debug(const char *message) const;
+      virtual ElementPtr toDebug() const;
+
+      bool isShutdown() const { return mShutdown; }
+
+      void step();
+
+      bool stepRegister();
+      bool stepMappings();
+
+      void cancel();
+
+      void switchSource(
+                        const RTPPacket &packet,
+                        ULONG clockRate,
+                        const Time &now
+                        );
+
+      SSRCType outputSSRC() const;
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPForwarder => (data)
+      #pragma mark
+
+      AutoPUID mID;
+      RTPForwarderWeakPtr mThisWeak;
+
+      UseRTPReceiverWeakPtr mRTPReceiver;
+      UseRTPSenderWeakPtr mRTPSender;
+
+      Options mOptions;
+      Milliseconds mSwitchSourceAfterIdle {};
+
+      bool mRegistered {false};
+      bool mShutdown {false};
+
+      ParametersPtr mReceiverParameters;
+      ParametersPtr mSenderParameters;
+
+      PayloadTypeMap mPayloadTypes;               // incoming -> outgoing
+      ClockRateMap mClockRates;                   // incoming payload type -> clock rate
+      HeaderExtensionIDMap mHeaderExtensionIDs;   // incoming -> outgoing
+
+      Optional<SSRCType> mOutputSSRC;
+      SSRCType mGeneratedSSRC {};
+
+      Optional<SSRCType> mActiveSourceSSRC;
+      Time mLastSourcePacketTime;
+
+      WORD mSequenceNumberOffset {};
+      DWORD mTimestampOffset {};
+
+      bool mHasOutput {false};
+      WORD mLastOutputSequenceNumber {};
+      DWORD mLastOutputTimestamp {};
+      Time mLastOutputTime;
+
+      size_t mTotalPacketsForwarded {};
+      size_t mTotalPacketsDropped {};
+      size_t mTotalFeedbackForwarded {};
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPForwarderFactory
+    #pragma mark
+
+    interaction IRTPForwarderFactory
+    {
+      typedef IRTPForwarderTypes::Options Options;
+
+      static IRTPForwarderFactory &singleton();
+
+      virtual RTPForwarderPtr create(
+                                     IRTPReceiverPtr receiver,
+                                     IRTPSenderPtr sender,
+                                     const Options &options
+                                     );
+    };
+
+    class RTPForwarderFactory : public IFactory<IRTPForwarderFactory> {};
+  }
+}
@@ -52,6 +52,8 @@
 
 #define ORTC_SETTING_RTP_LISTENER_ONLY_RESOLVE_AMBIGUOUS_PAYLOAD_MAPPING_IF_ACTIVITY_DIFFERS_IN_MILLISECONDS "ortc/rtp-listener/only-resolve-ambiguous-payload-mapping-if-activity-differs-in-milliseconds"
 
+#define ORTC_SETTING_RTP_LISTENER_ROUTE_RTCP_BY_SSRC "ortc/rtp-listener/route-rtcp-by-ssrc"
+
 namespace ortc
 {
   namespace internal
@@ -293,6 +295,12 @@ namespace ortc
       ZS_DECLARE_PTR(ReceiverObjectMap)
       ZS_DECLARE_PTR(SenderObjectMap)
 
+      typedef std::list<SSRCType> SSRCList;
+      typedef std::map<SSRCType, SenderID> SenderSSRCMap;
+      typedef std::map<SenderID, SSRCList> SenderSSRCListMap;
+      typedef std::set<SenderID> SenderIDSet;
+      typedef std::map<SSRCType, ReceiverID> ReceiverSSRCMap;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPListener::SSRCInfo
@@ -570,6 +578,30 @@ namespace ortc
       void processSDESMid(const RTCPPacket &rtcpPacket);
       void processSenderReports(const RTCPPacket &rtcpPacket);
 
+      static bool extractRTCPSSRCs(
+                                   const RTCPPacket &rtcpPacket,
+                                   SSRCList &outSSRCs,
+                                   bool &outAllSenders
+                                   );
+      void routeRTCPSSRCs(
+                          const SSRCList &ssrcs,
+                          ReceiverObjectMap &ioReceivers,
+                          SenderObjectMap &ioSenders
+                          );
+      void addRTCPWildcards(
+                            ReceiverObjectMap &ioReceivers,
+                            SenderObjectMap &ioSenders,
+                            bool allSenders
+                            );
+      void setSenderSSRCs(
+                          SenderID senderID,
+                          const Parameters *params
+                          );
+      void setReceiverRTCPSSRC(
+                               ReceiverID receiverID,
+                               const Parameters *params
+                               );
+
       void handleDeltaChanges(
                               ReceiverInfoPtr replacementInfo,
                               const EncodingParameters &existing,
@@ -632,6 +664,16 @@ namespace ortc
       SSRCMap mSSRCTable;
       SSRCWeakMap mRegisteredSSRCs;
 
+      bool mRouteRTCPBySSRC {true};
+      bool mRTCPWildcardReceiversDirty {true};
+      ReceiverObjectMap mRTCPWildcardReceivers;   // receivers not reachable by any known SSRC
+
+      SenderSSRCMap mSenderSSRCs;
+      SenderSSRCListMap mSenderSSRCLists;
+      SenderIDSet mRTCPWildcardSenders;           // senders without any SSRC in their parameters
+
+      ReceiverSSRCMap mReceiverRTCPSSRCs;         // receivers' own RTCP SSRCs (targets of XR DLRR sub-blocks)
+
       MuxIDMap mMuxIDTable;
 
       ITimerPtr mSSRCTableTimer;
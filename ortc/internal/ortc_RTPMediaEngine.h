@@ -33,6 +33,8 @@
 
 #include <ortc/internal/types.h>
 #include <ortc/internal/ortc_ISecureTransport.h>
+#include <ortc/internal/ortc_ReceiveLatency.h>
+#include <ortc/internal/ortc_SyntheticMediaSource.h>
 
 #include <ortc/IICETransport.h>
 #include <ortc/IDTMFSender.h>
@@ -563,6 +565,11 @@ namespace ortc
       virtual webrtc::VoiceEngine *getVoiceEngine() = 0;
       virtual const SharedRecursiveLock &getSharedLock() const = 0;
       virtual IMessageQueuePtr getMessageQueue() const = 0;
+
+      // the voice engine has a single recording path so only one synthetic
+      // audio source may feed it at a time
+      virtual bool claimSyntheticAudioFeed(PUID resourceID) = 0;
+      virtual void releaseSyntheticAudioFeed(PUID resourceID) = 0;
     };
 
     //-------------------------------------------------------------------------
@@ -653,7 +660,11 @@ namespace ortc
     {
       ZS_DECLARE_TYPEDEF_PTR(webrtc::VideoFrame, VideoFrame);
 
-      virtual void onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer) = 0;
+      virtual void onHandleRTPPacket(
+                                     DWORD timestamp,
+                                     SecureByteBlockPtr buffer,
+                                     ReceiveLatencyStamp latencyStamp
+                                     ) = 0;
       virtual void onHandleRTCPPacket(SecureByteBlockPtr buffer) = 0;
       virtual void onSendVideoFrame(VideoFramePtr videoFrame) = 0;
     };
@@ -891,6 +902,9 @@ namespace ortc
       virtual const SharedRecursiveLock &getSharedLock() const override { return *this; }
       virtual IMessageQueuePtr getMessageQueue() const override { return getAssociatedMessageQueue(); }
 
+      virtual bool claimSyntheticAudioFeed(PUID resourceID) override;
+      virtual void releaseSyntheticAudioFeed(PUID resourceID) override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPMediaEngine => IRTPMediaEngineForChannelResource
@@ -1124,7 +1138,8 @@ namespace ortc
       class DeviceResource : public IRTPMediaEngineDeviceResource,
                              public BaseResource,
                              public IDeviceResourceForRTPMediaEngine,
-                             public IRTPMediaEngineDeviceResourceAsyncDelegate
+                             public IRTPMediaEngineDeviceResourceAsyncDelegate,
+                             public ISyntheticMediaSourceSink
       {
       public:
         ZS_DECLARE_CLASS_PTR(VideoCaptureTransport)
@@ -1136,6 +1151,7 @@ namespace ortc
         ZS_DECLARE_TYPEDEF_PTR(webrtc::VideoFrame, VideoFrame);
 
         ZS_DECLARE_TYPEDEF_PTR(IRTPMediaEngineForDeviceResource, UseEngine)
+        ZS_DECLARE_TYPEDEF_PTR(ISyntheticMediaSourceForDeviceResource, UseSyntheticSource)
         ZS_DECLARE_TYPEDEF_PTR(IStatsProviderTypes::PromiseWithStatsReport, PromiseWithStatsReport);
         ZS_DECLARE_TYPEDEF_PTR(IStatsReportTypes::StatsTypeSet, StatsTypeSet);
 
@@ -1195,6 +1211,20 @@ namespace ortc
 
         virtual void onCapturedVideoFrame(VideoFramePtr frame) override;
 
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark RTPMediaEngine::DeviceResource => ISyntheticMediaSourceSink
+        #pragma mark
+
+        virtual void onSyntheticVideoFrame(VideoFramePtr frame) override;
+
+        virtual void onSyntheticAudioSamples(
+                                             const int16_t *samples,
+                                             size_t samplesPerChannel,
+                                             size_t channels,
+                                             ULONG sampleRate
+                                             ) override;
+
         //---------------------------------------------------------------------
         #pragma mark
         #pragma mark RTPMediaEngine::DeviceResource => (friend RTPMediaEngine)
@@ -1268,6 +1298,12 @@ namespace ortc
 
         PromisePtr getShutdownPromise();
 
+        bool setupSyntheticSource(
+                                  Kinds kind,
+                                  TrackSettingsPtr settings
+                                  );
+        void releaseSyntheticSource();
+
         int getAudioDeviceIndex(webrtc::VoiceEngine *voiceEngine, String deviceID);
 
         FLOAT calculateSizeDistance(
@@ -1301,6 +1337,8 @@ namespace ortc
         VideoCaptureTransportPtr mTransport;  // keep lifetime of webrtc callback separate from this object
 
         webrtc::VideoCaptureModule* mVideoCaptureModule {NULL};
+        UseSyntheticSourcePtr mSyntheticSource;   // replaces the capture device for "synthetic:" device IDs
+        std::atomic<bool> mSyntheticAudioFeed {false};
         webrtc::VideoRenderCallback* mVideoRendererCallback {NULL};
         IMediaStreamTrackRenderCallbackPtr mVideoRenderCallbackReferenceHolder;
 
@@ -1495,7 +1533,11 @@ namespace ortc
         #pragma mark RTPMediaEngine::AudioReceiverChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
         #pragma mark
 
-        virtual void onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer) override;
+        virtual void onHandleRTPPacket(
+                                       DWORD timestamp,
+                                       SecureByteBlockPtr buffer,
+                                       ReceiveLatencyStamp latencyStamp
+                                       ) override;
         virtual void onHandleRTCPPacket(SecureByteBlockPtr buffer) override;
         virtual void onSendVideoFrame(VideoFramePtr videoFrame) override {}
 
@@ -1640,7 +1682,7 @@ namespace ortc
         #pragma mark RTPMediaEngine::AudioSenderChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
         #pragma mark
 
-        virtual void onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer) override {}
+        virtual void onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer, ReceiveLatencyStamp latencyStamp) override {}
         virtual void onHandleRTCPPacket(SecureByteBlockPtr buffer) override;
         virtual void onSendVideoFrame(VideoFramePtr videoFrame) override {}
 
@@ -1798,7 +1840,11 @@ namespace ortc
         #pragma mark RTPMediaEngine::VideoReceiverChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
         #pragma mark
 
-        virtual void onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer) override;
+        virtual void onHandleRTPPacket(
+                                       DWORD timestamp,
+                                       SecureByteBlockPtr buffer,
+                                       ReceiveLatencyStamp latencyStamp
+                                       ) override;
         virtual void onHandleRTCPPacket(SecureByteBlockPtr buffer) override;
         virtual void onSendVideoFrame(VideoFramePtr videoFrame) override {}
 
@@ -1919,7 +1965,7 @@ namespace ortc
         #pragma mark RTPMediaEngine::VideoSenderChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
         #pragma mark
 
-        virtual void onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer) override {}
+        virtual void onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer, ReceiveLatencyStamp latencyStamp) override {}
         virtual void onHandleRTCPPacket(SecureByteBlockPtr buffer) override;
         virtual void onSendVideoFrame(VideoFramePtr videoFrame) override;
 
@@ -1981,6 +2027,7 @@ namespace ortc
 
       rtc::scoped_refptr<webrtc::AudioState> mAudioState;
       rtc::scoped_ptr<webrtc::VoiceEngine, VoiceEngineDeleter> mVoiceEngine;
+      std::atomic<PUID> mSyntheticAudioFeedResourceID {};
 
       rtc::scoped_ptr<WebRtcTraceCallback> mTraceCallback;
       rtc::scoped_ptr<WebRtcLogSink> mLogSink;
@@ -2036,7 +2083,8 @@ ZS_DECLARE_PROXY_END()
 ZS_DECLARE_PROXY_BEGIN(ortc::internal::IRTPMediaEngineHandlePacketAsyncDelegate)
 ZS_DECLARE_PROXY_TYPEDEF(ortc::services::SecureByteBlockPtr, SecureByteBlockPtr)
 ZS_DECLARE_PROXY_TYPEDEF(ortc::internal::IRTPMediaEngineHandlePacketAsyncDelegate::VideoFramePtr, VideoFramePtr)
-ZS_DECLARE_PROXY_METHOD_2(onHandleRTPPacket, DWORD, SecureByteBlockPtr)
+ZS_DECLARE_PROXY_TYPEDEF(ortc::internal::ReceiveLatencyStamp, ReceiveLatencyStamp)
+ZS_DECLARE_PROXY_METHOD_3(onHandleRTPPacket, DWORD, SecureByteBlockPtr, ReceiveLatencyStamp)
 ZS_DECLARE_PROXY_METHOD_1(onHandleRTCPPacket, SecureByteBlockPtr)
 ZS_DECLARE_PROXY_METHOD_1(onSendVideoFrame, VideoFramePtr)
 ZS_DECLARE_PROXY_END()
@@ -0,0 +1,165 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#pragma once
+
+#include <ortc/internal/types.h>
+
+#include <ortc/internal/ortc_RTPPacket.h>
+#include <ortc/internal/ortc_RTCPPacket.h>
+
+#include <list>
+#include <vector>
+
+namespace ortc
+{
+  namespace internal
+  {
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPPacketHistory
+    #pragma mark
+
+    // Fixed size ring of the most recently sent RTP packets of a single
+    // outgoing SSRC, indexed by sequence number, from which generic NACKs
+    // are answered with RTX (RFC4588) retransmissions. Only packets that
+    // did not originate from the media engine (e.g. forwarded packets) are
+    // stored; the engine answers NACKs for its own packets.
+    //
+    // NOTE: Not thread safe; the owner must serialize access.
+    class RTPPacketHistory
+    {
+    protected:
+      struct make_private {};
+
+    public:
+      typedef IRTPTypes::PayloadType PayloadType;
+      typedef IRTPTypes::SSRCType SSRCType;
+
+      typedef std::map<PayloadType, PayloadType> PayloadTypeMap;  // media payload type => rtx payload type
+      typedef std::list<RTPPacketPtr> RTPPacketList;
+
+      struct Settings
+      {
+        size_t mMaxPackets {512};                   // rounded up to a power of 2
+        Milliseconds mMaxAge {1000};
+        Milliseconds mMinResendInterval {10};       // used when the round trip time is not yet known
+        size_t mMaxResendsPerPacket {5};
+        size_t mMaxResendBytesPerSecond {256*1024};
+
+        ElementPtr toDebug() const;
+      };
+
+      struct Slot
+      {
+        RTPPacketPtr mPacket;
+        WORD mSequenceNumber {};
+        Time mSent;
+        Time mLastResent;
+        size_t mResends {};
+      };
+
+      typedef std::vector<Slot> SlotVector;
+
+    public:
+      RTPPacketHistory(
+                       const make_private &,
+                       const Settings &settings,
+                       SSRCType rtxSSRC
+                       );
+
+      static RTPPacketHistoryPtr create(
+                                        const Settings &settings,
+                                        SSRCType rtxSSRC
+                                        );
+
+      SSRCType rtxSSRC() const                    {return mRTXSSRC;}
+
+      void store(
+                 RTPPacketPtr packet,
+                 const Time &now
+                 );
+
+      // returns NULL if the packet is no longer held, is suppressed because
+      // it was already resent within the round trip time, or the resend
+      // rate limit was reached
+      RTPPacketPtr resend(
+                          WORD sequenceNumber,
+                          const Time &now,
+                          Milliseconds roundTripTime,
+                          const PayloadTypeMap &rtxPayloadTypes
+                          );
+
+      // answers every sequence number covered by a generic NACK (pid + blp)
+      // appending the resulting RTX packets
+      void handleNACK(
+                      const RTCPPacket::TransportLayerFeedbackMessage &nack,
+                      const Time &now,
+                      Milliseconds roundTripTime,
+                      const PayloadTypeMap &rtxPayloadTypes,
+                      RTPPacketList &outResends
+                      );
+
+      static RTPPacketPtr createRTXPacket(
+                                          const RTPPacket &original,
+                                          PayloadType rtxPayloadType,
+                                          SSRCType rtxSSRC,
+                                          WORD rtxSequenceNumber
+                                          );
+
+      ElementPtr toDebug() const;
+
+    protected:
+      void updateCredit(const Time &now);
+
+    protected:
+      Settings mSettings;
+      SSRCType mRTXSSRC {};
+      WORD mRTXSequenceNumber {};
+
+      SlotVector mSlots;
+      size_t mMask {};
+
+      Time mLastCreditUpdate;
+      double mCredit {};
+
+      size_t mTotalStored {};
+      size_t mTotalResent {};
+      size_t mTotalMissing {};
+      size_t mTotalSuppressed {};
+      size_t mTotalRateLimited {};
+    };
+
+  }
+}
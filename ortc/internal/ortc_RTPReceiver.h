@@ -34,6 +34,7 @@
 #include <ortc/internal/types.h>
 #include <ortc/internal/ortc_ISecureTransport.h>
 #include <ortc/internal/ortc_RTPTypes.h>
+#include <ortc/internal/ortc_RTPContributingSourceTable.h>
 
 #include <ortc/IICETransport.h>
 #include <ortc/IRTPReceiver.h>
@@ -55,12 +56,17 @@
 
 #define ORTC_SETTING_RTP_RECEIVER_LOCK_TO_RECEIVER_CHANNEL_AFTER_SWITCH_EXCLUSIVELY_FOR_IN_MILLISECONDS "ortc/rtp-receiver/lock-to-receiver-channel-after-switch-in-milliseconds"
 
+#define ORTC_SETTING_RTP_RECEIVER_DECODE_ONLY_ACTIVE_CHANNEL "ortc/rtp-receiver/decode-only-active-channel"
+#define ORTC_SETTING_RTP_RECEIVER_CHANNEL_WARM_UP_TIMEOUT_IN_MILLISECONDS "ortc/rtp-receiver/channel-warm-up-timeout-in-milliseconds"
+#define ORTC_SETTING_RTP_RECEIVER_MIN_KEY_FRAME_REQUEST_INTERVAL_IN_MILLISECONDS "ortc/rtp-receiver/min-key-frame-request-interval-in-milliseconds"
+
 namespace ortc
 {
   namespace internal
   {
     ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForRTPListener)
     ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForMediaStreamTrack)
+    ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForRTPForwarder)
 
     ZS_DECLARE_INTERACTION_PTR(IRTPReceiverChannelForRTPReceiver)
 
@@ -68,6 +74,9 @@ namespace ortc
     ZS_DECLARE_INTERACTION_PTR(IRTPListenerForRTPReceiver)
     ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForRTPReceiverChannel)
     ZS_DECLARE_INTERACTION_PTR(IMediaStreamTrackForRTPReceiver)
+    ZS_DECLARE_INTERACTION_PTR(IRTPForwarderForRTPReceiver)
+
+    ZS_DECLARE_CLASS_PTR(StatsCountersHandle);
 
     ZS_DECLARE_INTERACTION_PROXY(IRTPReceiverAsyncDelegate)
 
@@ -134,6 +143,34 @@ namespace ortc
       virtual PUID getID() const = 0;
     };
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPReceiverForRTPForwarder
+    #pragma mark
+
+    interaction IRTPReceiverForRTPForwarder
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IRTPReceiverForRTPForwarder, ForRTPForwarder)
+      ZS_DECLARE_TYPEDEF_PTR(IRTPForwarderForRTPReceiver, UseForwarder)
+
+      static ElementPtr toDebug(ForRTPForwarderPtr object);
+
+      virtual PUID getID() const = 0;
+
+      virtual IRTPTypes::ParametersPtr getParameters() const = 0;
+
+      virtual void registerForwarder(
+                                     UseForwarderPtr forwarder,
+                                     bool exclusive
+                                     ) = 0;
+      virtual void unregisterForwarder(PUID forwarderID) = 0;
+
+      virtual bool sendPacket(RTCPPacketPtr packet) = 0;
+    };
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -144,6 +181,11 @@ namespace ortc
 
     interaction IRTPReceiverAsyncDelegate
     {
+      typedef IRTPTypes::SSRCType SSRCType;
+
+      virtual void onRequestKeyFrame(SSRCType ssrc) = 0;
+      virtual void onDeliverBufferedPackets() = 0;
+
       virtual ~IRTPReceiverAsyncDelegate() {}
     };
 
@@ -162,6 +204,7 @@ namespace ortc
                         public IRTPReceiverForRTPListener,
                         public IRTPReceiverForRTPReceiverChannel,
                         public IRTPReceiverForMediaStreamTrack,
+                        public IRTPReceiverForRTPForwarder,
                         public ISecureTransportDelegate,
                         public IWakeDelegate,
                         public zsLib::ITimerDelegate,
@@ -176,11 +219,13 @@ namespace ortc
       friend interaction IRTPReceiverForRTPListener;
       friend interaction IRTPReceiverForRTPReceiverChannel;
       friend interaction IRTPReceiverForMediaStreamTrack;
+      friend interaction IRTPReceiverForRTPForwarder;
 
       ZS_DECLARE_TYPEDEF_PTR(ISecureTransportForRTPReceiver, UseSecureTransport);
       ZS_DECLARE_TYPEDEF_PTR(IRTPListenerForRTPReceiver, UseListener);
       ZS_DECLARE_TYPEDEF_PTR(IRTPReceiverChannelForRTPReceiver, UseChannel);
       ZS_DECLARE_TYPEDEF_PTR(IMediaStreamTrackForRTPReceiver, UseMediaStreamTrack);
+      ZS_DECLARE_TYPEDEF_PTR(IRTPForwarderForRTPReceiver, UseForwarder);
       ZS_DECLARE_TYPEDEF_PTR(IStatsProviderTypes::PromiseWithStatsReport, PromiseWithStatsReport);
 
       ZS_DECLARE_STRUCT_PTR(RegisteredHeaderExtension);
@@ -223,6 +268,38 @@ namespace ortc
       typedef std::map<ChannelID, ChannelHolderWeakPtr> ChannelWeakMap;
       ZS_DECLARE_PTR(ChannelWeakMap)
 
+      typedef PUID ForwarderID;
+      typedef std::map<ForwarderID, UseForwarderWeakPtr> ForwarderWeakMap;
+      ZS_DECLARE_PTR(ForwarderWeakMap)
+      typedef std::set<ForwarderID> ForwarderIDSet;
+
+      // a buffered packet whose channel mapping has since been resolved
+      struct BufferedDelivery
+      {
+        RTPPacketPtr mPacket;
+        ChannelHolderPtr mChannelHolder;
+        bool mDeliverToChannel {};
+      };
+      typedef std::list<BufferedDelivery> BufferedDeliveryList;
+
+      // audio levels pulled from a packet inside the object lock and
+      // applied to the contributing source table once the lock is released
+      struct ContributingSourceUpdates
+      {
+        struct Update
+        {
+          SSRCType mCSRC {};
+          BYTE mLevel {};
+          Optional<bool> mVoiceActivityFlag;
+        };
+
+        static const size_t kMaxUpdates {16};     // the ssrc plus up to 15 csrcs
+
+        Time mTime;
+        size_t mCount {};
+        Update mUpdates[kMaxUpdates];
+      };
+
       typedef DWORD RoutingPayloadType;
 
       typedef std::pair<SSRCType, RoutingPayloadType> SSRCRoutingPair;
@@ -248,8 +325,6 @@ namespace ortc
 
       typedef std::map<LocalID, RegisteredHeaderExtension> HeaderExtensionMap;
 
-      typedef std::map<SSRCType, ContributingSource> ContributingSourceMap;
-
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPReceiver::ChannelHolder
@@ -355,6 +430,7 @@ namespace ortc
       {
         PayloadType mPayloadType {};
         CodecTypes mCodecType {CodecType_First};
+        IRTPTypes::SupportedCodecs mSupportedCodec {IRTPTypes::SupportedCodec_Unknown};
         CodecInfo *mOriginalCodec {};  // used for rtx to point to original codec
         IRTPTypes::CodecParameters *mOriginalCodecParams {};
 
@@ -363,6 +439,8 @@ namespace ortc
 
       typedef std::map<PayloadType, CodecInfo> CodecInfoMap;
 
+      typedef std::map<SSRCType, Time> SSRCTimeMap;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPReceiver::States
@@ -403,6 +481,7 @@ namespace ortc
       static RTPReceiverPtr convert(ForRTPListenerPtr object);
       static RTPReceiverPtr convert(ForRTPReceiverChannelPtr object);
       static RTPReceiverPtr convert(ForMediaStreamTrackPtr object);
+      static RTPReceiverPtr convert(ForRTPForwarderPtr object);
 
     protected:
       //-----------------------------------------------------------------------
@@ -487,6 +566,25 @@ namespace ortc
 
       // (duplicate) virtual PUID getID() const = 0;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPReceiver => IRTPReceiverForRTPForwarder
+      #pragma mark
+
+      // (duplicate) static ElementPtr toDebug(ForRTPForwarderPtr object);
+
+      // (duplicate) virtual PUID getID() const = 0;
+
+      virtual ParametersPtr getParameters() const override;
+
+      virtual void registerForwarder(
+                                     UseForwarderPtr forwarder,
+                                     bool exclusive
+                                     ) override;
+      virtual void unregisterForwarder(PUID forwarderID) override;
+
+      // (duplicate) virtual bool sendPacket(RTCPPacketPtr packet) = 0;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPReceiver => ISecureTransportDelegate
@@ -516,6 +614,9 @@ namespace ortc
       #pragma mark RTPReceiver => IRTPReceiverAsyncDelegate
       #pragma mark
 
+      virtual void onRequestKeyFrame(SSRCType ssrc) override;
+      virtual void onDeliverBufferedPackets() override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPReceiver => (friend RTPReceiver::ChannelHolder)
@@ -655,20 +756,40 @@ namespace ortc
       void processByes(const RTCPPacket &rtcpPacket);
       void processSenderReports(const RTCPPacket &rtcpPacket);
 
-      void extractCSRCs(const RTPPacket &rtpPacket);
-      void setContributingSource(
-                                 SSRCType csrc,
-                                 BYTE level,
-                                 const Optional<bool> &voiceActivityFlag
-                                 );
+      void extractCSRCs(
+                        const RTPPacket &rtpPacket,
+                        ContributingSourceUpdates &outUpdates
+                        );
+      void setContributingSources(const ContributingSourceUpdates &updates);
 
-      void postFindMappingProcessPacket(
+      bool postFindMappingProcessPacket(
                                         const RTPPacket &rtpPacket,
-                                        ChannelHolderPtr &channelHolder
+                                        ChannelHolderPtr &channelHolder,
+                                        ContributingSourceUpdates &outContributingSources
                                         );
 
+      bool deliverPacket(
+                         IICETypes::Components viaTransport,
+                         RTPPacketPtr packet,
+                         ChannelHolderPtr channelHolder,
+                         ForwarderWeakMapPtr forwarders,
+                         bool forwardExclusively,
+                         bool deliverToChannel
+                         );
+
+      void switchActiveReceiverChannel(
+                                       ChannelHolderPtr &channelHolder,
+                                       const Time &tick
+                                       );
       void resetActiveReceiverChannel();
 
+      void requestKeyFrame(
+                           SSRCType ssrc,
+                           const Time &tick
+                           );
+
+      bool isKeyFrameStart(const RTPPacket &rtpPacket);
+
       Optional<RoutingPayloadType> decodeREDRoutingPayloadType(
                                                                const BYTE *buffer,
                                                                size_t bufferSizeInBytes
@@ -747,6 +868,7 @@ namespace ortc
       ParametersToChannelInfoMap mChannelInfos;
 
       HeaderExtensionMap mRegisteredExtensions;
+      bool mHasAudioLevelExtensions {};
 
       SSRCRoutingMap mSSRCRoutingPayloadTable;
       SSRCRoutingWeakMap mRegisteredSSRCRoutingPayloads;
@@ -761,8 +883,10 @@ namespace ortc
 
       BufferedRTPPacketList mBufferedRTPPackets;
       bool mReattemptRTPDelivery {false};
+      BufferedDeliveryList mPendingBufferedDeliveries;  // delivered outside the lock via onDeliverBufferedPackets()
 
-      ContributingSourceMap mContributingSources;
+      Lock mContributingSourcesLock;                    // serializes the writers of mContributingSources
+      RTPContributingSourceTable mContributingSources;  // read without lock
       Seconds mContributingSourcesExpiry {};
       ITimerPtr mContributingSourcesTimer;
 
@@ -770,7 +894,19 @@ namespace ortc
       Time mLastSwitchedCurrentChannel;
       Milliseconds mLockAfterSwitchTime {};
 
+      bool mDecodeOnlyActiveChannel {};
+      Milliseconds mChannelWarmUpTimeout {};
+      ChannelHolderPtr mWarmingChannel;             // channel waiting for a key frame before becoming current (only one candidate at a time)
+      Time mWarmingStarted;
+      Milliseconds mMinKeyFrameRequestInterval {};
+      SSRCTimeMap mLastKeyFrameRequests;            // per SSRC time of last PLI sent
+
       Milliseconds mAmbiguousPayloadMappingMinDifference {};
+
+      ForwarderWeakMapPtr mForwarders;             // COW pattern, always valid ptr
+      ForwarderIDSet mExclusiveForwarders;
+
+      StatsCountersHandlePtr mStatsCounters;      // set once in init(), updated without lock
     };
 
     //-------------------------------------------------------------------------
@@ -803,5 +939,8 @@ namespace ortc
 }
 
 ZS_DECLARE_PROXY_BEGIN(ortc::internal::IRTPReceiverAsyncDelegate)
+ZS_DECLARE_PROXY_TYPEDEF(ortc::internal::IRTPReceiverAsyncDelegate::SSRCType, SSRCType)
 //ZS_DECLARE_PROXY_METHOD_2(onDeliverPacket, UseChannelPtr, RTPPacketPtr)
+ZS_DECLARE_PROXY_METHOD_1(onRequestKeyFrame, SSRCType)
+ZS_DECLARE_PROXY_METHOD_0(onDeliverBufferedPackets)
 ZS_DECLARE_PROXY_END()
@@ -33,6 +33,8 @@
 
 #include <ortc/internal/types.h>
 #include <ortc/internal/ortc_ISecureTransport.h>
+#include <ortc/internal/ortc_RTCPPacket.h>
+#include <ortc/internal/ortc_RTPPacketHistory.h>
 
 #include <ortc/IRTPSender.h>
 #include <ortc/IDTLSTransport.h>
@@ -43,7 +45,13 @@
 #include <zsLib/MessageQueueAssociator.h>
 #include <zsLib/ITimer.h>
 
-//#define ORTC_SETTING_SCTP_TRANSPORT_MAX_MESSAGE_SIZE "ortc/sctp/max-message-size"
+#define ORTC_SETTING_RTP_SENDER_GROUP_SIMULCAST_VIDEO_ENCODINGS "ortc/rtp-sender/group-simulcast-video-encodings"
+
+#define ORTC_SETTING_RTP_SENDER_NACK_HISTORY_MAX_PACKETS "ortc/rtp-sender/nack-history/max-packets"
+#define ORTC_SETTING_RTP_SENDER_NACK_HISTORY_MAX_AGE_IN_MILLISECONDS "ortc/rtp-sender/nack-history/max-age-in-milliseconds"
+#define ORTC_SETTING_RTP_SENDER_NACK_HISTORY_MIN_RESEND_INTERVAL_IN_MILLISECONDS "ortc/rtp-sender/nack-history/min-resend-interval-in-milliseconds"
+#define ORTC_SETTING_RTP_SENDER_NACK_HISTORY_MAX_RESENDS_PER_PACKET "ortc/rtp-sender/nack-history/max-resends-per-packet"
+#define ORTC_SETTING_RTP_SENDER_NACK_HISTORY_MAX_RESEND_BYTES_PER_SECOND "ortc/rtp-sender/nack-history/max-resend-bytes-per-second"
 
 namespace ortc
 {
@@ -54,11 +62,15 @@ namespace ortc
     ZS_DECLARE_INTERACTION_PTR(IRTPSenderForRTPSenderChannel);
     ZS_DECLARE_INTERACTION_PTR(IRTPSenderForMediaStreamTrack);
     ZS_DECLARE_INTERACTION_PTR(IRTPSenderForDTMFSender);
+    ZS_DECLARE_INTERACTION_PTR(IRTPSenderForRTPForwarder);
 
     ZS_DECLARE_INTERACTION_PTR(ISecureTransportForRTPSender);
     ZS_DECLARE_INTERACTION_PTR(IRTPListenerForRTPSender);
     ZS_DECLARE_INTERACTION_PTR(IRTPSenderChannelForRTPSender);
     ZS_DECLARE_INTERACTION_PTR(IMediaStreamTrackForRTPSender);
+    ZS_DECLARE_INTERACTION_PTR(IRTPForwarderForRTPSender);
+
+    ZS_DECLARE_CLASS_PTR(StatsCountersHandle);
 
     ZS_DECLARE_INTERACTION_PROXY(IRTPSenderAsyncDelegate)
 
@@ -169,6 +181,32 @@ namespace ortc
       virtual PUID getID() const = 0;
     };
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPSenderForRTPForwarder
+    #pragma mark
+
+    interaction IRTPSenderForRTPForwarder
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IRTPSenderForRTPForwarder, ForRTPForwarder)
+      ZS_DECLARE_TYPEDEF_PTR(IRTPForwarderForRTPSender, UseForwarder)
+
+      static ElementPtr toDebug(ForRTPForwarderPtr transport);
+
+      virtual PUID getID() const = 0;
+
+      virtual IRTPTypes::ParametersPtr getParameters() const = 0;
+
+      virtual void registerForwarder(UseForwarderPtr forwarder) = 0;
+      virtual void unregisterForwarder(PUID forwarderID) = 0;
+
+      virtual bool sendForwardedPacket(RTPPacketPtr packet) = 0;
+      virtual bool sendPacket(RTCPPacketPtr packet) = 0;
+    };
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -201,6 +239,7 @@ namespace ortc
                       public IRTPSenderForRTPSenderChannel,
                       public IRTPSenderForDTMFSender,
                       public IRTPSenderForMediaStreamTrack,
+                      public IRTPSenderForRTPForwarder,
                       public ISecureTransportDelegate,
                       public IWakeDelegate,
                       public IDTMFSenderDelegate,
@@ -217,17 +256,21 @@ namespace ortc
       friend interaction IRTPSenderForRTPSenderChannel;
       friend interaction IRTPSenderForDTMFSender;
       friend interaction IRTPSenderForMediaStreamTrack;
+      friend interaction IRTPSenderForRTPForwarder;
 
       ZS_DECLARE_TYPEDEF_PTR(ISecureTransportForRTPSender, UseSecureTransport);
       ZS_DECLARE_TYPEDEF_PTR(IRTPListenerForRTPSender, UseListener);
       ZS_DECLARE_TYPEDEF_PTR(IRTPSenderChannelForRTPSender, UseChannel);
       ZS_DECLARE_TYPEDEF_PTR(IMediaStreamTrackForRTPSender, UseMediaStreamTrack);
+      ZS_DECLARE_TYPEDEF_PTR(IRTPForwarderForRTPSender, UseForwarder);
 
       ZS_DECLARE_TYPEDEF_PTR(IStatsProviderTypes::PromiseWithStatsReport, PromiseWithStatsReport);
 
       typedef std::list<RTCPPacketPtr> RTCPPacketList;
       ZS_DECLARE_PTR(RTCPPacketList)
 
+      typedef std::list<RTPPacketPtr> RTPPacketList;
+
       ZS_DECLARE_STRUCT_PTR(ChannelHolder)
 
       typedef std::map<ParametersPtr, ChannelHolderPtr> ParametersToChannelHolderMap;
@@ -237,6 +280,11 @@ namespace ortc
 
       typedef std::list<IRTPTypes::SSRCType> SSRCList;
 
+      typedef std::map<IRTPTypes::SSRCType, RTPPacketHistoryPtr> PacketHistoryMap;
+
+      typedef std::map<PUID, UseForwarderWeakPtr> ForwarderWeakMap;
+      ZS_DECLARE_PTR(ForwarderWeakMap)
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPSender::ChannelHolder
@@ -317,6 +365,7 @@ namespace ortc
       static RTPSenderPtr convert(ForRTPSenderChannelPtr object);
       static RTPSenderPtr convert(ForDTMFSenderPtr object);
       static RTPSenderPtr convert(ForMediaStreamTrackPtr object);
+      static RTPSenderPtr convert(ForRTPForwarderPtr object);
 
     protected:
       //-----------------------------------------------------------------------
@@ -403,6 +452,23 @@ namespace ortc
 
       // (duplicate) virtual PUID getID() const = 0;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPSender => IRTPSenderForRTPForwarder
+      #pragma mark
+
+      // (duplciate) static ElementPtr toDebug(ForRTPForwarderPtr transport);
+
+      // (duplicate) virtual PUID getID() const = 0;
+
+      virtual ParametersPtr getParameters() const override;
+
+      virtual void registerForwarder(UseForwarderPtr forwarder) override;
+      virtual void unregisterForwarder(PUID forwarderID) override;
+
+      virtual bool sendForwardedPacket(RTPPacketPtr packet) override;
+      // (duplicate) virtual bool sendPacket(RTCPPacketPtr packet) = 0;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPSender => IRTPSenderForDTMFSender
@@ -503,6 +569,28 @@ namespace ortc
 
       ChannelHolderPtr getDTMFChannelHolder() const;
 
+      bool shouldGroupSimulcastEncodings() const;
+
+      static bool isSSRCOfChannels(
+                                   const ParametersToChannelHolderMap &channels,
+                                   IRTPTypes::SSRCType ssrc
+                                   );
+      void updateStatsCounters(
+                               const ParametersToChannelHolderMap &channels,
+                               const RTCPPacket &packet
+                               );
+      static bool getRoundTripTime(
+                                   const RTCPPacket::SenderReceiverCommonReport::ReportBlock &block,
+                                   DWORD compactNow,
+                                   Microseconds &outRoundTripTime
+                                   );
+
+      void updatePacketHistories();
+      void handleNACKs(
+                       const RTCPPacket &packet,
+                       RTPPacketList &outResends
+                       );
+
     protected:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -544,7 +632,16 @@ namespace ortc
 
       ParametersToChannelHolderMapPtr mChannels;  // using COW pattern
 
+      ForwarderWeakMapPtr mForwarders;            // using COW pattern, always valid ptr
+
       SSRCList mConflicts;
+
+      RTPPacketHistory::Settings mPacketHistorySettings;
+      PacketHistoryMap mPacketHistories;          // media ssrc => sent packets (only for encodings with an rtx ssrc)
+      RTPPacketHistory::PayloadTypeMap mRTXPayloadTypes;
+      Milliseconds mRoundTripTime {};
+
+      StatsCountersHandlePtr mStatsCounters;      // set once in init(), updated without lock
     };
 
     //-------------------------------------------------------------------------
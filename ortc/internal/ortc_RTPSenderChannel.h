@@ -286,6 +286,7 @@ namespace ortc
       };
 
       typedef std::map<SSRCType, TaggingInfoPtr> TaggingMap;
+      typedef std::map<SSRCType, String> SSRCToRIDMap;
 
     public:
       RTPSenderChannel(
@@ -441,6 +442,7 @@ namespace ortc
       void setError(WORD error, const char *reason = NULL);
 
       void setupTagging();
+      const String &getRID(SSRCType ssrc) const;
 
     protected:
       //-----------------------------------------------------------------------
@@ -469,6 +471,7 @@ namespace ortc
       std::atomic<bool> mIsTagging {false};
       String mMuxID;
       String mRID;
+      SSRCToRIDMap mRIDs;             // per SSRC RID when simulcast encodings share this channel
       String mHeaderHash;
 
       Seconds mRetagAfterInSeconds {};
@@ -59,6 +59,14 @@ namespace ortc
 
       ZS_DECLARE_TYPEDEF_PTR(std::list<OldNewParametersPair>, ParametersPtrPairList)
 
+      struct ChannelHashes
+      {
+        String mFull;
+        String mCompatible;     // excludes header extensions and RTCP
+      };
+
+      typedef std::map<ParametersPtr, ChannelHashes> ChannelHashMap;
+
       struct FindCodecOptions
       {
         typedef std::set<PayloadType> PayloadTypeSet;
@@ -109,7 +117,15 @@ namespace ortc
 
       static void splitParamsIntoChannels(
                                           const Parameters &params,
-                                          ParametersPtrList &outParamsGroupedIntoChannels
+                                          ParametersPtrList &outParamsGroupedIntoChannels,
+                                          bool groupSimulcastEncodings = false
+                                          );
+
+      static void splitParamsIntoChannels(
+                                          const Parameters &params,
+                                          const ParametersPtrList &previousParamsGroupedIntoChannels,
+                                          ParametersPtrList &outParamsGroupedIntoChannels,
+                                          bool groupSimulcastEncodings = false
                                           );
 
       static void calculateDeltaChangesInChannels(
@@ -122,6 +138,16 @@ namespace ortc
                                                   ParametersPtrList &outRemovedChannels
                                                   );
 
+      static void calculateChannelHashes(
+                                         const ParametersPtrList &paramsGroupedIntoChannels,
+                                         ChannelHashMap &ioHashes
+                                         );
+
+      static void adoptUnchangedChannels(
+                                         ParametersPtrList &ioParamsGroupedIntoChannels,
+                                         const ParametersPtrPairList &unchangedChannels
+                                         );
+
       static bool isGeneralizedSSRCCompatibleChange(
                                                     const Parameters &oldParams,
                                                     const Parameters &newParams
@@ -195,6 +221,12 @@ namespace ortc
                                                              size_t packetPayloadSizeInBytes
                                                              );
 
+      static bool isKeyFrameStart(
+                                  IRTPTypes::SupportedCodecs codec,
+                                  const BYTE *packetPayload,
+                                  size_t packetPayloadSizeInBytes
+                                  );
+
       static Log::Params slog(const char *message);
     };
   }
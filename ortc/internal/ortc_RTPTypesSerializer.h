@@ -0,0 +1,255 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#pragma once
+
+#include <ortc/internal/types.h>
+
+#include <ortc/IRTPTypes.h>
+
+namespace ortc
+{
+  namespace internal
+  {
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPTypesJSONReader
+    #pragma mark
+
+    // Pull reader over a NUL terminated JSON document. Values are consumed
+    // in place; nothing is allocated beyond the strings being extracted.
+    class RTPTypesJSONReader
+    {
+    public:
+      RTPTypesJSONReader(const char *json);
+
+      bool hasFailed() const {return mFailed;}
+      const char *position() const {return mPos;}
+
+      bool fail();
+      bool isNext(char ch);
+      bool isAtEnd();
+
+      bool beginObject();
+      bool nextMember(String &outName);
+
+      bool beginArray();
+      bool nextItem();
+
+      // reads a string or a bare scalar (number, true, false) as text; null
+      // and nested values yield an empty result
+      bool readScalar(String &outValue);
+      bool skipValue();
+
+      // returns the next value exactly as written (e.g. to hand a sub-object
+      // which has no streaming reader to the Element parser)
+      bool readRaw(String &outValue);
+
+      // lists follow the Element layout, i.e. {"itemName":[...]} or
+      // {"itemName":{...}} for a single item; the callback reads one item
+      template <typename Callback>
+      void readList(
+                    const char *itemName,
+                    Callback callback
+                    )
+      {
+        if (!isNext('{')) {
+          skipValue();
+          return;
+        }
+
+        beginObject();
+
+        String name;
+        while (nextMember(name)) {
+          if (name != itemName) {
+            skipValue();
+            continue;
+          }
+
+          if (isNext('[')) {
+            beginArray();
+            while (nextItem()) {
+              callback();
+            }
+            continue;
+          }
+
+          callback();
+        }
+      }
+
+    protected:
+      static bool isDelimiter(char ch);
+      void skipWhitespace();
+      bool readHex4(DWORD &outValue);
+      static void appendUTF8(String &output, DWORD codePoint);
+      bool readString(String &outValue);
+
+    protected:
+      const char *mPos {};
+      bool mFailed {false};
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPTypesSerializer
+    #pragma mark
+
+    // Serializes RTP parameters and capabilities without building a zsLib
+    // Element tree. The JSON form is accepted by the Element based
+    // constructors (and vice versa); the binary form is a compact encoding
+    // meant for server to server signaling between nodes running the same
+    // encoding version.
+    class RTPTypesSerializer
+    {
+    public:
+      ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::Parameters, Parameters)
+      ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::Capabilities, Capabilities)
+
+      enum BinaryTypes
+      {
+        BinaryType_Parameters =   1,
+        BinaryType_Capabilities = 2,
+      };
+
+      static const BYTE kBinaryVersion = 1;
+
+      // writes the object body (i.e. "{...}") so it can be embedded inside a
+      // larger streamed document
+      static void writeJSON(
+                            std::string &output,
+                            const Parameters &params
+                            );
+      static void writeJSON(
+                            std::string &output,
+                            const Capabilities &capabilities
+                            );
+
+      // writes a complete document wrapped in the named root object (or just
+      // the object body when no name is given)
+      static String toJSON(
+                           const Parameters &params,
+                           const char *objectName = "parameters"
+                           );
+      static String toJSON(
+                           const Capabilities &capabilities,
+                           const char *objectName = "capabilities"
+                           );
+
+      // a NULL object name parses the object body directly
+      static ParametersPtr createParametersFromJSON(
+                                                    const char *json,
+                                                    const char *objectName = "parameters"
+                                                    );
+      static CapabilitiesPtr createCapabilitiesFromJSON(
+                                                        const char *json,
+                                                        const char *objectName = "capabilities"
+                                                        );
+
+      // reads an object body written by writeJSON() (or by createElement()
+      // and the zsLib JSON generator) from the reader's current position
+      static bool readJSON(
+                           RTPTypesJSONReader &reader,
+                           Parameters &outParams
+                           );
+      static bool readJSON(
+                           RTPTypesJSONReader &reader,
+                           Capabilities &outCapabilities
+                           );
+
+      // building blocks for streaming documents that embed RTP parameters
+      // or capabilities (e.g. session descriptions)
+      static void writeJSONString(
+                                  std::string &output,
+                                  const char *value
+                                  );
+      static void writeJSONName(
+                                std::string &output,
+                                bool &ioFirst,
+                                const char *name
+                                );
+
+      // lists mirror the Element layout, i.e. {"listName":{"itemName":[...]}}
+      // where a single item is written as a plain object rather than an array
+      template <typename List, typename Writer>
+      static void writeJSONList(
+                                std::string &output,
+                                bool &ioFirst,
+                                const char *listName,
+                                const char *itemName,
+                                const List &list,
+                                Writer writer
+                                )
+      {
+        if (list.size() < 1) return;
+
+        bool isArray = (list.size() > 1);
+
+        writeJSONName(output, ioFirst, listName);
+        output.append("{\"");
+        output.append(itemName);
+        output.append("\":");
+        if (isArray) output.append(1, '[');
+
+        bool firstItem = true;
+        for (auto iter = list.begin(); iter != list.end(); ++iter) {
+          if (!firstItem) output.append(1, ',');
+          firstItem = false;
+          writer(output, *iter);
+        }
+
+        if (isArray) output.append(1, ']');
+        output.append(1, '}');
+      }
+
+      static SecureByteBlockPtr encodeBinary(const Parameters &params);
+      static SecureByteBlockPtr encodeBinary(const Capabilities &capabilities);
+
+      static ParametersPtr decodeParameters(
+                                            const BYTE *buffer,
+                                            size_t bufferSizeInBytes
+                                            );
+      static CapabilitiesPtr decodeCapabilities(
+                                                const BYTE *buffer,
+                                                size_t bufferSizeInBytes
+                                                );
+
+      static Log::Params slog(const char *message);
+    };
+  }
+}
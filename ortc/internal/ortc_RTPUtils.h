@@ -81,6 +81,9 @@ namespace ortc
                             DWORD ntpLS
                             );
 
+      // middle 32 bits of the 64 bit NTP timestamp (as used by LSR/DLSR)
+      static DWORD timeToCompactNTP(const Time &time);
+
       static Log::Params slog(const char *message);
     };
 
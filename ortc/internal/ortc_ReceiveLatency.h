@@ -0,0 +1,266 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#pragma once
+
+#include <ortc/internal/types.h>
+
+#include <ortc/IReceiveLatency.h>
+
+#include <atomic>
+#include <list>
+
+#define ORTC_SETTING_RECEIVE_LATENCY_ENABLED "ortc/receive-latency/enabled"
+
+// histogram keeps 2^5 linear sub-buckets per power of two (~3% precision)
+// and tracks values up to 2^36 nanoseconds (~68 seconds)
+#define ORTC_RECEIVE_LATENCY_SUB_BUCKET_BITS 5
+#define ORTC_RECEIVE_LATENCY_MAX_VALUE_BITS 36
+
+namespace ortc
+{
+  namespace internal
+  {
+    ZS_DECLARE_INTERACTION_PTR(IReceiveLatencyForInternal);
+
+    void installReceiveLatencySettingsDefaults();
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ReceiveLatencyStamp
+    #pragma mark
+
+    // Carried with a packet across a queue hop (steady clock nanoseconds;
+    // zero when the packet was not being timed).
+    struct ReceiveLatencyStamp
+    {
+      ULONGLONG mReceived {};
+      ULONGLONG mQueued {};
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IReceiveLatencyForInternal
+    #pragma mark
+
+    interaction IReceiveLatencyForInternal
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IReceiveLatencyForInternal, ForInternal);
+
+      typedef IReceiveLatencyTypes::Stages Stages;
+
+      // packet was read from a socket (starts timing on this thread)
+      static void received();
+
+      // packet reached a stage on the thread that read it
+      static void stage(Stages stage);
+
+      // packet is being handed to another queue
+      static ReceiveLatencyStamp queued();
+
+      // packet was picked up from a queue
+      static void dequeued(const ReceiveLatencyStamp &stamp);
+
+      // socket read handling is complete (stops timing on this thread)
+      static void finished();
+
+      virtual ~IReceiveLatencyForInternal() {}
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ReceiveLatencyScope
+    #pragma mark
+
+    class ReceiveLatencyScope
+    {
+    public:
+      ReceiveLatencyScope() {}
+      ~ReceiveLatencyScope()                  {IReceiveLatencyForInternal::finished();}
+
+      void received()                         {IReceiveLatencyForInternal::received();}
+
+    private:
+      ReceiveLatencyScope(const ReceiveLatencyScope &) = delete;
+      ReceiveLatencyScope &operator=(const ReceiveLatencyScope &) = delete;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ReceiveLatencyHistogram
+    #pragma mark
+
+    // Log-linear (HDR style) histogram of nanosecond values. Written by a
+    // single thread without read-modify-write atomics; read by any thread.
+    class ReceiveLatencyHistogram
+    {
+    public:
+      enum
+      {
+        SubBucketBits = ORTC_RECEIVE_LATENCY_SUB_BUCKET_BITS,
+        SubBucketCount = (1 << SubBucketBits),
+        MaxValueBits = ORTC_RECEIVE_LATENCY_MAX_VALUE_BITS,
+        TotalBuckets = ((MaxValueBits - SubBucketBits + 1) * SubBucketCount),
+      };
+
+      struct Values
+      {
+        ULONGLONG mCounts[TotalBuckets] {};
+        ULONGLONG mTotal {};
+        ULONGLONG mSum {};
+        ULONGLONG mMin {};
+        ULONGLONG mMax {};
+
+        void add(const Values &values);
+        ULONGLONG percentile(double fraction) const;
+      };
+
+    public:
+      void record(ULONGLONG value);
+      void get(Values &outValues) const;
+      void reset();
+
+      static size_t toBucket(ULONGLONG value);
+      static ULONGLONG fromBucket(size_t bucket);
+
+    protected:
+      std::atomic<DWORD> mCounts[TotalBuckets] {};
+      std::atomic<ULONGLONG> mTotal {};
+      std::atomic<ULONGLONG> mSum {};
+      std::atomic<ULONGLONG> mMin {};
+      std::atomic<ULONGLONG> mMax {};
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ReceiveLatency
+    #pragma mark
+
+    class ReceiveLatency : public IReceiveLatencyForInternal
+    {
+    protected:
+      struct make_private {};
+
+    public:
+      friend interaction IReceiveLatency;
+      friend interaction IReceiveLatencyForInternal;
+
+      typedef IReceiveLatencyTypes::Stages Stages;
+      typedef IReceiveLatencyTypes::StageStats StageStats;
+      typedef IReceiveLatencyTypes::StageStatsList StageStatsList;
+      typedef IReceiveLatencyTypes::StageStatsListPtr StageStatsListPtr;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ReceiveLatency::ThreadHistograms
+      #pragma mark
+
+      struct ThreadHistograms
+      {
+        String mThread;
+        ReceiveLatencyHistogram mStages[IReceiveLatencyTypes::Stage_Last + 1];
+      };
+
+      ZS_DECLARE_PTR(ThreadHistograms);
+      typedef std::list<ThreadHistogramsPtr> ThreadHistogramsList;
+
+    public:
+      ReceiveLatency(const make_private &);
+
+    protected:
+      void init();
+
+    public:
+      virtual ~ReceiveLatency();
+
+      static ReceiveLatencyPtr singleton();
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ReceiveLatency => IReceiveLatency
+      #pragma mark
+
+      ElementPtr toDebug() const;
+
+      static void enable(bool enabled);
+      static bool isEnabled();
+
+      StageStatsListPtr getStats(bool perThread) const;
+
+      void reset();
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ReceiveLatency => (internal)
+      #pragma mark
+
+      static Log::Params slog(const char *message);
+
+      static ThreadHistograms *getThreadHistograms();
+      ThreadHistogramsPtr registerThread();
+
+      static void fill(
+                       StageStats &outStats,
+                       const ReceiveLatencyHistogram::Values &values
+                       );
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ReceiveLatency => (data)
+      #pragma mark
+
+      ReceiveLatencyWeakPtr mThisWeak;
+
+      mutable Lock mLock;
+
+      ThreadHistogramsList mThreads;
+      size_t mNextThreadIndex {};
+    };
+  }
+}
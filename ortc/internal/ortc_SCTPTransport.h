@@ -48,6 +48,7 @@
 #include <queue>
 
 #define ORTC_SETTING_SCTP_TRANSPORT_MAX_SESSIONS_PER_PORT "ortc/sctp/max-sessions-per-port"
+#define ORTC_SETTING_SCTP_TRANSPORT_TOTAL_SHARDS "ortc/sctp/total-shards"
 
 namespace ortc
 {
@@ -139,6 +140,32 @@ namespace ortc
       ElementPtr toDebug() const;
     };
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SCTPShardAllocator
+    #pragma mark
+
+    // Counts the associations bound to each shard so a new association is
+    // placed on the least loaded shard (lowest index wins a tie); the caller
+    // is responsible for locking.
+    class SCTPShardAllocator
+    {
+    public:
+      SCTPShardAllocator(size_t totalShards = 0);
+
+      size_t allocate();
+      bool release(size_t shardIndex);
+
+      size_t totalShards() const {return mAssociations.size();}
+      size_t totalAssociations(size_t shardIndex) const;
+
+    protected:
+      std::vector<size_t> mAssociations;
+    };
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -577,6 +604,8 @@ namespace ortc
       void setState(InternalStates state);
       void setError(WORD error, const char *reason = NULL);
 
+      void closeSocket();
+
       bool openConnectSCTPSocket();
       bool openSCTPSocket();
       bool prepareSocket(struct socket *sock);
@@ -617,6 +646,7 @@ namespace ortc
       SCTPTransportPtr mGracefulShutdownReference;
 
       SCTPInitPtr mSCTPInit;
+      Optional<size_t> mShardIndex;
       size_t mMaxSessionsPerPort {};
 
       ISCTPTransportDelegateSubscriptions mSubscriptions;
@@ -643,6 +673,13 @@ namespace ortc
 
       struct socket *mSocket {};
 
+      // usrsctp_conninput() runs outside the object lock; each call holds a
+      // registration reference so shutdown defers closing the socket and
+      // deregistering the address until the last in-flight input returns
+      std::atomic<size_t> mInputsInFlight {};
+      std::atomic<bool> mSocketClosePending {false};
+      struct socket *mClosingSocket {};
+
       WORD mLocalPort {};
       Optional<WORD> mAllocatedLocalPort {};
       Optional<WORD> mRemotePort {};
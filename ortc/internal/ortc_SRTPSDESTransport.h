@@ -260,6 +260,12 @@ namespace ortc
                                        size_t bufferLengthInBytes
                                        ) override;
 
+      virtual bool sendEncryptedPackets(
+                                        IICETypes::Components sendOverICETransport,
+                                        IICETypes::Components packetType,
+                                        const PacketBufferRefList &packets
+                                        ) override;
+
       virtual bool handleReceivedDecryptedPacket(
                                                  IICETypes::Components viaTransport,
                                                  IICETypes::Components packetType,
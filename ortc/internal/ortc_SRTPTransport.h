@@ -34,6 +34,7 @@
 #include <ortc/internal/types.h>
 #include <ortc/internal/ortc_ISRTPTransport.h>
 #include <ortc/internal/ortc_ISecureTransport.h>
+#include <ortc/internal/ortc_RTCPAggregator.h>
 
 #include <zsLib/MessageQueueAssociator.h>
 #include <zsLib/ITimer.h>
@@ -45,6 +46,14 @@ struct srtp_policy_t;
 
 //#define ORTC_SETTING_SRTP_TRANSPORT_WARN_OF_KEY_LIFETIME_EXHAUGSTION_WHEN_REACH_PERCENTAGE_USSED "ortc/srtp/warm-key-lifetime-exhaustion-when-reach-percentage-used"
 
+#define ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_ENABLED "ortc/srtp/rtcp-aggregation/enabled"
+#define ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_MAX_PACKET_SIZE "ortc/srtp/rtcp-aggregation/max-packet-size"
+#define ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_MAX_DELAY_IN_MILLISECONDS "ortc/srtp/rtcp-aggregation/max-delay-in-milliseconds"
+#define ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_MAX_TIMING_REPORT_DELAY_IN_MILLISECONDS "ortc/srtp/rtcp-aggregation/max-timing-report-delay-in-milliseconds"
+#define ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_MAX_BANDWIDTH_DELAY_IN_MILLISECONDS "ortc/srtp/rtcp-aggregation/max-bandwidth-delay-in-milliseconds"
+#define ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_BANDWIDTH_PERCENTAGE "ortc/srtp/rtcp-aggregation/bandwidth-percentage"
+#define ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_MIN_BANDWIDTH_BYTES_PER_SECOND "ortc/srtp/rtcp-aggregation/min-bandwidth-bytes-per-second"
+
 #pragma warning(push)
 #pragma warning(disable:4351)
 
@@ -119,6 +128,12 @@ namespace ortc
                               const BYTE *buffer,
                               size_t bufferLengthInBytes
                               ) = 0;
+
+      virtual bool sendPackets(
+                               IICETypes::Components sendOverICETransport,
+                               IICETypes::Components component,
+                               const PacketBufferRefList &packets
+                               ) = 0;
     };
 
     //-------------------------------------------------------------------------
@@ -237,6 +252,12 @@ namespace ortc
                               size_t bufferLengthInBytes
                               ) override;
 
+      virtual bool sendPackets(
+                               IICETypes::Components sendOverICETransport,
+                               IICETypes::Components component,
+                               const PacketBufferRefList &packets
+                               ) override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark SRTPTransport => IWakeDelegate
@@ -276,6 +297,40 @@ namespace ortc
                               KeyingMaterialPtr &keyingMaterial
                               );
 
+      bool selectEncryptionKey(
+                               IICETypes::Components packetType,
+                               size_t bufferLengthInBytes,
+                               KeyingMaterialPtr &outKeyingMaterial
+                               );
+
+      SecureByteBlockPtr protect(
+                                 IICETypes::Components packetType,
+                                 KeyingMaterialPtr keyingMaterial,
+                                 const BYTE *buffer,
+                                 size_t bufferLengthInBytes
+                                 );
+
+      bool protectAndSendPacket(
+                                IICETypes::Components sendOverICETransport,
+                                IICETypes::Components packetType,
+                                const BYTE *buffer,
+                                size_t bufferLengthInBytes
+                                );
+
+      bool protectAndSendPackets(
+                                 IICETypes::Components sendOverICETransport,
+                                 IICETypes::Components packetType,
+                                 const PacketBufferRefList &packets
+                                 );
+
+      bool queueRTCPPacket(
+                           IICETypes::Components sendOverICETransport,
+                           const BYTE *buffer,
+                           size_t bufferLengthInBytes
+                           );
+      void flushRTCPPackets(bool onlyIfDue);
+      void scheduleRTCPFlush();
+
       static size_t parseLifetime(const String &lifetime) throw(InvalidParameters);
 
       static SecureByteBlockPtr convertIntegerToBigEndianEncodedBuffer(
@@ -361,6 +416,12 @@ namespace ortc
       DirectionMaterial mMaterial[Direction_Last+1];
 
       SRTPInitPtr mSRTPInit;
+
+      bool mRTCPAggregationEnabled {};
+      RTCPAggregator::Settings mRTCPAggregatorSettings;
+      RTCPAggregatorPtr mRTCPAggregators[IICETypes::Component_Last+1];  // indexed by the component the RTCP is sent over
+      ITimerPtr mRTCPFlushTimer;
+      Time mRTCPFlushTime;
     };
 
     //-------------------------------------------------------------------------
@@ -0,0 +1,368 @@
+/*
+
+ Copyright (c) 2015, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#pragma once
+
+#include <ortc/internal/types.h>
+
+#include <ortc/IStatsCounters.h>
+
+#include <zsLib/MessageQueueAssociator.h>
+#include <zsLib/ITimer.h>
+#include <zsLib/Singleton.h>
+
+#include <atomic>
+#include <vector>
+
+#define ORTC_SETTING_STATS_COUNTERS_MAX_OBJECTS "ortc/stats-counters/max-objects"
+#define ORTC_SETTING_STATS_COUNTERS_EXPORT_INTERVAL_IN_MILLISECONDS "ortc/stats-counters/export-interval-in-milliseconds"
+#define ORTC_SETTING_STATS_COUNTERS_EXPORT_FORMAT "ortc/stats-counters/export-format"
+#define ORTC_SETTING_STATS_COUNTERS_FULL_EXPORT_EVERY "ortc/stats-counters/full-export-every"
+
+#define ORTC_STATS_COUNTERS_CACHE_LINE_SIZE 64
+
+namespace ortc
+{
+  namespace internal
+  {
+    ZS_DECLARE_CLASS_PTR(StatsCounters);
+    ZS_DECLARE_CLASS_PTR(StatsCountersHandle);
+
+    ZS_DECLARE_INTERACTION_PTR(IStatsCountersForInternal);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsCountersSlot
+    #pragma mark
+
+    // One slot per registered object; slots are cache line aligned so that
+    // objects updated from different packet threads never share a line.
+    struct alignas(ORTC_STATS_COUNTERS_CACHE_LINE_SIZE) StatsCountersSlot
+    {
+      std::atomic<PUID> mObjectID {};
+      std::atomic<int> mStatsType {};
+      std::atomic<QWORD> mCounters[IStatsCountersTypes::Counter_Last + 1];
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsCountersHandle
+    #pragma mark
+
+    class StatsCountersHandle
+    {
+    public:
+      typedef IStatsCountersTypes::Counters Counters;
+
+    public:
+      StatsCountersHandle(
+                          StatsCountersPtr owner,
+                          StatsCountersSlot *slot,
+                          size_t index
+                          );
+      ~StatsCountersHandle();
+
+      PUID objectID() const                             {return mSlot->mObjectID.load(std::memory_order_relaxed);}
+
+      void increment(
+                     Counters counter,
+                     QWORD value = 1
+                     )                                  {mSlot->mCounters[counter].fetch_add(value, std::memory_order_relaxed);}
+      void set(
+               Counters counter,
+               QWORD value
+               )                                        {mSlot->mCounters[counter].store(value, std::memory_order_relaxed);}
+      void setSigned(
+                     Counters counter,
+                     long long value
+                     )                                  {mSlot->mCounters[counter].store(static_cast<QWORD>(value), std::memory_order_relaxed);}
+      QWORD get(Counters counter) const                 {return mSlot->mCounters[counter].load(std::memory_order_relaxed);}
+
+    protected:
+      StatsCountersPtr mOwner;
+      StatsCountersSlot *mSlot {};
+      size_t mIndex {};
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IStatsCountersForInternal
+    #pragma mark
+
+    interaction IStatsCountersForInternal
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IStatsCountersForInternal, ForInternal);
+
+      typedef IStatsReportTypes::StatsTypes StatsTypes;
+
+      // returns null if the registry is full (in which case the object simply
+      // does not report counters)
+      static StatsCountersHandlePtr registerObject(
+                                                   PUID objectID,
+                                                   StatsTypes statsType
+                                                   );
+
+      virtual ~IStatsCountersForInternal() {}
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsCounters
+    #pragma mark
+
+    class StatsCounters : public Noop,
+                          public MessageQueueAssociator,
+                          public SharedRecursiveLock,
+                          public IStatsCounters,
+                          public IStatsCountersForInternal,
+                          public zsLib::ITimerDelegate,
+                          public ISingletonManagerDelegate
+    {
+    protected:
+      struct make_private {};
+
+    public:
+      friend interaction IStatsCounters;
+      friend interaction IStatsCountersFactory;
+      friend interaction IStatsCountersForInternal;
+      friend class StatsCountersHandle;
+
+      typedef IStatsCountersTypes::Counters Counters;
+      typedef IStatsCountersTypes::ExportFormats ExportFormats;
+      typedef IStatsReportTypes::StatsTypes StatsTypes;
+
+      typedef size_t SlotIndex;
+      typedef std::vector<SlotIndex> SlotIndexList;
+
+      struct ObjectValues
+      {
+        PUID mObjectID {};
+        StatsTypes mStatsType {IStatsReportTypes::StatsType_First};
+        QWORD mValues[IStatsCountersTypes::Counter_Last + 1] {};
+      };
+      typedef std::vector<ObjectValues> ObjectValuesList;
+
+      struct ExportEntry
+      {
+        PUID mObjectID {};
+        StatsTypes mStatsType {IStatsReportTypes::StatsType_First};
+        long long mValues[IStatsCountersTypes::Counter_Last + 1] {};
+      };
+      typedef std::vector<ExportEntry> ExportEntryList;
+      typedef std::vector<PUID> PUIDList;
+
+    public:
+      StatsCounters(
+                    const make_private &,
+                    IMessageQueuePtr queue
+                    );
+
+    protected:
+      StatsCounters(Noop) :
+        Noop(true),
+        MessageQueueAssociator(IMessageQueuePtr()),
+        SharedRecursiveLock(SharedRecursiveLock::create())
+      {}
+
+      void init();
+
+      static StatsCountersPtr create();
+      static StatsCountersPtr singleton();
+
+    public:
+      virtual ~StatsCounters();
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark StatsCounters => IStatsCounters
+      #pragma mark
+
+      static ElementPtr singletonToDebug();
+
+      static IStatsCountersSubscriptionPtr subscribe(IStatsCountersDelegatePtr delegate);
+
+      static SecureByteBlockPtr snapshot(ExportFormats format);
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark StatsCounters => IStatsCountersForInternal
+      #pragma mark
+
+      static StatsCountersHandlePtr registerObject(
+                                                   PUID objectID,
+                                                   StatsTypes statsType
+                                                   );
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark StatsCounters => ITimerDelegate
+      #pragma mark
+
+      virtual void onTimer(ITimerPtr timer) override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark StatsCounters => ISingletonManagerDelegate
+      #pragma mark
+
+      virtual void notifySingletonCleanup() override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark StatsCounters => friend StatsCountersHandle
+      #pragma mark
+
+      void releaseSlot(SlotIndex index);
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark StatsCounters => (internal)
+      #pragma mark
+
+      Log::Params log(const char *message) const;
+      static Log::Params slog(const char *message);
+      Log::Params debug(const char *message) const;
+      virtual ElementPtr toDebug() const;
+
+      void cancel();
+
+      void startExportTimer();
+
+      StatsCountersHandlePtr allocateSlot(
+                                          PUID objectID,
+                                          StatsTypes statsType
+                                          );
+
+      void collect(ObjectValuesList &outValues) const;
+
+      void calculateExport(
+                           const ObjectValuesList &current,
+                           const ObjectValuesList *previous,
+                           ExportEntryList &outEntries,
+                           PUIDList &outRemoved
+                           ) const;
+
+      SecureByteBlockPtr encode(
+                                ExportFormats format,
+                                bool delta,
+                                DWORD sequence,
+                                const ExportEntryList &entries,
+                                const PUIDList &removed
+                                ) const;
+
+      static SecureByteBlockPtr encodeBinary(
+                                             bool delta,
+                                             DWORD sequence,
+                                             const ExportEntryList &entries,
+                                             const PUIDList &removed
+                                             );
+
+      static SecureByteBlockPtr encodeJSON(
+                                           bool delta,
+                                           DWORD sequence,
+                                           const ExportEntryList &entries,
+                                           const PUIDList &removed
+                                           );
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark StatsCounters => (data)
+      #pragma mark
+
+      AutoPUID mID;
+      StatsCountersWeakPtr mThisWeak;
+
+      IStatsCountersDelegateSubscriptions mSubscriptions;
+
+      BYTE *mSlotAllocation {};
+      StatsCountersSlot *mSlots {};
+      size_t mTotalSlots {};
+      std::atomic<size_t> mHighWaterSlot {};
+      SlotIndexList mFreeSlots;
+
+      Milliseconds mExportInterval {};
+      ITimerPtr mExportTimer;
+      ExportFormats mExportFormat {IStatsCountersTypes::ExportFormat_Binary};
+      size_t mFullExportEvery {};
+      size_t mExportsSinceFull {};
+      bool mForceFullExport {true};
+      DWORD mExportSequence {};
+
+      ObjectValuesList mPreviousExport;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IStatsCountersFactory
+    #pragma mark
+
+    interaction IStatsCountersFactory
+    {
+      typedef IStatsCountersTypes::ExportFormats ExportFormats;
+      typedef IStatsReportTypes::StatsTypes StatsTypes;
+
+      static IStatsCountersFactory &singleton();
+
+      virtual StatsCountersPtr create();
+
+      virtual ElementPtr singletonToDebug();
+
+      virtual IStatsCountersSubscriptionPtr subscribe(IStatsCountersDelegatePtr delegate);
+
+      virtual SecureByteBlockPtr snapshot(ExportFormats format);
+
+      virtual StatsCountersHandlePtr registerObject(
+                                                    PUID objectID,
+                                                    StatsTypes statsType
+                                                    );
+    };
+
+    class StatsCountersFactory : public IFactory<IStatsCountersFactory> {};
+  }
+}
@@ -0,0 +1,309 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#pragma once
+
+#include <ortc/internal/types.h>
+
+#include <zsLib/Singleton.h>
+
+#include <webrtc/video_frame.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define ORTC_SETTING_SYNTHETIC_MEDIA_SOURCE_MAX_PRELOAD_VIDEO_FRAMES "ortc/synthetic-media-source/max-preload-video-frames"
+#define ORTC_SETTING_SYNTHETIC_MEDIA_SOURCE_MAX_PRELOAD_AUDIO_SECONDS "ortc/synthetic-media-source/max-preload-audio-seconds"
+
+namespace ortc
+{
+  namespace internal
+  {
+    ZS_DECLARE_CLASS_PTR(SyntheticMediaSource);
+
+    ZS_DECLARE_INTERACTION_PTR(ISyntheticMediaSourceSink);
+    ZS_DECLARE_INTERACTION_PTR(ISyntheticMediaSourceForDeviceResource);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ISyntheticMediaSourceSink
+    #pragma mark
+
+    interaction ISyntheticMediaSourceSink
+    {
+      ZS_DECLARE_TYPEDEF_PTR(webrtc::VideoFrame, VideoFrame)
+
+      // called from the source's pacing thread; the frame buffer is shared
+      // by every sink attached to the source and must not be modified
+      virtual void onSyntheticVideoFrame(VideoFramePtr frame) = 0;
+
+      // called from the source's pacing thread with 10ms of interleaved
+      // 16-bit PCM samples
+      virtual void onSyntheticAudioSamples(
+                                           const int16_t *samples,
+                                           size_t samplesPerChannel,
+                                           size_t channels,
+                                           ULONG sampleRate
+                                           ) = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ISyntheticMediaSourceForDeviceResource
+    #pragma mark
+
+    interaction ISyntheticMediaSourceForDeviceResource
+    {
+      ZS_DECLARE_TYPEDEF_PTR(ISyntheticMediaSourceForDeviceResource, ForDeviceResource)
+      ZS_DECLARE_TYPEDEF_PTR(ISyntheticMediaSourceSink, UseSink)
+
+      static ElementPtr toDebug(ForDeviceResourcePtr source);
+
+      // device IDs of the form "synthetic:<type>?<name>=<value>&..." where
+      // type is one of:
+      //   video-pattern  width, height, fps
+      //   video-file     path, fps (y4m header or width/height for raw I420)
+      //   audio-tone     frequency, rate, channels
+      //   audio-file     path (16-bit PCM wav or rate/channels for raw PCM)
+      static bool isSyntheticDeviceID(const String &deviceID);
+
+      // returns the already running source for the device ID if one exists
+      // so all tracks opened against the same ID share one decoded buffer;
+      // returns null if the device ID cannot be parsed or loaded
+      static ForDeviceResourcePtr open(const String &deviceID);
+
+      virtual PUID getID() const = 0;
+
+      virtual IMediaStreamTrackTypes::Kinds kind() const = 0;
+
+      virtual ULONG width() const = 0;
+      virtual ULONG height() const = 0;
+      virtual double frameRate() const = 0;
+
+      virtual ULONG sampleRate() const = 0;
+      virtual size_t channels() const = 0;
+
+      virtual void attach(
+                          PUID sinkID,
+                          UseSinkPtr sink
+                          ) = 0;
+      virtual void detach(PUID sinkID) = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SyntheticMediaSourceSettingsDefaults
+    #pragma mark
+
+    void installSyntheticMediaSourceSettingsDefaults();
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SyntheticMediaSource
+    #pragma mark
+
+    class SyntheticMediaSource : public SharedRecursiveLock,
+                                 public ISyntheticMediaSourceForDeviceResource
+    {
+    protected:
+      struct make_private {};
+
+    public:
+      friend interaction ISyntheticMediaSourceForDeviceResource;
+
+      ZS_DECLARE_TYPEDEF_PTR(IMediaStreamTrackTypes::Kinds, Kinds)
+      ZS_DECLARE_TYPEDEF_PTR(webrtc::VideoFrame, VideoFrame)
+      ZS_DECLARE_TYPEDEF_PTR(ISyntheticMediaSourceSink, UseSink)
+
+      enum SourceTypes
+      {
+        SourceType_First,
+
+        SourceType_VideoPattern = SourceType_First,
+        SourceType_VideoFile,
+        SourceType_AudioTone,
+        SourceType_AudioFile,
+
+        SourceType_Last = SourceType_AudioFile,
+      };
+
+      static const char *toString(SourceTypes type);
+      static SourceTypes toSourceType(const char *type) throw (InvalidParameters);
+
+      typedef std::map<String, String> ParameterMap;
+
+      typedef rtc::scoped_refptr<webrtc::VideoFrameBuffer> VideoFrameBufferPtr;
+      typedef std::vector<VideoFrameBufferPtr> VideoFrameBufferList;
+      typedef std::vector<int16_t> SampleBuffer;
+
+      typedef std::map<PUID, UseSinkWeakPtr> SinkMap;
+      ZS_DECLARE_PTR(SinkMap)
+
+      typedef std::map<String, SyntheticMediaSourceWeakPtr> SourceMap;
+
+      typedef std::atomic<bool> StopFlag;
+      ZS_DECLARE_PTR(StopFlag)
+
+    public:
+      SyntheticMediaSource(
+                           const make_private &,
+                           const String &deviceID,
+                           SourceTypes type,
+                           const ParameterMap &params
+                           );
+
+    protected:
+      void init();
+
+    public:
+      virtual ~SyntheticMediaSource();
+
+      static SyntheticMediaSourcePtr convert(ForDeviceResourcePtr object);
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark SyntheticMediaSource => ISyntheticMediaSourceForDeviceResource
+      #pragma mark
+
+      static ElementPtr toDebug(SyntheticMediaSourcePtr source);
+
+      static SyntheticMediaSourcePtr open(const String &deviceID);
+
+      virtual PUID getID() const override {return mID;}
+
+      virtual Kinds kind() const override;
+
+      virtual ULONG width() const override {return mWidth;}
+      virtual ULONG height() const override {return mHeight;}
+      virtual double frameRate() const override {return mFrameRate;}
+
+      virtual ULONG sampleRate() const override {return mSampleRate;}
+      virtual size_t channels() const override {return mChannels;}
+
+      virtual void attach(
+                          PUID sinkID,
+                          UseSinkPtr sink
+                          ) override;
+      virtual void detach(PUID sinkID) override;
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark SyntheticMediaSource => (internal)
+      #pragma mark
+
+      static Log::Params slog(const char *message);
+      Log::Params log(const char *message) const;
+      Log::Params debug(const char *message) const;
+      virtual ElementPtr toDebug() const;
+
+      static bool parseDeviceID(
+                                const String &deviceID,
+                                SourceTypes &outType,
+                                ParameterMap &outParams
+                                );
+      static String getParam(
+                             const ParameterMap &params,
+                             const char *name
+                             );
+      template <typename T>
+      static T getParam(
+                        const ParameterMap &params,
+                        const char *name,
+                        T defaultValue
+                        );
+
+      bool isVideo() const;
+
+      bool loadVideoPattern();
+      bool loadVideoFile();
+      bool loadAudioTone();
+      bool loadAudioFile();
+
+      void start();                         // must be called within lock
+      void stop(std::thread &outThread);    // must be called within lock
+      static void join(std::thread &thread);
+
+      void runVideo(const StopFlag &shouldStop);
+      void runAudio(const StopFlag &shouldStop);
+
+      SinkMapPtr sinks() const;
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark SyntheticMediaSource => (data)
+      #pragma mark
+
+      AutoPUID mID;
+      SyntheticMediaSourceWeakPtr mThisWeak;
+
+      String mDeviceID;
+      SourceTypes mType {SourceType_First};
+      ParameterMap mParams;
+
+      bool mLoaded {false};
+
+      ULONG mWidth {};
+      ULONG mHeight {};
+      double mFrameRate {};
+      VideoFrameBufferList mFrames;             // decoded once, shared by every sink
+
+      ULONG mSampleRate {};
+      size_t mChannels {};
+      SampleBuffer mSamples;                    // interleaved, decoded once, shared by every sink
+
+      SinkMapPtr mSinks;                        // using COW pattern, always valid ptr
+
+      StopFlagPtr mShouldStop;                  // one per pacing thread run
+      std::thread mThread;                      // pacing thread, runs only while sinks are attached (and holds a reference to the source)
+
+      std::atomic<ULONG> mFramesDelivered {};
+      std::atomic<ULONG> mLateDeadlines {};
+    };
+
+  }
+}
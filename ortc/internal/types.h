@@ -40,6 +40,8 @@
 #include <zsLib/IWakeDelegate.h>
 #include <zsLib/WeightedMovingAverage.h>
 
+#include <vector>
+
 namespace ortc
 {
   namespace internal
@@ -111,6 +113,10 @@ namespace ortc
 
     ZS_DECLARE_CLASS_PTR(RTPPacket);
     ZS_DECLARE_CLASS_PTR(RTCPPacket);
+    ZS_DECLARE_CLASS_PTR(RTCPAggregator);
+    ZS_DECLARE_CLASS_PTR(RTPPacketHistory);
+    ZS_DECLARE_CLASS_PTR(RTPContributingSourceTable);
+    ZS_DECLARE_CLASS_PTR(RTPTypesSerializer);
 
     ZS_DECLARE_INTERACTION_PTR(IDataTransportForSecureTransport);
     ZS_DECLARE_INTERACTION_PTR(ISecureTransport);
@@ -125,6 +131,7 @@ namespace ortc
     ZS_DECLARE_CLASS_PTR(DataChannel);
     ZS_DECLARE_CLASS_PTR(DTMFSender);
     ZS_DECLARE_CLASS_PTR(DTLSTransport);
+    ZS_DECLARE_CLASS_PTR(EventTrace);
     ZS_DECLARE_CLASS_PTR(ICEGatherer);
     ZS_DECLARE_CLASS_PTR(ICEGathererRouter);
     ZS_DECLARE_CLASS_PTR(ICETransport);
@@ -132,6 +139,8 @@ namespace ortc
     ZS_DECLARE_CLASS_PTR(Identity);
     ZS_DECLARE_CLASS_PTR(MediaDevices);
     ZS_DECLARE_CLASS_PTR(MediaStreamTrack);
+    ZS_DECLARE_CLASS_PTR(ReceiveLatency);
+    ZS_DECLARE_CLASS_PTR(RTPForwarder);
     ZS_DECLARE_CLASS_PTR(RTPListener);
     ZS_DECLARE_CLASS_PTR(RTPMediaEngine);
     ZS_DECLARE_CLASS_PTR(RTPReceiver);
@@ -146,11 +155,31 @@ namespace ortc
     ZS_DECLARE_CLASS_PTR(SCTPTransport);
     ZS_DECLARE_CLASS_PTR(SRTPSDESTransport);
     ZS_DECLARE_CLASS_PTR(SRTPTransport);
+    ZS_DECLARE_CLASS_PTR(SyntheticMediaSource);
 
     ZS_DECLARE_INTERACTION_PROXY(ISecureTransportDelegate);
     ZS_DECLARE_INTERACTION_PROXY(ISRTPTransportDelegate);
 
     ZS_DECLARE_INTERACTION_PROXY_SUBSCRIPTION(ISRTPTransportSubscription, ISRTPTransportDelegate);
     ZS_DECLARE_INTERACTION_PROXY_SUBSCRIPTION(ISecureTransportSubscription, ISecureTransportDelegate);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (packet batches)
+    #pragma mark
+
+    // A batch of outgoing packets passed through the secure / ICE transport
+    // layers in a single call; the referenced buffers are owned by the
+    // caller and must remain valid until the send call returns.
+    struct PacketBufferRef
+    {
+      const BYTE *mBuffer {};
+      size_t mSize {};
+    };
+
+    typedef std::vector<PacketBufferRef> PacketBufferRefList;
   }
 }
@@ -47,11 +47,14 @@
 #include <ortc/IICETransportController.h>
 #include <ortc/IMediaDevices.h>
 #include <ortc/IMediaStreamTrack.h>
+#include <ortc/IReceiveLatency.h>
 #include <ortc/IRTPTypes.h>
+#include <ortc/IRTPForwarder.h>
 #include <ortc/IRTPListener.h>
 #include <ortc/IRTPSender.h>
 #include <ortc/IRTPReceiver.h>
 #include <ortc/ISCTPTransport.h>
 #include <ortc/ISRTPSDESTransport.h>
+#include <ortc/IStatsCounters.h>
 #include <ortc/IStatsProvider.h>
 #include <ortc/IStatsReport.h>
@@ -316,6 +316,16 @@ namespace ortc
           return true;
         }
 
+        //---------------------------------------------------------------------
+        virtual bool sendPackets(const ortc::internal::PacketBufferRefList &packets) override
+        {
+          bool result = true;
+          for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+            if (!sendPacket((*iter).mBuffer, (*iter).mSize)) result = false;
+          }
+          return result;
+        }
+
         //---------------------------------------------------------------------
         #pragma mark
         #pragma mark FakeICETransport => IFakeICETransportAsyncDelegate
@@ -651,6 +661,10 @@ ZS_DECLARE_USING_PTR(ortc, IICETransport)
 using ortc::IICETypes;
 
 #define TEST_BASIC_CONNECTIVITY 0
+#define TEST_CONCURRENT_HANDSHAKES 1
+
+// more pairs than handshake pool threads so transports share pool queues
+#define TEST_CONCURRENT_HANDSHAKE_EXTRA_PAIRS 3
 
 
 void doTestDTLS()
@@ -670,6 +684,9 @@ void doTestDTLS()
   DTLSTesterPtr testDTLSObject1;
   DTLSTesterPtr testDTLSObject2;
 
+  std::vector<FakeICETransportPtr> extraFakeIceObjects;
+  std::vector<DTLSTesterPtr> extraTestDTLSObjects;
+
   TESTING_STDOUT() << "WAITING:      Waiting for DTLS testing to complete (max wait is 180 seconds).\n";
 
   // check to see if all DNS routines have resolved
@@ -713,6 +730,35 @@ void doTestDTLS()
           }
           break;
         }
+        case TEST_CONCURRENT_HANDSHAKES: {
+          {
+            // setup for test 1 (every pair handshakes at the same time
+            // through the shared DTLS handshake pool)
+            fakeIceObject1 = FakeICETransport::create(thread);
+            fakeIceObject2 = FakeICETransport::create(thread);
+
+            TESTING_CHECK(fakeIceObject1)
+            TESTING_CHECK(fakeIceObject2)
+
+            testDTLSObject1 = DTLSTester::create(thread, fakeIceObject1);
+            testDTLSObject2 = DTLSTester::create(thread, fakeIceObject2);
+
+            TESTING_CHECK(testDTLSObject1)
+            TESTING_CHECK(testDTLSObject2)
+
+            for (size_t index = 0; index < TEST_CONCURRENT_HANDSHAKE_EXTRA_PAIRS * 2; ++index) {
+              auto fakeIceObject = FakeICETransport::create(thread);
+              TESTING_CHECK(fakeIceObject)
+
+              auto testDTLSObject = DTLSTester::create(thread, fakeIceObject);
+              TESTING_CHECK(testDTLSObject)
+
+              extraFakeIceObjects.push_back(fakeIceObject);
+              extraTestDTLSObjects.push_back(testDTLSObject);
+            }
+          }
+          break;
+        }
         default:  quit = true; break;
       }
       if (quit) break;
@@ -720,6 +766,7 @@ void doTestDTLS()
       expecting = 0;
       expecting += (testDTLSObject1 ? 1 : 0);
       expecting += (testDTLSObject2 ? 1 : 0);
+      expecting += static_cast<ULONG>(extraTestDTLSObjects.size());
 
       ULONG found = 0;
       ULONG lastFound = 0;
@@ -735,21 +782,32 @@ void doTestDTLS()
         found = 0;
 
         switch (testNumber) {
-          case TEST_BASIC_CONNECTIVITY: {
+          case TEST_BASIC_CONNECTIVITY:
+          case TEST_CONCURRENT_HANDSHAKES: {
             switch (step) {
               case 2: {
                 if (fakeIceObject1) fakeIceObject1->state(IICETransport::State_Checking);
                 if (fakeIceObject2) fakeIceObject2->state(IICETransport::State_Checking);
+                for (auto iter = extraFakeIceObjects.begin(); iter != extraFakeIceObjects.end(); ++iter) {
+                  (*iter)->state(IICETransport::State_Checking);
+                }
                 break;
               }
               case 3: {
                 if (testDTLSObject1) testDTLSObject1->generateCertificate();
                 if (testDTLSObject2) testDTLSObject2->generateCertificate();
+                for (auto iter = extraTestDTLSObjects.begin(); iter != extraTestDTLSObjects.end(); ++iter) {
+                  (*iter)->generateCertificate();
+                }
                 break;
               }
               case 6: {
                 if (fakeIceObject1) fakeIceObject1->role(IICETypes::Role_Controlling);
                 if (fakeIceObject2) fakeIceObject1->role(IICETypes::Role_Controlled);
+                for (size_t index = 0; index + 1 < extraFakeIceObjects.size(); index += 2) {
+                  extraFakeIceObjects[index]->role(IICETypes::Role_Controlling);
+                  extraFakeIceObjects[index+1]->role(IICETypes::Role_Controlled);
+                }
                 break;
               }
               case 7: {
@@ -758,31 +816,55 @@ void doTestDTLS()
 
                 if (fakeIceObject1) fakeIceObject1->state(IICETransport::State_Connected);
                 if (fakeIceObject2) fakeIceObject2->state(IICETransport::State_Connected);
+
+                for (size_t index = 0; index + 1 < extraFakeIceObjects.size(); index += 2) {
+                  extraFakeIceObjects[index]->linkTransport(extraFakeIceObjects[index+1]);
+                  extraFakeIceObjects[index+1]->linkTransport(extraFakeIceObjects[index]);
+                }
+                for (auto iter = extraFakeIceObjects.begin(); iter != extraFakeIceObjects.end(); ++iter) {
+                  (*iter)->state(IICETransport::State_Connected);
+                }
                 break;
               }
               case 10: {
                 if (testDTLSObject1) testDTLSObject1->start(testDTLSObject2);
                 if (testDTLSObject2) testDTLSObject2->start(testDTLSObject1);
+                for (size_t index = 0; index + 1 < extraTestDTLSObjects.size(); index += 2) {
+                  extraTestDTLSObjects[index]->start(extraTestDTLSObjects[index+1]);
+                  extraTestDTLSObjects[index+1]->start(extraTestDTLSObjects[index]);
+                }
                 break;
               }
               case 20: {
                 if (fakeIceObject1) fakeIceObject1->state(IICETransport::State_Completed);
                 if (fakeIceObject2) fakeIceObject2->state(IICETransport::State_Completed);
+                for (auto iter = extraFakeIceObjects.begin(); iter != extraFakeIceObjects.end(); ++iter) {
+                  (*iter)->state(IICETransport::State_Completed);
+                }
                 break;
               }
               case 25: {
                 if (fakeIceObject1) fakeIceObject1->state(IICETransport::State_Disconnected);
                 if (fakeIceObject2) fakeIceObject2->state(IICETransport::State_Disconnected);
+                for (auto iter = extraFakeIceObjects.begin(); iter != extraFakeIceObjects.end(); ++iter) {
+                  (*iter)->state(IICETransport::State_Disconnected);
+                }
                 break;
               }
               case 30: {
                 if (fakeIceObject1) fakeIceObject1->state(IICETransport::State_Closed);
                 if (fakeIceObject2) fakeIceObject2->state(IICETransport::State_Closed);
+                for (auto iter = extraFakeIceObjects.begin(); iter != extraFakeIceObjects.end(); ++iter) {
+                  (*iter)->state(IICETransport::State_Closed);
+                }
                 break;
               }
               case 35: {
                 if (testDTLSObject1) testDTLSObject1->close();
                 if (testDTLSObject2) testDTLSObject2->close();
+                for (auto iter = extraTestDTLSObjects.begin(); iter != extraTestDTLSObjects.end(); ++iter) {
+                  (*iter)->close();
+                }
                 break;
               }
               default: {
@@ -801,6 +883,9 @@ void doTestDTLS()
         if (0 == found) {
           found += (testDTLSObject1 ? (testDTLSObject1->matches(expectationsDTLS1) ? 1 : 0) : 0);
           found += (testDTLSObject2 ? (testDTLSObject2->matches(expectationsDTLS2) ? 1 : 0) : 0);
+          for (auto iter = extraTestDTLSObjects.begin(); iter != extraTestDTLSObjects.end(); ++iter) {
+            found += ((*iter)->matches(expectationsDTLS1) ? 1 : 0);
+          }
         }
 
         if (lastFound != found) {
@@ -818,6 +903,10 @@ void doTestDTLS()
         {
           if (testDTLSObject1) {TESTING_CHECK(testDTLSObject1->matches(expectationsDTLS1))}
           if (testDTLSObject2) {TESTING_CHECK(testDTLSObject2->matches(expectationsDTLS2))}
+          for (auto iter = extraTestDTLSObjects.begin(); iter != extraTestDTLSObjects.end(); ++iter) {
+            // every concurrent handshake must have reached connected
+            TESTING_CHECK((*iter)->matches(expectationsDTLS1))
+          }
           break;
         }
       }
@@ -828,6 +917,9 @@ void doTestDTLS()
       fakeIceObject1.reset();
       fakeIceObject2.reset();
 
+      extraTestDTLSObjects.clear();
+      extraFakeIceObjects.clear();
+
       ++testNumber;
     } while (true);
   }
@@ -32,6 +32,9 @@
 
 #include <ortc/IICEGatherer.h>
 
+#include <ortc/internal/ortc_ICEGatherer.h>
+#include <ortc/internal/ortc_ICEGathererUDPMux.h>
+
 #include <ortc/services/IHelper.h>
 
 #include <zsLib/IMessageQueueThread.h>
@@ -319,6 +322,172 @@ namespace ortc
 
 ZS_DECLARE_USING_PTR(ortc::test::gatherer, ICEGathererTester)
 
+namespace ortc
+{
+  namespace test
+  {
+    namespace gatherer
+    {
+      ZS_DECLARE_CLASS_PTR(FakeUDPMuxGatherer)
+      ZS_DECLARE_CLASS_PTR(FakeICEGathererUDPMux)
+
+      //-----------------------------------------------------------------------
+      class FakeUDPMuxGatherer : public ortc::internal::IICEGathererForICEGathererUDPMux
+      {
+      public:
+        virtual PUID getID() const override {return mID;}
+
+        virtual void notifyUDPMuxPacket(
+                                        SocketPtr socket,
+                                        const IPAddress &fromIP,
+                                        const BYTE *buffer,
+                                        size_t bufferSizeInBytes
+                                        ) override
+        {
+        }
+
+      public:
+        AutoPUID mID;
+      };
+
+      //-----------------------------------------------------------------------
+      // exposes the mux routing table without binding any sockets
+      class FakeICEGathererUDPMux : public ortc::internal::ICEGathererUDPMux
+      {
+      public:
+        FakeICEGathererUDPMux() :
+          ICEGathererUDPMux(make_private{}, 0, 1)
+        {
+          mRemoteIdleTimeout = Seconds(60);
+        }
+
+        static FakeICEGathererUDPMuxPtr create()
+        {
+          FakeICEGathererUDPMuxPtr pThis(make_shared<FakeICEGathererUDPMux>());
+          pThis->mThisWeak = pThis;
+          return pThis;
+        }
+
+        using ICEGathererUDPMux::registerGatherer;
+        using ICEGathererUDPMux::unregisterGatherer;
+        using ICEGathererUDPMux::notifyRemote;
+        using ICEGathererUDPMux::route;
+        using ICEGathererUDPMux::expireIdleRemotes;
+
+        size_t totalRemotes() const
+        {
+          AutoRecursiveLock lock(*this);
+          return mRemotes.size();
+        }
+
+        size_t totalRemotes(PUID gathererID) const
+        {
+          AutoRecursiveLock lock(*this);
+          auto found = mGatherers.find(gathererID);
+          if (found == mGatherers.end()) return 0;
+          return (*found).second->mRemotes.size();
+        }
+      };
+
+    }
+  }
+}
+
+ZS_DECLARE_USING_PTR(ortc::test::gatherer, FakeUDPMuxGatherer)
+ZS_DECLARE_USING_PTR(ortc::test::gatherer, FakeICEGathererUDPMux)
+
+static ortc::SecureByteBlockPtr createUDPMuxBindingRequest(
+                                                          const char *username,
+                                                          const char *password
+                                                          )
+{
+  typedef ortc::services::STUNPacket STUNPacket;
+
+  auto request = STUNPacket::createRequest(STUNPacket::Method_Binding);
+  request->mFingerprintIncluded = true;
+  request->mCredentialMechanism = STUNPacket::CredentialMechanisms_ShortTerm;
+  request->mUsername = username;
+  request->mPassword = password;
+  return request->packetize(STUNPacket::RFC_5245_ICE);
+}
+
+static void testUDPMuxRouting()
+{
+  typedef zsLib::IPAddress IPAddress;
+  typedef zsLib::BYTE BYTE;
+
+  auto mux = FakeICEGathererUDPMux::create();
+  auto gathererA = std::make_shared<FakeUDPMuxGatherer>();
+  auto gathererB = std::make_shared<FakeUDPMuxGatherer>();
+
+  mux->registerGatherer(gathererA, "fragA");
+  mux->registerGatherer(gathererB, "fragB");
+
+  IPAddress boundIP("192.168.1.10", 9000);
+  IPAddress remoteIP("10.0.0.1", 5000);
+  IPAddress otherRemoteIP("10.0.0.2", 5000);
+
+  BYTE media[100] {};
+  media[0] = 0x80;  // RTP version 2
+
+  auto requestA = createUDPMuxBindingRequest("fragA:remote", "passwordA");
+  auto requestB = createUDPMuxBindingRequest("fragB:attacker", "passwordB");
+  auto requestUnknown = createUDPMuxBindingRequest("fragX:remote", "passwordX");
+
+  // media from a remote nobody has authenticated is dropped
+  TESTING_CHECK(!mux->route(boundIP, remoteIP, media, sizeof(media)))
+
+  // first contact is routed by username frag but nothing is learned
+  TESTING_CHECK(gathererA == mux->route(boundIP, remoteIP, *requestA, requestA->SizeInBytes()))
+  TESTING_CHECK(!mux->route(boundIP, remoteIP, *requestUnknown, requestUnknown->SizeInBytes()))
+  TESTING_EQUAL(mux->totalRemotes(), 0)
+  TESTING_CHECK(!mux->route(boundIP, remoteIP, media, sizeof(media)))
+
+  // gatherer A passed MESSAGE-INTEGRITY and confirms (repeat confirms dedupe)
+  mux->notifyRemote(gathererA->getID(), boundIP, remoteIP);
+  mux->notifyRemote(gathererA->getID(), boundIP, remoteIP);
+  TESTING_EQUAL(mux->totalRemotes(), 1)
+  TESTING_EQUAL(mux->totalRemotes(gathererA->getID()), 1)
+  TESTING_CHECK(gathererA == mux->route(boundIP, remoteIP, media, sizeof(media)))
+
+  // a request with another gatherer's frag from the same remote is handed
+  // to that gatherer to validate but does not hijack the remote's media
+  TESTING_CHECK(gathererB == mux->route(boundIP, remoteIP, *requestB, requestB->SizeInBytes()))
+  TESTING_CHECK(gathererA == mux->route(boundIP, remoteIP, media, sizeof(media)))
+  TESTING_EQUAL(mux->totalRemotes(gathererB->getID()), 0)
+
+  // only a confirmation moves the remote and the old owner's key goes too
+  mux->notifyRemote(gathererB->getID(), boundIP, remoteIP);
+  TESTING_EQUAL(mux->totalRemotes(), 1)
+  TESTING_EQUAL(mux->totalRemotes(gathererA->getID()), 0)
+  TESTING_EQUAL(mux->totalRemotes(gathererB->getID()), 1)
+  TESTING_CHECK(gathererB == mux->route(boundIP, remoteIP, media, sizeof(media)))
+
+  // remotes idle past the timeout must be authenticated again
+  mux->notifyRemote(gathererA->getID(), boundIP, otherRemoteIP);
+  TESTING_EQUAL(mux->totalRemotes(), 2)
+  mux->expireIdleRemotes(zsLib::now() + zsLib::Seconds(61));
+  TESTING_EQUAL(mux->totalRemotes(), 0)
+  TESTING_EQUAL(mux->totalRemotes(gathererA->getID()), 0)
+  TESTING_EQUAL(mux->totalRemotes(gathererB->getID()), 0)
+  TESTING_CHECK(!mux->route(boundIP, remoteIP, media, sizeof(media)))
+
+  // unregistering drops the gatherer's remotes and username frag
+  mux->notifyRemote(gathererA->getID(), boundIP, remoteIP);
+  mux->notifyRemote(gathererA->getID(), boundIP, otherRemoteIP);
+  TESTING_EQUAL(mux->totalRemotes(), 2)
+  mux->unregisterGatherer(gathererA->getID());
+  TESTING_EQUAL(mux->totalRemotes(), 0)
+  TESTING_CHECK(!mux->route(boundIP, remoteIP, media, sizeof(media)))
+  TESTING_CHECK(!mux->route(boundIP, remoteIP, *requestA, requestA->SizeInBytes()))
+
+  // confirmations from unregistered gatherers are ignored
+  mux->notifyRemote(gathererA->getID(), boundIP, remoteIP);
+  TESTING_EQUAL(mux->totalRemotes(), 0)
+
+  mux->unregisterGatherer(gathererB->getID());
+}
+
 
 void doTestICEGatherer()
 {
@@ -330,6 +499,8 @@ void doTestICEGatherer()
 
   UseSettings::applyDefaults();
 
+  testUDPMuxRouting();
+
   auto thread(zsLib::IMessageQueueThread::createBasic());
 
   size_t totalHostIPs = UseSettings::getUInt("tester/total-host-ips");
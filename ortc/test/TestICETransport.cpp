@@ -33,6 +33,8 @@
 #include <ortc/IICEGatherer.h>
 #include <ortc/IICETransport.h>
 
+#include <ortc/internal/ortc_ICEScheduler.h>
+
 #include <ortc/services/IHelper.h>
 
 #include <zsLib/ISettings.h>
@@ -631,6 +633,252 @@ namespace ortc
 ZS_DECLARE_USING_PTR(ortc::test::transport, ICEGathererTester)
 ZS_DECLARE_USING_PTR(ortc::test::transport, ICETransportTester)
 
+namespace ortc
+{
+  namespace test
+  {
+    namespace transport
+    {
+      ZS_DECLARE_CLASS_PTR(FakeICESchedulerDelegate)
+      ZS_DECLARE_CLASS_PTR(FakeICEScheduler)
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark FakeICESchedulerDelegate
+      #pragma mark
+
+      class FakeICESchedulerDelegate : public ortc::internal::IICESchedulerDelegate
+      {
+      public:
+        virtual void onICESchedulerTimersFired(TimerIDListPtr timers) override {}
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark FakeICEScheduler
+      #pragma mark
+
+      // drives the wheel tick by tick without the tick timer
+      class FakeICEScheduler : public ortc::internal::ICEScheduler
+      {
+      public:
+        FakeICEScheduler(zsLib::IMessageQueuePtr queue) :
+          ICEScheduler(make_private{}, queue)
+        {
+        }
+
+        static FakeICESchedulerPtr create(zsLib::IMessageQueuePtr queue)
+        {
+          FakeICESchedulerPtr pThis(make_shared<FakeICEScheduler>(queue));
+          pThis->mThisWeak = pThis;
+          pThis->init();
+          return pThis;
+        }
+
+        using ICEScheduler::scheduleAt;
+
+        // advances the given number of ticks collecting everything fired
+        void advance(
+                     QWORD ticks,
+                     FiredBatchMap &ioFired
+                     )
+        {
+          AutoRecursiveLock lock(*this);
+          for (QWORD loop = 0; loop < ticks; ++loop) {
+            ICEScheduler::advance(ioFired);
+          }
+        }
+
+        QWORD currentTick() const
+        {
+          AutoRecursiveLock lock(*this);
+          return mCurrentTick;
+        }
+
+        size_t totalScheduled() const
+        {
+          AutoRecursiveLock lock(*this);
+          return mTotalScheduled;
+        }
+      };
+
+    }
+  }
+}
+
+ZS_DECLARE_USING_PTR(ortc::test::transport, FakeICESchedulerDelegate)
+ZS_DECLARE_USING_PTR(ortc::test::transport, FakeICEScheduler)
+
+typedef ortc::internal::ICEScheduler::FiredBatchMap FiredBatchMap;
+
+//-----------------------------------------------------------------------------
+static size_t totalFired(
+                         const FiredBatchMap &fired,
+                         zsLib::PUID ownerID
+                         )
+{
+  auto found = fired.find(ownerID);
+  if (found == fired.end()) return 0;
+  return (*found).second.mTimers->size();
+}
+
+//-----------------------------------------------------------------------------
+static bool wasFired(
+                     const FiredBatchMap &fired,
+                     ortc::internal::ICESchedulerTimerPtr timer
+                     )
+{
+  for (auto iter = fired.begin(); iter != fired.end(); ++iter) {
+    auto &timers = *((*iter).second.mTimers);
+    for (auto iterTimer = timers.begin(); iterTimer != timers.end(); ++iterTimer) {
+      if ((*iterTimer) == timer->getID()) return true;
+    }
+  }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+// advances until the timer fires (or the limit is reached) and returns the
+// tick it fired on
+static zsLib::QWORD advanceUntilFired(
+                                      FakeICESchedulerPtr scheduler,
+                                      ortc::internal::ICESchedulerTimerPtr timer,
+                                      zsLib::QWORD limit
+                                      )
+{
+  while (scheduler->currentTick() < limit) {
+    FiredBatchMap fired;
+    scheduler->advance(1, fired);
+    if (wasFired(fired, timer)) return scheduler->currentTick();
+  }
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+static void testICESchedulerWheel(zsLib::IMessageQueuePtr queue)
+{
+  typedef ortc::internal::ICEScheduler ICEScheduler;
+  typedef zsLib::QWORD QWORD;
+
+  const QWORD level0Span = static_cast<QWORD>(1) << ICEScheduler::kLevel0Bits;                                     // 256
+  const QWORD level1Span = static_cast<QWORD>(1) << (ICEScheduler::kLevel0Bits + ICEScheduler::kLevelNBits);        // 16384
+  const QWORD level2Span = static_cast<QWORD>(1) << (ICEScheduler::kLevel0Bits + (2 * ICEScheduler::kLevelNBits));  // 1048576
+
+  auto delegate = make_shared<FakeICESchedulerDelegate>();
+
+  // cascade boundaries: each timer must fire on exactly its own tick
+  {
+    auto scheduler = FakeICEScheduler::create(queue);
+
+    auto lastLevel0 = scheduler->scheduleAt(1, delegate, level0Span - 1);
+    auto firstLevel1 = scheduler->scheduleAt(1, delegate, level0Span);
+    auto lastLevel1 = scheduler->scheduleAt(1, delegate, level1Span - 1);
+    auto firstLevel2 = scheduler->scheduleAt(1, delegate, level1Span);
+    auto insideLevel2 = scheduler->scheduleAt(1, delegate, level1Span + 300);   // cascades twice
+
+    TESTING_EQUAL(scheduler->totalScheduled(), 5)
+
+    TESTING_EQUAL(advanceUntilFired(scheduler, lastLevel0, level2Span), level0Span - 1)
+    TESTING_EQUAL(advanceUntilFired(scheduler, firstLevel1, level2Span), level0Span)
+    TESTING_EQUAL(advanceUntilFired(scheduler, lastLevel1, level2Span), level1Span - 1)
+    TESTING_EQUAL(advanceUntilFired(scheduler, firstLevel2, level2Span), level1Span)
+    TESTING_EQUAL(advanceUntilFired(scheduler, insideLevel2, level2Span), level1Span + 300)
+
+    TESTING_EQUAL(scheduler->totalScheduled(), 0)
+  }
+
+  // the same boundaries relative to a current tick that is not aligned
+  {
+    auto scheduler = FakeICEScheduler::create(queue);
+
+    FiredBatchMap ignored;
+    scheduler->advance(level0Span + 17, ignored);
+
+    QWORD start = scheduler->currentTick();
+    auto justBefore = scheduler->scheduleAt(1, delegate, start + level1Span - 1);
+    auto justAfter = scheduler->scheduleAt(1, delegate, start + level1Span);
+
+    TESTING_EQUAL(advanceUntilFired(scheduler, justBefore, start + level2Span), start + level1Span - 1)
+    TESTING_EQUAL(advanceUntilFired(scheduler, justAfter, start + level2Span), start + level1Span)
+  }
+
+  // anything past the level 2 span is clamped to its last tick
+  {
+    auto scheduler = FakeICEScheduler::create(queue);
+
+    auto beyond = scheduler->scheduleAt(1, delegate, level2Span * 3);
+    auto edge = scheduler->scheduleAt(1, delegate, level2Span - 1);
+
+    FiredBatchMap fired;
+    scheduler->advance(level2Span - 2, fired);
+    TESTING_CHECK(!wasFired(fired, beyond))
+    TESTING_CHECK(!wasFired(fired, edge))
+
+    fired.clear();
+    scheduler->advance(1, fired);
+    TESTING_CHECK(wasFired(fired, beyond))
+    TESTING_CHECK(wasFired(fired, edge))
+    TESTING_EQUAL(scheduler->totalScheduled(), 0)
+  }
+
+  // all timers of one owner firing while the wheel catches up are batched
+  // together; other owners get their own batch
+  {
+    auto scheduler = FakeICEScheduler::create(queue);
+
+    scheduler->scheduleAt(1, delegate, 10);
+    scheduler->scheduleAt(1, delegate, 10);
+    scheduler->scheduleAt(1, delegate, 11);
+    scheduler->scheduleAt(2, delegate, 11);
+    scheduler->scheduleAt(3, delegate, 12);
+
+    FiredBatchMap fired;
+    scheduler->advance(11, fired);    // catch up ticks 1..11 in one pass
+    TESTING_EQUAL(fired.size(), 2)
+    TESTING_EQUAL(totalFired(fired, 1), 3)
+    TESTING_EQUAL(totalFired(fired, 2), 1)
+    TESTING_EQUAL(totalFired(fired, 3), 0)
+    TESTING_EQUAL(scheduler->totalScheduled(), 1)
+  }
+
+  // cancelling while a batch is being handled: timers already in the batch
+  // are unaffected (no double count) and pending timers never fire
+  {
+    auto scheduler = FakeICEScheduler::create(queue);
+
+    auto first = scheduler->scheduleAt(1, delegate, 10);
+    auto second = scheduler->scheduleAt(1, delegate, 10);
+    auto pending = scheduler->scheduleAt(1, delegate, 11);
+    auto cancelledBefore = scheduler->scheduleAt(1, delegate, 10);
+
+    cancelledBefore->cancel();
+    TESTING_EQUAL(scheduler->totalScheduled(), 3)
+
+    FiredBatchMap fired;
+    scheduler->advance(10, fired);
+    TESTING_EQUAL(totalFired(fired, 1), 2)
+    TESTING_CHECK(!wasFired(fired, cancelledBefore))
+    TESTING_EQUAL(scheduler->totalScheduled(), 1)
+
+    // as the delegate would from onICESchedulerTimersFired()
+    second->cancel();
+    first->cancel();
+    pending->cancel();
+    pending->cancel();
+    TESTING_EQUAL(scheduler->totalScheduled(), 0)
+
+    fired.clear();
+    scheduler->advance(5, fired);
+    TESTING_EQUAL(fired.size(), 0)
+  }
+}
+
 
 void doTestICETransport()
 {
@@ -644,6 +892,8 @@ void doTestICETransport()
 
   auto thread(zsLib::IMessageQueueThread::createBasic());
 
+  testICESchedulerWheel(thread);
+
   size_t totalHostIPs = UseSettings::getUInt("tester/total-host-ips");
 
   ICEGathererTesterPtr testGathererObject1;
@@ -0,0 +1,1091 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+
+#include <ortc/ICertificate.h>
+#include <ortc/IDataChannel.h>
+#include <ortc/IDTLSTransport.h>
+#include <ortc/IICEGatherer.h>
+#include <ortc/IICETransport.h>
+#include <ortc/ISCTPTransport.h>
+
+#include <ortc/internal/ortc_ISecureTransport.h>
+#include <ortc/internal/ortc_RTPListener.h>
+#include <ortc/internal/ortc_RTPPacket.h>
+#include <ortc/internal/ortc_RTPReceiver.h>
+
+#include <ortc/services/IHelper.h>
+
+#include <zsLib/IMessageQueueThread.h>
+#include <zsLib/ISettings.h>
+#include <zsLib/XML.h>
+
+#include "config.h"
+#include "testing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <time.h>
+#endif //__linux__
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::String;
+using zsLib::BYTE;
+using zsLib::WORD;
+using zsLib::DWORD;
+using zsLib::ULONG;
+using zsLib::ULONGLONG;
+using zsLib::PUID;
+using zsLib::Lock;
+using zsLib::AutoLock;
+using zsLib::Log;
+using zsLib::AutoPUID;
+using zsLib::AutoRecursiveLock;
+using namespace zsLib::XML;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+ZS_DECLARE_TYPEDEF_PTR(ortc::services::IHelper, UseServicesHelper)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace loopbackbenchmark
+    {
+      ZS_DECLARE_CLASS_PTR(LatencyRecorder)
+      ZS_DECLARE_CLASS_PTR(BenchmarkReceiver)
+      ZS_DECLARE_CLASS_PTR(LoopbackPeer)
+
+      ZS_DECLARE_TYPEDEF_PTR(ortc::internal::IRTPListenerForRTPReceiver, UseListener)
+      ZS_DECLARE_TYPEDEF_PTR(ortc::internal::ISecureTransportForRTPSender, UseSecureTransport)
+      ZS_DECLARE_TYPEDEF_PTR(ortc::internal::RTPPacket, RTPPacket)
+      ZS_DECLARE_TYPEDEF_PTR(ortc::internal::RTCPPacket, RTCPPacket)
+
+      static const size_t kRTPHeaderSize = 12;
+      static const size_t kRTCPSenderReportSize = 28;
+      static const size_t kTimestampSize = sizeof(ULONGLONG);
+      static const BYTE kPayloadType = 111;
+
+      //-----------------------------------------------------------------------
+      static ULONGLONG nowInNanoseconds()
+      {
+        return static_cast<ULONGLONG>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+      }
+
+      //-----------------------------------------------------------------------
+      static void writeTimestamp(BYTE *buffer, ULONGLONG value)
+      {
+        for (size_t index = 0; index < kTimestampSize; ++index) {
+          buffer[index] = static_cast<BYTE>(value >> (8 * (kTimestampSize - index - 1)));
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      static ULONGLONG readTimestamp(const BYTE *buffer)
+      {
+        ULONGLONG result = 0;
+        for (size_t index = 0; index < kTimestampSize; ++index) {
+          result = (result << 8) | static_cast<ULONGLONG>(buffer[index]);
+        }
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      static double processCPUSeconds()
+      {
+#ifdef __linux__
+        struct timespec value {};
+        if (0 == clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &value)) {
+          return static_cast<double>(value.tv_sec) + (static_cast<double>(value.tv_nsec) / 1000000000.0);
+        }
+#endif //__linux__
+        return static_cast<double>(std::clock()) / static_cast<double>(CLOCKS_PER_SEC);
+      }
+
+      //-----------------------------------------------------------------------
+      static ULONG processThreadCount()
+      {
+#ifdef __linux__
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+          if (0 == line.compare(0, 8, "Threads:")) return static_cast<ULONG>(atol(line.c_str() + 8));
+        }
+#endif //__linux__
+        return 0;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark LatencyRecorder
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      // Samples are stored in a buffer reserved before measurement starts so
+      // recording never allocates (and never skews the allocation counts).
+      class LatencyRecorder
+      {
+      public:
+        //---------------------------------------------------------------------
+        void start(size_t expectedSamples)
+        {
+          AutoLock lock(mLock);
+          mSamples.clear();
+          mSamples.reserve(expectedSamples);
+          mDropped = 0;
+          mRecording = true;
+        }
+
+        //---------------------------------------------------------------------
+        void stop()
+        {
+          AutoLock lock(mLock);
+          mRecording = false;
+        }
+
+        //---------------------------------------------------------------------
+        void record(ULONGLONG sentAt)
+        {
+          ULONGLONG now = nowInNanoseconds();
+
+          AutoLock lock(mLock);
+          if (!mRecording) return;
+          if (mSamples.size() >= mSamples.capacity()) {
+            ++mDropped;
+            return;
+          }
+          mSamples.push_back(now > sentAt ? now - sentAt : 0);
+        }
+
+        //---------------------------------------------------------------------
+        size_t total() const
+        {
+          AutoLock lock(mLock);
+          return mSamples.size() + mDropped;
+        }
+
+        //---------------------------------------------------------------------
+        void report(const char *name) const
+        {
+          std::vector<ULONGLONG> samples;
+          size_t dropped = 0;
+
+          {
+            AutoLock lock(mLock);
+            samples = mSamples;
+            dropped = mDropped;
+          }
+
+          if (samples.size() < 1) {
+            TESTING_STDOUT() << "BENCHMARK:    " << name << " latency: no samples\n";
+            return;
+          }
+
+          std::sort(samples.begin(), samples.end());
+
+          TESTING_STDOUT() << "BENCHMARK:    " << name << " one-way latency (us):"
+                           << " p50=" << (percentile(samples, 0.50) / 1000.0)
+                           << " p99=" << (percentile(samples, 0.99) / 1000.0)
+                           << " p999=" << (percentile(samples, 0.999) / 1000.0)
+                           << " max=" << (samples.back() / 1000.0)
+                           << " samples=" << samples.size()
+                           << " dropped=" << dropped << "\n";
+        }
+
+      protected:
+        //---------------------------------------------------------------------
+        static double percentile(
+                                 const std::vector<ULONGLONG> &sortedSamples,
+                                 double fraction
+                                 )
+        {
+          size_t index = static_cast<size_t>(fraction * static_cast<double>(sortedSamples.size() - 1));
+          return static_cast<double>(sortedSamples[index]);
+        }
+
+      protected:
+        mutable Lock mLock;
+        std::vector<ULONGLONG> mSamples;
+        size_t mDropped {};
+        bool mRecording {false};
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark BenchmarkReceiver
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      // Terminates the receive path at the RTPReceiver boundary (the point the
+      // RTPListener hands off to) so the benchmark measures the transport
+      // stack rather than the codec engine.
+      class BenchmarkReceiver : public ortc::internal::RTPReceiver
+      {
+      public:
+        //---------------------------------------------------------------------
+        BenchmarkReceiver(
+                          LatencyRecorderPtr rtpLatency,
+                          std::atomic<ULONGLONG> &rtcpReceived
+                          ) :
+          RTPReceiver(Noop(true)),
+          mRTPLatency(rtpLatency),
+          mRTCPReceived(rtcpReceived)
+        {
+        }
+
+        //---------------------------------------------------------------------
+        ~BenchmarkReceiver()
+        {
+          mThisWeak.reset();
+          stop();
+        }
+
+        //---------------------------------------------------------------------
+        static BenchmarkReceiverPtr create(
+                                           LatencyRecorderPtr rtpLatency,
+                                           std::atomic<ULONGLONG> &rtcpReceived
+                                           )
+        {
+          BenchmarkReceiverPtr pThis(make_shared<BenchmarkReceiver>(rtpLatency, rtcpReceived));
+          pThis->mThisWeak = pThis;
+          return pThis;
+        }
+
+        //---------------------------------------------------------------------
+        void attach(
+                    IDTLSTransportPtr transport,
+                    DWORD ssrc
+                    )
+        {
+          AutoRecursiveLock lock(*this);
+
+          IRTPTypes::CodecParameters codec;
+          codec.mName = IRTPTypes::toString(IRTPTypes::SupportedCodec_Opus);
+          codec.mPayloadType = kPayloadType;
+          codec.mClockRate = 48000;
+
+          IRTPTypes::EncodingParameters encoding;
+          encoding.mSSRC = ssrc;
+          encoding.mCodecPayloadType = kPayloadType;
+
+          mParameters = make_shared<Parameters>();
+          mParameters->mCodecs.push_back(codec);
+          mParameters->mEncodings.push_back(encoding);
+
+          mListener = UseListener::getListener(transport);
+          TESTING_CHECK(mListener)
+
+          mListener->registerReceiver(IMediaStreamTrackTypes::Kind_Audio, mThisWeak.lock(), *mParameters);
+        }
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark BenchmarkReceiver => IRTPReceiverForRTPListener
+        #pragma mark
+
+        //---------------------------------------------------------------------
+        virtual bool handlePacket(
+                                  IICETypes::Components viaTransport,
+                                  RTPPacketPtr packet
+                                  ) override
+        {
+          if (packet->payloadSize() >= kTimestampSize) {
+            mRTPLatency->record(readTimestamp(packet->payload()));
+          }
+          return true;
+        }
+
+        //---------------------------------------------------------------------
+        virtual bool handlePacket(
+                                  IICETypes::Components viaTransport,
+                                  RTCPPacketPtr packet
+                                  ) override
+        {
+          mRTCPReceived.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+
+        //---------------------------------------------------------------------
+        virtual void stop() override
+        {
+          AutoRecursiveLock lock(*this);
+
+          if (mListener) {
+            mListener->unregisterReceiver(*this);
+            mListener.reset();
+          }
+        }
+
+      protected:
+        BenchmarkReceiverWeakPtr mThisWeak;
+
+        LatencyRecorderPtr mRTPLatency;
+        std::atomic<ULONGLONG> &mRTCPReceived;
+
+        ParametersPtr mParameters;
+        UseListenerPtr mListener;
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark LoopbackPeer
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      // One side of a loopback pair: real ICEGatherer -> ICETransport ->
+      // DTLSTransport (with its SRTPTransport) -> RTPListener, plus an
+      // SCTPTransport/DataChannel riding the same DTLS transport.
+      class LoopbackPeer : public zsLib::MessageQueueAssociator,
+                           public SharedRecursiveLock,
+                           public IICEGathererDelegate,
+                           public IICETransportDelegate,
+                           public IDTLSTransportDelegate,
+                           public ISCTPTransportDelegate,
+                           public IDataChannelDelegate
+      {
+      protected:
+        struct make_private {};
+
+      public:
+        //---------------------------------------------------------------------
+        LoopbackPeer(
+                     const make_private &,
+                     IMessageQueuePtr queue,
+                     DWORD ssrc,
+                     LatencyRecorderPtr rtpLatency,
+                     LatencyRecorderPtr dataLatency,
+                     std::atomic<ULONGLONG> &rtcpReceived
+                     ) :
+          zsLib::MessageQueueAssociator(queue),
+          SharedRecursiveLock(SharedRecursiveLock::create()),
+          mSSRC(ssrc),
+          mRTPLatency(rtpLatency),
+          mDataLatency(dataLatency),
+          mRTCPReceived(rtcpReceived)
+        {
+        }
+
+        //---------------------------------------------------------------------
+        ~LoopbackPeer()
+        {
+          mThisWeak.reset();
+        }
+
+        //---------------------------------------------------------------------
+        static LoopbackPeerPtr create(
+                                      IMessageQueuePtr queue,
+                                      DWORD ssrc,
+                                      LatencyRecorderPtr rtpLatency,
+                                      LatencyRecorderPtr dataLatency,
+                                      std::atomic<ULONGLONG> &rtcpReceived
+                                      )
+        {
+          LoopbackPeerPtr pThis(make_shared<LoopbackPeer>(make_private{}, queue, ssrc, rtpLatency, dataLatency, rtcpReceived));
+          pThis->mThisWeak = pThis;
+          pThis->init();
+          return pThis;
+        }
+
+        //---------------------------------------------------------------------
+        void init()
+        {
+          AutoRecursiveLock lock(*this);
+
+          IICEGathererTypes::Options options;
+          options.mContinuousGathering = false;
+          mGatherer = IICEGatherer::create(mThisWeak.lock(), options);
+          mCertificatePromise = ICertificate::generateCertificate();
+        }
+
+        //---------------------------------------------------------------------
+        bool isPrepared() const
+        {
+          AutoRecursiveLock lock(*this);
+          return (bool)mCertificatePromise && mCertificatePromise->isSettled();
+        }
+
+        //---------------------------------------------------------------------
+        void createTransports()
+        {
+          AutoRecursiveLock lock(*this);
+
+          auto certificate = mCertificatePromise->value();
+          TESTING_CHECK(certificate)
+
+          std::list<ICertificatePtr> certificates;
+          certificates.push_back(certificate);
+
+          mICETransport = IICETransport::create(mThisWeak.lock(), mGatherer);
+          mDTLSTransport = IDTLSTransport::create(mThisWeak.lock(), mICETransport, certificates);
+          mSCTPTransport = ISCTPTransport::create(mThisWeak.lock(), mDTLSTransport);
+
+          IICETypes::Components rtcpComponent {};
+          UseSecureTransportPtr rtcpTransport;
+          UseSecureTransport::getSendingTransport(mDTLSTransport, IRTCPTransportPtr(), mRTPComponent, rtcpComponent, mSecureTransport, rtcpTransport);
+          TESTING_CHECK(mSecureTransport)
+
+          mReceiver = BenchmarkReceiver::create(mRTPLatency, mRTCPReceived);
+        }
+
+        //---------------------------------------------------------------------
+        void connect(
+                     LoopbackPeerPtr remote,
+                     bool controlling
+                     )
+        {
+          AutoRecursiveLock lock(*this);
+
+          mRemote = remote;
+
+          IICETransportTypes::Options options;
+          options.mAggressiveICE = true;
+          options.mRole = (controlling ? IICETypes::Role_Controlling : IICETypes::Role_Controlled);
+
+          mICETransport->start(mGatherer, *(remote->mGatherer->getLocalParameters()), options);
+          mDTLSTransport->start(*(remote->mDTLSTransport->getLocalParameters()));
+          mSCTPTransport->start(*ISCTPTransport::getCapabilities(), remote->mSCTPTransport->localPort());
+
+          // the remote side's SSRC is what arrives on this side
+          mReceiver->attach(mDTLSTransport, remote->mSSRC);
+
+          IDataChannelTypes::Parameters params;
+          params.mLabel = "benchmark";
+          params.mOrdered = false;
+          params.mMaxRetransmits = 0;
+          params.mNegotiated = true;
+          params.mID = 1;
+          mDataChannel = IDataChannel::create(mThisWeak.lock(), mSCTPTransport, params);
+
+          // candidates gathered before the remote was known
+          auto candidates = mGatherer->getLocalCandidates();
+          if (candidates) {
+            for (auto iter = candidates->begin(); iter != candidates->end(); ++iter) {
+              remote->addRemoteCandidate(*iter);
+            }
+          }
+        }
+
+        //---------------------------------------------------------------------
+        void addRemoteCandidate(const IICETypes::GatherCandidate &candidate)
+        {
+          AutoRecursiveLock lock(*this);
+          if (!mICETransport) return;
+          mICETransport->addRemoteCandidate(candidate);
+        }
+
+        //---------------------------------------------------------------------
+        bool isConnected() const
+        {
+          AutoRecursiveLock lock(*this);
+          return mDTLSConnected && mDataChannelOpen;
+        }
+
+        //---------------------------------------------------------------------
+        bool isFailed() const
+        {
+          AutoRecursiveLock lock(*this);
+          return mFailed;
+        }
+
+        //---------------------------------------------------------------------
+        // Called from the benchmark pump thread; sends straight into the
+        // secure transport the way RTPSender does, with no codec in the path.
+        bool sendRTP(
+                     BYTE *buffer,
+                     size_t size
+                     )
+        {
+          ++mSequenceNumber;
+          mTimestamp += 960;
+
+          buffer[0] = 0x80;
+          buffer[1] = kPayloadType;
+          buffer[2] = static_cast<BYTE>(mSequenceNumber >> 8);
+          buffer[3] = static_cast<BYTE>(mSequenceNumber);
+          buffer[4] = static_cast<BYTE>(mTimestamp >> 24);
+          buffer[5] = static_cast<BYTE>(mTimestamp >> 16);
+          buffer[6] = static_cast<BYTE>(mTimestamp >> 8);
+          buffer[7] = static_cast<BYTE>(mTimestamp);
+          buffer[8] = static_cast<BYTE>(mSSRC >> 24);
+          buffer[9] = static_cast<BYTE>(mSSRC >> 16);
+          buffer[10] = static_cast<BYTE>(mSSRC >> 8);
+          buffer[11] = static_cast<BYTE>(mSSRC);
+          writeTimestamp(&(buffer[kRTPHeaderSize]), nowInNanoseconds());
+
+          ++mRTPPacketsSent;
+          mRTPOctetsSent += static_cast<DWORD>(size - kRTPHeaderSize);
+
+          return mSecureTransport->sendPacket(mRTPComponent, IICETypes::Component_RTP, buffer, size);
+        }
+
+        //---------------------------------------------------------------------
+        bool sendRTCP()
+        {
+          BYTE buffer[kRTCPSenderReportSize] {};
+
+          ULONGLONG now = nowInNanoseconds();
+
+          buffer[0] = 0x80;
+          buffer[1] = 200;  // SR
+          buffer[3] = static_cast<BYTE>((kRTCPSenderReportSize / 4) - 1);
+          buffer[4] = static_cast<BYTE>(mSSRC >> 24);
+          buffer[5] = static_cast<BYTE>(mSSRC >> 16);
+          buffer[6] = static_cast<BYTE>(mSSRC >> 8);
+          buffer[7] = static_cast<BYTE>(mSSRC);
+          writeTimestamp(&(buffer[8]), now);
+          buffer[16] = static_cast<BYTE>(mTimestamp >> 24);
+          buffer[17] = static_cast<BYTE>(mTimestamp >> 16);
+          buffer[18] = static_cast<BYTE>(mTimestamp >> 8);
+          buffer[19] = static_cast<BYTE>(mTimestamp);
+          buffer[20] = static_cast<BYTE>(mRTPPacketsSent >> 24);
+          buffer[21] = static_cast<BYTE>(mRTPPacketsSent >> 16);
+          buffer[22] = static_cast<BYTE>(mRTPPacketsSent >> 8);
+          buffer[23] = static_cast<BYTE>(mRTPPacketsSent);
+          buffer[24] = static_cast<BYTE>(mRTPOctetsSent >> 24);
+          buffer[25] = static_cast<BYTE>(mRTPOctetsSent >> 16);
+          buffer[26] = static_cast<BYTE>(mRTPOctetsSent >> 8);
+          buffer[27] = static_cast<BYTE>(mRTPOctetsSent);
+
+          return mSecureTransport->sendPacket(mRTPComponent, IICETypes::Component_RTCP, buffer, sizeof(buffer));
+        }
+
+        //---------------------------------------------------------------------
+        void sendData(
+                      BYTE *buffer,
+                      size_t size
+                      )
+        {
+          writeTimestamp(buffer, nowInNanoseconds());
+          mDataChannel->send(buffer, size);
+        }
+
+        //---------------------------------------------------------------------
+        void close()
+        {
+          AutoRecursiveLock lock(*this);
+
+          if (mReceiver) mReceiver->stop();
+          if (mDataChannel) mDataChannel->close();
+          if (mSCTPTransport) mSCTPTransport->stop();
+          if (mDTLSTransport) mDTLSTransport->stop();
+          if (mICETransport) mICETransport->stop();
+          if (mGatherer) mGatherer->close();
+
+          mRemote.reset();
+        }
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark LoopbackPeer => IICEGathererDelegate
+        #pragma mark
+
+        //---------------------------------------------------------------------
+        virtual void onICEGathererStateChange(
+                                              IICEGathererPtr gatherer,
+                                              IICEGatherer::States state
+                                              ) override
+        {
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onICEGathererLocalCandidate(
+                                                 IICEGathererPtr gatherer,
+                                                 CandidatePtr candidate
+                                                 ) override
+        {
+          auto remote = getRemote();
+          if (remote) remote->addRemoteCandidate(*candidate);
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onICEGathererLocalCandidateComplete(
+                                                         IICEGathererPtr gatherer,
+                                                         CandidateCompletePtr candidate
+                                                         ) override
+        {
+          auto remote = getRemote();
+          if (remote) remote->addRemoteCandidate(*candidate);
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onICEGathererLocalCandidateGone(
+                                                     IICEGathererPtr gatherer,
+                                                     CandidatePtr candidate
+                                                     ) override
+        {
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onICEGathererError(
+                                        IICEGathererPtr gatherer,
+                                        ErrorEventPtr errorEvent
+                                        ) override
+        {
+        }
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark LoopbackPeer => IICETransportDelegate
+        #pragma mark
+
+        //---------------------------------------------------------------------
+        virtual void onICETransportStateChange(
+                                               IICETransportPtr transport,
+                                               IICETransport::States state
+                                               ) override
+        {
+          if (IICETransport::State_Failed != state) return;
+
+          AutoRecursiveLock lock(*this);
+          mFailed = true;
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onICETransportCandidatePairAvailable(
+                                                          IICETransportPtr transport,
+                                                          CandidatePairPtr candidatePair
+                                                          ) override
+        {
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onICETransportCandidatePairGone(
+                                                     IICETransportPtr transport,
+                                                     CandidatePairPtr candidatePair
+                                                     ) override
+        {
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onICETransportCandidatePairChanged(
+                                                        IICETransportPtr transport,
+                                                        CandidatePairPtr candidatePair
+                                                        ) override
+        {
+        }
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark LoopbackPeer => IDTLSTransportDelegate
+        #pragma mark
+
+        //---------------------------------------------------------------------
+        virtual void onDTLSTransportStateChange(
+                                                IDTLSTransportPtr transport,
+                                                IDTLSTransport::States state
+                                                ) override
+        {
+          AutoRecursiveLock lock(*this);
+
+          switch (state) {
+            case IDTLSTransport::State_Connected: mDTLSConnected = true; break;
+            case IDTLSTransport::State_Failed:    mFailed = true; break;
+            default:                              break;
+          }
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onDTLSTransportError(
+                                          IDTLSTransportPtr transport,
+                                          ErrorAnyPtr error
+                                          ) override
+        {
+          AutoRecursiveLock lock(*this);
+          mFailed = true;
+        }
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark LoopbackPeer => ISCTPTransportDelegate
+        #pragma mark
+
+        //---------------------------------------------------------------------
+        virtual void onSCTPTransportStateChange(
+                                                ISCTPTransportPtr transport,
+                                                ISCTPTransportTypes::States state
+                                                ) override
+        {
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onSCTPTransportDataChannel(
+                                                ISCTPTransportPtr transport,
+                                                IDataChannelPtr channel
+                                                ) override
+        {
+        }
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark LoopbackPeer => IDataChannelDelegate
+        #pragma mark
+
+        //---------------------------------------------------------------------
+        virtual void onDataChannelStateChange(
+                                              IDataChannelPtr channel,
+                                              IDataChannelTypes::States state
+                                              ) override
+        {
+          if (IDataChannelTypes::State_Open != state) return;
+
+          AutoRecursiveLock lock(*this);
+          mDataChannelOpen = true;
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onDataChannelError(
+                                        IDataChannelPtr channel,
+                                        ErrorAnyPtr error
+                                        ) override
+        {
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onDataChannelBufferedAmountLow(IDataChannelPtr channel) override
+        {
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onDataChannelMessage(
+                                          IDataChannelPtr channel,
+                                          MessageEventDataPtr data
+                                          ) override
+        {
+          if (!data) return;
+          if (!data->mBinary) return;
+          if (data->mBinary->SizeInBytes() < kTimestampSize) return;
+
+          mDataLatency->record(readTimestamp(data->mBinary->BytePtr()));
+        }
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark LoopbackPeer => (internal)
+        #pragma mark
+
+        //---------------------------------------------------------------------
+        LoopbackPeerPtr getRemote() const
+        {
+          AutoRecursiveLock lock(*this);
+          return mRemote.lock();
+        }
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark LoopbackPeer => (data)
+        #pragma mark
+
+        AutoPUID mID;
+        LoopbackPeerWeakPtr mThisWeak;
+        LoopbackPeerWeakPtr mRemote;
+
+        DWORD mSSRC {};
+        LatencyRecorderPtr mRTPLatency;
+        LatencyRecorderPtr mDataLatency;
+        std::atomic<ULONGLONG> &mRTCPReceived;
+
+        IICEGathererPtr mGatherer;
+        IICETransportPtr mICETransport;
+        IDTLSTransportPtr mDTLSTransport;
+        ISCTPTransportPtr mSCTPTransport;
+        IDataChannelPtr mDataChannel;
+        BenchmarkReceiverPtr mReceiver;
+
+        ICertificateTypes::PromiseWithCertificatePtr mCertificatePromise;
+
+        UseSecureTransportPtr mSecureTransport;
+        IICETypes::Components mRTPComponent {IICETypes::Component_RTP};
+
+        // only touched by the pump thread
+        WORD mSequenceNumber {};
+        DWORD mTimestamp {};
+        DWORD mRTPPacketsSent {};
+        DWORD mRTPOctetsSent {};
+
+        bool mDTLSConnected {false};
+        bool mDataChannelOpen {false};
+        bool mFailed {false};
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark Pump
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      // Paces every stream against absolute deadlines on one clock so a slow
+      // iteration does not silently lower the offered load; deadlines that
+      // have already passed are sent immediately and counted as late.
+      struct Pump
+      {
+        typedef std::vector<LoopbackPeerPtr> PeerList;
+
+        PeerList mPeers;
+
+        ULONG mRTPPacketsPerSecond {};
+        ULONG mRTCPPacketsPerSecond {};
+        ULONG mDataMessagesPerSecond {};
+        size_t mRTPPacketSize {};
+        size_t mDataMessageSize {};
+
+        std::atomic<bool> mStop {false};
+
+        ULONGLONG mRTPSent {};
+        ULONGLONG mRTCPSent {};
+        ULONGLONG mDataSent {};
+        ULONGLONG mLate {};
+
+        //---------------------------------------------------------------------
+        void run()
+        {
+          typedef std::chrono::steady_clock Clock;
+
+          std::vector<BYTE> rtpBuffer(std::max(mRTPPacketSize, kRTPHeaderSize + kTimestampSize));
+          std::vector<BYTE> dataBuffer(std::max(mDataMessageSize, kTimestampSize));
+
+          auto rtpInterval = std::chrono::nanoseconds(0 != mRTPPacketsPerSecond ? (1000000000 / mRTPPacketsPerSecond) : 0);
+          auto rtcpInterval = std::chrono::nanoseconds(0 != mRTCPPacketsPerSecond ? (1000000000 / mRTCPPacketsPerSecond) : 0);
+          auto dataInterval = std::chrono::nanoseconds(0 != mDataMessagesPerSecond ? (1000000000 / mDataMessagesPerSecond) : 0);
+
+          auto start = Clock::now();
+          auto nextRTP = start;
+          auto nextRTCP = start;
+          auto nextData = start;
+
+          while (!mStop) {
+            auto now = Clock::now();
+
+            if ((0 != mRTPPacketsPerSecond) && (now >= nextRTP)) {
+              if (now - nextRTP > rtpInterval) ++mLate;
+              for (auto iter = mPeers.begin(); iter != mPeers.end(); ++iter) {
+                (*iter)->sendRTP(&(rtpBuffer[0]), rtpBuffer.size());
+                ++mRTPSent;
+              }
+              nextRTP += rtpInterval;
+            }
+            if ((0 != mRTCPPacketsPerSecond) && (now >= nextRTCP)) {
+              for (auto iter = mPeers.begin(); iter != mPeers.end(); ++iter) {
+                (*iter)->sendRTCP();
+                ++mRTCPSent;
+              }
+              nextRTCP += rtcpInterval;
+            }
+            if ((0 != mDataMessagesPerSecond) && (now >= nextData)) {
+              for (auto iter = mPeers.begin(); iter != mPeers.end(); ++iter) {
+                (*iter)->sendData(&(dataBuffer[0]), dataBuffer.size());
+                ++mDataSent;
+              }
+              nextData += dataInterval;
+            }
+
+            auto next = Clock::time_point::max();
+            if (0 != mRTPPacketsPerSecond) next = std::min(next, nextRTP);
+            if (0 != mRTCPPacketsPerSecond) next = std::min(next, nextRTCP);
+            if (0 != mDataMessagesPerSecond) next = std::min(next, nextData);
+            if (Clock::time_point::max() == next) break;
+
+            if (next > Clock::now()) std::this_thread::sleep_until(next);
+          }
+        }
+      };
+
+    }
+  }
+}
+
+ZS_DECLARE_USING_PTR(ortc::test::loopbackbenchmark, LatencyRecorder)
+ZS_DECLARE_USING_PTR(ortc::test::loopbackbenchmark, LoopbackPeer)
+using ortc::test::loopbackbenchmark::Pump;
+using ortc::test::loopbackbenchmark::processCPUSeconds;
+using ortc::test::loopbackbenchmark::processThreadCount;
+
+void doTestLoopbackBenchmark()
+{
+  if (!ORTC_TEST_DO_LOOPBACK_BENCHMARK) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  TESTING_SLEEP(1000)
+
+  UseSettings::applyDefaults();
+
+  const ULONG totalPairs = ORTC_TEST_LOOPBACK_BENCHMARK_PAIRS;
+  const ULONG durationSeconds = ORTC_TEST_LOOPBACK_BENCHMARK_DURATION_SECONDS;
+
+  auto thread(zsLib::IMessageQueueThread::createBasic());
+
+  auto rtpLatency = make_shared<LatencyRecorder>();
+  auto dataLatency = make_shared<LatencyRecorder>();
+  std::atomic<ULONGLONG> rtcpReceived {};
+
+  ULONG threadsBefore = processThreadCount();
+
+  std::vector<LoopbackPeerPtr> peers;
+
+  for (ULONG index = 0; index < totalPairs; ++index) {
+    auto ssrcBase = static_cast<zsLib::DWORD>(0x10000 + (index * 2));
+    peers.push_back(LoopbackPeer::create(thread, ssrcBase, rtpLatency, dataLatency, rtcpReceived));
+    peers.push_back(LoopbackPeer::create(thread, ssrcBase + 1, rtpLatency, dataLatency, rtcpReceived));
+  }
+
+  TESTING_STDOUT() << "WAITING:      Setting up " << totalPairs << " loopback pair(s).\n";
+
+  for (ULONG step = 0; step < 60; ++step) {
+    bool prepared = true;
+    for (auto iter = peers.begin(); iter != peers.end(); ++iter) {
+      prepared = prepared && (*iter)->isPrepared();
+    }
+    if (prepared) break;
+    TESTING_SLEEP(500)
+  }
+
+  for (auto iter = peers.begin(); iter != peers.end(); ++iter) {
+    TESTING_CHECK((*iter)->isPrepared())
+    (*iter)->createTransports();
+  }
+
+  for (size_t index = 0; index + 1 < peers.size(); index += 2) {
+    peers[index]->connect(peers[index + 1], true);
+    peers[index + 1]->connect(peers[index], false);
+  }
+
+  bool connected = false;
+  for (ULONG step = 0; step < 120; ++step) {
+    connected = true;
+    bool failed = false;
+    for (auto iter = peers.begin(); iter != peers.end(); ++iter) {
+      connected = connected && (*iter)->isConnected();
+      failed = failed || (*iter)->isFailed();
+    }
+    if ((connected) || (failed)) break;
+    TESTING_SLEEP(500)
+  }
+
+  TESTING_CHECK(connected)
+
+  if (connected) {
+    Pump pump;
+    pump.mPeers = peers;
+    pump.mRTPPacketsPerSecond = ORTC_TEST_LOOPBACK_BENCHMARK_RTP_PACKETS_PER_SECOND;
+    pump.mRTCPPacketsPerSecond = ORTC_TEST_LOOPBACK_BENCHMARK_RTCP_PACKETS_PER_SECOND;
+    pump.mDataMessagesPerSecond = ORTC_TEST_LOOPBACK_BENCHMARK_DATA_MESSAGES_PER_SECOND;
+    pump.mRTPPacketSize = ORTC_TEST_LOOPBACK_BENCHMARK_RTP_PACKET_SIZE;
+    pump.mDataMessageSize = ORTC_TEST_LOOPBACK_BENCHMARK_DATA_MESSAGE_SIZE;
+
+    std::thread pumpThread([&pump]() {pump.run();});
+
+    TESTING_SLEEP(ORTC_TEST_LOOPBACK_BENCHMARK_WARMUP_SECONDS * 1000)
+
+    // reserve with headroom so recording never allocates during measurement
+    size_t expectedRTP = static_cast<size_t>(peers.size()) * pump.mRTPPacketsPerSecond * durationSeconds * 2;
+    size_t expectedData = static_cast<size_t>(peers.size()) * pump.mDataMessagesPerSecond * durationSeconds * 2;
+
+    rtpLatency->start(expectedRTP);
+    dataLatency->start(expectedData);
+    ULONGLONG rtcpBefore = rtcpReceived.load();
+    ULONGLONG allocationsBefore = Testing::allocationCount();
+    double cpuBefore = processCPUSeconds();
+    auto wallBefore = std::chrono::steady_clock::now();
+
+    TESTING_SLEEP(durationSeconds * 1000)
+
+    rtpLatency->stop();
+    dataLatency->stop();
+    ULONGLONG rtcpDuring = rtcpReceived.load() - rtcpBefore;
+    ULONGLONG allocationsDuring = Testing::allocationCount() - allocationsBefore;
+    double cpuDuring = processCPUSeconds() - cpuBefore;
+    double wallDuring = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallBefore).count();
+    ULONG threadsDuring = processThreadCount();
+
+    pump.mStop = true;
+    pumpThread.join();
+
+    ULONGLONG received = static_cast<ULONGLONG>(rtpLatency->total() + dataLatency->total()) + rtcpDuring;
+
+    TESTING_STDOUT() << "BENCHMARK:    pairs=" << totalPairs
+                     << " duration=" << wallDuring << "s"
+                     << " cpu=" << cpuDuring << "s"
+                     << " cores=" << std::thread::hardware_concurrency() << "\n";
+    TESTING_STDOUT() << "BENCHMARK:    received rtp=" << rtpLatency->total()
+                     << " rtcp=" << rtcpDuring
+                     << " data=" << dataLatency->total()
+                     << " (sent during run incl. warmup rtp=" << pump.mRTPSent
+                     << " rtcp=" << pump.mRTCPSent
+                     << " data=" << pump.mDataSent
+                     << " late=" << pump.mLate << ")\n";
+    TESTING_STDOUT() << "BENCHMARK:    packets/sec=" << (wallDuring > 0 ? (received / wallDuring) : 0)
+                     << " packets/sec/core=" << (cpuDuring > 0 ? (received / cpuDuring) : 0) << "\n";
+    rtpLatency->report("rtp");
+    dataLatency->report("data");
+#if ORTC_TEST_COUNT_ALLOCATIONS
+    TESTING_STDOUT() << "BENCHMARK:    allocations=" << allocationsDuring
+                     << " allocations/packet=" << (received > 0 ? (static_cast<double>(allocationsDuring) / static_cast<double>(received)) : 0) << "\n";
+#else
+    (void)allocationsDuring;
+#endif //ORTC_TEST_COUNT_ALLOCATIONS
+    TESTING_STDOUT() << "BENCHMARK:    threads before=" << threadsBefore << " during=" << threadsDuring << "\n";
+  }
+
+  for (auto iter = peers.begin(); iter != peers.end(); ++iter) {
+    (*iter)->close();
+  }
+
+  TESTING_SLEEP(2000)
+
+  peers.clear();
+
+  TESTING_UNINSTALL_LOGGER()
+}
@@ -0,0 +1,619 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+
+#include <ortc/internal/ortc_RTPPacket.h>
+#include <ortc/internal/ortc_RTCPPacket.h>
+#include <ortc/internal/ortc_RTPUtils.h>
+
+#include <ortc/services/IHelper.h>
+
+#include <zsLib/XML.h>
+
+#include "config.h"
+#include "testing.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <list>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif //__linux__
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::String;
+using zsLib::BYTE;
+using zsLib::WORD;
+using zsLib::DWORD;
+using zsLib::ULONG;
+using zsLib::ULONGLONG;
+using namespace zsLib::XML;
+
+ZS_DECLARE_TYPEDEF_PTR(ortc::services::IHelper, UseServicesHelper)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace packetbenchmark
+    {
+      ZS_DECLARE_USING_PTR(ortc::internal, RTPPacket)
+      ZS_DECLARE_USING_PTR(ortc::internal, RTCPPacket)
+      using ortc::internal::RTPUtils;
+
+      typedef std::vector<BYTE> Buffer;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark CacheMissCounter
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      // Hardware cache-miss counter for the calling thread (Linux perf events
+      // only); unavailable when the kernel or perf_event_paranoid refuses it.
+      class CacheMissCounter
+      {
+      public:
+        //---------------------------------------------------------------------
+        CacheMissCounter()
+        {
+#ifdef __linux__
+          struct perf_event_attr attr {};
+          attr.type = PERF_TYPE_HARDWARE;
+          attr.size = sizeof(attr);
+          attr.config = PERF_COUNT_HW_CACHE_MISSES;
+          attr.disabled = 1;
+          attr.exclude_kernel = 1;
+          attr.exclude_hv = 1;
+          mFD = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif //__linux__
+        }
+
+        //---------------------------------------------------------------------
+        ~CacheMissCounter()
+        {
+#ifdef __linux__
+          if (mFD >= 0) close(mFD);
+#endif //__linux__
+        }
+
+        //---------------------------------------------------------------------
+        bool isAvailable() const {return mFD >= 0;}
+
+        //---------------------------------------------------------------------
+        void start()
+        {
+#ifdef __linux__
+          if (mFD < 0) return;
+          ioctl(mFD, PERF_EVENT_IOC_RESET, 0);
+          ioctl(mFD, PERF_EVENT_IOC_ENABLE, 0);
+#endif //__linux__
+        }
+
+        //---------------------------------------------------------------------
+        ULONGLONG stop()
+        {
+#ifdef __linux__
+          if (mFD < 0) return 0;
+          ioctl(mFD, PERF_EVENT_IOC_DISABLE, 0);
+          long long value = 0;
+          if (static_cast<ssize_t>(sizeof(value)) != read(mFD, &value, sizeof(value))) return 0;
+          return static_cast<ULONGLONG>(value);
+#else
+          return 0;
+#endif //__linux__
+        }
+
+      protected:
+        int mFD {-1};
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark Corpus
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      struct Sample
+      {
+        String mName;
+        Buffer mBuffer;
+      };
+
+      typedef std::list<Sample> SampleList;
+
+      //-----------------------------------------------------------------------
+      static Buffer toBuffer(RTPPacketPtr packet)
+      {
+        return Buffer(packet->ptr(), packet->ptr() + packet->size());
+      }
+
+      //-----------------------------------------------------------------------
+      static void createRTPCorpus(SampleList &outSamples)
+      {
+        BYTE payload[1200] {};
+        for (size_t index = 0; index < sizeof(payload); ++index) {
+          payload[index] = static_cast<BYTE>(index);
+        }
+
+        // audio: one-byte ssrc-audio-level extension
+        {
+          BYTE level[1] = {0x85};
+          RTPPacket::HeaderExtension ext1;
+          ext1.mID = 1;
+          ext1.mData = level;
+          ext1.mDataSizeInBytes = sizeof(level);
+
+          RTPPacket::CreationParams params;
+          params.mPT = 111;
+          params.mSequenceNumber = 4321;
+          params.mTimestamp = 960000;
+          params.mSSRC = 0x11111111;
+          params.mPayload = payload;
+          params.mPayloadSize = 160;
+          params.mFirstHeaderExtension = &ext1;
+
+          outSamples.push_back(Sample {"rtp-audio-1byte-ext", toBuffer(RTPPacket::create(params))});
+        }
+
+        // video: CSRCs plus one-byte abs-send-time, mid, rid and transport-cc
+        {
+          BYTE absSendTime[3] = {0x12, 0x34, 0x56};
+          BYTE mid[1] = {'0'};
+          BYTE rid[2] = {'h', 'i'};
+          BYTE transportCC[2] = {0x01, 0x02};
+
+          RTPPacket::HeaderExtension ext1, ext2, ext3, ext4;
+          ext1.mID = 2; ext1.mData = absSendTime; ext1.mDataSizeInBytes = sizeof(absSendTime); ext1.mNext = &ext2;
+          ext2.mID = 3; ext2.mData = mid; ext2.mDataSizeInBytes = sizeof(mid); ext2.mNext = &ext3;
+          ext3.mID = 4; ext3.mData = rid; ext3.mDataSizeInBytes = sizeof(rid); ext3.mNext = &ext4;
+          ext4.mID = 5; ext4.mData = transportCC; ext4.mDataSizeInBytes = sizeof(transportCC);
+
+          DWORD csrcs[2] = {0x22222222, 0x33333333};
+
+          RTPPacket::CreationParams params;
+          params.mM = true;
+          params.mPT = 96;
+          params.mSequenceNumber = 10;
+          params.mTimestamp = 90000;
+          params.mSSRC = 0x44444444;
+          params.mCC = 2;
+          params.mCSRCList = csrcs;
+          params.mPayload = payload;
+          params.mPayloadSize = 1100;
+          params.mFirstHeaderExtension = &ext1;
+
+          outSamples.push_back(Sample {"rtp-video-csrc-1byte-ext", toBuffer(RTPPacket::create(params))});
+        }
+
+        // two-byte extension header (extension data longer than 16 bytes)
+        {
+          BYTE longValue[20] {};
+          RTPPacket::HeaderExtension ext1;
+          ext1.mID = 7;
+          ext1.mData = longValue;
+          ext1.mDataSizeInBytes = sizeof(longValue);
+
+          RTPPacket::CreationParams params;
+          params.mPT = 96;
+          params.mSequenceNumber = 11;
+          params.mTimestamp = 93000;
+          params.mSSRC = 0x55555555;
+          params.mPayload = payload;
+          params.mPayloadSize = 1000;
+          params.mFirstHeaderExtension = &ext1;
+
+          outSamples.push_back(Sample {"rtp-video-2byte-ext", toBuffer(RTPPacket::create(params))});
+        }
+
+        // padding (as used for bandwidth probing)
+        {
+          RTPPacket::CreationParams params;
+          params.mPT = 96;
+          params.mSequenceNumber = 12;
+          params.mTimestamp = 96000;
+          params.mSSRC = 0x66666666;
+          params.mPadding = 32;
+          params.mPayload = payload;
+          params.mPayloadSize = 500;
+
+          outSamples.push_back(Sample {"rtp-video-padding", toBuffer(RTPPacket::create(params))});
+        }
+
+        // plain header, full-size payload
+        {
+          RTPPacket::CreationParams params;
+          params.mPT = 96;
+          params.mSequenceNumber = 13;
+          params.mTimestamp = 99000;
+          params.mSSRC = 0x77777777;
+          params.mPayload = payload;
+          params.mPayloadSize = sizeof(payload);
+
+          outSamples.push_back(Sample {"rtp-video-plain", toBuffer(RTPPacket::create(params))});
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTCPWriter
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      // Hand assembles wire-format RTCP so the parse corpus does not depend on
+      // the serializer being measured.
+      class RTCPWriter
+      {
+      public:
+        //---------------------------------------------------------------------
+        void header(
+                    BYTE countOrFormat,
+                    BYTE pt,
+                    size_t totalSizeInBytes
+                    )
+        {
+          put8(static_cast<BYTE>(0x80 | (countOrFormat & 0x1F)));
+          put8(pt);
+          put16(static_cast<WORD>((totalSizeInBytes / 4) - 1));
+        }
+
+        //---------------------------------------------------------------------
+        void put8(BYTE value) {mBuffer.push_back(value);}
+
+        //---------------------------------------------------------------------
+        void put16(WORD value)
+        {
+          BYTE temp[2];
+          RTPUtils::setBE16(temp, value);
+          mBuffer.insert(mBuffer.end(), temp, temp + sizeof(temp));
+        }
+
+        //---------------------------------------------------------------------
+        void put32(DWORD value)
+        {
+          BYTE temp[4];
+          RTPUtils::setBE32(temp, value);
+          mBuffer.insert(mBuffer.end(), temp, temp + sizeof(temp));
+        }
+
+        //---------------------------------------------------------------------
+        void reportBlock(DWORD ssrc)
+        {
+          put32(ssrc);
+          put32(0x05000010);      // fraction lost, cumulative lost
+          put32(0x00010203);      // extended highest sequence
+          put32(20);              // jitter
+          put32(0x12345678);      // LSR
+          put32(0x00001000);      // DLSR
+        }
+
+        //---------------------------------------------------------------------
+        Buffer &buffer() {return mBuffer;}
+
+      protected:
+        Buffer mBuffer;
+      };
+
+      //-----------------------------------------------------------------------
+      static void createRTCPCorpus(SampleList &outSamples)
+      {
+        const DWORD senderSSRC = 0x11111111;
+        const DWORD mediaSSRC = 0x44444444;
+
+        RTCPWriter compound;
+        RTCPWriter srOnly;
+
+        for (int loop = 0; loop < 2; ++loop) {
+          RTCPWriter &writer = (0 == loop ? srOnly : compound);
+
+          // SR with one report block
+          writer.header(1, 200, 52);
+          writer.put32(senderSSRC);
+          writer.put32(0xDA000000);  // NTP MSW
+          writer.put32(0x80000000);  // NTP LSW
+          writer.put32(960000);
+          writer.put32(1000);
+          writer.put32(160000);
+          writer.reportBlock(mediaSSRC);
+
+          if (0 == loop) continue;
+
+          // RR with one report block
+          writer.header(1, 201, 32);
+          writer.put32(senderSSRC);
+          writer.reportBlock(0x77777777);
+
+          // SDES with a CNAME chunk
+          writer.header(1, 202, 28);
+          writer.put32(senderSSRC);
+          writer.put8(1);            // CNAME
+          writer.put8(16);
+          for (int index = 0; index < 16; ++index) {writer.put8(static_cast<BYTE>('a' + index));}
+          writer.put8(0);            // END
+          writer.put8(0);
+          writer.put8(0);            // pad chunk to 32 bits
+
+          // PSFB REMB
+          writer.header(15, 206, 24);
+          writer.put32(senderSSRC);
+          writer.put32(0);
+          writer.put8('R'); writer.put8('E'); writer.put8('M'); writer.put8('B');
+          writer.put32((1 << 24) | (2 << 18) | 0x3FFFF);
+          writer.put32(mediaSSRC);
+
+          // RTPFB generic NACK with two FCI entries
+          writer.header(1, 205, 20);
+          writer.put32(senderSSRC);
+          writer.put32(mediaSSRC);
+          writer.put16(100); writer.put16(0x0005);
+          writer.put16(140); writer.put16(0x8001);
+
+          // XR with RRTR and DLRR blocks
+          writer.header(0, 207, 36);
+          writer.put32(senderSSRC);
+          writer.put8(4); writer.put8(0); writer.put16(2);
+          writer.put32(0xDA000000);
+          writer.put32(0x80000000);
+          writer.put8(5); writer.put8(0); writer.put16(3);
+          writer.put32(mediaSSRC);
+          writer.put32(0x12345678);
+          writer.put32(0x00001000);
+        }
+
+        outSamples.push_back(Sample {"rtcp-sr", srOnly.buffer()});
+        outSamples.push_back(Sample {"rtcp-compound-sr-rr-sdes-remb-nack-xr", compound.buffer()});
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark Measurement
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      struct Result
+      {
+        String mSample;
+        String mOperation;
+        size_t mPacketSize {};
+        ULONG mIterations {};
+        double mNanosecondsPerPacket {};
+        double mAllocationsPerPacket {};
+        double mBytesAllocatedPerPacket {};
+        bool mCacheMissesAvailable {false};
+        double mCacheMissesPerPacket {};
+
+        //---------------------------------------------------------------------
+        ElementPtr createElement() const
+        {
+          ElementPtr resultEl = Element::create("result");
+
+          UseServicesHelper::adoptElementValue(resultEl, "sample", mSample, false);
+          UseServicesHelper::adoptElementValue(resultEl, "operation", mOperation, false);
+          UseServicesHelper::adoptElementValue(resultEl, "packetSize", mPacketSize);
+          UseServicesHelper::adoptElementValue(resultEl, "iterations", mIterations);
+          UseServicesHelper::adoptElementValue(resultEl, "nsPerPacket", mNanosecondsPerPacket);
+          UseServicesHelper::adoptElementValue(resultEl, "allocationsPerPacket", mAllocationsPerPacket);
+          UseServicesHelper::adoptElementValue(resultEl, "bytesAllocatedPerPacket", mBytesAllocatedPerPacket);
+          if (mCacheMissesAvailable) {
+            UseServicesHelper::adoptElementValue(resultEl, "cacheMissesPerPacket", mCacheMissesPerPacket);
+          }
+
+          return resultEl;
+        }
+      };
+
+      typedef std::list<Result> ResultList;
+
+      //-----------------------------------------------------------------------
+      template <typename Operation>
+      static Result measure(
+                           CacheMissCounter &cacheMisses,
+                           const Sample &sample,
+                           const char *operationName,
+                           ULONG iterations,
+                           Operation operation
+                           )
+      {
+        typedef std::chrono::steady_clock Clock;
+
+        // warm caches and any lazily created singletons before timing
+        for (ULONG loop = 0; loop < (iterations / 10) + 1; ++loop) {
+          operation();
+        }
+
+        ULONGLONG allocationsBefore = Testing::allocationCount();
+        ULONGLONG bytesBefore = Testing::allocationBytes();
+        cacheMisses.start();
+        auto start = Clock::now();
+
+        for (ULONG loop = 0; loop < iterations; ++loop) {
+          operation();
+        }
+
+        auto elapsed = Clock::now() - start;
+        ULONGLONG misses = cacheMisses.stop();
+        ULONGLONG allocations = Testing::allocationCount() - allocationsBefore;
+        ULONGLONG bytes = Testing::allocationBytes() - bytesBefore;
+
+        double count = static_cast<double>(iterations);
+
+        Result result;
+        result.mSample = sample.mName;
+        result.mOperation = operationName;
+        result.mPacketSize = sample.mBuffer.size();
+        result.mIterations = iterations;
+        result.mNanosecondsPerPacket = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / count;
+        result.mAllocationsPerPacket = static_cast<double>(allocations) / count;
+        result.mBytesAllocatedPerPacket = static_cast<double>(bytes) / count;
+        result.mCacheMissesAvailable = cacheMisses.isAvailable();
+        result.mCacheMissesPerPacket = static_cast<double>(misses) / count;
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      static void output(const ResultList &results)
+      {
+        for (auto iter = results.begin(); iter != results.end(); ++iter) {
+          auto &result = (*iter);
+          TESTING_STDOUT() << "BENCHMARK:    " << result.mSample << " " << result.mOperation
+                           << " size=" << result.mPacketSize
+                           << " ns/packet=" << result.mNanosecondsPerPacket
+                           << " allocs/packet=" << result.mAllocationsPerPacket
+                           << " bytes/packet=" << result.mBytesAllocatedPerPacket;
+          if (result.mCacheMissesAvailable) {
+            TESTING_STDOUT() << " cache-misses/packet=" << result.mCacheMissesPerPacket;
+          }
+          TESTING_STDOUT() << "\n";
+        }
+
+        const char *jsonFile = getenv("ORTC_TEST_PACKET_BENCHMARK_JSON");
+        if ((!jsonFile) || ('\0' == *jsonFile)) jsonFile = ORTC_TEST_PACKET_BENCHMARK_JSON_FILE;
+        if ('\0' == *jsonFile) return;
+
+        ElementPtr rootEl = Element::create("packetBenchmark");
+        UseServicesHelper::adoptElementValue(rootEl, "allocationsCounted", (bool)ORTC_TEST_COUNT_ALLOCATIONS);
+
+        ElementPtr resultsEl = Element::create("results");
+        for (auto iter = results.begin(); iter != results.end(); ++iter) {
+          resultsEl->adoptAsLastChild((*iter).createElement());
+        }
+        rootEl->adoptAsLastChild(resultsEl);
+
+        std::ofstream file(jsonFile, std::ios::out | std::ios::trunc);
+        file << UseServicesHelper::toString(rootEl).c_str() << "\n";
+
+        TESTING_STDOUT() << "BENCHMARK:    wrote JSON results to " << jsonFile << "\n";
+      }
+
+    }
+  }
+}
+
+void doTestPacketBenchmark()
+{
+  if (!ORTC_TEST_DO_PACKET_BENCHMARK) return;
+
+  using namespace ortc::test::packetbenchmark;
+
+  const ULONG iterations = ORTC_TEST_PACKET_BENCHMARK_ITERATIONS;
+  const ULONG debugIterations = ORTC_TEST_PACKET_BENCHMARK_DEBUG_ITERATIONS;
+
+  SampleList rtpSamples;
+  SampleList rtcpSamples;
+  createRTPCorpus(rtpSamples);
+  createRTCPCorpus(rtcpSamples);
+
+  CacheMissCounter cacheMisses;
+  ResultList results;
+
+  for (auto iter = rtpSamples.begin(); iter != rtpSamples.end(); ++iter) {
+    const Sample &sample = (*iter);
+    const BYTE *buffer = &(sample.mBuffer[0]);
+    size_t size = sample.mBuffer.size();
+
+    RTPPacketPtr parsed = RTPPacket::create(buffer, size);
+    TESTING_CHECK(parsed)
+    if (!parsed) continue;
+
+    std::vector<DWORD> csrcs;
+    for (size_t index = 0; index < parsed->cc(); ++index) {
+      csrcs.push_back(parsed->getCSRC(index));
+    }
+
+    RTPPacket::CreationParams params;
+    params.mVersion = parsed->version();
+    params.mPadding = parsed->padding();
+    params.mM = parsed->m();
+    params.mPT = parsed->pt();
+    params.mSequenceNumber = parsed->sequenceNumber();
+    params.mTimestamp = parsed->timestamp();
+    params.mSSRC = parsed->ssrc();
+    params.mCC = csrcs.size();
+    params.mCSRCList = (csrcs.size() > 0 ? &(csrcs[0]) : NULL);
+    params.mPayload = parsed->payload();
+    params.mPayloadSize = parsed->payloadSize();
+    params.mFirstHeaderExtension = parsed->firstHeaderExtension();
+
+    results.push_back(measure(cacheMisses, sample, "parse", iterations, [buffer, size]() {
+      RTPPacket::create(buffer, size);
+    }));
+    results.push_back(measure(cacheMisses, sample, "serialize", iterations, [&params]() {
+      RTPPacket::create(params);
+    }));
+    results.push_back(measure(cacheMisses, sample, "toDebug", debugIterations, [&parsed]() {
+      parsed->toDebug();
+    }));
+  }
+
+  for (auto iter = rtcpSamples.begin(); iter != rtcpSamples.end(); ++iter) {
+    const Sample &sample = (*iter);
+    const BYTE *buffer = &(sample.mBuffer[0]);
+    size_t size = sample.mBuffer.size();
+
+    RTCPPacketPtr parsed = RTCPPacket::create(buffer, size);
+    TESTING_CHECK(parsed)
+    if (!parsed) continue;
+
+    TESTING_CHECK(NULL != parsed->first())
+
+    results.push_back(measure(cacheMisses, sample, "parse", iterations, [buffer, size]() {
+      RTCPPacket::create(buffer, size);
+    }));
+    results.push_back(measure(cacheMisses, sample, "serialize", iterations, [&parsed]() {
+      RTCPPacket::generateFrom(parsed->first());
+    }));
+    results.push_back(measure(cacheMisses, sample, "toDebug", debugIterations, [&parsed]() {
+      parsed->toDebug();
+    }));
+  }
+
+  output(results);
+}
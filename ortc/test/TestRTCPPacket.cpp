@@ -31,6 +31,7 @@
 
 
 #include <ortc/internal/ortc_RTCPPacket.h>
+#include <ortc/internal/ortc_RTCPAggregator.h>
 #include <ortc/internal/ortc_Helper.h>
 
 #include <ortc/services/IHelper.h>
@@ -3455,6 +3456,206 @@ static signed gSeeds[] = {2286, 2075, -57479, 1000, 1001, -17, 89, -97, 523, 104
 
 using namespace ortc::test;
 
+ZS_DECLARE_USING_PTR(ortc::internal, RTCPAggregator)
+ZS_DECLARE_USING_PTR(ortc::services, SecureByteBlock)
+
+//-----------------------------------------------------------------------------
+static SecureByteBlockPtr createAggregatorRR(
+                                             DWORD ssrcOfSender,
+                                             size_t totalReportBlocks = 1
+                                             )
+{
+  // 8 byte header + 24 bytes per report block
+  RTCPPacket::ReceiverReport rr;
+  RTCPPacket::SenderReceiverCommonReport::ReportBlock blocks[10];
+  TESTING_CHECK(totalReportBlocks <= (sizeof(blocks) / sizeof(blocks[0])))
+
+  rr.mVersion = 2;
+  rr.mPT = RTCPPacket::ReceiverReport::kPayloadType;
+  rr.mSSRCOfSender = ssrcOfSender;
+  rr.mReportSpecific = static_cast<BYTE>(totalReportBlocks);
+  for (size_t index = 0; index < totalReportBlocks; ++index) {
+    blocks[index].mSSRC = ssrcOfSender + 1 + static_cast<DWORD>(index);
+    if (index > 0) blocks[index-1].mNext = &(blocks[index]);
+  }
+  if (totalReportBlocks > 0) rr.mFirstReportBlock = &(blocks[0]);
+
+  auto packet = RTCPPacket::create(&rr);
+  TESTING_CHECK(packet)
+  return packet->buffer();
+}
+
+//-----------------------------------------------------------------------------
+static SecureByteBlockPtr createAggregatorSDES(DWORD ssrc)
+{
+  RTCPPacket::SDES sdes;
+  RTCPPacket::SDES::Chunk chunk;
+
+  sdes.mVersion = 2;
+  sdes.mPT = RTCPPacket::SDES::kPayloadType;
+  sdes.mReportSpecific = 1;
+  chunk.mSSRC = ssrc;
+  sdes.mFirstChunk = &chunk;
+
+  auto packet = RTCPPacket::create(&sdes);
+  TESTING_CHECK(packet)
+  return packet->buffer();
+}
+
+//-----------------------------------------------------------------------------
+static SecureByteBlockPtr createAggregatorBye(DWORD ssrc)
+{
+  RTCPPacket::Bye bye;
+  DWORD ssrcs[1] = {ssrc};
+
+  bye.mVersion = 2;
+  bye.mPT = RTCPPacket::Bye::kPayloadType;
+  bye.mReportSpecific = 1;
+  bye.mSSRCs = &(ssrcs[0]);
+
+  auto packet = RTCPPacket::create(&bye);
+  TESTING_CHECK(packet)
+  return packet->buffer();
+}
+
+//-----------------------------------------------------------------------------
+static bool queueAggregator(
+                            RTCPAggregatorPtr aggregator,
+                            SecureByteBlockPtr buffer,
+                            const zsLib::Time &now,
+                            bool &outFlushNow
+                            )
+{
+  return aggregator->queue(buffer->BytePtr(), buffer->SizeInBytes(), now, outFlushNow);
+}
+
+//-----------------------------------------------------------------------------
+static size_t countReceiverReports(SecureByteBlockPtr buffer)
+{
+  auto packet = RTCPPacket::create(*buffer);
+  TESTING_CHECK(packet)
+  if (!packet) return 0;
+
+  size_t result = 0;
+  for (auto rr = packet->firstReceiverReport(); NULL != rr; rr = rr->nextReceiverReport()) {
+    ++result;
+  }
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+static void testRTCPAggregator()
+{
+  RTCPAggregator::Settings settings;
+  settings.mMaxPacketSize = 200;
+  settings.mMaxDelay = zsLib::Milliseconds(20);
+  settings.mMaxTimingReportDelay = zsLib::Milliseconds(5);
+  settings.mMinBandwidthBytesPerSecond = 100000;   // keep the bandwidth hold out of the way
+
+  zsLib::Time now = zsLib::now();
+  bool flushNow = false;
+
+  TESTING_EQUAL(createAggregatorRR(1000)->SizeInBytes(), 32)
+
+  // SR/RR wait for the (short) timing report delay, not the full delay, and
+  // come first in the packed compound packet
+  {
+    auto aggregator = RTCPAggregator::create(settings);
+
+    TESTING_CHECK(queueAggregator(aggregator, createAggregatorSDES(2000), now, flushNow))
+    TESTING_CHECK(!flushNow)
+    TESTING_CHECK(now + settings.mMaxDelay == aggregator->nextFlush(now))
+
+    TESTING_CHECK(queueAggregator(aggregator, createAggregatorRR(1000), now + zsLib::Milliseconds(1), flushNow))
+    TESTING_CHECK(!flushNow)
+    TESTING_CHECK(now + zsLib::Milliseconds(1) + settings.mMaxTimingReportDelay == aggregator->nextFlush(now + zsLib::Milliseconds(1)))
+
+    RTCPAggregator::BufferList buffers;
+    aggregator->flush(now + zsLib::Milliseconds(6), buffers);
+    TESTING_EQUAL(buffers.size(), 1)
+    TESTING_CHECK(!aggregator->hasPending())
+
+    auto packet = RTCPPacket::create(*(buffers.front()));
+    TESTING_CHECK(packet)
+    TESTING_EQUAL(packet->first()->pt(), RTCPPacket::ReceiverReport::kPayloadType)
+    TESTING_CHECK(NULL != packet->firstSDES())
+  }
+
+  // a zero timing report delay restores flushing SR/RR at once
+  {
+    RTCPAggregator::Settings immediateSettings(settings);
+    immediateSettings.mMaxTimingReportDelay = zsLib::Milliseconds();
+
+    auto aggregator = RTCPAggregator::create(immediateSettings);
+    TESTING_CHECK(queueAggregator(aggregator, createAggregatorRR(1000), now, flushNow))
+    TESTING_CHECK(flushNow)
+  }
+
+  // packing boundary: 6 x 32 bytes fit within 200 bytes, the 7th reaches
+  // the limit and forces a flush which splits at the MTU
+  {
+    auto aggregator = RTCPAggregator::create(settings);
+
+    for (DWORD loop = 0; loop < 6; ++loop) {
+      TESTING_CHECK(queueAggregator(aggregator, createAggregatorRR(1000 + (loop * 100)), now, flushNow))
+      TESTING_CHECK(!flushNow)
+    }
+    TESTING_CHECK(queueAggregator(aggregator, createAggregatorRR(1600), now, flushNow))
+    TESTING_CHECK(flushNow)
+
+    RTCPAggregator::BufferList buffers;
+    aggregator->flush(now, buffers);
+    TESTING_EQUAL(buffers.size(), 2)
+
+    for (auto iter = buffers.begin(); iter != buffers.end(); ++iter) {
+      TESTING_CHECK((*iter)->SizeInBytes() <= settings.mMaxPacketSize)
+    }
+    TESTING_EQUAL(buffers.front()->SizeInBytes(), 192)
+    TESTING_EQUAL(countReceiverReports(buffers.front()), 6)
+    TESTING_EQUAL(buffers.back()->SizeInBytes(), 32)
+    TESTING_EQUAL(countReceiverReports(buffers.back()), 1)
+  }
+
+  // a newer plain report from the same SSRC replaces the pending one
+  {
+    auto aggregator = RTCPAggregator::create(settings);
+
+    TESTING_CHECK(queueAggregator(aggregator, createAggregatorRR(1000), now, flushNow))
+    TESTING_CHECK(queueAggregator(aggregator, createAggregatorRR(1000), now + zsLib::Milliseconds(2), flushNow))
+    TESTING_CHECK(!flushNow)
+
+    // superseding keeps the original hold deadline
+    TESTING_CHECK(now + settings.mMaxTimingReportDelay == aggregator->nextFlush(now + zsLib::Milliseconds(2)))
+
+    RTCPAggregator::BufferList buffers;
+    aggregator->flush(now + zsLib::Milliseconds(5), buffers);
+    TESTING_EQUAL(buffers.size(), 1)
+    TESTING_EQUAL(countReceiverReports(buffers.front()), 1)
+  }
+
+  // BYE is urgent and packets at or above the MTU bypass the aggregator
+  {
+    auto aggregator = RTCPAggregator::create(settings);
+
+    TESTING_CHECK(!queueAggregator(aggregator, createAggregatorRR(1000, 8), now, flushNow))
+    TESTING_CHECK(!aggregator->hasPending())
+
+    TESTING_CHECK(queueAggregator(aggregator, createAggregatorSDES(2000), now, flushNow))
+    TESTING_CHECK(!flushNow)
+    TESTING_CHECK(queueAggregator(aggregator, createAggregatorBye(2000), now, flushNow))
+    TESTING_CHECK(flushNow)
+
+    RTCPAggregator::BufferList buffers;
+    aggregator->flush(now, buffers);
+    TESTING_EQUAL(buffers.size(), 1)
+
+    auto packet = RTCPPacket::create(*(buffers.front()));
+    TESTING_CHECK(packet)
+    TESTING_CHECK(NULL != packet->firstSDES())
+    TESTING_CHECK(NULL != packet->firstBye())
+  }
+}
+
 void doTestRTCPPacket()
 {
   if (!ORTC_TEST_DO_RTCP_PACKET_TEST) return;
@@ -3465,6 +3666,8 @@ void doTestRTCPPacket()
 
   UseSettings::applyDefaults();
 
+  testRTCPAggregator();
+
   auto thread(zsLib::IMessageQueueThread::createBasic());
 
   TesterPtr testObject1;
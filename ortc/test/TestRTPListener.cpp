@@ -1688,12 +1688,14 @@ using ortc::IICETypes;
 using zsLib::Optional;
 using zsLib::WORD;
 using zsLib::BYTE;
+using zsLib::DWORD;
 using zsLib::Milliseconds;
 using ortc::SecureByteBlock;
 using ortc::SecureByteBlockPtr;
 
 #define TEST_BASIC_ROUTING 0
 #define TEST_BASIC_ROUTING_EXTENDED_SOURCE 1
+#define TEST_RTCP_ROUTING 2
 
 static void bogusSleep()
 {
@@ -1703,6 +1705,97 @@ static void bogusSleep()
   }
 }
 
+// builds a (compound) RTCP packet; a zero SSRC leaves that report out
+static RTCPPacketPtr createRoutingRTCPPacket(
+                                             DWORD srSSRC,
+                                             DWORD rrReportBlockSSRC,
+                                             DWORD sdesSSRC,
+                                             DWORD dlrrSSRC,
+                                             DWORD byeSSRC
+                                             )
+{
+  typedef RTCPPacket::Report Report;
+  typedef RTCPPacket::SenderReport SenderReport;
+  typedef RTCPPacket::ReceiverReport ReceiverReport;
+  typedef RTCPPacket::SenderReceiverCommonReport::ReportBlock CommonReportBlock;
+  typedef RTCPPacket::SDES SDES;
+  typedef RTCPPacket::XR XR;
+  typedef RTCPPacket::XR::DLRRReportBlock DLRRReportBlock;
+  typedef RTCPPacket::Bye Bye;
+
+  const DWORD remoteSSRC = 5000;   // not known to the listener
+
+  SenderReport sr;
+  ReceiverReport rr;
+  CommonReportBlock rrBlock;
+  SDES sdes;
+  SDES::Chunk sdesChunk;
+  XR xr;
+  DLRRReportBlock dlrr;
+  DLRRReportBlock::SubBlock dlrrSubBlock;
+  Bye bye;
+  DWORD byeSSRCs[1] = {byeSSRC};
+
+  Report *first = NULL;
+  Report *last = NULL;
+
+  auto append = [&first, &last](Report *report) {
+    report->mVersion = 2;
+    if (NULL == first) first = report;
+    if (NULL != last) last->mNext = report;
+    last = report;
+  };
+
+  if (0 != srSSRC) {
+    sr.mPT = SenderReport::kPayloadType;
+    sr.mSSRCOfSender = srSSRC;
+    append(&sr);
+  }
+
+  if (0 != rrReportBlockSSRC) {
+    rr.mPT = ReceiverReport::kPayloadType;
+    rr.mSSRCOfSender = remoteSSRC;
+    rrBlock.mSSRC = rrReportBlockSSRC;
+    rr.mReportSpecific = 1;
+    rr.mFirstReportBlock = &rrBlock;
+    append(&rr);
+  }
+
+  if (0 != sdesSSRC) {
+    sdes.mPT = SDES::kPayloadType;
+    sdesChunk.mSSRC = sdesSSRC;
+    sdes.mReportSpecific = 1;
+    sdes.mFirstChunk = &sdesChunk;
+    append(&sdes);
+  }
+
+  if (0 != dlrrSSRC) {
+    // DLRR answers the RRTR a local receiver sent from its own RTCP SSRC
+    xr.mPT = XR::kPayloadType;
+    xr.mSSRC = remoteSSRC;
+    dlrrSubBlock.mSSRC = dlrrSSRC;
+    dlrr.mBlockType = DLRRReportBlock::kBlockType;
+    dlrr.mSubBlockCount = 1;
+    dlrr.mSubBlocks = &dlrrSubBlock;
+    xr.mReportBlockCount = 1;
+    xr.mFirstReportBlock = &dlrr;
+    xr.mDLRRReportBlockCount = 1;
+    xr.mFirstDLRRReportBlock = &dlrr;
+    append(&xr);
+  }
+
+  if (0 != byeSSRC) {
+    bye.mPT = Bye::kPayloadType;
+    bye.mReportSpecific = 1;
+    bye.mSSRCs = &(byeSSRCs[0]);
+    append(&bye);
+  }
+
+  auto packet = RTCPPacket::create(first);
+  TESTING_CHECK(packet)
+  return packet;
+}
+
 void doTestRTPListener()
 {
   typedef ortc::IRTPTypes IRTPTypes;
@@ -1775,6 +1868,22 @@ void doTestRTPListener()
           expectations1.mUnhandled = 0;
           break;
         }
+        case TEST_RTCP_ROUTING:
+        {
+          testObject1 = RTPListenerTester::create(thread);
+          testObject2 = RTPListenerTester::create(thread);
+
+          TESTING_CHECK(testObject1)
+          TESTING_CHECK(testObject2)
+
+          testObject1->setClientRole(true);
+          testObject2->setClientRole(false);
+
+          // sr(2) + rr(2) + sdes(2) + dlrr(2) + compound(4) + bye(2)
+          expectations1.mReceivedPackets = 14;
+          expectations1.mUnhandled = 0;
+          break;
+        }
         default:  quit = true; break;
       }
       if (quit) break;
@@ -2096,6 +2205,131 @@ void doTestRTPListener()
             }
             break;
           }
+          case TEST_RTCP_ROUTING: {
+            // r1 receives SSRC 100 (sending its own RTCP from 1100), r2
+            // receives SSRC 200, r3 has no SSRC (thus is an RTCP wildcard)
+            // and s3 sends SSRC 300
+            switch (step) {
+              case 1: {
+                if (testObject1) testObject1->connect(testObject2);
+                if (testObject1) testObject1->state(IICETransport::State_Completed);
+                if (testObject2) testObject2->state(IICETransport::State_Completed);
+                if (testObject1) testObject1->state(IDTLSTransportTypes::State_Connected);
+                if (testObject2) testObject2->state(IDTLSTransportTypes::State_Connected);
+                break;
+              }
+              case 2: {
+                Parameters params;
+                testObject2->send("s1", params);
+
+                EncodingParameters encoding;
+
+                Parameters params1;
+                encoding.mSSRC = 100;
+                params1.mEncodings.push_back(encoding);
+                params1.mRTCP.mSSRC = 1100;
+                testObject1->receive("r1", params1);
+
+                Parameters params2;
+                encoding.mSSRC = 200;
+                params2.mEncodings.push_back(encoding);
+                params2.mRTCP.mSSRC = 1200;
+                testObject1->receive("r2", params2);
+
+                Parameters params3;
+                testObject1->receive("r3", params3);
+
+                Parameters params4;
+                encoding.mSSRC = 300;
+                params4.mEncodings.push_back(encoding);
+                testObject1->send("s3", params4);
+                break;
+              }
+              case 3: {
+                auto packet = createRoutingRTCPPacket(100, 0, 0, 0, 0);
+                testObject1->store("sr", packet);
+                testObject2->store("sr", packet);
+
+                packet = createRoutingRTCPPacket(0, 300, 0, 0, 0);
+                testObject1->store("rr", packet);
+                testObject2->store("rr", packet);
+
+                packet = createRoutingRTCPPacket(0, 0, 200, 0, 0);
+                testObject1->store("sdes", packet);
+                testObject2->store("sdes", packet);
+
+                packet = createRoutingRTCPPacket(0, 0, 0, 1100, 0);
+                testObject1->store("dlrr", packet);
+                testObject2->store("dlrr", packet);
+
+                packet = createRoutingRTCPPacket(200, 300, 100, 0, 0);
+                testObject1->store("compound", packet);
+                testObject2->store("compound", packet);
+
+                packet = createRoutingRTCPPacket(0, 0, 0, 0, 200);
+                testObject1->store("bye", packet);
+                testObject2->store("bye", packet);
+                break;
+              }
+              case 4: {
+                // SR from a sender SSRC reaches its receiver
+                testObject1->expectPacket("r1", "sr");
+                testObject1->expectPacket("r3", "sr");
+                testObject2->sendPacket("s1", "sr");
+                break;
+              }
+              case 5: {
+                // RR report block about a sent SSRC reaches the sender
+                testObject1->expectPacket("s3", "rr");
+                testObject1->expectPacket("r3", "rr");
+                testObject2->sendPacket("s1", "rr");
+                break;
+              }
+              case 6: {
+                testObject1->expectPacket("r2", "sdes");
+                testObject1->expectPacket("r3", "sdes");
+                testObject2->sendPacket("s1", "sdes");
+                break;
+              }
+              case 7: {
+                // XR DLRR addressed to a receiver's own RTCP SSRC
+                testObject1->expectPacket("r1", "dlrr");
+                testObject1->expectPacket("r3", "dlrr");
+                testObject2->sendPacket("s1", "dlrr");
+                break;
+              }
+              case 8: {
+                testObject1->expectPacket("r1", "compound");
+                testObject1->expectPacket("r2", "compound");
+                testObject1->expectPacket("s3", "compound");
+                testObject1->expectPacket("r3", "compound");
+                testObject2->sendPacket("s1", "compound");
+                break;
+              }
+              case 9: {
+                testObject1->expectPacket("r2", "bye");
+                testObject1->expectPacket("r3", "bye");
+                testObject2->sendPacket("s1", "bye");
+                break;
+              }
+              case 10: {
+                if (testObject1) testObject1->state(IDTLSTransportTypes::State_Closed);
+                if (testObject2) testObject2->state(IDTLSTransportTypes::State_Closed);
+                if (testObject1) testObject1->state(IICETransport::State_Closed);
+                if (testObject2) testObject2->state(IICETransport::State_Closed);
+                break;
+              }
+              case 11: {
+                lastStepReached = true;
+                break;
+              }
+              default: {
+                // nothing happening in this step
+                break;
+              }
+            }
+            break;
+          }
           default: {
             // none defined
             break;
@@ -0,0 +1,234 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#include <ortc/internal/ortc_RTPPacketHistory.h>
+#include <ortc/internal/ortc_RTPPacket.h>
+#include <ortc/internal/ortc_RTCPPacket.h>
+#include <ortc/internal/ortc_RTPUtils.h>
+
+#include <zsLib/ISettings.h>
+
+#include "config.h"
+#include "testing.h"
+
+#include <cstring>
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::BYTE;
+using zsLib::WORD;
+using zsLib::Time;
+using zsLib::Milliseconds;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace rtppackethistory
+    {
+      ZS_DECLARE_USING_PTR(ortc::internal, RTPPacketHistory)
+      ZS_DECLARE_USING_PTR(ortc::internal, RTPPacket)
+      ZS_DECLARE_USING_PTR(ortc::internal, RTCPPacket)
+
+      typedef ortc::internal::RTPUtils RTPUtils;
+      typedef RTCPPacket::TransportLayerFeedbackMessage TransportLayerFeedbackMessage;
+      typedef TransportLayerFeedbackMessage::GenericNACK GenericNACK;
+
+      static const IRTPTypes::SSRCType kMediaSSRC {0x11111111};
+      static const IRTPTypes::SSRCType kRTXSSRC {0x22222222};
+      static const IRTPTypes::PayloadType kMediaPayloadType {96};
+      static const IRTPTypes::PayloadType kRTXPayloadType {97};
+
+      //-----------------------------------------------------------------------
+      static RTPPacketPtr createMediaPacket(WORD sequenceNumber)
+      {
+        BYTE payload[16] {};
+        for (size_t index = 0; index < sizeof(payload); ++index) {
+          payload[index] = static_cast<BYTE>(sequenceNumber + index);
+        }
+
+        RTPPacket::CreationParams params;
+        params.mPT = kMediaPayloadType;
+        params.mSequenceNumber = sequenceNumber;
+        params.mTimestamp = 90000 + sequenceNumber;
+        params.mSSRC = kMediaSSRC;
+        params.mPayload = &(payload[0]);
+        params.mPayloadSize = sizeof(payload);
+
+        return RTPPacket::create(params);
+      }
+
+      //-----------------------------------------------------------------------
+      // serializes then parses the NACK as it would arrive from the wire
+      static RTCPPacketPtr createNACK(
+                                      GenericNACK *entries,
+                                      size_t count
+                                      )
+      {
+        TransportLayerFeedbackMessage fb;
+        fb.mVersion = 2;
+        fb.mPT = TransportLayerFeedbackMessage::kPayloadType;
+        fb.mReportSpecific = GenericNACK::kFmt;
+        fb.mSSRCOfPacketSender = 0x33333333;
+        fb.mSSRCOfMediaSource = kMediaSSRC;
+        fb.mGenericNACKCount = count;
+        fb.mFirstGenericNACK = entries;
+
+        auto packet = RTCPPacket::create(&fb);
+        fb.mFirstGenericNACK = NULL;  // entries are owned by the caller
+        return packet;
+      }
+
+      //-----------------------------------------------------------------------
+      static void checkRTX(
+                           const RTPPacket &rtx,
+                           const RTPPacket &original
+                           )
+      {
+        TESTING_EQUAL(rtx.ssrc(), kRTXSSRC)
+        TESTING_EQUAL(rtx.pt(), kRTXPayloadType)
+        TESTING_EQUAL(rtx.timestamp(), original.timestamp())
+
+        // https://tools.ietf.org/html/rfc4588#section-4
+        TESTING_EQUAL(rtx.payloadSize(), original.payloadSize() + sizeof(WORD))
+        if (rtx.payloadSize() != original.payloadSize() + sizeof(WORD)) return;
+
+        TESTING_EQUAL(RTPUtils::getBE16(rtx.payload()), original.sequenceNumber())
+        TESTING_CHECK(0 == memcmp(&((rtx.payload())[sizeof(WORD)]), original.payload(), original.payloadSize()))
+      }
+    }
+  }
+}
+
+using namespace ortc::test::rtppackethistory;
+
+void doTestRTPPacketHistory()
+{
+  if (!ORTC_TEST_DO_RTP_PACKET_HISTORY_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+
+  {
+    RTPPacketHistory::Settings settings;
+    settings.mMaxPackets = 16;
+
+    auto history = RTPPacketHistory::create(settings, kRTXSSRC);
+    TESTING_CHECK(history)
+
+    RTPPacketHistory::PayloadTypeMap rtxPayloadTypes;
+    rtxPayloadTypes[kMediaPayloadType] = kRTXPayloadType;
+
+    Time now = zsLib::now();
+    Milliseconds rtt(100);
+
+    RTPPacketPtr originals[5];
+    for (size_t index = 0; index < 5; ++index) {
+      originals[index] = createMediaPacket(static_cast<WORD>(1000 + index));
+      TESTING_CHECK(originals[index])
+      history->store(originals[index], now);
+    }
+
+    WORD firstRTXSequenceNumber {};
+
+    // the same sequence number listed twice within one NACK is answered once
+    {
+      GenericNACK entries[2];
+      entries[0].mPID = 1002;
+      entries[1].mPID = 1002;
+
+      auto nack = createNACK(&(entries[0]), 2);
+      TESTING_CHECK(nack)
+      TESTING_CHECK(NULL != nack->firstTransportLayerFeedbackMessage())
+
+      RTPPacketHistory::RTPPacketList resends;
+      history->handleNACK(*(nack->firstTransportLayerFeedbackMessage()), now, rtt, rtxPayloadTypes, resends);
+
+      TESTING_EQUAL(resends.size(), 1)
+      if (1 == resends.size()) {
+        checkRTX(*resends.front(), *originals[2]);
+        firstRTXSequenceNumber = resends.front()->sequenceNumber();
+      }
+    }
+
+    // a repeated NACK within the round trip time is suppressed
+    {
+      GenericNACK entries[1];
+      entries[0].mPID = 1002;
+
+      auto nack = createNACK(&(entries[0]), 1);
+      TESTING_CHECK(nack)
+
+      RTPPacketHistory::RTPPacketList resends;
+      history->handleNACK(*(nack->firstTransportLayerFeedbackMessage()), now + Milliseconds(10), rtt, rtxPayloadTypes, resends);
+      TESTING_EQUAL(resends.size(), 0)
+    }
+
+    // packets never stored (e.g. sent by the media engine) are not answered
+    {
+      GenericNACK entries[1];
+      entries[0].mPID = 2000;
+
+      auto nack = createNACK(&(entries[0]), 1);
+      TESTING_CHECK(nack)
+
+      RTPPacketHistory::RTPPacketList resends;
+      history->handleNACK(*(nack->firstTransportLayerFeedbackMessage()), now, rtt, rtxPayloadTypes, resends);
+      TESTING_EQUAL(resends.size(), 0)
+    }
+
+    // pid + blp; rtx sequence numbers continue from the previous resend
+    {
+      GenericNACK entries[1];
+      entries[0].mPID = 1000;
+      entries[0].mBLP = 0x0008;   // 1004
+
+      auto nack = createNACK(&(entries[0]), 1);
+      TESTING_CHECK(nack)
+
+      RTPPacketHistory::RTPPacketList resends;
+      history->handleNACK(*(nack->firstTransportLayerFeedbackMessage()), now, rtt, rtxPayloadTypes, resends);
+
+      TESTING_EQUAL(resends.size(), 2)
+      if (2 == resends.size()) {
+        checkRTX(*resends.front(), *originals[0]);
+        checkRTX(*resends.back(), *originals[4]);
+        TESTING_EQUAL(resends.front()->sequenceNumber(), static_cast<WORD>(firstRTXSequenceNumber + 1))
+        TESTING_EQUAL(resends.back()->sequenceNumber(), static_cast<WORD>(firstRTXSequenceNumber + 2))
+      }
+    }
+  }
+
+  TESTING_UNINSTALL_LOGGER();
+}
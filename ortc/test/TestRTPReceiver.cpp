@@ -34,6 +34,7 @@
 
 #include <ortc/internal/ortc_RTPPacket.h>
 #include <ortc/internal/ortc_RTCPPacket.h>
+#include <ortc/internal/ortc_RTPContributingSourceTable.h>
 #include <ortc/IRTPTypes.h>
 
 #include <zsLib/IMessageQueueThread.h>
@@ -43,6 +44,10 @@
 #include "config.h"
 #include "testing.h"
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
 
 using zsLib::String;
@@ -2967,6 +2972,146 @@ static void bogusSleep()
   }
 }
 
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::RTPContributingSourceTable, UseContributingSourceTable)
+
+//-----------------------------------------------------------------------------
+static zsLib::Time contributingSourceTime(size_t milliseconds)
+{
+  return zsLib::Time() + Milliseconds(static_cast<Milliseconds::rep>(milliseconds));
+}
+
+//-----------------------------------------------------------------------------
+static void testContributingSourceTableEviction()
+{
+  typedef UseContributingSourceTable::ContributingSourceList ContributingSourceList;
+
+  const size_t capacity = UseContributingSourceTable::kCapacity;
+
+  auto table = std::make_shared<UseContributingSourceTable>();
+
+  // csrc 1000+N was last updated at N+1 milliseconds
+  for (size_t index = 0; index < capacity; ++index) {
+    TESTING_CHECK(table->update(static_cast<DWORD>(1000 + index), contributingSourceTime(index + 1), static_cast<BYTE>(index), Optional<bool>()))
+  }
+  TESTING_EQUAL(table->activeCount(), capacity)
+
+  // refreshing a source that is already active is not an add
+  TESTING_CHECK(!table->update(1000, contributingSourceTime(capacity + 1), 0, Optional<bool>()))
+
+  // the table is full; csrc 1001 is now the least recently updated
+  TESTING_CHECK(table->update(5000, contributingSourceTime(capacity + 2), 99, true))
+  TESTING_EQUAL(table->activeCount(), capacity)
+
+  {
+    ContributingSourceList sources;
+    table->getSources(sources);
+    TESTING_EQUAL(sources.size(), capacity)
+
+    bool foundNew = false;
+    bool foundRefreshed = false;
+    for (auto iter = sources.begin(); iter != sources.end(); ++iter) {
+      auto &source = (*iter);
+      TESTING_CHECK(1001 != source.mCSRC)
+      if (5000 == source.mCSRC) {
+        foundNew = true;
+        TESTING_EQUAL(source.mAudioLevel, 99)
+        TESTING_CHECK(source.mVoiceActivityFlag.hasValue())
+        TESTING_CHECK(source.mVoiceActivityFlag.value())
+        TESTING_CHECK(contributingSourceTime(capacity + 2) == source.mTimestamp)
+      }
+      if (1000 == source.mCSRC) foundRefreshed = true;
+    }
+    TESTING_CHECK(foundNew)
+    TESTING_CHECK(foundRefreshed)
+  }
+
+  // an evicted source comes back by evicting the next oldest (csrc 1002)
+  TESTING_CHECK(table->update(1001, contributingSourceTime(capacity + 3), 1, Optional<bool>()))
+  TESTING_EQUAL(table->activeCount(), capacity)
+
+  // expiring frees entries which are then reused without further evictions
+  {
+    ContributingSourceList expired;
+    table->expire(contributingSourceTime(11), expired);   // csrc 1003 .. 1009 (1000 .. 1002 were refreshed or evicted)
+    TESTING_EQUAL(expired.size(), 7)
+    TESTING_EQUAL(table->activeCount(), capacity - 7)
+
+    TESTING_CHECK(table->update(6000, contributingSourceTime(capacity + 4), 0, Optional<bool>()))
+    TESTING_EQUAL(table->activeCount(), capacity - 6)
+
+    ContributingSourceList sources;
+    table->getSources(sources);
+    TESTING_EQUAL(sources.size(), capacity - 6)
+  }
+
+  table->clear();
+  TESTING_EQUAL(table->activeCount(), 0)
+}
+
+//-----------------------------------------------------------------------------
+static void testContributingSourceTableReaders()
+{
+  typedef UseContributingSourceTable::ContributingSourceList ContributingSourceList;
+
+  // every value written is derived from the csrc so a reader can detect a
+  // csrc paired with another source's state (i.e. a torn entry)
+  auto expectedLevel = [](DWORD csrc) -> BYTE {return static_cast<BYTE>(csrc % 127);};
+  auto expectedVoiceActivity = [](DWORD csrc) -> bool {return 0 != (csrc & 1);};
+  auto expectedTime = [](DWORD csrc) -> zsLib::Time {return contributingSourceTime((csrc / 1000) + 1);};
+
+  const size_t kRounds = 2000;
+  const size_t kSourcesPerRound = 48;
+  const size_t kReaders = 3;
+
+  auto table = std::make_shared<UseContributingSourceTable>();
+
+  std::atomic<bool> done {false};
+  std::atomic<size_t> totalRead {0};
+  std::atomic<size_t> totalTorn {0};
+
+  std::vector<std::thread> readers;
+  for (size_t loop = 0; loop < kReaders; ++loop) {
+    readers.push_back(std::thread([&]() {
+      while (!done) {
+        ContributingSourceList sources;
+        table->getSources(sources);
+
+        for (auto iter = sources.begin(); iter != sources.end(); ++iter) {
+          auto &source = (*iter);
+          DWORD csrc = static_cast<DWORD>(source.mCSRC);
+          bool torn = (source.mAudioLevel != expectedLevel(csrc)) ||
+                      (!source.mVoiceActivityFlag.hasValue()) ||
+                      (source.mVoiceActivityFlag.value() != expectedVoiceActivity(csrc)) ||
+                      (source.mTimestamp != expectedTime(csrc));
+          if (torn) ++totalTorn;
+          ++totalRead;
+        }
+      }
+    }));
+  }
+
+  // each round replaces the whole set of sources; the previous round's
+  // entries are expired and then re-keyed (or evicted) by the new sources
+  for (size_t round = 0; round < kRounds; ++round) {
+    for (size_t index = 0; index < kSourcesPerRound; ++index) {
+      DWORD csrc = static_cast<DWORD>((round * 1000) + index);
+      table->update(csrc, expectedTime(csrc), expectedLevel(csrc), expectedVoiceActivity(csrc));
+    }
+
+    ContributingSourceList expired;
+    table->expire(expectedTime(static_cast<DWORD>(round * 1000)), expired);
+  }
+
+  done = true;
+  for (auto iter = readers.begin(); iter != readers.end(); ++iter) {
+    (*iter).join();
+  }
+
+  TESTING_CHECK(totalRead.load() > 0)
+  TESTING_EQUAL(totalTorn.load(), 0)
+  TESTING_EQUAL(table->activeCount(), kSourcesPerRound)
+}
+
 void doTestRTPReceiver()
 {
   if (!ORTC_TEST_DO_RTP_RECEIVER_TEST) return;
@@ -2977,6 +3122,9 @@ void doTestRTPReceiver()
 
   UseSettings::applyDefaults();
 
+  testContributingSourceTableEviction();
+  testContributingSourceTableReaders();
+
   auto thread(zsLib::IMessageQueueThread::createBasic());
 
   RTPReceiverTesterPtr testObject1;
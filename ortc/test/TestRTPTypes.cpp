@@ -0,0 +1,549 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#include <ortc/IRTPTypes.h>
+#include <ortc/IHelper.h>
+#include <ortc/adapter/ISessionDescription.h>
+#include <ortc/internal/ortc_RTPTypes.h>
+#include <ortc/internal/ortc_RTPTypesSerializer.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/XML.h>
+
+#include "config.h"
+#include "testing.h"
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::ElementPtr;
+using zsLib::Milliseconds;
+using zsLib::Microseconds;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace rtptypes
+    {
+      typedef IRTPTypes::Parameters Parameters;
+      typedef IRTPTypes::Capabilities Capabilities;
+      typedef IRTPTypes::EncodingParameters EncodingParameters;
+      typedef IRTPTypes::CodecParameters CodecParameters;
+      typedef IRTPTypes::CodecCapability CodecCapability;
+      typedef IRTPTypes::RTCPFeedback RTCPFeedback;
+      typedef adapter::ISessionDescriptionTypes ISessionDescriptionTypes;
+      typedef ISessionDescriptionTypes::Description Description;
+      ZS_DECLARE_TYPEDEF_PTR(ortc::internal::RTPTypesHelper, UseRTPTypesHelper)
+      ZS_DECLARE_TYPEDEF_PTR(ortc::internal::RTPTypesSerializer, UseRTPTypesSerializer)
+      typedef UseRTPTypesHelper::ParametersPtrList ParametersPtrList;
+      typedef UseRTPTypesHelper::ParametersPtrPairList ParametersPtrPairList;
+
+      //-----------------------------------------------------------------------
+      static Parameters createParameters()
+      {
+        Parameters params;
+        params.mMuxID = "mux";
+
+        EncodingParameters encoding;
+        encoding.mSSRC = 0x11111111;
+        encoding.mCodecPayloadType = 96;
+        encoding.mMaxBitrate = 500000;
+        encoding.mResolutionScale = 2.0;
+        encoding.mFramerateScale = 0.5;
+        encoding.mEncodingID = "low";
+        params.mEncodings.push_back(encoding);
+
+        encoding.mSSRC = 0x22222222;
+        encoding.mResolutionScale = 1.0;
+        encoding.mFramerateScale = 1.0;
+        encoding.mEncodingID = "high";
+        encoding.mDependencyEncodingIDs.push_back("low");
+        params.mEncodings.push_back(encoding);
+
+        return params;
+      }
+
+      //-----------------------------------------------------------------------
+      static void checkParameters(
+                                  const Parameters &expected,
+                                  const Parameters &actual
+                                  )
+      {
+        TESTING_EQUAL(actual.mMuxID, expected.mMuxID)
+        TESTING_EQUAL(actual.mEncodings.size(), expected.mEncodings.size())
+        if (actual.mEncodings.size() != expected.mEncodings.size()) return;
+
+        auto iterExpected = expected.mEncodings.begin();
+        for (auto iter = actual.mEncodings.begin(); iter != actual.mEncodings.end(); ++iter, ++iterExpected) {
+          auto &encoding = (*iter);
+          auto &expectedEncoding = (*iterExpected);
+
+          // each scale must survive under its own key
+          TESTING_CHECK(encoding.mResolutionScale.hasValue())
+          TESTING_CHECK(encoding.mFramerateScale.hasValue())
+          if ((!encoding.mResolutionScale.hasValue()) ||
+              (!encoding.mFramerateScale.hasValue())) continue;
+
+          TESTING_EQUAL(encoding.mResolutionScale.value(), expectedEncoding.mResolutionScale.value())
+          TESTING_EQUAL(encoding.mFramerateScale.value(), expectedEncoding.mFramerateScale.value())
+          TESTING_EQUAL(encoding.mEncodingID, expectedEncoding.mEncodingID)
+          TESTING_EQUAL(encoding.mDependencyEncodingIDs.size(), expectedEncoding.mDependencyEncodingIDs.size())
+        }
+
+        TESTING_EQUAL(actual.hash(), expected.hash())
+      }
+
+      //-----------------------------------------------------------------------
+      static Parameters createCodecParameters()
+      {
+        Parameters params = createParameters();
+
+        CodecParameters codec;
+        codec.mName = "opus";
+        codec.mPayloadType = 111;
+        codec.mClockRate = 48000;
+        codec.mNumChannels = 2;
+
+        RTCPFeedback feedback;
+        feedback.mType = "transport-cc";
+        codec.mRTCPFeedback.push_back(feedback);
+
+        auto opus = make_shared<IRTPTypes::OpusCodecParameters>();
+        opus->mMaxPlaybackRate = 48000;
+        opus->mStereo = true;
+        opus->mUseDTX = true;
+        opus->mComplexity = 10;
+        codec.mParameters = opus;
+        params.mCodecs.push_back(codec);
+
+        IRTPTypes::HeaderExtensionParameters ext;
+        ext.mURI = "urn:ietf:params:rtp-hdrext:ssrc-audio-level";
+        ext.mID = 1;
+        params.mHeaderExtensions.push_back(ext);
+
+        params.mRTCP.mSSRC = 0x33333333;
+        params.mRTCP.mCName = "cname \"quoted\"";
+        params.mRTCP.mReducedSize = true;
+
+        return params;
+      }
+
+      //-----------------------------------------------------------------------
+      static Capabilities createCapabilities()
+      {
+        Capabilities capabilities;
+
+        {
+          CodecCapability codec;
+          codec.mName = "opus";
+          codec.mKind = "audio";
+          codec.mClockRate = 48000;
+          codec.mPreferredPayloadType = 111;
+          codec.mNumChannels = 2;
+
+          auto opus = make_shared<IRTPTypes::OpusCodecCapabilityParameters>();
+          opus->mStereo = true;
+          opus->mUseDTX = true;
+          codec.mParameters = opus;
+          capabilities.mCodecs.push_back(codec);
+        }
+        {
+          CodecCapability codec;
+          codec.mName = "vp8";
+          codec.mKind = "video";
+          codec.mClockRate = 90000;
+          codec.mPreferredPayloadType = 96;
+
+          RTCPFeedback feedback;
+          feedback.mType = "nack";
+          codec.mRTCPFeedback.push_back(feedback);
+          feedback.mParameter = "pli";
+          codec.mRTCPFeedback.push_back(feedback);
+
+          auto vp8 = make_shared<IRTPTypes::VP8CodecCapabilityParameters>();
+          vp8->mMaxFR = 30;
+          vp8->mMaxFS = 8160;
+          codec.mParameters = vp8;
+          capabilities.mCodecs.push_back(codec);
+        }
+        {
+          CodecCapability codec;
+          codec.mName = "flexfec";
+          codec.mKind = "video";
+          codec.mClockRate = 90000;
+          codec.mPreferredPayloadType = 98;
+
+          auto flexFEC = make_shared<IRTPTypes::FlexFECCodecCapabilityParameters>();
+          flexFEC->mRepairWindow = Microseconds(200000);
+          flexFEC->mL = 5;
+          flexFEC->mD = 5;
+          codec.mParameters = flexFEC;
+          capabilities.mCodecs.push_back(codec);
+        }
+
+        IRTPTypes::HeaderExtension ext;
+        ext.mKind = "audio";
+        ext.mURI = "urn:ietf:params:rtp-hdrext:ssrc-audio-level";
+        ext.mPreferredID = 1;
+        capabilities.mHeaderExtensions.push_back(ext);
+
+        capabilities.mFECMechanisms.push_back("flexfec");
+
+        return capabilities;
+      }
+
+      //-----------------------------------------------------------------------
+      static void checkCodecParameters(
+                                       const Parameters &expected,
+                                       const Parameters &actual
+                                       )
+      {
+        checkParameters(expected, actual);
+
+        TESTING_EQUAL(actual.mCodecs.size(), expected.mCodecs.size())
+        if (actual.mCodecs.size() < 1) return;
+
+        // opus "useDtx" and "stereo" must survive every path
+        auto opus = IRTPTypes::OpusCodecParameters::convert(actual.mCodecs.front().mParameters);
+        TESTING_CHECK(opus)
+        if (!opus) return;
+        TESTING_CHECK(opus->mUseDTX.hasValue())
+        TESTING_CHECK(opus->mStereo.hasValue())
+        TESTING_EQUAL(actual.mRTCP.mCName, expected.mRTCP.mCName)
+      }
+
+      //-----------------------------------------------------------------------
+      static void checkCapabilities(
+                                    const Capabilities &expected,
+                                    const Capabilities &actual
+                                    )
+      {
+        TESTING_EQUAL(actual.mCodecs.size(), expected.mCodecs.size())
+        TESTING_EQUAL(actual.mHeaderExtensions.size(), expected.mHeaderExtensions.size())
+        TESTING_EQUAL(actual.mFECMechanisms.size(), expected.mFECMechanisms.size())
+
+        for (auto iter = actual.mCodecs.begin(); iter != actual.mCodecs.end(); ++iter) {
+          auto &codec = (*iter);
+          if ("flexfec" != codec.mName) continue;
+
+          // the repair window is written as "repairWindow" (not "rtxTime")
+          auto flexFEC = IRTPTypes::FlexFECCodecCapabilityParameters::convert(codec.mParameters);
+          TESTING_CHECK(flexFEC)
+          if (!flexFEC) continue;
+          TESTING_EQUAL(flexFEC->mRepairWindow.count(), 200000)
+        }
+
+        TESTING_EQUAL(actual.hash(), expected.hash())
+      }
+
+      //-----------------------------------------------------------------------
+      static Description createDescription()
+      {
+        Description description;
+
+        description.mDetails = make_shared<Description::Details>();
+        description.mDetails->mSessionID = 1234;
+        description.mDetails->mSessionVersion = 2;
+        description.mDetails->mSessionName = "session";
+
+        {
+          auto transport = make_shared<ISessionDescriptionTypes::Transport>();
+          transport->mID = "transport";
+          description.mTransports.push_back(transport);
+        }
+        {
+          auto mediaLine = make_shared<ISessionDescriptionTypes::RTPMediaLine>();
+          mediaLine->mID = "audio";
+          mediaLine->mTransportID = "transport";
+          mediaLine->mMediaType = "audio";
+          mediaLine->mDetails = make_shared<ISessionDescriptionTypes::MediaLine::Details>();
+          mediaLine->mDetails->mInternalIndex = 0;
+          mediaLine->mDetails->mProtocol = "UDP/TLS/RTP/SAVPF";
+          mediaLine->mSenderCapabilities = make_shared<Capabilities>(createCapabilities());
+          mediaLine->mReceiverCapabilities = make_shared<Capabilities>(createCapabilities());
+          description.mRTPMediaLines.push_back(mediaLine);
+        }
+        {
+          auto mediaLine = make_shared<ISessionDescriptionTypes::SCTPMediaLine>();
+          mediaLine->mID = "data";
+          mediaLine->mTransportID = "transport";
+          mediaLine->mMediaType = "application";
+          mediaLine->mPort = 5000;
+          description.mSCTPMediaLines.push_back(mediaLine);
+        }
+        for (int index = 0; index < 2; ++index) {
+          auto sender = make_shared<ISessionDescriptionTypes::RTPSender>();
+          sender->mID = (0 == index ? "sender1" : "sender2");
+          sender->mRTPMediaLineID = "audio";
+          sender->mParameters = make_shared<Parameters>(createCodecParameters());
+          sender->mMediaStreamTrackID = "track";
+          sender->mMediaStreamIDs.insert("stream1");
+          if (0 != index) sender->mMediaStreamIDs.insert("stream2");
+          description.mRTPSenders.push_back(sender);
+        }
+
+        return description;
+      }
+
+      //-----------------------------------------------------------------------
+      static void checkDescription(
+                                   const Description &expected,
+                                   const Description &actual
+                                   )
+      {
+        TESTING_EQUAL(actual.mTransports.size(), expected.mTransports.size())
+        TESTING_EQUAL(actual.mRTPMediaLines.size(), expected.mRTPMediaLines.size())
+        TESTING_EQUAL(actual.mSCTPMediaLines.size(), expected.mSCTPMediaLines.size())
+        TESTING_EQUAL(actual.mRTPSenders.size(), expected.mRTPSenders.size())
+
+        if (actual.mRTPSenders.size() == expected.mRTPSenders.size()) {
+          auto iterExpected = expected.mRTPSenders.begin();
+          for (auto iter = actual.mRTPSenders.begin(); iter != actual.mRTPSenders.end(); ++iter, ++iterExpected) {
+            TESTING_EQUAL((*iter)->mMediaStreamIDs.size(), (*iterExpected)->mMediaStreamIDs.size())
+          }
+        }
+
+        TESTING_EQUAL(actual.hash(), expected.hash())
+      }
+
+      //-----------------------------------------------------------------------
+      static void testSerializer()
+      {
+        // streamed json read by the Element path and vice versa
+        {
+          Parameters params = createCodecParameters();
+
+          String json = UseRTPTypesSerializer::toJSON(params, "parameters");
+          ElementPtr rootEl = ortc::IHelper::toJSON(json);
+          TESTING_CHECK(rootEl)
+          if (rootEl) {
+            Parameters decoded(rootEl);
+            checkCodecParameters(params, decoded);
+          }
+
+          auto decoded = UseRTPTypesSerializer::createParametersFromJSON(ortc::IHelper::toString(params.createElement("parameters")).c_str());
+          TESTING_CHECK(decoded)
+          if (decoded) checkCodecParameters(params, *decoded);
+
+          decoded = UseRTPTypesSerializer::createParametersFromJSON(json.c_str());
+          TESTING_CHECK(decoded)
+          if (decoded) checkCodecParameters(params, *decoded);
+        }
+        {
+          Capabilities capabilities = createCapabilities();
+
+          String json = UseRTPTypesSerializer::toJSON(capabilities, "capabilities");
+          ElementPtr rootEl = ortc::IHelper::toJSON(json);
+          TESTING_CHECK(rootEl)
+          if (rootEl) {
+            Capabilities decoded(rootEl);
+            checkCapabilities(capabilities, decoded);
+          }
+
+          auto decoded = UseRTPTypesSerializer::createCapabilitiesFromJSON(ortc::IHelper::toString(capabilities.createElement("capabilities")).c_str());
+          TESTING_CHECK(decoded)
+          if (decoded) checkCapabilities(capabilities, *decoded);
+        }
+
+        // binary round trip; truncated or mistyped input is rejected
+        {
+          Parameters params = createCodecParameters();
+
+          auto buffer = UseRTPTypesSerializer::encodeBinary(params);
+          TESTING_CHECK(buffer)
+          if (buffer) {
+            auto decoded = UseRTPTypesSerializer::decodeParameters(buffer->BytePtr(), buffer->SizeInBytes());
+            TESTING_CHECK(decoded)
+            if (decoded) checkCodecParameters(params, *decoded);
+
+            TESTING_CHECK(!UseRTPTypesSerializer::decodeParameters(buffer->BytePtr(), buffer->SizeInBytes() - 1))
+            TESTING_CHECK(!UseRTPTypesSerializer::decodeCapabilities(buffer->BytePtr(), buffer->SizeInBytes()))
+          }
+        }
+        {
+          Capabilities capabilities = createCapabilities();
+
+          auto buffer = UseRTPTypesSerializer::encodeBinary(capabilities);
+          TESTING_CHECK(buffer)
+          if (buffer) {
+            auto decoded = UseRTPTypesSerializer::decodeCapabilities(buffer->BytePtr(), buffer->SizeInBytes());
+            TESTING_CHECK(decoded)
+            if (decoded) checkCapabilities(capabilities, *decoded);
+          }
+        }
+
+        // json signaling streams the description; the Element path must
+        // read what is written and vice versa
+        {
+          Description description = createDescription();
+
+          auto streamed = adapter::ISessionDescription::create(ISessionDescriptionTypes::SignalingType_JSON, description);
+          String json = streamed->formattedDescription();
+          TESTING_CHECK(json.hasData())
+
+          auto decoded = Description::create(ortc::IHelper::toJSON(json));
+          TESTING_CHECK(decoded)
+          if (decoded) checkDescription(description, *decoded);
+
+          auto parsed = adapter::ISessionDescription::create(ISessionDescriptionTypes::SignalingType_JSON, json.c_str());
+          decoded = parsed->description();
+          TESTING_CHECK(decoded)
+          if (decoded) checkDescription(description, *decoded);
+
+          auto fromElement = adapter::ISessionDescription::create(ISessionDescriptionTypes::SignalingType_JSON, ortc::IHelper::toString(description.createElement()).c_str());
+          decoded = fromElement->description();
+          TESTING_CHECK(decoded)
+          if (decoded) checkDescription(description, *decoded);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      static Parameters createChannelParameters()
+      {
+        Parameters params = createCodecParameters();
+        params.mEncodings.clear();
+
+        EncodingParameters encoding;
+        encoding.mSSRC = 0x11111111;
+        encoding.mCodecPayloadType = 111;
+        encoding.mEncodingID = "a";
+        params.mEncodings.push_back(encoding);
+
+        encoding.mSSRC = 0x22222222;
+        encoding.mEncodingID = "b";
+        params.mEncodings.push_back(encoding);
+
+        return params;
+      }
+
+      //-----------------------------------------------------------------------
+      static void testChannelSplit()
+      {
+        Parameters params = createChannelParameters();
+
+        ParametersPtrList channels;
+        UseRTPTypesHelper::splitParamsIntoChannels(params, channels);
+        TESTING_EQUAL(channels.size(), 2)
+        if (channels.size() != 2) return;
+
+        auto firstChannel = channels.front();
+        auto secondChannel = channels.back();
+        TESTING_EQUAL(firstChannel->mCodecs.size(), params.mCodecs.size())
+        TESTING_EQUAL(firstChannel->mMuxID, params.mMuxID)
+
+        // renegotiate with only the second encoding changed; the first
+        // channel must keep its existing params object
+        params.mEncodings.back().mMaxBitrate = 250000;
+
+        ParametersPtrList renegotiated;
+        UseRTPTypesHelper::splitParamsIntoChannels(params, channels, renegotiated);
+        TESTING_EQUAL(renegotiated.size(), 2)
+        if (renegotiated.size() != 2) return;
+
+        TESTING_CHECK(renegotiated.front() == firstChannel)
+        TESTING_CHECK(renegotiated.back() != secondChannel)
+        TESTING_EQUAL(renegotiated.back()->mCodecs.size(), params.mCodecs.size())
+        TESTING_EQUAL(renegotiated.back()->mEncodings.front().mMaxBitrate.value(), 250000)
+
+        ParametersPtrPairList unchangedChannels;
+        ParametersPtrList newChannels;
+        ParametersPtrPairList updatedChannels;
+        ParametersPtrList removedChannels;
+        UseRTPTypesHelper::calculateDeltaChangesInChannels(IMediaStreamTrackTypes::Kind_Audio, channels, renegotiated, unchangedChannels, newChannels, updatedChannels, removedChannels);
+
+        TESTING_EQUAL(unchangedChannels.size(), 1)
+        TESTING_EQUAL(updatedChannels.size(), 1)
+        TESTING_EQUAL(newChannels.size(), 0)
+        TESTING_EQUAL(removedChannels.size(), 0)
+        if (unchangedChannels.size() == 1) {
+          TESTING_CHECK(unchangedChannels.front().first == firstChannel)
+          TESTING_CHECK(unchangedChannels.front().second == firstChannel)
+        }
+
+        // a changed codec list changes every channel's sections so nothing
+        // can be kept
+        params.mCodecs.front().mMaxPTime = Milliseconds(60);
+
+        ParametersPtrList recodec;
+        UseRTPTypesHelper::splitParamsIntoChannels(params, renegotiated, recodec);
+        TESTING_EQUAL(recodec.size(), 2)
+        if (recodec.size() != 2) return;
+
+        TESTING_CHECK(recodec.front() != firstChannel)
+        TESTING_EQUAL(recodec.front()->mCodecs.front().mMaxPTime.count(), 60)
+      }
+    }
+  }
+}
+
+using namespace ortc::test::rtptypes;
+
+void doTestRTPTypes()
+{
+  if (!ORTC_TEST_DO_RTP_TYPES_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+
+  testSerializer();
+  testChannelSplit();
+
+  {
+    Parameters params = createParameters();
+
+    // element round trip
+    {
+      ElementPtr rootEl = params.createElement();
+      TESTING_CHECK(rootEl)
+
+      Parameters decoded(rootEl);
+      checkParameters(params, decoded);
+    }
+
+    // json round trip
+    {
+      String json = ortc::IHelper::toString(params.createElement());
+      TESTING_CHECK(json.hasData())
+
+      ElementPtr rootEl = ortc::IHelper::toJSON(json);
+      TESTING_CHECK(rootEl)
+      if (rootEl) {
+        Parameters decoded(rootEl);
+        checkParameters(params, decoded);
+      }
+    }
+  }
+
+  TESTING_UNINSTALL_LOGGER();
+}
@@ -1443,6 +1443,43 @@ static void bogusSleep()
   }
 }
 
+static void testShardAllocator()
+{
+  typedef ortc::internal::SCTPShardAllocator SCTPShardAllocator;
+
+  SCTPShardAllocator allocator(3);
+  TESTING_EQUAL(allocator.totalShards(), 3)
+
+  // associations are spread round the least loaded shards in index order
+  TESTING_EQUAL(allocator.allocate(), 0)
+  TESTING_EQUAL(allocator.allocate(), 1)
+  TESTING_EQUAL(allocator.allocate(), 2)
+  TESTING_EQUAL(allocator.allocate(), 0)
+  TESTING_EQUAL(allocator.totalAssociations(0), 2)
+  TESTING_EQUAL(allocator.totalAssociations(1), 1)
+  TESTING_EQUAL(allocator.totalAssociations(2), 1)
+
+  // a released shard becomes the least loaded and is picked next
+  TESTING_CHECK(allocator.release(2))
+  TESTING_EQUAL(allocator.totalAssociations(2), 0)
+  TESTING_EQUAL(allocator.allocate(), 2)
+
+  // releasing an idle shard never underflows
+  TESTING_CHECK(allocator.release(1))
+  TESTING_CHECK(allocator.release(1))
+  TESTING_EQUAL(allocator.totalAssociations(1), 0)
+
+  // unknown shards are rejected
+  TESTING_CHECK(!allocator.release(3))
+  TESTING_EQUAL(allocator.totalAssociations(3), 0)
+
+  SCTPShardAllocator single(1);
+  for (int loop = 0; loop < 10; ++loop) {
+    TESTING_EQUAL(single.allocate(), 0)
+  }
+  TESTING_EQUAL(single.totalAssociations(0), 10)
+}
+
 void doTestSCTP()
 {
   if (!ORTC_TEST_DO_SCTP_TRANSPORT_TEST) return;
@@ -1453,6 +1490,8 @@ void doTestSCTP()
 
   UseSettings::applyDefaults();
 
+  testShardAllocator();
+
   auto thread(zsLib::IMessageQueueThread::createBasic());
 
   SCTPTesterPtr testSCTPObject1;
@@ -37,6 +37,7 @@
 #include <ortc/internal/ortc_ICETransport.h>
 #include <ortc/internal/ortc_ISecureTransport.h>
 #include <ortc/internal/ortc_DTLSTransport.h>
+#include <ortc/internal/ortc_SCTPTransport.h>
 
 #include <ortc/services/IHelper.h>
 
@@ -0,0 +1,134 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include <ortc/adapter/internal/ortc_adapter_SDPParser.h>
+
+#include <zsLib/ISettings.h>
+
+#include "config.h"
+#include "testing.h"
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::String;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace sdpparser
+    {
+      typedef ortc::adapter::internal::SDPParser SDPParser;
+      typedef ortc::adapter::internal::ISDPTypes ISDPTypes;
+
+      //-----------------------------------------------------------------------
+      static const char *getSampleSDP()
+      {
+        return
+          "v=0\r\n"
+          "o=- 4611731400430051336 2 IN IP4 127.0.0.1\r\n"
+          "s=-\r\n"
+          "t=0 0\r\n"
+          "a=group:BUNDLE audio video\r\n"
+          "m=audio 9 UDP/TLS/RTP/SAVPF 111\r\n"
+          "c=IN IP4 0.0.0.0\r\n"
+          "a=rtcp:9 IN IP4 0.0.0.0\r\n"
+          "a=ice-ufrag:Fa8m\r\n"
+          "a=ice-pwd:Ljf6vQHWHtqvXDThmS2qnGR0\r\n"
+          "a=setup:actpass\r\n"
+          "a=mid:audio\r\n"
+          "a=sendrecv\r\n"
+          "a=rtcp-mux\r\n"
+          "a=rtpmap:111 opus/48000/2\r\n"
+          "a=candidate:1 1 udp 2122260223 192.168.1.2 54321 typ host\r\n"
+          "a=ssrc:1001 cname:ortc\r\n"
+          "m=video 9 UDP/TLS/RTP/SAVPF 100\r\n"
+          "c=IN IP4 0.0.0.0\r\n"
+          "a=rtcp:9 IN IP4 0.0.0.0\r\n"
+          "a=ice-ufrag:Fa8m\r\n"
+          "a=ice-pwd:Ljf6vQHWHtqvXDThmS2qnGR0\r\n"
+          "a=setup:actpass\r\n"
+          "a=mid:video\r\n"
+          "a=sendrecv\r\n"
+          "a=rtcp-mux\r\n"
+          "a=rtpmap:100 VP8/90000\r\n"
+          "a=candidate:1 1 udp 2122260223 192.168.1.2 54322 typ host\r\n"
+          "a=ssrc:2001 cname:ortc\r\n";
+      }
+    }
+  }
+}
+
+using namespace ortc::test::sdpparser;
+
+void doTestSDPParser()
+{
+  if (!ORTC_TEST_DO_SDP_PARSER_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+
+  {
+    auto sdp = SDPParser::parse(getSampleSDP());
+    TESTING_CHECK(sdp)
+    TESTING_EQUAL(2, sdp->mMLines.size())
+
+    String full = SDPParser::generate(*sdp);
+    TESTING_CHECK(full.hasData())
+
+    // the pre-sized output must hold the whole blob without growing
+    TESTING_CHECK(SDPParser::estimateGeneratedSize(*sdp) >= full.length())
+
+    // generating from a re-parse of the output is stable
+    {
+      auto reparsed = SDPParser::parse(full.c_str());
+      TESTING_CHECK(reparsed)
+      if (reparsed) {
+        TESTING_EQUAL(2, reparsed->mMLines.size())
+        TESTING_EQUAL(full, SDPParser::generate(*reparsed))
+      }
+    }
+
+    // every m-section, candidate and ssrc line is written
+    TESTING_CHECK(String::npos != full.find("m=audio 9 "))
+    TESTING_CHECK(String::npos != full.find("m=video 9 "))
+    TESTING_CHECK(String::npos != full.find("192.168.1.2 54321 typ host"))
+    TESTING_CHECK(String::npos != full.find("192.168.1.2 54322 typ host"))
+    TESTING_CHECK(String::npos != full.find("a=ssrc:2001 cname:ortc"))
+    TESTING_CHECK(full.find("m=audio") < full.find("m=video"))
+  }
+
+  TESTING_UNINSTALL_LOGGER();
+}
@@ -143,6 +143,11 @@ namespace ortc
                                               const BYTE *buffer,
                                               size_t bufferLengthInBytes
                                               ) = 0;
+
+        virtual void notifyFakeSentPackets(
+                                           size_t totalPackets,
+                                           size_t totalBytes
+                                           ) = 0;
       };
 
       //-----------------------------------------------------------------------
@@ -246,6 +251,28 @@ namespace ortc
           return transport->sendPacket(sendOverICETransport, packetType, buffer, bufferLengthInBytes);
         }
 
+        //---------------------------------------------------------------------
+        bool fakeSendPackets(
+                             IICETypes::Components sendOverICETransport,
+                             IICETypes::Components packetType,
+                             const ortc::internal::PacketBufferRefList &packets
+                             )
+        {
+          UseSRTPTransportPtr transport;
+
+          {
+            AutoRecursiveLock lock(*this);
+            transport = mSRTPTransport;
+            if (!transport) {
+              ZS_LOG_WARNING(Basic, log("no srtp transport available"))
+              TESTING_CHECK(false)
+              return false;
+            }
+          }
+
+          return transport->sendPackets(sendOverICETransport, packetType, packets);
+        }
+
       protected:
         //---------------------------------------------------------------------
         #pragma mark
@@ -307,6 +334,36 @@ namespace ortc
           return true;
         }
 
+        //---------------------------------------------------------------------
+        virtual bool sendEncryptedPackets(
+                                          IICETypes::Components sendOverICETransport,
+                                          IICETypes::Components packetType,
+                                          const ortc::internal::PacketBufferRefList &packets
+                                          ) override
+        {
+          ISRTPTesterPtr tester;
+
+          {
+            AutoRecursiveLock lock(*this);
+            tester = mOuterTester.lock();
+          }
+
+          size_t totalBytes = 0;
+          for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+            totalBytes += (*iter).mSize;
+          }
+
+          ZS_LOG_DEBUG(log("sending encrypted batch to linked fake transport") + ZS_PARAM("packets", packets.size()) + ZS_PARAM("bytes", totalBytes))
+
+          if (tester) tester->notifyFakeSentPackets(packets.size(), totalBytes);
+
+          bool result = true;
+          for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+            if (!sendEncryptedPacket(sendOverICETransport, packetType, (*iter).mBuffer, (*iter).mSize)) result = false;
+          }
+          return result;
+        }
+
         //---------------------------------------------------------------------
         virtual bool handleReceivedDecryptedPacket(
                                                    IICETypes::Components viaTransport,
@@ -439,12 +496,19 @@ namespace ortc
           ULONG mReceivedPackets {0};
           ULONG mClosed {0};
 
+          ULONG mSentBatches {0};
+          ULONG mSentBatchPackets {0};
+          ULONG mSentBatchBytes {0};
+
           //-------------------------------------------------------------------
           bool operator==(const Expectations &op2) const
           {
             return (mSentPackets == op2.mSentPackets) &&
               (mReceivedPackets == op2.mReceivedPackets) &&
-              (mClosed == op2.mClosed)
+              (mClosed == op2.mClosed) &&
+              (mSentBatches == op2.mSentBatches) &&
+              (mSentBatchPackets == op2.mSentBatchPackets) &&
+              (mSentBatchBytes == op2.mSentBatchBytes)
             ;
           }
         };
@@ -545,6 +609,24 @@ namespace ortc
           return transport->fakeSendPacket(viaTransport, packetType, buffer, bufferLengthInBytes);
         }
 
+        //---------------------------------------------------------------------
+        bool sendPackets(
+                         IICETypes::Components viaTransport,
+                         IICETypes::Components packetType,
+                         const ortc::internal::PacketBufferRefList &packets
+                         )
+        {
+          FakeSecureTransportPtr transport;
+
+          {
+            AutoRecursiveLock lock(*this);
+            transport = mDTLS;
+            mExpectations.mSentPackets += static_cast<ULONG>(packets.size());
+          }
+
+          return transport->fakeSendPackets(viaTransport, packetType, packets);
+        }
+
       protected:
         //---------------------------------------------------------------------
         #pragma mark
@@ -582,6 +664,19 @@ namespace ortc
           return true;
         }
 
+        //---------------------------------------------------------------------
+        virtual void notifyFakeSentPackets(
+                                           size_t totalPackets,
+                                           size_t totalBytes
+                                           ) override
+        {
+          AutoRecursiveLock lock(*this);
+
+          ++mExpectations.mSentBatches;
+          mExpectations.mSentBatchPackets += static_cast<ULONG>(totalPackets);
+          mExpectations.mSentBatchBytes += static_cast<ULONG>(totalBytes);
+        }
+
       protected:
         //---------------------------------------------------------------------
         //---------------------------------------------------------------------
@@ -637,6 +732,7 @@ using ortc::IICETypes;
 #define TEST_MULTIPLE_KEYS 1
 #define TEST_MKI 2
 #define TEST_RTCP 3
+#define TEST_BATCH 4
 
 static const BYTE kTestKey1[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ1234";
 static const BYTE kTestKey2[] = "4321ZYXWVUTSRQPONMLKJIHGFEDCBA";
@@ -685,6 +781,12 @@ static const BYTE kRtcpReport[] = {
 
 static const size_t kBufferLen = 172;
 
+// AES_CM_128_HMAC_SHA1_80 appends an 80-bit authentication tag to each
+// protected RTP packet (no MKI configured).
+static const size_t kAuthTagLen80 = 10;
+
+static const size_t kBatchPackets = 8;
+
 //-----------------------------------------------------------------------------
 static void Set8(void* memory, size_t offset, BYTE v) {
   static_cast<BYTE*>(memory)[offset] = v;
@@ -979,6 +1081,67 @@ void doTestSRTP()
           }
           break;
         }
+        case TEST_BATCH: {
+          {
+            expectationsDTLS1.mSentPackets = 0;
+            expectationsDTLS1.mReceivedPackets = kBatchPackets;
+            expectationsDTLS1.mClosed = 1;
+
+            expectationsDTLS2.mSentPackets = kBatchPackets;
+            expectationsDTLS2.mReceivedPackets = 0;
+            expectationsDTLS2.mClosed = 1;
+
+            // the whole batch must be protected and handed down in a single call
+            expectationsDTLS2.mSentBatches = 1;
+            expectationsDTLS2.mSentBatchPackets = kBatchPackets;
+            expectationsDTLS2.mSentBatchBytes = static_cast<ULONG>(kBatchPackets * (sizeof(kPcmuFrame) + kAuthTagLen80));
+
+            KeyParameters kParamsEncrypt1;
+            kParamsEncrypt1.mKeyMethod = "inline";
+            kParamsEncrypt1.mKeySalt = UseServicesHelper::convertToBase64(kTestKey1, kTestKeyLen);
+            kParamsEncrypt1.mLifetime = "2^20";
+            kParamsEncrypt1.mMKILength = 0;
+
+            KeyParameters kParamsEncrypt2;
+            kParamsEncrypt2.mKeyMethod = "inline";
+            kParamsEncrypt2.mKeySalt = UseServicesHelper::convertToBase64(kTestKey2, kTestKeyLen);
+            kParamsEncrypt2.mLifetime = "2^20";
+            kParamsEncrypt2.mMKILength = 0;
+
+            CryptoParameters encrypt1;
+            CryptoParameters decrypt1;
+
+            CryptoParameters encrypt2;
+            CryptoParameters decrypt2;
+
+            encrypt1.mKeyParams.push_front(kParamsEncrypt1);
+            encrypt1.mCryptoSuite = CS_AES_CM_128_HMAC_SHA1_80;
+
+            decrypt1.mKeyParams.push_front(kParamsEncrypt2);
+            decrypt1.mCryptoSuite = CS_AES_CM_128_HMAC_SHA1_80;
+
+            encrypt2.mKeyParams.push_front(kParamsEncrypt2);
+            encrypt2.mCryptoSuite = CS_AES_CM_128_HMAC_SHA1_80;
+
+            decrypt2.mKeyParams.push_front(kParamsEncrypt1);
+            decrypt2.mCryptoSuite = CS_AES_CM_128_HMAC_SHA1_80;
+
+
+            // setup for test 4
+            fakeDTLSObject1 = FakeSecureTransport::create(thread, encrypt1, decrypt1);
+            fakeDTLSObject2 = FakeSecureTransport::create(thread, encrypt2, decrypt2);
+
+            TESTING_CHECK(fakeDTLSObject1)
+            TESTING_CHECK(fakeDTLSObject2)
+
+            testSRTPObject1 = SRTPTester::create(thread, fakeDTLSObject1);
+            testSRTPObject2 = SRTPTester::create(thread, fakeDTLSObject2);
+
+            TESTING_CHECK(testSRTPObject1)
+            TESTING_CHECK(testSRTPObject2)
+          }
+          break;
+        }
         default:  quit = true; break;
       }
       if (quit) break;
@@ -1164,6 +1327,49 @@ void doTestSRTP()
             }
             break;
           }
+          case TEST_BATCH: {
+            switch (step) {
+            case 2: {
+              if (fakeDTLSObject1) fakeDTLSObject1->linkTransport(testSRTPObject1, fakeDTLSObject2);
+              if (fakeDTLSObject2) fakeDTLSObject2->linkTransport(testSRTPObject2, fakeDTLSObject1);
+              break;
+            }
+            case 10: {
+              std::list<SecureByteBlockPtr> buffers;
+              ortc::internal::PacketBufferRefList packets;
+
+              for (size_t i = 0; i < kBatchPackets; ++i)
+              {
+                BYTE rtp_packet[sizeof(kPcmuFrame)];
+                memcpy(rtp_packet, kPcmuFrame, sizeof(kPcmuFrame));
+                SetBE16(reinterpret_cast<BYTE*>(rtp_packet)+2, static_cast<WORD>(i));
+
+                SecureByteBlockPtr buffer = UseServicesHelper::convertToBuffer(rtp_packet, sizeof(rtp_packet));
+                buffers.push_back(buffer);
+
+                ortc::internal::PacketBufferRef ref;
+                ref.mBuffer = buffer->BytePtr();
+                ref.mSize = buffer->SizeInBytes();
+                packets.push_back(ref);
+
+                if (testSRTPObject1) testSRTPObject1->expectingIncomingPacket(IICETypes::Component_RTP, IICETypes::Component_RTP, *buffer, buffer->SizeInBytes());
+              }
+
+              if (testSRTPObject2) {TESTING_CHECK(testSRTPObject2->sendPackets(IICETypes::Component_RTP, IICETypes::Component_RTP, packets))}
+              break;
+            }
+            case 35: {
+              if (testSRTPObject1) testSRTPObject1->close();
+              if (testSRTPObject2) testSRTPObject2->close();
+              break;
+            }
+            default: {
+              // nothing happening in this step
+              break;
+            }
+            }
+            break;
+          }
           default: {
             // none defined
             break;
@@ -0,0 +1,294 @@
+/*
+
+ Copyright (c) 2014, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include <ortc/internal/ortc_StatsCounters.h>
+
+#include <zsLib/IMessageQueueThread.h>
+#include <zsLib/ISettings.h>
+
+#include "config.h"
+#include "testing.h"
+
+#include <string>
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using std::make_shared;
+
+using zsLib::QWORD;
+using zsLib::ULONG;
+using zsLib::IMessageQueue;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace statscounters
+    {
+      ZS_DECLARE_CLASS_PTR(StatsCountersTester)
+      ZS_DECLARE_USING_PTR(ortc::internal, StatsCountersHandle)
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark StatsCountersTester
+      #pragma mark
+
+      // private registry instance (not the singleton) so the export
+      // calculation can be driven synchronously without a timer
+      class StatsCountersTester : public ortc::internal::StatsCounters
+      {
+      public:
+        typedef ortc::internal::StatsCounters StatsCounters;
+
+        //---------------------------------------------------------------------
+        StatsCountersTester(
+                            const make_private &priv,
+                            IMessageQueuePtr queue
+                            ) :
+          StatsCounters(priv, queue)
+        {
+        }
+
+        //---------------------------------------------------------------------
+        static StatsCountersTesterPtr create(IMessageQueuePtr queue)
+        {
+          StatsCountersTesterPtr pThis(make_shared<StatsCountersTester>(make_private {}, queue));
+          pThis->mThisWeak = pThis;
+          pThis->init();
+          return pThis;
+        }
+
+        //---------------------------------------------------------------------
+        StatsCountersHandlePtr registerObject(
+                                              PUID objectID,
+                                              StatsTypes statsType
+                                              )
+        {
+          return allocateSlot(objectID, statsType);
+        }
+
+        //---------------------------------------------------------------------
+        void exportValues(
+                          bool delta,
+                          ExportEntryList &outEntries,
+                          PUIDList &outRemoved
+                          )
+        {
+          ObjectValuesList current;
+          collect(current);
+          calculateExport(current, delta ? (&mPrevious) : NULL, outEntries, outRemoved);
+          mPrevious.swap(current);
+        }
+
+        //---------------------------------------------------------------------
+        std::string encodeJSONValues(
+                                     bool delta,
+                                     const ExportEntryList &entries,
+                                     const PUIDList &removed
+                                     )
+        {
+          auto buffer = encode(IStatsCountersTypes::ExportFormat_JSON, delta, 0, entries, removed);
+          if (!buffer) return std::string();
+          return std::string(reinterpret_cast<const char *>(buffer->BytePtr()), buffer->SizeInBytes());
+        }
+
+        //---------------------------------------------------------------------
+        bool hasExportTimer() const
+        {
+          AutoRecursiveLock lock(*this);
+          return (bool)mExportTimer;
+        }
+
+      protected:
+        ObjectValuesList mPrevious;
+      };
+
+      //-----------------------------------------------------------------------
+      static const StatsCountersTester::ExportEntry *findEntry(
+                                                                const StatsCountersTester::ExportEntryList &entries,
+                                                                PUID objectID
+                                                                )
+      {
+        for (auto iter = entries.begin(); iter != entries.end(); ++iter) {
+          if ((*iter).mObjectID == objectID) return &(*iter);
+        }
+        return NULL;
+      }
+
+      //-----------------------------------------------------------------------
+      static bool contains(
+                           const std::string &json,
+                           const char *value
+                           )
+      {
+        return std::string::npos != json.find(value);
+      }
+    }
+  }
+}
+
+using namespace ortc::test::statscounters;
+using ortc::IStatsCountersTypes;
+using ortc::IStatsReportTypes;
+
+void doTestStatsCounters()
+{
+  if (!ORTC_TEST_DO_STATS_COUNTERS_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+
+  auto thread(zsLib::IMessageQueueThread::createBasic());
+
+  {
+    auto counters = StatsCountersTester::create(thread);
+    TESTING_CHECK(counters)
+
+    // no subscribers thus no export timer
+    TESTING_CHECK(!counters->hasExportTimer())
+
+    auto handle1 = counters->registerObject(1001, IStatsReportTypes::StatsType_OutboundRTP);
+    auto handle2 = counters->registerObject(1002, IStatsReportTypes::StatsType_DTLSTransport);
+    TESTING_CHECK(handle1)
+    TESTING_CHECK(handle2)
+
+    handle1->increment(IStatsCountersTypes::Counter_PacketsSent, 10);
+    handle1->increment(IStatsCountersTypes::Counter_BytesSent, 12000);
+    handle1->set(IStatsCountersTypes::Counter_RoundTripTime, 5000);
+    handle1->setSigned(IStatsCountersTypes::Counter_PacketsLost, -3);
+
+    // full export
+    {
+      StatsCountersTester::ExportEntryList entries;
+      StatsCountersTester::PUIDList removed;
+      counters->exportValues(false, entries, removed);
+
+      TESTING_EQUAL(2, entries.size())
+      TESTING_EQUAL(0, removed.size())
+
+      auto entry = findEntry(entries, 1001);
+      TESTING_CHECK(NULL != entry)
+      if (entry) {
+        TESTING_EQUAL(10, entry->mValues[IStatsCountersTypes::Counter_PacketsSent])
+        TESTING_EQUAL(12000, entry->mValues[IStatsCountersTypes::Counter_BytesSent])
+        TESTING_EQUAL(5000, entry->mValues[IStatsCountersTypes::Counter_RoundTripTime])
+        TESTING_EQUAL(-3, entry->mValues[IStatsCountersTypes::Counter_PacketsLost])
+      }
+
+      auto json = counters->encodeJSONValues(false, entries, removed);
+      TESTING_CHECK(contains(json, "\"delta\":false"))
+      TESTING_CHECK(contains(json, "\"packetsSent\":10"))
+      TESTING_CHECK(contains(json, "\"packetsLost\":-3"))
+    }
+
+    handle1->increment(IStatsCountersTypes::Counter_PacketsSent, 5);
+    handle1->increment(IStatsCountersTypes::Counter_BytesSent, 6000);
+
+    // delta export: counters are deltas, unchanged gauges keep their value
+    {
+      StatsCountersTester::ExportEntryList entries;
+      StatsCountersTester::PUIDList removed;
+      counters->exportValues(true, entries, removed);
+
+      TESTING_EQUAL(1, entries.size())
+
+      auto entry = findEntry(entries, 1001);
+      TESTING_CHECK(NULL != entry)
+      if (entry) {
+        TESTING_EQUAL(5, entry->mValues[IStatsCountersTypes::Counter_PacketsSent])
+        TESTING_EQUAL(6000, entry->mValues[IStatsCountersTypes::Counter_BytesSent])
+        TESTING_EQUAL(5000, entry->mValues[IStatsCountersTypes::Counter_RoundTripTime])
+        TESTING_EQUAL(-3, entry->mValues[IStatsCountersTypes::Counter_PacketsLost])
+      }
+
+      auto json = counters->encodeJSONValues(true, entries, removed);
+      TESTING_CHECK(contains(json, "\"delta\":true"))
+      TESTING_CHECK(contains(json, "\"packetsSent\":5"))
+      TESTING_CHECK(contains(json, "\"roundTripTime\":5000"))
+      TESTING_CHECK(!contains(json, "\"nackCount\""))
+    }
+
+    // nothing changed thus nothing exported
+    {
+      StatsCountersTester::ExportEntryList entries;
+      StatsCountersTester::PUIDList removed;
+      counters->exportValues(true, entries, removed);
+
+      TESTING_EQUAL(0, entries.size())
+    }
+
+    // a gauge going down is exported as its new value (never as a delta)
+    handle1->set(IStatsCountersTypes::Counter_RoundTripTime, 2000);
+    handle2->set(IStatsCountersTypes::Counter_HandshakeQueueDepth, 0);
+
+    {
+      StatsCountersTester::ExportEntryList entries;
+      StatsCountersTester::PUIDList removed;
+      counters->exportValues(true, entries, removed);
+
+      TESTING_EQUAL(1, entries.size())
+
+      auto entry = findEntry(entries, 1001);
+      TESTING_CHECK(NULL != entry)
+      if (entry) {
+        TESTING_EQUAL(0, entry->mValues[IStatsCountersTypes::Counter_PacketsSent])
+        TESTING_EQUAL(2000, entry->mValues[IStatsCountersTypes::Counter_RoundTripTime])
+      }
+    }
+
+    // released objects are reported as removed
+    handle2.reset();
+
+    {
+      StatsCountersTester::ExportEntryList entries;
+      StatsCountersTester::PUIDList removed;
+      counters->exportValues(true, entries, removed);
+
+      TESTING_EQUAL(0, entries.size())
+      TESTING_EQUAL(1, removed.size())
+      if (removed.size() > 0) {
+        TESTING_EQUAL(1002, removed.front())
+      }
+    }
+
+    handle1.reset();
+    counters.reset();
+  }
+
+  TESTING_UNINSTALL_LOGGER();
+}
@@ -58,6 +58,40 @@
 #define ORTC_TEST_DO_RTP_CHANNEL_VIDEO_TEST               (false)
 #define ORTC_TEST_DO_RTP_SENDER_TEST                      (false)
 #define ORTC_TEST_DO_RTP_MEDIA_STREAM_TRACK_TEST          (false)
+#define ORTC_TEST_DO_PACKET_BENCHMARK                     (false)
+// define on the command line to build a benchmark binary without editing
+// this file (see Testing::runLoopbackBenchmark)
+#ifndef ORTC_TEST_DO_LOOPBACK_BENCHMARK
+#define ORTC_TEST_DO_LOOPBACK_BENCHMARK                   (false)
+#endif //ndef ORTC_TEST_DO_LOOPBACK_BENCHMARK
+#define ORTC_TEST_DO_STATS_COUNTERS_TEST                  (false)
+#define ORTC_TEST_DO_SDP_PARSER_TEST                      (false)
+#define ORTC_TEST_DO_RTP_PACKET_HISTORY_TEST              (false)
+#define ORTC_TEST_DO_RTP_TYPES_TEST                       (false)
+
+// packet parse/serialize microbenchmark; set the JSON file (or the
+// ORTC_TEST_PACKET_BENCHMARK_JSON environment variable) for CI output
+#define ORTC_TEST_PACKET_BENCHMARK_ITERATIONS                   (20000)
+#define ORTC_TEST_PACKET_BENCHMARK_DEBUG_ITERATIONS             (1000)
+#define ORTC_TEST_PACKET_BENCHMARK_JSON_FILE                    ""
+
+// loopback benchmark (N pairs of the real transport stack over loopback)
+#define ORTC_TEST_LOOPBACK_BENCHMARK_PAIRS                      (4)
+#define ORTC_TEST_LOOPBACK_BENCHMARK_WARMUP_SECONDS             (3)
+#define ORTC_TEST_LOOPBACK_BENCHMARK_DURATION_SECONDS           (30)
+#define ORTC_TEST_LOOPBACK_BENCHMARK_RTP_PACKETS_PER_SECOND     (200)
+#define ORTC_TEST_LOOPBACK_BENCHMARK_RTP_PACKET_SIZE            (1000)
+#define ORTC_TEST_LOOPBACK_BENCHMARK_RTCP_PACKETS_PER_SECOND    (5)
+#define ORTC_TEST_LOOPBACK_BENCHMARK_DATA_MESSAGES_PER_SECOND   (50)
+#define ORTC_TEST_LOOPBACK_BENCHMARK_DATA_MESSAGE_SIZE          (256)
+
+// the single allocation counting hook (testing.cpp) replaces the global
+// operator new/delete of the test binary and is therefore only compiled in
+// when a benchmark that reports allocations is enabled (see
+// Testing::allocationCount); define on the command line to force either way
+#ifndef ORTC_TEST_COUNT_ALLOCATIONS
+#define ORTC_TEST_COUNT_ALLOCATIONS ((ORTC_TEST_DO_PACKET_BENCHMARK) || (ORTC_TEST_DO_LOOPBACK_BENCHMARK))
+#endif //ndef ORTC_TEST_COUNT_ALLOCATIONS
 
 
 #define ORTC_TEST_STUN_SERVER             "stun.vline.com"
@@ -33,6 +33,7 @@
 
 #include "testing.h"
 
+#include <cstring>
 #include <iostream>
 
 #include <zsLib/Log.h>
@@ -51,7 +52,17 @@ int main (int argc, char * const argv[]) {
 
   std::cout << "TEST NOW STARTING...\n\n";
 
-  Testing::runAllTests(NULL, NULL);
+#ifdef _WIN32
+  bool loopbackBenchmark = ((argc > 1) && (0 == _tcscmp(argv[1], _T("--loopback-benchmark"))));
+#else
+  bool loopbackBenchmark = ((argc > 1) && (0 == strcmp(argv[1], "--loopback-benchmark")));
+#endif //_WIN32
+
+  if (loopbackBenchmark) {
+    Testing::runLoopbackBenchmark();
+  } else {
+    Testing::runAllTests(NULL, NULL);
+  }
   Testing::output();
 
   if (0 != Testing::getGlobalFailedVar()) {
@@ -38,9 +38,44 @@
 #include <ortc/services/ILogger.h>
 
 #include <iostream>
+#include <new>
+#include <cstdlib>
 
 namespace ortc { namespace test { ZS_IMPLEMENT_SUBSYSTEM(ortc_test) } }
 
+#if ORTC_TEST_COUNT_ALLOCATIONS
+
+namespace
+{
+  std::atomic<zsLib::ULONGLONG> &getGlobalAllocationCountVar()
+  {
+    static std::atomic<zsLib::ULONGLONG> value {};
+    return value;
+  }
+
+  std::atomic<zsLib::ULONGLONG> &getGlobalAllocationBytesVar()
+  {
+    static std::atomic<zsLib::ULONGLONG> value {};
+    return value;
+  }
+
+  void *countedAllocate(size_t size)
+  {
+    getGlobalAllocationCountVar().fetch_add(1, std::memory_order_relaxed);
+    getGlobalAllocationBytesVar().fetch_add(size, std::memory_order_relaxed);
+    void *result = malloc(0 != size ? size : 1);
+    if (!result) throw std::bad_alloc();
+    return result;
+  }
+}
+
+void *operator new(size_t size) {return countedAllocate(size);}
+void *operator new[](size_t size) {return countedAllocate(size);}
+void operator delete(void *ptr) noexcept {free(ptr);}
+void operator delete[](void *ptr) noexcept {free(ptr);}
+
+#endif //ORTC_TEST_COUNT_ALLOCATIONS
+
 
 #ifdef _WIN32
 debugostream &getDebugCout()
@@ -68,6 +103,12 @@ void doTestICETransport();
 void doTestMediaStreamTrack(void* videoSurface);
 void doTestRTPChannelAudio();
 void doTestRTPChannelVideo(void* localSurface, void* remoteSurface);
+void doTestLoopbackBenchmark();
+void doTestPacketBenchmark();
+void doTestStatsCounters();
+void doTestSDPParser();
+void doTestRTPPacketHistory();
+void doTestRTPTypes();
 
 namespace Testing
 {
@@ -185,6 +226,24 @@ namespace Testing
     }
   }
 
+  zsLib::ULONGLONG allocationCount()
+  {
+#if ORTC_TEST_COUNT_ALLOCATIONS
+    return getGlobalAllocationCountVar().load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif //ORTC_TEST_COUNT_ALLOCATIONS
+  }
+
+  zsLib::ULONGLONG allocationBytes()
+  {
+#if ORTC_TEST_COUNT_ALLOCATIONS
+    return getGlobalAllocationBytesVar().load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif //ORTC_TEST_COUNT_ALLOCATIONS
+  }
+
   void runAllTests(void* videoSurface1, void* videoSurface2)
   {
     srand(static_cast<signed int>(time(NULL)));
@@ -208,6 +267,32 @@ namespace Testing
     TESTING_RUN_TEST_FUNC_1(doTestMediaStreamTrack, videoSurface1)
     TESTING_RUN_TEST_FUNC_0(doTestRTPChannelAudio)
     TESTING_RUN_TEST_FUNC_2(doTestRTPChannelVideo, videoSurface1, videoSurface2)
+    TESTING_RUN_TEST_FUNC_0(doTestPacketBenchmark)
+    TESTING_RUN_TEST_FUNC_0(doTestLoopbackBenchmark)
+    TESTING_RUN_TEST_FUNC_0(doTestStatsCounters)
+    TESTING_RUN_TEST_FUNC_0(doTestSDPParser)
+    TESTING_RUN_TEST_FUNC_0(doTestRTPPacketHistory)
+    TESTING_RUN_TEST_FUNC_0(doTestRTPTypes)
+
+    TESTING_UNINSTALL_LOGGER()
+  }
+
+  void runLoopbackBenchmark()
+  {
+    srand(static_cast<signed int>(time(NULL)));
+
+    if (!ORTC_TEST_DO_LOOPBACK_BENCHMARK) {
+      TESTING_STDOUT() << "***FAILED***: loopback benchmark is not compiled in (define ORTC_TEST_DO_LOOPBACK_BENCHMARK=1)\n";
+      failed();
+      return;
+    }
+
+    TESTING_INSTALL_LOGGER()
+
+    setup();
+    doSetup();
+
+    TESTING_RUN_TEST_FUNC_0(doTestLoopbackBenchmark)
 
     TESTING_UNINSTALL_LOGGER()
   }
@@ -152,6 +152,15 @@ namespace Testing
   void setup();
   void output();
   void runAllTests(void* videoSurface1, void* videoSurface2);
+
+  // runs only the loopback benchmark (main.cpp: --loopback-benchmark); the
+  // benchmark must be compiled in with ORTC_TEST_DO_LOOPBACK_BENCHMARK
+  void runLoopbackBenchmark();
+
+  // heap allocations made by the test binary so far (0 unless
+  // ORTC_TEST_COUNT_ALLOCATIONS is enabled)
+  zsLib::ULONGLONG allocationCount();
+  zsLib::ULONGLONG allocationBytes();
 }
 
 #define TESTING_INSTALL_LOGGER()                                             \
@@ -150,6 +150,8 @@ namespace ortc
   ZS_DECLARE_INTERACTION_PTR(IMediaDevices);
   ZS_DECLARE_INTERACTION_PTR(IMediaStreamTrackRenderCallback);
   ZS_DECLARE_INTERACTION_PTR(IMediaStreamTrack);
+  ZS_DECLARE_INTERACTION_PTR(IReceiveLatency);
+  ZS_DECLARE_INTERACTION_PTR(IRTPForwarder);
   ZS_DECLARE_INTERACTION_PTR(IRTPListener);
   ZS_DECLARE_INTERACTION_PTR(IRTPSender);
   ZS_DECLARE_INTERACTION_PTR(IRTPReceiver);
@@ -158,6 +160,7 @@ namespace ortc
   ZS_DECLARE_INTERACTION_PTR(IRTCPTransport);
   ZS_DECLARE_INTERACTION_PTR(ISCTPTransport);
   ZS_DECLARE_INTERACTION_PTR(ISRTPSDESTransport);
+  ZS_DECLARE_INTERACTION_PTR(IStatsCounters);
   ZS_DECLARE_INTERACTION_PTR(IStatsProvider);
   ZS_DECLARE_INTERACTION_PTR(IStatsReport);
 
@@ -174,6 +177,7 @@ namespace ortc
   ZS_DECLARE_INTERACTION_PROXY(ISCTPTransportDelegate);
   ZS_DECLARE_INTERACTION_PROXY(ISCTPTransportListenerDelegate);
   ZS_DECLARE_INTERACTION_PROXY(ISRTPSDESTransportDelegate);
+  ZS_DECLARE_INTERACTION_PROXY(IStatsCountersDelegate);
 
   ZS_DECLARE_INTERACTION_PROXY_SUBSCRIPTION(IDataChannelSubscription, IDataChannelDelegate);
   ZS_DECLARE_INTERACTION_PROXY_SUBSCRIPTION(IDTLSTransportSubscription, IDTLSTransportDelegate);
@@ -188,6 +192,7 @@ namespace ortc
   ZS_DECLARE_INTERACTION_PROXY_SUBSCRIPTION(ISCTPTransportSubscription, ISCTPTransportDelegate);
   ZS_DECLARE_INTERACTION_PROXY_SUBSCRIPTION(ISCTPTransportListenerSubscription, ISCTPTransportListenerDelegate);
   ZS_DECLARE_INTERACTION_PROXY_SUBSCRIPTION(ISRTPSDESTransportSubscription, ISRTPSDESTransportDelegate);
+  ZS_DECLARE_INTERACTION_PROXY_SUBSCRIPTION(IStatsCountersSubscription, IStatsCountersDelegate);
 
 
   //---------------------------------------------------------------------------